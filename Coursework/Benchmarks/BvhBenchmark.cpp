@@ -0,0 +1,21 @@
+#include "Bvh.h"
+
+#include <cstdio>
+
+//Building, refitting and querying trees of up to a million random boxes against testing every box, which the application's
+//Benchmark BVH button runs for a million. The queries are checked against the brute force tests before and after the refit.
+int main()
+{
+	std::printf("%9s %8s %8s %10s %10s %10s %12s %8s %9s\n", "objects", "nodes", "visible", "build ms", "refit ms", "query ms", "brute ms", "speedup",
+		"matches");
+
+	for (int objects : { 1000, 10000, 100000, 1000000 })
+	{
+		Bvh::BenchmarkResult result = Bvh::benchmark(objects, 10);
+		std::printf("%9d %8d %8d %10.2f %10.3f %10.3f %12.3f %7.1fx %9s\n", result.objects, result.nodes, result.visible, result.buildMilliseconds,
+			result.refitMilliseconds, result.queryMilliseconds, result.bruteForceMilliseconds, result.bruteForceMilliseconds / result.queryMilliseconds,
+			result.matches ? "yes" : "NO");
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "CommandRecorder.h"
+#include "RecordingContexts.h"
+#include "RenderStats.h"
+#include "SceneGraph.h"
+#include "Bvh.h"
+#include "JobSystem.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+//A frame shaped like Application::recordPasses(): four shadow maps, each drawing the casters its light's frustum kept with the depth
+//shader's world, view and projection constants and its position streams, and the four draws of the post processing chain. The
+//culling is done before recording, as prepareShadowMaps() does, so only the recording is split across threads.
+struct ShadowFrame
+{
+	SceneGraph scene;
+	Bvh bvh;
+	std::vector<unsigned int> indexCounts;
+	std::vector<int> vertexCounts;
+	XMFLOAT4X4 lightViews[4];
+	XMFLOAT4X4 lightProjections[4];
+	std::vector<int> casters[4];
+	RenderStats stats[4];
+};
+
+static void buildFrame(ShadowFrame& frame, int objects)
+{
+	//Cubes, spheres and teapots on roots of their own across a 400 unit square
+	const unsigned int indexCounts[3] = { 36, 2400, 4704 };
+	const int vertexCounts[3] = { 24, 441, 792 };
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+	std::uniform_real_distribution<float> size(0.5f, 3.0f);
+	std::vector<Bvh::Box> boxes;
+
+	for (int i = 0; i < objects; i++)
+	{
+		float scale = size(random);
+		frame.scene.createNode(-1, XMFLOAT3(position(random), scale, position(random)), XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f), XMFLOAT3(scale, scale, scale));
+		frame.indexCounts.push_back(indexCounts[i % 3]);
+		frame.vertexCounts.push_back(vertexCounts[i % 3]);
+		boxes.push_back({ XMFLOAT3(-1.0f, -1.0f, -1.0f), XMFLOAT3(1.0f, 1.0f, 1.0f) });
+	}
+
+	frame.scene.update(false);
+
+	for (int i = 0; i < objects; i++)
+	{
+		boxes[i] = Bvh::transformBox(boxes[i], frame.scene.getWorldMatrix(i));
+	}
+
+	frame.bvh.build(boxes);
+
+	//Spotlights over each quarter of the square, looking down and in
+	for (int light = 0; light < 4; light++)
+	{
+		XMVECTOR eye = XMVectorSet(light & 1 ? 150.0f : -150.0f, 120.0f, light & 2 ? 150.0f : -150.0f, 1.0f);
+		XMMATRIX view = XMMatrixLookAtLH(eye, XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV2, 1.0f, 1.0f, 500.0f);
+		XMStoreFloat4x4(&frame.lightViews[light], view);
+		XMStoreFloat4x4(&frame.lightProjections[light], projection);
+		frame.bvh.query(Frustum(view * projection), frame.casters[light]);
+	}
+}
+
+static void setConstants(RecordingContexts::Context* context, const XMMATRIX& matrix)
+{
+	XMFLOAT4X4 transposed;
+	XMStoreFloat4x4(&transposed, XMMatrixTranspose(matrix));
+	context->setConstants(&transposed._11);
+}
+
+static void recordShadowMap(ShadowFrame& frame, int light, RecordingContexts::Context* context)
+{
+	RenderStats& stats = frame.stats[light];
+	stats.beginFrame();
+	stats.beginPass("Shadow map " + std::to_string(light));
+
+	XMMATRIX view = XMLoadFloat4x4(&frame.lightViews[light]);
+	XMMATRIX projection = XMLoadFloat4x4(&frame.lightProjections[light]);
+	context->setShader(0);
+
+	for (int object : frame.casters[light])
+	{
+		setConstants(context, frame.scene.getWorldMatrix(object));
+		setConstants(context, view);
+		setConstants(context, projection);
+		context->setVertexBuffers(object % 3, 20);
+		context->drawIndexed(frame.indexCounts[object]);
+		stats.recordDraw(frame.indexCounts[object], frame.vertexCounts[object], 20);
+	}
+}
+
+//Bloom extract, both blurs and the composite, each a full screen quad
+static void recordPostProcess(RecordingContexts::Context* context)
+{
+	XMMATRIX ortho = XMMatrixOrthographicLH(1280.0f, 720.0f, 0.1f, 100.0f);
+
+	for (unsigned int shader = 1; shader <= 4; shader++)
+	{
+		context->setShader(shader);
+		setConstants(context, XMMatrixIdentity());
+		setConstants(context, XMMatrixIdentity());
+		setConstants(context, ortho);
+		context->setVertexBuffers(3, 32);
+		context->drawIndexed(6);
+	}
+}
+
+static float recordFrame(ShadowFrame& frame, CommandRecorder& recorder, RecordingContexts& contexts, bool multithreaded)
+{
+	for (int light = 0; light < 4; light++)
+	{
+		recorder.addPass([&frame, &contexts, light](int context)
+		{
+			recordShadowMap(frame, light, contexts.getContext(context));
+		});
+	}
+
+	recorder.addPass([&contexts](int context)
+	{
+		recordPostProcess(contexts.getContext(context));
+	});
+
+	recorder.record(multithreaded);
+
+	return recorder.getRecordMilliseconds();
+}
+
+//Times recording the frame on one thread and a pass per thread for each number of threads, and replaying the lists in order
+int main()
+{
+	const int iterations = 20;
+
+	std::printf("%9s %7s %8s %10s %12s %12s %8s %11s %8s\n", "objects", "threads", "draws", "commands", "record 1T ms", "record MT ms", "speedup",
+		"execute ms", "matches");
+
+	for (int objects : { 10000, 100000 })
+	{
+		ShadowFrame frame;
+		buildFrame(frame, objects);
+
+		for (int threads : { 1, 2, 4, 8 })
+		{
+			//One thread is the calling thread alone, without a job system
+			JobSystem* jobs = threads > 1 ? new JobSystem(threads - 1) : nullptr;
+			JobSystem::setShared(jobs);
+
+			RecordingContexts contexts;
+			CommandRecorder recorder(&contexts);
+			float singleMilliseconds = 0.0f;
+			float multiMilliseconds = 0.0f;
+			float executeMilliseconds = 0.0f;
+			bool matches = true;
+
+			for (int iteration = 0; iteration < iterations; iteration++)
+			{
+				contexts.clearExecuted();
+				singleMilliseconds += recordFrame(frame, recorder, contexts, false);
+				recorder.execute();
+				std::vector<RecordingContexts::Command> single = contexts.getExecuted();
+
+				contexts.clearExecuted();
+				multiMilliseconds += recordFrame(frame, recorder, contexts, true);
+				recorder.execute();
+				executeMilliseconds += recorder.getExecuteMilliseconds();
+
+				const std::vector<RecordingContexts::Command>& multi = contexts.getExecuted();
+				matches = matches && multi.size() == single.size();
+
+				for (size_t i = 0; matches && i < multi.size(); i++)
+				{
+					matches = multi[i].type == single[i].type && multi[i].value == single[i].value && multi[i].constants[12] == single[i].constants[12];
+				}
+			}
+
+			std::printf("%9d %7d %8d %10d %12.3f %12.3f %7.2fx %11.3f %8s\n", objects, jobs ? jobs->getThreadCount() : 1, contexts.getExecutedDraws(),
+				(int)contexts.getExecuted().size(), singleMilliseconds / iterations, multiMilliseconds / iterations, singleMilliseconds / multiMilliseconds,
+				executeMilliseconds / iterations, matches ? "yes" : "NO");
+
+			JobSystem::setShared(nullptr);
+			delete jobs;
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#include "DepthSort.h"
+
+#include <cstdio>
+
+//Quantising and radix sorting the view depths of 100k to 4M grass instances, against std::stable_sort on the same keys.
+//1M instances is the field the forward pass sorts when grass is blended rather than drawn with alpha to coverage.
+int main()
+{
+	std::printf("%10s %12s %10s %15s %8s\n", "instances", "quantise ms", "radix ms", "stable_sort ms", "match");
+
+	for (int count : { 100000, 1000000, 4000000 })
+	{
+		DepthSort::BenchmarkResult result = DepthSort::benchmark(count);
+		std::printf("%10d %12.3f %10.3f %15.3f %8s\n", result.count, result.quantiseMilliseconds, result.radixMilliseconds,
+			result.comparisonMilliseconds, result.matches ? "yes" : "NO");
+	}
+
+	return 0;
+}
\ No newline at end of file
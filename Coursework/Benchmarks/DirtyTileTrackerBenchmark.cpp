@@ -0,0 +1,32 @@
+#include "TerrainBaker.h"
+#include "JobSystem.h"
+
+#include <cstdio>
+
+//Brush sized edits to a 4k heightmap, re-baking the normal map tiles and refitting the quadtree nodes each one dirtied,
+//against re-baking and rebuilding everything after every edit
+int main()
+{
+	const int size = 4096;
+	const int edits = 16;
+
+	JobSystem jobs;
+	JobSystem::setShared(&jobs);
+
+	std::printf("%d x %d heightmap, %d edits\n", size, size, edits);
+	std::printf("%6s %6s %12s %16s %8s %8s\n", "brush", "tile", "full ms", "incremental ms", "tiles", "speedup");
+
+	for (int radius : { 8, 32, 128 })
+	{
+		for (int tileSize : { 32, 64, 128 })
+		{
+			TerrainBaker::EditBenchmarkResult result = TerrainBaker::benchmarkEdits(size, radius, edits, tileSize);
+			std::printf("%6d %6d %12.2f %16.3f %8.1f %7.0fx\n", result.brushRadius, tileSize, result.fullMilliseconds, result.incrementalMilliseconds,
+				result.dirtyTiles, result.fullMilliseconds / result.incrementalMilliseconds);
+		}
+	}
+
+	JobSystem::setShared(nullptr);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#include "GrassCells.h"
+#include "JobSystem.h"
+
+#include <cstdio>
+
+//Culling and compacting fields of 1M to 10M blades from 16 views, scalar and SIMD on one thread and SIMD on the job system.
+//Only the cells within the fade distance are visited, so the time should barely grow with the field.
+int main()
+{
+	JobSystem jobs;
+	JobSystem::setShared(&jobs);
+
+	std::printf("%10s %8s %11s %11s %11s %10s %8s\n", "blades", "cells", "scalar ms", "simd ms", "threads ms", "visible", "match");
+
+	for (int blades : { 1000000, 2000000, 5000000, 10000000 })
+	{
+		GrassCells::BenchmarkResult result = GrassCells::benchmark(blades, 16);
+		std::printf("%10d %8d %11.3f %11.3f %11.3f %10.0f %8s\n", result.blades, result.cells, result.scalarMilliseconds, result.simdMilliseconds,
+			result.multithreadedMilliseconds, result.averageVisible, result.matches ? "yes" : "NO");
+	}
+
+	JobSystem::setShared(nullptr);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include "GrassScatter.h"
+#include "JobSystem.h"
+
+#include <cstdio>
+#include <initializer_list>
+
+//Jittered and Poisson scattering over the scene's 100 unit terrain at the spacings the grass panel offers, then over larger
+//fields up to four million jittered blades
+int main()
+{
+	JobSystem jobs;
+	JobSystem::setShared(&jobs);
+
+	std::printf("%7s %8s %10s %11s %11s %10s %11s %10s %8s\n", "world", "spacing", "jittered", "1 thread ms", "threads ms", "poisson", "poisson ms", "closest", "Mblade/s");
+
+	for (float worldSize : { 100.0f, 500.0f, 2000.0f })
+	{
+		for (float spacing : { 4.0f, 1.0f, 0.5f, 0.25f })
+		{
+			//Poisson is single threaded and slower, so the largest fields are left at their coarser spacings
+			if (worldSize / spacing > 2000.0f)
+			{
+				continue;
+			}
+
+			GrassScatter::BenchmarkResult result = GrassScatter::benchmark(worldSize, spacing);
+			std::printf("%7.0f %8.2f %10d %11.3f %11.3f %10d %11.3f %10.4f %8.1f\n", worldSize, spacing, result.jitteredBlades, result.jitteredMilliseconds,
+				result.multithreadedMilliseconds, result.poissonBlades, result.poissonMilliseconds, result.poissonMinimumDistance,
+				((float)result.jitteredBlades / 1e6f) / (result.multithreadedMilliseconds * 0.001f));
+		}
+	}
+
+	std::printf("\nThe old path drew %d points through the geometry shader\n", GrassScatter::benchmark(10.0f, 1.0f).planeBlades);
+
+	JobSystem::setShared(nullptr);
+
+	return 0;
+}
\ No newline at end of file
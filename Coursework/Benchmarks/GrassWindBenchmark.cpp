@@ -0,0 +1,25 @@
+#include "GrassWind.h"
+#include "JobSystem.h"
+
+#include <cstdio>
+
+//Cost per blade per step of the wind springs for fields of 1M to 8M blades, scalar and SIMD on one thread and SIMD on the job system.
+//The per blade cost is what GrassWind::update() sizes its budget with, so it should stay flat as the field grows.
+int main()
+{
+	JobSystem jobs;
+	JobSystem::setShared(&jobs);
+
+	std::printf("%10s %11s %11s %11s %12s\n", "blades", "scalar ns", "simd ns", "threads ns", "max diff");
+
+	for (int blades : { 1000000, 2000000, 4000000, 8000000 })
+	{
+		GrassWind::BenchmarkResult result = GrassWind::benchmark(blades, 10);
+		std::printf("%10d %11.3f %11.3f %11.3f %12.2e\n", result.blades, result.scalarNanoseconds, result.simdNanoseconds,
+			result.multithreadedNanoseconds, result.maxDifference);
+	}
+
+	JobSystem::setShared(nullptr);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "CommandRecorder.h"
+#include "RecordingContexts.h"
+#include "InstanceData.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace DirectX;
+
+//The cube and grid Application::benchmarkInstancing() draws, 36 indices each, 47 a side and stacked as deep as the count needs
+static const unsigned int cubeIndices = 36;
+static const unsigned int cubeStride = 32;
+
+static std::vector<InstanceData::Instance> buildGrid(int count)
+{
+	const int side = 47;
+	std::vector<InstanceData::Instance> instances(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		float x = (float)(i % side);
+		float y = (float)((i / side) % side);
+		float z = (float)(i / (side * side));
+		XMStoreFloat4x4(&instances[i].world, XMMatrixMultiply(XMMatrixScaling(0.25f, 0.25f, 0.25f), XMMatrixTranslation(x - (side / 2), y, z)));
+	}
+
+	return instances;
+}
+
+static void setConstants(RecordingContexts::Context* context, const XMMATRIX& matrix)
+{
+	XMFLOAT4X4 transposed;
+	XMStoreFloat4x4(&transposed, XMMatrixTranspose(matrix));
+	context->setConstants(&transposed._11);
+}
+
+//One draw per cube, mapping the shader's matrix buffer for its world as LightShader::setShaderParameters() does each time
+static void recordPerObject(const std::vector<InstanceData::Instance>& instances, RecordingContexts::Context* context)
+{
+	context->setShader(0);
+	context->setVertexBuffers(0, cubeStride);
+
+	for (const InstanceData::Instance& instance : instances)
+	{
+		setConstants(context, XMLoadFloat4x4(&instance.world));
+		context->drawIndexed(cubeIndices);
+	}
+}
+
+//One fill of the instance buffer, as InstanceBuffer::update() does, and one DrawIndexedInstanced of every cube
+static void recordInstanced(const std::vector<InstanceData::Instance>& instances, RecordingContexts::Context* context)
+{
+	int count = (int)instances.size();
+	void* mapped = context->mapInstances((unsigned int)(sizeof(InstanceData::Instance) * count));
+	count = InstanceData::write(mapped, count, instances.data(), count);
+
+	context->setShader(1);
+	context->setVertexBuffers(0, cubeStride);
+	setConstants(context, XMMatrixIdentity());
+	context->drawIndexedInstanced(cubeIndices, (unsigned int)count);
+}
+
+//Times recording and replaying the cubes a draw at a time against one instanced draw, the CPU side of each path. The GPU's work
+//is the same either way, so the submission is all that differs.
+int main()
+{
+	const int iterations = 20;
+
+	std::printf("%7s %10s %10s %14s %14s %14s %14s %8s\n", "cubes", "commands", "inst cmds", "per draw ms", "execute ms", "instanced ms",
+		"execute ms", "speedup");
+
+	for (int cubes : { 1000, 10000, 100000 })
+	{
+		std::vector<InstanceData::Instance> instances = buildGrid(cubes);
+		RecordingContexts contexts;
+		CommandRecorder recorder(&contexts);
+		float perObject[2] = { 0.0f, 0.0f };
+		float instanced[2] = { 0.0f, 0.0f };
+		int perObjectCommands = 0;
+		int instancedCommands = 0;
+		long long drawn[2] = { 0, 0 };
+
+		for (int iteration = 0; iteration < iterations; iteration++)
+		{
+			contexts.clearExecuted();
+			recorder.addPass([&instances, &contexts](int context)
+			{
+				recordPerObject(instances, contexts.getContext(context));
+			});
+			recorder.record(false);
+			recorder.execute();
+			perObject[0] += recorder.getRecordMilliseconds();
+			perObject[1] += recorder.getExecuteMilliseconds();
+			perObjectCommands = (int)contexts.getExecuted().size();
+			drawn[0] = contexts.getExecutedInstances();
+
+			contexts.clearExecuted();
+			recorder.addPass([&instances, &contexts](int context)
+			{
+				recordInstanced(instances, contexts.getContext(context));
+			});
+			recorder.record(false);
+			recorder.execute();
+			instanced[0] += recorder.getRecordMilliseconds();
+			instanced[1] += recorder.getExecuteMilliseconds();
+			instancedCommands = (int)contexts.getExecuted().size();
+			drawn[1] = contexts.getExecutedInstances();
+		}
+
+		std::printf("%7d %10d %10d %14.3f %14.3f %14.3f %14.3f %7.1fx%s\n", cubes, perObjectCommands, instancedCommands, perObject[0] / iterations,
+			perObject[1] / iterations, instanced[0] / iterations, instanced[1] / iterations, (perObject[0] + perObject[1]) / (instanced[0] + instanced[1]),
+			drawn[0] == drawn[1] ? "" : " (cube counts differ)");
+	}
+
+	return 0;
+}
\ No newline at end of file
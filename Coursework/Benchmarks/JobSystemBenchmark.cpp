@@ -0,0 +1,27 @@
+#include "JobSystem.h"
+
+#include <cstdio>
+
+//Empty jobs on two to eight threads, so only the scheduling is timed: queueing a job, spawning and finishing many, a single job's
+//round trip and a job another thread has to wake and steal, against the same jobs as std::async tasks. The application's Benchmark
+//Jobs button runs the 10k row on its own system.
+int main()
+{
+	std::printf("%7s %7s %9s %10s %8s %10s %9s %11s %10s %9s\n", "threads", "jobs", "spawn ns", "jobs/ms", "stolen", "async/ms", "trip us", "async trip",
+		"steal us", "speedup");
+
+	for (int threads : { 2, 4, 8 })
+	{
+		JobSystem jobs(threads - 1);
+
+		for (int count : { 1000, 10000 })
+		{
+			JobSystem::BenchmarkResult result = JobSystem::benchmark(jobs, count);
+			std::printf("%7d %7d %9.1f %10.0f %7.1f%% %10.1f %9.2f %11.2f %10.2f %8.0fx\n", result.threads, result.jobs, result.spawnNanoseconds,
+				result.jobsPerMillisecond, result.stolenPercent, result.asyncJobsPerMillisecond, result.roundTripMicroseconds,
+				result.asyncRoundTripMicroseconds, result.stealMicroseconds, result.jobsPerMillisecond / result.asyncJobsPerMillisecond);
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
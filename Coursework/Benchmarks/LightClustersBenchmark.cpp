@@ -0,0 +1,63 @@
+#include "LightClusters.h"
+#include "JobSystem.h"
+
+#include <cstdio>
+#include <thread>
+
+//Cluster build time for 256, 1024 and 4096 lights scattered over the terrain, on one thread and on the job system with
+//a growing number of workers, looking down the terrain as the application's camera starts
+int main()
+{
+	const int iterations = 50;
+	const float nearZ = 0.1f;
+	const float farZ = 200.0f;
+
+	XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(0.0f, 10.0f, -20.0f, 1.0f), XMVectorSet(0.0f, 0.0f, 40.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+	XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, nearZ, farZ);
+
+	int hardwareThreads = (int)std::thread::hardware_concurrency();
+	std::vector<int> workerCounts = { 1, 2, 4 };
+
+	if (hardwareThreads - 1 > 4)
+	{
+		workerCounts.push_back(hardwareThreads - 1);
+	}
+
+	std::printf("%6s %9s %9s", "lights", "indices", "1 thread");
+
+	for (int workers : workerCounts)
+	{
+		std::printf(" %6d+1", workers);
+	}
+
+	std::printf("   (ms per build)\n");
+
+	for (int lightCount : { 256, 1024, 4096 })
+	{
+		LightSystem lights;
+		lights.addRandomLights(lightCount, XMFLOAT3(-50.0f, 1.0f, -10.0f), XMFLOAT3(50.0f, 8.0f, 90.0f));
+
+		std::vector<unsigned int> visible(lightCount);
+
+		for (int i = 0; i < lightCount; i++)
+		{
+			visible[i] = i;
+		}
+
+		LightClusters clusters;
+		float single = clusters.benchmark(lights, visible, view, projection, nearZ, farZ, false, iterations);
+		std::printf("%6d %9d %9.3f", lightCount, clusters.getStats().indexCount, single);
+
+		for (int workers : workerCounts)
+		{
+			JobSystem jobs(workers);
+			JobSystem::setShared(&jobs);
+			std::printf(" %8.3f", clusters.benchmark(lights, visible, view, projection, nearZ, farZ, true, iterations));
+			JobSystem::setShared(nullptr);
+		}
+
+		std::printf("\n");
+	}
+
+	return 0;
+}
\ No newline at end of file
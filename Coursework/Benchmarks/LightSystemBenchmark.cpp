@@ -0,0 +1,90 @@
+#include "AppLightLayout.h"
+#include "LightSystem.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+template<typename Function>
+static float averageMilliseconds(int iterations, Function function)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for (int iteration = 0; iteration < iterations; iteration++)
+	{
+		function();
+	}
+
+	return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / (float)iterations;
+}
+
+//Packing lights into the clustered light buffer layout from one object per light, as the shadowed AppLights are, against from
+//LightSystem's arrays, and culling them against a view frustum, for a few light counts. Each object is an AppLightLayout, which
+//AppLight.cpp holds to AppLight's size, so the packed fields are spread across the same bytes as in the application.
+int main()
+{
+	const int iterations = 200;
+
+	std::printf("%8s %12s %12s %11s %12s %10s\n", "lights", "objects ms", "arrays ms", "ns obj/arr", "cull ms", "visible");
+
+	for (int lightCount : { 1000, 10000, 100000 })
+	{
+		LightSystem system;
+		system.addRandomLights(lightCount, XMFLOAT3(-50.0f, 1.0f, -10.0f), XMFLOAT3(50.0f, 8.0f, 90.0f));
+
+		//Allocated one at a time and interleaved with other allocations, as lights created during scene setup are
+		std::vector<std::unique_ptr<AppLightLayout>> objects;
+		std::vector<std::unique_ptr<char[]>> clutter;
+
+		for (int i = 0; i < lightCount; i++)
+		{
+			std::unique_ptr<AppLightLayout> light(new AppLightLayout());
+			bool spot = system.getKinds()[i] == LightSystem::KIND_SPOT;
+
+			light->lightType = XMFLOAT4(0.0f, spot ? 0.0f : 1.0f, spot ? 1.0f : 0.0f, 0.0f);
+			light->position = XMVectorSet(system.getPositionX()[i], system.getPositionY()[i], system.getPositionZ()[i], 1.0f);
+			light->direction = system.getDirections()[i];
+			light->diffuseColour = system.getColours()[i];
+			light->range = system.getRanges()[i];
+			light->exponent = system.getSpotCosines()[i];
+			objects.push_back(std::move(light));
+			clutter.emplace_back(new char[64 + (i % 7) * 32]);
+		}
+
+		std::vector<LightSystem::PackedLight> packed(lightCount);
+		std::vector<unsigned int> indices(lightCount);
+
+		for (int i = 0; i < lightCount; i++)
+		{
+			indices[i] = i;
+		}
+
+		float objectMilliseconds = averageMilliseconds(iterations, [&]()
+		{
+			for (int i = 0; i < lightCount; i++)
+			{
+				const AppLightLayout* light = objects[i].get();
+
+				XMStoreFloat3(&packed[i].position, light->position);
+				packed[i].range = light->range;
+				packed[i].direction = light->direction;
+				packed[i].spotCosine = light->lightType.z > 0.0f ? light->exponent : -1.0f;
+				packed[i].colour = light->diffuseColour;
+			}
+		});
+
+		float arrayMilliseconds = averageMilliseconds(iterations, [&]() { system.pack(packed.data(), indices, lightCount); });
+
+		//A wide frustum looking down the terrain, so roughly half of the lights survive
+		Frustum frustum(XMMatrixLookAtLH(XMVectorSet(0.0f, 10.0f, -20.0f, 1.0f), XMVectorSet(0.0f, 0.0f, 40.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f))
+			* XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 200.0f));
+		std::vector<unsigned int> visible;
+
+		float cullMilliseconds = averageMilliseconds(iterations, [&]() { system.cull(frustum, visible); });
+
+		std::printf("%8d %12.4f %12.4f %5.2f/%5.2f %12.4f %10d\n", lightCount, objectMilliseconds, arrayMilliseconds,
+			(objectMilliseconds * 1e6f) / (float)lightCount, (arrayMilliseconds * 1e6f) / (float)lightCount, cullMilliseconds, (int)visible.size());
+	}
+
+	return 0;
+}
\ No newline at end of file
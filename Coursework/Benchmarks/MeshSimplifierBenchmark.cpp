@@ -0,0 +1,41 @@
+#include "MeshSimplifier.h"
+#include "JobSystem.h"
+#include "ObjFile.h"
+
+#include <cstdio>
+
+//Simplifies teapot.obj and ScaleBot.obj to 50%, 25% and 10% of their triangles, as the application's benchmark button does.
+//Reports the source triangles simplified per second on one thread and with the levels in parallel, and each level's quadric
+//error and farthest source vertex from its surface, both in model units beside the model's radius.
+int main()
+{
+	JobSystem jobs;
+	JobSystem::setShared(&jobs);
+
+	for (const char* name : { "teapot.obj", "ScaleBot.obj" })
+	{
+		ObjFile model;
+
+		if (!model.load(std::string(COURSEWORK_DIR) + "/res/" + name))
+		{
+			std::printf("Couldn't read res/%s\n", name);
+			continue;
+		}
+
+		MeshSimplifier::BenchmarkResult result = MeshSimplifier::benchmark(model.positions, model.indices, { 0.5f, 0.25f, 0.1f });
+
+		std::printf("%s: %d triangles, %d vertices, radius %.3f\n", name, result.triangles, (int)model.positions.size(), result.radius);
+		std::printf("  one thread %.2f ms, %.0f triangles/s, parallel levels %.2f ms, %.0f triangles/s, %s\n", result.singleMilliseconds,
+			result.singleTrianglesPerSecond, result.multiMilliseconds, result.multiTrianglesPerSecond, result.matches ? "identical" : "DIFFERENT");
+		std::printf("  %10s %14s %14s\n", "triangles", "quadric error", "max distance");
+
+		for (size_t level = 0; level < result.levelTriangles.size(); level++)
+		{
+			std::printf("  %10d %14.4f %14.4f\n", result.levelTriangles[level], result.levelError[level], result.levelDistance[level]);
+		}
+	}
+
+	JobSystem::setShared(nullptr);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "MomentShadow.h"
+
+#include <chrono>
+#include <cstdio>
+
+//Light bleeding of VSM and EVSM over two overlapping occluders, for each blur radius and bleeding reduction, with the time to encode
+//and prefilter a 1024x1024 moment map on one thread
+int main()
+{
+	const int size = 256;
+	ShadowFilter::DepthMap map = MomentShadow::buildBleedingTestMap(size, 0.8f);
+
+	std::printf("Light bleeding in the umbra of a %dx%d map\n", size, size);
+	std::printf("%-5s %6s %9s %13s %13s %9s\n", "mode", "radius", "reduction", "mean bleed", "max bleed", "texels");
+
+	for (int mode = MomentShadow::MODE_VSM; mode <= MomentShadow::MODE_EVSM; mode++)
+	{
+		for (int radius = 0; radius <= 5; radius++)
+		{
+			for (float reduction : { 0.0f, 0.1f, 0.2f, 0.3f })
+			{
+				MomentShadow moments((MomentShadow::Mode)mode);
+				moments.setBleedReduction(reduction);
+				moments.encodeDepthMap(map);
+				moments.blur(radius, radius > 1 ? (float)radius * 0.5f : 0.5f);
+
+				MomentShadow::BleedingResult result = moments.measureLightBleeding(map, 0.8f, 0.002f);
+				std::printf("%-5s %6d %9.1f %13.5f %13.5f %9.0f\n", mode == MomentShadow::MODE_VSM ? "VSM" : "EVSM", radius, reduction,
+					result.meanBleeding, result.maxBleeding, result.shadowedTexels);
+			}
+		}
+	}
+
+	ShadowFilter::DepthMap large = MomentShadow::buildBleedingTestMap(1024, 0.8f);
+
+	std::printf("\nEncode and blur, 1024x1024\n");
+
+	for (int mode = MomentShadow::MODE_VSM; mode <= MomentShadow::MODE_EVSM; mode++)
+	{
+		MomentShadow moments((MomentShadow::Mode)mode);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		moments.encodeDepthMap(large);
+		float encodeMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+		start = std::chrono::high_resolution_clock::now();
+		moments.blur(3, 1.5f);
+		float blurMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+		std::printf("%-5s encode %.2f ms, radius 3 blur %.2f ms\n", mode == MomentShadow::MODE_VSM ? "VSM" : "EVSM", encodeMilliseconds, blurMilliseconds);
+	}
+
+	return 0;
+}
\ No newline at end of file
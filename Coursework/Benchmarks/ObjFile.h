@@ -0,0 +1,111 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace DirectX;
+
+//Reads the triangles of a Wavefront OBJ for the headless benchmarks, which can't use AModel's importer. Each distinct position,
+//texture coordinate and normal triple becomes one vertex, as AModel's join of identical vertices gives, and polygons are split
+//into fans. Positions are left as written, without AModel's conversion to left handed.
+struct ObjFile
+{
+	std::vector<XMFLOAT3> positions;
+	std::vector<XMFLOAT2> textures;
+	std::vector<XMFLOAT3> normals;
+	std::vector<unsigned long> indices;
+
+	bool load(const std::string& filename)
+	{
+		FILE* file = std::fopen(filename.c_str(), "r");
+
+		if (!file)
+		{
+			return false;
+		}
+
+		std::vector<XMFLOAT3> filePositions;
+		std::vector<XMFLOAT2> fileTextures;
+		std::vector<XMFLOAT3> fileNormals;
+		std::map<std::tuple<int, int, int>, unsigned long> vertices;
+		char line[1024];
+
+		//OBJ indices count from one, or back from the end when negative
+		auto resolve = [](int index, size_t count)
+		{
+			return index < 0 ? (int)count + index : index - 1;
+		};
+
+		while (std::fgets(line, sizeof(line), file))
+		{
+			XMFLOAT3 value(0.0f, 0.0f, 0.0f);
+
+			if (std::strncmp(line, "v ", 2) == 0 && std::sscanf(line + 2, "%f %f %f", &value.x, &value.y, &value.z) == 3)
+			{
+				filePositions.push_back(value);
+			}
+
+			else if (std::strncmp(line, "vt ", 3) == 0 && std::sscanf(line + 3, "%f %f", &value.x, &value.y) == 2)
+			{
+				fileTextures.push_back(XMFLOAT2(value.x, value.y));
+			}
+
+			else if (std::strncmp(line, "vn ", 3) == 0 && std::sscanf(line + 3, "%f %f %f", &value.x, &value.y, &value.z) == 3)
+			{
+				fileNormals.push_back(value);
+			}
+
+			else if (std::strncmp(line, "f ", 2) == 0)
+			{
+				std::vector<unsigned long> polygon;
+				char* token = std::strtok(line + 2, " \t\r\n");
+
+				while (token)
+				{
+					//v, v/vt, v//vn or v/vt/vn
+					int position = std::atoi(token);
+					int texture = 0;
+					int normal = 0;
+					char* slash = std::strchr(token, '/');
+
+					if (slash)
+					{
+						texture = slash[1] != '/' ? std::atoi(slash + 1) : 0;
+						char* second = std::strchr(slash + 1, '/');
+						normal = second ? std::atoi(second + 1) : 0;
+					}
+
+					std::tuple<int, int, int> key(resolve(position, filePositions.size()), texture ? resolve(texture, fileTextures.size()) : -1,
+						normal ? resolve(normal, fileNormals.size()) : -1);
+					auto found = vertices.find(key);
+
+					if (found == vertices.end())
+					{
+						found = vertices.emplace(key, (unsigned long)positions.size()).first;
+						positions.push_back(filePositions[std::get<0>(key)]);
+						textures.push_back(std::get<1>(key) >= 0 ? fileTextures[std::get<1>(key)] : XMFLOAT2(0.0f, 0.0f));
+						normals.push_back(std::get<2>(key) >= 0 ? fileNormals[std::get<2>(key)] : XMFLOAT3(0.0f, 0.0f, 0.0f));
+					}
+
+					polygon.push_back(found->second);
+					token = std::strtok(nullptr, " \t\r\n");
+				}
+
+				for (size_t i = 2; i < polygon.size(); i++)
+				{
+					indices.insert(indices.end(), { polygon[0], polygon[i - 1], polygon[i] });
+				}
+			}
+		}
+
+		std::fclose(file);
+
+		return !indices.empty();
+	}
+};
\ No newline at end of file
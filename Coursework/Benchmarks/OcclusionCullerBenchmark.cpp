@@ -0,0 +1,29 @@
+#include "OcclusionCuller.h"
+#include "JobSystem.h"
+
+#include <cstdio>
+
+//Culling a hundred thousand props among cities of 16 x 16 to 64 x 64 buildings, from a street corner. Times binning the buildings'
+//triangles, rasterising the tiles on one thread and on every thread, building the pyramid and testing each prop the frustum kept.
+//The application's Benchmark Occlusion button runs the 32 and 64 block cities.
+int main()
+{
+	JobSystem jobs;
+	JobSystem::setShared(&jobs);
+
+	std::printf("%d threads\n", jobs.getThreadCount());
+	std::printf("%9s %9s %9s %9s %8s %12s %12s %8s %8s %9s\n", "buildings", "triangles", "in view", "occluded", "bin ms", "raster 1T ms", "raster MT ms",
+		"speedup", "hi-z ms", "ns/test");
+
+	for (int blocks : { 16, 32, 64 })
+	{
+		OcclusionCuller::BenchmarkResult result = OcclusionCuller::benchmark(blocks, 100000, 10);
+		std::printf("%9d %9d %9d %9d %8.3f %12.3f %12.3f %7.2fx %8.3f %9.1f\n", result.buildings, result.triangles, result.inFrustum, result.occluded,
+			result.binMilliseconds, result.singleMilliseconds, result.multiMilliseconds, result.singleMilliseconds / result.multiMilliseconds,
+			result.hiZMilliseconds, result.testNanoseconds);
+	}
+
+	JobSystem::setShared(nullptr);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#include "SceneGraph.h"
+#include "JobSystem.h"
+
+#include <cstdio>
+
+//Hierarchy updates of graphs up to a million nodes, every node after the root moves and one node in a hundred after random turns,
+//on one thread and on every thread. The application's Benchmark Scene Graph button runs the million node, eight way case.
+int main()
+{
+	JobSystem jobs;
+	JobSystem::setShared(&jobs);
+
+	std::printf("%d threads\n", jobs.getThreadCount());
+	std::printf("%9s %6s %6s %12s %12s %8s %12s %12s %9s %10s\n", "nodes", "branch", "depth", "root 1T ms", "root MT ms", "speedup", "sparse 1T ms",
+		"sparse MT ms", "updated", "max diff");
+
+	for (int nodes : { 10000, 100000, 1000000 })
+	{
+		for (int branching : { 2, 8, 32 })
+		{
+			SceneGraph::BenchmarkResult result = SceneGraph::benchmark(nodes, branching, 10);
+			std::printf("%9d %6d %6d %12.3f %12.3f %7.2fx %12.3f %12.3f %9d %10g\n", result.nodes, branching, result.depth, result.rootSingleMilliseconds,
+				result.rootMultiMilliseconds, result.rootSingleMilliseconds / result.rootMultiMilliseconds, result.sparseSingleMilliseconds,
+				result.sparseMultiMilliseconds, result.sparseNodes, result.maxDifference);
+		}
+	}
+
+	JobSystem::setShared(nullptr);
+
+	return 0;
+}
\ No newline at end of file
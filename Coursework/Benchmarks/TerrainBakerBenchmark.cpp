@@ -0,0 +1,26 @@
+#include "TerrainBaker.h"
+#include "JobSystem.h"
+
+#include <cstdio>
+
+//Normal map bake of generated heightmaps from 1k to 8k, scalar and SIMD on one thread and SIMD on the job system
+int main()
+{
+	JobSystem jobs;
+	JobSystem::setShared(&jobs);
+
+	std::printf("%6s %11s %11s %11s %13s %12s\n", "size", "scalar ms", "simd ms", "threads ms", "Mtexels/s", "max diff");
+
+	for (int size : { 1024, 2048, 4096, 8192 })
+	{
+		TerrainBaker::BenchmarkResult result = TerrainBaker::benchmark(size);
+		float megatexels = ((float)size * (float)size) / 1e6f;
+
+		std::printf("%6d %11.2f %11.2f %11.2f %13.1f %12.5f\n", result.size, result.scalarMilliseconds, result.simdMilliseconds,
+			result.multithreadedMilliseconds, megatexels / (result.multithreadedMilliseconds * 0.001f), result.maxDifference);
+	}
+
+	JobSystem::setShared(nullptr);
+
+	return 0;
+}
\ No newline at end of file
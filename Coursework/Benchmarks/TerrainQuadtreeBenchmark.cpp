@@ -0,0 +1,28 @@
+#include "TerrainQuadtree.h"
+#include "JobSystem.h"
+
+#include <cstdio>
+
+//Tree build and per view LOD selection over generated 4k and 16k heightmaps with 64 and 32 cell chunks, as the
+//application's terrain panel runs them, with the build on the job system
+int main()
+{
+	JobSystem jobs;
+	JobSystem::setShared(&jobs);
+
+	std::printf("%6s %6s %8s %12s %10s %11s %10s %10s\n", "size", "chunk", "nodes", "generate ms", "build ms", "select ms", "selected", "triangles");
+
+	for (int size : { 4096, 16384 })
+	{
+		for (int chunk : { 64, 32 })
+		{
+			TerrainQuadtree::BenchmarkResult result = TerrainQuadtree::benchmark(size, chunk, 16);
+			std::printf("%6d %6d %8d %12.1f %10.2f %11.4f %10.1f %9.3f%%\n", result.heightFieldSize, chunk, result.nodeCount, result.generateMilliseconds,
+				result.buildMilliseconds, result.selectMilliseconds, result.selectedNodes, result.triangleRatio * 100.0f);
+		}
+	}
+
+	JobSystem::setShared(nullptr);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "TerrainTessellation.h"
+
+#include <cstdio>
+#include <initializer_list>
+
+//Triangles the tessellated terrain draws from each of 16 views around the scene's 100 unit terrain, at the application's
+//default 32 x 32 patches, 16 pixels per edge and a factor of up to 16, then the averages over other settings
+int main()
+{
+	const int views = 16;
+	const float world = 100.0f;
+
+	XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 200.0f);
+	XMFLOAT4X4 projectionValues;
+	XMStoreFloat4x4(&projectionValues, projection);
+
+	TerrainTessellation::Settings settings;
+	settings.amplitude = 10.0f;
+	settings.projectionScale = projectionValues._22 * 540.0f;
+	settings.pixelsPerEdge = 16.0f;
+	settings.minFactor = 1.0f;
+	settings.maxFactor = 16.0f;
+
+	std::printf("%5s %8s %10s %8s\n", "view", "patches", "triangles", "factor");
+
+	//The same ring of views as TerrainTessellation::benchmark()
+	for (int view = 0; view < views; view++)
+	{
+		float angle = XM_2PI * (float)view / (float)views;
+		XMFLOAT3 eye((world * 0.5f) + (cosf(angle) * world * 0.3f), settings.amplitude * 1.2f, (world * 0.5f) + (sinf(angle) * world * 0.3f));
+		XMMATRIX viewMatrix = XMMatrixLookAtLH(XMVectorSet(eye.x, eye.y, eye.z, 1.0f), XMVectorSet(world * 0.5f, 0.0f, world * 0.5f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+
+		settings.cameraPosition = eye;
+		TerrainTessellation::ViewStats stats = TerrainTessellation::measureView(settings, Frustum(viewMatrix * projection), 32, world);
+		std::printf("%5d %8d %10d %8.2f\n", view, stats.visiblePatches, stats.triangles, stats.averageFactor);
+	}
+
+	std::printf("\n%7s %6s %6s %10s %10s %10s %8s %8s %10s\n", "patches", "pixels", "max", "min tris", "avg tris", "max tris", "visible", "plane", "ms/view");
+
+	for (int patches : { 16, 32, 64 })
+	{
+		for (float pixels : { 8.0f, 16.0f, 32.0f })
+		{
+			for (float maxFactor : { 16.0f, 64.0f })
+			{
+				TerrainTessellation::BenchmarkResult result = TerrainTessellation::benchmark(patches, pixels, maxFactor, views);
+				std::printf("%7d %6.0f %6.0f %10.0f %10.0f %10.0f %8.1f %8d %10.4f\n", patches, pixels, maxFactor, result.minTriangles, result.averageTriangles,
+					result.maxTriangles, result.averagePatches, result.planeTriangles, result.milliseconds);
+			}
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "VertexPacker.h"
+#include "ObjFile.h"
+
+#include <cstdio>
+#include <random>
+
+static void printReport(const VertexPacker::Report& report)
+{
+	std::printf("%-14s %9d %9d %9d %9d %11.3e %11.3e %9.4f %9.4f %9.6f %8.2f %9.1f\n", report.name.c_str(), report.vertices, report.floatBytes, report.packedBytes,
+		report.compactBytes, report.packedError.position, report.packedError.positionBound, report.packedError.normalDegrees, report.compactError.normalDegrees,
+		report.packedError.texture, report.milliseconds, (float)report.vertices / (report.milliseconds * 1000.0f));
+}
+
+//Packs teapot.obj, ScaleBot.obj and a million random vertices into both packed formats and back, as the application's Vertex
+//Packing button does. Reports the bytes of each format, the largest position error against its half step bound, the normal
+//error of the 16 and 8 bit normals, the texture coordinate error and the time to encode and decode both formats.
+int main()
+{
+	std::printf("%-14s %9s %9s %9s %9s %11s %11s %9s %9s %9s %8s %9s\n", "mesh", "vertices", "float B", "packed B", "compact B", "position", "bound",
+		"normal16", "normal8", "texture", "ms", "Mverts/s");
+
+	for (const char* name : { "teapot.obj", "ScaleBot.obj" })
+	{
+		ObjFile model;
+
+		if (!model.load(std::string(COURSEWORK_DIR) + "/res/" + name))
+		{
+			std::printf("Couldn't read res/%s\n", name);
+			continue;
+		}
+
+		std::vector<VertexFormats::VertexType> vertices(model.positions.size());
+
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			vertices[i] = { model.positions[i], model.textures[i], model.normals[i] };
+		}
+
+		printReport(VertexPacker::measure(name, vertices.data(), (int)vertices.size()));
+	}
+
+	//Random directions and texture coordinates up to 8, where half floats are coarsest
+	std::mt19937 random(1);
+	std::normal_distribution<float> direction(0.0f, 1.0f);
+	std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+	std::vector<VertexFormats::VertexType> vertices(1000000);
+
+	for (VertexFormats::VertexType& vertex : vertices)
+	{
+		vertex.position = XMFLOAT3(uniform(random) * 100.0f, uniform(random) * 20.0f, uniform(random) * 100.0f);
+		vertex.texture = XMFLOAT2(uniform(random) * 8.0f, uniform(random) * 8.0f);
+		XMStoreFloat3(&vertex.normal, XMVector3Normalize(XMVectorSet(direction(random), direction(random), direction(random), 0.0f)));
+	}
+
+	printReport(VertexPacker::measure("1M random", vertices.data(), (int)vertices.size()));
+
+	return 0;
+}
\ No newline at end of file
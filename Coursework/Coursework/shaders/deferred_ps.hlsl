@@ -0,0 +1,69 @@
+// Deferred lighting pixel shader, a full screen pass that lights each G-buffer pixel once for all of the lights
+
+#include "lighting.hlsli"
+#include "gbuffer.hlsli"
+
+Texture2D albedoTexture : register(t0);
+Texture2D normalTexture : register(t13);
+Texture2D viewDepthTexture : register(t14);
+
+//LightShader's vertex shader matrices, only the light matrices are used here
+cbuffer MatrixBuffer : register(b4)
+{
+    matrix worldMatrix;
+    matrix viewMatrix;
+    matrix projectionMatrix;
+    matrix lightViewMatrix[4];
+    matrix lightProjectionMatrix[4];
+};
+
+cbuffer DeferredBuffer : register(b5)
+{
+    matrix inverseView;
+    matrix inverseProjection;
+    float3 cameraPosition;
+    float deferredPadding;
+    float2 gBufferSize;
+    float2 gBufferPadding;
+};
+
+struct InputType
+{
+    float4 position : SV_POSITION;
+    float2 tex : TEXCOORD0;
+    float3 normal : NORMAL;
+};
+
+float4 main(InputType input) : SV_TARGET
+{
+    int3 texel = int3(input.position.xy, 0);
+    float depth = viewDepthTexture.Load(texel).r;
+
+    //Nothing was drawn here, show the clear colour
+    if (depth <= 0.0f)
+    {
+        return float4(0.35f, 0.35f, 0.35f, 1.0f);
+    }
+
+    float4 textureColour = albedoTexture.Load(texel);
+    float3 normals = decodeNormal(normalTexture.Load(texel).xy);
+
+    //If normals are set to render, don't calculate lighting, return normals for the current pixel
+    if (renderType == 1.0f || renderType == 3.0f)
+    {
+        return float4(normals.xyz, 1.0f);
+    }
+
+    float3 worldPosition = reconstructPosition(input.position.xy / gBufferSize, depth, inverseProjection, inverseView);
+    float3 viewVector = normalize(cameraPosition - worldPosition);
+    float4 lightViewPosition[4];
+
+    [unroll]
+    for (int i = 0; i < 4; i++)
+    {
+        lightViewPosition[i] = mul(float4(worldPosition, 1.0f), lightViewMatrix[i]);
+        lightViewPosition[i] = mul(lightViewPosition[i], lightProjectionMatrix[i]);
+    }
+
+    return shadeSurface(worldPosition, normals, viewVector, lightViewPosition, float4(input.position.xy, 0.0f, depth), textureColour);
+}
\ No newline at end of file
@@ -0,0 +1,3 @@
+// depth_vs over packed vertices, for meshes drawn with BaseMesh::setDrawPacked
+#define PACKED_VERTICES
+#include "depth_vs.hlsl"
\ No newline at end of file
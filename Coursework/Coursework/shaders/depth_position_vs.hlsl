@@ -0,0 +1,3 @@
+// depth_vs over separate position and texture coordinate streams, for meshes drawn with BaseMesh::sendPositionData
+#define POSITION_STREAMS
+#include "depth_vs.hlsl"
\ No newline at end of file
@@ -2,28 +2,45 @@ cbuffer DepthBuffer : register(b0)
 {
     float near;
     float far;
-    float2 padding;
+    float projectionType;
+    float momentMode;
 }
 
+//Must match MomentShadow and light_ps.hlsl
+static const float positiveExponent = 40.0f;
+static const float negativeExponent = 5.0f;
+
 struct InputType
 {
     float4 position : SV_POSITION;
     float4 depthPosition : TEXCOORD0;
 };
 
-float lineariseDepthValue(float depth)
+//Linear depth from the light in the range (0,1), orthographic depth is already linear
+float getMomentDepth(float4 depthPosition)
 {
-    float z = depth * 2.0f - 1.0f;  //Converting back to normalised device coordinates
+    if (projectionType == 0.0f)
+    {
+        return depthPosition.z / depthPosition.w;
+    }
     
-    return ((2.0f * near * far) / (far + near - z * (far - near)));
+    return saturate((depthPosition.w - near) / (far - near));
 }
 
 float4 main(InputType input) : SV_TARGET
 {
-    // Get the depth value of the pixel by dividing the Z pixel depth by the homogeneous W coordinate.
-    float depthValue = input.depthPosition.z / input.depthPosition.w;
+    //Only kept when rendering to a moment map, the hardware shadow maps bind no render target
+    float depth = getMomentDepth(input.depthPosition);
+    
+    if (momentMode < 1.0f)   //Variance shadow map
+    {
+        return float4(depth, depth * depth, 0.0f, 0.0f);
+    }
     
-    float linearDepth = lineariseDepthValue(depthValue);
+    //Exponential variance shadow map, depth is warped from (-1,1) so both exponents stay in range once squared
+    float warped = (depth * 2.0f) - 1.0f;
+    float positive = exp(positiveExponent * warped);
+    float negative = -exp(-negativeExponent * warped);
     
-    return float4(linearDepth, linearDepth, linearDepth, 1.0f);
+    return float4(positive, positive * positive, negative, negative * negative);
 }
\ No newline at end of file
@@ -19,9 +19,15 @@ struct InputType
 {
     float4 position : POSITION;
     float2 tex : TEXCOORD0;
+#ifndef POSITION_STREAMS
     float3 normal : NORMAL;
+#endif
 };
 
+#ifdef PACKED_VERTICES
+#include "packed_vertex.hlsli"
+#endif
+
 struct OutputType
 {
     float4 position : SV_POSITION;
@@ -35,8 +41,14 @@ float getHeight(float2 uv)
     return height;
 }
 
+#ifdef PACKED_VERTICES
+OutputType main(PackedInputType packed)
+{
+    InputType input = unpackVertex(packed);
+#else
 OutputType main(InputType input)
 {
+#endif
     OutputType output;
 
     if (geometryType < 1.0f)
@@ -0,0 +1,37 @@
+// G-buffer encoding shared by gbuffer_ps.hlsl and deferred_ps.hlsl, must match GBufferEncoding
+
+//Octahedral normals - the unit sphere is projected onto an octahedron and unfolded into the (-1,1) square,
+//so two signed normalised channels hold a normal with roughly even precision in every direction
+float2 octahedralWrap(float2 v)
+{
+    return (1.0f - abs(v.yx)) * float2(v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f);
+}
+
+float2 encodeNormal(float3 normal)
+{
+    normal /= (abs(normal.x) + abs(normal.y) + abs(normal.z));
+    normal.xy = normal.z >= 0.0f ? normal.xy : octahedralWrap(normal.xy);
+
+    return normal.xy;
+}
+
+float3 decodeNormal(float2 encoded)
+{
+    float3 normal = float3(encoded.x, encoded.y, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float t = saturate(-normal.z);
+    normal.xy += float2(normal.x >= 0.0f ? -t : t, normal.y >= 0.0f ? -t : t);
+
+    return normalize(normal);
+}
+
+//World position from the view space depth stored in the G-buffer, by scaling the view ray through the pixel
+float3 reconstructPosition(float2 uv, float viewDepth, matrix inverseProjection, matrix inverseView)
+{
+    float2 ndc = float2((uv.x * 2.0f) - 1.0f, 1.0f - (uv.y * 2.0f));
+    float4 viewRay = mul(float4(ndc, 1.0f, 1.0f), inverseProjection);
+    viewRay.xyz /= viewRay.w;
+
+    float3 viewPosition = viewRay.xyz * (viewDepth / viewRay.z);
+
+    return mul(float4(viewPosition, 1.0f), inverseView).xyz;
+}
\ No newline at end of file
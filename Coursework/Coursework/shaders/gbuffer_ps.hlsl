@@ -0,0 +1,44 @@
+// G-buffer pixel shader, writes the surface attributes read by the deferred lighting pass
+
+#include "lighting.hlsli"
+#include "gbuffer.hlsli"
+
+Texture2D texture0 : register(t0);
+
+//Only the leading attributes of light_vs.hlsl are read, so the billboarding geometry shader can write here as well
+struct InputType
+{
+    float4 position : SV_POSITION;
+    float2 tex : TEXCOORD0;
+    float3 normal : NORMAL;
+};
+
+struct OutputType
+{
+    float4 albedo : SV_TARGET0;     //R8G8B8A8_UNORM
+    float2 normal : SV_TARGET1;     //R16G16_SNORM, octahedral
+    float depth : SV_TARGET2;       //R32_FLOAT, view space depth, zero where nothing was drawn
+};
+
+OutputType main(InputType input)
+{
+    OutputType output;
+    float3 normals = input.normal;
+
+    float4 textureColour = texture0.Sample(diffuseSampler, input.tex);
+
+    //Transparent texels are cut out rather than blended, there is only one surface per pixel
+    clip(textureColour.a - 0.9f);
+
+    //If working with the terrain and per pixel normal calculations are selected
+    if ((geometryType < 1.0f || geometryType >= 2.0f) && renderType <= 1.0f)
+    {
+        normals = getTerrainNormal(input.tex, input.normal);
+    }
+
+    output.albedo = float4(textureColour.rgb, 1.0f);
+    output.normal = encodeNormal(normalize(normals));
+    output.depth = input.position.w;
+
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+// Grass pixel shader, lit as light_ps with the blade texture's alpha kept for alpha to coverage or blending
+
+#include "lighting.hlsli"
+
+Texture2D texture0 : register(t0);
+
+cbuffer TransparencyBuffer : register(b4)
+{
+    float transparency; //0 cuts out the transparent texels, 1 is alpha to coverage, 2 is blended back to front
+    float3 padding;
+};
+
+struct InputType
+{
+    float4 position : SV_POSITION;
+    float2 tex : TEXCOORD0;
+    float3 normal : NORMAL;
+    float3 worldPosition : TEXCOORD1;
+    float3 viewVector : TEXCOORD2;
+    float4 lightViewPosition[4] : TEXCOORD3;
+};
+
+float4 main(InputType input) : SV_TARGET
+{
+    float4 textureColour = texture0.Sample(diffuseSampler, input.tex);
+    float alpha = textureColour.a;
+    
+    if (transparency == 1.0f)
+    {
+        //Sharpen the edge to about a pixel wide around half alpha, so the coverage mask anti-aliases the cut out rather than dithering the whole blade
+        alpha = saturate(((alpha - 0.5f) / max(fwidth(alpha), 0.0001f)) + 0.5f);
+    }
+    
+    else if (transparency < 1.0f)
+    {
+        alpha = alpha >= 0.9f ? 1.0f : 0.0f;
+    }
+    
+    clip(alpha - (1.0f / 255.0f));
+    
+    //If normals are set to render, don't calculate lighting, return normals for the current pixel
+    if (renderType == 1.0f || renderType == 3.0f)
+    {
+        return float4(input.normal, 1.0f);
+    }
+    
+    float4 colour = shadeSurface(input.worldPosition, input.normal, input.viewVector, input.lightViewPosition, input.position, float4(textureColour.rgb, 1.0f));
+    
+    //The blend state adds the source without scaling it by alpha
+    if (transparency >= 2.0f)
+    {
+        return float4(colour.rgb * alpha, alpha);
+    }
+    
+    return float4(colour.rgb, alpha);
+}
\ No newline at end of file
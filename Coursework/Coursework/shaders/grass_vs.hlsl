@@ -0,0 +1,68 @@
+// Instanced grass vertex shader, places the shared blade mesh at each scattered instance's position with its scale and rotation.
+// Replaces the billboarding geometry shader, which built a camera facing quad for every vertex of the plane.
+
+cbuffer MatrixBuffer : register(b0)
+{
+    matrix worldMatrix;
+    matrix viewMatrix;
+    matrix projectionMatrix;
+};
+
+cbuffer GrassBuffer : register(b1)
+{
+    float3 cameraPosition;
+    float amplitude;    //The instance heights are normalised, like the heightmap
+};
+
+struct InputType
+{
+    float4 position : POSITION;
+    float2 tex : TEXCOORD0;
+    float3 normal : NORMAL;
+    float3 instancePosition : INSTANCEPOSITION;
+    float2 instanceScaleRotation : INSTANCESCALEROTATION;
+    float2 instanceBend : INSTANCEBEND;     //From GrassWind, in terrain space
+};
+
+struct OutputType
+{
+    float4 position : SV_POSITION;
+    float2 tex : TEXCOORD0;
+    float3 normal : NORMAL;
+    float3 worldPosition : TEXCOORD1;
+    float3 viewVector : TEXCOORD2;
+    float4 lightViewPosition[4] : TEXCOORD3;
+};
+
+OutputType main(InputType input)
+{
+    OutputType output = (OutputType)0;
+    
+    float scale = input.instanceScaleRotation.x;
+    float sine, cosine;
+    sincos(input.instanceScaleRotation.y, sine, cosine);
+    
+    //Rotate the blade about the vertical axis, then stand it on the terrain
+    float3 local = input.position.xyz * scale;
+    float3 rotated = float3((local.x * cosine) - (local.z * sine), local.y, (local.x * sine) + (local.z * cosine));
+    
+    //Bend along a curve that is flat at the root, lowering the tip so the blade keeps roughly its length
+    float along = input.position.y * 0.5f;
+    float bendAmount = along * along;
+    rotated.xz += input.instanceBend * (bendAmount * 2.0f * scale);
+    rotated.y *= 1.0f - (0.3f * dot(input.instanceBend, input.instanceBend) * along);
+    float3 base = float3(input.instancePosition.x, input.instancePosition.y * amplitude, input.instancePosition.z);
+    
+    float4 worldPosition = mul(float4(base + rotated, 1.0f), worldMatrix);
+    output.position = mul(worldPosition, viewMatrix);
+    output.position = mul(output.position, projectionMatrix);
+    
+    float3 normal = float3((input.normal.x * cosine) - (input.normal.z * sine), input.normal.y, (input.normal.x * sine) + (input.normal.z * cosine));
+    output.normal = normalize(mul(normal, (float3x3)worldMatrix));
+    
+    output.tex = input.tex;
+    output.worldPosition = worldPosition.xyz;
+    output.viewVector = normalize(cameraPosition - worldPosition.xyz);
+
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+// Octahedral impostor atlas shared by the impostor shaders, the frame directions and axes must match ImpostorBaker
+
+#include "gbuffer.hlsli"
+
+Texture2D impostorAlbedo : register(t13);
+Texture2D impostorNormals : register(t14);
+Texture2D impostorDepth : register(t15);
+SamplerState impostorSampler : register(s4);
+
+cbuffer ImpostorBuffer : register(b4)
+{
+    matrix impostorWorld;
+    float3 impostorCameraPosition;
+    float impostorRadius;   //Bounding sphere of the model, in model space
+    float3 impostorCentre;
+    float framesPerSide;
+};
+
+struct ImpostorSample
+{
+    float4 albedo;
+    float3 normal;      //Model space
+    float3 position;    //Model space, relative to the centre in units of the radius
+};
+
+//Axes of a frame's image plane for a view direction from the centre, x to the right and y up
+void getFrameAxes(float3 direction, out float3 right, out float3 up)
+{
+    float3 worldUp = abs(direction.y) > 0.999f ? float3(0.0f, 0.0f, 1.0f) : float3(0.0f, 1.0f, 0.0f);
+    float3 forward = -direction;
+    right = normalize(cross(worldUp, forward));
+    up = cross(forward, right);
+}
+
+//Blends the four frames around the view direction. Each frame is looked up where the billboard's point projects onto its own
+//image plane, and the colours are weighted by coverage so the silhouettes of the frames don't darken each other.
+ImpostorSample sampleImpostor(float3 direction, float3 planePoint)
+{
+    ImpostorSample result = (ImpostorSample)0;
+    
+    float2 grid = ((((encodeNormal(direction) * 0.5f) + 0.5f) * framesPerSide) - 0.5f);
+    float2 first = clamp(floor(grid), 0.0f, framesPerSide - 1.0f);
+    float2 blend = saturate(grid - first);
+    
+    [unroll]
+    for (int i = 0; i < 4; i++)
+    {
+        float2 offset = float2(i & 1, i >> 1);
+        float2 frame = min(first + offset, framesPerSide - 1.0f);
+        float weight = lerp(1.0f - blend.x, blend.x, offset.x) * lerp(1.0f - blend.y, blend.y, offset.y);
+        
+        float3 frameDirection = decodeNormal((((frame + 0.5f) / framesPerSide) * 2.0f) - 1.0f);
+        float3 right, up;
+        getFrameAxes(frameDirection, right, up);
+        
+        float2 framePoint = float2(dot(planePoint, right), dot(planePoint, up));
+        float2 uv = saturate(float2((framePoint.x * 0.5f) + 0.5f, 0.5f - (framePoint.y * 0.5f)));
+        float2 atlasUV = (frame + uv) / framesPerSide;
+        
+        float4 albedo = impostorAlbedo.Sample(impostorSampler, atlasUV);
+        float3 normal = (impostorNormals.Sample(impostorSampler, atlasUV).xyz * 2.0f) - 1.0f;
+        float depth = (impostorDepth.Sample(impostorSampler, atlasUV).r * 2.0f) - 1.0f;
+        float covered = albedo.a * weight;
+        
+        result.albedo += float4(albedo.rgb * covered, covered);
+        result.normal += normal * covered;
+        result.position += ((right * framePoint.x) + (up * framePoint.y) + (frameDirection * depth)) * covered;
+    }
+    
+    float inverseCoverage = 1.0f / max(result.albedo.a, 0.0001f);
+    result.albedo.rgb *= inverseCoverage;
+    result.normal = normalize(result.normal + float3(0.0f, 0.0001f, 0.0f));
+    result.position *= inverseCoverage;
+    
+    return result;
+}
+
+//World space position of a point relative to the centre, in units of the radius
+float3 getImpostorWorldPosition(float3 position)
+{
+    return mul(float4(impostorCentre + (position * impostorRadius), 1.0f), impostorWorld).xyz;
+}
+
+//Model to world for directions, the world matrix is taken to be a rotation and uniform scale
+float3 getImpostorWorldNormal(float3 normal)
+{
+    return normalize(mul(normal, (float3x3)impostorWorld));
+}
\ No newline at end of file
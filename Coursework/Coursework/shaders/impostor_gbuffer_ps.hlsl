@@ -0,0 +1,40 @@
+// Impostor G-buffer pixel shader, writes the blended atlas frames' surface attributes as gbuffer_ps writes the model's
+
+#include "impostor.hlsli"
+
+struct InputType
+{
+    float4 position : SV_POSITION;
+    float2 tex : TEXCOORD0;
+    float3 normal : NORMAL;
+    float3 worldPosition : TEXCOORD1;
+    float3 viewVector : TEXCOORD2;
+    float3 direction : TEXCOORD3;
+    float3 planePoint : TEXCOORD4;
+};
+
+struct OutputType
+{
+    float4 albedo : SV_TARGET0;     //R8G8B8A8_UNORM
+    float2 normal : SV_TARGET1;     //R16G16_SNORM, octahedral
+    float depth : SV_TARGET2;       //R32_FLOAT, view space depth, zero where nothing was drawn
+};
+
+OutputType main(InputType input)
+{
+    OutputType output;
+    
+    float3 direction = normalize(input.direction);
+    ImpostorSample impostor = sampleImpostor(direction, input.planePoint);
+    
+    clip(impostor.albedo.a - 0.5f);
+    
+    //The baked surface is nearer or farther than the billboard along the view, roughly the view depth for a distant model
+    float worldRadius = impostorRadius * length(impostorWorld[0].xyz);
+    
+    output.albedo = float4(impostor.albedo.rgb, 1.0f);
+    output.normal = encodeNormal(getImpostorWorldNormal(impostor.normal));
+    output.depth = input.position.w - (dot(impostor.position, direction) * worldRadius);
+    
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+// Impostor pixel shader, lights the blended atlas frames with the model's baked normals as light_ps lights the model
+
+#include "lighting.hlsli"
+#include "impostor.hlsli"
+
+struct InputType
+{
+    float4 position : SV_POSITION;
+    float2 tex : TEXCOORD0;
+    float3 normal : NORMAL;
+    float3 worldPosition : TEXCOORD1;
+    float3 viewVector : TEXCOORD2;
+    float3 direction : TEXCOORD3;
+    float3 planePoint : TEXCOORD4;
+};
+
+float4 main(InputType input) : SV_TARGET
+{
+    ImpostorSample impostor = sampleImpostor(normalize(input.direction), input.planePoint);
+    
+    clip(impostor.albedo.a - 0.5f);
+    
+    float3 normals = getImpostorWorldNormal(impostor.normal);
+    
+    //If normals are set to render, don't calculate lighting, return normals for the current pixel
+    if (renderType == 1.0f || renderType == 3.0f)
+    {
+        return float4(normals, 1.0f);
+    }
+    
+    //Lit at the baked surface rather than on the billboard. Distant impostors aren't shadowed, their light space positions are outside every shadow map.
+    float3 worldPosition = getImpostorWorldPosition(impostor.position);
+    float4 outside = float4(2.0f, 2.0f, 0.0f, 1.0f);
+    float4 lightViewPosition[4] = { outside, outside, outside, outside };
+    
+    return shadeSurface(worldPosition, normals, normalize(impostorCameraPosition - worldPosition), lightViewPosition, input.position, float4(impostor.albedo.rgb, 1.0f));
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+// Impostor vertex shader, turns the unit quad into a billboard over the model's bounding sphere, facing the camera
+
+#include "impostor.hlsli"
+
+cbuffer MatrixBuffer : register(b0)
+{
+    matrix worldMatrix;
+    matrix viewMatrix;
+    matrix projectionMatrix;
+};
+
+struct InputType
+{
+    float4 position : POSITION;
+    float2 tex : TEXCOORD0;
+    float3 normal : NORMAL;
+};
+
+struct OutputType
+{
+    float4 position : SV_POSITION;
+    float2 tex : TEXCOORD0;
+    float3 normal : NORMAL;
+    float3 worldPosition : TEXCOORD1;
+    float3 viewVector : TEXCOORD2;
+    float3 direction : TEXCOORD3;   //Model space, from the centre towards the camera
+    float3 planePoint : TEXCOORD4;  //Model space, relative to the centre in units of the radius
+};
+
+OutputType main(InputType input)
+{
+    OutputType output;
+    
+    //The transpose of a rotation and uniform scale takes a world direction back into model space, up to its length
+    float3 worldCentre = mul(float4(impostorCentre, 1.0f), worldMatrix).xyz;
+    float3 direction = normalize(mul((float3x3)worldMatrix, impostorCameraPosition - worldCentre));
+    
+    float3 right, up;
+    getFrameAxes(direction, right, up);
+    
+    float3 planePoint = (right * input.position.x) + (up * input.position.y);
+    float4 worldPosition = mul(float4(impostorCentre + (planePoint * impostorRadius), 1.0f), worldMatrix);
+    
+    output.position = mul(worldPosition, viewMatrix);
+    output.position = mul(output.position, projectionMatrix);
+    
+    output.tex = input.tex;
+    output.normal = normalize(impostorCameraPosition - worldCentre);
+    output.worldPosition = worldPosition.xyz;
+    output.viewVector = normalize(impostorCameraPosition - worldPosition.xyz);
+    output.direction = direction;
+    output.planePoint = planePoint;
+    
+    return output;
+}
\ No newline at end of file
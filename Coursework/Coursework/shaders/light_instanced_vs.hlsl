@@ -0,0 +1,3 @@
+// light_vs with a world matrix per instance, for meshes drawn with BaseMesh::sendInstancedData
+#define INSTANCED_WORLDS
+#include "light_vs.hlsl"
\ No newline at end of file
@@ -0,0 +1,3 @@
+// light_vs over packed vertices, for meshes drawn with BaseMesh::setDrawPacked
+#define PACKED_VERTICES
+#include "light_vs.hlsl"
\ No newline at end of file
@@ -30,8 +30,19 @@ struct InputType
     float4 position : POSITION;
     float2 tex : TEXCOORD0;
     float3 normal : NORMAL;
+#ifdef INSTANCED_WORLDS
+    //Rows of the instance's world matrix, untransposed unlike worldMatrix
+    float4 world0 : WORLD0;
+    float4 world1 : WORLD1;
+    float4 world2 : WORLD2;
+    float4 world3 : WORLD3;
+#endif
 };
 
+#ifdef PACKED_VERTICES
+#include "packed_vertex.hlsli"
+#endif
+
 struct OutputType
 {
     float4 position : SV_POSITION;
@@ -78,10 +89,22 @@ float getHeight(float2 uv)
     return height;
 }
 
+#ifdef PACKED_VERTICES
+OutputType main(PackedInputType packed)
+{
+    InputType input = unpackVertex(packed);
+#else
 OutputType main(InputType input)
 {
+#endif
     OutputType output;
     
+#ifdef INSTANCED_WORLDS
+    matrix world = float4x4(input.world0, input.world1, input.world2, input.world3);
+#else
+    matrix world = worldMatrix;
+#endif
+    
     if(geometryType < 1.0f) //If working with the terrain
     {
         input.position.y = getHeight(input.tex) * amplitude;
@@ -93,12 +116,12 @@ OutputType main(InputType input)
     }
     
 	// Calculate the position of the vertex against the world, view, and projection matrices.
-    output.worldPosition = mul(input.position, worldMatrix);
+    output.worldPosition = mul(input.position, world);
     
     output.viewVector = cameraPosition.xyz - output.worldPosition.xyz;
     output.viewVector = normalize(output.viewVector);
     
-    output.position = mul(input.position, worldMatrix);
+    output.position = mul(input.position, world);
     output.position = mul(output.position, viewMatrix);
     output.position = mul(output.position, projectionMatrix);
     
@@ -106,7 +129,7 @@ OutputType main(InputType input)
     
     for (int i = 0; i < 4; i++)
     {
-        output.lightViewPosition[i] = mul(input.position, worldMatrix);
+        output.lightViewPosition[i] = mul(input.position, world);
         output.lightViewPosition[i] = mul(output.lightViewPosition[i], lightViewMatrix[i]);
         output.lightViewPosition[i] = mul(output.lightViewPosition[i], lightProjectionMatrix[i]);
     }
@@ -115,7 +138,7 @@ OutputType main(InputType input)
     output.tex = input.tex;
 
 	// Calculate the normal vector against the world matrix only and normalise.
-    output.normal = mul(input.normal, (float3x3) worldMatrix);
+    output.normal = mul(input.normal, (float3x3) world);
     output.normal = normalize(output.normal);
 
     return output;
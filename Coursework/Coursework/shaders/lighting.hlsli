@@ -0,0 +1,555 @@
+// Lighting shared by the forward and deferred pixel shaders
+
+Texture2D depthMapTextures[4] : register(t1);
+Texture2D heightMapTexture : register(t5);
+Texture2D momentMapTextures[4] : register(t6);
+
+SamplerState diffuseSampler : register(s0);
+SamplerState shadowSampler : register(s1);
+SamplerComparisonState shadowCompareSampler : register(s2);
+SamplerState momentSampler : register(s3);
+
+struct ClusterLight
+{
+    float3 position;
+    float range;
+    float3 direction;
+    float spotCosine;   //-1 for point lights
+    float4 colour;
+};
+
+StructuredBuffer<ClusterLight> clusterLights : register(t10);
+StructuredBuffer<uint2> clusterRanges : register(t11);   //Offset and count into the index list for each cluster
+StructuredBuffer<uint> clusterLightIndices : register(t12);
+
+struct Light
+{
+    float4 ambient;
+    float4 diffuse;
+    float4 specular;
+    float3 direction;
+    float range;
+    float3 position;
+    float exponent;
+    float3 attenuation;
+    float specularPower;
+    float4 lightType;
+    float shadowBias;
+    float nearPlane;
+    float farPlane;
+    float softShadowsEnabled;
+    float softenRadius;
+    float projectionType;
+    float renderShadows;
+    float shadowFilterMode;
+};
+
+cbuffer LightBuffer : register(b0)
+{
+    Light lights[4];
+};
+
+cbuffer VertexManipulationBuffer : register(b1)
+{
+    float amplitude;
+    float renderType;
+    float terrainResolution;
+    float geometryType;
+}
+
+cbuffer ShadowFilterBuffer : register(b2)
+{
+    float4 poissonDisk[64];
+    float sampleCount;
+    float blockerSampleCount;
+    float lightSize;
+    float minVariance;
+    float bleedReduction;
+    float3 filterPadding;
+}
+
+cbuffer ClusterBuffer : register(b3)
+{
+    float2 screenSize;
+    float sliceScale;
+    float sliceBias;
+    float clustersEnabled;
+    float3 clusterPadding;
+}
+
+//Must match LightClusters
+static const uint3 clusterCount = uint3(16, 9, 24);
+
+//Must match MomentShadow and depth_ps.hlsl
+static const float positiveExponent = 40.0f;
+static const float negativeExponent = 5.0f;
+
+
+
+// Calculate lighting intensity based on direction and normal. Combine with light colour.
+float4 calculateDirectional(Light light, float3 normal)
+{
+    float intensity = saturate(dot(normal, -light.direction));
+    float4 colour = saturate(light.diffuse * intensity);
+  
+    return colour + light.ambient;
+}
+
+float4 calculatePoint(Light light, float3 wPos, float3 normal)
+{
+    //Get the vector to the light source from the surface for omnidirectional lighting
+    float3 lightVector = light.position - wPos;
+    float distanceToSurface = length(lightVector);
+    
+    lightVector = normalize(lightVector);
+	
+    float intensity = saturate(dot(normal, lightVector));
+    float4 diffuse = saturate(intensity * light.diffuse);
+	
+    float3 baseAttenuation = float3(1.0f, distanceToSurface, distanceToSurface * distanceToSurface);
+    
+    float attenuation = 1.0f / dot(light.attenuation, baseAttenuation);
+    float4 ambient = light.ambient;
+	
+    return (ambient * attenuation) + (diffuse * attenuation);
+}
+
+float4 calculateSpot(Light light, float3 wPos, float3 normal)
+{
+    float3 lightVector = light.position - wPos;
+    float distanceToSurface = length(lightVector);
+    
+    if (distanceToSurface > light.range)
+    {
+        return float4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+	
+    lightVector = normalize(lightVector);
+
+    float intensity = saturate(dot(normal, lightVector));
+    float4 diffuse = saturate(intensity * light.diffuse);
+	  
+    //lamberts cosine rule
+    float spot = pow(max(dot(lightVector, -light.direction), 0.0f), light.exponent);
+    
+    float3 baseAttenuation = float3(1.0f, distanceToSurface, distanceToSurface * distanceToSurface);
+    float attenuation = spot / dot(light.attenuation, baseAttenuation);
+    
+    float4 ambient = light.ambient;
+
+    return ambient * spot + (diffuse * attenuation);
+}
+
+float4 calculateSpecular(Light light, float3 viewVector, float3 normal)
+{
+    // blinn-phong specular calculation
+    float3 halfway = normalize(light.direction + viewVector);
+    
+    float specularIntensity = pow(max(dot(normal, halfway), 0.0f), light.specularPower);
+    
+    return saturate(light.specular * specularIntensity);
+}
+
+// Is the gemoetry in our shadow map
+bool hasDepthData(float2 uv)
+{
+    if (uv.x < 0.f || uv.x > 1.f || uv.y < 0.f || uv.y > 1.f)
+    {
+        return false;
+    }
+    
+    return true;
+}
+
+bool isInShadow(Texture2D sMap, float2 uv, float4 lightViewPosition, float bias)
+{
+    // Sample the shadow map (get depth of geometry)
+    float depthValue = sMap.Sample(shadowSampler, uv).r;
+    
+	// Calculate the depth from the light.
+    float lightDepthValue = lightViewPosition.z / lightViewPosition.w;
+    lightDepthValue -= bias;
+
+	// Compare the depth of the shadow map value and the depth of the light to determine whether to shadow or to light this pixel.
+    if (lightDepthValue < depthValue)
+    {
+        return false;
+    }
+    
+    return true;
+}
+
+float2 getProjectiveCoords(float4 lightViewPosition)
+{
+    // Calculate the projected texture coordinates.
+    float2 projTex = lightViewPosition.xy / lightViewPosition.w;
+    
+    projTex *= float2(0.5f, -0.5f);
+    projTex += float2(0.5f, 0.5f);
+    
+    return projTex;
+}
+
+float3 estimateNormalsByHeightMap(float2 tex)
+{
+    uint levels, width, height;
+    heightMapTexture.GetDimensions(0, width, height, levels);
+    
+    //Per pixel rendering
+    
+    //Space between height values in normalised uv space (0,1)
+    float texelCellSpaceU = 1.0f / (float) width;
+    float texelCellSpaceV = 1.0f / (float) height;
+    //Space between cells in world space
+    float worldCellSpace = 1.0f / ((float) width / terrainResolution);
+    
+    float2 leftTex = tex + float2(-texelCellSpaceU, 0.0f);
+    float2 rightTex = tex + float2(texelCellSpaceU, 0.0f);
+    float2 topTex = tex + float2(0.0f, -texelCellSpaceV);
+    float2 bottomTex = tex + float2(0.0f, texelCellSpaceV);
+    
+    float leftY = heightMapTexture.SampleLevel(diffuseSampler, leftTex, 0).r;
+    float rightY = heightMapTexture.SampleLevel(diffuseSampler, rightTex, 0).r;
+    float topY = heightMapTexture.SampleLevel(diffuseSampler, topTex, 0).r;
+    float bottomY = heightMapTexture.SampleLevel(diffuseSampler, bottomTex, 0).r;
+    
+    float3 tangent = normalize(float3(2.0f * worldCellSpace, (rightY - leftY) * amplitude, 0.0f));
+    float3 bitan = normalize(float3(0.0f, (bottomY - topY) * amplitude, -2.0f * worldCellSpace));
+
+    return cross(tangent, bitan);
+}
+
+//Per pixel terrain normal. Baked terrain chunks read their normal map from the heightmap's slot, or keep the baked vertex normal,
+//instead of estimating the normal from four heightmap taps
+float3 getTerrainNormal(float2 tex, float3 vertexNormal)
+{
+    if (geometryType >= 3.0f)
+    {
+        return normalize((heightMapTexture.Sample(diffuseSampler, tex).xyz * 2.0f) - 1.0f);
+    }
+    
+    if (geometryType >= 2.0f)
+    {
+        return normalize(vertexNormal);
+    }
+    
+    return estimateNormalsByHeightMap(tex);
+}
+
+float softenShadowEdges(Light light, float4 lightViewPosition, Texture2D depthMap, float2 tex, float3 worldPos)
+{
+    float shadow = 0.0f;
+    float levels;
+    float2 depthMapSize;
+    
+    depthMap.GetDimensions(0, depthMapSize[0], depthMapSize[1], levels);
+    
+    float2 texelSize = 1.0f / depthMapSize;
+    float depth = depthMap.Sample(shadowSampler, tex.xy).r;
+    float lightDepth = lightViewPosition.z / lightViewPosition.w;
+    float pixelCount = 0.0f;
+    
+    //Sampling depth values around a point for a given radius
+    for (int x = -light.softenRadius; x <= light.softenRadius; ++x)
+    {
+        for (int y = -light.softenRadius; y <= light.softenRadius; ++y)
+        {
+            float nextDepth = depthMap.Sample(shadowSampler, tex.xy + (float2(x, y) * texelSize)).r;
+            shadow += (lightDepth - light.shadowBias) > nextDepth ? 1.0f : 0.0f;
+            pixelCount += 1.0f;
+        }
+    }
+    
+    //Checking if the current light is a spotlight and ensuring the tex coords are normalised
+    if(light.lightType.z == 1.0f)
+    {
+        if (tex.x < 0.0f || tex.x > 1.0f || tex.y < 0.0f || tex.y > 1.0f)
+        {
+            return (shadow / pixelCount);
+        }
+    }
+    
+    return (1.0f - (shadow / pixelCount));
+}
+
+//Rotates the Poisson disk per pixel, so the banding from a small number of samples becomes noise
+float2x2 getSampleRotation(float2 screenPosition)
+{
+    //Interleaved gradient noise
+    float angle = 6.28318f * frac(52.9829189f * frac(dot(screenPosition, float2(0.06711056f, 0.00583715f))));
+    float s, c;
+    sincos(angle, s, c);
+    
+    return float2x2(c, -s, s, c);
+}
+
+float filterPoisson(Light light, float4 lightViewPosition, Texture2D depthMap, float2 tex, float2x2 rotation, float radius)
+{
+    float levels;
+    float2 depthMapSize;
+    
+    depthMap.GetDimensions(0, depthMapSize[0], depthMapSize[1], levels);
+    
+    float2 texelSize = 1.0f / depthMapSize;
+    float lightDepth = (lightViewPosition.z / lightViewPosition.w) - light.shadowBias;
+    float lit = 0.0f;
+    
+    //Each comparison fetch is a bilinear weighted 2x2 depth test
+    for (int i = 0; i < (int) sampleCount; i++)
+    {
+        float2 offset = mul(poissonDisk[i].xy, rotation) * radius * texelSize;
+        lit += depthMap.SampleCmpLevelZero(shadowCompareSampler, tex + offset, lightDepth);
+    }
+    
+    return lit / sampleCount;
+}
+
+float filterPCSS(Light light, float4 lightViewPosition, Texture2D depthMap, float2 tex, float2x2 rotation)
+{
+    float levels;
+    float2 depthMapSize;
+    
+    depthMap.GetDimensions(0, depthMapSize[0], depthMapSize[1], levels);
+    
+    float2 texelSize = 1.0f / depthMapSize;
+    float receiverDepth = lightViewPosition.z / lightViewPosition.w;
+    float blockerSum = 0.0f;
+    float blockerCount = 0.0f;
+    
+    //Blocker search over the light size footprint
+    for (int i = 0; i < (int) blockerSampleCount; i++)
+    {
+        float2 offset = mul(poissonDisk[i].xy, rotation) * lightSize * texelSize;
+        float blockerDepth = depthMap.SampleLevel(shadowSampler, tex + offset, 0).r;
+        
+        if (blockerDepth < receiverDepth - light.shadowBias)
+        {
+            blockerSum += blockerDepth;
+            blockerCount += 1.0f;
+        }
+    }
+    
+    if (blockerCount == 0.0f)
+    {
+        return 1.0f;
+    }
+    
+    //Penumbra estimate from similar triangles between the receiver, the blockers and the light
+    float averageBlocker = blockerSum / blockerCount;
+    float penumbra = ((receiverDepth - averageBlocker) / averageBlocker) * lightSize;
+    
+    return filterPoisson(light, lightViewPosition, depthMap, tex, rotation, clamp(penumbra, 1.0f, light.softenRadius));
+}
+
+//Linear depth from the light in the range (0,1), as written to the moment maps by depth_ps.hlsl
+float getMomentDepth(Light light, float4 lightViewPosition)
+{
+    if (light.projectionType == 0.0f)
+    {
+        return lightViewPosition.z / lightViewPosition.w;
+    }
+    
+    return saturate((lightViewPosition.w - light.nearPlane) / (light.farPlane - light.nearPlane));
+}
+
+float chebyshevUpperBound(float2 moments, float depth, float varianceFloor)
+{
+    if (depth <= moments.x)
+    {
+        return 1.0f;
+    }
+    
+    float variance = max(moments.y - (moments.x * moments.x), varianceFloor);
+    float d = depth - moments.x;
+    float pMax = variance / (variance + (d * d));
+    
+    //Light bleeding reduction, cuts off the tail of the upper bound
+    return saturate((pMax - bleedReduction) / (1.0f - bleedReduction));
+}
+
+//The moment maps are blurred once per frame in the depth pass, so a single bilinear fetch gives the filtered result
+float filterMoments(Light light, float4 lightViewPosition, Texture2D momentMap, float2 tex)
+{
+    float4 moments = momentMap.SampleLevel(momentSampler, tex, 0);
+    float depth = getMomentDepth(light, lightViewPosition) - light.shadowBias;
+    
+    if (light.shadowFilterMode < 4.0f)
+    {
+        return chebyshevUpperBound(moments.xy, depth, minVariance);
+    }
+    
+    float warped = (depth * 2.0f) - 1.0f;
+    float positive = exp(positiveExponent * warped);
+    float negative = -exp(-negativeExponent * warped);
+    
+    //Minimum variance is scaled by the slope of each warp, so one setting works in both warped spaces
+    float positiveScale = 2.0f * positiveExponent * positive;
+    float negativeScale = 2.0f * negativeExponent * negative;
+    
+    float positiveLit = chebyshevUpperBound(moments.xy, positive, minVariance * positiveScale * positiveScale);
+    float negativeLit = chebyshevUpperBound(moments.zw, negative, minVariance * negativeScale * negativeScale);
+    
+    return min(positiveLit, negativeLit);
+}
+
+float filterShadow(Light light, float4 lightViewPosition, Texture2D depthMap, Texture2D momentMap, float2 tex, float3 worldPos, float2 screenPosition)
+{
+    if (light.shadowFilterMode < 1.0f)
+    {
+        return softenShadowEdges(light, lightViewPosition, depthMap, tex, worldPos);
+    }
+    
+    float2x2 rotation = getSampleRotation(screenPosition);
+    float lit;
+    
+    if (light.shadowFilterMode < 2.0f)
+    {
+        lit = filterPoisson(light, lightViewPosition, depthMap, tex, rotation, light.softenRadius);
+    }
+    else if (light.shadowFilterMode < 3.0f)
+    {
+        lit = filterPCSS(light, lightViewPosition, depthMap, tex, rotation);
+    }
+    else
+    {
+        lit = filterMoments(light, lightViewPosition, momentMap, tex);
+    }
+    
+    //Spotlights don't light anything outside of their shadow map, as with softenShadowEdges
+    if (light.lightType.z == 1.0f && !hasDepthData(tex))
+    {
+        return 1.0f - lit;
+    }
+    
+    return lit;
+}
+
+//Lights from the cluster containing this pixel, found from its screen position and view depth
+float4 calculateClusteredLights(float3 wPos, float3 normal, float4 screenPosition)
+{
+    float4 colour = float4(0.0f, 0.0f, 0.0f, 0.0f);
+    
+    if (clustersEnabled < 1.0f)
+    {
+        return colour;
+    }
+    
+    //The w component of the pixel position holds the view space depth
+    uint slice = (uint) max((log(screenPosition.w) * sliceScale) + sliceBias, 0.0f);
+    uint3 cluster = uint3((screenPosition.xy / screenSize) * float2(clusterCount.xy), min(slice, clusterCount.z - 1));
+    cluster.xy = min(cluster.xy, clusterCount.xy - 1);
+    
+    uint2 range = clusterRanges[cluster.x + (clusterCount.x * (cluster.y + (clusterCount.y * cluster.z)))];
+    
+    for (uint i = 0; i < range.y; i++)
+    {
+        ClusterLight light = clusterLights[clusterLightIndices[range.x + i]];
+        
+        float3 lightVector = light.position - wPos;
+        float distanceToSurface = length(lightVector);
+        lightVector /= max(distanceToSurface, 0.0001f);
+        
+        //Inverse square falloff, windowed so it reaches zero at the light's range and matches the culling
+        float window = saturate(1.0f - pow(distanceToSurface / light.range, 4.0f));
+        float attenuation = (window * window) / (1.0f + (distanceToSurface * distanceToSurface));
+        
+        float spot = 1.0f;
+        
+        if (light.spotCosine > -1.0f)
+        {
+            spot = smoothstep(light.spotCosine, lerp(light.spotCosine, 1.0f, 0.25f), dot(-lightVector, light.direction));
+        }
+        
+        colour += light.colour * saturate(dot(normal, lightVector)) * attenuation * spot;
+    }
+    
+    return colour;
+}
+
+//Lighting from the four shadowed lights and the clustered lights, shared by the forward and deferred paths.
+//The screen position holds the pixel coordinates in xy and the view space depth in w, as with SV_POSITION.
+float4 shadeSurface(float3 worldPosition, float3 normals, float3 viewVector, float4 lightViewPosition[4], float4 screenPosition, float4 textureColour)
+{
+    float4 lightColour = float4(0.0f, 0.0f, 0.0f, 1.0f);
+    float4 specularColour = float4(0.0f, 0.0f, 0.0f, 1.0f);
+    float2 pTexCoord;
+    
+    [unroll]
+    for (int i = 0; i < 4; i++)
+    {
+        if (lights[i].lightType.w > 0.0f)
+        {
+            lightColour += 0.0f;
+            specularColour += 0.0f;
+        }
+        
+        else
+        {            
+            // Calculate the projected texture coordinates.
+            pTexCoord = getProjectiveCoords(lightViewPosition[i]);
+            
+            if (lights[i].lightType.y > 0.0f)
+            {
+                lightColour += calculatePoint(lights[i], worldPosition, normals);
+            }
+            
+            if(lights[i].renderShadows == 1.0f) //Shadows are enabled
+            {
+                //Soft shadows are enabled, moment shadow maps are always filtered as they have no hardware shadow map
+                if (lights[i].softShadowsEnabled == 1.0f || lights[i].shadowFilterMode >= 3.0f)
+                {
+                    float soften = filterShadow(lights[i], lightViewPosition[i], depthMapTextures[i], momentMapTextures[i], pTexCoord, worldPosition, screenPosition.xy);
+                
+                    if (lights[i].lightType.x > 0.0f)
+                    {
+                        lightColour += (soften * calculateDirectional(lights[i], normals));
+                    }
+                    else if (lights[i].lightType.z > 0.0f)
+                    {
+                        lightColour += (soften * calculateSpot(lights[i], worldPosition, normals));
+                    }
+                    
+                    specularColour += (soften * calculateSpecular(lights[i], viewVector, normals));
+                }
+            
+            // Shadow test. Is or isn't in shadow
+                else if (hasDepthData(pTexCoord))   //Shadows are enabled, but soft shadows are not
+                {
+                // Has depth map data
+                    if (!isInShadow(depthMapTextures[i], pTexCoord, lightViewPosition[i], lights[i].shadowBias))
+                    {
+                    // is NOT in shadow, therefore light               
+                        if (lights[i].lightType.x > 0.0f)
+                        {
+                            lightColour += calculateDirectional(lights[i], normals);
+                        }
+                        else if (lights[i].lightType.z > 0.0f)
+                        {
+                            lightColour += calculateSpot(lights[i], worldPosition, normals);
+                        }
+                    
+                        specularColour += calculateSpecular(lights[i], viewVector, normals);
+                    }
+                }
+            }
+            
+            else    //Shadows are disabled, calculate light colour normally
+            {
+                if (lights[i].lightType.x > 0.0f)
+                {
+                    lightColour += calculateDirectional(lights[i], normals);
+                }
+                else if (lights[i].lightType.z > 0.0f)
+                {
+                    lightColour += calculateSpot(lights[i], worldPosition, normals);
+                }
+                
+                specularColour += calculateSpecular(lights[i], viewVector, normals);
+            }
+        }
+    }
+    
+    lightColour += calculateClusteredLights(worldPosition, normals, screenPosition);
+    
+    return specularColour + (saturate(lightColour) * textureColour);
+}
\ No newline at end of file
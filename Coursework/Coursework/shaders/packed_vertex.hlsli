@@ -0,0 +1,29 @@
+// Packed vertices as BaseMesh::createPackedVertices uploads them, the input layout widens every component back to floats
+// The including shader defines InputType before this, as it reads float vertices
+
+struct PackedInputType
+{
+    float4 position : POSITION;     //In the unit cube of the mesh's bounds, the mesh's decode matrix goes in front of the world matrix
+    float2 tex : TEXCOORD0;
+    float2 normal : NORMAL;         //Octahedral, must match VertexPacker::decodeOctahedral
+};
+
+float3 decodeOctahedralNormal(float2 encoded)
+{
+    float3 normal = float3(encoded.x, encoded.y, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float fold = saturate(-normal.z);
+    normal.xy += normal.xy >= 0.0f ? -fold : fold;
+    return normalize(normal);
+}
+
+InputType unpackVertex(PackedInputType packed)
+{
+    InputType input;
+    
+    //w holds nothing or, in the compact format, the normal
+    input.position = float4(packed.position.xyz, 1.0f);
+    input.tex = packed.tex;
+    input.normal = decodeOctahedralNormal(packed.normal);
+    
+    return input;
+}
\ No newline at end of file
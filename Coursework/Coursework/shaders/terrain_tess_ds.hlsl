@@ -0,0 +1,112 @@
+// Tessellated terrain domain shader, places each generated vertex on the patch and displaces it by the heightmap.
+// Writes the same output as light_vs.hlsl, so the light and G-buffer pixel shaders can shade it.
+
+Texture2D heightMapTexture : register(t0);
+
+SamplerState sampler0 : register(s0);
+
+cbuffer MatrixBuffer : register(b0)
+{
+    matrix worldMatrix;
+    matrix viewMatrix;
+    matrix projectionMatrix;
+    matrix lightViewMatrix[4];
+    matrix lightProjectionMatrix[4];
+};
+
+cbuffer CameraBuffer : register(b1)
+{
+    float3 cameraPosition;
+    float time;
+}
+
+cbuffer VertexManipulationBuffer : register(b2)
+{
+    float amplitude;
+    float renderType;
+    float terrainResolution;
+    float geometryType;
+}
+
+struct ConstantOutputType
+{
+    float edges[4] : SV_TessFactor;
+    float inside[2] : SV_InsideTessFactor;
+};
+
+struct InputType
+{
+    float3 position : POSITION;
+    float2 tex : TEXCOORD0;
+};
+
+struct OutputType
+{
+    float4 position : SV_POSITION;
+    float2 tex : TEXCOORD0;
+    float3 normal : NORMAL;
+    float3 worldPosition : TEXCOORD1;
+    float3 viewVector : TEXCOORD2;
+    float4 lightViewPosition[4] : TEXCOORD3;
+};
+
+float getHeight(float2 uv)
+{
+    return heightMapTexture.SampleLevel(sampler0, uv, 0).r;
+}
+
+//As light_vs.hlsl, for per vertex normals
+float3 estimateNormalsByHeightMap(float2 tex)
+{
+    float texelCellSpace = 1.0f / terrainResolution;
+    float worldCellSpace = 1.0f;
+
+    float leftY = getHeight(tex + float2(-texelCellSpace, 0.0f));
+    float rightY = getHeight(tex + float2(texelCellSpace, 0.0f));
+    float topY = getHeight(tex + float2(0.0f, -texelCellSpace));
+    float bottomY = getHeight(tex + float2(0.0f, texelCellSpace));
+
+    float3 tangent = normalize(float3(2.0f * worldCellSpace, (rightY - leftY) * amplitude, 0.0f));
+    float3 bitan = normalize(float3(0.0f, (bottomY - topY) * amplitude, -2.0f * worldCellSpace));
+
+    return cross(tangent, bitan);
+}
+
+[domain("quad")]
+OutputType main(ConstantOutputType input, float2 uv : SV_DomainLocation, const OutputPatch<InputType, 4> patch)
+{
+    OutputType output;
+
+    //Corners are ordered (0,0), (1,0), (0,1) and (1,1) across the patch
+    float3 position = lerp(lerp(patch[0].position, patch[1].position, uv.x), lerp(patch[2].position, patch[3].position, uv.x), uv.y);
+    float2 tex = lerp(lerp(patch[0].tex, patch[1].tex, uv.x), lerp(patch[2].tex, patch[3].tex, uv.x), uv.y);
+    float3 normal = float3(0.0f, 1.0f, 0.0f);
+
+    position.y = getHeight(tex) * amplitude;
+
+    if (renderType >= 2.0f) //If per vertex normals are selected
+    {
+        normal = estimateNormalsByHeightMap(tex);
+    }
+
+    float4 vertexPosition = float4(position, 1.0f);
+
+    output.worldPosition = mul(vertexPosition, worldMatrix).xyz;
+    output.viewVector = normalize(cameraPosition.xyz - output.worldPosition.xyz);
+
+    output.position = mul(vertexPosition, worldMatrix);
+    output.position = mul(output.position, viewMatrix);
+    output.position = mul(output.position, projectionMatrix);
+
+    for (int i = 0; i < 4; i++)
+    {
+        output.lightViewPosition[i] = mul(vertexPosition, worldMatrix);
+        output.lightViewPosition[i] = mul(output.lightViewPosition[i], lightViewMatrix[i]);
+        output.lightViewPosition[i] = mul(output.lightViewPosition[i], lightProjectionMatrix[i]);
+    }
+
+    output.tex = tex;
+    output.normal = normalize(mul(normal, (float3x3) worldMatrix));
+
+    return output;
+}
\ No newline at end of file
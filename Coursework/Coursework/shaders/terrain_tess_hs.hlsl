@@ -0,0 +1,103 @@
+// Tessellated terrain hull shader, splits each patch edge by its projected length and culls patches outside the view.
+// TerrainTessellation.cpp mirrors this on the CPU.
+
+cbuffer TessellationBuffer : register(b0)
+{
+    float3 cameraPosition;  //Terrain space
+    float amplitude;
+    float projectionScale;
+    float pixelsPerEdge;
+    float minFactor;
+    float maxFactor;
+    float4 frustumPlanes[6];    //Terrain space, facing inwards
+};
+
+struct InputType
+{
+    float3 position : POSITION;
+    float2 tex : TEXCOORD0;
+};
+
+struct ConstantOutputType
+{
+    float edges[4] : SV_TessFactor;
+    float inside[2] : SV_InsideTessFactor;
+};
+
+struct OutputType
+{
+    float3 position : POSITION;
+    float2 tex : TEXCOORD0;
+};
+
+//Taken from the edge alone, so the patches either side of an edge always split it the same way and no cracks open
+float edgeFactor(float3 a, float3 b)
+{
+    //The displaced height isn't known yet, so the midpoint is taken at the height closest to the camera
+    float3 midpoint = float3((a.x + b.x) * 0.5f, clamp(cameraPosition.y, 0.0f, amplitude), (a.z + b.z) * 0.5f);
+    float distance = max(length(midpoint - cameraPosition), 0.0001f);
+    float factor = (length(b.xz - a.xz) * projectionScale) / (distance * pixelsPerEdge);
+
+    return clamp(factor, minFactor, maxFactor);
+}
+
+bool patchVisible(float3 minimum, float3 maximum)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        //Corner furthest along the plane normal
+        float3 corner = float3(frustumPlanes[i].x >= 0.0f ? maximum.x : minimum.x, frustumPlanes[i].y >= 0.0f ? maximum.y : minimum.y,
+            frustumPlanes[i].z >= 0.0f ? maximum.z : minimum.z);
+
+        if (dot(frustumPlanes[i].xyz, corner) + frustumPlanes[i].w < 0.0f)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+ConstantOutputType PatchConstantFunction(InputPatch<InputType, 4> inputPatch, uint patchId : SV_PrimitiveID)
+{
+    ConstantOutputType output;
+
+    //The height is only known to lie between zero and the amplitude
+    float3 minimum = float3(inputPatch[0].position.x, 0.0f, inputPatch[0].position.z);
+    float3 maximum = float3(inputPatch[3].position.x, amplitude, inputPatch[3].position.z);
+
+    if (!patchVisible(minimum, maximum))
+    {
+        //Zero factors discard the patch
+        output.edges[0] = output.edges[1] = output.edges[2] = output.edges[3] = 0.0f;
+        output.inside[0] = output.inside[1] = 0.0f;
+
+        return output;
+    }
+
+    //Edges at u = 0, v = 0, u = 1 and v = 1
+    output.edges[0] = edgeFactor(inputPatch[0].position, inputPatch[2].position);
+    output.edges[1] = edgeFactor(inputPatch[0].position, inputPatch[1].position);
+    output.edges[2] = edgeFactor(inputPatch[1].position, inputPatch[3].position);
+    output.edges[3] = edgeFactor(inputPatch[2].position, inputPatch[3].position);
+
+    output.inside[0] = max(max(output.edges[0], output.edges[1]), max(output.edges[2], output.edges[3]));
+    output.inside[1] = output.inside[0];
+
+    return output;
+}
+
+[domain("quad")]
+[partitioning("integer")]
+[outputtopology("triangle_cw")]
+[outputcontrolpoints(4)]
+[patchconstantfunc("PatchConstantFunction")]
+OutputType main(InputPatch<InputType, 4> patch, uint pointId : SV_OutputControlPointID, uint patchId : SV_PrimitiveID)
+{
+    OutputType output;
+
+    output.position = patch[pointId].position;
+    output.tex = patch[pointId].tex;
+
+    return output;
+}
\ No newline at end of file
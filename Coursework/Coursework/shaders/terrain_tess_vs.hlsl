@@ -0,0 +1,24 @@
+// Tessellated terrain vertex shader, passes the patch corners on to the hull shader
+
+struct InputType
+{
+    float3 position : POSITION;
+    float2 tex : TEXCOORD0;
+    float3 normal : NORMAL;
+};
+
+struct OutputType
+{
+    float3 position : POSITION;
+    float2 tex : TEXCOORD0;
+};
+
+OutputType main(InputType input)
+{
+    OutputType output;
+
+    output.position = input.position;
+    output.tex = input.tex;
+
+    return output;
+}
\ No newline at end of file
@@ -1,4 +1,9 @@
 #include "AppLight.h"
+#include "AppLightLayout.h"
+
+//The headless light packing benchmark reads its lights through AppLightLayout
+static_assert(sizeof(AppLight) == sizeof(AppLightLayout), "AppLightLayout is out of step with AppLight's members");
+static_assert(alignof(AppLight) == alignof(AppLightLayout), "AppLightLayout is out of step with AppLight's members");
 
 AppLight::AppLight(XMFLOAT4 type)
 {
@@ -17,8 +22,11 @@ AppLight::AppLight(XMFLOAT4 type)
 	farPlane = 100.0f;
 	softenShadows = 0.0f;
 	softenRadius = 3.0f;
+	shadowFilterMode = 1.0f;
 
 	shadowMap = nullptr;
+	momentMap = nullptr;
+	momentBlurMap = nullptr;
 }
 
 AppLight::~AppLight()
@@ -29,4 +37,10 @@ AppLight::~AppLight()
 void AppLight::generateShadowMap(ID3D11Device* renderDevice, int width, int height)
 {
 	shadowMap = new ShadowMap(renderDevice, width, height);
+}
+
+void AppLight::generateMomentMaps(ID3D11Device* renderDevice, int width, int height)
+{
+	momentMap = new RenderTexture(renderDevice, width, height, nearPlane, farPlane);
+	momentBlurMap = new RenderTexture(renderDevice, width, height, nearPlane, farPlane);
 }
\ No newline at end of file
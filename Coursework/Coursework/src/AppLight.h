@@ -2,6 +2,7 @@
 
 #include "Light.h"
 #include "ShadowMap.h"
+#include "RenderTexture.h"
 
 //An extension of the light class with additional functionality for point lights and spotlights
 class AppLight : public Light
@@ -11,6 +12,7 @@ public:
 	~AppLight();
 
 	void generateShadowMap(ID3D11Device* renderDevice, int width, int height);
+	void generateMomentMaps(ID3D11Device* renderDevice, int width, int height);
 
 	inline void setLightType(XMFLOAT4 type) { lightType = type; }
 	inline void setRange(float r) { range = r; }
@@ -22,6 +24,7 @@ public:
 	inline void setSoftenShadows(float soften) { softenShadows = soften; }
 	inline void setSoftenRadius(float radius) { softenRadius = radius; }
 	inline void setProjectionMatrixType(float type) { projectionMatrixType = type; }
+	inline void setShadowFilterMode(float mode) { shadowFilterMode = mode; }
 
 	inline XMFLOAT4 getLightType() const { return lightType; }
 	inline float getRange() const { return range; }
@@ -33,8 +36,11 @@ public:
 	inline float getSoftenShadows() const { return softenShadows; }
 	inline float getSoftenRadius() const { return softenRadius; }
 	inline float getProjectionMatrixType() const { return projectionMatrixType; }
+	inline float getShadowFilterMode() const { return shadowFilterMode; }
 
 	inline ShadowMap* getShadowMap() const { return shadowMap; }
+	inline RenderTexture* getMomentMap() const { return momentMap; }
+	inline RenderTexture* getMomentBlurMap() const { return momentBlurMap; }
 
 	inline XMVECTOR getLookAt() const { return lookAt; }
 
@@ -49,5 +55,8 @@ private:
 	float softenShadows;
 	float softenRadius;
 	float projectionMatrixType;
+	float shadowFilterMode;	//Matches ShadowFilter::FilterMode - 0 for the sample grid, 1 for Poisson PCF, 2 for PCSS, 3 for VSM, 4 for EVSM
 	ShadowMap* shadowMap;
+	RenderTexture* momentMap;	//Prefiltered depth moments for the VSM and EVSM filters
+	RenderTexture* momentBlurMap;	//Intermediate target between the horizontal and vertical blur
 };
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+//Light's and AppLight's members in the same order, without the Direct3D types, so the headless light packing benchmark can time
+//reading the packed fields out of one object per light without building AppLight. AppLight.cpp checks the two stay the same size.
+struct AppLightLayout
+{
+	//Light
+	XMFLOAT4 ambientColour;
+	XMFLOAT4 diffuseColour;
+	XMFLOAT3 direction;
+	XMFLOAT4 specularColour;
+	float specularPower;
+	XMVECTOR position;
+	XMMATRIX viewMatrix;
+	XMMATRIX projectionMatrix;
+	XMMATRIX orthoMatrix;
+	XMVECTOR lookAt;
+
+	//AppLight
+	XMFLOAT4 lightType;
+	float range;
+	float exponent;
+	XMFLOAT3 attenuation;
+	float shadowBias;
+	float nearPlane;
+	float farPlane;
+	float softenShadows;
+	float softenRadius;
+	float projectionMatrixType;
+	float shadowFilterMode;
+	void* shadowMap;
+	void* momentMap;
+	void* momentBlurMap;
+};
\ No newline at end of file
@@ -1,7 +1,12 @@
 #include "Application.h"
 
+#include <cfloat>
+#include <chrono>
+
 Application::Application()
 {
+	//Multisampled back buffer, so the grass can use alpha to coverage in the forward pass
+	msaaSamples = 4;
 }
 
 void Application::init(HINSTANCE hinstance, HWND hwnd, int screenWidth, int screenHeight, Input *in, bool VSYNC, bool FULL_SCREEN)
@@ -14,6 +19,11 @@ void Application::init(HINSTANCE hinstance, HWND hwnd, int screenWidth, int scre
 	initLightingAndShadows();
 	initMeshes(screenWidth, screenHeight);
 	initTextures(screenWidth, screenHeight);
+	initScene();
+
+	//Deferred contexts for the passes recorded on worker threads
+	deferredContexts = new DeferredContexts(renderer->getDevice(), renderer->getDeviceContext());
+	commandRecorder = new CommandRecorder(deferredContexts);
 }
 
 Application::~Application()
@@ -53,10 +63,23 @@ void Application::initShaders(HWND hwnd)
 	textureShader = new TextureShader(renderer->getDevice(), hwnd);
 	horizontalBlurShader = new HorizontalBlurShader(renderer->getDevice(), hwnd);
 	verticalBlurShader = new VerticalBlurShader(renderer->getDevice(), hwnd);
+	momentHorizontalBlurShader = new HorizontalBlurShader(renderer->getDevice(), hwnd, D3D11_TEXTURE_ADDRESS_CLAMP);
+	momentVerticalBlurShader = new VerticalBlurShader(renderer->getDevice(), hwnd, D3D11_TEXTURE_ADDRESS_CLAMP);
 	depthShader = new DepthShader(renderer->getDevice(), hwnd);
+	packedLightShader = new LightShader(renderer->getDevice(), hwnd, compactPackedNormals ? LightShader::PACKED_COMPACT_VERTICES : LightShader::PACKED_VERTICES);
+	packedDepthShader = new DepthShader(renderer->getDevice(), hwnd, compactPackedNormals ? DepthShader::PACKED_COMPACT_VERTICES : DepthShader::PACKED_VERTICES);
+	instancedLightShader = new LightShader(renderer->getDevice(), hwnd, LightShader::INSTANCED_WORLDS);
+	positionDepthShader = new DepthShader(renderer->getDevice(), hwnd, DepthShader::POSITION_STREAMS);
 	bloomExtractShader = new BloomExtractShader(renderer->getDevice(), hwnd);
 	bloomCompositeShader = new BloomCompositeShader(renderer->getDevice(), hwnd);
-	billboardingShader = new BillboardingShader(renderer->getDevice(), hwnd);
+	grassShader = new GrassShader(renderer->getDevice(), hwnd);
+	gBufferShader = new GBufferShader(renderer->getDevice(), hwnd);
+	gBufferGrassShader = new GrassShader(renderer->getDevice(), hwnd, L"gbuffer_ps.cso");
+	deferredLightingShader = new DeferredLightingShader(renderer->getDevice(), hwnd);
+	tessellatedTerrainShader = new TessellatedTerrainShader(renderer->getDevice(), hwnd);
+	gBufferTessellatedTerrainShader = new TessellatedTerrainShader(renderer->getDevice(), hwnd, L"gbuffer_ps.cso");
+	impostorShader = new ImpostorShader(renderer->getDevice(), hwnd);
+	gBufferImpostorShader = new ImpostorShader(renderer->getDevice(), hwnd, L"impostor_gbuffer_ps.cso");
 }
 
 //Initialise the scene lights
@@ -65,6 +88,8 @@ void Application::initLightingAndShadows()
 	int shadowMapWidth = 1024;
 	int shadowMapHeight = 1024;
 
+	shadowFilter = new ShadowFilter(16, 8);
+
 	// Configure a set of lights
 	lights[0] = new AppLight(XMFLOAT4(1.0f, 0.0f, 0.0f, 0.0f));	//Directional light
 	lights[0]->setAmbientColour(0.2f, 0.2f, 0.2f, 1.0f);
@@ -109,6 +134,18 @@ void Application::initLightingAndShadows()
 	lights[3]->setRange(25.0f);
 	lights[3]->generateOrthoMatrix(sceneWidth, sceneHeight, 0.1f, 100.0f);
 	lights[3]->generateShadowMap(renderer->getDevice(), shadowMapWidth, shadowMapHeight);
+
+	//Moment maps are blurred every frame, so they're kept smaller than the hardware shadow maps
+	for (AppLight* light : lights)
+	{
+		light->generateMomentMaps(renderer->getDevice(), momentMapSize, momentMapSize);
+	}
+
+	//Unshadowed point and spotlights scattered over the terrain, assigned to view clusters each frame
+	lightSystem = new LightSystem();
+	lightSystem->addRandomLights(clusteredLightCount, XMFLOAT3(-50.0f, 1.0f, -10.0f), XMFLOAT3(50.0f, 8.0f, 90.0f));
+
+	lightClusters = new LightClusters();
 }
 
 //Initialise the meshes
@@ -117,8 +154,125 @@ void Application::initMeshes(int screenWidth, int screenHeight)
 	cubeMesh = new CubeMesh(renderer->getDevice(), renderer->getDeviceContext());
 	sphereMesh = new SphereMesh(renderer->getDevice(), renderer->getDeviceContext());
 	orthoMesh = new OrthoMesh(renderer->getDevice(), renderer->getDeviceContext(), screenWidth, screenHeight);	// Full screen size
+	momentOrthoMesh = new OrthoMesh(renderer->getDevice(), renderer->getDeviceContext(), momentMapSize, momentMapSize);	// Moment map size
 	planeMesh = new PlaneMesh(renderer->getDevice(), renderer->getDeviceContext());
+	terrainPatchMesh = new TerrainPatchMesh(renderer->getDevice());
+	grassMesh = new GrassMesh(renderer->getDevice());
+	grassCells = new GrassCells();
+	grassWind = new GrassWind();
 	teapotModel = new AModel(renderer->getDevice(), "res/teapot.obj");
+	teapotLods = new LodMesh(renderer->getDevice(), teapotModel->getVertices(), teapotModel->getIndices(), { 0.5f, 0.25f, 0.1f }, true, compactPackedNormals);
+	impostorQuad = new QuadMesh(renderer->getDevice(), renderer->getDeviceContext());
+	teapotImpostor = new Impostor();
+}
+
+//Places the scene's objects, each pass reads their world matrices from the scene graph
+void Application::initScene()
+{
+	floorNode = scene.createNode(-1, XMFLOAT3(-50.0f, 0.0f, -10.0f));
+	teapotNode = scene.createNode(-1, XMFLOAT3(0.0f, 5.0f, 2.5f), XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f), XMFLOAT3(0.5f, 0.5f, 0.5f));
+	cubeNode = scene.createNode(-1, XMFLOAT3(12.0f, 10.0f, 3.0f));
+	sphereNode = scene.createNode(-1, XMFLOAT3(-12.0f, 10.0f, 2.0f));
+	scene.update(multithreadedScene);
+
+	//The objects that are culled, by their model space boxes carried into world space by their nodes
+	objectNodes[OBJECT_TEAPOT] = teapotNode;
+	objectNodes[OBJECT_CUBE] = cubeNode;
+	objectNodes[OBJECT_SPHERE] = sphereNode;
+
+	Bvh::Box teapotBounds = { XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX), XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX) };
+
+	for (const BaseMesh::VertexType& vertex : teapotModel->getVertices())
+	{
+		teapotBounds.minimum = XMFLOAT3(fminf(teapotBounds.minimum.x, vertex.position.x), fminf(teapotBounds.minimum.y, vertex.position.y), fminf(teapotBounds.minimum.z, vertex.position.z));
+		teapotBounds.maximum = XMFLOAT3(fmaxf(teapotBounds.maximum.x, vertex.position.x), fmaxf(teapotBounds.maximum.y, vertex.position.y), fmaxf(teapotBounds.maximum.z, vertex.position.z));
+	}
+
+	objectBounds[OBJECT_TEAPOT] = teapotBounds;
+	objectBounds[OBJECT_CUBE] = { XMFLOAT3(-1.0f, -1.0f, -1.0f), XMFLOAT3(1.0f, 1.0f, 1.0f) };
+	objectBounds[OBJECT_SPHERE] = { XMFLOAT3(-1.0f, -1.0f, -1.0f), XMFLOAT3(1.0f, 1.0f, 1.0f) };
+
+	std::vector<Bvh::Box> boxes;
+
+	for (int i = 0; i < OBJECT_COUNT; i++)
+	{
+		boxes.push_back(Bvh::transformBox(objectBounds[i], scene.getWorldMatrix(objectNodes[i])));
+		objectVisible[i] = true;
+	}
+
+	sceneBvh.build(boxes);
+}
+
+//Refits the hierarchy around the objects whose nodes moved this frame
+void Application::updateObjectBounds()
+{
+	for (int i = 0; i < OBJECT_COUNT; i++)
+	{
+		if (scene.wasUpdated(objectNodes[i]))
+		{
+			sceneBvh.setBox(i, Bvh::transformBox(objectBounds[i], scene.getWorldMatrix(objectNodes[i])));
+		}
+	}
+
+	sceneBvh.refit();
+}
+
+//Draws the terrain into the occlusion culler's depth buffer from the camera, for the camera pass to test objects against
+void Application::updateOcclusion()
+{
+	occlusionActive = occlusionCulling && chunkedTerrain && !tessellatedTerrain;
+
+	if (!occlusionActive)
+	{
+		return;
+	}
+
+	//A coarse grid under the surface, rebuilt whenever the chunks are re-baked
+	if (terrain->getBakeCount() != terrainOccluderBake)
+	{
+		terrain->buildOccluder(occluderQuadsPerSide, terrain->getBakedAmplitude(), terrainOccluderVertices, terrainOccluderIndices);
+		terrainOccluderBake = terrain->getBakeCount();
+	}
+
+	camera->update();
+	occlusionCuller.beginFrame(camera->getViewMatrix() * renderer->getProjectionMatrix());
+	occlusionCuller.addOccluder(terrainOccluderVertices.data(), (int)terrainOccluderVertices.size(), terrainOccluderIndices.data(), (int)terrainOccluderIndices.size(),
+		scene.getWorldMatrix(floorNode));
+	occlusionCuller.rasterise(multithreadedOcclusion);
+}
+
+//Marks which objects the current pass draws, and records how many it culled. Occlusion is only tested from the camera, whose view
+//updateOcclusion() drew.
+void Application::cullObjects(const XMMATRIX& viewProjection, bool occlusion)
+{
+	if (!cullSceneObjects)
+	{
+		for (int i = 0; i < OBJECT_COUNT; i++)
+		{
+			objectVisible[i] = true;
+		}
+
+		renderStats.recordCulling(OBJECT_COUNT, 0);
+		return;
+	}
+
+	Bvh::QueryStats stats = sceneBvh.query(Frustum(viewProjection), visibleObjects);
+
+	for (int i = 0; i < OBJECT_COUNT; i++)
+	{
+		objectVisible[i] = false;
+	}
+
+	int occluded = 0;
+
+	for (int object : visibleObjects)
+	{
+		const Bvh::Box& box = sceneBvh.getBox(object);
+		objectVisible[object] = !occlusion || occlusionCuller.boxVisible(box.minimum, box.maximum);
+		occluded += objectVisible[object] ? 0 : 1;
+	}
+
+	renderStats.recordCulling(stats.visible - occluded, stats.culled, occluded);
 }
 
 //Initialise textures and render texture objects
@@ -136,23 +290,80 @@ void Application::initTextures(int screenWidth, int screenHeight)
 	bloomCompositeTexture = new RenderTexture(renderer->getDevice(), screenWidth, screenHeight, SCREEN_NEAR, SCREEN_DEPTH);
 	horizontalBlurTexture = new RenderTexture(renderer->getDevice(), screenWidth, screenHeight, SCREEN_NEAR, SCREEN_DEPTH);
 	verticalBlurTexture = new RenderTexture(renderer->getDevice(), screenWidth, screenHeight, SCREEN_NEAR, SCREEN_DEPTH);
+
+	gBuffer = new GBuffer(renderer->getDevice(), screenWidth, screenHeight, SCREEN_NEAR, SCREEN_DEPTH);
+	lightClusterBuffers = new LightClusterBuffers(renderer->getDevice(), (float)screenWidth, (float)screenHeight);
+
+	//Built from the CPU copy of the heightmap, so it has to wait for the texture to load
+	terrain = new ChunkedTerrain();
+
+	if (!terrain->load(renderer->getDevice(), renderer->getDeviceContext(), textureMgr->getTexture(L"height"), amplitude))
+	{
+		chunkedTerrain = false;
+	}
+
+	//Scattered over the same CPU heights, or the flat plane if they couldn't be read
+	scatterGrass();
+
+	//Baked with the model's texture read back from the GPU
+	bakeImpostors();
 }
 
 bool Application::render()
 {
-	firstPass();
+	renderStats.beginFrame();
+	drawState.resetCounters();
+	scene.update(multithreadedScene);
+	updateObjectBounds();
 
-	if (renderShadows)
+	if (renderClusteredLights)
+	{
+		updateLightClusters();
+	}
+
+	if (chunkedTerrain)
+	{
+		updateTerrainLod();
+	}
+
+	updateOcclusion();
+
+	if (tessellatedTerrain)
+	{
+		updateTerrainTessellation();
+	}
+
+	if (renderGrass)
+	{
+		updateGrass();
+	}
+
+	if (deferredShading)
+	{
+		geometryPass();
+		deferredLightingPass();
+	}
+
+	else
 	{
-		depthPass();
+		firstPass();
 	}
 
-	bloomExtract();
+	if (recordCommandLists)
+	{
+		recordPasses();
+	}
 
-	horizontalBlur();
-	verticalBlur();
+	else
+	{
+		if (renderShadows)
+		{
+			depthPass();
+		}
 
-	bloomComposite();
+		postProcess(renderer->getDeviceContext());
+		renderer->setBackBufferRenderTarget();
+	}
 
 	finalPass();
 
@@ -173,9 +384,22 @@ void Application::gui()
 	guiGeneral();
 	guiVertexManipulation();
 	guiLighting();
+	guiClusteredLights();
+	guiDeferredShading();
 	guiShadows();
 	guiPostProcessing();
-	guiBillboarding();
+	guiGrass();
+	guiImpostors();
+	guiLevelsOfDetail();
+	guiMeshOptimisation();
+	guiVertexPacking();
+	guiRenderStats();
+	guiInstancing();
+	guiSceneGraph();
+	guiCulling();
+	guiDrawQueue();
+	guiCommandRecording();
+	guiJobSystem();
 
 	// Render UI
 	ImGui::Render();
@@ -196,74 +420,229 @@ void Application::firstPass()
 		renderer->beginScene(0.35f, 0.35f, 0.35f, 1.0f);
 	}
 
+	renderScene(lightShader, grassShader, tessellatedTerrainShader, impostorShader, getGrassTransparency());
+
+	if (renderGizmos)
+	{
+		renderLightingGizmos();
+	}
+
+	// Reset the render target back to the original back buffer and not the render to texture anymore.
+	renderer->setBackBufferRenderTarget();
+}
+
+//Draws the scene's geometry with either the forward lighting shaders or the G-buffer shaders
+void Application::renderScene(LightShader* shader, GrassShader* grassShader, TessellatedTerrainShader* terrainShader, ImpostorShader* impostorShader,
+	GrassShader::Transparency grassTransparency)
+{
 	// Get matrices
 	camera->update();
 	XMMATRIX worldMatrix = renderer->getWorldMatrix();
 	XMMATRIX viewMatrix = camera->getViewMatrix();
 	XMMATRIX projectionMatrix = renderer->getProjectionMatrix();
 
+	renderStats.beginPass("Camera");
+	cullObjects(viewMatrix * projectionMatrix, occlusionActive);
+
 	// Render floor
-	worldMatrix = XMMatrixTranslation(-50.f, 0.f, -10.f);
-	planeMesh->sendData(renderer->getDeviceContext());
-	lightShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, viewMatrix, projectionMatrix, textureMgr->getTexture(L"dirt"), textureMgr->getTexture(L"height"),
-		amplitude, lights, camera->getPosition(), timer->getTime(), renderType, 100.0f, 0.0f, renderShadows);
-	lightShader->render(renderer->getDeviceContext(), planeMesh->getIndexCount());
+	worldMatrix = scene.getWorldMatrix(floorNode);
+
+	if (tessellatedTerrain)
+	{
+		//Patches are split by the hull shader and displaced by the domain shader, which samples the heightmap as light_vs does for the plane
+		terrainPatchMesh->sendData(renderer->getDeviceContext());
+		terrainShader->setTessellationParameters(renderer->getDeviceContext(), terrainTessellation, terrainFrustum);
+		terrainShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, viewMatrix, projectionMatrix, textureMgr->getTexture(L"dirt"), textureMgr->getTexture(L"height"),
+			amplitude, lights, camera->getPosition(), timer->getTime(), renderType, 100.0f, 0.0f, renderShadows, shadowFilter, renderClusteredLights ? lightClusterBuffers : nullptr);
+		terrainShader->render(renderer->getDeviceContext(), terrainPatchMesh->getIndexCount());
+	}
+
+	else if (chunkedTerrain)
+	{
+		renderTerrain(shader, worldMatrix, viewMatrix, projectionMatrix);
+	}
+
+	else
+	{
+		planeMesh->sendData(renderer->getDeviceContext());
+		shader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, viewMatrix, projectionMatrix, textureMgr->getTexture(L"dirt"), textureMgr->getTexture(L"height"),
+			amplitude, lights, camera->getPosition(), timer->getTime(), renderType, 100.0f, 0.0f, renderShadows, shadowFilter, renderClusteredLights ? lightClusterBuffers : nullptr);
+		shader->render(renderer->getDeviceContext(), planeMesh->getIndexCount());
+	}
 
 	// Render teapot model
-	worldMatrix = renderer->getWorldMatrix();
-	worldMatrix = XMMatrixTranslation(0.0f, 10.f, 5.0f);
-	XMMATRIX scaleMatrix = XMMatrixScaling(0.5f, 0.5f, 0.5f);
-	worldMatrix = XMMatrixMultiply(worldMatrix, scaleMatrix);
-	teapotModel->sendData(renderer->getDeviceContext());
-	lightShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, viewMatrix, projectionMatrix, textureMgr->getTexture(L"wood"), textureMgr->getTexture(L"wood"),
-		1.0f, lights, camera->getPosition(), timer->getTime(), renderType, teapotModel->getIndexCount(), 1.0f, renderShadows);
-	lightShader->render(renderer->getDeviceContext(), teapotModel->getIndexCount());
+	worldMatrix = scene.getWorldMatrix(teapotNode);
 
-	//Render cube
-	worldMatrix = renderer->getWorldMatrix();
-	worldMatrix = XMMatrixTranslation(12.0f, 10.f, 3.0f);
-	cubeMesh->sendData(renderer->getDeviceContext());
-	lightShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, viewMatrix, projectionMatrix, textureMgr->getTexture(L"wood"), textureMgr->getTexture(L"wood"),
-		1.0f, lights, camera->getPosition(), timer->getTime(), renderType, cubeMesh->getIndexCount(), 1.0f, renderShadows);
-	lightShader->render(renderer->getDeviceContext(), cubeMesh->getIndexCount());
+	//A billboard of the baked views once the teapot is only a few pixels tall
+	teapotScreenSize = getProjectedSize(worldMatrix, teapotImpostor);
+	teapotIsImpostor = renderImpostors && teapotImpostor->isBaked() && teapotScreenSize < impostorSwitchPixels;
 
-	//Render sphere
-	worldMatrix = renderer->getWorldMatrix();
-	worldMatrix = XMMatrixTranslation(-12.0f, 10.f, 2.0f);
-	sphereMesh->sendData(renderer->getDeviceContext());
-	lightShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, viewMatrix, projectionMatrix, textureMgr->getTexture(L"wood"), textureMgr->getTexture(L"wood"),
-		1.0f, lights, camera->getPosition(), timer->getTime(), renderType, sphereMesh->getIndexCount(), 1.0f, renderShadows);
-	lightShader->render(renderer->getDeviceContext(), sphereMesh->getIndexCount());
+	//Its size is still measured when it is culled, the shadow passes draw the level picked here
+	if (objectVisible[OBJECT_TEAPOT] && teapotIsImpostor)
+	{
+		impostorQuad->sendData(renderer->getDeviceContext());
+		impostorShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, viewMatrix, projectionMatrix, teapotImpostor, camera->getPosition());
+		impostorShader->render(renderer->getDeviceContext(), impostorQuad->getIndexCount());
+	}
+
+	else if (objectVisible[OBJECT_TEAPOT])
+	{
+		//Simplified levels in between, the one closest to the full model's triangle density on screen
+		if (renderLevelsOfDetail)
+		{
+			teapotLods->selectLevel(teapotScreenSize, lodFullDetailPixels, lodHysteresis);
+		}
+
+		else
+		{
+			teapotLods->setLevel(0);
+		}
+	}
+
+	//Packed vertices in the forward pass, the G-buffer shaders only read float vertices
+	bool packedTeapot = packedVertices && shader == lightShader;
+	teapotLods->setDrawPacked(packedTeapot);
+
+	//The objects as draw packets, sorted so those sharing a shader, texture or mesh are drawn together, nearest first
+	BaseMesh* objectMeshes[OBJECT_COUNT] = { teapotLods, cubeMesh, sphereMesh };
+	drawQueue.clear();
+
+	for (int object = 0; object < OBJECT_COUNT; object++)
+	{
+		if (objectVisible[object] && !(object == OBJECT_TEAPOT && teapotIsImpostor))
+		{
+			DrawShader objectShader = object == OBJECT_TEAPOT && packedTeapot ? SHADER_PACKED_LIGHT : SHADER_LIGHT;
+			XMVECTOR viewPosition = XMVector3TransformCoord(scene.getWorldMatrix(objectNodes[object]).r[3], viewMatrix);
+			drawQueue.submit(DrawQueue::makeKey(DRAW_OPAQUE, objectShader, MATERIAL_WOOD, object, XMVectorGetZ(viewPosition)), object);
+		}
+	}
+
+	if (sortDraws)
+	{
+		drawQueue.sort();
+	}
+
+	drawQueue.execute(drawState, [&](const DrawQueue::Packet& packet, unsigned int binds)
+	{
+		LightShader* objectShader = DrawQueue::getShader(packet.key) == SHADER_PACKED_LIGHT ? packedLightShader : shader;
+		BaseMesh* mesh = objectMeshes[packet.payload];
+
+		//The frame's lights and matrices are sent with the shader, only the world matrix changes between objects
+		if (binds & DrawQueue::BIND_SHADER)
+		{
+			objectShader->bind(renderer->getDeviceContext());
+			objectShader->setFrameParameters(renderer->getDeviceContext(), viewMatrix, projectionMatrix, lights, camera->getPosition(), timer->getTime(), renderShadows, shadowFilter,
+				renderClusteredLights ? lightClusterBuffers : nullptr);
+		}
+
+		if (binds & DrawQueue::BIND_MATERIAL)
+		{
+			objectShader->setMaterial(renderer->getDeviceContext(), textureMgr->getTexture(L"wood"), textureMgr->getTexture(L"wood"));
+		}
+
+		if (binds & DrawQueue::BIND_MESH)
+		{
+			mesh->sendData(renderer->getDeviceContext());
+		}
+
+		XMMATRIX objectWorldMatrix = scene.getWorldMatrix(objectNodes[packet.payload]);
+
+		if (packet.payload == OBJECT_TEAPOT)
+		{
+			objectWorldMatrix = XMMatrixMultiply(teapotLods->getDecodeMatrix(), objectWorldMatrix);
+		}
+
+		objectShader->setObjectParameters(renderer->getDeviceContext(), objectWorldMatrix, 1.0f, renderType, (float)mesh->getIndexCount(), 1.0f);
+		objectShader->draw(renderer->getDeviceContext(), mesh->getIndexCount());
+	});
 
 	if (renderGrass)
 	{
-		//Render billboards
-		worldMatrix = renderer->getWorldMatrix();
-		worldMatrix = XMMatrixTranslation(-50.f, 1.0f, -10.f);
+		//Render grass, one instance of the blade mesh for every scattered blade
+		worldMatrix = scene.getWorldMatrix(floorNode);
 
-		//The opposite translations must be applied to the camera to ensure it aligns with the plane mesh in the geometry shader
-		XMFLOAT3 camPos = XMFLOAT3(camera->getPosition().x + 50.0f, camera->getPosition().y - 1.0f, camera->getPosition().z + 10.0f);
+		if (grassTransparency == GrassShader::ALPHA_TO_COVERAGE)
+		{
+			renderer->setAlphaToCoverage(true);
+		}
 
-		if (!enableBloom)	//Avoids artefacting when used in conjunction with bloom
+		else if (grassTransparency == GrassShader::BLENDED)
 		{
-			renderer->setAlphaBlending(true);
+			renderer->setSortedBlending(true);
 		}
-		renderer->getDeviceContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
-		planeMesh->sendData(renderer->getDeviceContext());
-		billboardingShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, viewMatrix, projectionMatrix, textureMgr->getTexture(L"grass"), camPos);
-		billboardingShader->render(renderer->getDeviceContext(), planeMesh->getIndexCount());
-		if (!enableBloom)
+
+		grassMesh->sendData(renderer->getDeviceContext());
+		grassShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, viewMatrix, projectionMatrix, textureMgr->getTexture(L"grass"), camera->getPosition(), amplitude,
+			grassTransparency);
+		grassShader->renderInstanced(renderer->getDeviceContext(), grassMesh->getIndexCount(), grassMesh->getInstanceCount());
+
+		if (grassTransparency != GrassShader::CUTOUT)
 		{
 			renderer->setAlphaBlending(false);
 		}
 	}
+}
+
+//Draws the terrain chunks picked by updateTerrainLod(), the parameters are the same for every chunk so they are only set once.
+//The chunks are already displaced and lit from baked normals, the normal map takes the heightmap's place for per pixel lighting.
+void Application::renderTerrain(LightShader* shader, XMMATRIX worldMatrix, XMMATRIX viewMatrix, XMMATRIX projectionMatrix)
+{
+	ID3D11ShaderResourceView* normalMap = terrainNormalMap ? terrain->getNormalMap() : textureMgr->getTexture(L"height");
+
+	shader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, viewMatrix, projectionMatrix, textureMgr->getTexture(L"dirt"), normalMap,
+		amplitude, lights, camera->getPosition(), timer->getTime(), renderType, 100.0f, terrainNormalMap ? 3.0f : 2.0f, renderShadows, shadowFilter, renderClusteredLights ? lightClusterBuffers : nullptr);
+
+	for (int node : terrainChunks)
+	{
+		TerrainChunkMesh* mesh = terrain->getMesh(node);
+		mesh->sendData(renderer->getDeviceContext());
+		shader->render(renderer->getDeviceContext(), mesh->getIndexCount());
+	}
+}
+
+//Deferred geometry pass, writes the scene's surface attributes to the G-buffer instead of lighting them
+void Application::geometryPass()
+{
+	gBuffer->setRenderTargets(renderer->getDeviceContext());
+	gBuffer->clearRenderTargets(renderer->getDeviceContext());
+
+	//Blending would also blend the normals and depth, the G-buffer shader cuts out the transparent texels instead
+	renderScene(gBufferShader, gBufferGrassShader, gBufferTessellatedTerrainShader, gBufferImpostorShader, GrassShader::CUTOUT);
+
+	renderer->setBackBufferRenderTarget();
+}
+
+//Deferred lighting pass, a single full screen draw that lights every G-buffer pixel with all of the lights
+void Application::deferredLightingPass()
+{
+	if (enableBloom)
+	{
+		sceneTexture->setRenderTarget(renderer->getDeviceContext());
+		sceneTexture->clearRenderTarget(renderer->getDeviceContext(), 0.35f, 0.35f, 0.35f, 1.0f);
+	}
+
+	else
+	{
+		renderer->beginScene(0.35f, 0.35f, 0.35f, 1.0f);
+	}
+
+	XMMATRIX worldMatrix = renderer->getWorldMatrix();
+	XMMATRIX orthoMatrix = renderer->getOrthoMatrix();
+	XMMATRIX orthoViewMatrix = camera->getOrthoViewMatrix();
+
+	renderer->setZBuffer(false);
+	orthoMesh->sendData(renderer->getDeviceContext());
+	deferredLightingShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, orthoViewMatrix, orthoMatrix, camera->getViewMatrix(), renderer->getProjectionMatrix(),
+		gBuffer, lights, camera->getPosition(), timer->getTime(), renderType, renderShadows, shadowFilter, renderClusteredLights ? lightClusterBuffers : nullptr);
+	deferredLightingShader->render(renderer->getDeviceContext(), orthoMesh->getIndexCount());
+	renderer->setZBuffer(true);
 
+	//Gizmos are drawn forward over the lit scene, without the G-buffer's depth
 	if (renderGizmos)
 	{
 		renderLightingGizmos();
 	}
 
-	// Reset the render target back to the original back buffer and not the render to texture anymore.
 	renderer->setBackBufferRenderTarget();
 }
 
@@ -297,76 +676,67 @@ void Application::finalPass()
 	renderer->endScene();
 }
 
-void Application::bloomExtract()
+void Application::bloomExtract(ID3D11DeviceContext* context)
 {
 	XMMATRIX worldMatrix, baseViewMatrix, orthoMatrix;
 
-	bloomExtractTexture->setRenderTarget(renderer->getDeviceContext());
-	bloomExtractTexture->clearRenderTarget(renderer->getDeviceContext(), 0.35f, 0.35f, 0.35f, 1.0f);
+	bloomExtractTexture->setRenderTarget(context);
+	bloomExtractTexture->clearRenderTarget(context, 0.35f, 0.35f, 0.35f, 1.0f);
 
 	worldMatrix = renderer->getWorldMatrix();
 	baseViewMatrix = camera->getOrthoViewMatrix();
 	orthoMatrix = bloomExtractTexture->getOrthoMatrix();
 
-	orthoMesh->sendData(renderer->getDeviceContext());
-	bloomExtractShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, baseViewMatrix, orthoMatrix, sceneTexture->getShaderResourceView(),
+	orthoMesh->sendData(context);
+	bloomExtractShader->setShaderParameters(context, worldMatrix, baseViewMatrix, orthoMatrix, sceneTexture->getShaderResourceView(),
 		bloomThreshold, bloomIntensity, bloomSaturation, sceneIntensity, sceneSaturation);
-	bloomExtractShader->render(renderer->getDeviceContext(), orthoMesh->getIndexCount());
-
-	// Reset the render target back to the original back buffer and not the render to texture anymore.
-	renderer->setBackBufferRenderTarget();
+	bloomExtractShader->render(context, orthoMesh->getIndexCount());
 }
 
-void Application::bloomComposite()
+void Application::bloomComposite(ID3D11DeviceContext* context)
 {
 	XMMATRIX worldMatrix, baseViewMatrix, orthoMatrix;
 
-	bloomCompositeTexture->setRenderTarget(renderer->getDeviceContext());
-	bloomCompositeTexture->clearRenderTarget(renderer->getDeviceContext(), 0.35f, 0.35f, 0.35f, 1.0f);
+	bloomCompositeTexture->setRenderTarget(context);
+	bloomCompositeTexture->clearRenderTarget(context, 0.35f, 0.35f, 0.35f, 1.0f);
 
 	worldMatrix = renderer->getWorldMatrix();
 	baseViewMatrix = camera->getOrthoViewMatrix();
 	orthoMatrix = bloomExtractTexture->getOrthoMatrix();
 
-	orthoMesh->sendData(renderer->getDeviceContext());
-	bloomCompositeShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, baseViewMatrix, orthoMatrix, sceneTexture->getShaderResourceView(),
+	orthoMesh->sendData(context);
+	bloomCompositeShader->setShaderParameters(context, worldMatrix, baseViewMatrix, orthoMatrix, sceneTexture->getShaderResourceView(),
 		verticalBlurTexture->getShaderResourceView(), bloomThreshold, bloomIntensity, bloomSaturation, sceneIntensity, sceneSaturation);
-	bloomCompositeShader->render(renderer->getDeviceContext(), orthoMesh->getIndexCount());
-
-	// Reset the render target back to the original back buffer and not the render to texture anymore.
-	renderer->setBackBufferRenderTarget();
+	bloomCompositeShader->render(context, orthoMesh->getIndexCount());
 }
 
-void Application::horizontalBlur()
+void Application::horizontalBlur(ID3D11DeviceContext* context)
 {
 	XMMATRIX worldMatrix, baseViewMatrix, orthoMatrix;
 
 	float screenSizeX = (float)horizontalBlurTexture->getTextureWidth();
-	horizontalBlurTexture->setRenderTarget(renderer->getDeviceContext());
-	horizontalBlurTexture->clearRenderTarget(renderer->getDeviceContext(), 0.35f, 0.35f, 0.35f, 1.0f);
+	horizontalBlurTexture->setRenderTarget(context);
+	horizontalBlurTexture->clearRenderTarget(context, 0.35f, 0.35f, 0.35f, 1.0f);
 
 	worldMatrix = renderer->getWorldMatrix();
 	baseViewMatrix = camera->getOrthoViewMatrix();
 	orthoMatrix = horizontalBlurTexture->getOrthoMatrix();
 
 	// Render for Horizontal Blur
-	renderer->setZBuffer(false);
-	orthoMesh->sendData(renderer->getDeviceContext());
-	horizontalBlurShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, baseViewMatrix, orthoMatrix, bloomExtractTexture->getShaderResourceView(), screenSizeX, -25.0f, 25.0f, 15.0f);
-	horizontalBlurShader->render(renderer->getDeviceContext(), orthoMesh->getIndexCount());
-	renderer->setZBuffer(true);
-
-	// Reset the render target back to the original back buffer and not the render to texture anymore.
-	renderer->setBackBufferRenderTarget();
+	renderer->setZBuffer(false, context);
+	orthoMesh->sendData(context);
+	horizontalBlurShader->setShaderParameters(context, worldMatrix, baseViewMatrix, orthoMatrix, bloomExtractTexture->getShaderResourceView(), screenSizeX, -25.0f, 25.0f, 15.0f);
+	horizontalBlurShader->render(context, orthoMesh->getIndexCount());
+	renderer->setZBuffer(true, context);
 }
 
-void Application::verticalBlur()
+void Application::verticalBlur(ID3D11DeviceContext* context)
 {
 	XMMATRIX worldMatrix, baseViewMatrix, orthoMatrix;
 
 	float screenSizeY = (float)verticalBlurTexture->getTextureHeight();
-	verticalBlurTexture->setRenderTarget(renderer->getDeviceContext());
-	verticalBlurTexture->clearRenderTarget(renderer->getDeviceContext(), 0.35f, 0.35f, 0.35f, 1.0f);
+	verticalBlurTexture->setRenderTarget(context);
+	verticalBlurTexture->clearRenderTarget(context, 0.35f, 0.35f, 0.35f, 1.0f);
 
 	worldMatrix = renderer->getWorldMatrix();
 	baseViewMatrix = camera->getOrthoViewMatrix();
@@ -374,23 +744,71 @@ void Application::verticalBlur()
 	orthoMatrix = verticalBlurTexture->getOrthoMatrix();
 
 	// Render for Vertical Blur
-	renderer->setZBuffer(false);
-	orthoMesh->sendData(renderer->getDeviceContext());
-	verticalBlurShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, baseViewMatrix, orthoMatrix, horizontalBlurTexture->getShaderResourceView(), screenSizeY, -25.0f, 25.0f, 15.0f);
-	verticalBlurShader->render(renderer->getDeviceContext(), orthoMesh->getIndexCount());
-	renderer->setZBuffer(true);
+	renderer->setZBuffer(false, context);
+	orthoMesh->sendData(context);
+	verticalBlurShader->setShaderParameters(context, worldMatrix, baseViewMatrix, orthoMatrix, horizontalBlurTexture->getShaderResourceView(), screenSizeY, -25.0f, 25.0f, 15.0f);
+	verticalBlurShader->render(context, orthoMesh->getIndexCount());
+	renderer->setZBuffer(true, context);
+}
 
-	// Reset the render target back to the original back buffer and not the render to texture anymore.
-	renderer->setBackBufferRenderTarget();
+void Application::recordPasses()
+{
+	//The shadow maps and the post processing chain don't read anything the others write while recording, so each is recorded on a
+	//thread of its own. The lists then run in the order the passes were drawn in on one thread.
+	if (renderShadows)
+	{
+		prepareShadowMaps();
+
+		for (int i = 0; i < 4; i++)
+		{
+			commandRecorder->addPass([this, i](int pass)
+			{
+				ID3D11DeviceContext* context = deferredContexts->getContext(pass);
+				renderer->applyStates(context);
+				renderShadowMap(i, context);
+			});
+		}
+	}
+
+	commandRecorder->addPass([this](int pass)
+	{
+		ID3D11DeviceContext* context = deferredContexts->getContext(pass);
+		renderer->applyStates(context);
+		postProcess(context);
+	});
+
+	commandRecorder->record(multithreadedRecording);
+	commandRecorder->execute();
+
+	if (renderShadows)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			renderStats.merge(shadowStats[i]);
+		}
+	}
 }
 
 void Application::depthPass()
 {
-	// get the world, view, and projection matrices from the camera and d3d objects.
+	prepareShadowMaps();
+
 	for (int i = 0; i < 4; i++)
 	{
-		lights[i]->getShadowMap()->BindDsvAndSetNullRenderTarget(renderer->getDeviceContext());
+		renderShadowMap(i, renderer->getDeviceContext());
+		renderStats.merge(shadowStats[i]);
+	}
+
+	// Set back buffer as render target and reset view port.
+	renderer->setBackBufferRenderTarget();
+	renderer->resetViewport();
+}
 
+void Application::prepareShadowMaps()
+{
+	//Everything the shadow maps share with the rest of the frame is done here on the main thread, so they can be recorded on others
+	for (int i = 0; i < 4; i++)
+	{
 		lights[i]->generateViewMatrix();
 
 		XMMATRIX lightViewMatrix = lights[i]->getViewMatrix();
@@ -408,69 +826,468 @@ void Application::depthPass()
 			lightProjectionMatrix = lights[i]->getProjectionMatrix();
 		}
 
-		XMMATRIX worldMatrix = renderer->getWorldMatrix();
-
-		worldMatrix = XMMatrixTranslation(-50.0f, 0.0f, -10.0f);
+		renderStats.beginPass("Shadow map " + std::to_string(i));
+		cullObjects(lightViewMatrix * lightProjectionMatrix);
 
-		// Set the render target to be the render to texture.
-		// Render floor
-		planeMesh->sendData(renderer->getDeviceContext());
-		depthShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, lightViewMatrix, lightProjectionMatrix, textureMgr->getTexture(L"height"),
-			lights[i]->getNearPlane(), lights[i]->getFarPlane(), amplitude, 0.0f);
-		depthShader->render(renderer->getDeviceContext(), planeMesh->getIndexCount());
-
-		// Render model
-		worldMatrix = renderer->getWorldMatrix();
-		worldMatrix = XMMatrixTranslation(0.0f, 7.0f, 5.0f);
-		XMMATRIX scaleMatrix = XMMatrixScaling(0.5f, 0.5f, 0.5f);
-		worldMatrix = XMMatrixMultiply(worldMatrix, scaleMatrix);
-		teapotModel->sendData(renderer->getDeviceContext());
-		depthShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, lightViewMatrix, lightProjectionMatrix, textureMgr->getTexture(L"height"),
-			lights[i]->getNearPlane(), lights[i]->getFarPlane(), amplitude, 1.0f);
-		depthShader->render(renderer->getDeviceContext(), teapotModel->getIndexCount());
-
-		//Render cube
-		worldMatrix = renderer->getWorldMatrix();
-		worldMatrix = XMMatrixTranslation(12.0f, 10.f, 3.0f);
-		cubeMesh->sendData(renderer->getDeviceContext());
-		depthShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, lightViewMatrix, lightProjectionMatrix, textureMgr->getTexture(L"height"),
-			lights[i]->getNearPlane(), lights[i]->getFarPlane(), amplitude, 1.0f);
-		depthShader->render(renderer->getDeviceContext(), cubeMesh->getIndexCount());
-
-		//Render sphere
-		worldMatrix = renderer->getWorldMatrix();
-		worldMatrix = XMMatrixTranslation(-12.0f, 10.f, 2.0f);
-		sphereMesh->sendData(renderer->getDeviceContext());
-		depthShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, lightViewMatrix, lightProjectionMatrix, textureMgr->getTexture(L"height"),
-			lights[i]->getNearPlane(), lights[i]->getFarPlane(), amplitude, 1.0f);
-		depthShader->render(renderer->getDeviceContext(), sphereMesh->getIndexCount());
-
-		// Set back buffer as render target and reset view port.
-		renderer->setBackBufferRenderTarget();
-		renderer->resetViewport();
+		for (int object = 0; object < OBJECT_COUNT; object++)
+		{
+			shadowObjectVisible[i][object] = objectVisible[object];
+		}
 	}
+
+	//The level the camera last drew, from its packed vertices when they're on
+	teapotLods->setDrawPacked(packedVertices);
 }
 
-void Application::renderLightingGizmos()
+void Application::renderShadowMap(int i, ID3D11DeviceContext* context)
 {
-	for (AppLight* light : lights)
-	{
-		if (light->getLightType().w == 0.0f)	//Check the light hasn't been disabled
-		{
-			camera->update();
-			XMMATRIX worldMatrix = renderer->getWorldMatrix();
-			XMMATRIX viewMatrix = camera->getViewMatrix();
-			XMMATRIX projectionMatrix = renderer->getProjectionMatrix();
+	//Draws are counted apart from the frame's stats, which the pass's culling was recorded in
+	RenderStats& stats = shadowStats[i];
+	stats.beginFrame();
+	stats.beginPass("Shadow map " + std::to_string(i));
 
-			//Translate to the light's position
-			worldMatrix *= XMMatrixTranslation(light->getPosition().x, light->getPosition().y, light->getPosition().z);
+	//VSM and EVSM lights write filterable moments to a render texture instead of the hardware shadow map
+	bool momentShadows = lights[i]->getShadowFilterMode() >= (float)ShadowFilter::FILTER_VSM;
+	float momentMode = lights[i]->getShadowFilterMode() >= (float)ShadowFilter::FILTER_EVSM ? 1.0f : 0.0f;
 
-			sphereMesh->sendData(renderer->getDeviceContext());
-			textureShader->setShaderParameters(renderer->getDeviceContext(), worldMatrix, viewMatrix, projectionMatrix, textureMgr->getTexture(L"check"));
-			textureShader->render(renderer->getDeviceContext(), sphereMesh->getIndexCount());
-		}
+	if (momentShadows)
+	{
+		XMFLOAT4 clearMoments = MomentShadow::encode(1.0f, (MomentShadow::Mode)(int)momentMode);
+
+		lights[i]->getMomentMap()->setRenderTarget(context);
+		lights[i]->getMomentMap()->clearRenderTarget(context, clearMoments.x, clearMoments.y, clearMoments.z, clearMoments.w);
 	}
-}
+
+	else
+	{
+		lights[i]->getShadowMap()->BindDsvAndSetNullRenderTarget(context);
+	}
+
+	XMMATRIX lightViewMatrix = lights[i]->getViewMatrix();
+	XMMATRIX lightProjectionMatrix = lights[i]->getProjectionMatrixType() == 0.0f ? lights[i]->getOrthoMatrix() : lights[i]->getProjectionMatrix();
+	XMMATRIX worldMatrix = scene.getWorldMatrix(floorNode);
+
+	// Render floor
+	if (chunkedTerrain)
+	{
+		//Every chunk has position streams, so one shader reads them all
+		DepthShader* chunkDepthShader = positionStreams ? positionDepthShader : depthShader;
+		chunkDepthShader->setShaderParameters(context, worldMatrix, lightViewMatrix, lightProjectionMatrix, textureMgr->getTexture(L"height"),
+			lights[i]->getNearPlane(), lights[i]->getFarPlane(), amplitude, 1.0f, lights[i]->getProjectionMatrixType(), momentMode);
+
+		for (int node : shadowTerrainChunks)
+		{
+			TerrainChunkMesh* mesh = terrain->getMesh(node);
+			sendShadowCaster(mesh, context, stats);
+			chunkDepthShader->render(context, mesh->getIndexCount());
+		}
+	}
+
+	else
+	{
+		DepthShader* planeDepthShader = sendShadowCaster(planeMesh, context, stats);
+		planeDepthShader->setShaderParameters(context, worldMatrix, lightViewMatrix, lightProjectionMatrix, textureMgr->getTexture(L"height"),
+			lights[i]->getNearPlane(), lights[i]->getFarPlane(), amplitude, 0.0f, lights[i]->getProjectionMatrixType(), momentMode);
+		planeDepthShader->render(context, planeMesh->getIndexCount());
+	}
+
+	// Render model
+	if (shadowObjectVisible[i][OBJECT_TEAPOT])
+	{
+		worldMatrix = scene.getWorldMatrix(teapotNode);
+		DepthShader* teapotDepthShader = packedDepthShader;
+		XMMATRIX teapotWorldMatrix = XMMatrixMultiply(teapotLods->getDecodeMatrix(), worldMatrix);
+
+		if (packedVertices)
+		{
+			stats.recordDraw(teapotLods->getIndexCount(), teapotLods->getVertexCount(), teapotLods->sendData(context));
+		}
+
+		else
+		{
+			teapotDepthShader = sendShadowCaster(teapotLods, context, stats);
+		}
+
+		teapotDepthShader->setShaderParameters(context, teapotWorldMatrix, lightViewMatrix, lightProjectionMatrix, textureMgr->getTexture(L"height"),
+			lights[i]->getNearPlane(), lights[i]->getFarPlane(), amplitude, 1.0f, lights[i]->getProjectionMatrixType(), momentMode);
+		teapotDepthShader->render(context, teapotLods->getIndexCount());
+	}
+
+	//Render cube
+	if (shadowObjectVisible[i][OBJECT_CUBE])
+	{
+		worldMatrix = scene.getWorldMatrix(cubeNode);
+		DepthShader* cubeDepthShader = sendShadowCaster(cubeMesh, context, stats);
+		cubeDepthShader->setShaderParameters(context, worldMatrix, lightViewMatrix, lightProjectionMatrix, textureMgr->getTexture(L"height"),
+			lights[i]->getNearPlane(), lights[i]->getFarPlane(), amplitude, 1.0f, lights[i]->getProjectionMatrixType(), momentMode);
+		cubeDepthShader->render(context, cubeMesh->getIndexCount());
+	}
+
+	//Render sphere
+	if (shadowObjectVisible[i][OBJECT_SPHERE])
+	{
+		worldMatrix = scene.getWorldMatrix(sphereNode);
+		DepthShader* sphereDepthShader = sendShadowCaster(sphereMesh, context, stats);
+		sphereDepthShader->setShaderParameters(context, worldMatrix, lightViewMatrix, lightProjectionMatrix, textureMgr->getTexture(L"height"),
+			lights[i]->getNearPlane(), lights[i]->getFarPlane(), amplitude, 1.0f, lights[i]->getProjectionMatrixType(), momentMode);
+		sphereDepthShader->render(context, sphereMesh->getIndexCount());
+	}
+
+	if (momentShadows)
+	{
+		blurMomentMap(lights[i], context);
+	}
+}
+
+void Application::postProcess(ID3D11DeviceContext* context)
+{
+	bloomExtract(context);
+
+	horizontalBlur(context);
+	verticalBlur(context);
+
+	bloomComposite(context);
+}
+
+
+//Binds a shadow caster's vertices for a depth only pass, just its positions and texture coordinates when it has streams of them,
+//records the draw and returns the depth shader that reads what was bound
+DepthShader* Application::sendShadowCaster(BaseMesh* mesh, ID3D11DeviceContext* context, RenderStats& stats)
+{
+	DepthShader* shader = depthShader;
+	unsigned int bytesPerVertex;
+
+	if (positionStreams && mesh->hasPositionStreams())
+	{
+		bytesPerVertex = mesh->sendPositionData(context);
+		shader = positionDepthShader;
+	}
+
+	else
+	{
+		bytesPerVertex = mesh->sendData(context);
+	}
+
+	//The bytes come back from the call rather than off the mesh, which other threads may be binding for their own passes
+	stats.recordDraw(mesh->getIndexCount(), mesh->getVertexCount(), bytesPerVertex);
+
+	return shader;
+}
+
+//Submits a grid of small cubes to an offscreen target one draw at a time, then as one instanced draw, timing the CPU side of each.
+//The GPU's work is the same either way, so only the submission is measured.
+void Application::benchmarkInstancing()
+{
+	const int side = 47;
+	int count = instancingBenchmarkCubes;
+
+	if (!benchmarkCube)
+	{
+		benchmarkCube = new CubeMesh(renderer->getDevice(), renderer->getDeviceContext(), 1);
+		benchmarkInstances = new InstanceBuffer(renderer->getDevice(), count);
+		benchmarkTexture = new RenderTexture(renderer->getDevice(), 256, 256, SCREEN_NEAR, SCREEN_DEPTH);
+	}
+
+	std::vector<InstanceBuffer::Instance> instances(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		float x = (float)(i % side);
+		float y = (float)((i / side) % side);
+		float z = (float)(i / (side * side));
+		XMStoreFloat4x4(&instances[i].world, XMMatrixMultiply(XMMatrixScaling(0.25f, 0.25f, 0.25f), XMMatrixTranslation(x - (side / 2), y, z)));
+	}
+
+	XMMATRIX viewMatrix = camera->getViewMatrix();
+	XMMATRIX projectionMatrix = renderer->getProjectionMatrix();
+	benchmarkTexture->setRenderTarget(renderer->getDeviceContext());
+	benchmarkTexture->clearRenderTarget(renderer->getDeviceContext(), 0.0f, 0.0f, 0.0f, 1.0f);
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for (int i = 0; i < count; i++)
+	{
+		benchmarkCube->sendData(renderer->getDeviceContext());
+		lightShader->setShaderParameters(renderer->getDeviceContext(), XMLoadFloat4x4(&instances[i].world), viewMatrix, projectionMatrix, textureMgr->getTexture(L"wood"),
+			textureMgr->getTexture(L"wood"), 1.0f, lights, camera->getPosition(), timer->getTime(), renderType, 0.0f, 1.0f, renderShadows, shadowFilter, nullptr);
+		lightShader->render(renderer->getDeviceContext(), benchmarkCube->getIndexCount());
+	}
+
+	instancingBenchmark[0] = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	benchmarkInstances->update(renderer->getDeviceContext(), instances.data(), count);
+	instancingBenchmark[1] = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	benchmarkCube->sendInstancedData(renderer->getDeviceContext(), benchmarkInstances->getBuffer(), InstanceBuffer::getStride());
+	instancedLightShader->setShaderParameters(renderer->getDeviceContext(), XMMatrixIdentity(), viewMatrix, projectionMatrix, textureMgr->getTexture(L"wood"),
+		textureMgr->getTexture(L"wood"), 1.0f, lights, camera->getPosition(), timer->getTime(), renderType, 0.0f, 1.0f, renderShadows, shadowFilter, nullptr);
+	instancedLightShader->renderInstanced(renderer->getDeviceContext(), benchmarkCube->getIndexCount(), benchmarkInstances->getCount());
+	instancingBenchmark[2] = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	renderer->setBackBufferRenderTarget();
+	renderer->resetViewport();
+}
+
+//Separable prefilter of a light's moment map, once per shadow map rather than once per shaded pixel. The moment blur shaders clamp
+//at the edges, as the moment sampler in LightShader, so one side of the map does not wrap into the other.
+void Application::blurMomentMap(AppLight* light, ID3D11DeviceContext* context)
+{
+	XMMATRIX worldMatrix = renderer->getWorldMatrix();
+	XMMATRIX baseViewMatrix = camera->getOrthoViewMatrix();
+	XMMATRIX orthoMatrix = light->getMomentMap()->getOrthoMatrix();
+
+	float size = (float)light->getMomentMap()->getTextureWidth();
+	float radius = (float)momentBlurRadius;
+	float deviation = radius > 1.0f ? radius * 0.5f : 0.5f;
+
+	renderer->setZBuffer(false, context);
+	momentOrthoMesh->sendData(context);
+
+	light->getMomentBlurMap()->setRenderTarget(context);
+	momentHorizontalBlurShader->setShaderParameters(context, worldMatrix, baseViewMatrix, orthoMatrix, light->getMomentMap()->getShaderResourceView(), size, -radius, radius, deviation);
+	momentHorizontalBlurShader->render(context, momentOrthoMesh->getIndexCount());
+
+	light->getMomentMap()->setRenderTarget(context);
+	momentVerticalBlurShader->setShaderParameters(context, worldMatrix, baseViewMatrix, orthoMatrix, light->getMomentBlurMap()->getShaderResourceView(), size, -radius, radius, deviation);
+	momentVerticalBlurShader->render(context, momentOrthoMesh->getIndexCount());
+
+	renderer->setZBuffer(true, context);
+}
+
+//Culls the clustered lights against the camera, assigns the survivors to the view's clusters and sends the lists to the GPU
+void Application::updateLightClusters()
+{
+	camera->update();
+
+	Frustum frustum(camera->getViewMatrix() * renderer->getProjectionMatrix());
+	lightSystem->cull(frustum, visibleLights);
+
+	lightClusters->build(*lightSystem, visibleLights, camera->getViewMatrix(), renderer->getProjectionMatrix(), SCREEN_NEAR, SCREEN_DEPTH, multithreadedClusters);
+	lightClusterBuffers->upload(renderer->getDeviceContext(), *lightClusters, *lightSystem, visibleLights);
+}
+
+//Re-bakes the terrain if needed, then picks the chunks for this frame by their projected error. The same pick without culling is
+//used for the shadow maps.
+void Application::updateTerrainLod()
+{
+	//The chunks hold displaced vertices, rescaled when the amplitude changes and re-baked where the heights were edited
+	terrain->update(renderer->getDeviceContext(), amplitude);
+
+	camera->update();
+
+	//The terrain is placed by the floor's node, so the camera is moved the opposite way into terrain space
+	XMMATRIX terrainMatrix = scene.getWorldMatrix(floorNode);
+	XMFLOAT4X4 projection;
+	XMStoreFloat4x4(&projection, renderer->getProjectionMatrix());
+
+	TerrainQuadtree::SelectionParams params;
+	params.cameraPosition = getTerrainCameraPosition();
+	params.amplitude = amplitude;
+	params.projectionScale = projection._22 * (float)sceneTexture->getTextureHeight() * 0.5f;
+	params.pixelThreshold = terrainPixelError;
+
+	Frustum frustum(terrainMatrix * camera->getViewMatrix() * renderer->getProjectionMatrix());
+	terrain->select(params, &frustum, terrainChunks);
+	terrain->select(params, nullptr, shadowTerrainChunks);
+}
+
+//Fills the hull shader's settings for this frame, and measures the same tessellation on the CPU for the GUI's triangle count
+void Application::updateTerrainTessellation()
+{
+	camera->update();
+
+	//The patches are placed by the floor's node like the plane, so the camera and frustum are moved into terrain space
+	XMMATRIX terrainMatrix = scene.getWorldMatrix(floorNode);
+	XMFLOAT4X4 projection;
+	XMStoreFloat4x4(&projection, renderer->getProjectionMatrix());
+
+	terrainTessellation.cameraPosition = getTerrainCameraPosition();
+	terrainTessellation.amplitude = amplitude;
+	terrainTessellation.projectionScale = projection._22 * (float)sceneTexture->getTextureHeight() * 0.5f;
+	terrainTessellation.pixelsPerEdge = terrainPixelsPerEdge;
+	terrainTessellation.minFactor = 1.0f;
+	terrainTessellation.maxFactor = terrainMaxTessellation;
+
+	terrainFrustum = Frustum(terrainMatrix * camera->getViewMatrix() * renderer->getProjectionMatrix());
+	tessellationStats = TerrainTessellation::measureView(terrainTessellation, terrainFrustum, terrainPatchMesh->getPatchesPerSide(), terrainPatchMesh->getWorldSize());
+}
+
+//Scatters the grass over the terrain's CPU heights and uploads the blades to the instance buffer
+void Application::scatterGrass()
+{
+	std::vector<GrassScatter::Instance> instances;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	if (poissonGrass)
+	{
+		GrassScatter::scatterPoisson(terrain->getHeightField(), 100.0f, grassSpacing, 1, instances);
+	}
+
+	else
+	{
+		GrassScatter::scatterJittered(terrain->getHeightField(), 100.0f, grassSpacing, 1, instances);
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	grassScatterMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+
+	//Eight cells a side, each around twelve units across
+	grassCells->build(instances, 100.0f, 8);
+	grassMesh->createInstanceBuffer(renderer->getDevice(), grassCells->getBladeCount());
+	grassWind->build(*grassCells);
+}
+
+//Culls the grass cells against the view and thins the blades with distance, writing the survivors straight into the instance buffer
+void Application::updateGrass()
+{
+	//Only the batches that fit the budget are stepped, the rest keep last frame's bend
+	if (grassWindEnabled)
+	{
+		grassWindTime += timer->getTime();
+		grassWindSettings.direction = XMFLOAT2(cosf(grassWindAngle), sinf(grassWindAngle));
+		grassWind->update(grassWindTime, grassWindSettings, true, multithreadedGrass);
+	}
+
+	GrassScatter::Instance* instances = grassMesh->mapInstances(renderer->getDeviceContext());
+
+	if (!instances)
+	{
+		return;
+	}
+
+	camera->update();
+
+	//The grass is placed by the floor's node with the terrain, so the camera and frustum are moved into terrain space
+	XMMATRIX grassMatrix = scene.getWorldMatrix(floorNode);
+
+	GrassCells::CullSettings settings;
+	settings.cameraPosition = getTerrainCameraPosition();
+	settings.amplitude = amplitude;
+	settings.fadeStart = grassFadeStart;
+	settings.fadeEnd = grassFadeEnd > grassFadeStart ? grassFadeEnd : grassFadeStart;
+
+	//The view's forward axis is the third column of the view matrix, translating the grass doesn't change it
+	XMFLOAT4X4 view;
+	XMStoreFloat4x4(&view, camera->getViewMatrix());
+	settings.viewDirection = XMFLOAT3(view._13, view._23, view._33);
+	settings.backToFront = sortGrass && getGrassTransparency() == GrassShader::BLENDED;
+
+	Frustum frustum(grassMatrix * camera->getViewMatrix() * renderer->getProjectionMatrix());
+	int count = grassCells->cull(settings, frustum, instances, true, multithreadedGrass, grassWindEnabled ? grassWind->getPackedBends() : nullptr);
+
+	grassMesh->unmapInstances(renderer->getDeviceContext(), count);
+}
+
+//Bakes the teapot's octahedral impostor on the CPU, coloured by the wood texture when it can be read back
+void Application::bakeImpostors()
+{
+	std::vector<uint32_t> texels;
+	ImpostorBaker::Texture albedo = { 0, 0, nullptr };
+
+	if (Impostor::readTexture(renderer->getDevice(), renderer->getDeviceContext(), textureMgr->getTexture(L"wood"), texels, albedo.width, albedo.height))
+	{
+		albedo.texels = texels.data();
+	}
+
+	teapotImpostor->bake(renderer->getDevice(), teapotModel->getVertices(), teapotModel->getIndices(), albedo, impostorFramesPerSide, impostorFrameSize);
+}
+
+//The camera's position relative to the floor, which the terrain and grass are built around
+XMFLOAT3 Application::getTerrainCameraPosition()
+{
+	XMFLOAT3 position = camera->getPosition();
+	XMMATRIX toTerrain = XMMatrixInverse(nullptr, scene.getWorldMatrix(floorNode));
+	XMStoreFloat3(&position, XMVector3TransformCoord(XMLoadFloat3(&position), toTerrain));
+
+	return position;
+}
+
+//Height on screen of the bounding sphere of an impostor's model, in pixels
+float Application::getProjectedSize(const XMMATRIX& worldMatrix, const Impostor* impostor)
+{
+	const ImpostorBaker::Atlas& atlas = impostor->getAtlas();
+
+	XMFLOAT3 cameraPosition = camera->getPosition();
+	XMVECTOR centre = XMVector3TransformCoord(XMLoadFloat3(&atlas.centre), worldMatrix);
+	float radius = atlas.radius * XMVectorGetX(XMVector3Length(worldMatrix.r[0]));
+	float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(centre, XMLoadFloat3(&cameraPosition))));
+
+	//The projection's y scale is the cotangent of half the field of view
+	XMFLOAT4X4 projection;
+	XMStoreFloat4x4(&projection, renderer->getProjectionMatrix());
+
+	return distance > radius ? (radius * projection._22 * (float)sHeight) / distance : (float)sHeight;
+}
+
+//How the forward pass draws the grass. The G-buffer can't blend and the bloom's scene texture isn't multisampled, so both cut the
+//blades out as before. Otherwise alpha to coverage smooths the edges when the back buffer is multisampled, or they are blended.
+GrassShader::Transparency Application::getGrassTransparency()
+{
+	if (deferredShading || enableBloom)
+	{
+		return GrassShader::CUTOUT;
+	}
+
+	if (grassAlphaToCoverage && renderer->getSampleCount() > 1)
+	{
+		return GrassShader::ALPHA_TO_COVERAGE;
+	}
+
+	return GrassShader::BLENDED;
+}
+
+void Application::renderLightingGizmos()
+{
+	camera->update();
+	XMMATRIX viewMatrix = camera->getViewMatrix();
+	XMMATRIX projectionMatrix = renderer->getProjectionMatrix();
+
+	//Every gizmo is the same textured sphere, so the shader, texture and mesh are bound once for all of them
+	drawQueue.clear();
+
+	for (int i = 0; i < 4; i++)
+	{
+		if (lights[i]->getLightType().w == 0.0f)	//Check the light hasn't been disabled
+		{
+			XMFLOAT3 position = lights[i]->getPosition();
+			XMVECTOR viewPosition = XMVector3TransformCoord(XMLoadFloat3(&position), viewMatrix);
+			drawQueue.submit(DrawQueue::makeKey(DRAW_GIZMOS, SHADER_TEXTURE, MATERIAL_CHECK, OBJECT_SPHERE, XMVectorGetZ(viewPosition)), i);
+		}
+	}
+
+	if (sortDraws)
+	{
+		drawQueue.sort();
+	}
+
+	drawQueue.execute(drawState, [&](const DrawQueue::Packet& packet, unsigned int binds)
+	{
+		if (binds & DrawQueue::BIND_SHADER)
+		{
+			textureShader->bind(renderer->getDeviceContext());
+		}
+
+		if (binds & DrawQueue::BIND_MATERIAL)
+		{
+			textureShader->setMaterial(renderer->getDeviceContext(), textureMgr->getTexture(L"check"));
+		}
+
+		if (binds & DrawQueue::BIND_MESH)
+		{
+			sphereMesh->sendData(renderer->getDeviceContext());
+		}
+
+		//Translate to the light's position
+		XMFLOAT3 position = lights[packet.payload]->getPosition();
+		XMMATRIX worldMatrix = renderer->getWorldMatrix() * XMMatrixTranslation(position.x, position.y, position.z);
+
+		textureShader->setObjectParameters(renderer->getDeviceContext(), worldMatrix, viewMatrix, projectionMatrix);
+		textureShader->draw(renderer->getDeviceContext(), sphereMesh->getIndexCount());
+	});
+}
 
 void Application::guiGeneral()
 {
@@ -612,6 +1429,85 @@ void Application::guiLighting()
 	}
 }
 
+void Application::guiClusteredLights()
+{
+	if (ImGui::CollapsingHeader("Clustered Lights", 0))
+	{
+		ImGui::Checkbox("Render Clustered Lights", &renderClusteredLights);
+		ImGui::Checkbox("Multithreaded Cluster Build", &multithreadedClusters);
+
+		int count = clusteredLightCount;
+		ImGui::DragInt("Clustered Light Count", &count, 4, 0, LightClusters::MAX_LIGHTS);
+
+		if (count != clusteredLightCount)
+		{
+			clusteredLightCount = count;
+			lightSystem->clear();
+			lightSystem->addRandomLights(clusteredLightCount, XMFLOAT3(-50.0f, 1.0f, -10.0f), XMFLOAT3(50.0f, 8.0f, 90.0f));
+		}
+
+		const LightClusters::BuildStats& stats = lightClusters->getStats();
+		ImGui::Text("Visible after frustum culling: %d of %d", (int)visibleLights.size(), lightSystem->getCount());
+		ImGui::Text("Build: %.3f ms, %d lights, %d indices", stats.buildMilliseconds, stats.lightCount, stats.indexCount);
+		ImGui::Text("Most lights in one cluster: %d%s", stats.maxLightsPerCluster, stats.truncated ? " (index list full)" : "");
+
+		//Times the cluster build from the current view at fixed light counts, the frame's own lights are rebuilt next frame
+		if (ImGui::Button("Benchmark Cluster Build"))
+		{
+			const int lightCounts[3] = { 256, 1024, 4096 };
+
+			for (int i = 0; i < 3; i++)
+			{
+				LightSystem testLights;
+				testLights.addRandomLights(lightCounts[i], XMFLOAT3(-50.0f, 1.0f, -10.0f), XMFLOAT3(50.0f, 8.0f, 90.0f));
+
+				//Every light is clustered, without frustum culling, so the counts are exact
+				std::vector<unsigned int> allLights(lightCounts[i]);
+
+				for (int j = 0; j < lightCounts[i]; j++)
+				{
+					allLights[j] = j;
+				}
+
+				clusterBenchmarks[i][0] = lightClusters->benchmark(testLights, allLights, camera->getViewMatrix(), renderer->getProjectionMatrix(), SCREEN_NEAR, SCREEN_DEPTH, false, 10);
+				clusterBenchmarks[i][1] = lightClusters->benchmark(testLights, allLights, camera->getViewMatrix(), renderer->getProjectionMatrix(), SCREEN_NEAR, SCREEN_DEPTH, true, 10);
+			}
+		}
+
+		ImGui::Text("256 lights: %.3f ms single, %.3f ms threaded", clusterBenchmarks[0][0], clusterBenchmarks[0][1]);
+		ImGui::Text("1024 lights: %.3f ms single, %.3f ms threaded", clusterBenchmarks[1][0], clusterBenchmarks[1][1]);
+		ImGui::Text("4096 lights: %.3f ms single, %.3f ms threaded", clusterBenchmarks[2][0], clusterBenchmarks[2][1]);
+	}
+}
+
+void Application::guiDeferredShading()
+{
+	if (ImGui::CollapsingHeader("Deferred Shading", 0))
+	{
+		ImGui::Checkbox("Deferred Shading", &deferredShading);
+		ImGui::Text("G-buffer: %d bytes per pixel, %.2f MB", GBuffer::getBytesPerPixel(),
+			(float)(GBuffer::getBytesPerPixel() * gBuffer->getWidth() * gBuffer->getHeight()) / (1024.0f * 1024.0f));
+
+		//Round trips random normals and positions through the CPU reference of the G-buffer encoding
+		if (ImGui::Button("Measure G-Buffer Precision"))
+		{
+			const int normalBits[3] = { 8, 10, 16 };
+
+			for (int i = 0; i < 3; i++)
+			{
+				gBufferPrecision[i] = GBufferEncoding::measurePrecision(normalBits[i], 100000, renderer->getProjectionMatrix(), SCREEN_NEAR, SCREEN_DEPTH);
+			}
+		}
+
+		for (int i = 0; i < 3; i++)
+		{
+			ImGui::Text("%d bit normals: mean %.4f, max %.4f degrees", gBufferPrecision[i].normalBits, gBufferPrecision[i].meanNormalError, gBufferPrecision[i].maxNormalError);
+		}
+
+		ImGui::Text("Position from depth: mean %.6f, max %.6f units", gBufferPrecision[0].meanPositionError, gBufferPrecision[0].maxPositionError);
+	}
+}
+
 void Application::guiShadows()
 {
 	if (ImGui::CollapsingHeader("Shadows", 0))
@@ -620,8 +1516,39 @@ void Application::guiShadows()
 		ImGui::Checkbox("Toggle Shadows", &shadow);
 		renderShadows = shadow;
 
+		//Sample patterns shared by the Poisson PCF and PCSS filters
+		int samples = shadowFilter->getSampleCount();
+		int blockerSamples = shadowFilter->getBlockerSampleCount();
+		float lightSize = shadowFilter->getLightSize();
+
+		ImGui::DragInt("Poisson Samples", &samples, 1, 4, ShadowFilter::MAX_SAMPLES);
+		ImGui::DragInt("PCSS Blocker Samples", &blockerSamples, 1, 1, samples);
+		ImGui::DragFloat("PCSS Light Size", &lightSize, 0.1f, 1.0f, 50.0f);
+
+		if (samples != shadowFilter->getSampleCount())
+		{
+			shadowFilter->generatePoissonDisk(samples);
+		}
+
+		shadowFilter->setBlockerSampleCount(blockerSamples);
+		shadowFilter->setLightSize(lightSize);
+
+		ImGui::Spacing();
+
+		//Settings for the VSM and EVSM filters
+		float minVariance = shadowFilter->getMinVariance();
+		float bleedReduction = shadowFilter->getBleedReduction();
+
+		ImGui::DragInt("Moment Blur Radius", &momentBlurRadius, 1, 0, 10);
+		ImGui::DragFloat("Minimum Variance", &minVariance, 0.000001f, 0.0f, 0.001f, "%.6f");
+		ImGui::DragFloat("Light Bleed Reduction", &bleedReduction, 0.01f, 0.0f, 0.9f);
+
+		shadowFilter->setMinVariance(minVariance);
+		shadowFilter->setBleedReduction(bleedReduction);
+
 		int index = 1;
 		const char* matrixLabels[] = { "orthographic", "perspective" };
+		const char* filterLabels[] = { "sample grid", "poisson (PCF)", "PCSS", "variance (VSM)", "exponential variance (EVSM)" };
 		static const char* currentLabel[4] =
 		{
 			matrixLabels[(int)lights[0]->getProjectionMatrixType()],
@@ -676,6 +1603,10 @@ void Application::guiShadows()
 			std::string radiusLabel = "(" + std::to_string(index) + ") Softening Radius";
 			ImGui::DragInt(radiusLabel.c_str(), &radius, 1, 1, 25);
 
+			int filterMode = (int)light->getShadowFilterMode();
+			std::string filterLabel = "(" + std::to_string(index) + ") Shadow Filter";
+			ImGui::Combo(filterLabel.c_str(), &filterMode, filterLabels, IM_ARRAYSIZE(filterLabels));
+
 			//To prevent exceptions errors - the near plane must always be less than the far plane
 			if (nearP >= farP)
 			{
@@ -692,6 +1623,7 @@ void Application::guiShadows()
 			light->setFarPlane(farP);
 			light->setSoftenShadows(soften);
 			light->setSoftenRadius(radius);
+			light->setShadowFilterMode((float)filterMode);
 
 			index++;
 		}
@@ -755,17 +1687,524 @@ void Application::guiVertexManipulation()
 		}
 
 		amplitude = ampl;
+
+		//CPU quadtree LOD over the heightmap, in place of the full resolution plane
+		ImGui::Checkbox("Chunked Terrain", &chunkedTerrain);
+		ImGui::SliderFloat("Terrain Pixel Error", &terrainPixelError, 0.5f, 16.0f);
+		ImGui::Text("Terrain: %d nodes, %d drawn, %d in shadow maps", (int)terrain->getQuadtree().getNodes().size(), (int)terrainChunks.size(), (int)shadowTerrainChunks.size());
+		ImGui::Checkbox("Terrain Normal Map", &terrainNormalMap);
+		ImGui::Text("Last terrain bake: %.2f ms, %d tiles, %d chunks", terrain->getBakeMilliseconds(), terrain->getLastDirtyTiles(), terrain->getLastRebakedChunks());
+
+		//Edits the CPU heights under the camera, only the chunked terrain shows them
+		ImGui::SliderFloat("Brush Radius", &terrainBrushRadius, 1.0f, 20.0f);
+		ImGui::SliderFloat("Brush Strength", &terrainBrushStrength, -0.1f, 0.1f);
+
+		if (ImGui::Button("Apply Brush Below Camera"))
+		{
+			XMFLOAT3 terrainCamera = getTerrainCameraPosition();
+			terrain->applyBrush(terrainCamera.x, terrainCamera.z, terrainBrushRadius, terrainBrushStrength);
+		}
+
+		//Generated heightmaps, the quadtree is built with every thread and selection is averaged over a ring of views
+		if (ImGui::Button("Benchmark 4k Terrain"))
+		{
+			terrainBenchmarks[0] = TerrainQuadtree::benchmark(4096, 64, 16);
+		}
+
+		ImGui::SameLine();
+
+		if (ImGui::Button("Benchmark 16k Terrain (512 MB)"))
+		{
+			terrainBenchmarks[1] = TerrainQuadtree::benchmark(16384, 64, 16);
+		}
+
+		for (int i = 0; i < 2; i++)
+		{
+			const TerrainQuadtree::BenchmarkResult& result = terrainBenchmarks[i];
+
+			ImGui::Text("%d: generate %.1f ms, build %.1f ms, select %.4f ms", result.heightFieldSize, result.generateMilliseconds, result.buildMilliseconds, result.selectMilliseconds);
+			ImGui::Text("    %d nodes, %.1f selected, %.4f of full resolution triangles", result.nodeCount, result.selectedNodes, result.triangleRatio);
+		}
+
+		if (ImGui::Button("Benchmark 4k Normal Bake"))
+		{
+			terrainBakeBenchmark = TerrainBaker::benchmark(4096);
+		}
+
+		ImGui::Text("Scalar %.1f ms, SIMD %.1f ms, SIMD multithreaded %.1f ms", terrainBakeBenchmark.scalarMilliseconds, terrainBakeBenchmark.simdMilliseconds,
+			terrainBakeBenchmark.multithreadedMilliseconds);
+		ImGui::Text("Largest SIMD difference: %.4f", terrainBakeBenchmark.maxDifference);
+
+		if (ImGui::Button("Benchmark 4k Brush Edits"))
+		{
+			terrainEditBenchmark = TerrainBaker::benchmarkEdits(4096, 32, 16);
+		}
+
+		ImGui::Text("Radius %d brush: full re-bake %.2f ms, dirty tiles %.3f ms (%.1f tiles)", terrainEditBenchmark.brushRadius, terrainEditBenchmark.fullMilliseconds,
+			terrainEditBenchmark.incrementalMilliseconds, terrainEditBenchmark.dirtyTiles);
+
+		//Hardware tessellation of the heightmap, drawn in place of the plane or chunks in the camera's view
+		ImGui::Checkbox("Tessellated Terrain", &tessellatedTerrain);
+		ImGui::SliderFloat("Pixels Per Edge", &terrainPixelsPerEdge, 4.0f, 64.0f);
+		ImGui::SliderFloat("Max Tessellation", &terrainMaxTessellation, 1.0f, 64.0f);
+		ImGui::Text("Tessellated: %d patches, %d triangles, average factor %.1f", tessellationStats.visiblePatches, tessellationStats.triangles, tessellationStats.averageFactor);
+
+		if (ImGui::Button("Benchmark Tessellation"))
+		{
+			tessellationBenchmark = TerrainTessellation::benchmark(terrainPatchMesh->getPatchesPerSide(), terrainPixelsPerEdge, terrainMaxTessellation, 16);
+		}
+
+		ImGui::Text("%d views: %.0f triangles (%.0f - %.0f) against the plane's %d, %.1f patches, %.4f ms", tessellationBenchmark.views, tessellationBenchmark.averageTriangles,
+			tessellationBenchmark.minTriangles, tessellationBenchmark.maxTriangles, tessellationBenchmark.planeTriangles, tessellationBenchmark.averagePatches, tessellationBenchmark.milliseconds);
 	}
 }
 
-void Application::guiBillboarding()
+void Application::guiGrass()
 {
-	if (ImGui::CollapsingHeader("Billboarding", 0))
+	if (ImGui::CollapsingHeader("Grass", 0))
 	{
 		static bool grass = renderGrass;
 
 		ImGui::Checkbox("Toggle Grass", &grass);
 
 		renderGrass = grass;
+
+		//Scattering again also picks up any brush edits to the heights
+		ImGui::SliderFloat("Grass Spacing", &grassSpacing, 0.25f, 4.0f);
+		ImGui::Checkbox("Poisson Disc Scatter", &poissonGrass);
+
+		if (ImGui::Button("Scatter Grass"))
+		{
+			scatterGrass();
+		}
+
+		ImGui::Text("%d blades in %d cells, scattered in %.2f ms", grassCells->getBladeCount(), grassCells->getCellCount(), grassScatterMilliseconds);
+
+		//Cells outside the view are skipped, blades past the fade start are thinned out by a fixed hash so they don't pop
+		ImGui::SliderFloat("Grass Fade Start", &grassFadeStart, 0.0f, 100.0f);
+		ImGui::SliderFloat("Grass Fade End", &grassFadeEnd, 0.0f, 150.0f);
+		ImGui::Checkbox("Multithreaded Grass Culling", &multithreadedGrass);
+		ImGui::Text("Drawn: %d blades from %d cells, culled in %.3f ms", grassCells->getLastStats().visibleBlades, grassCells->getLastStats().visibleCells,
+			grassCells->getLastStats().milliseconds);
+
+		//Alpha to coverage needs the multisampled back buffer, without it the blended blades are drawn a cell at a time, farthest first
+		const char* transparencies[] = { "Cut Out", "Alpha To Coverage", "Sorted Blending" };
+		ImGui::Checkbox("Grass Alpha To Coverage", &grassAlphaToCoverage);
+		ImGui::Checkbox("Sort Grass Back To Front", &sortGrass);
+		ImGui::Text("Grass transparency: %s, back buffer %dx MSAA", transparencies[getGrassTransparency()], renderer->getSampleCount());
+
+		if (ImGui::Button("Benchmark 1M Instance Depth Sort"))
+		{
+			grassSortBenchmark = DepthSort::benchmark(1000000);
+		}
+
+		ImGui::Text("%d depths: quantise %.2f ms, radix sort %.2f ms, std::stable_sort %.2f ms, orders %s", grassSortBenchmark.count, grassSortBenchmark.quantiseMilliseconds,
+			grassSortBenchmark.radixMilliseconds, grassSortBenchmark.comparisonMilliseconds, grassSortBenchmark.matches ? "match" : "differ");
+
+		if (ImGui::Button("Benchmark Grass Scatter"))
+		{
+			grassBenchmark = GrassScatter::benchmark(100.0f, grassSpacing);
+		}
+
+		ImGui::Text("Plane geometry shader: %d blades", grassBenchmark.planeBlades);
+		ImGui::Text("Jittered: %d blades, %.2f ms, multithreaded %.2f ms", grassBenchmark.jitteredBlades, grassBenchmark.jitteredMilliseconds, grassBenchmark.multithreadedMilliseconds);
+		ImGui::Text("Poisson: %d blades, %.2f ms, closest pair %.3f", grassBenchmark.poissonBlades, grassBenchmark.poissonMilliseconds, grassBenchmark.poissonMinimumDistance);
+
+		//Springs pulled by scrolling gusts, stepped on the CPU within a time budget and uploaded as a bend for each blade
+		ImGui::Checkbox("Grass Wind", &grassWindEnabled);
+		ImGui::SliderAngle("Wind Direction", &grassWindAngle);
+		ImGui::SliderFloat("Wind Strength", &grassWindSettings.strength, 0.0f, 30.0f);
+		ImGui::SliderFloat("Gust Width", &grassWindSettings.gustScale, 1.0f, 40.0f);
+		ImGui::SliderFloat("Gust Speed", &grassWindSettings.gustSpeed, 0.0f, 20.0f);
+		ImGui::SliderFloat("Wind Budget (ms)", &grassWindSettings.budgetMilliseconds, 0.05f, 4.0f);
+		ImGui::Text("Wind: %d blades stepped in %.3f ms, %.1f ns a blade", grassWind->getLastBlades(), grassWind->getLastMilliseconds(), grassWind->getNanosecondsPerBlade());
+
+		if (ImGui::Button("Benchmark 1M Blade Wind"))
+		{
+			grassWindBenchmarks[0] = GrassWind::benchmark(1000000, 30);
+		}
+
+		ImGui::SameLine();
+
+		if (ImGui::Button("Benchmark 4M Blade Wind"))
+		{
+			grassWindBenchmarks[1] = GrassWind::benchmark(4000000, 30);
+		}
+
+		for (int i = 0; i < 2; i++)
+		{
+			const GrassWind::BenchmarkResult& result = grassWindBenchmarks[i];
+
+			ImGui::Text("%d blades: scalar %.2f ns, SIMD %.2f ns, multithreaded %.2f ns a blade, largest difference %.5f", result.blades, result.scalarNanoseconds,
+				result.simdNanoseconds, result.multithreadedNanoseconds, result.maxDifference);
+		}
+
+		//Generated flat fields of one blade per square unit, culled from a ring of views
+		if (ImGui::Button("Benchmark 1M Blade Culling"))
+		{
+			grassCullBenchmarks[0] = GrassCells::benchmark(1000000, 16);
+		}
+
+		ImGui::SameLine();
+
+		if (ImGui::Button("Benchmark 10M Blade Culling (600 MB)"))
+		{
+			grassCullBenchmarks[1] = GrassCells::benchmark(10000000, 16);
+		}
+
+		for (int i = 0; i < 2; i++)
+		{
+			const GrassCells::BenchmarkResult& result = grassCullBenchmarks[i];
+
+			ImGui::Text("%d blades, %d cells: scalar %.3f ms, SIMD %.3f ms, multithreaded %.3f ms", result.blades, result.cells, result.scalarMilliseconds, result.simdMilliseconds,
+				result.multithreadedMilliseconds);
+			ImGui::Text("    %.0f drawn, paths %s", result.averageVisible, result.matches ? "match" : "differ");
+		}
+	}
+}
+
+void Application::guiImpostors()
+{
+	if (ImGui::CollapsingHeader("Impostors", 0))
+	{
+		//The teapot switches to a billboard of its nearest baked views when it is small on screen
+		ImGui::Checkbox("Toggle Impostors", &renderImpostors);
+		ImGui::SliderFloat("Impostor Switch Size (px)", &impostorSwitchPixels, 0.0f, 512.0f);
+		ImGui::Text("Teapot: %.0f px tall, drawn as %s", teapotScreenSize, teapotIsImpostor ? "an impostor" : "the mesh");
+
+		//Rasterized on the CPU, one frame per task
+		ImGui::SliderInt("Frames Per Side", &impostorFramesPerSide, 2, 16);
+		ImGui::SliderInt("Frame Size", &impostorFrameSize, 16, 256);
+
+		if (ImGui::Button("Bake Impostors"))
+		{
+			bakeImpostors();
+		}
+
+		const ImpostorBaker::BakeStats& stats = teapotImpostor->getStats();
+		ImGui::Text("%d frames of %d triangles in %.1f ms, %dx%d atlas", stats.frames, stats.triangles, stats.milliseconds, teapotImpostor->getAtlas().getSize(),
+			teapotImpostor->getAtlas().getSize());
+		ImGui::Text("Coverage %.1f%%, reprojection error %.4f units", stats.coverage * 100.0f, stats.reprojectionError);
+	}
+}
+
+void Application::guiLevelsOfDetail()
+{
+	if (ImGui::CollapsingHeader("Levels of Detail", 0))
+	{
+		//The teapot's simplified levels, built when it is loaded and picked by its size on screen until the impostor takes over
+		ImGui::Checkbox("Toggle Levels of Detail", &renderLevelsOfDetail);
+		ImGui::SliderFloat("Full Detail Size (px)", &lodFullDetailPixels, 64.0f, 1024.0f);
+		ImGui::SliderFloat("Hysteresis", &lodHysteresis, 0.0f, 0.5f);
+		ImGui::Text("Teapot: level %d, %d triangles", teapotLods->getLevel(), teapotLods->getLevelTriangles(teapotLods->getLevel()));
+		ImGui::Text("Chain built in %.2f ms", teapotLods->getBuildMilliseconds());
+
+		for (int i = 0; i < teapotLods->getLevelCount(); i++)
+		{
+			ImGui::Text("Level %d: %d triangles, switches at %.0f px, error %.4f units", i, teapotLods->getLevelTriangles(i), teapotLods->getSwitchPixels(i, lodFullDetailPixels),
+				teapotLods->getLevelError(i));
+		}
+
+		//Simplifies each model to 50%, 25% and 10% of its triangles, one level at a time then the levels in parallel
+		if (ImGui::Button("Benchmark Mesh Simplifier"))
+		{
+			const char* files[2] = { "res/teapot.obj", "res/ScaleBot.obj" };
+
+			for (int i = 0; i < 2; i++)
+			{
+				AModel model(renderer->getDevice(), files[i]);
+				simplifierBenchmarks[i] = MeshSimplifier::benchmark(LodMesh::getPositions(model.getVertices()), model.getIndices(), { 0.5f, 0.25f, 0.1f });
+			}
+		}
+
+		const char* names[2] = { "teapot.obj", "ScaleBot.obj" };
+
+		for (int i = 0; i < 2; i++)
+		{
+			const MeshSimplifier::BenchmarkResult& result = simplifierBenchmarks[i];
+
+			if (result.levelTriangles.empty())
+			{
+				continue;
+			}
+
+			ImGui::Text("%s: %d triangles, radius %.3f", names[i], result.triangles, result.radius);
+			ImGui::Text("One thread %.2f ms, %.0f triangles/s, parallel levels %.2f ms, %.0f triangles/s, %s", result.singleMilliseconds, result.singleTrianglesPerSecond,
+				result.multiMilliseconds, result.multiTrianglesPerSecond, result.matches ? "identical" : "different");
+
+			for (size_t level = 0; level < result.levelTriangles.size(); level++)
+			{
+				ImGui::Text("  %d triangles, quadric error %.4f, farthest source vertex %.4f", result.levelTriangles[level], result.levelError[level],
+					result.levelDistance[level]);
+			}
+		}
+	}
+}
+
+void Application::guiMeshOptimisation()
+{
+	if (ImGui::CollapsingHeader("Mesh Optimisation", 0))
+	{
+		//Every mesh is reordered for the post-transform cache, overdraw and vertex fetch as it is built, simulated with a 16 entry FIFO
+		//cache and 64 byte lines
+		for (const MeshOptimiser::Report& report : MeshOptimiser::getReports())
+		{
+			ImGui::Text("%s: %d triangles, %d to %d vertices", report.name.c_str(), report.triangles, report.verticesBefore, report.verticesAfter);
+			ImGui::Text("  ACMR %.3f to %.3f, ATVR %.3f to %.3f, fetch efficiency %.2f to %.2f", report.before.acmr, report.after.acmr, report.before.atvr,
+				report.after.atvr, report.before.fetchEfficiency, report.after.fetchEfficiency);
+			ImGui::Text("  Weld %.2f ms, cache %.2f ms, overdraw %.2f ms, fetch %.2f ms", report.weldMilliseconds, report.cacheMilliseconds, report.overdrawMilliseconds,
+				report.fetchMilliseconds);
+		}
+	}
+}
+
+void Application::guiVertexPacking()
+{
+	if (ImGui::CollapsingHeader("Vertex Packing", 0))
+	{
+		//The teapot's levels draw from 16 bit positions over its bounds, octahedral normals and half float texture coordinates
+		ImGui::Checkbox("Toggle Packed Vertices", &packedVertices);
+		ImGui::Text("Teapot: %u bytes per vertex, %s normals", packedVertices ? VertexPacker::getStride(compactPackedNormals) : (unsigned int)sizeof(BaseMesh::VertexType),
+			compactPackedNormals ? "8:8" : "16:16");
+
+		//Round trips each mesh's vertices through both packed formats
+		if (ImGui::Button("Measure Vertex Packing"))
+		{
+			AModel scaleBot(renderer->getDevice(), "res/ScaleBot.obj");
+			vertexPackingReports.clear();
+			vertexPackingReports.push_back(VertexPacker::measure("teapot.obj", teapotModel->getVertices().data(), (int)teapotModel->getVertices().size()));
+			vertexPackingReports.push_back(VertexPacker::measure("ScaleBot.obj", scaleBot.getVertices().data(), (int)scaleBot.getVertices().size()));
+
+			if (terrain)
+			{
+				const std::vector<BaseMesh::VertexType>& chunkVertices = terrain->getMesh(0)->getVertices();
+				vertexPackingReports.push_back(VertexPacker::measure("Terrain root chunk", chunkVertices.data(), (int)chunkVertices.size()));
+			}
+		}
+
+		for (const VertexPacker::Report& report : vertexPackingReports)
+		{
+			ImGui::Text("%s: %d vertices, %d bytes, packed %d (%.0f%%), compact %d (%.0f%%), %.2f ms", report.name.c_str(), report.vertices, report.floatBytes,
+				report.packedBytes, 100.0f * report.packedBytes / report.floatBytes, report.compactBytes, 100.0f * report.compactBytes / report.floatBytes, report.milliseconds);
+			ImGui::Text("  16:16 normals: position %.6f (bound %.6f), normal %.3f deg, texture %.6f", report.packedError.position, report.packedError.positionBound,
+				report.packedError.normalDegrees, report.packedError.texture);
+			ImGui::Text("  8:8 normals: position %.6f, normal %.3f deg, texture %.6f", report.compactError.position, report.compactError.normalDegrees,
+				report.compactError.texture);
+		}
+	}
+}
+
+void Application::guiRenderStats()
+{
+	if (ImGui::CollapsingHeader("Render Stats", 0))
+	{
+		//Depth only passes read positions, and texture coordinates for the displaced plane, so normals needn't be fetched
+		ImGui::Checkbox("Toggle Shadow Position Streams", &positionStreams);
+
+		for (const RenderStats::PassStats& pass : renderStats.getPasses())
+		{
+			ImGui::Text("%s: %d draws, %d triangles, %.1f KB of vertices", pass.name.c_str(), pass.draws, pass.triangles, pass.vertexBytes / 1024.0f);
+
+			if (pass.visibleObjects + pass.culledObjects + pass.occludedObjects > 0)
+			{
+				ImGui::Text("  %d objects visible, %d outside the frustum, %d occluded", pass.visibleObjects, pass.culledObjects, pass.occludedObjects);
+			}
+		}
+	}
+}
+
+void Application::guiInstancing()
+{
+	if (ImGui::CollapsingHeader("Instancing", 0))
+	{
+		//The light shader's per object path against one DrawIndexedInstanced of the same cubes, drawn offscreen
+		ImGui::SliderInt("Cubes", &instancingBenchmarkCubes, 1000, 100000);
+
+		if (ImGui::Button("Benchmark Instancing"))
+		{
+			//The instance buffer is made for the first run's count
+			if (benchmarkInstances && benchmarkInstances->getCapacity() < instancingBenchmarkCubes)
+			{
+				delete benchmarkInstances;
+				benchmarkInstances = new InstanceBuffer(renderer->getDevice(), instancingBenchmarkCubes);
+			}
+
+			benchmarkInstancing();
+		}
+
+		if (instancingBenchmark[0] > 0.0f)
+		{
+			float instanced = instancingBenchmark[1] + instancingBenchmark[2];
+			ImGui::Text("Per draw: %.2f ms, %.2f us per cube", instancingBenchmark[0], 1000.0f * instancingBenchmark[0] / benchmarkInstances->getCount());
+			ImGui::Text("Instanced: upload %.3f ms, submit %.3f ms, %.0fx faster", instancingBenchmark[1], instancingBenchmark[2], instancingBenchmark[0] / instanced);
+		}
+	}
+}
+
+void Application::guiSceneGraph()
+{
+	if (ImGui::CollapsingHeader("Scene Graph", 0))
+	{
+		//Moving a node only recomputes it and the nodes below it at the start of the next frame
+		XMFLOAT3 teapotPosition = scene.getPosition(teapotNode);
+
+		if (ImGui::DragFloat3("Teapot Position", &teapotPosition.x, 0.1f))
+		{
+			scene.setPosition(teapotNode, teapotPosition);
+		}
+
+		ImGui::Checkbox("Toggle Multithreaded Update", &multithreadedScene);
+		ImGui::Text("%d nodes, %d updated last frame in %.3f ms", scene.getNodeCount(), scene.getLastUpdated(), scene.getLastMilliseconds());
+
+		//A million nodes with eight children each, every node moved by the root then one node in a hundred turned
+		if (ImGui::Button("Benchmark 1M Nodes"))
+		{
+			sceneBenchmark = SceneGraph::benchmark(1000000, 8, 10);
+		}
+
+		if (sceneBenchmark.nodes > 0)
+		{
+			ImGui::Text("%d nodes, depth %d", sceneBenchmark.nodes, sceneBenchmark.depth);
+			ImGui::Text("Root moved: one thread %.2f ms, every thread %.2f ms", sceneBenchmark.rootSingleMilliseconds, sceneBenchmark.rootMultiMilliseconds);
+			ImGui::Text("1%% dirty, %d nodes updated: one thread %.2f ms, every thread %.2f ms", sceneBenchmark.sparseNodes, sceneBenchmark.sparseSingleMilliseconds,
+				sceneBenchmark.sparseMultiMilliseconds);
+			ImGui::Text("Largest difference %g", sceneBenchmark.maxDifference);
+		}
+	}
+}
+
+void Application::guiCulling()
+{
+	if (ImGui::CollapsingHeader("Culling", 0))
+	{
+		//The camera and every shadow map query the hierarchy for the objects in their frustum, Render Stats shows what each culled
+		ImGui::Checkbox("Toggle Frustum Culling", &cullSceneObjects);
+		ImGui::Text("%d objects, %d nodes", sceneBvh.getObjectCount(), sceneBvh.getNodeCount());
+
+		//A million random boxes, built, queried, moved and refitted, then queried again
+		if (ImGui::Button("Benchmark 1M Objects"))
+		{
+			bvhBenchmark = Bvh::benchmark(1000000, 10);
+		}
+
+		if (bvhBenchmark.objects > 0)
+		{
+			ImGui::Text("%d objects, %d nodes, %d visible", bvhBenchmark.objects, bvhBenchmark.nodes, bvhBenchmark.visible);
+			ImGui::Text("Build %.1f ms, refit %.2f ms", bvhBenchmark.buildMilliseconds, bvhBenchmark.refitMilliseconds);
+			ImGui::Text("Query %.3f ms, testing every box %.3f ms, %s", bvhBenchmark.queryMilliseconds, bvhBenchmark.bruteForceMilliseconds,
+				bvhBenchmark.matches ? "identical" : "different");
+		}
+
+		//The chunked terrain is drawn into a 256x128 depth buffer on the CPU, and the objects the camera's frustum keeps are tested against it
+		ImGui::Checkbox("Toggle Occlusion Culling", &occlusionCulling);
+		ImGui::Checkbox("Toggle Multithreaded Rasterisation", &multithreadedOcclusion);
+
+		if (ImGui::SliderInt("Terrain Occluder Quads", &occluderQuadsPerSide, 8, 64))
+		{
+			//Whole cells of the heightmap's grid
+			while (terrain->getQuadtree().getGridSize() % occluderQuadsPerSide != 0)
+			{
+				occluderQuadsPerSide--;
+			}
+
+			terrainOccluderBake = -1;
+		}
+
+		if (occlusionActive)
+		{
+			const OcclusionCuller::Stats& stats = occlusionCuller.getStats();
+			ImGui::Text("%d occluder triangles, %d binned to tiles", stats.occluderTriangles, stats.rasterisedTriangles);
+			ImGui::Text("Bin %.3f ms, rasterise %.3f ms, hierarchical-Z %.3f ms", stats.binMilliseconds, stats.rasteriseMilliseconds, stats.hiZMilliseconds);
+		}
+
+		//Props along the streets of a city of box buildings, seen from a corner at head height
+		if (ImGui::Button("Benchmark Occlusion"))
+		{
+			occlusionBenchmarks[0] = OcclusionCuller::benchmark(32, 100000, 10);
+			occlusionBenchmarks[1] = OcclusionCuller::benchmark(64, 100000, 10);
+		}
+
+		for (const OcclusionCuller::BenchmarkResult& result : occlusionBenchmarks)
+		{
+			if (result.buildings == 0)
+			{
+				continue;
+			}
+
+			ImGui::Text("%d buildings, %d triangles: bin %.2f ms, rasterise %.2f ms on one thread, %.2f ms on every thread, hierarchical-Z %.3f ms", result.buildings,
+				result.triangles, result.binMilliseconds, result.singleMilliseconds, result.multiMilliseconds, result.hiZMilliseconds);
+			ImGui::Text("  %d of %d props in the frustum, %d occluded (%.1f%%), %.0f ns per test", result.inFrustum, result.objects, result.occluded,
+				result.inFrustum > 0 ? 100.0f * result.occluded / result.inFrustum : 0.0f, result.testNanoseconds);
+		}
+	}
+}
+
+void Application::guiDrawQueue()
+{
+	if (ImGui::CollapsingHeader("Draw Queue", 0))
+	{
+		//The objects and gizmos are drawn from sorted packets, binding only the state that changed since the last draw
+		ImGui::Checkbox("Toggle Draw Sorting", &sortDraws);
+
+		const StateCache::Counters& counters = drawState.getCounters();
+		ImGui::Text("%d draws, %d binds, %d skipped", counters.draws, drawState.getBinds(), counters.skippedBinds);
+		ImGui::Text("Shaders %d, materials %d, meshes %d", counters.shaderBinds, counters.materialBinds, counters.meshBinds);
+
+		//Random packets over 64 shaders, 256 materials and 128 meshes, bound in submission order then in key order
+		if (ImGui::Button("Benchmark Draw Sorting"))
+		{
+			drawQueueBenchmarks[0] = DrawQueue::benchmark(10000, 64, 256, 128, 20);
+			drawQueueBenchmarks[1] = DrawQueue::benchmark(1000000, 64, 256, 128, 5);
+		}
+
+		for (const DrawQueue::BenchmarkResult& result : drawQueueBenchmarks)
+		{
+			if (result.packets == 0)
+			{
+				continue;
+			}
+
+			ImGui::Text("%d packets: %d binds unsorted, %d sorted", result.packets, result.unsortedBinds, result.sortedBinds);
+			ImGui::Text("  Radix sort %.3f ms, std::sort %.3f ms, %s", result.radixMilliseconds, result.stdSortMilliseconds, result.matches ? "identical" : "different");
+		}
+	}
+}
+
+void Application::guiCommandRecording()
+{
+	if (ImGui::CollapsingHeader("Command Recording", 0))
+	{
+		//Each shadow map and the post processing chain are recorded into a command list on a deferred context, then run in order
+		ImGui::Checkbox("Toggle Command Lists", &recordCommandLists);
+		ImGui::Checkbox("Toggle Multithreaded Recording", &multithreadedRecording);
+
+		if (recordCommandLists)
+		{
+			ImGui::Text("Record %.3f ms, execute %.3f ms", commandRecorder->getRecordMilliseconds(), commandRecorder->getExecuteMilliseconds());
+		}
+	}
+}
+
+void Application::guiJobSystem()
+{
+	if (ImGui::CollapsingHeader("Job System", 0))
+	{
+		//Culling, the scene graph, the occlusion tiles and command recording all run their parallelFor() on these threads
+		ImGui::Text("%d threads, %lld jobs stolen", jobs->getThreadCount(), jobs->getStolenCount());
+
+		//Empty jobs, against the same jobs as std::async tasks
+		if (ImGui::Button("Benchmark Jobs"))
+		{
+			jobBenchmark = JobSystem::benchmark(*jobs, 10000);
+		}
+
+		if (jobBenchmark.jobs > 0)
+		{
+			const JobSystem::BenchmarkResult& result = jobBenchmark;
+			ImGui::Text("%d jobs on %d threads: spawn %.1f ns, %.0f jobs/ms, %.1f%% stolen", result.jobs, result.threads, result.spawnNanoseconds, result.jobsPerMillisecond, result.stolenPercent);
+			ImGui::Text("  Round trip %.2f us, steal %.2f us", result.roundTripMicroseconds, result.stealMicroseconds);
+			ImGui::Text("  std::async: %.1f jobs/ms, round trip %.2f us (%.0fx)", result.asyncJobsPerMillisecond, result.asyncRoundTripMicroseconds,
+				result.asyncJobsPerMillisecond > 0.0f ? result.jobsPerMillisecond / result.asyncJobsPerMillisecond : 0.0f);
+		}
 	}
 }
\ No newline at end of file
@@ -11,7 +11,36 @@
 #include "shader/DepthShader.h"
 #include "shader/BloomExtractShader.h"
 #include "shader/BloomCompositeShader.h"
-#include "shader/BillboardingShader.h"
+#include "shader/GrassShader.h"
+#include "shader/GBufferShader.h"
+#include "shader/DeferredLightingShader.h"
+#include "shader/TessellatedTerrainShader.h"
+#include "shader/ImpostorShader.h"
+#include "ShadowFilter.h"
+#include "MomentShadow.h"
+#include "LightClusterBuffers.h"
+#include "LightSystem.h"
+#include "GBuffer.h"
+#include "GBufferEncoding.h"
+#include "ChunkedTerrain.h"
+#include "TerrainBaker.h"
+#include "TerrainPatchMesh.h"
+#include "TerrainTessellation.h"
+#include "GrassMesh.h"
+#include "GrassScatter.h"
+#include "GrassCells.h"
+#include "GrassWind.h"
+#include "DepthSort.h"
+#include "Impostor.h"
+#include "LodMesh.h"
+#include "MeshSimplifier.h"
+#include "RenderStats.h"
+#include "SceneGraph.h"
+#include "Bvh.h"
+#include "OcclusionCuller.h"
+#include "DrawQueue.h"
+#include "CommandRecorder.h"
+#include "DeferredContexts.h"
 
 class Application : public BaseApplication
 {
@@ -29,28 +58,95 @@ protected:
 	void firstPass();
 	void finalPass();
 
-	void bloomExtract();
-	void bloomComposite();
+	void geometryPass();
+	void deferredLightingPass();
 
-	void horizontalBlur();
-	void verticalBlur();
+	void bloomExtract(ID3D11DeviceContext* context);
+	void bloomComposite(ID3D11DeviceContext* context);
 
+	void horizontalBlur(ID3D11DeviceContext* context);
+	void verticalBlur(ID3D11DeviceContext* context);
+	void postProcess(ID3D11DeviceContext* context);
+
+	void recordPasses();
 	void depthPass();
+	void prepareShadowMaps();
+	void renderShadowMap(int light, ID3D11DeviceContext* context);
+	void updateLightClusters();
+	void updateTerrainLod();
+	void updateTerrainTessellation();
+	void updateGrass();
+	void blurMomentMap(AppLight* light, ID3D11DeviceContext* context);
+	DepthShader* sendShadowCaster(BaseMesh* mesh, ID3D11DeviceContext* context, RenderStats& stats);
+	void benchmarkInstancing();
 
 private:
 	void initShaders(HWND hwnd);
 	void initLightingAndShadows();
 	void initMeshes(int screenWidth, int screenHeight);
 	void initTextures(int screenWidth, int screenHeight);
+	void initScene();
+	void updateObjectBounds();
+	void updateOcclusion();
+	void cullObjects(const XMMATRIX& viewProjection, bool occlusion = false);
 	
+	void renderScene(LightShader* shader, GrassShader* grassShader, TessellatedTerrainShader* terrainShader, ImpostorShader* impostorShader, GrassShader::Transparency grassTransparency);
+	void renderTerrain(LightShader* shader, XMMATRIX worldMatrix, XMMATRIX viewMatrix, XMMATRIX projectionMatrix);
 	void renderLightingGizmos();
+	void scatterGrass();
+	GrassShader::Transparency getGrassTransparency();
+	void bakeImpostors();
+	float getProjectedSize(const XMMATRIX& worldMatrix, const Impostor* impostor);
+	XMFLOAT3 getTerrainCameraPosition();
 
 	void guiGeneral();
 	void guiLighting();
+	void guiClusteredLights();
+	void guiDeferredShading();
 	void guiShadows();
 	void guiPostProcessing();
 	void guiVertexManipulation();
-	void guiBillboarding();
+	void guiGrass();
+	void guiImpostors();
+	void guiLevelsOfDetail();
+	void guiMeshOptimisation();
+	void guiVertexPacking();
+	void guiRenderStats();
+	void guiInstancing();
+	void guiSceneGraph();
+	void guiCulling();
+	void guiDrawQueue();
+	void guiCommandRecording();
+	void guiJobSystem();
+
+	//Objects culled against each pass's frustum
+	enum SceneObject
+	{
+		OBJECT_TEAPOT = 0,
+		OBJECT_CUBE,
+		OBJECT_SPHERE,
+		OBJECT_COUNT
+	};
+
+	//Ids in the draw queue's sort keys, the mesh is the object's own
+	enum DrawPass
+	{
+		DRAW_OPAQUE = 0,
+		DRAW_GIZMOS
+	};
+
+	enum DrawShader
+	{
+		SHADER_LIGHT = 0,		//The light or G-buffer shader the scene is rendered with
+		SHADER_PACKED_LIGHT,
+		SHADER_TEXTURE
+	};
+
+	enum DrawMaterial
+	{
+		MATERIAL_WOOD = 0,
+		MATERIAL_CHECK
+	};
 
 	bool renderShadows = true;
 	bool renderGizmos = false;
@@ -58,26 +154,65 @@ private:
 
 	CubeMesh* cubeMesh = nullptr;
 	OrthoMesh* orthoMesh = nullptr;
+	OrthoMesh* momentOrthoMesh = nullptr;
 	SphereMesh* sphereMesh = nullptr;
 	PlaneMesh* planeMesh = nullptr;
 	AModel* teapotModel = nullptr;
+	LodMesh* teapotLods = nullptr;
+	QuadMesh* impostorQuad = nullptr;
+	Impostor* teapotImpostor = nullptr;
+	ChunkedTerrain* terrain = nullptr;
+	TerrainPatchMesh* terrainPatchMesh = nullptr;
+	GrassMesh* grassMesh = nullptr;
+	GrassCells* grassCells = nullptr;
+	GrassWind* grassWind = nullptr;
 
 	RenderTexture* sceneTexture = nullptr;
 	RenderTexture* bloomExtractTexture = nullptr;
 	RenderTexture* bloomCompositeTexture = nullptr;
 	RenderTexture* horizontalBlurTexture = nullptr;
 	RenderTexture* verticalBlurTexture = nullptr;
+	GBuffer* gBuffer = nullptr;
 
 	AppLight* lights[4] = {nullptr};
+	ShadowFilter* shadowFilter = nullptr;
+
+	int momentMapSize = 512;
+	int momentBlurRadius = 3;
+
+	LightClusters* lightClusters = nullptr;
+	LightClusterBuffers* lightClusterBuffers = nullptr;
+	LightSystem* lightSystem = nullptr;
+	std::vector<unsigned int> visibleLights;
+	bool renderClusteredLights = true;
+	bool multithreadedClusters = true;
+	int clusteredLightCount = 256;
+	float clusterBenchmarks[3][2] = {};	//Build times for 256, 1024 and 4096 lights, single and multithreaded
+
+	bool deferredShading = false;
+	GBufferEncoding::PrecisionResult gBufferPrecision[3] = {};	//8, 10 and 16 bit normals
 
 	LightShader* lightShader = nullptr;
 	TextureShader* textureShader = nullptr;
 	VerticalBlurShader* verticalBlurShader = nullptr;
 	HorizontalBlurShader* horizontalBlurShader = nullptr;
+	VerticalBlurShader* momentVerticalBlurShader = nullptr;	//Clamped, for the moment maps
+	HorizontalBlurShader* momentHorizontalBlurShader = nullptr;
 	DepthShader* depthShader = nullptr;
+	LightShader* packedLightShader = nullptr;
+	DepthShader* packedDepthShader = nullptr;
+	DepthShader* positionDepthShader = nullptr;
+	LightShader* instancedLightShader = nullptr;
 	BloomExtractShader* bloomExtractShader = nullptr;
 	BloomCompositeShader* bloomCompositeShader = nullptr;
-	BillboardingShader* billboardingShader = nullptr;
+	GrassShader* grassShader = nullptr;
+	GBufferShader* gBufferShader = nullptr;
+	GrassShader* gBufferGrassShader = nullptr;
+	DeferredLightingShader* deferredLightingShader = nullptr;
+	TessellatedTerrainShader* tessellatedTerrainShader = nullptr;
+	TessellatedTerrainShader* gBufferTessellatedTerrainShader = nullptr;
+	ImpostorShader* impostorShader = nullptr;
+	ImpostorShader* gBufferImpostorShader = nullptr;
 
 	float sceneWidth = 100.0f;
 	float sceneHeight = 100.0f;
@@ -89,6 +224,106 @@ private:
 	float sceneIntensity = 1.0f;
 	float sceneSaturation = 1.0f;
 
+	bool chunkedTerrain = true;
+	bool terrainNormalMap = true;
+	float terrainPixelError = 2.0f;
+	std::vector<int> terrainChunks;			//Selected for the camera
+	std::vector<int> shadowTerrainChunks;	//Selected for the whole terrain, from the camera's position
+	TerrainQuadtree::BenchmarkResult terrainBenchmarks[2] = {};	//4k and 16k heightmaps
+	TerrainBaker::BenchmarkResult terrainBakeBenchmark = {};
+	TerrainBaker::EditBenchmarkResult terrainEditBenchmark = {};
+	float terrainBrushRadius = 5.0f;
+	float terrainBrushStrength = 0.02f;
+
+	bool tessellatedTerrain = false;
+	float terrainPixelsPerEdge = 16.0f;
+	float terrainMaxTessellation = 16.0f;
+	TerrainTessellation::Settings terrainTessellation = {};
+	Frustum terrainFrustum;	//In terrain space, for the hull shader's patch culling
+	TerrainTessellation::ViewStats tessellationStats = {};	//CPU estimate of the hull shader's output this frame
+	TerrainTessellation::BenchmarkResult tessellationBenchmark = {};
+
+	float grassSpacing = 1.0f;
+	bool poissonGrass = false;
+	float grassScatterMilliseconds = 0.0f;
+	GrassScatter::BenchmarkResult grassBenchmark = {};
+	float grassFadeStart = 20.0f;
+	float grassFadeEnd = 50.0f;
+	bool multithreadedGrass = true;
+	GrassCells::BenchmarkResult grassCullBenchmarks[2] = {};	//1M and 10M blades
+	bool grassWindEnabled = true;
+	float grassWindTime = 0.0f;
+	float grassWindAngle = 0.6f;
+	GrassWind::Settings grassWindSettings = { XMFLOAT2(0.0f, 0.0f), 10.0f, 8.0f, 4.0f, 3.0f, 1.0f };
+	GrassWind::BenchmarkResult grassWindBenchmarks[2] = {};	//1M and 4M blades
+	bool grassAlphaToCoverage = true;
+	bool sortGrass = true;
+	DepthSort::BenchmarkResult grassSortBenchmark = {};
+
+	bool renderImpostors = true;
+	float impostorSwitchPixels = 64.0f;		//Models shorter than this on screen are drawn as impostors
+	int impostorFramesPerSide = 8;
+	int impostorFrameSize = 128;
+	float teapotScreenSize = 0.0f;
+	bool teapotIsImpostor = false;
+
+	bool renderLevelsOfDetail = true;
+	float lodFullDetailPixels = 400.0f;	//Models taller than this on screen are drawn in full
+	float lodHysteresis = 0.15f;
+	MeshSimplifier::BenchmarkResult simplifierBenchmarks[2] = {};	//teapot.obj and ScaleBot.obj
+
+	bool packedVertices = false;
+	const bool compactPackedNormals = false;	//8:8 rather than 16:16 octahedral normals for the teapot, fixed when its buffers are made
+	std::vector<VertexPacker::Report> vertexPackingReports;
+
+	bool positionStreams = true;	//Shadow casters bind only their position and texture coordinate streams
+	RenderStats renderStats;
+
+	CubeMesh* benchmarkCube = nullptr;				//A single quad per face, made with the offscreen target the first time the benchmark runs
+	InstanceBuffer* benchmarkInstances = nullptr;
+	RenderTexture* benchmarkTexture = nullptr;
+	int instancingBenchmarkCubes = 100000;
+	float instancingBenchmark[3] = {};	//Per draw submission, instance upload and instanced submission, in ms
+
+	SceneGraph scene;
+	int floorNode = -1;		//The plane, terrain and grass
+	int teapotNode = -1;
+	int cubeNode = -1;
+	int sphereNode = -1;
+	bool multithreadedScene = true;
+	SceneGraph::BenchmarkResult sceneBenchmark = {};
+
+	Bvh sceneBvh;
+	int objectNodes[OBJECT_COUNT] = {};
+	Bvh::Box objectBounds[OBJECT_COUNT] = {};	//In model space
+	bool objectVisible[OBJECT_COUNT] = {};		//To the current pass
+	std::vector<int> visibleObjects;
+	bool cullSceneObjects = true;
+	Bvh::BenchmarkResult bvhBenchmark = {};
+
+	OcclusionCuller occlusionCuller;
+	bool occlusionCulling = true;
+	bool occlusionActive = false;	//This frame, only while the chunked terrain the occluder is built from is drawn
+	bool multithreadedOcclusion = true;
+	int occluderQuadsPerSide = 32;
+	int terrainOccluderBake = -1;	//The terrain's bake count when its occluder was built
+	std::vector<XMFLOAT3> terrainOccluderVertices;
+	std::vector<unsigned int> terrainOccluderIndices;
+	OcclusionCuller::BenchmarkResult occlusionBenchmarks[2] = {};	//1024 and 4096 buildings
+
+	DrawQueue drawQueue;
+	StateCache drawState;		//Counts the frame's binds
+	bool sortDraws = true;
+	DrawQueue::BenchmarkResult drawQueueBenchmarks[2] = {};	//10k and 1M packets
+
+	DeferredContexts* deferredContexts = nullptr;
+	CommandRecorder* commandRecorder = nullptr;
+	bool recordCommandLists = true;		//The shadow maps and post processing recorded on worker threads rather than drawn in turn
+	bool multithreadedRecording = true;
+	bool shadowObjectVisible[4][OBJECT_COUNT] = {};	//Each shadow map's culling, done before recording
+	RenderStats shadowStats[4];						//Each shadow map's draws, merged into renderStats once recorded
+	JobSystem::BenchmarkResult jobBenchmark = {};
+
 	float amplitude = 10.0f;
 	float renderType = 0.0f;
 };
@@ -0,0 +1,534 @@
+#include "Bvh.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+//A node of the binary tree the four wide nodes are collapsed from, a leaf when it has a count
+struct Bvh::BuildNode
+{
+	Box box;
+	int left;
+	int right;
+	int first;
+	int count;
+};
+
+static Bvh::Box emptyBox()
+{
+	return { XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX), XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX) };
+}
+
+static void growBox(Bvh::Box& box, const Bvh::Box& other)
+{
+	box.minimum = XMFLOAT3(fminf(box.minimum.x, other.minimum.x), fminf(box.minimum.y, other.minimum.y), fminf(box.minimum.z, other.minimum.z));
+	box.maximum = XMFLOAT3(fmaxf(box.maximum.x, other.maximum.x), fmaxf(box.maximum.y, other.maximum.y), fmaxf(box.maximum.z, other.maximum.z));
+}
+
+static float surfaceArea(const Bvh::Box& box)
+{
+	float x = box.maximum.x - box.minimum.x;
+	float y = box.maximum.y - box.minimum.y;
+	float z = box.maximum.z - box.minimum.z;
+
+	return x < 0.0f ? 0.0f : 2.0f * ((x * y) + (y * z) + (z * x));
+}
+
+static inline float getCentre(const Bvh::Box& box, int axis)
+{
+	return 0.5f * ((&box.minimum.x)[axis] + (&box.maximum.x)[axis]);
+}
+
+//Splits the objects from first by the cheapest of the binned surface area splits along the widest axis of their centres, or at the
+//median when the centres are too close to bin. Leaves hold up to MAX_LEAF_SIZE objects, so larger groups are always split.
+int Bvh::buildBinary(const std::vector<Box>& boxes, std::vector<int>& order, int first, int count, std::vector<BuildNode>& buildNodes)
+{
+	int index = (int)buildNodes.size();
+	buildNodes.push_back({ emptyBox(), -1, -1, first, count });
+
+	Box bounds = emptyBox();
+	Box centres = emptyBox();
+
+	for (int i = first; i < first + count; i++)
+	{
+		const Box& box = boxes[order[i]];
+		XMFLOAT3 centre(getCentre(box, 0), getCentre(box, 1), getCentre(box, 2));
+
+		growBox(bounds, box);
+		growBox(centres, { centre, centre });
+	}
+
+	buildNodes[index].box = bounds;
+
+	if (count <= MAX_LEAF_SIZE)
+	{
+		return index;
+	}
+
+	XMFLOAT3 extent(centres.maximum.x - centres.minimum.x, centres.maximum.y - centres.minimum.y, centres.maximum.z - centres.minimum.z);
+	int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+	float axisMinimum = (&centres.minimum.x)[axis];
+	float axisExtent = (&extent.x)[axis];
+	int split = first + (count / 2);
+
+	if (axisExtent > 0.0f)
+	{
+		float binScale = (float)SAH_BINS / axisExtent;
+		int binCounts[SAH_BINS] = {};
+		Box binBoxes[SAH_BINS];
+
+		for (int bin = 0; bin < SAH_BINS; bin++)
+		{
+			binBoxes[bin] = emptyBox();
+		}
+
+		auto getBin = [&](int object)
+		{
+			int bin = (int)((getCentre(boxes[object], axis) - axisMinimum) * binScale);
+			return bin < SAH_BINS - 1 ? bin : SAH_BINS - 1;
+		};
+
+		for (int i = first; i < first + count; i++)
+		{
+			int bin = getBin(order[i]);
+			binCounts[bin]++;
+			growBox(binBoxes[bin], boxes[order[i]]);
+		}
+
+		//Costs of splitting after each bin, the area of each side weighted by its objects
+		float rightAreas[SAH_BINS];
+		int rightCounts[SAH_BINS];
+		Box right = emptyBox();
+		int rightCount = 0;
+
+		for (int bin = SAH_BINS - 1; bin > 0; bin--)
+		{
+			growBox(right, binBoxes[bin]);
+			rightCount += binCounts[bin];
+			rightAreas[bin] = surfaceArea(right);
+			rightCounts[bin] = rightCount;
+		}
+
+		Box left = emptyBox();
+		int leftCount = 0;
+		float bestCost = FLT_MAX;
+		int bestBin = -1;
+
+		for (int bin = 0; bin < SAH_BINS - 1; bin++)
+		{
+			growBox(left, binBoxes[bin]);
+			leftCount += binCounts[bin];
+
+			if (leftCount == 0 || rightCounts[bin + 1] == 0)
+			{
+				continue;
+			}
+
+			float cost = (surfaceArea(left) * (float)leftCount) + (rightAreas[bin + 1] * (float)rightCounts[bin + 1]);
+
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestBin = bin;
+			}
+		}
+
+		if (bestBin >= 0)
+		{
+			split = (int)(std::partition(order.begin() + first, order.begin() + first + count, [&](int object) { return getBin(object) <= bestBin; }) - order.begin());
+		}
+	}
+
+	if (split == first || split == first + count || axisExtent <= 0.0f)
+	{
+		split = first + (count / 2);
+		std::nth_element(order.begin() + first, order.begin() + split, order.begin() + first + count,
+			[&](int a, int b) { return getCentre(boxes[a], axis) < getCentre(boxes[b], axis); });
+	}
+
+	int leftNode = buildBinary(boxes, order, first, split - first, buildNodes);
+	int rightNode = buildBinary(boxes, order, split, first + count - split, buildNodes);
+	buildNodes[index].left = leftNode;
+	buildNodes[index].right = rightNode;
+	buildNodes[index].count = 0;
+
+	return index;
+}
+
+Bvh::Bvh() : needsRefit(false)
+{
+
+}
+
+Bvh::~Bvh()
+{
+
+}
+
+void Bvh::build(const std::vector<Box>& boxes)
+{
+	nodes.clear();
+	leafObjects.resize(boxes.size());
+
+	for (int i = 0; i < (int)boxes.size(); i++)
+	{
+		leafObjects[i] = i;
+	}
+
+	if (!boxes.empty())
+	{
+		std::vector<BuildNode> buildNodes;
+		buildNodes.reserve(boxes.size());
+		buildBinary(boxes, leafObjects, 0, (int)boxes.size(), buildNodes);
+		collapse(buildNodes, 0);
+	}
+
+	//The leaves' objects are contiguous in the order the build left them
+	leafBoxes.resize(boxes.size());
+	objectSlots.resize(boxes.size());
+
+	for (int slot = 0; slot < (int)leafObjects.size(); slot++)
+	{
+		leafBoxes[slot] = boxes[leafObjects[slot]];
+		objectSlots[leafObjects[slot]] = slot;
+	}
+
+	needsRefit = false;
+}
+
+//Opens the largest of the node's binary descendants until it has four children or only leaves are left
+int Bvh::collapse(const std::vector<BuildNode>& buildNodes, int buildNode)
+{
+	int index = (int)nodes.size();
+	Node node;
+
+	for (int lane = 0; lane < 4; lane++)
+	{
+		node.children[lane] = -1;
+		node.counts[lane] = 0;
+		setChildBox(node, lane, emptyBox());
+	}
+
+	nodes.push_back(node);
+
+	int lanes[4] = { buildNode, -1, -1, -1 };
+	int laneCount = 1;
+
+	while (laneCount < 4)
+	{
+		int largest = -1;
+		float largestArea = -1.0f;
+
+		for (int lane = 0; lane < laneCount; lane++)
+		{
+			const BuildNode& child = buildNodes[lanes[lane]];
+			float area = surfaceArea(child.box);
+
+			if (child.count == 0 && area > largestArea)
+			{
+				largest = lane;
+				largestArea = area;
+			}
+		}
+
+		if (largest < 0)
+		{
+			break;
+		}
+
+		const BuildNode& opened = buildNodes[lanes[largest]];
+		lanes[largest] = opened.left;
+		lanes[laneCount++] = opened.right;
+	}
+
+	for (int lane = 0; lane < laneCount; lane++)
+	{
+		const BuildNode& child = buildNodes[lanes[lane]];
+		int childIndex = child.count > 0 ? child.first : collapse(buildNodes, lanes[lane]);
+
+		nodes[index].children[lane] = childIndex;
+		nodes[index].counts[lane] = child.count;
+		setChildBox(nodes[index], lane, child.box);
+	}
+
+	return index;
+}
+
+void Bvh::setChildBox(Node& node, int lane, const Box& box)
+{
+	(&node.minX.x)[lane] = box.minimum.x;
+	(&node.minY.x)[lane] = box.minimum.y;
+	(&node.minZ.x)[lane] = box.minimum.z;
+	(&node.maxX.x)[lane] = box.maximum.x;
+	(&node.maxY.x)[lane] = box.maximum.y;
+	(&node.maxZ.x)[lane] = box.maximum.z;
+}
+
+Bvh::Box Bvh::getNodeBox(const Node& node) const
+{
+	Box box = emptyBox();
+
+	for (int lane = 0; lane < 4; lane++)
+	{
+		if (node.children[lane] >= 0)
+		{
+			growBox(box, { XMFLOAT3((&node.minX.x)[lane], (&node.minY.x)[lane], (&node.minZ.x)[lane]),
+				XMFLOAT3((&node.maxX.x)[lane], (&node.maxY.x)[lane], (&node.maxZ.x)[lane]) });
+		}
+	}
+
+	return box;
+}
+
+void Bvh::setBox(int object, const Box& box)
+{
+	leafBoxes[objectSlots[object]] = box;
+	needsRefit = true;
+}
+
+//Children are stored after their parents, so walking the nodes backwards finishes every child before its parent
+void Bvh::refit()
+{
+	if (!needsRefit)
+	{
+		return;
+	}
+
+	for (int index = (int)nodes.size() - 1; index >= 0; index--)
+	{
+		Node& node = nodes[index];
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			if (node.children[lane] < 0)
+			{
+				continue;
+			}
+
+			Box box = emptyBox();
+
+			if (node.counts[lane] > 0)
+			{
+				for (int slot = node.children[lane]; slot < node.children[lane] + node.counts[lane]; slot++)
+				{
+					growBox(box, leafBoxes[slot]);
+				}
+			}
+
+			else
+			{
+				box = getNodeBox(nodes[node.children[lane]]);
+			}
+
+			setChildBox(node, lane, box);
+		}
+	}
+
+	needsRefit = false;
+}
+
+//Children wholly inside the frustum are taken without testing anything below them
+Bvh::QueryStats Bvh::query(const Frustum& frustum, std::vector<int>& visible) const
+{
+	QueryStats stats = { 0, 0, 0 };
+	visible.clear();
+
+	if (nodes.empty())
+	{
+		return stats;
+	}
+
+	std::vector<std::pair<int, bool>> stack;
+	stack.push_back({ 0, false });
+
+	while (!stack.empty())
+	{
+		int index = stack.back().first;
+		bool inside = stack.back().second;
+		stack.pop_back();
+
+		const Node& node = nodes[index];
+		uint32_t visibleLanes[4] = { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF };
+		uint32_t insideLanes[4] = { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF };
+		stats.nodesVisited++;
+
+		if (!inside)
+		{
+			XMVECTOR insideMask;
+			XMStoreInt4(visibleLanes, frustum.boxesVisible(XMLoadFloat4(&node.minX), XMLoadFloat4(&node.minY), XMLoadFloat4(&node.minZ),
+				XMLoadFloat4(&node.maxX), XMLoadFloat4(&node.maxY), XMLoadFloat4(&node.maxZ), &insideMask));
+			XMStoreInt4(insideLanes, insideMask);
+		}
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			if (node.children[lane] < 0 || !visibleLanes[lane])
+			{
+				continue;
+			}
+
+			if (node.counts[lane] == 0)
+			{
+				stack.push_back({ node.children[lane], insideLanes[lane] != 0 });
+				continue;
+			}
+
+			int first = node.children[lane];
+			int count = node.counts[lane];
+
+			if (insideLanes[lane])
+			{
+				visible.insert(visible.end(), leafObjects.begin() + first, leafObjects.begin() + first + count);
+				continue;
+			}
+
+			//The leaf's objects together, lanes past its count repeat the first and are ignored
+			const Box* boxes[4];
+
+			for (int i = 0; i < 4; i++)
+			{
+				boxes[i] = &leafBoxes[first + (i < count ? i : 0)];
+			}
+
+			uint32_t objectLanes[4];
+			XMStoreInt4(objectLanes, frustum.boxesVisible(
+				XMVectorSet(boxes[0]->minimum.x, boxes[1]->minimum.x, boxes[2]->minimum.x, boxes[3]->minimum.x),
+				XMVectorSet(boxes[0]->minimum.y, boxes[1]->minimum.y, boxes[2]->minimum.y, boxes[3]->minimum.y),
+				XMVectorSet(boxes[0]->minimum.z, boxes[1]->minimum.z, boxes[2]->minimum.z, boxes[3]->minimum.z),
+				XMVectorSet(boxes[0]->maximum.x, boxes[1]->maximum.x, boxes[2]->maximum.x, boxes[3]->maximum.x),
+				XMVectorSet(boxes[0]->maximum.y, boxes[1]->maximum.y, boxes[2]->maximum.y, boxes[3]->maximum.y),
+				XMVectorSet(boxes[0]->maximum.z, boxes[1]->maximum.z, boxes[2]->maximum.z, boxes[3]->maximum.z)));
+
+			for (int i = 0; i < count; i++)
+			{
+				if (objectLanes[i])
+				{
+					visible.push_back(leafObjects[first + i]);
+				}
+			}
+		}
+	}
+
+	stats.visible = (int)visible.size();
+	stats.culled = getObjectCount() - stats.visible;
+
+	return stats;
+}
+
+//The box's centre is transformed and its half extents are carried along each axis by the absolute values of the matrix
+Bvh::Box Bvh::transformBox(const Box& box, const XMMATRIX& matrix)
+{
+	XMFLOAT4X4 m;
+	XMStoreFloat4x4(&m, matrix);
+
+	float centre[3] = { getCentre(box, 0), getCentre(box, 1), getCentre(box, 2) };
+	float extent[3] = { 0.5f * (box.maximum.x - box.minimum.x), 0.5f * (box.maximum.y - box.minimum.y), 0.5f * (box.maximum.z - box.minimum.z) };
+	float newCentre[3];
+	float newExtent[3];
+
+	for (int column = 0; column < 3; column++)
+	{
+		newCentre[column] = m.m[3][column];
+		newExtent[column] = 0.0f;
+
+		for (int row = 0; row < 3; row++)
+		{
+			newCentre[column] += centre[row] * m.m[row][column];
+			newExtent[column] += extent[row] * fabsf(m.m[row][column]);
+		}
+	}
+
+	return { XMFLOAT3(newCentre[0] - newExtent[0], newCentre[1] - newExtent[1], newCentre[2] - newExtent[2]),
+		XMFLOAT3(newCentre[0] + newExtent[0], newCentre[1] + newExtent[1], newCentre[2] + newExtent[2]) };
+}
+
+Bvh::BenchmarkResult Bvh::benchmark(int objects, int iterations)
+{
+	BenchmarkResult result = { objects, 0, 0, 0.0f, 0.0f, 0.0f, 0.0f, true };
+
+	if (objects <= 0 || iterations <= 0)
+	{
+		return result;
+	}
+
+	//Boxes from half a unit to five units across, scattered through a cube a thousand units across around the camera
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+	std::uniform_real_distribution<float> size(0.25f, 2.5f);
+	std::uniform_real_distribution<float> jitter(-1.0f, 1.0f);
+	std::vector<Box> boxes(objects);
+
+	for (Box& box : boxes)
+	{
+		XMFLOAT3 centre(position(random), position(random), position(random));
+		XMFLOAT3 half(size(random), size(random), size(random));
+		box = { XMFLOAT3(centre.x - half.x, centre.y - half.y, centre.z - half.z), XMFLOAT3(centre.x + half.x, centre.y + half.y, centre.z + half.z) };
+	}
+
+	Bvh bvh;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	bvh.build(boxes);
+	auto end = std::chrono::high_resolution_clock::now();
+	result.buildMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+	result.nodes = bvh.getNodeCount();
+
+	//A 60 degree view from the centre along z, reaching the cube's far side
+	XMMATRIX view = XMMatrixLookToLH(XMVectorZero(), XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+	XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PI / 3.0f, 16.0f / 9.0f, 0.1f, 500.0f);
+	Frustum frustum(view * projection);
+	std::vector<int> visible, expected;
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		//The second pass moves every box and refits before querying again
+		if (pass == 1)
+		{
+			for (int i = 0; i < objects; i++)
+			{
+				XMFLOAT3 offset(jitter(random), jitter(random), jitter(random));
+				boxes[i].minimum = XMFLOAT3(boxes[i].minimum.x + offset.x, boxes[i].minimum.y + offset.y, boxes[i].minimum.z + offset.z);
+				boxes[i].maximum = XMFLOAT3(boxes[i].maximum.x + offset.x, boxes[i].maximum.y + offset.y, boxes[i].maximum.z + offset.z);
+				bvh.setBox(i, boxes[i]);
+			}
+
+			start = std::chrono::high_resolution_clock::now();
+			bvh.refit();
+			end = std::chrono::high_resolution_clock::now();
+			result.refitMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+		}
+
+		for (int iteration = 0; iteration < iterations; iteration++)
+		{
+			start = std::chrono::high_resolution_clock::now();
+			bvh.query(frustum, visible);
+			end = std::chrono::high_resolution_clock::now();
+			result.queryMilliseconds += std::chrono::duration<float, std::milli>(end - start).count();
+
+			start = std::chrono::high_resolution_clock::now();
+			expected.clear();
+
+			for (int i = 0; i < objects; i++)
+			{
+				if (frustum.boxVisible(boxes[i].minimum, boxes[i].maximum))
+				{
+					expected.push_back(i);
+				}
+			}
+
+			end = std::chrono::high_resolution_clock::now();
+			result.bruteForceMilliseconds += std::chrono::duration<float, std::milli>(end - start).count();
+		}
+
+		std::sort(visible.begin(), visible.end());
+		result.matches = result.matches && visible == expected;
+		result.visible = (int)visible.size();
+	}
+
+	result.queryMilliseconds /= (float)(iterations * 2);
+	result.bruteForceMilliseconds /= (float)(iterations * 2);
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+
+#include "Frustum.h"
+
+using namespace DirectX;
+
+//Bounding volume hierarchy over objects' world space boxes, for culling them against a frustum. A binary tree is built by the surface
+//area heuristic over binned centroids, then collapsed into nodes of four children whose boxes are stored as structure of arrays, so
+//a node's children are tested against the frustum together. Moving objects only refits the boxes, the tree is kept until rebuilt.
+class Bvh
+{
+public:
+	struct Box
+	{
+		XMFLOAT3 minimum;
+		XMFLOAT3 maximum;
+	};
+
+	struct QueryStats
+	{
+		int visible;
+		int culled;
+		int nodesVisited;
+	};
+
+	struct BenchmarkResult
+	{
+		int objects;
+		int nodes;
+		int visible;					//Objects in the benchmark's frustum
+		float buildMilliseconds;
+		float refitMilliseconds;		//After moving every object
+		float queryMilliseconds;
+		float bruteForceMilliseconds;	//Testing every object's box in turn
+		bool matches;					//The queries found the same objects as the brute force tests, before and after the refit
+	};
+
+	Bvh();
+	~Bvh();
+
+	//Rebuilds the tree over the boxes, an object's index is its place in the list
+	void build(const std::vector<Box>& boxes);
+
+	//Moves an object's box, the nodes above it are only updated by refit()
+	void setBox(int object, const Box& box);
+	void refit();
+
+	//Fills visible with the objects whose boxes touch the frustum, in tree order
+	QueryStats query(const Frustum& frustum, std::vector<int>& visible) const;
+
+	//Times building, refitting and querying the given number of random boxes
+	static BenchmarkResult benchmark(int objects, int iterations);
+
+	//Box around a box transformed by the matrix
+	static Box transformBox(const Box& box, const XMMATRIX& matrix);
+
+	inline const Box& getBox(int object) const { return leafBoxes[objectSlots[object]]; }
+	inline int getObjectCount() const { return (int)objectSlots.size(); }
+	inline int getNodeCount() const { return (int)nodes.size(); }
+
+	static const int MAX_LEAF_SIZE = 4;		//Objects in a leaf, tested together like a node's children
+	static const int SAH_BINS = 16;
+
+private:
+	//Four children's boxes, a child with a count is a leaf of that many objects from first in leafBoxes, otherwise a node or -1
+	struct Node
+	{
+		XMFLOAT4 minX, minY, minZ;
+		XMFLOAT4 maxX, maxY, maxZ;
+		int children[4];
+		int counts[4];
+	};
+
+	struct BuildNode;
+
+	static int buildBinary(const std::vector<Box>& boxes, std::vector<int>& order, int first, int count, std::vector<BuildNode>& buildNodes);
+	int collapse(const std::vector<BuildNode>& buildNodes, int buildNode);
+	void setChildBox(Node& node, int lane, const Box& box);
+	Box getNodeBox(const Node& node) const;
+
+	std::vector<Node> nodes;			//Parents before their children, the root first
+	std::vector<Box> leafBoxes;			//Objects' boxes in leaf order
+	std::vector<int> leafObjects;		//The object in each leaf slot
+	std::vector<int> objectSlots;		//Each object's leaf slot
+	bool needsRefit;
+};
\ No newline at end of file
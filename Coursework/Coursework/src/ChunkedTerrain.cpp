@@ -0,0 +1,388 @@
+#include "ChunkedTerrain.h"
+#include "TerrainBaker.h"
+#include "ParallelFor.h"
+
+#include <chrono>
+#include <cmath>
+
+ChunkedTerrain::ChunkedTerrain() : normalMap(nullptr), normalMapView(nullptr), bakedAmplitude(0.0f), bakeMilliseconds(0.0f), lastDirtyTiles(0), lastRebakedChunks(0), bakeCount(0)
+{
+
+}
+
+ChunkedTerrain::~ChunkedTerrain()
+{
+	releaseMeshes();
+}
+
+void ChunkedTerrain::releaseMeshes()
+{
+	for (TerrainChunkMesh* mesh : meshes)
+	{
+		delete mesh;
+	}
+
+	meshes.clear();
+
+	if (normalMapView)
+	{
+		normalMapView->Release();
+		normalMapView = nullptr;
+	}
+
+	if (normalMap)
+	{
+		normalMap->Release();
+		normalMap = nullptr;
+	}
+}
+
+bool ChunkedTerrain::createNormalMap(ID3D11Device* device)
+{
+	D3D11_TEXTURE2D_DESC textureDesc;
+	D3D11_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc;
+	D3D11_SUBRESOURCE_DATA textureData;
+
+	ZeroMemory(&textureDesc, sizeof(textureDesc));
+	textureDesc.Width = heights.getWidth();
+	textureDesc.Height = heights.getHeight();
+	textureDesc.MipLevels = 1;
+	textureDesc.ArraySize = 1;
+	textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.Usage = D3D11_USAGE_DEFAULT;
+	textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	textureDesc.CPUAccessFlags = 0;
+	textureDesc.MiscFlags = 0;
+
+	textureData.pSysMem = normalMapTexels.data();
+	textureData.SysMemPitch = heights.getWidth() * sizeof(uint32_t);
+	textureData.SysMemSlicePitch = 0;
+
+	if (FAILED(device->CreateTexture2D(&textureDesc, &textureData, &normalMap)))
+	{
+		return false;
+	}
+
+	shaderResourceViewDesc.Format = textureDesc.Format;
+	shaderResourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+	shaderResourceViewDesc.Texture2D.MostDetailedMip = 0;
+	shaderResourceViewDesc.Texture2D.MipLevels = 1;
+
+	return SUCCEEDED(device->CreateShaderResourceView(normalMap, &shaderResourceViewDesc, &normalMapView));
+}
+
+bool ChunkedTerrain::readHeightField(ID3D11Device* device, ID3D11DeviceContext* deviceContext, ID3D11ShaderResourceView* heightMap, HeightField& heights)
+{
+	ID3D11Resource* resource = nullptr;
+	ID3D11Texture2D* texture = nullptr;
+	ID3D11Texture2D* stagingTexture = nullptr;
+	D3D11_TEXTURE2D_DESC textureDesc;
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+
+	if (!heightMap)
+	{
+		return false;
+	}
+
+	heightMap->GetResource(&resource);
+	HRESULT result = resource->QueryInterface(__uuidof(ID3D11Texture2D), (void**)&texture);
+	resource->Release();
+
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//A CPU readable copy of the top mip
+	texture->GetDesc(&textureDesc);
+	textureDesc.MipLevels = 1;
+	textureDesc.ArraySize = 1;
+	textureDesc.Usage = D3D11_USAGE_STAGING;
+	textureDesc.BindFlags = 0;
+	textureDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+	textureDesc.MiscFlags = 0;
+
+	result = device->CreateTexture2D(&textureDesc, NULL, &stagingTexture);
+
+	if (FAILED(result))
+	{
+		texture->Release();
+		return false;
+	}
+
+	deviceContext->CopySubresourceRegion(stagingTexture, 0, 0, 0, 0, texture, 0, NULL);
+	texture->Release();
+
+	result = deviceContext->Map(stagingTexture, 0, D3D11_MAP_READ, 0, &mappedResource);
+
+	if (FAILED(result))
+	{
+		stagingTexture->Release();
+		return false;
+	}
+
+	bool supported = true;
+	heights.resize((int)textureDesc.Width, (int)textureDesc.Height);
+
+	for (int y = 0; y < (int)textureDesc.Height && supported; y++)
+	{
+		const unsigned char* row = (const unsigned char*)mappedResource.pData + ((size_t)y * mappedResource.RowPitch);
+
+		for (int x = 0; x < (int)textureDesc.Width; x++)
+		{
+			float value = 0.0f;
+
+			//The shaders only read the red channel
+			switch (textureDesc.Format)
+			{
+			case DXGI_FORMAT_R8G8B8A8_UNORM:
+			case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+				value = (float)row[x * 4] / 255.0f;
+				break;
+			case DXGI_FORMAT_B8G8R8A8_UNORM:
+			case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+				value = (float)row[(x * 4) + 2] / 255.0f;
+				break;
+			case DXGI_FORMAT_R8_UNORM:
+				value = (float)row[x] / 255.0f;
+				break;
+			case DXGI_FORMAT_R16_UNORM:
+				value = (float)((const unsigned short*)row)[x] / 65535.0f;
+				break;
+			case DXGI_FORMAT_R16G16B16A16_UNORM:
+				value = (float)((const unsigned short*)row)[x * 4] / 65535.0f;
+				break;
+			case DXGI_FORMAT_R32_FLOAT:
+				value = ((const float*)row)[x];
+				break;
+			default:
+				supported = false;
+				break;
+			}
+
+			heights.setSample(x, y, value);
+		}
+	}
+
+	deviceContext->Unmap(stagingTexture, 0);
+	stagingTexture->Release();
+
+	return supported;
+}
+
+bool ChunkedTerrain::load(ID3D11Device* device, ID3D11DeviceContext* deviceContext, ID3D11ShaderResourceView* heightMap, float amplitude, int gridSize, int chunkSize, float worldSize)
+{
+	releaseMeshes();
+
+	if (!readHeightField(device, deviceContext, heightMap, heights))
+	{
+		return false;
+	}
+
+	quadtree.build(heights, gridSize, chunkSize, worldSize);
+
+	//Skirts deep enough to cover the largest gap the coarsest patch can leave against a finer neighbour
+	float skirtDepth = quadtree.getNode(0).error + (1.0f / 64.0f);
+
+	meshes.resize(quadtree.getNodes().size());
+
+	for (int i = 0; i < (int)meshes.size(); i++)
+	{
+		meshes[i] = new TerrainChunkMesh(device, quadtree, heights, i, skirtDepth, amplitude);
+	}
+
+	normalMapTexels.resize((size_t)heights.getWidth() * heights.getHeight());
+	TerrainBaker::bakeNormalMap(heights, amplitude, worldSize / (float)heights.getWidth(), normalMapTexels.data());
+	bakedAmplitude = amplitude;
+
+	dirtyTiles.resize(heights.getWidth(), heights.getHeight(), 32);
+
+	return createNormalMap(device);
+}
+
+void ChunkedTerrain::update(ID3D11DeviceContext* deviceContext, float amplitude, bool multithreaded)
+{
+	if (amplitude == bakedAmplitude && !dirtyTiles.hasDirtyTiles())
+	{
+		return;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	if (amplitude != bakedAmplitude)
+	{
+		rescale(deviceContext, amplitude, multithreaded);
+	}
+
+	if (dirtyTiles.hasDirtyTiles())
+	{
+		rebakeDirtyTiles(deviceContext, multithreaded);
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	bakeMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+	bakeCount++;
+}
+
+void ChunkedTerrain::rescale(ID3D11DeviceContext* deviceContext, float amplitude, bool multithreaded)
+{
+	float scale = amplitude / bakedAmplitude;
+
+	auto rescaleMeshes = [&](int begin, int end)
+	{
+		for (int i = begin; i < end; i++)
+		{
+			meshes[i]->rescale(scale);
+		}
+	};
+
+	if (multithreaded)
+	{
+		parallelFor((int)meshes.size(), rescaleMeshes, 4);
+	}
+
+	else
+	{
+		rescaleMeshes(0, (int)meshes.size());
+	}
+
+	//Rescaling eight bit normals would build up their rounding error with every change, so the normal map is baked from the heights
+	TerrainBaker::bakeNormalMap(heights, amplitude, quadtree.getWorldSize() / (float)heights.getWidth(), normalMapTexels.data(), true, multithreaded);
+
+	//The device context isn't free threaded, so the uploads happen once every chunk has finished
+	for (TerrainChunkMesh* mesh : meshes)
+	{
+		mesh->upload(deviceContext);
+	}
+
+	deviceContext->UpdateSubresource(normalMap, 0, NULL, normalMapTexels.data(), heights.getWidth() * sizeof(uint32_t), 0);
+	bakedAmplitude = amplitude;
+}
+
+void ChunkedTerrain::rebakeDirtyTiles(ID3D11DeviceContext* deviceContext, bool multithreaded)
+{
+	std::vector<int> tiles;
+	dirtyTiles.getDirtyTiles(tiles);
+
+	float cellSize = quadtree.getWorldSize() / (float)heights.getWidth();
+
+	for (int tile : tiles)
+	{
+		int x0, y0, x1, y1;
+		dirtyTiles.getTileRect(tile, x0, y0, x1, y1);
+		TerrainBaker::bakeNormalMapRegion(heights, bakedAmplitude, cellSize, normalMapTexels.data(), x0, y0, x1, y1, true, false);
+
+		D3D11_BOX box = { (UINT)x0, (UINT)y0, 0, (UINT)x1, (UINT)y1, 1 };
+		deviceContext->UpdateSubresource(normalMap, 0, &box, &normalMapTexels[((size_t)y0 * heights.getWidth()) + x0], heights.getWidth() * sizeof(uint32_t), 0);
+	}
+
+	//Edited texels to the grid corners that sample them, a corner reads the texels either side of it
+	int x0, y0, x1, y1;
+	dirtyTiles.getDirtyBounds(x0, y0, x1, y1);
+
+	float texelsToGrid = (float)quadtree.getGridSize() / (float)heights.getWidth();
+	int gridX0 = (int)floorf((float)x0 * texelsToGrid) - 1;
+	int gridZ0 = (int)floorf((float)y0 * texelsToGrid) - 1;
+	int gridX1 = (int)ceilf((float)(x1 + 1) * texelsToGrid) + 1;
+	int gridZ1 = (int)ceilf((float)(y1 + 1) * texelsToGrid) + 1;
+
+	quadtree.refit(heights, gridX0, gridZ0, gridX1, gridZ1);
+
+	std::vector<TerrainChunkMesh*> dirtyMeshes;
+
+	for (TerrainChunkMesh* mesh : meshes)
+	{
+		if (mesh->overlaps(gridX0, gridZ0, gridX1, gridZ1))
+		{
+			dirtyMeshes.push_back(mesh);
+		}
+	}
+
+	auto bakeMeshes = [&](int begin, int end)
+	{
+		for (int i = begin; i < end; i++)
+		{
+			dirtyMeshes[i]->bake(bakedAmplitude);
+		}
+	};
+
+	if (multithreaded)
+	{
+		parallelFor((int)dirtyMeshes.size(), bakeMeshes, 2);
+	}
+
+	else
+	{
+		bakeMeshes(0, (int)dirtyMeshes.size());
+	}
+
+	for (TerrainChunkMesh* mesh : dirtyMeshes)
+	{
+		mesh->upload(deviceContext);
+	}
+
+	lastDirtyTiles = (int)tiles.size();
+	lastRebakedChunks = (int)dirtyMeshes.size();
+	dirtyTiles.clear();
+}
+
+void ChunkedTerrain::applyBrush(float x, float z, float radius, float amount)
+{
+	//Terrain space to texels, with texel centres at (i + 0.5) / width of the way across
+	float worldToTexels = (float)heights.getWidth() / quadtree.getWorldSize();
+	int centreX = (int)floorf(x * worldToTexels);
+	int centreY = (int)floorf(z * worldToTexels);
+	int texelRadius = (int)ceilf(radius * worldToTexels);
+
+	heights.applyBrush(centreX, centreY, texelRadius, amount);
+
+	//Normals read the texels either side of them, so the edit reaches one texel past the brush
+	dirtyTiles.markDirty(centreX - texelRadius - 1, centreY - texelRadius - 1, centreX + texelRadius + 1, centreY + texelRadius + 1);
+}
+
+void ChunkedTerrain::buildOccluder(int quadsPerSide, float amplitude, std::vector<XMFLOAT3>& vertices, std::vector<unsigned int>& indices) const
+{
+	int gridSize = quadtree.getGridSize();
+	int step = gridSize / quadsPerSide;
+	int side = quadsPerSide + 1;
+	float cellSize = quadtree.getWorldSize() / (float)gridSize;
+
+	vertices.resize(side * side);
+	indices.clear();
+
+	for (int j = 0; j < side; j++)
+	{
+		for (int i = 0; i < side; i++)
+		{
+			int x = i * step;
+			int z = j * step;
+			float lowest = 1.0f;
+
+			//The full resolution surface is linear between grid corners, so its lowest corner bounds it from below
+			for (int cz = z - step; cz <= z + step; cz++)
+			{
+				for (int cx = x - step; cx <= x + step; cx++)
+				{
+					if (cx >= 0 && cz >= 0 && cx <= gridSize && cz <= gridSize)
+					{
+						float height = quadtree.getGridHeight(heights, cx, cz);
+						lowest = height < lowest ? height : lowest;
+					}
+				}
+			}
+
+			vertices[(j * side) + i] = XMFLOAT3((float)x * cellSize, lowest * amplitude, (float)z * cellSize);
+		}
+	}
+
+	for (int j = 0; j < quadsPerSide; j++)
+	{
+		for (int i = 0; i < quadsPerSide; i++)
+		{
+			unsigned int corner = (j * side) + i;
+
+			indices.insert(indices.end(), { corner, corner + side, corner + 1, corner + 1, corner + side, corner + side + 1 });
+		}
+	}
+}
\ No newline at end of file
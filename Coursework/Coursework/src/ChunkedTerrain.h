@@ -0,0 +1,69 @@
+#pragma once
+
+#include "DXF.h"
+#include "HeightField.h"
+#include "TerrainQuadtree.h"
+#include "TerrainChunkMesh.h"
+#include "DirtyTileTracker.h"
+
+using namespace DirectX;
+
+//CPU side terrain, a copy of the heightmap with a LOD quadtree over it and one chunk mesh for every node.
+//Only the chunks picked by the quadtree are drawn, instead of the whole full resolution plane. Positions and normals
+//are baked for the current amplitude, with a normal map at the heightmap's resolution for per pixel lighting. Both are
+//cached - an amplitude change rescales them in place and a height edit only re-bakes the tiles and chunks it touched.
+class ChunkedTerrain
+{
+public:
+	ChunkedTerrain();
+	~ChunkedTerrain();
+
+	//Reads the heightmap back from the GPU and builds the tree and chunk meshes. The grid size must be the chunk size
+	//multiplied by a power of two.
+	bool load(ID3D11Device* device, ID3D11DeviceContext* deviceContext, ID3D11ShaderResourceView* heightMap, float amplitude, int gridSize = 256, int chunkSize = 32, float worldSize = 100.0f);
+
+	//Brings the baked data up to date with the amplitude and any height edits, doing nothing if neither has changed
+	void update(ID3D11DeviceContext* deviceContext, float amplitude, bool multithreaded = true);
+
+	//Raises the heights within a radius of a terrain space point, the affected tiles are re-baked by the next update()
+	void applyBrush(float x, float z, float radius, float amount);
+
+	//A coarse grid of quadsPerSide quads for occlusion culling, kept under the full resolution surface by giving every corner the lowest
+	//height of the cells around it. Positions are in terrain space, as the chunks'.
+	void buildOccluder(int quadsPerSide, float amplitude, std::vector<XMFLOAT3>& vertices, std::vector<unsigned int>& indices) const;
+
+	//Copies the first mip of a heightmap texture's red channel into a height field
+	static bool readHeightField(ID3D11Device* device, ID3D11DeviceContext* deviceContext, ID3D11ShaderResourceView* heightMap, HeightField& heights);
+
+	inline void select(const TerrainQuadtree::SelectionParams& params, const Frustum* frustum, std::vector<int>& selected) const { quadtree.select(params, frustum, selected); }
+
+	inline TerrainChunkMesh* getMesh(int node) const { return meshes[node]; }
+	inline const TerrainQuadtree& getQuadtree() const { return quadtree; }
+	inline const HeightField& getHeightField() const { return heights; }
+	inline ID3D11ShaderResourceView* getNormalMap() const { return normalMapView; }
+	inline float getBakedAmplitude() const { return bakedAmplitude; }
+	inline float getBakeMilliseconds() const { return bakeMilliseconds; }
+	inline int getLastDirtyTiles() const { return lastDirtyTiles; }
+	inline int getLastRebakedChunks() const { return lastRebakedChunks; }
+	inline int getBakeCount() const { return bakeCount; }	//Updates that changed the baked data, for anything built from it
+
+private:
+	void releaseMeshes();
+	bool createNormalMap(ID3D11Device* device);
+	void rescale(ID3D11DeviceContext* deviceContext, float amplitude, bool multithreaded);
+	void rebakeDirtyTiles(ID3D11DeviceContext* deviceContext, bool multithreaded);
+
+	HeightField heights;
+	TerrainQuadtree quadtree;
+	std::vector<TerrainChunkMesh*> meshes;
+
+	ID3D11Texture2D* normalMap;
+	ID3D11ShaderResourceView* normalMapView;
+	std::vector<uint32_t> normalMapTexels;
+	DirtyTileTracker dirtyTiles;
+	float bakedAmplitude;
+	float bakeMilliseconds;
+	int lastDirtyTiles;
+	int lastRebakedChunks;
+	int bakeCount;
+};
\ No newline at end of file
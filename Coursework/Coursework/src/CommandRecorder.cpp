@@ -0,0 +1,66 @@
+#include "CommandRecorder.h"
+#include "ParallelFor.h"
+
+#include <chrono>
+
+CommandRecorder::CommandRecorder(CommandBackend* backend) : backend(backend), recordedPasses(0), recordMilliseconds(0.0f), executeMilliseconds(0.0f)
+{
+}
+
+CommandRecorder::~CommandRecorder()
+{
+}
+
+void CommandRecorder::addPass(const std::function<void(int context)>& pass)
+{
+	//Contexts are made here rather than on the recording threads
+	passes.push_back(pass);
+	backend->reserveContexts((int)passes.size());
+}
+
+void CommandRecorder::record(bool multithreaded)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	auto recordPasses = [&](int begin, int end)
+	{
+		for (int pass = begin; pass < end; pass++)
+		{
+			passes[pass](pass);
+
+			//The context goes back to the defaults for the next pass it records
+			backend->finish(pass);
+		}
+	};
+
+	if (multithreaded)
+	{
+		parallelFor((int)passes.size(), recordPasses);
+	}
+
+	else
+	{
+		recordPasses(0, (int)passes.size());
+	}
+
+	recordedPasses = (int)passes.size();
+
+	auto end = std::chrono::high_resolution_clock::now();
+	recordMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+void CommandRecorder::execute()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for (int pass = 0; pass < recordedPasses; pass++)
+	{
+		backend->execute(pass);
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	executeMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+
+	recordedPasses = 0;
+	passes.clear();
+}
\ No newline at end of file
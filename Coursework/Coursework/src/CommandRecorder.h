@@ -0,0 +1,47 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+//Where a CommandRecorder's passes record their commands and where the recorded lists run. Each pass has a context of its own,
+//numbered in the order the passes were added. DeferredContexts records into Direct3D deferred contexts, RecordingContexts into
+//plain command buffers, so the recording runs without a device.
+class CommandBackend
+{
+public:
+	virtual ~CommandBackend() {}
+
+	//Makes sure there are at least count contexts, on the thread adding the passes, as a device only hands them out one at a time
+	virtual void reserveContexts(int count) = 0;
+	//Ends the context's recording, keeping what it recorded as its list. Called on the thread that recorded the pass.
+	virtual void finish(int context) = 0;
+	//Runs the context's list and forgets it
+	virtual void execute(int context) = 0;
+};
+
+//Records passes into command lists, each pass on its own thread, then runs the lists in the order the passes were added. A context
+//starts each pass from the backend's defaults, so a pass sets every state it relies on.
+class CommandRecorder
+{
+public:
+	CommandRecorder(CommandBackend* backend);
+	~CommandRecorder();
+
+	//The pass is recorded by the next record(), on a thread of its own, into the backend's context of the number it is given
+	void addPass(const std::function<void(int context)>& pass);
+	void record(bool multithreaded = true);
+
+	//Runs the recorded lists in order and forgets the passes
+	void execute();
+
+	inline int getPassCount() const { return (int)passes.size(); }
+	inline float getRecordMilliseconds() const { return recordMilliseconds; }
+	inline float getExecuteMilliseconds() const { return executeMilliseconds; }
+
+private:
+	CommandBackend* backend;
+	std::vector<std::function<void(int)>> passes;
+	int recordedPasses;		//Finished by the last record(), still to be executed
+	float recordMilliseconds;
+	float executeMilliseconds;
+};
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "DeferredContexts.h"
+
+DeferredContexts::DeferredContexts(ID3D11Device* device, ID3D11DeviceContext* immediateContext) : device(device), immediateContext(immediateContext)
+{
+}
+
+DeferredContexts::~DeferredContexts()
+{
+	for (ID3D11CommandList* commandList : commandLists)
+	{
+		if (commandList)
+		{
+			commandList->Release();
+		}
+	}
+
+	for (ID3D11DeviceContext* context : contexts)
+	{
+		context->Release();
+	}
+}
+
+void DeferredContexts::reserveContexts(int count)
+{
+	while ((int)contexts.size() < count)
+	{
+		ID3D11DeviceContext* context = nullptr;
+		device->CreateDeferredContext(0, &context);
+		contexts.push_back(context);
+		commandLists.push_back(nullptr);
+	}
+}
+
+void DeferredContexts::finish(int context)
+{
+	contexts[context]->FinishCommandList(FALSE, &commandLists[context]);
+}
+
+void DeferredContexts::execute(int context)
+{
+	if (commandLists[context])
+	{
+		immediateContext->ExecuteCommandList(commandLists[context], TRUE);
+		commandLists[context]->Release();
+		commandLists[context] = nullptr;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <d3d11.h>
+#include <vector>
+
+#include "CommandRecorder.h"
+
+//Direct3D side of command recording - a deferred context for every pass of the busiest frame, kept between frames, whose command
+//lists run on the immediate context. The immediate context's states are restored after each list has run.
+class DeferredContexts : public CommandBackend
+{
+public:
+	DeferredContexts(ID3D11Device* device, ID3D11DeviceContext* immediateContext);
+	~DeferredContexts();
+
+	void reserveContexts(int count) override;
+	void finish(int context) override;
+	void execute(int context) override;
+
+	inline ID3D11DeviceContext* getContext(int context) const { return contexts[context]; }
+
+private:
+	ID3D11Device* device;
+	ID3D11DeviceContext* immediateContext;
+	std::vector<ID3D11DeviceContext*> contexts;
+	std::vector<ID3D11CommandList*> commandLists;
+};
\ No newline at end of file
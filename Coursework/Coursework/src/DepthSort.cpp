@@ -0,0 +1,157 @@
+#include "DepthSort.h"
+#include "GrassScatter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+DepthSort::DepthSort()
+{
+
+}
+
+DepthSort::~DepthSort()
+{
+
+}
+
+void DepthSort::sort(const float* depths, int count, bool backToFront)
+{
+	keys.resize(count);
+
+	if (count == 0)
+	{
+		order.clear();
+		return;
+	}
+
+	//The keys span the range of the depths given, so the precision isn't spent on empty space before or after them
+	float nearest = depths[0];
+	float farthest = depths[0];
+
+	for (int i = 1; i < count; i++)
+	{
+		nearest = fminf(nearest, depths[i]);
+		farthest = fmaxf(farthest, depths[i]);
+	}
+
+	float range = farthest - nearest;
+	float scale = 65535.0f / (range > 0.0001f ? range : 0.0001f);
+
+	for (int i = 0; i < count; i++)
+	{
+		uint16_t key = (uint16_t)(((depths[i] - nearest) * scale) + 0.5f);
+
+		//The sort is ascending, so the farthest items are given the smallest keys to draw first
+		keys[i] = backToFront ? (uint16_t)(65535 - key) : key;
+	}
+
+	sortKeys(keys.data(), count);
+}
+
+void DepthSort::sortKeys(const uint16_t* itemKeys, int count)
+{
+	order.resize(count);
+	scratch.resize(count);
+
+	//Both digits are counted in one pass over the keys
+	uint32_t lowCounts[256] = {};
+	uint32_t highCounts[256] = {};
+
+	for (int i = 0; i < count; i++)
+	{
+		lowCounts[itemKeys[i] & 0xFF]++;
+		highCounts[itemKeys[i] >> 8]++;
+	}
+
+	//Counts become where each digit's items start
+	uint32_t lowTotal = 0;
+	uint32_t highTotal = 0;
+
+	for (int digit = 0; digit < 256; digit++)
+	{
+		uint32_t low = lowCounts[digit];
+		uint32_t high = highCounts[digit];
+		lowCounts[digit] = lowTotal;
+		highCounts[digit] = highTotal;
+		lowTotal += low;
+		highTotal += high;
+	}
+
+	//Low byte first, then the high byte, which keeps the low byte's order for equal high bytes
+	for (int i = 0; i < count; i++)
+	{
+		scratch[lowCounts[itemKeys[i] & 0xFF]++] = i;
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		uint32_t item = scratch[i];
+		order[highCounts[itemKeys[item] >> 8]++] = item;
+	}
+}
+
+DepthSort::BenchmarkResult DepthSort::benchmark(int count)
+{
+	BenchmarkResult result = { 0, 0.0f, 0.0f, 0.0f, true };
+
+	//One instance per square unit on flat ground, as the grass benchmarks
+	float world = sqrtf((float)count);
+	std::vector<GrassScatter::Instance> field;
+	GrassScatter::scatterJittered(HeightField(), world, 1.0f, 1, field);
+
+	result.count = (int)field.size();
+
+	//Standing at one corner of the field, looking across it to the other at an angle
+	float eyeX = -1.0f;
+	float eyeZ = -1.0f;
+	float directionX = cosf(0.6f);
+	float directionZ = sinf(0.6f);
+
+	std::vector<float> depths(result.count);
+
+	for (int i = 0; i < result.count; i++)
+	{
+		depths[i] = ((field[i].position.x - eyeX) * directionX) + ((field[i].position.z - eyeZ) * directionZ);
+	}
+
+	DepthSort depthSort;
+	const int runs = 8;
+
+	for (int run = 0; run < runs; run++)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		depthSort.sort(depths.data(), result.count);
+		auto quantised = std::chrono::high_resolution_clock::now();
+		depthSort.sortKeys(depthSort.getKeys().data(), result.count);
+		auto end = std::chrono::high_resolution_clock::now();
+
+		//sort() quantises then sorts, so the radix sort alone is timed from the already quantised keys
+		result.radixMilliseconds += std::chrono::duration<float, std::milli>(end - quantised).count();
+		result.quantiseMilliseconds += std::chrono::duration<float, std::milli>(quantised - start).count() - std::chrono::duration<float, std::milli>(end - quantised).count();
+	}
+
+	const std::vector<uint16_t>& keys = depthSort.getKeys();
+	std::vector<uint32_t> comparison(result.count);
+
+	for (int run = 0; run < runs; run++)
+	{
+		for (int i = 0; i < result.count; i++)
+		{
+			comparison[i] = i;
+		}
+
+		auto start = std::chrono::high_resolution_clock::now();
+		std::stable_sort(comparison.begin(), comparison.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+		auto end = std::chrono::high_resolution_clock::now();
+
+		result.comparisonMilliseconds += std::chrono::duration<float, std::milli>(end - start).count();
+	}
+
+	result.matches = comparison == depthSort.getOrder();
+	result.quantiseMilliseconds = fmaxf(result.quantiseMilliseconds, 0.0f) / (float)runs;
+	result.radixMilliseconds /= (float)runs;
+	result.comparisonMilliseconds /= (float)runs;
+
+	return result;
+}
\ No newline at end of file
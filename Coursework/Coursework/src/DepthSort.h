@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+//Orders items back to front, or front to back, by their view depth for alpha blending. Depths are quantised to 16 bit keys over
+//the range being sorted and put in order with a least significant digit radix sort, two passes of eight bits. Both passes are
+//stable, so items at the same quantised depth keep the order they were given in and the result is the same every frame.
+class DepthSort
+{
+public:
+	struct BenchmarkResult
+	{
+		int count;
+		float quantiseMilliseconds;		//Depths to 16 bit keys
+		float radixMilliseconds;
+		float comparisonMilliseconds;	//std::stable_sort on the same keys
+		bool matches;					//Whether both sorts gave the same order
+	};
+
+	DepthSort();
+	~DepthSort();
+
+	//Sorts count depths, with the order of the items read back through getOrder()
+	void sort(const float* depths, int count, bool backToFront = true);
+
+	//Sorts keys that are already quantised
+	void sortKeys(const uint16_t* itemKeys, int count);
+
+	//Sorts the view depths of a jittered field of the given number of grass instances with the radix sort and with std::stable_sort
+	static BenchmarkResult benchmark(int count);
+
+	inline const std::vector<uint32_t>& getOrder() const { return order; }
+	inline const std::vector<uint16_t>& getKeys() const { return keys; }
+
+private:
+	std::vector<uint16_t> keys;			//Indexed by item
+	std::vector<uint32_t> order;		//Item indices, sorted
+	std::vector<uint32_t> scratch;		//Order after the first pass
+};
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "DirtyTileTracker.h"
+
+DirtyTileTracker::DirtyTileTracker() : width(0), height(0), tileSize(1), tilesX(0), tilesY(0), dirtyCount(0)
+{
+	clear();
+}
+
+void DirtyTileTracker::resize(int trackedWidth, int trackedHeight, int size)
+{
+	width = trackedWidth;
+	height = trackedHeight;
+	tileSize = size > 0 ? size : 1;
+	tilesX = (width + tileSize - 1) / tileSize;
+	tilesY = (height + tileSize - 1) / tileSize;
+
+	dirty.assign(tilesX * tilesY, 0);
+	clear();
+}
+
+void DirtyTileTracker::markDirty(int x0, int y0, int x1, int y1)
+{
+	x0 = x0 < 0 ? 0 : x0;
+	y0 = y0 < 0 ? 0 : y0;
+	x1 = x1 >= width ? width - 1 : x1;
+	y1 = y1 >= height ? height - 1 : y1;
+
+	if (x0 > x1 || y0 > y1)
+	{
+		return;
+	}
+
+	for (int tileY = y0 / tileSize; tileY <= y1 / tileSize; tileY++)
+	{
+		for (int tileX = x0 / tileSize; tileX <= x1 / tileSize; tileX++)
+		{
+			uint8_t& tile = dirty[(tileY * tilesX) + tileX];
+
+			if (!tile)
+			{
+				tile = 1;
+				dirtyCount++;
+			}
+		}
+	}
+
+	bounds[0] = x0 < bounds[0] ? x0 : bounds[0];
+	bounds[1] = y0 < bounds[1] ? y0 : bounds[1];
+	bounds[2] = x1 > bounds[2] ? x1 : bounds[2];
+	bounds[3] = y1 > bounds[3] ? y1 : bounds[3];
+}
+
+void DirtyTileTracker::clear()
+{
+	for (uint8_t& tile : dirty)
+	{
+		tile = 0;
+	}
+
+	dirtyCount = 0;
+	bounds[0] = width;
+	bounds[1] = height;
+	bounds[2] = -1;
+	bounds[3] = -1;
+}
+
+void DirtyTileTracker::getDirtyTiles(std::vector<int>& tiles) const
+{
+	tiles.clear();
+
+	for (int i = 0; i < (int)dirty.size(); i++)
+	{
+		if (dirty[i])
+		{
+			tiles.push_back(i);
+		}
+	}
+}
+
+void DirtyTileTracker::getTileRect(int tile, int& x0, int& y0, int& x1, int& y1) const
+{
+	x0 = (tile % tilesX) * tileSize;
+	y0 = (tile / tilesX) * tileSize;
+	x1 = x0 + tileSize > width ? width : x0 + tileSize;
+	y1 = y0 + tileSize > height ? height : y0 + tileSize;
+}
+
+bool DirtyTileTracker::getDirtyBounds(int& x0, int& y0, int& x1, int& y1) const
+{
+	x0 = bounds[0];
+	y0 = bounds[1];
+	x1 = bounds[2];
+	y1 = bounds[3];
+
+	return dirtyCount > 0;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+//Splits a heightmap into square tiles and records which of them have been edited since they were last baked,
+//so only the edited part of the terrain's derived data has to be rebuilt
+class DirtyTileTracker
+{
+public:
+	DirtyTileTracker();
+
+	void resize(int width, int height, int tileSize);
+
+	//Marks every tile touching the texels from (x0, y0) to (x1, y1) inclusive, clamped to the heightmap
+	void markDirty(int x0, int y0, int x1, int y1);
+	void clear();
+
+	//Writes the indices of the dirty tiles, in row order
+	void getDirtyTiles(std::vector<int>& tiles) const;
+
+	//Texels covered by a tile, from (x0, y0) up to but not including (x1, y1)
+	void getTileRect(int tile, int& x0, int& y0, int& x1, int& y1) const;
+
+	//Smallest rectangle of texels holding every marked texel, inclusive. Returns false if nothing is dirty.
+	bool getDirtyBounds(int& x0, int& y0, int& x1, int& y1) const;
+
+	inline bool isDirty(int tile) const { return dirty[tile] != 0; }
+	inline bool hasDirtyTiles() const { return dirtyCount > 0; }
+	inline int getDirtyCount() const { return dirtyCount; }
+	inline int getTileCount() const { return tilesX * tilesY; }
+	inline int getTileSize() const { return tileSize; }
+
+private:
+	int width;
+	int height;
+	int tileSize;
+	int tilesX;
+	int tilesY;
+	int dirtyCount;
+	int bounds[4];	//Dirty texel bounds, x0, y0, x1 and y1
+	std::vector<uint8_t> dirty;
+};
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "DrawQueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+DrawQueue::DrawQueue()
+{
+}
+
+DrawQueue::~DrawQueue()
+{
+}
+
+uint64_t DrawQueue::makeKey(unsigned int pass, unsigned int shader, unsigned int material, unsigned int mesh, float depth, bool backToFront)
+{
+	//Negative depths, behind the camera, sort with zero. The sign bit is then clear and the bits order like the floats.
+	depth = depth > 0.0f ? depth : 0.0f;
+	uint32_t depthBits;
+	memcpy(&depthBits, &depth, sizeof(depthBits));
+
+	if (backToFront)
+	{
+		depthBits = ~depthBits;
+	}
+
+	return ((uint64_t)(pass & ((1u << PASS_BITS) - 1)) << PASS_SHIFT) | ((uint64_t)(shader & ((1u << SHADER_BITS) - 1)) << SHADER_SHIFT) |
+		((uint64_t)(material & ((1u << MATERIAL_BITS) - 1)) << MATERIAL_SHIFT) | ((uint64_t)(mesh & ((1u << MESH_BITS) - 1)) << MESH_SHIFT) | depthBits;
+}
+
+void DrawQueue::clear()
+{
+	packets.clear();
+}
+
+void DrawQueue::submit(uint64_t key, unsigned int payload)
+{
+	packets.push_back({ key, payload });
+}
+
+void DrawQueue::sort()
+{
+	radixSort(packets, scratch);
+}
+
+void DrawQueue::execute(StateCache& state, const std::function<void(const Packet& packet, unsigned int binds)>& draw) const
+{
+	state.invalidate();
+
+	for (const Packet& packet : packets)
+	{
+		unsigned int binds = 0;
+		binds |= state.setShader(getShader(packet.key)) ? BIND_SHADER : 0;
+		binds |= state.setMaterial(getMaterial(packet.key)) ? BIND_MATERIAL : 0;
+		binds |= state.setMesh(getMesh(packet.key)) ? BIND_MESH : 0;
+		state.countDraw();
+		draw(packet, binds);
+	}
+}
+
+void DrawQueue::radixSort(std::vector<Packet>& packets, std::vector<Packet>& scratch)
+{
+	const int count = (int)packets.size();
+
+	if (count < 2)
+	{
+		return;
+	}
+
+	//Every byte's histogram in one read of the keys
+	static const int BYTES = 8;
+	std::vector<int> histograms(BYTES * 256, 0);
+
+	for (const Packet& packet : packets)
+	{
+		for (int byte = 0; byte < BYTES; byte++)
+		{
+			histograms[byte * 256 + (int)((packet.key >> (byte * 8)) & 0xff)]++;
+		}
+	}
+
+	scratch.resize(count);
+	Packet* source = packets.data();
+	Packet* destination = scratch.data();
+
+	//Least significant byte first, each pass keeping the order of the last among equal bytes
+	for (int byte = 0; byte < BYTES; byte++)
+	{
+		int* histogram = &histograms[byte * 256];
+
+		//A byte every key shares leaves the order as it is
+		if (histogram[(packets[0].key >> (byte * 8)) & 0xff] == count)
+		{
+			continue;
+		}
+
+		int offset = 0;
+
+		for (int bucket = 0; bucket < 256; bucket++)
+		{
+			int bucketCount = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucketCount;
+		}
+
+		for (int i = 0; i < count; i++)
+		{
+			destination[histogram[(source[i].key >> (byte * 8)) & 0xff]++] = source[i];
+		}
+
+		Packet* swap = source;
+		source = destination;
+		destination = swap;
+	}
+
+	//After an odd number of passes the sorted packets are in scratch
+	if (source != packets.data())
+	{
+		packets.swap(scratch);
+	}
+}
+
+DrawQueue::BenchmarkResult DrawQueue::benchmark(int packetCount, int shaders, int materials, int meshes, int iterations)
+{
+	BenchmarkResult result = { packetCount, 0, 0, 0.0f, 0.0f, true };
+
+	if (packetCount <= 0 || iterations <= 0)
+	{
+		return result;
+	}
+
+	//Packets split over two passes, the second blended and back to front, at depths across a kilometre
+	std::mt19937 random(1);
+	std::uniform_int_distribution<int> pass(0, 1);
+	std::uniform_int_distribution<int> shader(0, shaders > 1 ? shaders - 1 : 0);
+	std::uniform_int_distribution<int> material(0, materials > 1 ? materials - 1 : 0);
+	std::uniform_int_distribution<int> mesh(0, meshes > 1 ? meshes - 1 : 0);
+	std::uniform_real_distribution<float> depth(0.1f, 1000.0f);
+	DrawQueue queue;
+
+	for (int i = 0; i < packetCount; i++)
+	{
+		int packetPass = pass(random);
+		queue.submit(makeKey(packetPass, shader(random), material(random), mesh(random), depth(random), packetPass == 1), i);
+	}
+
+	//Only the state cache sees the draws, counting the binds a device would have been sent
+	StateCache state;
+	auto countOnly = [](const Packet&, unsigned int) {};
+	queue.execute(state, countOnly);
+	result.unsortedBinds = state.getBinds();
+
+	const std::vector<Packet> unsorted = queue.packets;
+	std::vector<Packet> expected;
+
+	for (int iteration = 0; iteration < iterations; iteration++)
+	{
+		queue.packets = unsorted;
+		auto start = std::chrono::high_resolution_clock::now();
+		queue.sort();
+		auto end = std::chrono::high_resolution_clock::now();
+		result.radixMilliseconds += std::chrono::duration<float, std::milli>(end - start).count();
+
+		expected = unsorted;
+		start = std::chrono::high_resolution_clock::now();
+		std::sort(expected.begin(), expected.end(), [](const Packet& a, const Packet& b) { return a.key < b.key; });
+		end = std::chrono::high_resolution_clock::now();
+		result.stdSortMilliseconds += std::chrono::duration<float, std::milli>(end - start).count();
+	}
+
+	result.radixMilliseconds /= iterations;
+	result.stdSortMilliseconds /= iterations;
+
+	for (int i = 0; i < packetCount; i++)
+	{
+		result.matches = result.matches && queue.packets[i].key == expected[i].key;
+	}
+
+	state.resetCounters();
+	queue.execute(state, countOnly);
+	result.sortedBinds = state.getBinds();
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "StateCache.h"
+
+//Draws submitted as packets of a 64 bit sort key and a payload, the caller's index for what to draw. From the top bit down the key
+//holds the pass, shader, material, mesh and view depth, so sorting the keys groups each pass's draws by the state they bind and
+//orders each group by depth. Keys are radix sorted a byte at a time, skipping the bytes every key shares.
+class DrawQueue
+{
+public:
+	struct Packet
+	{
+		uint64_t key;
+		unsigned int payload;
+	};
+
+	//What a packet needs bound before it is drawn, passed to execute()'s draw function
+	enum Bind
+	{
+		BIND_SHADER = 1,
+		BIND_MATERIAL = 2,
+		BIND_MESH = 4
+	};
+
+	struct BenchmarkResult
+	{
+		int packets;
+		int unsortedBinds;			//Shader, material and mesh binds drawing in submission order
+		int sortedBinds;			//Drawing in key order
+		float radixMilliseconds;
+		float stdSortMilliseconds;	//std::sort of the same packets by key
+		bool matches;				//Both sorts gave the same keys in the same order
+	};
+
+	DrawQueue();
+	~DrawQueue();
+
+	//Ids are cut to their bits. Depth is the distance along the view, near first unless backToFront, for blended draws.
+	static uint64_t makeKey(unsigned int pass, unsigned int shader, unsigned int material, unsigned int mesh, float depth, bool backToFront = false);
+
+	inline static unsigned int getPass(uint64_t key) { return (unsigned int)(key >> PASS_SHIFT) & ((1u << PASS_BITS) - 1); }
+	inline static unsigned int getShader(uint64_t key) { return (unsigned int)(key >> SHADER_SHIFT) & ((1u << SHADER_BITS) - 1); }
+	inline static unsigned int getMaterial(uint64_t key) { return (unsigned int)(key >> MATERIAL_SHIFT) & ((1u << MATERIAL_BITS) - 1); }
+	inline static unsigned int getMesh(uint64_t key) { return (unsigned int)(key >> MESH_SHIFT) & ((1u << MESH_BITS) - 1); }
+
+	void clear();
+	void submit(uint64_t key, unsigned int payload);
+	void sort();
+
+	//Draws the packets in order, telling draw which of the packet's states the cache found unbound. The cache is invalidated first, as
+	//other draws may have bound their own state since the last queue.
+	void execute(StateCache& state, const std::function<void(const Packet& packet, unsigned int binds)>& draw) const;
+
+	//Stable sort by key, scratch is resized to hold the packets while they are moved between passes
+	static void radixSort(std::vector<Packet>& packets, std::vector<Packet>& scratch);
+
+	//Sorts random packets spread over the given numbers of shaders, materials and meshes, counting the binds before and after
+	static BenchmarkResult benchmark(int packets, int shaders, int materials, int meshes, int iterations);
+
+	inline const std::vector<Packet>& getPackets() const { return packets; }
+	inline int getPacketCount() const { return (int)packets.size(); }
+
+	static const int PASS_BITS = 4;
+	static const int SHADER_BITS = 10;
+	static const int MATERIAL_BITS = 10;
+	static const int MESH_BITS = 8;
+	static const int DEPTH_BITS = 32;	//The float's bits, which sort as integers for positive floats
+
+private:
+	static const int MESH_SHIFT = DEPTH_BITS;
+	static const int MATERIAL_SHIFT = MESH_SHIFT + MESH_BITS;
+	static const int SHADER_SHIFT = MATERIAL_SHIFT + MATERIAL_BITS;
+	static const int PASS_SHIFT = SHADER_SHIFT + SHADER_BITS;
+
+	std::vector<Packet> packets;
+	std::vector<Packet> scratch;
+};
\ No newline at end of file
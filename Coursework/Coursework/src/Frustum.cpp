@@ -0,0 +1,128 @@
+#include "Frustum.h"
+
+Frustum::Frustum()
+{
+	for (int i = 0; i < PLANE_COUNT; i++)
+	{
+		planes[i] = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
+	}
+}
+
+Frustum::Frustum(const XMMATRIX& viewProjection)
+{
+	build(viewProjection);
+}
+
+//Planes from the columns of the matrix, for row vectors multiplied on the left and a clip space depth of (0, w)
+void Frustum::build(const XMMATRIX& viewProjection)
+{
+	XMFLOAT4X4 m;
+	XMStoreFloat4x4(&m, viewProjection);
+
+	XMVECTOR column0 = XMVectorSet(m.m[0][0], m.m[1][0], m.m[2][0], m.m[3][0]);
+	XMVECTOR column1 = XMVectorSet(m.m[0][1], m.m[1][1], m.m[2][1], m.m[3][1]);
+	XMVECTOR column2 = XMVectorSet(m.m[0][2], m.m[1][2], m.m[2][2], m.m[3][2]);
+	XMVECTOR column3 = XMVectorSet(m.m[0][3], m.m[1][3], m.m[2][3], m.m[3][3]);
+
+	XMVECTOR extracted[PLANE_COUNT] =
+	{
+		XMVectorAdd(column3, column0),
+		XMVectorSubtract(column3, column0),
+		XMVectorAdd(column3, column1),
+		XMVectorSubtract(column3, column1),
+		column2,
+		XMVectorSubtract(column3, column2)
+	};
+
+	for (int i = 0; i < PLANE_COUNT; i++)
+	{
+		//Normalised so plane distances are in world units and can be compared against radii
+		float length = XMVectorGetX(XMVector3Length(extracted[i]));
+		XMStoreFloat4(&planes[i], XMVectorScale(extracted[i], 1.0f / length));
+	}
+}
+
+bool Frustum::sphereVisible(const XMFLOAT3& centre, float radius) const
+{
+	for (int i = 0; i < PLANE_COUNT; i++)
+	{
+		float distance = (planes[i].x * centre.x) + (planes[i].y * centre.y) + (planes[i].z * centre.z) + planes[i].w;
+
+		if (distance < -radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool Frustum::boxVisible(const XMFLOAT3& minimum, const XMFLOAT3& maximum) const
+{
+	for (int i = 0; i < PLANE_COUNT; i++)
+	{
+		//Corner furthest along the plane normal
+		float x = planes[i].x >= 0.0f ? maximum.x : minimum.x;
+		float y = planes[i].y >= 0.0f ? maximum.y : minimum.y;
+		float z = planes[i].z >= 0.0f ? maximum.z : minimum.z;
+
+		if ((planes[i].x * x) + (planes[i].y * y) + (planes[i].z * z) + planes[i].w < 0.0f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+XMVECTOR Frustum::spheresVisible(FXMVECTOR x, FXMVECTOR y, FXMVECTOR z, FXMVECTOR radius) const
+{
+	XMVECTOR visible = XMVectorTrueInt();
+	XMVECTOR negativeRadius = XMVectorNegate(radius);
+
+	for (int i = 0; i < PLANE_COUNT; i++)
+	{
+		XMVECTOR distance = XMVectorMultiplyAdd(x, XMVectorReplicate(planes[i].x),
+			XMVectorMultiplyAdd(y, XMVectorReplicate(planes[i].y),
+			XMVectorMultiplyAdd(z, XMVectorReplicate(planes[i].z), XMVectorReplicate(planes[i].w))));
+
+		visible = XMVectorAndInt(visible, XMVectorGreaterOrEqual(distance, negativeRadius));
+	}
+
+	return visible;
+}
+
+XMVECTOR Frustum::boxesVisible(FXMVECTOR minX, FXMVECTOR minY, FXMVECTOR minZ, GXMVECTOR maxX, HXMVECTOR maxY, HXMVECTOR maxZ, XMVECTOR* inside) const
+{
+	XMVECTOR visible = XMVectorTrueInt();
+	XMVECTOR within = XMVectorTrueInt();
+	XMVECTOR zero = XMVectorZero();
+
+	for (int i = 0; i < PLANE_COUNT; i++)
+	{
+		//The plane is the same in every lane, so its farthest and nearest corners are picked once for all four boxes
+		XMVECTOR farX = planes[i].x >= 0.0f ? maxX : minX;
+		XMVECTOR farY = planes[i].y >= 0.0f ? maxY : minY;
+		XMVECTOR farZ = planes[i].z >= 0.0f ? maxZ : minZ;
+		XMVECTOR nearX = planes[i].x >= 0.0f ? minX : maxX;
+		XMVECTOR nearY = planes[i].y >= 0.0f ? minY : maxY;
+		XMVECTOR nearZ = planes[i].z >= 0.0f ? minZ : maxZ;
+
+		XMVECTOR farDistance = XMVectorMultiplyAdd(farX, XMVectorReplicate(planes[i].x),
+			XMVectorMultiplyAdd(farY, XMVectorReplicate(planes[i].y),
+			XMVectorMultiplyAdd(farZ, XMVectorReplicate(planes[i].z), XMVectorReplicate(planes[i].w))));
+		XMVECTOR nearDistance = XMVectorMultiplyAdd(nearX, XMVectorReplicate(planes[i].x),
+			XMVectorMultiplyAdd(nearY, XMVectorReplicate(planes[i].y),
+			XMVectorMultiplyAdd(nearZ, XMVectorReplicate(planes[i].z), XMVectorReplicate(planes[i].w))));
+
+		visible = XMVectorAndInt(visible, XMVectorGreaterOrEqual(farDistance, zero));
+		within = XMVectorAndInt(within, XMVectorGreaterOrEqual(nearDistance, zero));
+	}
+
+	if (inside)
+	{
+		*inside = XMVectorAndInt(within, visible);
+	}
+
+	return visible;
+}
\ No newline at end of file
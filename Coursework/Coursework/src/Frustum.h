@@ -0,0 +1,40 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+//View frustum as six inward facing planes, taken from a combined view projection matrix
+class Frustum
+{
+public:
+	enum PlaneIndex
+	{
+		PLANE_LEFT = 0,
+		PLANE_RIGHT,
+		PLANE_BOTTOM,
+		PLANE_TOP,
+		PLANE_NEAR,
+		PLANE_FAR,
+		PLANE_COUNT
+	};
+
+	Frustum();
+	Frustum(const XMMATRIX& viewProjection);
+
+	void build(const XMMATRIX& viewProjection);
+
+	bool sphereVisible(const XMFLOAT3& centre, float radius) const;
+	bool boxVisible(const XMFLOAT3& minimum, const XMFLOAT3& maximum) const;
+
+	//Tests four spheres at once, the result has all bits set in each lane where the sphere touches the frustum
+	XMVECTOR spheresVisible(FXMVECTOR x, FXMVECTOR y, FXMVECTOR z, FXMVECTOR radius) const;
+
+	//Tests four boxes at once, as spheresVisible(). Where inside is given its lanes are set for boxes wholly within the frustum.
+	XMVECTOR boxesVisible(FXMVECTOR minX, FXMVECTOR minY, FXMVECTOR minZ, GXMVECTOR maxX, HXMVECTOR maxY, HXMVECTOR maxZ, XMVECTOR* inside = nullptr) const;
+
+	inline const XMFLOAT4& getPlane(int index) const { return planes[index]; }
+
+private:
+	XMFLOAT4 planes[PLANE_COUNT];
+};
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "GBuffer.h"
+
+GBuffer::GBuffer(ID3D11Device* device, int textureWidth, int textureHeight, float screenNear, float screenDepth)
+{
+	width = textureWidth;
+	height = textureHeight;
+
+	targets[TARGET_ALBEDO] = new RenderTexture(device, width, height, screenNear, screenDepth, DXGI_FORMAT_R8G8B8A8_UNORM);
+	targets[TARGET_NORMAL] = new RenderTexture(device, width, height, screenNear, screenDepth, DXGI_FORMAT_R16G16_SNORM);
+	targets[TARGET_DEPTH] = new RenderTexture(device, width, height, screenNear, screenDepth, DXGI_FORMAT_R32_FLOAT);
+}
+
+GBuffer::~GBuffer()
+{
+	for (int i = 0; i < TARGET_COUNT; i++)
+	{
+		if (targets[i])
+		{
+			delete targets[i];
+			targets[i] = nullptr;
+		}
+	}
+}
+
+void GBuffer::setRenderTargets(ID3D11DeviceContext* deviceContext)
+{
+	ID3D11RenderTargetView* renderTargets[TARGET_COUNT];
+
+	for (int i = 0; i < TARGET_COUNT; i++)
+	{
+		renderTargets[i] = targets[i]->getRenderTargetView();
+	}
+
+	//Sets the viewport, the targets are then replaced with the full set
+	targets[TARGET_ALBEDO]->setRenderTarget(deviceContext);
+	deviceContext->OMSetRenderTargets(TARGET_COUNT, renderTargets, targets[TARGET_ALBEDO]->getDepthStencilView());
+}
+
+void GBuffer::clearRenderTargets(ID3D11DeviceContext* deviceContext)
+{
+	//A view depth of zero marks pixels with nothing drawn
+	for (int i = 0; i < TARGET_COUNT; i++)
+	{
+		targets[i]->clearRenderTarget(deviceContext, 0.0f, 0.0f, 0.0f, 0.0f);
+	}
+}
+
+int GBuffer::getBytesPerPixel()
+{
+	return 4 + 4 + 4;
+}
\ No newline at end of file
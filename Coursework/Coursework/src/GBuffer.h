@@ -0,0 +1,40 @@
+#pragma once
+
+#include "DXF.h"
+
+using namespace DirectX;
+
+//Render textures written together by the deferred geometry pass. Kept compact, the lighting pass reads every
+//channel once per pixel, so the world position is rebuilt from view depth rather than stored.
+class GBuffer
+{
+public:
+	enum Target
+	{
+		TARGET_ALBEDO = 0,	//R8G8B8A8_UNORM
+		TARGET_NORMAL,		//R16G16_SNORM, octahedral encoded
+		TARGET_DEPTH,		//R32_FLOAT, view space depth
+		TARGET_COUNT
+	};
+
+	GBuffer(ID3D11Device* device, int width, int height, float screenNear, float screenDepth);
+	~GBuffer();
+
+	//Binds all of the targets at once, with the albedo target's depth buffer
+	void setRenderTargets(ID3D11DeviceContext* deviceContext);
+	void clearRenderTargets(ID3D11DeviceContext* deviceContext);
+
+	inline ID3D11ShaderResourceView* getShaderResourceView(Target target) const { return targets[target]->getShaderResourceView(); }
+	inline RenderTexture* getRenderTexture(Target target) const { return targets[target]; }
+
+	inline int getWidth() const { return width; }
+	inline int getHeight() const { return height; }
+
+	//Bytes written per pixel, excluding the depth buffer
+	static int getBytesPerPixel();
+
+private:
+	RenderTexture* targets[TARGET_COUNT];
+	int width;
+	int height;
+};
\ No newline at end of file
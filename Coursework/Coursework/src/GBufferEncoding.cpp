@@ -0,0 +1,122 @@
+#include "GBufferEncoding.h"
+
+#include <cmath>
+#include <random>
+
+XMFLOAT2 GBufferEncoding::encodeNormal(const XMFLOAT3& normal)
+{
+	float sum = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+	XMFLOAT2 encoded(normal.x / sum, normal.y / sum);
+
+	//Lower half of the octahedron is folded over the diagonals
+	if (normal.z < 0.0f)
+	{
+		XMFLOAT2 folded((1.0f - fabsf(encoded.y)) * (encoded.x >= 0.0f ? 1.0f : -1.0f), (1.0f - fabsf(encoded.x)) * (encoded.y >= 0.0f ? 1.0f : -1.0f));
+		encoded = folded;
+	}
+
+	return encoded;
+}
+
+XMFLOAT3 GBufferEncoding::decodeNormal(const XMFLOAT2& encoded)
+{
+	XMFLOAT3 normal(encoded.x, encoded.y, 1.0f - fabsf(encoded.x) - fabsf(encoded.y));
+	float t = fminf(fmaxf(-normal.z, 0.0f), 1.0f);
+
+	normal.x += normal.x >= 0.0f ? -t : t;
+	normal.y += normal.y >= 0.0f ? -t : t;
+
+	float length = sqrtf((normal.x * normal.x) + (normal.y * normal.y) + (normal.z * normal.z));
+
+	return XMFLOAT3(normal.x / length, normal.y / length, normal.z / length);
+}
+
+float GBufferEncoding::quantiseSnorm(float value, int bits)
+{
+	float steps = (float)((1 << (bits - 1)) - 1);
+	float clamped = fminf(fmaxf(value, -1.0f), 1.0f);
+
+	return roundf(clamped * steps) / steps;
+}
+
+XMFLOAT3 GBufferEncoding::reconstructViewPosition(const XMFLOAT2& uv, float viewDepth, const XMMATRIX& inverseProjection)
+{
+	XMVECTOR ndc = XMVectorSet((uv.x * 2.0f) - 1.0f, 1.0f - (uv.y * 2.0f), 1.0f, 1.0f);
+	XMVECTOR viewRay = XMVector4Transform(ndc, inverseProjection);
+	viewRay = XMVectorDivide(viewRay, XMVectorSplatW(viewRay));
+
+	XMFLOAT3 ray;
+	XMStoreFloat3(&ray, viewRay);
+
+	float scale = viewDepth / ray.z;
+
+	return XMFLOAT3(ray.x * scale, ray.y * scale, ray.z * scale);
+}
+
+GBufferEncoding::PrecisionResult GBufferEncoding::measurePrecision(int normalBits, int samples, const XMMATRIX& projection, float nearZ, float farZ, unsigned int seed)
+{
+	PrecisionResult result = { normalBits, samples, 0.0f, 0.0f, 0.0f, 0.0f };
+
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::normal_distribution<float> gaussian(0.0f, 1.0f);
+
+	XMMATRIX inverseProjection = XMMatrixInverse(nullptr, projection);
+
+	for (int i = 0; i < samples; i++)
+	{
+		//Uniform direction on the sphere, from a normalised gaussian vector
+		XMFLOAT3 normal(gaussian(generator), gaussian(generator), gaussian(generator));
+		float length = sqrtf((normal.x * normal.x) + (normal.y * normal.y) + (normal.z * normal.z));
+
+		if (length < 0.0001f)
+		{
+			normal = XMFLOAT3(0.0f, 1.0f, 0.0f);
+			length = 1.0f;
+		}
+
+		normal = XMFLOAT3(normal.x / length, normal.y / length, normal.z / length);
+
+		XMFLOAT2 encoded = encodeNormal(normal);
+		encoded = XMFLOAT2(quantiseSnorm(encoded.x, normalBits), quantiseSnorm(encoded.y, normalBits));
+		XMFLOAT3 decoded = decodeNormal(encoded);
+
+		//From the cross and dot products, acos loses too much precision for the small angles of the wider encodings
+		float cosine = (normal.x * decoded.x) + (normal.y * decoded.y) + (normal.z * decoded.z);
+		float cx = (normal.y * decoded.z) - (normal.z * decoded.y);
+		float cy = (normal.z * decoded.x) - (normal.x * decoded.z);
+		float cz = (normal.x * decoded.y) - (normal.y * decoded.x);
+		float angle = XMConvertToDegrees(atan2f(sqrtf((cx * cx) + (cy * cy) + (cz * cz)), cosine));
+
+		result.meanNormalError += angle;
+		result.maxNormalError = fmaxf(result.maxNormalError, angle);
+
+		//A point somewhere in the view frustum, projected to the screen then rebuilt from its uv and depth
+		XMFLOAT2 uv(unit(generator), unit(generator));
+		float depth = nearZ + ((farZ - nearZ) * unit(generator));
+		XMFLOAT3 original = reconstructViewPosition(uv, depth, inverseProjection);
+
+		XMVECTOR clip = XMVector4Transform(XMVectorSet(original.x, original.y, original.z, 1.0f), projection);
+		XMFLOAT4 projected;
+		XMStoreFloat4(&projected, clip);
+
+		XMFLOAT2 projectedUV(((projected.x / projected.w) * 0.5f) + 0.5f, 0.5f - ((projected.y / projected.w) * 0.5f));
+		XMFLOAT3 rebuilt = reconstructViewPosition(projectedUV, projected.w, inverseProjection);
+
+		float dx = rebuilt.x - original.x;
+		float dy = rebuilt.y - original.y;
+		float dz = rebuilt.z - original.z;
+		float error = sqrtf((dx * dx) + (dy * dy) + (dz * dz));
+
+		result.meanPositionError += error;
+		result.maxPositionError = fmaxf(result.maxPositionError, error);
+	}
+
+	if (samples > 0)
+	{
+		result.meanNormalError /= (float)samples;
+		result.meanPositionError /= (float)samples;
+	}
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+//CPU reference for the G-buffer encoding in gbuffer.hlsli, used to check how much precision the compact targets lose
+class GBufferEncoding
+{
+public:
+	struct PrecisionResult
+	{
+		int normalBits;
+		int samples;
+		float meanNormalError;		//Degrees between the original and decoded normal
+		float maxNormalError;
+		float meanPositionError;	//World units between the original and rebuilt position
+		float maxPositionError;
+	};
+
+	//Octahedral normal encoding into the (-1,1) square
+	static XMFLOAT2 encodeNormal(const XMFLOAT3& normal);
+	static XMFLOAT3 decodeNormal(const XMFLOAT2& encoded);
+
+	//Rounds a value in (-1,1) to what a signed normalised channel of the given width stores
+	static float quantiseSnorm(float value, int bits);
+
+	//View space position from a screen uv and the view depth, by scaling the view ray through the pixel
+	static XMFLOAT3 reconstructViewPosition(const XMFLOAT2& uv, float viewDepth, const XMMATRIX& inverseProjection);
+
+	//Round trips random unit normals through the quantised encoding, and random points in the frustum through depth
+	static PrecisionResult measurePrecision(int normalBits, int samples, const XMMATRIX& projection, float nearZ, float farZ, unsigned int seed = 1802644);
+};
\ No newline at end of file
@@ -0,0 +1,386 @@
+#include "GrassCells.h"
+#include "ParallelFor.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+//Position hash in the range [0,1), the same for a blade however the field is sorted
+static float hashPosition(float x, float z)
+{
+	unsigned int ix, iz;
+	memcpy(&ix, &x, sizeof(float));
+	memcpy(&iz, &z, sizeof(float));
+
+	unsigned int h = (ix * 374761393u) + (iz * 668265263u);
+	h = (h ^ (h >> 13)) * 1274126177u;
+	h ^= h >> 16;
+
+	return (float)(h & 0xFFFFFF) / (float)0x1000000;
+}
+
+GrassCells::GrassCells() : worldSize(0.0f), cellsPerSide(0), lastStats({ 0, 0, 0.0f })
+{
+
+}
+
+GrassCells::~GrassCells()
+{
+
+}
+
+void GrassCells::build(const std::vector<GrassScatter::Instance>& blades, float size, int side)
+{
+	worldSize = size;
+	cellsPerSide = side;
+
+	int cellCount = cellsPerSide * cellsPerSide;
+	float cellScale = (float)cellsPerSide / worldSize;
+
+	auto getCell = [&](const GrassScatter::Instance& blade)
+	{
+		int x = (int)(blade.position.x * cellScale);
+		int z = (int)(blade.position.z * cellScale);
+		x = x < 0 ? 0 : (x >= cellsPerSide ? cellsPerSide - 1 : x);
+		z = z < 0 ? 0 : (z >= cellsPerSide ? cellsPerSide - 1 : z);
+
+		return (z * cellsPerSide) + x;
+	};
+
+	//Counting sort, so each cell's blades are contiguous
+	cells.assign(cellCount, { 0, 0, 1.0f, 0.0f, 0.0f });
+
+	for (const GrassScatter::Instance& blade : blades)
+	{
+		cells[getCell(blade)].count++;
+	}
+
+	int first = 0;
+
+	for (Cell& cell : cells)
+	{
+		cell.first = first;
+		first += cell.count;
+		cell.count = 0;
+	}
+
+	instances.resize(blades.size());
+
+	for (const GrassScatter::Instance& blade : blades)
+	{
+		Cell& cell = cells[getCell(blade)];
+		instances[cell.first + cell.count] = blade;
+		cell.count++;
+
+		cell.minHeight = fminf(cell.minHeight, blade.position.y);
+		cell.maxHeight = fmaxf(cell.maxHeight, blade.position.y);
+		cell.maxScale = fmaxf(cell.maxScale, blade.scale);
+	}
+
+	positionX.resize(instances.size());
+	positionZ.resize(instances.size());
+	thinning.resize(instances.size());
+
+	for (int i = 0; i < (int)instances.size(); i++)
+	{
+		positionX[i] = instances[i].position.x;
+		positionZ[i] = instances[i].position.z;
+		thinning[i] = hashPosition(instances[i].position.x, instances[i].position.z);
+	}
+
+	survivors.resize(instances.size());
+	survivorCounts.assign(cellCount, 0);
+}
+
+int GrassCells::thinCell(const Cell& cell, const CullSettings& settings, bool simd)
+{
+	float fadeRange = settings.fadeEnd - settings.fadeStart;
+	float inverseRange = 1.0f / (fadeRange > 0.0001f ? fadeRange : 0.0001f);
+
+	uint32_t* kept = &survivors[cell.first];
+	int keptCount = 0;
+	int i = cell.first;
+	int end = cell.first + cell.count;
+
+	if (simd)
+	{
+		XMVECTOR cameraX = XMVectorReplicate(settings.cameraPosition.x);
+		XMVECTOR cameraZ = XMVectorReplicate(settings.cameraPosition.z);
+		XMVECTOR fadeEnd = XMVectorReplicate(settings.fadeEnd);
+		XMVECTOR scale = XMVectorReplicate(inverseRange);
+
+		for (; i + 4 <= end; i += 4)
+		{
+			XMVECTOR dx = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&positionX[i])), cameraX);
+			XMVECTOR dz = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&positionZ[i])), cameraZ);
+			XMVECTOR distance = XMVectorSqrt(XMVectorAdd(XMVectorMultiply(dx, dx), XMVectorMultiply(dz, dz)));
+			XMVECTOR density = XMVectorSaturate(XMVectorMultiply(XMVectorSubtract(fadeEnd, distance), scale));
+
+			uint32_t result[4];
+			XMStoreInt4(result, XMVectorLess(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&thinning[i])), density));
+
+			//Every lane is written, but only kept blades move the end of the list on
+			for (int lane = 0; lane < 4; lane++)
+			{
+				kept[keptCount] = i + lane;
+				keptCount += result[lane] & 1;
+			}
+		}
+	}
+
+	//Remaining blades that don't fill a group of four, or all of them for the scalar path
+	for (; i < end; i++)
+	{
+		float dx = positionX[i] - settings.cameraPosition.x;
+		float dz = positionZ[i] - settings.cameraPosition.z;
+		float distance = sqrtf((dx * dx) + (dz * dz));
+		float density = fminf(fmaxf((settings.fadeEnd - distance) * inverseRange, 0.0f), 1.0f);
+
+		if (thinning[i] < density)
+		{
+			kept[keptCount++] = i;
+		}
+	}
+
+	return keptCount;
+}
+
+int GrassCells::cull(const CullSettings& settings, const Frustum& frustum, GrassScatter::Instance* output, bool simd, bool multithreaded, const uint32_t* bends)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	float cellSize = worldSize / (float)cellsPerSide;
+
+	//Only the cells within the fade distance of the camera can have blades left, so a larger field costs no more to cull
+	int x0 = (int)floorf((settings.cameraPosition.x - settings.fadeEnd) / cellSize);
+	int z0 = (int)floorf((settings.cameraPosition.z - settings.fadeEnd) / cellSize);
+	int x1 = (int)floorf((settings.cameraPosition.x + settings.fadeEnd) / cellSize);
+	int z1 = (int)floorf((settings.cameraPosition.z + settings.fadeEnd) / cellSize);
+	x0 = x0 < 0 ? 0 : x0;
+	z0 = z0 < 0 ? 0 : z0;
+	x1 = x1 >= cellsPerSide ? cellsPerSide - 1 : x1;
+	z1 = z1 >= cellsPerSide ? cellsPerSide - 1 : z1;
+
+	candidates.clear();
+
+	for (int z = z0; z <= z1; z++)
+	{
+		for (int x = x0; x <= x1; x++)
+		{
+			candidates.push_back((z * cellsPerSide) + x);
+		}
+	}
+
+	int candidateCount = (int)candidates.size();
+
+	auto cullCells = [&](int begin, int end)
+	{
+		for (int candidate = begin; candidate < end; candidate++)
+		{
+			int c = candidates[candidate];
+			const Cell& cell = cells[c];
+			survivorCounts[c] = 0;
+
+			if (cell.count == 0)
+			{
+				continue;
+			}
+
+			//Blades are two units tall and one either side of their position, before scaling
+			float cellX = (float)(c % cellsPerSide) * cellSize;
+			float cellZ = (float)(c / cellsPerSide) * cellSize;
+			XMFLOAT3 minimum(cellX - cell.maxScale, cell.minHeight * settings.amplitude, cellZ - cell.maxScale);
+			XMFLOAT3 maximum(cellX + cellSize + cell.maxScale, (cell.maxHeight * settings.amplitude) + (2.0f * cell.maxScale), cellZ + cellSize + cell.maxScale);
+
+			//Horizontal distances to the nearest and farthest points of the cell
+			float nearX = fmaxf(fmaxf(cellX - settings.cameraPosition.x, settings.cameraPosition.x - (cellX + cellSize)), 0.0f);
+			float nearZ = fmaxf(fmaxf(cellZ - settings.cameraPosition.z, settings.cameraPosition.z - (cellZ + cellSize)), 0.0f);
+			float farX = fmaxf(fabsf(cellX - settings.cameraPosition.x), fabsf(cellX + cellSize - settings.cameraPosition.x));
+			float farZ = fmaxf(fabsf(cellZ - settings.cameraPosition.z), fabsf(cellZ + cellSize - settings.cameraPosition.z));
+
+			if ((nearX * nearX) + (nearZ * nearZ) >= settings.fadeEnd * settings.fadeEnd || !frustum.boxVisible(minimum, maximum))
+			{
+				continue;
+			}
+
+			//Nothing is thinned before the fade starts
+			if ((farX * farX) + (farZ * farZ) <= settings.fadeStart * settings.fadeStart)
+			{
+				for (int i = 0; i < cell.count; i++)
+				{
+					survivors[cell.first + i] = cell.first + i;
+				}
+
+				survivorCounts[c] = cell.count;
+				continue;
+			}
+
+			survivorCounts[c] = thinCell(cell, settings, simd);
+		}
+	};
+
+	if (multithreaded)
+	{
+		parallelFor(candidateCount, cullCells, 16);
+	}
+
+	else
+	{
+		cullCells(0, candidateCount);
+	}
+
+	if (settings.backToFront)
+	{
+		candidateDepths.resize(candidateCount);
+
+		for (int candidate = 0; candidate < candidateCount; candidate++)
+		{
+			int c = candidates[candidate];
+			float centreX = (((float)(c % cellsPerSide) + 0.5f) * cellSize) - settings.cameraPosition.x;
+			float centreY = ((cells[c].minHeight + cells[c].maxHeight) * 0.5f * settings.amplitude) - settings.cameraPosition.y;
+			float centreZ = (((float)(c / cellsPerSide) + 0.5f) * cellSize) - settings.cameraPosition.z;
+
+			candidateDepths[candidate] = (centreX * settings.viewDirection.x) + (centreY * settings.viewDirection.y) + (centreZ * settings.viewDirection.z);
+		}
+
+		depthSort.sort(candidateDepths.data(), candidateCount);
+
+		//The survivor counts are per cell, so only the order the candidates are written in changes
+		sortedCandidates.resize(candidateCount);
+
+		for (int candidate = 0; candidate < candidateCount; candidate++)
+		{
+			sortedCandidates[candidate] = candidates[depthSort.getOrder()[candidate]];
+		}
+
+		candidates.swap(sortedCandidates);
+	}
+
+	//Where each cell's survivors go in the output
+	offsets.resize(candidateCount);
+	int total = 0;
+	int visibleCells = 0;
+
+	for (int candidate = 0; candidate < candidateCount; candidate++)
+	{
+		int count = survivorCounts[candidates[candidate]];
+		offsets[candidate] = total;
+		total += count;
+		visibleCells += count > 0 ? 1 : 0;
+	}
+
+	auto compactCells = [&](int begin, int end)
+	{
+		for (int candidate = begin; candidate < end; candidate++)
+		{
+			int c = candidates[candidate];
+			const uint32_t* kept = &survivors[cells[c].first];
+			GrassScatter::Instance* destination = output + offsets[candidate];
+
+			for (int i = 0; i < survivorCounts[c]; i++)
+			{
+				destination[i] = instances[kept[i]];
+			}
+
+			if (bends)
+			{
+				for (int i = 0; i < survivorCounts[c]; i++)
+				{
+					destination[i].bend = bends[kept[i]];
+				}
+			}
+		}
+	};
+
+	if (multithreaded)
+	{
+		parallelFor(candidateCount, compactCells, 16);
+	}
+
+	else
+	{
+		compactCells(0, candidateCount);
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+
+	lastStats.visibleCells = visibleCells;
+	lastStats.visibleBlades = total;
+	lastStats.milliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+
+	return total;
+}
+
+GrassCells::BenchmarkResult GrassCells::benchmark(int blades, int views)
+{
+	BenchmarkResult result = { 0, 0, 0.0f, 0.0f, 0.0f, 0.0f, true };
+
+	//One blade per square unit on flat ground, in eight unit cells
+	float world = sqrtf((float)blades);
+	GrassCells grass;
+
+	{
+		std::vector<GrassScatter::Instance> field;
+		GrassScatter::scatterJittered(HeightField(), world, 1.0f, 1, field);
+		grass.build(field, world, (int)(world / 8.0f));
+	}
+
+	result.blades = grass.getBladeCount();
+	result.cells = grass.getCellCount();
+
+	std::vector<GrassScatter::Instance> output(result.blades);
+
+	//A 1080p view with a 45 degree field of view, as the scene's projection
+	XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 200.0f);
+
+	CullSettings settings;
+	settings.amplitude = 10.0f;
+	settings.fadeStart = 20.0f;
+	settings.fadeEnd = 60.0f;
+	settings.backToFront = false;
+
+	float totalVisible = 0.0f;
+
+	for (int view = 0; view < views; view++)
+	{
+		//Standing on a ring around the field's centre, looking along the ground towards it
+		float angle = XM_2PI * (float)view / (float)views;
+		XMFLOAT3 eye((world * 0.5f) + (cosf(angle) * world * 0.3f), 2.0f, (world * 0.5f) + (sinf(angle) * world * 0.3f));
+		XMMATRIX viewMatrix = XMMatrixLookAtLH(XMVectorSet(eye.x, eye.y, eye.z, 1.0f), XMVectorSet(world * 0.5f, 0.0f, world * 0.5f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		Frustum frustum(viewMatrix * projection);
+
+		settings.cameraPosition = eye;
+		XMStoreFloat3(&settings.viewDirection, XMVector3Normalize(XMVectorSet((world * 0.5f) - eye.x, -eye.y, (world * 0.5f) - eye.z, 0.0f)));
+
+		//Each path's count and a sum of the kept positions, which must agree
+		int counts[3];
+		double checksums[3];
+		float* milliseconds[3] = { &result.scalarMilliseconds, &result.simdMilliseconds, &result.multithreadedMilliseconds };
+
+		for (int path = 0; path < 3; path++)
+		{
+			counts[path] = grass.cull(settings, frustum, output.data(), path > 0, path > 1);
+			*milliseconds[path] += grass.getLastStats().milliseconds;
+
+			checksums[path] = 0.0;
+
+			for (int i = 0; i < counts[path]; i++)
+			{
+				checksums[path] += (double)output[i].position.x + (double)output[i].position.z;
+			}
+		}
+
+		result.matches = result.matches && counts[0] == counts[1] && counts[0] == counts[2] && checksums[0] == checksums[1] && checksums[0] == checksums[2];
+		totalVisible += (float)counts[2];
+	}
+
+	if (views > 0)
+	{
+		result.scalarMilliseconds /= (float)views;
+		result.simdMilliseconds /= (float)views;
+		result.multithreadedMilliseconds /= (float)views;
+		result.averageVisible = totalVisible / (float)views;
+	}
+
+	return result;
+}
\ No newline at end of file
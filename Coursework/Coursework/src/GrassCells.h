@@ -0,0 +1,96 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+#include "DepthSort.h"
+#include "Frustum.h"
+#include "GrassScatter.h"
+
+using namespace DirectX;
+
+//Scattered grass sorted into a grid of cells over the terrain, so each frame only the blades of cells inside the view are
+//considered. Blades are thinned with distance by comparing a fixed per blade hash against the density, so a blade that
+//has faded out stays out as the camera backs away and nothing pops back in. The survivors are compacted into the instance buffer.
+class GrassCells
+{
+public:
+	struct CullSettings
+	{
+		XMFLOAT3 cameraPosition;	//In terrain space
+		float amplitude;
+		float fadeStart;			//Horizontal distance where thinning starts
+		float fadeEnd;				//Horizontal distance where the last blades are gone
+		XMFLOAT3 viewDirection;		//Normalised, only used to order the cells
+		bool backToFront;			//Writes the visible cells farthest first, for blending
+	};
+
+	struct CullStats
+	{
+		int visibleCells;
+		int visibleBlades;
+		float milliseconds;
+	};
+
+	struct BenchmarkResult
+	{
+		int blades;
+		int cells;
+		float scalarMilliseconds;			//One thread, one blade at a time
+		float simdMilliseconds;				//One thread, four blades at a time
+		float multithreadedMilliseconds;	//Every thread, four blades at a time
+		float averageVisible;
+		bool matches;						//Whether every path kept the same blades
+	};
+
+	GrassCells();
+	~GrassCells();
+
+	//Sorts the blades into cellsPerSide x cellsPerSide cells over a worldSize square
+	void build(const std::vector<GrassScatter::Instance>& blades, float worldSize, int cellsPerSide);
+
+	//Writes the blades in visible cells that survive thinning to output, which must have room for every blade. Returns the count.
+	//Packed bends, one for each blade in the cells' order, replace the instances' own. Sorting is by cell, the blades of a cell
+	//keep their order, so it is only back to front at the scale of the cells.
+	int cull(const CullSettings& settings, const Frustum& frustum, GrassScatter::Instance* output, bool simd = true, bool multithreaded = true, const uint32_t* bends = nullptr);
+
+	//Culls a jittered field of the given number of blades, one per square unit, from a ring of views with each of the paths
+	static BenchmarkResult benchmark(int blades, int views);
+
+	inline int getBladeCount() const { return (int)instances.size(); }
+	inline int getCellCount() const { return (int)cells.size(); }
+	inline const CullStats& getLastStats() const { return lastStats; }
+	inline const GrassScatter::Instance& getInstance(int index) const { return instances[index]; }
+	inline const std::vector<float>& getPositionX() const { return positionX; }
+	inline const std::vector<float>& getPositionZ() const { return positionZ; }
+
+private:
+	struct Cell
+	{
+		int first;			//Blades of a cell are contiguous
+		int count;
+		float minHeight;	//Normalised, like the blade heights
+		float maxHeight;
+		float maxScale;
+	};
+
+	//Thins one cell's blades into its own range of the survivor list, returning how many survived
+	int thinCell(const Cell& cell, const CullSettings& settings, bool simd);
+
+	std::vector<Cell> cells;
+	std::vector<GrassScatter::Instance> instances;	//Sorted by cell
+	std::vector<float> positionX;
+	std::vector<float> positionZ;
+	std::vector<float> thinning;					//Hash of each blade's position in the range [0,1)
+	std::vector<uint32_t> survivors;				//Blade indices, each cell writing from its first blade
+	std::vector<int> survivorCounts;				//For each cell, zero when it was culled
+	std::vector<int> candidates;					//Cells within the fade distance this frame
+	std::vector<int> offsets;						//Where each candidate's survivors start in the output
+	std::vector<float> candidateDepths;				//View depth of each candidate's centre
+	std::vector<int> sortedCandidates;
+	DepthSort depthSort;
+	float worldSize;
+	int cellsPerSide;
+	CullStats lastStats;
+};
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "GrassMesh.h"
+
+GrassMesh::GrassMesh(ID3D11Device* device) : instanceBuffer(nullptr), instanceCount(0), instanceCapacity(0)
+{
+	initBuffers(device);
+}
+
+GrassMesh::~GrassMesh()
+{
+	if (instanceBuffer)
+	{
+		instanceBuffer->Release();
+		instanceBuffer = 0;
+	}
+
+	// Run parent deconstructor
+	BaseMesh::~BaseMesh();
+}
+
+void GrassMesh::initBuffers(ID3D11Device* device)
+{
+	VertexType* vertices;
+	unsigned long* indices;
+	D3D11_BUFFER_DESC vertexBufferDesc, indexBufferDesc;
+	D3D11_SUBRESOURCE_DATA vertexData, indexData;
+
+	//Two quads, each with a front and a back face so back face culling leaves one of them
+	vertexCount = 16;
+	indexCount = 24;
+	vertices = new VertexType[vertexCount];
+	indices = new unsigned long[indexCount];
+
+	//The same two unit wide, two unit tall quad as the old billboards, standing on the instance's position
+	const XMFLOAT2 corners[4] = { XMFLOAT2(-1.0f, 0.0f), XMFLOAT2(-1.0f, 2.0f), XMFLOAT2(1.0f, 0.0f), XMFLOAT2(1.0f, 2.0f) };
+
+	for (int quad = 0; quad < 2; quad++)
+	{
+		//The first quad along x facing -z, the second along z facing x
+		XMFLOAT3 across = quad == 0 ? XMFLOAT3(1.0f, 0.0f, 0.0f) : XMFLOAT3(0.0f, 0.0f, 1.0f);
+		XMFLOAT3 facing = quad == 0 ? XMFLOAT3(0.0f, 0.0f, -1.0f) : XMFLOAT3(1.0f, 0.0f, 0.0f);
+
+		for (int side = 0; side < 2; side++)
+		{
+			int first = ((quad * 2) + side) * 4;
+			float sign = side == 0 ? 1.0f : -1.0f;
+
+			for (int i = 0; i < 4; i++)
+			{
+				VertexType& vertex = vertices[first + i];
+				vertex.position = XMFLOAT3(across.x * corners[i].x, corners[i].y, across.z * corners[i].x);
+				vertex.texture = XMFLOAT2((corners[i].x + 1.0f) * 0.5f, 1.0f - (corners[i].y * 0.5f));
+				vertex.normal = XMFLOAT3(facing.x * sign, 0.0f, facing.z * sign);
+			}
+
+			//Counter clockwise seen from the side the normal faces
+			int index = ((quad * 2) + side) * 6;
+
+			if (side == 0)
+			{
+				indices[index++] = first;
+				indices[index++] = first + 2;
+				indices[index++] = first + 1;
+				indices[index++] = first + 1;
+				indices[index++] = first + 2;
+				indices[index++] = first + 3;
+			}
+
+			else
+			{
+				indices[index++] = first;
+				indices[index++] = first + 1;
+				indices[index++] = first + 2;
+				indices[index++] = first + 1;
+				indices[index++] = first + 3;
+				indices[index++] = first + 2;
+			}
+		}
+	}
+
+	// Reorder for the post-transform cache, overdraw and vertex fetch, merging duplicate vertices.
+	MeshOptimiser::optimise("GrassMesh", vertices, vertexCount, indices, indexCount);
+
+	// Set up the description of the static vertex buffer.
+	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	vertexBufferDesc.ByteWidth = sizeof(VertexType) * vertexCount;
+	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	vertexBufferDesc.CPUAccessFlags = 0;
+	vertexBufferDesc.MiscFlags = 0;
+	vertexBufferDesc.StructureByteStride = 0;
+	// Give the subresource structure a pointer to the vertex data.
+	vertexData.pSysMem = vertices;
+	vertexData.SysMemPitch = 0;
+	vertexData.SysMemSlicePitch = 0;
+	// Now create the vertex buffer.
+	device->CreateBuffer(&vertexBufferDesc, &vertexData, &vertexBuffer);
+
+	// Set up the description of the static index buffer.
+	indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	indexBufferDesc.ByteWidth = sizeof(unsigned long) * indexCount;
+	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+	indexBufferDesc.CPUAccessFlags = 0;
+	indexBufferDesc.MiscFlags = 0;
+	indexBufferDesc.StructureByteStride = 0;
+	// Give the subresource structure a pointer to the index data.
+	indexData.pSysMem = indices;
+	indexData.SysMemPitch = 0;
+	indexData.SysMemSlicePitch = 0;
+	// Create the index buffer.
+	device->CreateBuffer(&indexBufferDesc, &indexData, &indexBuffer);
+
+	// Release the arrays now that the vertex and index buffers have been created and loaded.
+	delete[] vertices;
+	vertices = 0;
+	delete[] indices;
+	indices = 0;
+}
+
+void GrassMesh::createInstanceBuffer(ID3D11Device* device, int capacity)
+{
+	D3D11_BUFFER_DESC instanceBufferDesc;
+
+	if (instanceBuffer)
+	{
+		instanceBuffer->Release();
+		instanceBuffer = 0;
+	}
+
+	instanceCount = 0;
+	instanceCapacity = capacity;
+
+	if (instanceCapacity == 0)
+	{
+		return;
+	}
+
+	// Rewritten every frame with the visible blades.
+	instanceBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	instanceBufferDesc.ByteWidth = sizeof(GrassScatter::Instance) * instanceCapacity;
+	instanceBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	instanceBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	instanceBufferDesc.MiscFlags = 0;
+	instanceBufferDesc.StructureByteStride = 0;
+	device->CreateBuffer(&instanceBufferDesc, NULL, &instanceBuffer);
+}
+
+GrassScatter::Instance* GrassMesh::mapInstances(ID3D11DeviceContext* deviceContext)
+{
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+
+	if (!instanceBuffer)
+	{
+		return nullptr;
+	}
+
+	deviceContext->Map(instanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+
+	return (GrassScatter::Instance*)mappedResource.pData;
+}
+
+void GrassMesh::unmapInstances(ID3D11DeviceContext* deviceContext, int count)
+{
+	deviceContext->Unmap(instanceBuffer, 0);
+	instanceCount = count;
+}
+
+// Override sendData() to bind the instances to the second input slot.
+unsigned int GrassMesh::sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top)
+{
+	ID3D11Buffer* buffers[2] = { vertexBuffer, instanceBuffer };
+	unsigned int strides[2] = { sizeof(VertexType), sizeof(GrassScatter::Instance) };
+	unsigned int offsets[2] = { 0, 0 };
+
+	deviceContext->IASetVertexBuffers(0, 2, buffers, strides, offsets);
+	deviceContext->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	deviceContext->IASetPrimitiveTopology(top);
+
+	return strides[0];
+}
\ No newline at end of file
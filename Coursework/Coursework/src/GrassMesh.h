@@ -0,0 +1,37 @@
+#pragma once
+
+#include "DXF.h"
+#include "GrassScatter.h"
+
+#include <vector>
+
+using namespace DirectX;
+
+//One grass blade, two crossed quads that are lit from either side, drawn once for every scattered instance.
+//sendData() binds the instance buffer alongside the blade's vertices for GrassShader's instanced input layout. The instance
+//buffer is dynamic, refilled every frame with the blades that GrassCells keeps.
+class GrassMesh : public BaseMesh
+{
+public:
+	GrassMesh(ID3D11Device* device);
+	~GrassMesh();
+
+	//Replaces the instance buffer with one that can hold capacity blades
+	void createInstanceBuffer(ID3D11Device* device, int capacity);
+
+	//Maps the instance buffer for writing, then unmaps it with the number of blades that were written. Map returns null without a buffer.
+	GrassScatter::Instance* mapInstances(ID3D11DeviceContext* deviceContext);
+	void unmapInstances(ID3D11DeviceContext* deviceContext, int count);
+
+	unsigned int sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST) override;
+
+	inline int getInstanceCount() const { return instanceCount; }
+	inline int getInstanceCapacity() const { return instanceCapacity; }
+
+protected:
+	void initBuffers(ID3D11Device* device);
+
+	ID3D11Buffer* instanceBuffer;
+	int instanceCount;
+	int instanceCapacity;
+};
\ No newline at end of file
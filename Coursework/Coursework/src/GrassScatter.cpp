@@ -0,0 +1,214 @@
+#include "GrassScatter.h"
+#include "ParallelFor.h"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+
+//Position hash in the range [0,1), a different stream for each channel
+static float hashUnit(unsigned int x, unsigned int y, unsigned int seed, unsigned int channel)
+{
+	unsigned int h = (x * 374761393u) + (y * 668265263u) + (seed * 2246822519u) + (channel * 3266489917u);
+	h = (h ^ (h >> 13)) * 1274126177u;
+	h ^= h >> 16;
+
+	return (float)(h & 0xFFFFFF) / (float)0x1000000;
+}
+
+GrassScatter::Instance GrassScatter::makeInstance(const HeightField& heights, float worldSize, float x, float z, float scaleRandom, float rotationRandom)
+{
+	Instance instance;
+
+	//Without a heightmap the blades stand on the flat plane
+	float height = !heights.isEmpty() ? heights.sample(x / worldSize, z / worldSize) : 0.0f;
+
+	instance.position = XMFLOAT3(x, height, z);
+	instance.scale = 0.75f + (scaleRandom * 0.5f);
+	instance.rotation = rotationRandom * XM_2PI;
+	instance.bend = 0;
+
+	return instance;
+}
+
+void GrassScatter::scatterJittered(const HeightField& heights, float worldSize, float spacing, unsigned int seed, std::vector<Instance>& instances, bool multithreaded)
+{
+	int cells = (int)(worldSize / spacing);
+	instances.resize((size_t)cells * (size_t)cells);
+
+	auto scatterRows = [&](int begin, int end)
+	{
+		for (int j = begin; j < end; j++)
+		{
+			for (int i = 0; i < cells; i++)
+			{
+				float x = ((float)i + hashUnit(i, j, seed, 0)) * spacing;
+				float z = ((float)j + hashUnit(i, j, seed, 1)) * spacing;
+
+				instances[(j * cells) + i] = makeInstance(heights, worldSize, x, z, hashUnit(i, j, seed, 2), hashUnit(i, j, seed, 3));
+			}
+		}
+	};
+
+	if (multithreaded)
+	{
+		parallelFor(cells, scatterRows, 16);
+	}
+
+	else
+	{
+		scatterRows(0, cells);
+	}
+}
+
+void GrassScatter::scatterPoisson(const HeightField& heights, float worldSize, float spacing, unsigned int seed, std::vector<Instance>& instances, int attempts)
+{
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	//A cell's diagonal is the spacing, so no two blades can share one
+	float cellSize = spacing / sqrtf(2.0f);
+	int gridSide = (int)ceilf(worldSize / cellSize);
+	std::vector<int> grid((size_t)gridSide * (size_t)gridSide, -1);
+	std::vector<int> active;
+
+	instances.clear();
+
+	auto addBlade = [&](float x, float z)
+	{
+		int index = (int)instances.size();
+		instances.push_back(makeInstance(heights, worldSize, x, z, unit(generator), unit(generator)));
+		grid[((int)(z / cellSize) * gridSide) + (int)(x / cellSize)] = index;
+		active.push_back(index);
+	};
+
+	addBlade(unit(generator) * worldSize, unit(generator) * worldSize);
+
+	while (!active.empty())
+	{
+		int activeIndex = (int)(unit(generator) * (float)active.size());
+		activeIndex = activeIndex < (int)active.size() ? activeIndex : (int)active.size() - 1;
+		XMFLOAT3 centre = instances[active[activeIndex]].position;
+		bool placed = false;
+
+		for (int attempt = 0; attempt < attempts && !placed; attempt++)
+		{
+			//Uniform over the ring between one and two spacings from the centre
+			float angle = unit(generator) * XM_2PI;
+			float distance = spacing * sqrtf(1.0f + (unit(generator) * 3.0f));
+			float x = centre.x + (cosf(angle) * distance);
+			float z = centre.z + (sinf(angle) * distance);
+
+			if (x < 0.0f || z < 0.0f || x >= worldSize || z >= worldSize)
+			{
+				continue;
+			}
+
+			int cellX = (int)(x / cellSize);
+			int cellZ = (int)(z / cellSize);
+			bool clear = true;
+
+			//Blades closer than the spacing can only be within two cells either way
+			for (int gz = cellZ - 2; gz <= cellZ + 2 && clear; gz++)
+			{
+				for (int gx = cellX - 2; gx <= cellX + 2 && clear; gx++)
+				{
+					if (gx < 0 || gz < 0 || gx >= gridSide || gz >= gridSide)
+					{
+						continue;
+					}
+
+					int other = grid[(gz * gridSide) + gx];
+
+					if (other >= 0)
+					{
+						float dx = instances[other].position.x - x;
+						float dz = instances[other].position.z - z;
+						clear = ((dx * dx) + (dz * dz)) >= (spacing * spacing);
+					}
+				}
+			}
+
+			if (clear)
+			{
+				addBlade(x, z);
+				placed = true;
+			}
+		}
+
+		//A point with no room left around it stops growing
+		if (!placed)
+		{
+			active[activeIndex] = active.back();
+			active.pop_back();
+		}
+	}
+}
+
+GrassScatter::BenchmarkResult GrassScatter::benchmark(float worldSize, float spacing)
+{
+	BenchmarkResult result = { worldSize, spacing, 99 * 99 * 6, 0, 0.0f, 0.0f, 0, 0.0f, 0.0f };
+
+	HeightField heights;
+	heights.generateFractal(1024);
+
+	std::vector<Instance> instances;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	scatterJittered(heights, worldSize, spacing, 1, instances, false);
+	auto end = std::chrono::high_resolution_clock::now();
+	result.jitteredMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+	result.jitteredBlades = (int)instances.size();
+
+	start = std::chrono::high_resolution_clock::now();
+	scatterJittered(heights, worldSize, spacing, 1, instances, true);
+	end = std::chrono::high_resolution_clock::now();
+	result.multithreadedMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	scatterPoisson(heights, worldSize, spacing, 1, instances);
+	end = std::chrono::high_resolution_clock::now();
+	result.poissonMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+	result.poissonBlades = (int)instances.size();
+
+	//Closest pair, checking each blade against those in the neighbouring spacing sized buckets
+	int side = (int)ceilf(worldSize / spacing);
+	std::vector<std::vector<int>> buckets((size_t)side * (size_t)side);
+
+	for (int i = 0; i < (int)instances.size(); i++)
+	{
+		buckets[((int)(instances[i].position.z / spacing) * side) + (int)(instances[i].position.x / spacing)].push_back(i);
+	}
+
+	float minimumSquared = worldSize * worldSize;
+
+	for (int i = 0; i < (int)instances.size(); i++)
+	{
+		int bucketX = (int)(instances[i].position.x / spacing);
+		int bucketZ = (int)(instances[i].position.z / spacing);
+
+		for (int bz = bucketZ - 1; bz <= bucketZ + 1; bz++)
+		{
+			for (int bx = bucketX - 1; bx <= bucketX + 1; bx++)
+			{
+				if (bx < 0 || bz < 0 || bx >= side || bz >= side)
+				{
+					continue;
+				}
+
+				for (int other : buckets[(bz * side) + bx])
+				{
+					if (other != i)
+					{
+						float dx = instances[other].position.x - instances[i].position.x;
+						float dz = instances[other].position.z - instances[i].position.z;
+						minimumSquared = fminf(minimumSquared, (dx * dx) + (dz * dz));
+					}
+				}
+			}
+		}
+	}
+
+	result.poissonMinimumDistance = sqrtf(minimumSquared);
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+#include "HeightField.h"
+
+using namespace DirectX;
+
+//Places grass blades over the heightmap on the CPU, for drawing one shared blade mesh per instance. Jittered scattering puts
+//one blade at a random point of every grid cell, Poisson disc scattering keeps every pair of blades at least a distance apart.
+class GrassScatter
+{
+public:
+	//Per instance vertex data, matching the INSTANCE elements of GrassShader's input layout
+	struct Instance
+	{
+		XMFLOAT3 position;	//Terrain space, the height is normalised and scaled by the amplitude in the vertex shader
+		float scale;
+		float rotation;		//About the vertical axis, in radians
+		uint32_t bend;		//Wind bend as R16G16_SNORM, see GrassWind
+	};
+
+	struct BenchmarkResult
+	{
+		float worldSize;
+		float spacing;
+		int planeBlades;					//Points drawn through the geometry shader by the old PlaneMesh path
+		int jitteredBlades;
+		float jitteredMilliseconds;			//One thread
+		float multithreadedMilliseconds;	//Every thread
+		int poissonBlades;
+		float poissonMilliseconds;
+		float poissonMinimumDistance;		//Closest pair of Poisson blades, at least the spacing
+	};
+
+	//One blade in every spacing x spacing cell of a worldSize square. Each cell is hashed from its coordinates and the seed,
+	//so the rows can be scattered on any thread and the result is the same.
+	static void scatterJittered(const HeightField& heights, float worldSize, float spacing, unsigned int seed, std::vector<Instance>& instances, bool multithreaded = true);
+
+	//Bridson's algorithm, growing out from a random point with a background grid of cells that hold at most one blade
+	static void scatterPoisson(const HeightField& heights, float worldSize, float spacing, unsigned int seed, std::vector<Instance>& instances, int attempts = 30);
+
+	//Scatters over a generated 1024 heightmap with each of the methods
+	static BenchmarkResult benchmark(float worldSize, float spacing);
+
+private:
+	static Instance makeInstance(const HeightField& heights, float worldSize, float x, float z, float scaleRandom, float rotationRandom);
+};
\ No newline at end of file
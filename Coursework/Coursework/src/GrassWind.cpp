@@ -0,0 +1,282 @@
+#include "GrassWind.h"
+#include "ParallelFor.h"
+
+#include <chrono>
+#include <cmath>
+
+//Longest step a batch takes, so a batch that has waited several frames doesn't make the springs unstable
+static const float MAX_STEP = 1.0f / 30.0f;
+
+//Both components in [-1,1] as R16G16_SNORM, x in the low half
+static uint32_t packBend(float x, float z)
+{
+	int packedX = (int)floorf((x * 32767.0f) + 0.5f);
+	int packedZ = (int)floorf((z * 32767.0f) + 0.5f);
+
+	return ((uint32_t)packedX & 0xFFFF) | (((uint32_t)packedZ & 0xFFFF) << 16);
+}
+
+GrassWind::GrassWind() : nextBatch(0), lastBlades(0), lastMilliseconds(0.0f), nanosecondsPerBlade(0.0f)
+{
+
+}
+
+GrassWind::~GrassWind()
+{
+
+}
+
+void GrassWind::build(const GrassCells& cells)
+{
+	int count = cells.getBladeCount();
+
+	positionX = cells.getPositionX();
+	positionZ = cells.getPositionZ();
+	stiffness.resize(count);
+
+	//Taller blades are softer and sway further
+	for (int i = 0; i < count; i++)
+	{
+		stiffness[i] = 24.0f / cells.getInstance(i).scale;
+	}
+
+	bendX.assign(count, 0.0f);
+	bendZ.assign(count, 0.0f);
+	velocityX.assign(count, 0.0f);
+	velocityZ.assign(count, 0.0f);
+	packedBends.assign(count, 0);
+
+	batchTimes.assign((count + BATCH_SIZE - 1) / BATCH_SIZE, 0.0f);
+	nextBatch = 0;
+	nanosecondsPerBlade = 0.0f;
+}
+
+void GrassWind::simulate(int begin, int end, float time, float deltaTime, const Settings& settings, bool simd)
+{
+	//The gusts are two sine waves along the wind and a third across it, scrolling with time
+	float inverseScale = 1.0f / settings.gustScale;
+	float scroll = time * settings.gustSpeed;
+	int i = begin;
+
+	if (simd)
+	{
+		XMVECTOR directionX = XMVectorReplicate(settings.direction.x);
+		XMVECTOR directionZ = XMVectorReplicate(settings.direction.y);
+		XMVECTOR scale = XMVectorReplicate(inverseScale);
+		XMVECTOR offset = XMVectorReplicate(scroll);
+		XMVECTOR strength = XMVectorReplicate(settings.strength);
+		XMVECTOR damping = XMVectorReplicate(settings.damping);
+		XMVECTOR step = XMVectorReplicate(deltaTime);
+		XMVECTOR one = XMVectorSplatOne();
+		XMVECTOR minusOne = XMVectorNegate(one);
+		XMVECTOR base = XMVectorReplicate(0.55f);
+		XMVECTOR gustLarge = XMVectorReplicate(0.3f);
+		XMVECTOR gustSmall = XMVectorReplicate(0.15f);
+		XMVECTOR frequency = XMVectorReplicate(2.3f);
+		XMVECTOR acrossFrequency = XMVectorReplicate(1.7f);
+
+		for (; i + 4 <= end; i += 4)
+		{
+			XMVECTOR x = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&positionX[i]));
+			XMVECTOR z = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&positionZ[i]));
+
+			XMVECTOR along = XMVectorAdd(XMVectorMultiply(x, directionX), XMVectorMultiply(z, directionZ));
+			XMVECTOR across = XMVectorSubtract(XMVectorMultiply(z, directionX), XMVectorMultiply(x, directionZ));
+			XMVECTOR phase = XMVectorMultiply(XMVectorSubtract(along, offset), scale);
+			XMVECTOR crossPhase = XMVectorMultiply(XMVectorMultiply(across, scale), acrossFrequency);
+
+			XMVECTOR gust = XMVectorAdd(base, XMVectorMultiply(gustLarge, XMVectorSin(phase)));
+			gust = XMVectorAdd(gust, XMVectorMultiply(gustSmall, XMVectorSin(XMVectorAdd(XMVectorMultiply(phase, frequency), crossPhase))));
+			XMVECTOR force = XMVectorMultiply(strength, gust);
+
+			XMVECTOR k = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&stiffness[i]));
+			XMVECTOR bx = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&bendX[i]));
+			XMVECTOR bz = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&bendZ[i]));
+			XMVECTOR vx = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&velocityX[i]));
+			XMVECTOR vz = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&velocityZ[i]));
+
+			//Semi-implicit Euler, the velocity is updated first and moves the bend
+			XMVECTOR ax = XMVectorSubtract(XMVectorSubtract(XMVectorMultiply(force, directionX), XMVectorMultiply(k, bx)), XMVectorMultiply(damping, vx));
+			XMVECTOR az = XMVectorSubtract(XMVectorSubtract(XMVectorMultiply(force, directionZ), XMVectorMultiply(k, bz)), XMVectorMultiply(damping, vz));
+			vx = XMVectorAdd(vx, XMVectorMultiply(ax, step));
+			vz = XMVectorAdd(vz, XMVectorMultiply(az, step));
+			bx = XMVectorClamp(XMVectorAdd(bx, XMVectorMultiply(vx, step)), minusOne, one);
+			bz = XMVectorClamp(XMVectorAdd(bz, XMVectorMultiply(vz, step)), minusOne, one);
+
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&velocityX[i]), vx);
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&velocityZ[i]), vz);
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&bendX[i]), bx);
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&bendZ[i]), bz);
+
+			for (int lane = 0; lane < 4; lane++)
+			{
+				packedBends[i + lane] = packBend(bendX[i + lane], bendZ[i + lane]);
+			}
+		}
+	}
+
+	//Remaining blades that don't fill a group of four, or all of them for the scalar path
+	for (; i < end; i++)
+	{
+		float along = (positionX[i] * settings.direction.x) + (positionZ[i] * settings.direction.y);
+		float across = (positionZ[i] * settings.direction.x) - (positionX[i] * settings.direction.y);
+		float phase = (along - scroll) * inverseScale;
+		float crossPhase = (across * inverseScale) * 1.7f;
+
+		float gust = 0.55f + (0.3f * sinf(phase));
+		gust = gust + (0.15f * sinf((phase * 2.3f) + crossPhase));
+		float force = settings.strength * gust;
+
+		float ax = ((force * settings.direction.x) - (stiffness[i] * bendX[i])) - (settings.damping * velocityX[i]);
+		float az = ((force * settings.direction.y) - (stiffness[i] * bendZ[i])) - (settings.damping * velocityZ[i]);
+		velocityX[i] = velocityX[i] + (ax * deltaTime);
+		velocityZ[i] = velocityZ[i] + (az * deltaTime);
+		bendX[i] = fminf(fmaxf(bendX[i] + (velocityX[i] * deltaTime), -1.0f), 1.0f);
+		bendZ[i] = fminf(fmaxf(bendZ[i] + (velocityZ[i] * deltaTime), -1.0f), 1.0f);
+
+		packedBends[i] = packBend(bendX[i], bendZ[i]);
+	}
+}
+
+void GrassWind::update(float time, const Settings& settings, bool simd, bool multithreaded)
+{
+	int count = getBladeCount();
+	int batchCount = (int)batchTimes.size();
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	//As many batches as the last frames' cost says will fit, always at least one so every blade moves eventually
+	int batches = batchCount;
+
+	if (nanosecondsPerBlade > 0.0f)
+	{
+		batches = (int)((settings.budgetMilliseconds * 1000000.0f) / (nanosecondsPerBlade * (float)BATCH_SIZE));
+		batches = batches < 1 ? 1 : (batches > batchCount ? batchCount : batches);
+	}
+
+	auto simulateBatches = [&](int begin, int end)
+	{
+		for (int k = begin; k < end; k++)
+		{
+			int batch = (nextBatch + k) % batchCount;
+			float deltaTime = fminf(fmaxf(time - batchTimes[batch], 0.0f), MAX_STEP);
+			int first = batch * BATCH_SIZE;
+			int last = first + BATCH_SIZE < count ? first + BATCH_SIZE : count;
+
+			simulate(first, last, time, deltaTime, settings, simd);
+			batchTimes[batch] = time;
+		}
+	};
+
+	if (multithreaded)
+	{
+		parallelFor(batches, simulateBatches, 1);
+	}
+
+	else
+	{
+		simulateBatches(0, batches);
+	}
+
+	//Every batch is full apart from the last, which may have been one of them
+	int lastBatch = batchCount - 1;
+	bool includesLast = ((lastBatch - nextBatch + batchCount) % batchCount) < batches;
+	lastBlades = (batches * BATCH_SIZE) - (includesLast ? (batchCount * BATCH_SIZE) - count : 0);
+
+	nextBatch = (nextBatch + batches) % batchCount;
+
+	auto end = std::chrono::high_resolution_clock::now();
+
+	lastMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+
+	float nanoseconds = (lastMilliseconds * 1000000.0f) / (float)lastBlades;
+	nanosecondsPerBlade = nanosecondsPerBlade > 0.0f ? (nanosecondsPerBlade * 0.9f) + (nanoseconds * 0.1f) : nanoseconds;
+}
+
+GrassWind::BenchmarkResult GrassWind::benchmark(int blades, int steps)
+{
+	BenchmarkResult result = { 0, 0.0f, 0.0f, 0.0f, 0.0f };
+
+	//One blade per square unit on flat ground, as GrassCells::benchmark()
+	float world = sqrtf((float)blades);
+	GrassCells cells;
+
+	{
+		std::vector<GrassScatter::Instance> field;
+		GrassScatter::scatterJittered(HeightField(), world, 1.0f, 1, field);
+		cells.build(field, world, (int)(world / 8.0f));
+	}
+
+	GrassWind scalarWind, simdWind;
+	scalarWind.build(cells);
+	simdWind.build(cells);
+
+	int count = scalarWind.getBladeCount();
+	result.blades = count;
+
+	if (count == 0 || steps <= 0)
+	{
+		return result;
+	}
+
+	Settings settings = { XMFLOAT2(0.8f, 0.6f), 10.0f, 8.0f, 4.0f, 3.0f, 0.0f };
+	float deltaTime = 1.0f / 60.0f;
+	float scalarMilliseconds = 0.0f;
+	float simdMilliseconds = 0.0f;
+
+	for (int step = 0; step < steps; step++)
+	{
+		float time = (float)(step + 1) * deltaTime;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		scalarWind.simulate(0, count, time, deltaTime, settings, false);
+		auto end = std::chrono::high_resolution_clock::now();
+		scalarMilliseconds += std::chrono::duration<float, std::milli>(end - start).count();
+
+		start = std::chrono::high_resolution_clock::now();
+		simdWind.simulate(0, count, time, deltaTime, settings, true);
+		end = std::chrono::high_resolution_clock::now();
+		simdMilliseconds += std::chrono::duration<float, std::milli>(end - start).count();
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		result.maxDifference = fmaxf(result.maxDifference, fabsf(scalarWind.bendX[i] - simdWind.bendX[i]));
+		result.maxDifference = fmaxf(result.maxDifference, fabsf(scalarWind.bendZ[i] - simdWind.bendZ[i]));
+	}
+
+	//Whole batches across every thread, carrying on from the SIMD state
+	int batchCount = (int)simdWind.batchTimes.size();
+	float multithreadedMilliseconds = 0.0f;
+
+	for (int step = 0; step < steps; step++)
+	{
+		float time = (float)(steps + step + 1) * deltaTime;
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		parallelFor(batchCount, [&](int begin, int end)
+		{
+			for (int batch = begin; batch < end; batch++)
+			{
+				int first = batch * BATCH_SIZE;
+				simdWind.simulate(first, first + BATCH_SIZE < count ? first + BATCH_SIZE : count, time, deltaTime, settings, true);
+			}
+		}, 1);
+
+		auto end = std::chrono::high_resolution_clock::now();
+		multithreadedMilliseconds += std::chrono::duration<float, std::milli>(end - start).count();
+	}
+
+	float toNanoseconds = 1000000.0f / ((float)count * (float)steps);
+	result.scalarNanoseconds = scalarMilliseconds * toNanoseconds;
+	result.simdNanoseconds = simdMilliseconds * toNanoseconds;
+	result.multithreadedNanoseconds = multithreadedMilliseconds * toNanoseconds;
+
+	return result;
+}
\ No newline at end of file
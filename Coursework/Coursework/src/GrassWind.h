@@ -0,0 +1,74 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+#include "GrassCells.h"
+
+using namespace DirectX;
+
+//Bends the grass in the wind. Every blade is a damped spring pulled by a wind field that scrolls across the terrain, with the
+//state kept as structure of arrays and advanced four blades at a time. The bend is packed into two 16 bit normalised
+//components for the instance buffer. Blades are simulated in batches, round robin, with only as many batches each frame as fit
+//the time budget - a batch that waited catches up with a longer, clamped, step.
+class GrassWind
+{
+public:
+	struct Settings
+	{
+		XMFLOAT2 direction;		//Normalised, in terrain space
+		float strength;
+		float gustScale;		//Width of the gusts in world units
+		float gustSpeed;		//How fast the gusts scroll along the direction
+		float damping;
+		float budgetMilliseconds;
+	};
+
+	struct BenchmarkResult
+	{
+		int blades;
+		float scalarNanoseconds;			//Per blade per step, one thread, one blade at a time
+		float simdNanoseconds;				//One thread, four blades at a time
+		float multithreadedNanoseconds;		//Every thread, four blades at a time
+		float maxDifference;				//Largest bend difference between the scalar and SIMD paths after every step
+	};
+
+	GrassWind();
+	~GrassWind();
+
+	//Takes each blade's position and scale from the cells, in their sorted order, and puts every blade at rest
+	void build(const GrassCells& cells);
+
+	//Advances the batches that fit the budget to the given time, in seconds
+	void update(float time, const Settings& settings, bool simd = true, bool multithreaded = true);
+
+	//Simulates every blade from begin up to end by one step of deltaTime
+	void simulate(int begin, int end, float time, float deltaTime, const Settings& settings, bool simd);
+
+	//Times whole field steps of a jittered field of the given number of blades
+	static BenchmarkResult benchmark(int blades, int steps);
+
+	inline const uint32_t* getPackedBends() const { return packedBends.data(); }
+	inline int getBladeCount() const { return (int)positionX.size(); }
+	inline int getLastBlades() const { return lastBlades; }
+	inline float getLastMilliseconds() const { return lastMilliseconds; }
+	inline float getNanosecondsPerBlade() const { return nanosecondsPerBlade; }
+
+	static const int BATCH_SIZE = 4096;
+
+private:
+	std::vector<float> positionX;
+	std::vector<float> positionZ;
+	std::vector<float> stiffness;
+	std::vector<float> bendX;
+	std::vector<float> bendZ;
+	std::vector<float> velocityX;
+	std::vector<float> velocityZ;
+	std::vector<uint32_t> packedBends;	//R16G16_SNORM
+	std::vector<float> batchTimes;		//When each batch was last simulated
+	int nextBatch;
+	int lastBlades;
+	float lastMilliseconds;
+	float nanosecondsPerBlade;			//Running average of the wall clock cost, used to size the next frame's work
+};
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "HeightField.h"
+#include "ParallelFor.h"
+
+#include <cmath>
+
+HeightField::HeightField() : width(0), height(0)
+{
+
+}
+
+HeightField::HeightField(int fieldWidth, int fieldHeight)
+{
+	resize(fieldWidth, fieldHeight);
+}
+
+void HeightField::resize(int fieldWidth, int fieldHeight)
+{
+	width = fieldWidth;
+	height = fieldHeight;
+	heights.assign((size_t)width * (size_t)height, 0);
+}
+
+float HeightField::sample(float u, float v) const
+{
+	float x = (u * (float)width) - 0.5f;
+	float y = (v * (float)height) - 0.5f;
+	float x0 = floorf(x);
+	float y0 = floorf(y);
+	float fx = x - x0;
+	float fy = y - y0;
+	int ix = (int)x0;
+	int iy = (int)y0;
+
+	float top = load(ix, iy) + ((load(ix + 1, iy) - load(ix, iy)) * fx);
+	float bottom = load(ix, iy + 1) + ((load(ix + 1, iy + 1) - load(ix, iy + 1)) * fx);
+
+	return top + ((bottom - top) * fy);
+}
+
+void HeightField::applyBrush(int centreX, int centreY, int radius, float amount)
+{
+	int x0 = centreX - radius < 0 ? 0 : centreX - radius;
+	int y0 = centreY - radius < 0 ? 0 : centreY - radius;
+	int x1 = centreX + radius >= width ? width - 1 : centreX + radius;
+	int y1 = centreY + radius >= height ? height - 1 : centreY + radius;
+	float inverseRadius = 1.0f / (float)(radius > 0 ? radius : 1);
+
+	for (int y = y0; y <= y1; y++)
+	{
+		for (int x = x0; x <= x1; x++)
+		{
+			float dx = (float)(x - centreX) * inverseRadius;
+			float dy = (float)(y - centreY) * inverseRadius;
+			float distance = sqrtf((dx * dx) + (dy * dy));
+
+			if (distance < 1.0f)
+			{
+				//Smoothstep falloff, flat at the centre and meeting the untouched heights without a crease
+				float falloff = 1.0f - distance;
+				falloff = falloff * falloff * (3.0f - (2.0f * falloff));
+
+				setSample(x, y, getSample(x, y) + (amount * falloff));
+			}
+		}
+	}
+}
+
+//Position hash in the range (-1,1), so every point is displaced the same way whichever thread computes it
+static float hashNoise(unsigned int x, unsigned int y, unsigned int seed)
+{
+	unsigned int h = (x * 374761393u) + (y * 668265263u) + (seed * 2246822519u);
+	h = (h ^ (h >> 13)) * 1274126177u;
+	h ^= h >> 16;
+
+	return (((float)(h & 0xFFFFFF) / (float)0xFFFFFF) * 2.0f) - 1.0f;
+}
+
+void HeightField::generateFractal(int size, float roughness, unsigned int seed)
+{
+	resize(size, size);
+
+	int mask = size - 1;
+	float scale = 0.25f;
+
+	setSample(0, 0, 0.5f);
+
+	for (int step = size; step > 1; step /= 2)
+	{
+		int half = step / 2;
+		int rows = size / step;
+
+		//Diamond step, the centre of each square from its four corners
+		parallelFor(rows, [&](int begin, int end)
+		{
+			for (int row = begin; row < end; row++)
+			{
+				int y = row * step;
+
+				for (int x = 0; x < size; x += step)
+				{
+					float average = (getSample(x, y) + getSample((x + step) & mask, y) + getSample(x, (y + step) & mask) + getSample((x + step) & mask, (y + step) & mask)) * 0.25f;
+					setSample(x + half, y + half, average + (hashNoise(x + half, y + half, seed) * scale));
+				}
+			}
+		}, 16);
+
+		//Square step, the midpoint of each edge from the corners and centres either side of it
+		parallelFor(rows * 2, [&](int begin, int end)
+		{
+			for (int row = begin; row < end; row++)
+			{
+				int y = row * half;
+
+				for (int x = (row & 1) ? 0 : half; x < size; x += step)
+				{
+					float average = (getSample((x - half) & mask, y) + getSample((x + half) & mask, y) + getSample(x, (y - half) & mask) + getSample(x, (y + half) & mask)) * 0.25f;
+					setSample(x, y, average + (hashNoise(x, y, seed) * scale));
+				}
+			}
+		}, 16);
+
+		scale *= roughness;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+//CPU copy of a heightmap, heights are normalised to (0,1) and stored as 16 bit values so large maps stay affordable
+class HeightField
+{
+public:
+	HeightField();
+	HeightField(int width, int height);
+
+	void resize(int width, int height);
+
+	inline void setSample(int x, int y, float value) { heights[(y * width) + x] = (uint16_t)(((value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value)) * 65535.0f) + 0.5f); }
+	inline float getSample(int x, int y) const { return (float)heights[(y * width) + x] * (1.0f / 65535.0f); }
+
+	//Clamped to the edge texels
+	inline float load(int x, int y) const
+	{
+		x = x < 0 ? 0 : (x >= width ? width - 1 : x);
+		y = y < 0 ? 0 : (y >= height ? height - 1 : y);
+
+		return getSample(x, y);
+	}
+
+	//Bilinear sample with texel centres at (i + 0.5) / width, as the terrain shaders' linear sampler
+	float sample(float u, float v) const;
+
+	//Raises the heights within a radius of a texel by up to amount, with a smooth falloff to the edge. Negative amounts lower them.
+	void applyBrush(int centreX, int centreY, int radius, float amount);
+
+	//Wrapping diamond-square fractal terrain, used for benchmarking at sizes larger than the scene's heightmap.
+	//The size must be a power of two.
+	void generateFractal(int size, float roughness = 0.55f, unsigned int seed = 1802644);
+
+	inline int getWidth() const { return width; }
+	inline int getHeight() const { return height; }
+	inline bool isEmpty() const { return heights.empty(); }
+
+	inline uint16_t* getData() { return heights.data(); }
+	inline const uint16_t* getData() const { return heights.data(); }
+
+private:
+	int width;
+	int height;
+	std::vector<uint16_t> heights;
+};
\ No newline at end of file
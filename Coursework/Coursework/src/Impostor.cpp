@@ -0,0 +1,187 @@
+#include "Impostor.h"
+
+Impostor::Impostor() : stats({ 0, 0, 0.0f, 0.0f, 0.0f })
+{
+	atlas.framesPerSide = 0;
+	atlas.frameSize = 0;
+	atlas.centre = XMFLOAT3(0.0f, 0.0f, 0.0f);
+	atlas.radius = 0.0f;
+
+	for (int i = 0; i < ATLAS_COUNT; i++)
+	{
+		textures[i] = nullptr;
+		views[i] = nullptr;
+	}
+}
+
+Impostor::~Impostor()
+{
+	release();
+}
+
+void Impostor::release()
+{
+	for (int i = 0; i < ATLAS_COUNT; i++)
+	{
+		if (views[i])
+		{
+			views[i]->Release();
+			views[i] = nullptr;
+		}
+
+		if (textures[i])
+		{
+			textures[i]->Release();
+			textures[i] = nullptr;
+		}
+	}
+}
+
+bool Impostor::createTexture(ID3D11Device* device, AtlasTexture texture, DXGI_FORMAT format, const void* texels, int bytesPerTexel)
+{
+	D3D11_TEXTURE2D_DESC textureDesc;
+	D3D11_SUBRESOURCE_DATA textureData;
+	D3D11_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc;
+
+	int size = atlas.getSize();
+
+	ZeroMemory(&textureDesc, sizeof(textureDesc));
+	textureDesc.Width = size;
+	textureDesc.Height = size;
+	textureDesc.MipLevels = 1;
+	textureDesc.ArraySize = 1;
+	textureDesc.Format = format;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.Usage = D3D11_USAGE_IMMUTABLE;
+	textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+	textureData.pSysMem = texels;
+	textureData.SysMemPitch = size * bytesPerTexel;
+	textureData.SysMemSlicePitch = 0;
+
+	if (FAILED(device->CreateTexture2D(&textureDesc, &textureData, &textures[texture])))
+	{
+		return false;
+	}
+
+	shaderResourceViewDesc.Format = format;
+	shaderResourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+	shaderResourceViewDesc.Texture2D.MostDetailedMip = 0;
+	shaderResourceViewDesc.Texture2D.MipLevels = 1;
+
+	return SUCCEEDED(device->CreateShaderResourceView(textures[texture], &shaderResourceViewDesc, &views[texture]));
+}
+
+bool Impostor::bake(ID3D11Device* device, const std::vector<BaseMesh::VertexType>& vertices, const std::vector<unsigned long>& indices, const ImpostorBaker::Texture& albedo,
+	int framesPerSide, int frameSize, bool multithreaded)
+{
+	release();
+
+	if (vertices.empty() || indices.empty())
+	{
+		return false;
+	}
+
+	//The baker takes plain vertices, the mesh's are copied once per bake
+	std::vector<ImpostorBaker::Vertex> bakeVertices(vertices.size());
+
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		bakeVertices[i] = { vertices[i].position, vertices[i].normal, vertices[i].texture };
+	}
+
+	stats = ImpostorBaker::bake(bakeVertices.data(), (int)bakeVertices.size(), indices.data(), (int)indices.size(), albedo, framesPerSide, frameSize, atlas, multithreaded);
+
+	//Depth gets a channel of its own, so the normals keep the full eight bits
+	bool created = createTexture(device, ATLAS_ALBEDO, DXGI_FORMAT_R8G8B8A8_UNORM, atlas.albedo.data(), sizeof(uint32_t))
+		&& createTexture(device, ATLAS_NORMALS, DXGI_FORMAT_R8G8B8A8_UNORM, atlas.normals.data(), sizeof(uint32_t))
+		&& createTexture(device, ATLAS_DEPTH, DXGI_FORMAT_R16_UNORM, atlas.depth.data(), sizeof(uint16_t));
+
+	if (!created)
+	{
+		release();
+	}
+
+	return created;
+}
+
+bool Impostor::readTexture(ID3D11Device* device, ID3D11DeviceContext* deviceContext, ID3D11ShaderResourceView* texture, std::vector<uint32_t>& texels, int& width, int& height)
+{
+	ID3D11Resource* resource = nullptr;
+	ID3D11Texture2D* source = nullptr;
+	ID3D11Texture2D* stagingTexture = nullptr;
+	D3D11_TEXTURE2D_DESC textureDesc;
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+
+	if (!texture)
+	{
+		return false;
+	}
+
+	texture->GetResource(&resource);
+	HRESULT result = resource->QueryInterface(__uuidof(ID3D11Texture2D), (void**)&source);
+	resource->Release();
+
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	source->GetDesc(&textureDesc);
+
+	bool swapRedBlue = textureDesc.Format == DXGI_FORMAT_B8G8R8A8_UNORM || textureDesc.Format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+	bool supported = swapRedBlue || textureDesc.Format == DXGI_FORMAT_R8G8B8A8_UNORM || textureDesc.Format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+
+	if (!supported)
+	{
+		source->Release();
+		return false;
+	}
+
+	//A CPU readable copy of the top mip, as ChunkedTerrain reads the heightmap
+	textureDesc.MipLevels = 1;
+	textureDesc.ArraySize = 1;
+	textureDesc.Usage = D3D11_USAGE_STAGING;
+	textureDesc.BindFlags = 0;
+	textureDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+	textureDesc.MiscFlags = 0;
+
+	result = device->CreateTexture2D(&textureDesc, NULL, &stagingTexture);
+
+	if (FAILED(result))
+	{
+		source->Release();
+		return false;
+	}
+
+	deviceContext->CopySubresourceRegion(stagingTexture, 0, 0, 0, 0, source, 0, NULL);
+	source->Release();
+
+	result = deviceContext->Map(stagingTexture, 0, D3D11_MAP_READ, 0, &mappedResource);
+
+	if (FAILED(result))
+	{
+		stagingTexture->Release();
+		return false;
+	}
+
+	width = (int)textureDesc.Width;
+	height = (int)textureDesc.Height;
+	texels.resize((size_t)width * height);
+
+	for (int y = 0; y < height; y++)
+	{
+		const uint32_t* row = (const uint32_t*)((const unsigned char*)mappedResource.pData + ((size_t)y * mappedResource.RowPitch));
+
+		for (int x = 0; x < width; x++)
+		{
+			uint32_t texel = row[x];
+			texels[((size_t)y * width) + x] = swapRedBlue ? ((texel & 0xFF00FF00) | ((texel >> 16) & 0xFF) | ((texel & 0xFF) << 16)) : texel;
+		}
+	}
+
+	deviceContext->Unmap(stagingTexture, 0);
+	stagingTexture->Release();
+
+	return true;
+}
\ No newline at end of file
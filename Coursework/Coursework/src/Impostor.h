@@ -0,0 +1,44 @@
+#pragma once
+
+#include "DXF.h"
+#include "ImpostorBaker.h"
+
+#include <vector>
+
+//Octahedral impostor of a model. The atlas is baked on the CPU by ImpostorBaker and uploaded as albedo, normal and depth
+//textures for ImpostorShader, which draws it as a camera facing billboard in place of the model once it is small on screen.
+class Impostor
+{
+public:
+	enum AtlasTexture
+	{
+		ATLAS_ALBEDO,
+		ATLAS_NORMALS,
+		ATLAS_DEPTH,
+		ATLAS_COUNT
+	};
+
+	Impostor();
+	~Impostor();
+
+	//Bakes the mesh and replaces any atlas already uploaded
+	bool bake(ID3D11Device* device, const std::vector<BaseMesh::VertexType>& vertices, const std::vector<unsigned long>& indices, const ImpostorBaker::Texture& albedo,
+		int framesPerSide, int frameSize, bool multithreaded = true);
+
+	//Copies the top mip of an R8G8B8A8 or B8G8R8A8 texture back to the CPU as R8G8B8A8 texels, for the albedo of a bake
+	static bool readTexture(ID3D11Device* device, ID3D11DeviceContext* deviceContext, ID3D11ShaderResourceView* texture, std::vector<uint32_t>& texels, int& width, int& height);
+
+	inline ID3D11ShaderResourceView* getTexture(AtlasTexture texture) const { return views[texture]; }
+	inline const ImpostorBaker::Atlas& getAtlas() const { return atlas; }
+	inline const ImpostorBaker::BakeStats& getStats() const { return stats; }
+	inline bool isBaked() const { return views[ATLAS_ALBEDO] != nullptr; }
+
+private:
+	void release();
+	bool createTexture(ID3D11Device* device, AtlasTexture texture, DXGI_FORMAT format, const void* texels, int bytesPerTexel);
+
+	ImpostorBaker::Atlas atlas;
+	ImpostorBaker::BakeStats stats;
+	ID3D11Texture2D* textures[ATLAS_COUNT];
+	ID3D11ShaderResourceView* views[ATLAS_COUNT];
+};
\ No newline at end of file
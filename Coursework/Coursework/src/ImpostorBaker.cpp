@@ -0,0 +1,366 @@
+#include "ImpostorBaker.h"
+#include "GBufferEncoding.h"
+#include "ParallelFor.h"
+
+#include <chrono>
+#include <cmath>
+
+static inline float dot3(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return (a.x * b.x) + (a.y * b.y) + (a.z * b.z);
+}
+
+static inline uint32_t packUnorm(float r, float g, float b, float a)
+{
+	auto channel = [](float value)
+	{
+		return (uint32_t)((fminf(fmaxf(value, 0.0f), 1.0f) * 255.0f) + 0.5f);
+	};
+
+	return channel(r) | (channel(g) << 8) | (channel(b) << 16) | (channel(a) << 24);
+}
+
+XMFLOAT3 ImpostorBaker::getFrameDirection(int frameX, int frameY, int framesPerSide)
+{
+	//Frame centres are spread evenly over the (-1,1) square of the octahedral encoding
+	XMFLOAT2 encoded(((((float)frameX + 0.5f) / (float)framesPerSide) * 2.0f) - 1.0f, ((((float)frameY + 0.5f) / (float)framesPerSide) * 2.0f) - 1.0f);
+
+	return GBufferEncoding::decodeNormal(encoded);
+}
+
+void ImpostorBaker::getFrameAxes(const XMFLOAT3& direction, XMFLOAT3& right, XMFLOAT3& up)
+{
+	//Up stays vertical in the image, unless the view is from straight above or below
+	XMVECTOR worldUp = fabsf(direction.y) > 0.999f ? XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f) : XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+	XMVECTOR forward = XMVectorNegate(XMLoadFloat3(&direction));
+	XMVECTOR x = XMVector3Normalize(XMVector3Cross(worldUp, forward));
+
+	XMStoreFloat3(&right, x);
+	XMStoreFloat3(&up, XMVector3Cross(forward, x));
+}
+
+uint32_t ImpostorBaker::sampleTexture(const Texture& texture, float u, float v)
+{
+	if (!texture.texels)
+	{
+		return 0xFFFFFFFF;
+	}
+
+	//Bilinear with wrapping, texel centres at (i + 0.5) / width
+	float x = (u * (float)texture.width) - 0.5f;
+	float y = (v * (float)texture.height) - 0.5f;
+	float fx = x - floorf(x);
+	float fy = y - floorf(y);
+	int x0 = (int)floorf(x);
+	int y0 = (int)floorf(y);
+
+	auto wrap = [](int value, int size)
+	{
+		value %= size;
+		return value < 0 ? value + size : value;
+	};
+
+	int xs[2] = { wrap(x0, texture.width), wrap(x0 + 1, texture.width) };
+	int ys[2] = { wrap(y0, texture.height), wrap(y0 + 1, texture.height) };
+	float weights[4] = { (1.0f - fx) * (1.0f - fy), fx * (1.0f - fy), (1.0f - fx) * fy, fx * fy };
+	float colour[3] = { 0.0f, 0.0f, 0.0f };
+
+	for (int i = 0; i < 4; i++)
+	{
+		uint32_t texel = texture.texels[((size_t)ys[i / 2] * texture.width) + xs[i % 2]];
+
+		for (int channel = 0; channel < 3; channel++)
+		{
+			colour[channel] += (float)((texel >> (channel * 8)) & 0xFF) * weights[i];
+		}
+	}
+
+	return packUnorm(colour[0] / 255.0f, colour[1] / 255.0f, colour[2] / 255.0f, 1.0f);
+}
+
+void ImpostorBaker::bakeFrame(const Vertex* vertices, const unsigned long* indices, int indexCount, const Texture& albedo, Atlas& atlas, int frameX, int frameY,
+	std::vector<float>& depthBuffer)
+{
+	XMFLOAT3 direction = getFrameDirection(frameX, frameY, atlas.framesPerSide);
+	XMFLOAT3 right, up;
+	getFrameAxes(direction, right, up);
+
+	int size = atlas.frameSize;
+	int atlasSize = atlas.getSize();
+	float inverseRadius = 1.0f / atlas.radius;
+
+	//Anything on the mesh is within one radius of the centre, so this is behind all of it
+	depthBuffer.assign((size_t)size * size, -2.0f);
+
+	for (int triangle = 0; triangle + 2 < indexCount; triangle += 3)
+	{
+		const Vertex* corners[3] = { &vertices[indices[triangle]], &vertices[indices[triangle + 1]], &vertices[indices[triangle + 2]] };
+		float sx[3], sy[3], sz[3];
+
+		//Orthographic projection onto the frame, depth increasing towards the viewer
+		for (int i = 0; i < 3; i++)
+		{
+			XMFLOAT3 local(corners[i]->position.x - atlas.centre.x, corners[i]->position.y - atlas.centre.y, corners[i]->position.z - atlas.centre.z);
+			sx[i] = ((dot3(local, right) * inverseRadius * 0.5f) + 0.5f) * (float)size;
+			sy[i] = (0.5f - (dot3(local, up) * inverseRadius * 0.5f)) * (float)size;
+			sz[i] = dot3(local, direction) * inverseRadius;
+		}
+
+		float area = ((sx[1] - sx[0]) * (sy[2] - sy[0])) - ((sx[2] - sx[0]) * (sy[1] - sy[0]));
+
+		if (fabsf(area) < 1e-8f)
+		{
+			continue;
+		}
+
+		//Either winding is drawn, the depth test keeps the nearest surface
+		float inverseArea = 1.0f / area;
+		int minX = (int)fmaxf(floorf(fminf(fminf(sx[0], sx[1]), sx[2])), 0.0f);
+		int minY = (int)fmaxf(floorf(fminf(fminf(sy[0], sy[1]), sy[2])), 0.0f);
+		int maxX = (int)fminf(ceilf(fmaxf(fmaxf(sx[0], sx[1]), sx[2])), (float)(size - 1));
+		int maxY = (int)fminf(ceilf(fmaxf(fmaxf(sy[0], sy[1]), sy[2])), (float)(size - 1));
+
+		for (int py = minY; py <= maxY; py++)
+		{
+			float y = (float)py + 0.5f;
+
+			for (int px = minX; px <= maxX; px++)
+			{
+				float x = (float)px + 0.5f;
+
+				//Barycentric weights from the edge functions, all positive inside the triangle
+				float w0 = (((sx[2] - sx[1]) * (y - sy[1])) - ((sy[2] - sy[1]) * (x - sx[1]))) * inverseArea;
+				float w1 = (((sx[0] - sx[2]) * (y - sy[2])) - ((sy[0] - sy[2]) * (x - sx[2]))) * inverseArea;
+				float w2 = 1.0f - w0 - w1;
+
+				if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+				{
+					continue;
+				}
+
+				float z = (w0 * sz[0]) + (w1 * sz[1]) + (w2 * sz[2]);
+				float& nearest = depthBuffer[((size_t)py * size) + px];
+
+				if (z <= nearest)
+				{
+					continue;
+				}
+
+				nearest = z;
+
+				float u = (w0 * corners[0]->texture.x) + (w1 * corners[1]->texture.x) + (w2 * corners[2]->texture.x);
+				float v = (w0 * corners[0]->texture.y) + (w1 * corners[1]->texture.y) + (w2 * corners[2]->texture.y);
+				XMFLOAT3 normal((w0 * corners[0]->normal.x) + (w1 * corners[1]->normal.x) + (w2 * corners[2]->normal.x),
+					(w0 * corners[0]->normal.y) + (w1 * corners[1]->normal.y) + (w2 * corners[2]->normal.y),
+					(w0 * corners[0]->normal.z) + (w1 * corners[1]->normal.z) + (w2 * corners[2]->normal.z));
+				float length = sqrtf(dot3(normal, normal));
+				length = length > 0.0001f ? length : 1.0f;
+
+				size_t texel = ((size_t)((frameY * size) + py) * atlasSize) + (frameX * size) + px;
+				atlas.albedo[texel] = sampleTexture(albedo, u, v);
+				atlas.normals[texel] = packUnorm(((normal.x / length) * 0.5f) + 0.5f, ((normal.y / length) * 0.5f) + 0.5f, ((normal.z / length) * 0.5f) + 0.5f, 1.0f);
+				atlas.depth[texel] = (uint16_t)((fminf(fmaxf((z * 0.5f) + 0.5f, 0.0f), 1.0f) * 65535.0f) + 0.5f);
+			}
+		}
+	}
+
+	dilate(atlas, frameX, frameY);
+}
+
+//Spreads the colours and normals of the covered texels two texels out into the empty ones, with the alpha left at zero,
+//so filtering at the silhouette doesn't pull in black
+void ImpostorBaker::dilate(Atlas& atlas, int frameX, int frameY)
+{
+	int size = atlas.frameSize;
+	int atlasSize = atlas.getSize();
+	size_t first = ((size_t)(frameY * size) * atlasSize) + (frameX * size);
+
+	std::vector<uint8_t> filled((size_t)size * size);
+
+	for (int y = 0; y < size; y++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			filled[((size_t)y * size) + x] = (atlas.albedo[first + ((size_t)y * atlasSize) + x] >> 24) != 0;
+		}
+	}
+
+	const int offsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		std::vector<uint8_t> next = filled;
+
+		for (int y = 0; y < size; y++)
+		{
+			for (int x = 0; x < size; x++)
+			{
+				if (filled[((size_t)y * size) + x])
+				{
+					continue;
+				}
+
+				for (int i = 0; i < 4; i++)
+				{
+					int nx = x + offsets[i][0];
+					int ny = y + offsets[i][1];
+
+					if (nx < 0 || ny < 0 || nx >= size || ny >= size || !filled[((size_t)ny * size) + nx])
+					{
+						continue;
+					}
+
+					size_t source = first + ((size_t)ny * atlasSize) + nx;
+					size_t destination = first + ((size_t)y * atlasSize) + x;
+					atlas.albedo[destination] = atlas.albedo[source] & 0x00FFFFFF;
+					atlas.normals[destination] = atlas.normals[source] & 0x00FFFFFF;
+					next[((size_t)y * size) + x] = 1;
+					break;
+				}
+			}
+		}
+
+		filled.swap(next);
+	}
+}
+
+ImpostorBaker::BakeStats ImpostorBaker::bake(const Vertex* vertices, int vertexCount, const unsigned long* indices, int indexCount, const Texture& albedo,
+	int framesPerSide, int frameSize, Atlas& atlas, bool multithreaded)
+{
+	BakeStats stats = { framesPerSide * framesPerSide, indexCount / 3, 0.0f, 0.0f, 0.0f };
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	//Bounding sphere around the centre of the bounding box
+	XMFLOAT3 minimum(0.0f, 0.0f, 0.0f);
+	XMFLOAT3 maximum(0.0f, 0.0f, 0.0f);
+
+	for (int i = 0; i < vertexCount; i++)
+	{
+		const XMFLOAT3& position = vertices[i].position;
+		minimum = i == 0 ? position : XMFLOAT3(fminf(minimum.x, position.x), fminf(minimum.y, position.y), fminf(minimum.z, position.z));
+		maximum = i == 0 ? position : XMFLOAT3(fmaxf(maximum.x, position.x), fmaxf(maximum.y, position.y), fmaxf(maximum.z, position.z));
+	}
+
+	atlas.framesPerSide = framesPerSide;
+	atlas.frameSize = frameSize;
+	atlas.centre = XMFLOAT3((minimum.x + maximum.x) * 0.5f, (minimum.y + maximum.y) * 0.5f, (minimum.z + maximum.z) * 0.5f);
+	atlas.radius = 0.0f;
+
+	for (int i = 0; i < vertexCount; i++)
+	{
+		XMFLOAT3 offset(vertices[i].position.x - atlas.centre.x, vertices[i].position.y - atlas.centre.y, vertices[i].position.z - atlas.centre.z);
+		atlas.radius = fmaxf(atlas.radius, sqrtf(dot3(offset, offset)));
+	}
+
+	atlas.radius = atlas.radius > 0.0001f ? atlas.radius : 1.0f;
+
+	size_t texels = (size_t)atlas.getSize() * atlas.getSize();
+	atlas.albedo.assign(texels, 0);
+	atlas.normals.assign(texels, 0);
+	atlas.depth.assign(texels, 0);
+
+	//Frames write to their own squares of the atlas, each task with its own depth buffer
+	auto bakeFrames = [&](int begin, int end)
+	{
+		std::vector<float> depthBuffer;
+
+		for (int frame = begin; frame < end; frame++)
+		{
+			bakeFrame(vertices, indices, indexCount, albedo, atlas, frame % framesPerSide, frame / framesPerSide, depthBuffer);
+		}
+	};
+
+	if (multithreaded)
+	{
+		parallelFor(stats.frames, bakeFrames, 1);
+	}
+
+	else
+	{
+		bakeFrames(0, stats.frames);
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	stats.milliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+
+	size_t covered = 0;
+
+	for (uint32_t texel : atlas.albedo)
+	{
+		covered += (texel >> 24) != 0 ? 1 : 0;
+	}
+
+	stats.coverage = (float)covered / (float)texels;
+	stats.reprojectionError = measureReprojectionError(atlas);
+
+	return stats;
+}
+
+float ImpostorBaker::measureReprojectionError(const Atlas& atlas)
+{
+	int size = atlas.frameSize;
+	int atlasSize = atlas.getSize();
+	double totalError = 0.0;
+	size_t samples = 0;
+
+	for (int frameY = 0; frameY < atlas.framesPerSide; frameY++)
+	{
+		for (int frameX = 0; frameX + 1 < atlas.framesPerSide; frameX++)
+		{
+			XMFLOAT3 direction = getFrameDirection(frameX, frameY, atlas.framesPerSide);
+			XMFLOAT3 nextDirection = getFrameDirection(frameX + 1, frameY, atlas.framesPerSide);
+			XMFLOAT3 right, up, nextRight, nextUp;
+			getFrameAxes(direction, right, up);
+			getFrameAxes(nextDirection, nextRight, nextUp);
+
+			for (int py = 0; py < size; py++)
+			{
+				for (int px = 0; px < size; px++)
+				{
+					size_t texel = ((size_t)((frameY * size) + py) * atlasSize) + (frameX * size) + px;
+
+					if ((atlas.albedo[texel] >> 24) == 0)
+					{
+						continue;
+					}
+
+					//The point behind the texel, relative to the centre in units of the radius
+					float x = ((((float)px + 0.5f) / (float)size) * 2.0f) - 1.0f;
+					float y = 1.0f - ((((float)py + 0.5f) / (float)size) * 2.0f);
+					float z = (((float)atlas.depth[texel] / 65535.0f) * 2.0f) - 1.0f;
+					XMFLOAT3 point((x * right.x) + (y * up.x) + (z * direction.x), (x * right.y) + (y * up.y) + (z * direction.y), (x * right.z) + (y * up.z) + (z * direction.z));
+
+					int nx = (int)(((dot3(point, nextRight) * 0.5f) + 0.5f) * (float)size);
+					int ny = (int)((0.5f - (dot3(point, nextUp) * 0.5f)) * (float)size);
+
+					if (nx < 0 || ny < 0 || nx >= size || ny >= size)
+					{
+						continue;
+					}
+
+					size_t nextTexel = ((size_t)((frameY * size) + ny) * atlasSize) + ((frameX + 1) * size) + nx;
+
+					if ((atlas.albedo[nextTexel] >> 24) == 0)
+					{
+						continue;
+					}
+
+					//A much nearer depth is another surface hiding the point from the next frame, not an error
+					float nextZ = (((float)atlas.depth[nextTexel] / 65535.0f) * 2.0f) - 1.0f;
+					float difference = nextZ - dot3(point, nextDirection);
+
+					if (difference > 0.1f)
+					{
+						continue;
+					}
+
+					totalError += fabsf(difference) * atlas.radius;
+					samples++;
+				}
+			}
+		}
+	}
+
+	return samples > 0 ? (float)(totalError / (double)samples) : 0.0f;
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+using namespace DirectX;
+
+//Bakes a mesh into an octahedral impostor atlas with a CPU rasterizer, so it needs no device and the result can be checked
+//anywhere. It takes plain vertices and fills arrays on the CPU, uploading the atlas is left to the caller (see Impostor). The
+//directions of the atlas' frames are spread over the sphere by the octahedral mapping of GBufferEncoding, each frame is an
+//orthographic view of the mesh's bounding sphere looking back at its centre from that direction. Must match impostor.hlsli.
+class ImpostorBaker
+{
+public:
+	struct Vertex
+	{
+		XMFLOAT3 position;
+		XMFLOAT3 normal;
+		XMFLOAT2 texture;
+	};
+
+	//Albedo source, R8G8B8A8_UNORM texels, sampled with wrapping by the mesh's texture coordinates
+	struct Texture
+	{
+		int width;
+		int height;
+		const uint32_t* texels;		//Null bakes a white albedo
+	};
+
+	struct Atlas
+	{
+		int framesPerSide;
+		int frameSize;				//Texels across each frame
+		XMFLOAT3 centre;			//Bounding sphere of the mesh, in model space
+		float radius;
+		std::vector<uint32_t> albedo;	//R8G8B8A8_UNORM, alpha is coverage
+		std::vector<uint32_t> normals;	//R8G8B8A8_UNORM, model space normals scaled into (0,1)
+		std::vector<uint16_t> depth;	//R16_UNORM, distance towards the viewer from the plane through the centre, over the diameter
+
+		inline int getSize() const { return framesPerSide * frameSize; }
+	};
+
+	struct BakeStats
+	{
+		int frames;
+		int triangles;
+		float milliseconds;
+		float coverage;				//Fraction of the atlas' texels the mesh covers
+		float reprojectionError;	//Mean depth difference, in model units, where neighbouring frames see the same point
+	};
+
+	//Rasterizes every frame of the atlas, a frame per task when multithreaded
+	static BakeStats bake(const Vertex* vertices, int vertexCount, const unsigned long* indices, int indexCount, const Texture& albedo, int framesPerSide,
+		int frameSize, Atlas& atlas, bool multithreaded = true);
+
+	//View direction of a frame, from the centre towards the viewer
+	static XMFLOAT3 getFrameDirection(int frameX, int frameY, int framesPerSide);
+
+	//Axes of the frame's image plane for a view direction, x to the right and y up
+	static void getFrameAxes(const XMFLOAT3& direction, XMFLOAT3& right, XMFLOAT3& up);
+
+	//Rebuilds the points behind covered texels from their depth and looks them up in the next frame along, where both frames
+	//cover the point the depths should agree
+	static float measureReprojectionError(const Atlas& atlas);
+
+private:
+	static void bakeFrame(const Vertex* vertices, const unsigned long* indices, int indexCount, const Texture& albedo, Atlas& atlas, int frameX, int frameY,
+		std::vector<float>& depthBuffer);
+	static uint32_t sampleTexture(const Texture& texture, float u, float v);
+	static void dilate(Atlas& atlas, int frameX, int frameY);
+};
\ No newline at end of file
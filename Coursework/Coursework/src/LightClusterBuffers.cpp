@@ -0,0 +1,109 @@
+#include "LightClusterBuffers.h"
+
+#include <cstring>
+
+LightClusterBuffers::LightClusterBuffers(ID3D11Device* device, float width, float height)
+{
+	sliceScale = 0.0f;
+	sliceBias = 0.0f;
+	screenWidth = width;
+	screenHeight = height;
+
+	lightBuffer = nullptr;
+	clusterBuffer = nullptr;
+	indexBuffer = nullptr;
+	lightSRV = nullptr;
+	clusterSRV = nullptr;
+	indexSRV = nullptr;
+
+	D3D11_BUFFER_DESC bufferDesc;
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+
+	// Dynamic structured buffers, rewritten by the CPU every frame.
+	bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	bufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+
+	srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+	srvDesc.Buffer.FirstElement = 0;
+
+	bufferDesc.ByteWidth = sizeof(LightSystem::PackedLight) * LightClusters::MAX_LIGHTS;
+	bufferDesc.StructureByteStride = sizeof(LightSystem::PackedLight);
+	device->CreateBuffer(&bufferDesc, NULL, &lightBuffer);
+	srvDesc.Buffer.NumElements = LightClusters::MAX_LIGHTS;
+	device->CreateShaderResourceView(lightBuffer, &srvDesc, &lightSRV);
+
+	bufferDesc.ByteWidth = sizeof(LightClusters::ClusterRange) * LightClusters::CLUSTER_COUNT;
+	bufferDesc.StructureByteStride = sizeof(LightClusters::ClusterRange);
+	device->CreateBuffer(&bufferDesc, NULL, &clusterBuffer);
+	srvDesc.Buffer.NumElements = LightClusters::CLUSTER_COUNT;
+	device->CreateShaderResourceView(clusterBuffer, &srvDesc, &clusterSRV);
+
+	bufferDesc.ByteWidth = sizeof(unsigned int) * LightClusters::MAX_LIGHT_INDICES;
+	bufferDesc.StructureByteStride = sizeof(unsigned int);
+	device->CreateBuffer(&bufferDesc, NULL, &indexBuffer);
+	srvDesc.Buffer.NumElements = LightClusters::MAX_LIGHT_INDICES;
+	device->CreateShaderResourceView(indexBuffer, &srvDesc, &indexSRV);
+}
+
+LightClusterBuffers::~LightClusterBuffers()
+{
+	if (lightSRV)
+	{
+		lightSRV->Release();
+		lightSRV = 0;
+	}
+
+	if (clusterSRV)
+	{
+		clusterSRV->Release();
+		clusterSRV = 0;
+	}
+
+	if (indexSRV)
+	{
+		indexSRV->Release();
+		indexSRV = 0;
+	}
+
+	if (lightBuffer)
+	{
+		lightBuffer->Release();
+		lightBuffer = 0;
+	}
+
+	if (clusterBuffer)
+	{
+		clusterBuffer->Release();
+		clusterBuffer = 0;
+	}
+
+	if (indexBuffer)
+	{
+		indexBuffer->Release();
+		indexBuffer = 0;
+	}
+}
+
+void LightClusterBuffers::upload(ID3D11DeviceContext* deviceContext, const LightClusters& clusters, const LightSystem& lights, const std::vector<unsigned int>& visible)
+{
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+
+	//Packed straight from the light arrays into the mapped buffer, in the same order as the cluster indices
+	deviceContext->Map(lightBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	lights.pack((LightSystem::PackedLight*)mappedResource.pData, visible, clusters.getStats().lightCount);
+	deviceContext->Unmap(lightBuffer, 0);
+
+	deviceContext->Map(clusterBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	memcpy(mappedResource.pData, clusters.getClusterRanges().data(), sizeof(LightClusters::ClusterRange) * LightClusters::CLUSTER_COUNT);
+	deviceContext->Unmap(clusterBuffer, 0);
+
+	deviceContext->Map(indexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	memcpy(mappedResource.pData, clusters.getLightIndices().data(), sizeof(unsigned int) * clusters.getLightIndices().size());
+	deviceContext->Unmap(indexBuffer, 0);
+
+	sliceScale = clusters.getSliceScale();
+	sliceBias = clusters.getSliceBias();
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <d3d11.h>
+#include <vector>
+
+#include "LightClusters.h"
+
+//GPU side of clustered shading - the structured buffers light_ps.hlsl reads the visible lights, each cluster's range
+//and the light index list from, rewritten every frame from a LightClusters build
+class LightClusterBuffers
+{
+public:
+	LightClusterBuffers(ID3D11Device* device, float screenWidth, float screenHeight);
+	~LightClusterBuffers();
+
+	//Packs the lights in the same order as the cluster indices, visible must be the list the clusters were built from
+	void upload(ID3D11DeviceContext* deviceContext, const LightClusters& clusters, const LightSystem& lights, const std::vector<unsigned int>& visible);
+
+	inline ID3D11ShaderResourceView* getLightSRV() const { return lightSRV; }
+	inline ID3D11ShaderResourceView* getClusterSRV() const { return clusterSRV; }
+	inline ID3D11ShaderResourceView* getIndexSRV() const { return indexSRV; }
+
+	//Slice parameters of the last upload, for mapping pixel depth to a cluster
+	inline float getSliceScale() const { return sliceScale; }
+	inline float getSliceBias() const { return sliceBias; }
+	inline float getScreenWidth() const { return screenWidth; }
+	inline float getScreenHeight() const { return screenHeight; }
+
+private:
+	float sliceScale;
+	float sliceBias;
+	float screenWidth;
+	float screenHeight;
+
+	ID3D11Buffer* lightBuffer;
+	ID3D11Buffer* clusterBuffer;
+	ID3D11Buffer* indexBuffer;
+	ID3D11ShaderResourceView* lightSRV;
+	ID3D11ShaderResourceView* clusterSRV;
+	ID3D11ShaderResourceView* indexSRV;
+};
\ No newline at end of file
@@ -0,0 +1,296 @@
+#include "LightClusters.h"
+#include "ParallelFor.h"
+
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+LightClusters::LightClusters()
+{
+	memset(&boundsProjection, 0, sizeof(boundsProjection));
+	boundsNear = 0.0f;
+	boundsFar = 0.0f;
+
+	stats = { 0.0f, 0, 0, 0, false };
+	sliceScale = 0.0f;
+	sliceBias = 0.0f;
+
+	clusterMin.resize(CLUSTER_COUNT);
+	clusterMax.resize(CLUSTER_COUNT);
+	clusterRanges.resize(CLUSTER_COUNT);
+	sliceIndices.resize(CLUSTERS_Z);
+}
+
+LightClusters::~LightClusters()
+{
+}
+
+//View space bounding box of every cluster, from the tile corners on the far plane pushed out to each slice's near and far depth
+void LightClusters::buildClusterBounds(const XMMATRIX& projection, float nearZ, float farZ)
+{
+	XMMATRIX inverseProjection = XMMatrixInverse(nullptr, projection);
+
+	//Depth slices are spaced exponentially, so each cluster is roughly as deep as it is wide
+	sliceScale = (float)CLUSTERS_Z / logf(farZ / nearZ);
+	sliceBias = -((float)CLUSTERS_Z * logf(nearZ)) / logf(farZ / nearZ);
+
+	for (int z = 0; z < CLUSTERS_Z; z++)
+	{
+		float sliceNear = nearZ * powf(farZ / nearZ, (float)z / (float)CLUSTERS_Z);
+		float sliceFar = nearZ * powf(farZ / nearZ, (float)(z + 1) / (float)CLUSTERS_Z);
+
+		for (int y = 0; y < CLUSTERS_Y; y++)
+		{
+			for (int x = 0; x < CLUSTERS_X; x++)
+			{
+				XMVECTOR minimum = XMVectorReplicate(FLT_MAX);
+				XMVECTOR maximum = XMVectorReplicate(-FLT_MAX);
+
+				for (int corner = 0; corner < 4; corner++)
+				{
+					//Screen y runs down, normalised device y runs up
+					float ndcX = -1.0f + ((2.0f * (float)(x + (corner & 1))) / (float)CLUSTERS_X);
+					float ndcY = 1.0f - ((2.0f * (float)(y + (corner >> 1))) / (float)CLUSTERS_Y);
+
+					XMVECTOR point = XMVector3TransformCoord(XMVectorSet(ndcX, ndcY, 1.0f, 1.0f), inverseProjection);
+					float pointDepth = XMVectorGetZ(point);
+
+					XMVECTOR nearPoint = XMVectorScale(point, sliceNear / pointDepth);
+					XMVECTOR farPoint = XMVectorScale(point, sliceFar / pointDepth);
+
+					minimum = XMVectorMin(minimum, XMVectorMin(nearPoint, farPoint));
+					maximum = XMVectorMax(maximum, XMVectorMax(nearPoint, farPoint));
+				}
+
+				int index = x + (CLUSTERS_X * (y + (CLUSTERS_Y * z)));
+				XMStoreFloat3(&clusterMin[index], minimum);
+				XMStoreFloat3(&clusterMax[index], maximum);
+			}
+		}
+	}
+
+	XMStoreFloat4x4(&boundsProjection, projection);
+	boundsNear = nearZ;
+	boundsFar = farZ;
+}
+
+void LightClusters::transformLights(const LightSystem& lights, const std::vector<unsigned int>& visible, const XMMATRIX& view, int begin, int end)
+{
+	for (int i = begin; i < end; i++)
+	{
+		unsigned int light = visible[i];
+
+		XMFLOAT3 viewPosition;
+		XMStoreFloat3(&viewPosition, XMVector3TransformCoord(XMVectorSet(lights.getPositionX()[light], lights.getPositionY()[light], lights.getPositionZ()[light], 1.0f), view));
+		XMStoreFloat3(&lightDirection[i], XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&lights.getDirections()[light]), view)));
+
+		lightX[i] = viewPosition.x;
+		lightY[i] = viewPosition.y;
+		lightZ[i] = viewPosition.z;
+		lightRange[i] = lights.getRanges()[light];
+		lightSpotCosine[i] = lights.getSpotCosines()[light];
+	}
+}
+
+//Assigns lights to every cluster of one depth slice, four lights are tested against each cluster box at a time
+void LightClusters::assignSlice(int slice, std::vector<unsigned int>& indices, std::vector<unsigned int>& candidates)
+{
+	indices.clear();
+	candidates.clear();
+
+	int firstCluster = slice * CLUSTERS_X * CLUSTERS_Y;
+	float sliceNear = clusterMin[firstCluster].z;
+	float sliceFar = clusterMax[firstCluster].z;
+
+	for (unsigned int i = 0; i < (unsigned int)lightX.size(); i++)
+	{
+		if (lightZ[i] + lightRange[i] >= sliceNear && lightZ[i] - lightRange[i] <= sliceFar)
+		{
+			candidates.push_back(i);
+		}
+	}
+
+	//Gather the candidates into padded arrays so they can be loaded four at a time
+	int candidateCount = (int)candidates.size();
+	int paddedCount = (candidateCount + 3) & ~3;
+	std::vector<float> x(paddedCount, 0.0f), y(paddedCount, 0.0f), z(paddedCount, 0.0f), radiusSquared(paddedCount, -1.0f);
+
+	for (int i = 0; i < candidateCount; i++)
+	{
+		x[i] = lightX[candidates[i]];
+		y[i] = lightY[candidates[i]];
+		z[i] = lightZ[candidates[i]];
+		radiusSquared[i] = lightRange[candidates[i]] * lightRange[candidates[i]];
+	}
+
+	XMVECTOR zero = XMVectorZero();
+
+	for (int cluster = firstCluster; cluster < firstCluster + (CLUSTERS_X * CLUSTERS_Y); cluster++)
+	{
+		clusterRanges[cluster].offset = (unsigned int)indices.size();
+
+		XMVECTOR minX = XMVectorReplicate(clusterMin[cluster].x);
+		XMVECTOR minY = XMVectorReplicate(clusterMin[cluster].y);
+		XMVECTOR minZ = XMVectorReplicate(clusterMin[cluster].z);
+		XMVECTOR maxX = XMVectorReplicate(clusterMax[cluster].x);
+		XMVECTOR maxY = XMVectorReplicate(clusterMax[cluster].y);
+		XMVECTOR maxZ = XMVectorReplicate(clusterMax[cluster].z);
+
+		//Bounding sphere of the cluster, for the spotlight cone test
+		XMVECTOR boxMin = XMLoadFloat3(&clusterMin[cluster]);
+		XMVECTOR boxMax = XMLoadFloat3(&clusterMax[cluster]);
+		XMVECTOR sphereCentre = XMVectorScale(XMVectorAdd(boxMin, boxMax), 0.5f);
+		float sphereRadius = XMVectorGetX(XMVector3Length(XMVectorSubtract(boxMax, sphereCentre)));
+
+		for (int i = 0; i < paddedCount; i += 4)
+		{
+			XMVECTOR cx = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&x[i]));
+			XMVECTOR cy = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&y[i]));
+			XMVECTOR cz = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&z[i]));
+			XMVECTOR r2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&radiusSquared[i]));
+
+			//Distance from each sphere centre to the box, zero on an axis where the centre lies inside the box
+			XMVECTOR dx = XMVectorMax(zero, XMVectorMax(XMVectorSubtract(minX, cx), XMVectorSubtract(cx, maxX)));
+			XMVECTOR dy = XMVectorMax(zero, XMVectorMax(XMVectorSubtract(minY, cy), XMVectorSubtract(cy, maxY)));
+			XMVECTOR dz = XMVectorMax(zero, XMVectorMax(XMVectorSubtract(minZ, cz), XMVectorSubtract(cz, maxZ)));
+			XMVECTOR distanceSquared = XMVectorMultiplyAdd(dx, dx, XMVectorMultiplyAdd(dy, dy, XMVectorMultiply(dz, dz)));
+
+			uint32_t overlaps[4];
+			XMStoreInt4(overlaps, XMVectorLessOrEqual(distanceSquared, r2));
+
+			for (int lane = 0; lane < 4; lane++)
+			{
+				if (!overlaps[lane])
+				{
+					continue;
+				}
+
+				unsigned int light = candidates[i + lane];
+
+				if (lightSpotCosine[light] > -1.0f)
+				{
+					//Cone against the cluster's bounding sphere
+					XMVECTOR toCluster = XMVectorSubtract(sphereCentre, XMVectorSet(lightX[light], lightY[light], lightZ[light], 0.0f));
+					float lengthSquared = XMVectorGetX(XMVector3LengthSq(toCluster));
+					float alongAxis = XMVectorGetX(XMVector3Dot(toCluster, XMLoadFloat3(&lightDirection[light])));
+					float spotSine = sqrtf(1.0f - (lightSpotCosine[light] * lightSpotCosine[light]));
+					float closestDistance = (lightSpotCosine[light] * sqrtf(fmaxf(lengthSquared - (alongAxis * alongAxis), 0.0f))) - (alongAxis * spotSine);
+
+					if (closestDistance > sphereRadius || alongAxis < -sphereRadius || alongAxis > sphereRadius + lightRange[light])
+					{
+						continue;
+					}
+				}
+
+				indices.push_back(light);
+			}
+		}
+
+		clusterRanges[cluster].count = (unsigned int)indices.size() - clusterRanges[cluster].offset;
+	}
+}
+
+void LightClusters::build(const LightSystem& lights, const std::vector<unsigned int>& visible, const XMMATRIX& view, const XMMATRIX& projection, float nearZ, float farZ, bool multithreaded)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	XMFLOAT4X4 currentProjection;
+	XMStoreFloat4x4(&currentProjection, projection);
+
+	if (memcmp(&currentProjection, &boundsProjection, sizeof(XMFLOAT4X4)) != 0 || nearZ != boundsNear || farZ != boundsFar)
+	{
+		buildClusterBounds(projection, nearZ, farZ);
+	}
+
+	int lightCount = (int)visible.size() < MAX_LIGHTS ? (int)visible.size() : MAX_LIGHTS;
+
+	lightX.resize(lightCount);
+	lightY.resize(lightCount);
+	lightZ.resize(lightCount);
+	lightRange.resize(lightCount);
+	lightDirection.resize(lightCount);
+	lightSpotCosine.resize(lightCount);
+
+	if (multithreaded)
+	{
+		parallelFor(lightCount, [&](int begin, int end) { transformLights(lights, visible, view, begin, end); }, 256);
+
+		parallelFor(CLUSTERS_Z, [&](int begin, int end)
+		{
+			std::vector<unsigned int> candidates;
+
+			for (int slice = begin; slice < end; slice++)
+			{
+				assignSlice(slice, sliceIndices[slice], candidates);
+			}
+		});
+	}
+
+	else
+	{
+		std::vector<unsigned int> candidates;
+		transformLights(lights, visible, view, 0, lightCount);
+
+		for (int slice = 0; slice < CLUSTERS_Z; slice++)
+		{
+			assignSlice(slice, sliceIndices[slice], candidates);
+		}
+	}
+
+	//Join the slice lists into one compact index list, slice offsets are relative until now
+	lightIndices.clear();
+	stats.maxLightsPerCluster = 0;
+	stats.truncated = false;
+
+	for (int slice = 0; slice < CLUSTERS_Z; slice++)
+	{
+		unsigned int sliceOffset = (unsigned int)lightIndices.size();
+		unsigned int available = MAX_LIGHT_INDICES - sliceOffset;
+		unsigned int sliceCount = (unsigned int)sliceIndices[slice].size();
+
+		if (sliceCount > available)
+		{
+			sliceCount = available;
+			stats.truncated = true;
+		}
+
+		lightIndices.insert(lightIndices.end(), sliceIndices[slice].begin(), sliceIndices[slice].begin() + sliceCount);
+
+		for (int cluster = slice * CLUSTERS_X * CLUSTERS_Y; cluster < (slice + 1) * CLUSTERS_X * CLUSTERS_Y; cluster++)
+		{
+			ClusterRange& range = clusterRanges[cluster];
+
+			if (range.offset + range.count > sliceCount)
+			{
+				range.count = range.offset < sliceCount ? sliceCount - range.offset : 0;
+			}
+
+			range.offset += sliceOffset;
+
+			if ((int)range.count > stats.maxLightsPerCluster)
+			{
+				stats.maxLightsPerCluster = (int)range.count;
+			}
+		}
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+
+	stats.buildMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+	stats.lightCount = lightCount;
+	stats.indexCount = (int)lightIndices.size();
+}
+
+float LightClusters::benchmark(const LightSystem& lights, const std::vector<unsigned int>& visible, const XMMATRIX& view, const XMMATRIX& projection, float nearZ, float farZ, bool multithreaded, int iterations)
+{
+	float total = 0.0f;
+
+	for (int i = 0; i < iterations; i++)
+	{
+		build(lights, visible, view, projection, nearZ, farZ, multithreaded);
+		total += stats.buildMilliseconds;
+	}
+
+	return total / (float)iterations;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+
+#include "LightSystem.h"
+
+using namespace DirectX;
+
+//Clustered forward shading - splits the view frustum into a grid of clusters, with exponentially spaced depth slices,
+//and builds a compact list of the point and spot lights touching each cluster for light_ps.hlsl to loop over.
+//LightClusterBuffers sends the lists to the GPU.
+class LightClusters
+{
+public:
+	//Must match light_ps.hlsl
+	static const int CLUSTERS_X = 16;
+	static const int CLUSTERS_Y = 9;
+	static const int CLUSTERS_Z = 24;
+	static const int CLUSTER_COUNT = CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z;
+	static const int MAX_LIGHTS = 4096;
+	static const int MAX_LIGHT_INDICES = CLUSTER_COUNT * 128;
+
+	struct ClusterRange
+	{
+		unsigned int offset;
+		unsigned int count;
+	};
+
+	struct BuildStats
+	{
+		float buildMilliseconds;
+		int lightCount;
+		int indexCount;
+		int maxLightsPerCluster;
+		bool truncated;		//More light indices than MAX_LIGHT_INDICES, the furthest clusters lose their lights
+	};
+
+	LightClusters();
+	~LightClusters();
+
+	//Clusters the listed lights, usually the ones left after frustum culling. Index lists refer to positions in this list.
+	void build(const LightSystem& lights, const std::vector<unsigned int>& visible, const XMMATRIX& view, const XMMATRIX& projection, float nearZ, float farZ, bool multithreaded = true);
+
+	//Average build time in milliseconds over a number of runs
+	float benchmark(const LightSystem& lights, const std::vector<unsigned int>& visible, const XMMATRIX& view, const XMMATRIX& projection, float nearZ, float farZ, bool multithreaded, int iterations);
+
+	inline const std::vector<ClusterRange>& getClusterRanges() const { return clusterRanges; }
+	inline const std::vector<unsigned int>& getLightIndices() const { return lightIndices; }
+	inline const BuildStats& getStats() const { return stats; }
+
+	inline float getSliceScale() const { return sliceScale; }
+	inline float getSliceBias() const { return sliceBias; }
+
+private:
+	void buildClusterBounds(const XMMATRIX& projection, float nearZ, float farZ);
+	void transformLights(const LightSystem& lights, const std::vector<unsigned int>& visible, const XMMATRIX& view, int begin, int end);
+	void assignSlice(int slice, std::vector<unsigned int>& indices, std::vector<unsigned int>& candidates);
+
+	//Cluster bounds in view space, rebuilt whenever the projection changes
+	std::vector<XMFLOAT3> clusterMin;
+	std::vector<XMFLOAT3> clusterMax;
+	XMFLOAT4X4 boundsProjection;
+	float boundsNear;
+	float boundsFar;
+
+	//View space lights, stored as separate arrays so four lights can be tested at once
+	std::vector<float> lightX;
+	std::vector<float> lightY;
+	std::vector<float> lightZ;
+	std::vector<float> lightRange;
+	std::vector<XMFLOAT3> lightDirection;
+	std::vector<float> lightSpotCosine;
+
+	std::vector<ClusterRange> clusterRanges;
+	std::vector<unsigned int> lightIndices;
+	std::vector<std::vector<unsigned int>> sliceIndices;
+
+	BuildStats stats;
+	float sliceScale;
+	float sliceBias;
+};
\ No newline at end of file
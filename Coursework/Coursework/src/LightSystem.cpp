@@ -0,0 +1,138 @@
+#include "LightSystem.h"
+
+#include <cmath>
+#include <random>
+
+LightSystem::LightSystem()
+{
+
+}
+
+LightSystem::~LightSystem()
+{
+
+}
+
+int LightSystem::add(XMFLOAT3 position, XMFLOAT3 direction, float range, float spotCosine, XMFLOAT4 colour, LightKind kind)
+{
+	positionX.push_back(position.x);
+	positionY.push_back(position.y);
+	positionZ.push_back(position.z);
+	ranges.push_back(range);
+	enabledMask.push_back(0xFFFFFFFF);
+
+	directions.push_back(direction);
+	spotCosines.push_back(spotCosine);
+	colours.push_back(colour);
+	kinds.push_back((uint8_t)kind);
+
+	return (int)positionX.size() - 1;
+}
+
+int LightSystem::addPointLight(XMFLOAT3 position, float range, XMFLOAT4 colour)
+{
+	return add(position, XMFLOAT3(0.0f, -1.0f, 0.0f), range, -1.0f, colour, KIND_POINT);
+}
+
+int LightSystem::addSpotLight(XMFLOAT3 position, XMFLOAT3 direction, float range, float spotCosine, XMFLOAT4 colour)
+{
+	return add(position, direction, range, spotCosine, colour, KIND_SPOT);
+}
+
+//Scatters point lights and downward facing spotlights through a box, half of each
+void LightSystem::addRandomLights(int count, XMFLOAT3 minimum, XMFLOAT3 maximum, unsigned int seed)
+{
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	for (int i = 0; i < count; i++)
+	{
+		XMFLOAT3 position(minimum.x + ((maximum.x - minimum.x) * unit(generator)),
+			minimum.y + ((maximum.y - minimum.y) * unit(generator)),
+			minimum.z + ((maximum.z - minimum.z) * unit(generator)));
+		float range = 3.0f + (5.0f * unit(generator));
+		float spotCosine = 0.8f + (0.15f * unit(generator));
+
+		//Bright, saturated colours so individual lights are easy to pick out
+		float hue = unit(generator) * 6.0f;
+		float r = fminf(fmaxf(fabsf(hue - 3.0f) - 1.0f, 0.0f), 1.0f);
+		float g = fminf(fmaxf(2.0f - fabsf(hue - 2.0f), 0.0f), 1.0f);
+		float b = fminf(fmaxf(2.0f - fabsf(hue - 4.0f), 0.0f), 1.0f);
+		float intensity = 4.0f;
+		XMFLOAT4 colour(r * intensity, g * intensity, b * intensity, 1.0f);
+
+		if (i & 1)
+		{
+			addSpotLight(position, XMFLOAT3(0.0f, -1.0f, 0.0f), range, spotCosine, colour);
+		}
+
+		else
+		{
+			addPointLight(position, range, colour);
+		}
+	}
+}
+
+void LightSystem::clear()
+{
+	positionX.clear();
+	positionY.clear();
+	positionZ.clear();
+	ranges.clear();
+	enabledMask.clear();
+	directions.clear();
+	spotCosines.clear();
+	colours.clear();
+	kinds.clear();
+}
+
+void LightSystem::cull(const Frustum& frustum, std::vector<unsigned int>& visible) const
+{
+	visible.clear();
+
+	int count = getCount();
+	int i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		XMVECTOR x = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&positionX[i]));
+		XMVECTOR y = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&positionY[i]));
+		XMVECTOR z = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&positionZ[i]));
+		XMVECTOR r = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&ranges[i]));
+		XMVECTOR enabled = XMLoadInt4(&enabledMask[i]);
+
+		uint32_t result[4];
+		XMStoreInt4(result, XMVectorAndInt(frustum.spheresVisible(x, y, z, r), enabled));
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			if (result[lane])
+			{
+				visible.push_back(i + lane);
+			}
+		}
+	}
+
+	//Remaining lights that don't fill a group of four
+	for (; i < count; i++)
+	{
+		if (enabledMask[i] && frustum.sphereVisible(XMFLOAT3(positionX[i], positionY[i], positionZ[i]), ranges[i]))
+		{
+			visible.push_back(i);
+		}
+	}
+}
+
+void LightSystem::pack(PackedLight* destination, const std::vector<unsigned int>& indices, int count) const
+{
+	for (int i = 0; i < count; i++)
+	{
+		unsigned int light = indices[i];
+
+		destination[i].position = XMFLOAT3(positionX[light], positionY[light], positionZ[light]);
+		destination[i].range = ranges[light];
+		destination[i].direction = directions[light];
+		destination[i].spotCosine = spotCosines[light];
+		destination[i].colour = colours[light];
+	}
+}
\ No newline at end of file
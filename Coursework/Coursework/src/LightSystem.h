@@ -0,0 +1,75 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+#include "Frustum.h"
+
+using namespace DirectX;
+
+//Structure of arrays storage for the unshadowed point and spot lights, so culling and buffer packing walk contiguous memory
+//rather than a heap allocated object per light
+class LightSystem
+{
+public:
+	enum LightKind
+	{
+		KIND_POINT = 0,
+		KIND_SPOT = 1
+	};
+
+	//Matches the ClusterLight structured buffer in light_ps.hlsl
+	struct PackedLight
+	{
+		XMFLOAT3 position;
+		float range;
+		XMFLOAT3 direction;
+		float spotCosine;	//Cosine of the cone's half angle, -1.0f for point lights
+		XMFLOAT4 colour;
+	};
+
+	LightSystem();
+	~LightSystem();
+
+	int addPointLight(XMFLOAT3 position, float range, XMFLOAT4 colour);
+	int addSpotLight(XMFLOAT3 position, XMFLOAT3 direction, float range, float spotCosine, XMFLOAT4 colour);
+	void addRandomLights(int count, XMFLOAT3 minimum, XMFLOAT3 maximum, unsigned int seed = 1802644);
+	void clear();
+
+	inline void setEnabled(int index, bool enable) { enabledMask[index] = enable ? 0xFFFFFFFF : 0; }
+	inline bool isEnabled(int index) const { return enabledMask[index] != 0; }
+
+	//Writes the indices of enabled lights whose range spheres touch the frustum
+	void cull(const Frustum& frustum, std::vector<unsigned int>& visible) const;
+
+	//Packs the given lights, in order, straight into a mapped GPU buffer
+	void pack(PackedLight* destination, const std::vector<unsigned int>& indices, int count) const;
+
+	inline int getCount() const { return (int)positionX.size(); }
+
+	inline const float* getPositionX() const { return positionX.data(); }
+	inline const float* getPositionY() const { return positionY.data(); }
+	inline const float* getPositionZ() const { return positionZ.data(); }
+	inline const float* getRanges() const { return ranges.data(); }
+	inline const XMFLOAT3* getDirections() const { return directions.data(); }
+	inline const float* getSpotCosines() const { return spotCosines.data(); }
+	inline const XMFLOAT4* getColours() const { return colours.data(); }
+	inline const uint8_t* getKinds() const { return kinds.data(); }
+
+private:
+	int add(XMFLOAT3 position, XMFLOAT3 direction, float range, float spotCosine, XMFLOAT4 colour, LightKind kind);
+
+	//Hot data read by culling and clustering
+	std::vector<float> positionX;
+	std::vector<float> positionY;
+	std::vector<float> positionZ;
+	std::vector<float> ranges;
+	std::vector<uint32_t> enabledMask;	//All bits set when enabled, so it can be and-ed with a comparison result
+
+	//Cold data only read when packing
+	std::vector<XMFLOAT3> directions;
+	std::vector<float> spotCosines;
+	std::vector<XMFLOAT4> colours;
+	std::vector<uint8_t> kinds;
+};
\ No newline at end of file
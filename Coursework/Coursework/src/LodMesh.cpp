@@ -0,0 +1,140 @@
+#include "LodMesh.h"
+
+#include <chrono>
+#include <string>
+
+LodMesh::LodMesh(ID3D11Device* device, const std::vector<VertexType>& modelVertices, const std::vector<unsigned long>& modelIndices, const std::vector<float>& ratios,
+	bool multithreaded, bool compactNormals) : vertices(modelVertices), indices(modelIndices), packCompactNormals(compactNormals)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	std::vector<MeshSimplifier::Level> levels = MeshSimplifier::buildChain(getPositions(vertices), indices, ratios, multithreaded);
+	buildMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	levelStarts.push_back(0);
+	levelCounts.push_back((int)indices.size());
+	levelErrors.push_back(0.0f);
+
+	for (MeshSimplifier::Level& simplified : levels)
+	{
+		//The levels share the model's vertices, which AModel has already put in fetch order, so only their triangles are reordered
+		int levelVertexCount = (int)vertices.size();
+		MeshOptimiser::optimise("LodMesh level " + std::to_string(levelStarts.size()), vertices.data(), levelVertexCount, simplified.indices.data(),
+			(int)simplified.indices.size(), false);
+
+		levelStarts.push_back((int)indices.size());
+		levelCounts.push_back((int)simplified.indices.size());
+		levelErrors.push_back(simplified.error);
+		indices.insert(indices.end(), simplified.indices.begin(), simplified.indices.end());
+	}
+
+	std::vector<int> levelTriangles;
+
+	for (int count : levelCounts)
+	{
+		levelTriangles.push_back(count / 3);
+	}
+
+	selector.setLevelTriangles(levelTriangles);
+	initBuffers(device);
+	setLevel(0);
+}
+
+LodMesh::~LodMesh()
+{
+	// Run parent deconstructor
+	BaseMesh::~BaseMesh();
+}
+
+std::vector<XMFLOAT3> LodMesh::getPositions(const std::vector<VertexType>& modelVertices)
+{
+	std::vector<XMFLOAT3> positions(modelVertices.size());
+
+	for (size_t i = 0; i < modelVertices.size(); i++)
+	{
+		positions[i] = modelVertices[i].position;
+	}
+
+	return positions;
+}
+
+void LodMesh::initBuffers(ID3D11Device* device)
+{
+	D3D11_BUFFER_DESC vertexBufferDesc, indexBufferDesc;
+	D3D11_SUBRESOURCE_DATA vertexData, indexData;
+
+	vertexCount = (int)vertices.size();
+
+	// Set up the description of the static vertex buffer.
+	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	vertexBufferDesc.ByteWidth = sizeof(VertexType) * vertexCount;
+	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	vertexBufferDesc.CPUAccessFlags = 0;
+	vertexBufferDesc.MiscFlags = 0;
+	vertexBufferDesc.StructureByteStride = 0;
+	// Give the subresource structure a pointer to the vertex data.
+	vertexData.pSysMem = vertices.data();
+	vertexData.SysMemPitch = 0;
+	vertexData.SysMemSlicePitch = 0;
+	// Now create the vertex buffer.
+	device->CreateBuffer(&vertexBufferDesc, &vertexData, &vertexBuffer);
+	createPackedVertices(device, vertices.data(), vertexCount, packCompactNormals);
+	createPositionStreams(device, vertices.data(), vertexCount);
+
+	// Set up the description of the static index buffer, holding every level.
+	indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	indexBufferDesc.ByteWidth = sizeof(unsigned long) * (UINT)indices.size();
+	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+	indexBufferDesc.CPUAccessFlags = 0;
+	indexBufferDesc.MiscFlags = 0;
+	indexBufferDesc.StructureByteStride = 0;
+	// Give the subresource structure a pointer to the index data.
+	indexData.pSysMem = indices.data();
+	indexData.SysMemPitch = 0;
+	indexData.SysMemSlicePitch = 0;
+	// Create the index buffer.
+	device->CreateBuffer(&indexBufferDesc, &indexData, &indexBuffer);
+
+	// Release the arrays now that the vertex and index buffers have been created and loaded.
+	std::vector<VertexType>().swap(vertices);
+	std::vector<unsigned long>().swap(indices);
+}
+
+// Override sendData() to start the index buffer at the selected level.
+unsigned int LodMesh::sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top)
+{
+	unsigned int stride = getVertexStride();
+	unsigned int offset = 0;
+
+	deviceContext->IASetVertexBuffers(0, 1, isDrawingPacked() ? &packedVertexBuffer : &vertexBuffer, &stride, &offset);
+	deviceContext->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, (UINT)(levelStarts[selector.getLevel()] * sizeof(unsigned long)));
+	deviceContext->IASetPrimitiveTopology(top);
+
+	return stride;
+}
+
+// Override sendPositionData() the same way, binding the position and texture coordinate streams.
+unsigned int LodMesh::sendPositionData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top)
+{
+	ID3D11Buffer* buffers[2] = { positionBuffer, texCoordBuffer };
+	unsigned int strides[2] = { sizeof(XMFLOAT3), sizeof(XMFLOAT2) };
+	unsigned int offsets[2] = { 0, 0 };
+
+	deviceContext->IASetVertexBuffers(0, 2, buffers, strides, offsets);
+	deviceContext->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, (UINT)(levelStarts[selector.getLevel()] * sizeof(unsigned long)));
+	deviceContext->IASetPrimitiveTopology(top);
+
+	return strides[0] + strides[1];
+}
+
+void LodMesh::setLevel(int newLevel)
+{
+	selector.setLevel(newLevel);
+	indexCount = levelCounts[selector.getLevel()];
+}
+
+int LodMesh::selectLevel(float screenPixels, float fullDetailPixels, float hysteresis)
+{
+	setLevel(selector.selectLevel(screenPixels, fullDetailPixels, hysteresis));
+
+	return selector.getLevel();
+}
\ No newline at end of file
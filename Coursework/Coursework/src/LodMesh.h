@@ -0,0 +1,53 @@
+#pragma once
+
+#include "DXF.h"
+#include "LodSelector.h"
+#include "MeshSimplifier.h"
+
+#include <vector>
+
+using namespace DirectX;
+
+//An imported model with a chain of simplified levels, built by MeshSimplifier when it is loaded. Every level shares the model's
+//vertices and their indices are packed one after another into a single index buffer, so switching level only moves where
+//sendData() binds the index buffer from.
+class LodMesh : public BaseMesh
+{
+public:
+	//Level 0 is the model itself, followed by a level for each fraction of its triangles. A packed copy of the vertices is uploaded
+	//too, with the normals compact or not, for drawing with setDrawPacked().
+	LodMesh(ID3D11Device* device, const std::vector<VertexType>& modelVertices, const std::vector<unsigned long>& modelIndices, const std::vector<float>& ratios,
+		bool multithreaded = true, bool compactNormals = false);
+	~LodMesh();
+
+	//Binds the index buffer from the selected level's first index, getIndexCount() is the level's own count
+	unsigned int sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST) override;
+	unsigned int sendPositionData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST) override;
+
+	//Picks the level for the model's height on screen, see LodSelector
+	int selectLevel(float screenPixels, float fullDetailPixels, float hysteresis);
+	void setLevel(int level);
+
+	inline float getSwitchPixels(int level, float fullDetailPixels) const { return selector.getSwitchPixels(level, fullDetailPixels); }
+
+	inline int getLevel() const { return selector.getLevel(); }
+	inline int getLevelCount() const { return selector.getLevelCount(); }
+	inline int getLevelTriangles(int level) const { return selector.getLevelTriangles(level); }
+	inline float getLevelError(int level) const { return levelErrors[level]; }
+	inline float getBuildMilliseconds() const { return buildMilliseconds; }
+
+	//The positions of a model's vertices, which is all MeshSimplifier reads
+	static std::vector<XMFLOAT3> getPositions(const std::vector<VertexType>& modelVertices);
+
+protected:
+	void initBuffers(ID3D11Device* device);
+
+	std::vector<VertexType> vertices;
+	std::vector<unsigned long> indices;	//Every level's, released once uploaded
+	std::vector<int> levelStarts;
+	std::vector<int> levelCounts;
+	std::vector<float> levelErrors;
+	LodSelector selector;
+	float buildMilliseconds;
+	bool packCompactNormals;
+};
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "LodSelector.h"
+
+#include <cmath>
+
+LodSelector::LodSelector() : level(0)
+{
+
+}
+
+void LodSelector::setLevelTriangles(const std::vector<int>& triangles)
+{
+	levelTriangles = triangles;
+	level = 0;
+}
+
+void LodSelector::setLevel(int newLevel)
+{
+	level = newLevel < 0 ? 0 : (newLevel >= getLevelCount() ? getLevelCount() - 1 : newLevel);
+}
+
+float LodSelector::getSwitchPixels(int switchLevel, float fullDetailPixels) const
+{
+	//Triangles per pixel stay the same while the height on screen shrinks by the square root of the triangles kept
+	return fullDetailPixels * sqrtf((float)levelTriangles[switchLevel] / (float)levelTriangles[0]);
+}
+
+int LodSelector::selectLevel(float screenPixels, float fullDetailPixels, float hysteresis)
+{
+	int selected = level;
+
+	//Coarser once the size has dropped the band below the next level's switch, finer once it has climbed the band above this one's
+	while (selected + 1 < getLevelCount() && screenPixels < getSwitchPixels(selected + 1, fullDetailPixels) * (1.0f - hysteresis))
+	{
+		selected++;
+	}
+
+	while (selected > 0 && screenPixels > getSwitchPixels(selected, fullDetailPixels) * (1.0f + hysteresis))
+	{
+		selected--;
+	}
+
+	setLevel(selected);
+
+	return level;
+}
\ No newline at end of file
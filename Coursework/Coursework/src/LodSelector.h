@@ -0,0 +1,28 @@
+#pragma once
+
+#include <vector>
+
+//Picks a level of a LodMesh's chain for the model's height on screen. Each level takes over below the size where its triangles
+//are as big on screen as the full model's are at fullDetailPixels, and only changes once the size is past that switch by the
+//hysteresis fraction, so a model hovering at a switch doesn't flicker between levels. Kept apart from LodMesh so it builds without Direct3D.
+class LodSelector
+{
+public:
+	LodSelector();
+
+	//Triangles of each level, level 0 being the full model. Goes back to level 0.
+	void setLevelTriangles(const std::vector<int>& triangles);
+
+	int selectLevel(float screenPixels, float fullDetailPixels, float hysteresis);
+	void setLevel(int level);
+
+	float getSwitchPixels(int level, float fullDetailPixels) const;
+
+	inline int getLevel() const { return level; }
+	inline int getLevelCount() const { return (int)levelTriangles.size(); }
+	inline int getLevelTriangles(int level) const { return levelTriangles[level]; }
+
+private:
+	std::vector<int> levelTriangles;
+	int level;
+};
\ No newline at end of file
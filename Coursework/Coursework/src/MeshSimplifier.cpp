@@ -0,0 +1,854 @@
+#include "MeshSimplifier.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+static inline XMFLOAT3 sub3(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+static inline float dot3(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return (a.x * b.x) + (a.y * b.y) + (a.z * b.z);
+}
+
+static inline XMFLOAT3 cross3(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return XMFLOAT3((a.y * b.z) - (a.z * b.y), (a.z * b.x) - (a.x * b.z), (a.x * b.y) - (a.y * b.x));
+}
+
+//How much more an open edge resists moving off its line than a face does off its plane
+static const float borderWeight = 10.0f;
+
+void MeshSimplifier::weld(const XMFLOAT3* positions, int vertexCount, std::vector<int>& positionOf)
+{
+	auto samePosition = [&](int a, int b)
+	{
+		const XMFLOAT3& p = positions[a];
+		const XMFLOAT3& q = positions[b];
+		return p.x == q.x && p.y == q.y && p.z == q.z;
+	};
+
+	std::vector<int> sorted(vertexCount);
+
+	for (int i = 0; i < vertexCount; i++)
+	{
+		sorted[i] = i;
+	}
+
+	std::sort(sorted.begin(), sorted.end(), [&](int a, int b)
+	{
+		const XMFLOAT3& p = positions[a];
+		const XMFLOAT3& q = positions[b];
+
+		if (p.x != q.x)
+		{
+			return p.x < q.x;
+		}
+
+		if (p.y != q.y)
+		{
+			return p.y < q.y;
+		}
+
+		if (p.z != q.z)
+		{
+			return p.z < q.z;
+		}
+
+		return a < b;
+	});
+
+	//Each run of equal positions is known by its first vertex
+	positionOf.resize(vertexCount);
+
+	for (int i = 0; i < vertexCount; i++)
+	{
+		int vertex = sorted[i];
+		positionOf[vertex] = i > 0 && samePosition(sorted[i - 1], vertex) ? positionOf[sorted[i - 1]] : vertex;
+	}
+}
+
+bool MeshSimplifier::hasEdge(const std::vector<int>& offsets, const std::vector<int>& targets, int from, int to)
+{
+	for (int i = offsets[from]; i < offsets[from + 1]; i++)
+	{
+		if (targets[i] == to)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void MeshSimplifier::buildTopology(const std::vector<int>& positionOf, const std::vector<unsigned long>& indices, Topology& topology)
+{
+	int vertexCount = (int)positionOf.size();
+	int indexCount = (int)indices.size();
+
+	//Outgoing edges of every vertex and every position, counted then filled in place
+	topology.edgeOffsets.assign(vertexCount + 1, 0);
+	topology.positionEdgeOffsets.assign(vertexCount + 1, 0);
+
+	for (int i = 0; i < indexCount; i++)
+	{
+		topology.edgeOffsets[indices[i] + 1]++;
+		topology.positionEdgeOffsets[positionOf[indices[i]] + 1]++;
+	}
+
+	for (int i = 0; i < vertexCount; i++)
+	{
+		topology.edgeOffsets[i + 1] += topology.edgeOffsets[i];
+		topology.positionEdgeOffsets[i + 1] += topology.positionEdgeOffsets[i];
+	}
+
+	std::vector<int> edgeCursor(topology.edgeOffsets.begin(), topology.edgeOffsets.end() - 1);
+	std::vector<int> positionCursor(topology.positionEdgeOffsets.begin(), topology.positionEdgeOffsets.end() - 1);
+	topology.edgeTargets.resize(indexCount);
+	topology.positionEdgeTargets.resize(indexCount);
+
+	for (int i = 0; i < indexCount; i += 3)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			int from = (int)indices[i + k];
+			int to = (int)indices[i + ((k + 1) % 3)];
+			topology.edgeTargets[edgeCursor[from]++] = to;
+			topology.positionEdgeTargets[positionCursor[positionOf[from]]++] = positionOf[to];
+		}
+	}
+
+	//An edge is open where no triangle runs back along it, between vertices that is a border or a seam, between positions only a border
+	topology.openOut.assign(vertexCount, -1);
+	topology.openIn.assign(vertexCount, -1);
+	std::vector<char> border(vertexCount, 0);
+
+	for (int i = 0; i < indexCount; i += 3)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			int from = (int)indices[i + k];
+			int to = (int)indices[i + ((k + 1) % 3)];
+
+			if (!hasEdge(topology.edgeOffsets, topology.edgeTargets, to, from))
+			{
+				topology.openOut[from] = topology.openOut[from] == -1 ? to : -2;
+				topology.openIn[to] = topology.openIn[to] == -1 ? from : -2;
+			}
+
+			if (!hasEdge(topology.positionEdgeOffsets, topology.positionEdgeTargets, positionOf[to], positionOf[from]))
+			{
+				border[positionOf[from]] = 1;
+				border[positionOf[to]] = 1;
+			}
+		}
+	}
+
+	//Vertices still in use at each position
+	std::vector<int> wedgeCount(vertexCount, 0);
+	std::vector<int> firstWedge(vertexCount, -1);
+	std::vector<int> secondWedge(vertexCount, -1);
+	std::vector<char> used(vertexCount, 0);
+
+	for (int i = 0; i < indexCount; i++)
+	{
+		int vertex = (int)indices[i];
+
+		if (used[vertex])
+		{
+			continue;
+		}
+
+		used[vertex] = 1;
+		int position = positionOf[vertex];
+
+		if (wedgeCount[position] == 0)
+		{
+			firstWedge[position] = vertex;
+		}
+
+		else if (wedgeCount[position] == 1)
+		{
+			secondWedge[position] = vertex;
+		}
+
+		wedgeCount[position]++;
+	}
+
+	topology.otherWedge.assign(vertexCount, -1);
+	topology.kind.assign(vertexCount, KIND_LOCKED);
+
+	auto isSimple = [&](int vertex)
+	{
+		return topology.openOut[vertex] >= 0 && topology.openIn[vertex] >= 0;
+	};
+
+	for (int vertex = 0; vertex < vertexCount; vertex++)
+	{
+		if (!used[vertex])
+		{
+			continue;
+		}
+
+		int position = positionOf[vertex];
+		bool open = topology.openOut[vertex] != -1 || topology.openIn[vertex] != -1;
+
+		if (wedgeCount[position] == 2)
+		{
+			topology.otherWedge[vertex] = firstWedge[position] == vertex ? secondWedge[position] : firstWedge[position];
+		}
+
+		//A single vertex with open edges but no border is where a seam ends, which stays put
+		if (wedgeCount[position] == 1 && !border[position])
+		{
+			topology.kind[vertex] = open ? KIND_LOCKED : KIND_MANIFOLD;
+		}
+
+		else if (wedgeCount[position] == 1)
+		{
+			topology.kind[vertex] = isSimple(vertex) ? KIND_BORDER : KIND_LOCKED;
+		}
+
+		else if (wedgeCount[position] == 2 && !border[position])
+		{
+			topology.kind[vertex] = isSimple(vertex) && isSimple(topology.otherWedge[vertex]) ? KIND_SEAM : KIND_LOCKED;
+		}
+	}
+}
+
+void MeshSimplifier::addPlane(Quadric& quadric, const XMFLOAT3& normal, float distance, float weight)
+{
+	double x = normal.x;
+	double y = normal.y;
+	double z = normal.z;
+	double d = distance;
+	double w = weight;
+
+	quadric.a00 += w * x * x;
+	quadric.a01 += w * x * y;
+	quadric.a02 += w * x * z;
+	quadric.a11 += w * y * y;
+	quadric.a12 += w * y * z;
+	quadric.a22 += w * z * z;
+	quadric.b0 += w * x * d;
+	quadric.b1 += w * y * d;
+	quadric.b2 += w * z * d;
+	quadric.c += w * d * d;
+}
+
+void MeshSimplifier::buildQuadrics(const XMFLOAT3* positions, const std::vector<int>& positionOf, const std::vector<unsigned long>& indices,
+	const Topology& topology, std::vector<Quadric>& quadrics)
+{
+	quadrics.assign(positionOf.size(), Quadric({ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 }));
+
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		const XMFLOAT3& p0 = positions[indices[i]];
+		const XMFLOAT3& p1 = positions[indices[i + 1]];
+		const XMFLOAT3& p2 = positions[indices[i + 2]];
+		XMFLOAT3 normal = cross3(sub3(p1, p0), sub3(p2, p0));
+		float length = sqrtf(dot3(normal, normal));
+
+		if (length <= 0.0f)
+		{
+			continue;
+		}
+
+		normal = XMFLOAT3(normal.x / length, normal.y / length, normal.z / length);
+		float area = length * 0.5f;
+		float distance = -dot3(normal, p0);
+
+		for (int k = 0; k < 3; k++)
+		{
+			Quadric& quadric = quadrics[positionOf[indices[i + k]]];
+			addPlane(quadric, normal, distance, area);
+			quadric.weight += area;
+		}
+
+		//Open edges get a plane of their own standing up from the face, so borders and seams keep their line. It adds no weight
+		//towards the mean, or the error would read smaller along them.
+		for (int k = 0; k < 3; k++)
+		{
+			int from = (int)indices[i + k];
+			int to = (int)indices[i + ((k + 1) % 3)];
+
+			if (hasEdge(topology.edgeOffsets, topology.edgeTargets, to, from))
+			{
+				continue;
+			}
+
+			XMFLOAT3 edge = sub3(positions[to], positions[from]);
+			XMFLOAT3 edgeNormal = cross3(edge, normal);
+			float edgeLength = sqrtf(dot3(edgeNormal, edgeNormal));
+
+			if (edgeLength <= 0.0f)
+			{
+				continue;
+			}
+
+			edgeNormal = XMFLOAT3(edgeNormal.x / edgeLength, edgeNormal.y / edgeLength, edgeNormal.z / edgeLength);
+			float edgeDistance = -dot3(edgeNormal, positions[from]);
+			float weight = dot3(edge, edge) * borderWeight;
+
+			addPlane(quadrics[positionOf[from]], edgeNormal, edgeDistance, weight);
+			addPlane(quadrics[positionOf[to]], edgeNormal, edgeDistance, weight);
+		}
+	}
+}
+
+float MeshSimplifier::evaluate(const Quadric& a, const Quadric& b, const XMFLOAT3& position)
+{
+	double x = position.x;
+	double y = position.y;
+	double z = position.z;
+
+	auto value = [&](const Quadric& q)
+	{
+		return (q.a00 * x * x) + (2.0 * q.a01 * x * y) + (2.0 * q.a02 * x * z) + (q.a11 * y * y) + (2.0 * q.a12 * y * z) + (q.a22 * z * z)
+			+ (2.0 * ((q.b0 * x) + (q.b1 * y) + (q.b2 * z))) + q.c;
+	};
+
+	//Mean squared distance to the planes, so the error is in model units whatever the triangles' sizes
+	double weight = a.weight + b.weight;
+
+	return (float)(fabs(value(a) + value(b)) / (weight > 0.0 ? weight : 1.0));
+}
+
+bool MeshSimplifier::getCollapse(const XMFLOAT3* positions, const std::vector<int>& positionOf, const Topology& topology,
+	const std::vector<Quadric>& quadrics, int from, int to, Collapse& collapse)
+{
+	int fromPosition = positionOf[from];
+	int toPosition = positionOf[to];
+
+	if (fromPosition == toPosition)
+	{
+		return false;
+	}
+
+	bool alongOpenEdge = topology.openOut[from] == to || topology.openIn[from] == to;
+	collapse.fromWedge = -1;
+	collapse.toWedge = -1;
+
+	switch (topology.kind[from])
+	{
+	case KIND_MANIFOLD:
+		break;
+
+	case KIND_BORDER:
+		if (!alongOpenEdge)
+		{
+			return false;
+		}
+
+		break;
+
+	case KIND_SEAM:
+	{
+		if (!alongOpenEdge)
+		{
+			return false;
+		}
+
+		//The other side of the seam has to follow it to the same position
+		int other = topology.otherWedge[from];
+		int out = topology.openOut[other];
+		int in = topology.openIn[other];
+
+		if (out >= 0 && positionOf[out] == toPosition)
+		{
+			collapse.toWedge = out;
+		}
+
+		else if (in >= 0 && positionOf[in] == toPosition)
+		{
+			collapse.toWedge = in;
+		}
+
+		else
+		{
+			return false;
+		}
+
+		collapse.fromWedge = other;
+		break;
+	}
+
+	default:
+		return false;
+	}
+
+	collapse.from = from;
+	collapse.to = to;
+	collapse.cost = evaluate(quadrics[fromPosition], quadrics[toPosition], positions[to]);
+
+	return true;
+}
+
+bool MeshSimplifier::flipsTriangle(const XMFLOAT3* positions, const std::vector<int>& positionOf, const std::vector<unsigned long>& indices,
+	const std::vector<int>& triangleOffsets, const std::vector<int>& triangles, const std::vector<int>& remap, int from, int to)
+{
+	int fromPosition = positionOf[from];
+	int toPosition = positionOf[to];
+
+	for (int i = triangleOffsets[fromPosition]; i < triangleOffsets[fromPosition + 1]; i++)
+	{
+		int triangle = triangles[i];
+		int corners[3];
+		bool removed = false;
+
+		//Through the collapses already made this pass
+		for (int k = 0; k < 3; k++)
+		{
+			corners[k] = remap[indices[(triangle * 3) + k]];
+			removed |= positionOf[corners[k]] == toPosition;
+		}
+
+		if (removed || positionOf[corners[0]] == positionOf[corners[1]] || positionOf[corners[1]] == positionOf[corners[2]] || positionOf[corners[0]] == positionOf[corners[2]])
+		{
+			continue;
+		}
+
+		XMFLOAT3 before[3];
+		XMFLOAT3 after[3];
+
+		for (int k = 0; k < 3; k++)
+		{
+			before[k] = positions[corners[k]];
+			after[k] = positionOf[corners[k]] == fromPosition ? positions[to] : before[k];
+		}
+
+		XMFLOAT3 normalBefore = cross3(sub3(before[1], before[0]), sub3(before[2], before[0]));
+		XMFLOAT3 normalAfter = cross3(sub3(after[1], after[0]), sub3(after[2], after[0]));
+
+		if (dot3(normalBefore, normalAfter) <= 0.0f)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+MeshSimplifier::Level MeshSimplifier::simplify(const std::vector<XMFLOAT3>& positions, const std::vector<unsigned long>& indices, int targetTriangles,
+	bool multithreaded)
+{
+	Level level;
+	level.indices = indices;
+	level.error = 0.0f;
+
+	int vertexCount = (int)positions.size();
+	std::vector<int> positionOf;
+	weld(positions.data(), vertexCount, positionOf);
+
+	Topology topology;
+	buildTopology(positionOf, level.indices, topology);
+
+	std::vector<Quadric> quadrics;
+	buildQuadrics(positions.data(), positionOf, level.indices, topology, quadrics);
+
+	std::vector<Collapse> candidates;
+	std::vector<int> triangleOffsets;
+	std::vector<int> triangles;
+	std::vector<int> remap(vertexCount);
+	std::vector<char> locked(vertexCount);
+	float largestCost = 0.0f;
+
+	for (int pass = 0; (int)level.indices.size() / 3 > targetTriangles; pass++)
+	{
+		int triangleCount = (int)level.indices.size() / 3;
+
+		if (pass > 0)
+		{
+			buildTopology(positionOf, level.indices, topology);
+		}
+
+		//Every edge of every triangle, the cheaper way round it may collapse
+		candidates.resize((size_t)triangleCount * 3);
+
+		auto cost = [&](int begin, int end)
+		{
+			for (int triangle = begin; triangle < end; triangle++)
+			{
+				for (int k = 0; k < 3; k++)
+				{
+					int a = (int)level.indices[(triangle * 3) + k];
+					int b = (int)level.indices[(triangle * 3) + ((k + 1) % 3)];
+					Collapse forward;
+					Collapse backward;
+					bool canForward = getCollapse(positions.data(), positionOf, topology, quadrics, a, b, forward);
+					bool canBackward = getCollapse(positions.data(), positionOf, topology, quadrics, b, a, backward);
+					Collapse& candidate = candidates[(triangle * 3) + k];
+
+					if (canForward && (!canBackward || forward.cost <= backward.cost))
+					{
+						candidate = forward;
+					}
+
+					else if (canBackward)
+					{
+						candidate = backward;
+					}
+
+					else
+					{
+						candidate.from = -1;
+					}
+				}
+			}
+		};
+
+		if (multithreaded)
+		{
+			parallelFor(triangleCount, cost, 256);
+		}
+
+		else
+		{
+			cost(0, triangleCount);
+		}
+
+		candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [](const Collapse& collapse) { return collapse.from < 0; }), candidates.end());
+
+		if (candidates.empty())
+		{
+			break;
+		}
+
+		std::sort(candidates.begin(), candidates.end(), [](const Collapse& a, const Collapse& b)
+		{
+			if (a.cost != b.cost)
+			{
+				return a.cost < b.cost;
+			}
+
+			return a.from != b.from ? a.from < b.from : a.to < b.to;
+		});
+
+		//Triangles around each position, for the flip test
+		triangleOffsets.assign(vertexCount + 1, 0);
+
+		for (int i = 0; i < triangleCount * 3; i++)
+		{
+			triangleOffsets[positionOf[level.indices[i]] + 1]++;
+		}
+
+		for (int i = 0; i < vertexCount; i++)
+		{
+			triangleOffsets[i + 1] += triangleOffsets[i];
+		}
+
+		std::vector<int> triangleCursor(triangleOffsets.begin(), triangleOffsets.end() - 1);
+		triangles.resize((size_t)triangleCount * 3);
+
+		for (int i = 0; i < triangleCount * 3; i++)
+		{
+			triangles[triangleCursor[positionOf[level.indices[i]]]++] = i / 3;
+		}
+
+		for (int i = 0; i < vertexCount; i++)
+		{
+			remap[i] = i;
+			locked[i] = 0;
+		}
+
+		//A collapse locks both of its positions for the rest of the pass, so many cheap collapses are passed over. The pass goes
+		//somewhat past the cost of the collapse that would reach the target alone, so it doesn't spend the remaining triangles on
+		//expensive collapses while cheaper ones wait for the next pass.
+		int removeGoal = triangleCount - targetTriangles;
+		size_t goalCandidate = (size_t)(removeGoal / 2);
+		float costGoal = goalCandidate < candidates.size() ? candidates[goalCandidate].cost * 1.5f : candidates.back().cost;
+		int removed = 0;
+		int collapses = 0;
+
+		for (const Collapse& collapse : candidates)
+		{
+			if (removed >= removeGoal || (collapse.cost > costGoal && collapses > 0))
+			{
+				break;
+			}
+
+			int fromPosition = positionOf[collapse.from];
+			int toPosition = positionOf[collapse.to];
+
+			if (locked[fromPosition] || locked[toPosition])
+			{
+				continue;
+			}
+
+			if (flipsTriangle(positions.data(), positionOf, level.indices, triangleOffsets, triangles, remap, collapse.from, collapse.to))
+			{
+				continue;
+			}
+
+			remap[collapse.from] = collapse.to;
+
+			if (collapse.fromWedge >= 0)
+			{
+				remap[collapse.fromWedge] = collapse.toWedge;
+			}
+
+			Quadric& target = quadrics[toPosition];
+			const Quadric& source = quadrics[fromPosition];
+			target.a00 += source.a00;
+			target.a01 += source.a01;
+			target.a02 += source.a02;
+			target.a11 += source.a11;
+			target.a12 += source.a12;
+			target.a22 += source.a22;
+			target.b0 += source.b0;
+			target.b1 += source.b1;
+			target.b2 += source.b2;
+			target.c += source.c;
+			target.weight += source.weight;
+
+			locked[fromPosition] = 1;
+			locked[toPosition] = 1;
+
+			//An edge inside the surface has a triangle either side, on a border only one
+			removed += topology.kind[collapse.from] == KIND_BORDER ? 1 : 2;
+			largestCost = fmaxf(largestCost, collapse.cost);
+			collapses++;
+		}
+
+		if (collapses == 0)
+		{
+			break;
+		}
+
+		//Triangles that lost a corner to a collapse are dropped
+		size_t written = 0;
+
+		for (size_t i = 0; i < level.indices.size(); i += 3)
+		{
+			int a = remap[level.indices[i]];
+			int b = remap[level.indices[i + 1]];
+			int c = remap[level.indices[i + 2]];
+
+			if (positionOf[a] == positionOf[b] || positionOf[b] == positionOf[c] || positionOf[a] == positionOf[c])
+			{
+				continue;
+			}
+
+			level.indices[written++] = a;
+			level.indices[written++] = b;
+			level.indices[written++] = c;
+		}
+
+		level.indices.resize(written);
+	}
+
+	level.triangles = (int)level.indices.size() / 3;
+	level.error = sqrtf(largestCost);
+
+	return level;
+}
+
+std::vector<MeshSimplifier::Level> MeshSimplifier::buildChain(const std::vector<XMFLOAT3>& positions, const std::vector<unsigned long>& indices,
+	const std::vector<float>& ratios, bool multithreaded)
+{
+	std::vector<Level> levels(ratios.size());
+	int triangleCount = (int)indices.size() / 3;
+
+	//A level per task, each simplifying on its own thread rather than splitting its candidates further
+	auto build = [&](int begin, int end)
+	{
+		for (int i = begin; i < end; i++)
+		{
+			int target = (int)((float)triangleCount * ratios[i]);
+			levels[i] = simplify(positions, indices, target, false);
+		}
+	};
+
+	if (multithreaded)
+	{
+		parallelFor((int)ratios.size(), build);
+	}
+
+	else
+	{
+		build(0, (int)ratios.size());
+	}
+
+	return levels;
+}
+
+float MeshSimplifier::distanceToTriangle(const XMFLOAT3& point, const XMFLOAT3& a, const XMFLOAT3& b, const XMFLOAT3& c)
+{
+	//Closest point by the region of the triangle the point projects into, from Ericson's Real-Time Collision Detection
+	XMFLOAT3 ab = sub3(b, a);
+	XMFLOAT3 ac = sub3(c, a);
+	XMFLOAT3 ap = sub3(point, a);
+	XMFLOAT3 closest;
+
+	float d1 = dot3(ab, ap);
+	float d2 = dot3(ac, ap);
+
+	XMFLOAT3 bp = sub3(point, b);
+	float d3 = dot3(ab, bp);
+	float d4 = dot3(ac, bp);
+
+	XMFLOAT3 cp = sub3(point, c);
+	float d5 = dot3(ab, cp);
+	float d6 = dot3(ac, cp);
+
+	float vc = (d1 * d4) - (d3 * d2);
+	float vb = (d5 * d2) - (d1 * d6);
+	float va = (d3 * d6) - (d5 * d4);
+
+	if (d1 <= 0.0f && d2 <= 0.0f)
+	{
+		closest = a;
+	}
+
+	else if (d3 >= 0.0f && d4 <= d3)
+	{
+		closest = b;
+	}
+
+	else if (d6 >= 0.0f && d5 <= d6)
+	{
+		closest = c;
+	}
+
+	else if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+	{
+		float v = d1 / (d1 - d3);
+		closest = XMFLOAT3(a.x + (ab.x * v), a.y + (ab.y * v), a.z + (ab.z * v));
+	}
+
+	else if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+	{
+		float w = d2 / (d2 - d6);
+		closest = XMFLOAT3(a.x + (ac.x * w), a.y + (ac.y * w), a.z + (ac.z * w));
+	}
+
+	else if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+	{
+		float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+		closest = XMFLOAT3(b.x + ((c.x - b.x) * w), b.y + ((c.y - b.y) * w), b.z + ((c.z - b.z) * w));
+	}
+
+	else
+	{
+		float denominator = 1.0f / (va + vb + vc);
+		float v = vb * denominator;
+		float w = vc * denominator;
+		closest = XMFLOAT3(a.x + (ab.x * v) + (ac.x * w), a.y + (ab.y * v) + (ac.y * w), a.z + (ab.z * v) + (ac.z * w));
+	}
+
+	XMFLOAT3 offset = sub3(point, closest);
+
+	return sqrtf(dot3(offset, offset));
+}
+
+float MeshSimplifier::measureDistance(const std::vector<XMFLOAT3>& positions, const std::vector<unsigned long>& sourceIndices,
+	const std::vector<unsigned long>& indices)
+{
+	int sourceIndexCount = (int)sourceIndices.size();
+	int indexCount = (int)indices.size();
+
+	if (indexCount == 0)
+	{
+		return 0.0f;
+	}
+
+	//Every corner of the source against every simplified triangle, which is only meant for the benchmark's small meshes
+	std::vector<float> distances(sourceIndexCount);
+
+	parallelFor(sourceIndexCount, [&](int begin, int end)
+	{
+		for (int i = begin; i < end; i++)
+		{
+			const XMFLOAT3& point = positions[sourceIndices[i]];
+			float nearest = INFINITY;
+
+			for (int j = 0; j < indexCount && nearest > 0.0f; j += 3)
+			{
+				nearest = fminf(nearest, distanceToTriangle(point, positions[indices[j]], positions[indices[j + 1]], positions[indices[j + 2]]));
+			}
+
+			distances[i] = nearest;
+		}
+	}, 64);
+
+	float farthest = 0.0f;
+
+	for (float distance : distances)
+	{
+		farthest = fmaxf(farthest, distance);
+	}
+
+	return farthest;
+}
+
+MeshSimplifier::BenchmarkResult MeshSimplifier::benchmark(const std::vector<XMFLOAT3>& positions, const std::vector<unsigned long>& indices,
+	const std::vector<float>& ratios)
+{
+	BenchmarkResult result;
+	result.triangles = (int)indices.size() / 3;
+	result.radius = 0.0f;
+
+	if (positions.empty() || indices.empty())
+	{
+		result.singleMilliseconds = 0.0f;
+		result.multiMilliseconds = 0.0f;
+		result.singleTrianglesPerSecond = 0.0f;
+		result.multiTrianglesPerSecond = 0.0f;
+		result.matches = true;
+		return result;
+	}
+
+	XMFLOAT3 minimum = positions[0];
+	XMFLOAT3 maximum = positions[0];
+
+	for (const XMFLOAT3& position : positions)
+	{
+		minimum = XMFLOAT3(fminf(minimum.x, position.x), fminf(minimum.y, position.y), fminf(minimum.z, position.z));
+		maximum = XMFLOAT3(fmaxf(maximum.x, position.x), fmaxf(maximum.y, position.y), fmaxf(maximum.z, position.z));
+	}
+
+	XMFLOAT3 extent = sub3(maximum, minimum);
+	result.radius = sqrtf(dot3(extent, extent)) * 0.5f;
+
+	const int runs = 4;
+	std::vector<Level> single;
+	std::vector<Level> multi;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for (int run = 0; run < runs; run++)
+	{
+		single = buildChain(positions, indices, ratios, false);
+	}
+
+	auto middle = std::chrono::high_resolution_clock::now();
+
+	for (int run = 0; run < runs; run++)
+	{
+		multi = buildChain(positions, indices, ratios, true);
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+
+	result.singleMilliseconds = std::chrono::duration<float, std::milli>(middle - start).count() / (float)runs;
+	result.multiMilliseconds = std::chrono::duration<float, std::milli>(end - middle).count() / (float)runs;
+
+	float simplified = (float)result.triangles * (float)ratios.size();
+	result.singleTrianglesPerSecond = simplified / fmaxf(result.singleMilliseconds * 0.001f, 0.000001f);
+	result.multiTrianglesPerSecond = simplified / fmaxf(result.multiMilliseconds * 0.001f, 0.000001f);
+	result.matches = true;
+
+	for (size_t i = 0; i < ratios.size(); i++)
+	{
+		result.matches &= single[i].indices == multi[i].indices;
+		result.levelTriangles.push_back(multi[i].triangles);
+		result.levelError.push_back(multi[i].error);
+		result.levelDistance.push_back(measureDistance(positions, indices, multi[i].indices));
+	}
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+
+using namespace DirectX;
+
+//Quadric error metric simplifier for imported meshes. Only the index buffer is rewritten, each collapse folds a vertex into one of
+//its neighbours, so every level shares the source's vertex buffer and keeps its texture coordinates and normals exactly. It only
+//reads the positions, given as a plain array indexed like the vertex buffer. Vertices are welded by position to find the topology
+//underneath the attributes. A position split between two vertices, a UV or normal seam, only collapses along the seam with both
+//sides at once, vertices on open borders only collapse along the border and anything more tangled is locked.
+class MeshSimplifier
+{
+public:
+	struct Level
+	{
+		std::vector<unsigned long> indices;
+		int triangles;
+		float error;			//Largest quadric error of the collapses made, as a distance in model units
+	};
+
+	struct BenchmarkResult
+	{
+		int triangles;					//Of the source mesh
+		float radius;					//Of the source's bounds, to put the errors in scale
+		float singleMilliseconds;		//The whole chain on one thread
+		float multiMilliseconds;		//Levels built in parallel
+		float singleTrianglesPerSecond;	//Source triangles simplified per second, over every level of the chain
+		float multiTrianglesPerSecond;
+		bool matches;					//Whether both builds gave the same indices
+		std::vector<int> levelTriangles;
+		std::vector<float> levelError;
+		std::vector<float> levelDistance;	//Farthest any source vertex is from the level's surface
+	};
+
+	//Simplifies to at most targetTriangles, or as close as the locked vertices allow. Candidate collapses are costed in parallel when multithreaded.
+	static Level simplify(const std::vector<XMFLOAT3>& positions, const std::vector<unsigned long>& indices, int targetTriangles, bool multithreaded = true);
+
+	//Simplifies the source to each fraction of its triangles, every level from the source itself so errors don't build up along the
+	//chain. The levels are built in parallel when multithreaded.
+	static std::vector<Level> buildChain(const std::vector<XMFLOAT3>& positions, const std::vector<unsigned long>& indices, const std::vector<float>& ratios,
+		bool multithreaded = true);
+
+	//Farthest distance from a vertex of the source triangles to the nearest of the simplified triangles
+	static float measureDistance(const std::vector<XMFLOAT3>& positions, const std::vector<unsigned long>& sourceIndices, const std::vector<unsigned long>& indices);
+
+	//Times the chain single and multithreaded, then measures each level's distance from the source
+	static BenchmarkResult benchmark(const std::vector<XMFLOAT3>& positions, const std::vector<unsigned long>& indices, const std::vector<float>& ratios);
+
+private:
+	enum VertexKind : char
+	{
+		KIND_MANIFOLD,
+		KIND_BORDER,
+		KIND_SEAM,
+		KIND_LOCKED
+	};
+
+	//Symmetric 4x4 quadric of the planes around a position, each weighted by the area it came from
+	struct Quadric
+	{
+		double a00, a01, a02, a11, a12, a22;
+		double b0, b1, b2;
+		double c;
+		double weight;
+	};
+
+	//Connectivity of the current indices, rebuilt before each pass of collapses
+	struct Topology
+	{
+		std::vector<int> edgeOffsets;		//Outgoing edges of each vertex, into edgeTargets
+		std::vector<int> edgeTargets;
+		std::vector<int> positionEdgeOffsets;	//The same between welded positions
+		std::vector<int> positionEdgeTargets;
+		std::vector<int> openOut;			//Vertex across the vertex's only open outgoing edge, -1 for none and -2 for several
+		std::vector<int> openIn;
+		std::vector<int> otherWedge;		//The other vertex at the same position, -1 unless there are exactly two
+		std::vector<char> kind;
+	};
+
+	struct Collapse
+	{
+		int from;
+		int to;
+		int fromWedge;			//The seam's other side and where it goes, -1 off a seam
+		int toWedge;
+		float cost;
+	};
+
+	static void weld(const XMFLOAT3* positions, int vertexCount, std::vector<int>& positionOf);
+	static void buildTopology(const std::vector<int>& positionOf, const std::vector<unsigned long>& indices, Topology& topology);
+	static bool hasEdge(const std::vector<int>& offsets, const std::vector<int>& targets, int from, int to);
+	static void buildQuadrics(const XMFLOAT3* positions, const std::vector<int>& positionOf, const std::vector<unsigned long>& indices,
+		const Topology& topology, std::vector<Quadric>& quadrics);
+	static void addPlane(Quadric& quadric, const XMFLOAT3& normal, float distance, float weight);
+	static float evaluate(const Quadric& a, const Quadric& b, const XMFLOAT3& position);
+	static bool getCollapse(const XMFLOAT3* positions, const std::vector<int>& positionOf, const Topology& topology, const std::vector<Quadric>& quadrics,
+		int from, int to, Collapse& collapse);
+	static bool flipsTriangle(const XMFLOAT3* positions, const std::vector<int>& positionOf, const std::vector<unsigned long>& indices,
+		const std::vector<int>& triangleOffsets, const std::vector<int>& triangles, const std::vector<int>& remap, int from, int to);
+	static float distanceToTriangle(const XMFLOAT3& point, const XMFLOAT3& a, const XMFLOAT3& b, const XMFLOAT3& c);
+};
\ No newline at end of file
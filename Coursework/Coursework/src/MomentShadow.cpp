@@ -0,0 +1,237 @@
+#include "MomentShadow.h"
+
+#include <algorithm>
+#include <cmath>
+
+const float MomentShadow::POSITIVE_EXPONENT = 40.0f;
+const float MomentShadow::NEGATIVE_EXPONENT = 5.0f;
+
+MomentShadow::MomentShadow(Mode m)
+{
+	mode = m;
+	width = 0;
+	height = 0;
+	blurRadius = 0;
+	minVariance = 0.00002f;
+	bleedReduction = 0.2f;
+}
+
+MomentShadow::~MomentShadow()
+{
+
+}
+
+//Depth is the normalised linear depth from the light, matching getMomentDepth in light_ps.hlsl
+XMFLOAT4 MomentShadow::encode(float depth, Mode mode)
+{
+	if (mode == MODE_VSM)
+	{
+		return XMFLOAT4(depth, depth * depth, 0.0f, 0.0f);
+	}
+
+	//Depth is moved to [-1, 1] before warping, so both exponents stay inside 32 bit float range once squared
+	float warped = (depth * 2.0f) - 1.0f;
+	float positive = expf(POSITIVE_EXPONENT * warped);
+	float negative = -expf(-NEGATIVE_EXPONENT * warped);
+
+	return XMFLOAT4(positive, positive * positive, negative, negative * negative);
+}
+
+void MomentShadow::encodeDepthMap(const ShadowFilter::DepthMap& map)
+{
+	width = map.width;
+	height = map.height;
+	blurRadius = 0;
+	moments.resize(map.depths.size());
+
+	for (size_t i = 0; i < map.depths.size(); i++)
+	{
+		moments[i] = encode(map.depths[i], mode);
+	}
+}
+
+XMFLOAT4 MomentShadow::load(int x, int y) const
+{
+	//Clamp addressing, as the moment sampler in LightShader
+	x = std::max(0, std::min(x, width - 1));
+	y = std::max(0, std::min(y, height - 1));
+
+	return moments[(y * width) + x];
+}
+
+void MomentShadow::blur(int radius, float standardDeviation)
+{
+	if (radius <= 0 || moments.empty())
+	{
+		return;
+	}
+
+	blurRadius = radius;
+
+	//Same unnormalised gaussian as the blur shaders, divided by the kernel sum afterwards
+	std::vector<float> weights;
+	float kernelSum = 0.0f;
+
+	for (int i = -radius; i <= radius; i++)
+	{
+		float weight = expf(-(float)(i * i) / (2.0f * standardDeviation * standardDeviation));
+		weights.push_back(weight);
+		kernelSum += weight;
+	}
+
+	std::vector<XMFLOAT4> temp(moments.size());
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				XMFLOAT4 sum(0.0f, 0.0f, 0.0f, 0.0f);
+
+				for (int i = -radius; i <= radius; i++)
+				{
+					XMFLOAT4 sample = pass == 0 ? load(x + i, y) : load(x, y + i);
+					float weight = weights[i + radius];
+
+					sum.x += sample.x * weight;
+					sum.y += sample.y * weight;
+					sum.z += sample.z * weight;
+					sum.w += sample.w * weight;
+				}
+
+				temp[(y * width) + x] = XMFLOAT4(sum.x / kernelSum, sum.y / kernelSum, sum.z / kernelSum, sum.w / kernelSum);
+			}
+		}
+
+		moments.swap(temp);
+	}
+}
+
+float MomentShadow::chebyshevUpperBound(XMFLOAT2 m, float depth, float minVar, float reduction)
+{
+	if (depth <= m.x)
+	{
+		return 1.0f;
+	}
+
+	float variance = std::max(m.y - (m.x * m.x), minVar);
+	float d = depth - m.x;
+	float pMax = variance / (variance + (d * d));
+
+	//Light bleeding reduction, cuts off the tail of the upper bound
+	return std::max(0.0f, std::min((pMax - reduction) / (1.0f - reduction), 1.0f));
+}
+
+float MomentShadow::visibility(XMFLOAT2 uv, float depth) const
+{
+	float x = (uv.x * (float)width) - 0.5f;
+	float y = (uv.y * (float)height) - 0.5f;
+	int x0 = (int)floorf(x);
+	int y0 = (int)floorf(y);
+	float fx = x - (float)x0;
+	float fy = y - (float)y0;
+
+	XMFLOAT4 m00 = load(x0, y0);
+	XMFLOAT4 m10 = load(x0 + 1, y0);
+	XMFLOAT4 m01 = load(x0, y0 + 1);
+	XMFLOAT4 m11 = load(x0 + 1, y0 + 1);
+
+	float w00 = (1.0f - fx) * (1.0f - fy);
+	float w10 = fx * (1.0f - fy);
+	float w01 = (1.0f - fx) * fy;
+	float w11 = fx * fy;
+
+	XMFLOAT4 m((m00.x * w00) + (m10.x * w10) + (m01.x * w01) + (m11.x * w11),
+		(m00.y * w00) + (m10.y * w10) + (m01.y * w01) + (m11.y * w11),
+		(m00.z * w00) + (m10.z * w10) + (m01.z * w01) + (m11.z * w11),
+		(m00.w * w00) + (m10.w * w10) + (m01.w * w01) + (m11.w * w11));
+
+	if (mode == MODE_VSM)
+	{
+		return chebyshevUpperBound(XMFLOAT2(m.x, m.y), depth, minVariance, bleedReduction);
+	}
+
+	XMFLOAT4 warped = encode(depth, MODE_EVSM);
+
+	//Minimum variance is scaled by the slope of each warp, so one setting works in both warped spaces
+	float positiveScale = 2.0f * POSITIVE_EXPONENT * warped.x;
+	float negativeScale = 2.0f * NEGATIVE_EXPONENT * warped.z;
+
+	float positive = chebyshevUpperBound(XMFLOAT2(m.x, m.y), warped.x, minVariance * positiveScale * positiveScale, bleedReduction);
+	float negative = chebyshevUpperBound(XMFLOAT2(m.z, m.w), warped.z, minVariance * negativeScale * negativeScale, bleedReduction);
+
+	return std::min(positive, negative);
+}
+
+MomentShadow::BleedingResult MomentShadow::measureLightBleeding(const ShadowFilter::DepthMap& map, float receiverDepth, float bias) const
+{
+	BleedingResult result = { 0.0f, 0.0f, 0.0f };
+	double bleedingSum = 0.0;
+
+	for (int y = 0; y < map.height; y++)
+	{
+		for (int x = 0; x < map.width; x++)
+		{
+			//Only texels with every neighbour inside the blur footprint shadowed, so the blurred penumbra isn't counted
+			bool umbra = true;
+
+			for (int j = -blurRadius - 1; j <= blurRadius + 1 && umbra; j++)
+			{
+				for (int i = -blurRadius - 1; i <= blurRadius + 1 && umbra; i++)
+				{
+					umbra = (receiverDepth - bias) > map.load(x + i, y + j);
+				}
+			}
+
+			if (!umbra)
+			{
+				continue;
+			}
+
+			XMFLOAT2 uv(((float)x + 0.5f) / (float)map.width, ((float)y + 0.5f) / (float)map.height);
+			float bleeding = visibility(uv, receiverDepth - bias);
+
+			bleedingSum += bleeding;
+			result.maxBleeding = std::max(result.maxBleeding, bleeding);
+			result.shadowedTexels += 1.0f;
+		}
+	}
+
+	if (result.shadowedTexels > 0.0f)
+	{
+		result.meanBleeding = (float)(bleedingSum / (double)result.shadowedTexels);
+	}
+
+	return result;
+}
+
+//Two overlapping occluders at different depths over a receiver plane, the classic case for variance shadow light bleeding
+ShadowFilter::DepthMap MomentShadow::buildBleedingTestMap(int size, float receiverDepth)
+{
+	ShadowFilter::DepthMap map;
+	map.width = size;
+	map.height = size;
+	map.depths.assign(size * size, receiverDepth);
+
+	for (int y = 0; y < size; y++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			bool inLower = x > size / 8 && x < (size * 7) / 8 && y > size / 8 && y < (size * 7) / 8;
+			bool inUpper = x > (size * 3) / 8 && x < (size * 5) / 8 && y > size / 4 && y < (size * 3) / 4;
+
+			if (inUpper)
+			{
+				map.depths[(y * size) + x] = receiverDepth * 0.2f;
+			}
+
+			else if (inLower)
+			{
+				map.depths[(y * size) + x] = receiverDepth * 0.7f;
+			}
+		}
+	}
+
+	return map;
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "ShadowFilter.h"
+
+//CPU implementation of the variance (VSM) and exponential variance (EVSM) shadow maps written by depth_ps.hlsl
+//Encodes moments, prefilters them with the same separable gaussian as the blur shaders and runs the Chebyshev test from light_ps.hlsl
+class MomentShadow
+{
+public:
+	enum Mode
+	{
+		MODE_VSM = 0,
+		MODE_EVSM = 1
+	};
+
+	//Warp exponents, must match depth_ps.hlsl and light_ps.hlsl. Kept low enough for 32 bit float moments.
+	static const float POSITIVE_EXPONENT;
+	static const float NEGATIVE_EXPONENT;
+
+	struct BleedingResult
+	{
+		float meanBleeding;		//Average visibility where the depth test says the receiver is fully shadowed
+		float maxBleeding;
+		float shadowedTexels;
+	};
+
+	MomentShadow(Mode mode);
+	~MomentShadow();
+
+	static XMFLOAT4 encode(float depth, Mode mode);
+
+	void encodeDepthMap(const ShadowFilter::DepthMap& map);
+	void blur(int radius, float standardDeviation);		//Horizontal then vertical pass, as horizontalBlur_ps and verticalBlur_ps
+	float visibility(XMFLOAT2 uv, float depth) const;	//Bilinear moment fetch followed by the Chebyshev test
+
+	//Compares the filtered visibility against a plain depth test over every texel of a receiver plane
+	BleedingResult measureLightBleeding(const ShadowFilter::DepthMap& map, float receiverDepth, float bias) const;
+
+	static float chebyshevUpperBound(XMFLOAT2 moments, float depth, float minVariance, float bleedReduction);
+	static ShadowFilter::DepthMap buildBleedingTestMap(int size, float receiverDepth);
+
+	inline void setMinVariance(float variance) { minVariance = variance; }
+	inline void setBleedReduction(float reduction) { bleedReduction = reduction; }
+
+	inline const std::vector<XMFLOAT4>& getMoments() const { return moments; }
+
+private:
+	XMFLOAT4 load(int x, int y) const;
+
+	Mode mode;
+	int width;
+	int height;
+	int blurRadius;
+	float minVariance;
+	float bleedReduction;
+	std::vector<XMFLOAT4> moments;
+};
\ No newline at end of file
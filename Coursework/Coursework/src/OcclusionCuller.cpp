@@ -0,0 +1,451 @@
+#include "OcclusionCuller.h"
+#include "Frustum.h"
+#include "ParallelFor.h"
+
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+OcclusionCuller::OcclusionCuller(int lwidth, int lheight) : width((lwidth + 3) & ~3), height(lheight)
+{
+	tilesX = (width + TILE_WIDTH - 1) / TILE_WIDTH;
+	tilesY = (height + TILE_HEIGHT - 1) / TILE_HEIGHT;
+	tileTriangles.resize(tilesX * tilesY);
+
+	//Halved, rounding up, down to a single texel
+	int levelWidth = width;
+	int levelHeight = height;
+
+	while (true)
+	{
+		levels.push_back(std::vector<float>(levelWidth * levelHeight, 1.0f));
+		levelWidths.push_back(levelWidth);
+		levelHeights.push_back(levelHeight);
+
+		if (levelWidth == 1 && levelHeight == 1)
+		{
+			break;
+		}
+
+		levelWidth = (levelWidth + 1) / 2;
+		levelHeight = (levelHeight + 1) / 2;
+	}
+
+	XMStoreFloat4x4(&viewProjection, XMMatrixIdentity());
+	stats = { 0, 0, 0.0f, 0.0f, 0.0f };
+}
+
+OcclusionCuller::~OcclusionCuller()
+{
+
+}
+
+void OcclusionCuller::beginFrame(const XMMATRIX& lviewProjection)
+{
+	XMStoreFloat4x4(&viewProjection, lviewProjection);
+	triangles.clear();
+
+	for (std::vector<int>& tile : tileTriangles)
+	{
+		tile.clear();
+	}
+
+	stats = { 0, 0, 0.0f, 0.0f, 0.0f };
+}
+
+void OcclusionCuller::addOccluder(const XMFLOAT3* vertices, int vertexCount, const unsigned int* indices, int indexCount, const XMMATRIX& world)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	XMMATRIX toClip = XMMatrixMultiply(world, XMLoadFloat4x4(&viewProjection));
+	clipVertices.resize(vertexCount);
+
+	for (int i = 0; i < vertexCount; i++)
+	{
+		XMStoreFloat4(&clipVertices[i], XMVector4Transform(XMVectorSet(vertices[i].x, vertices[i].y, vertices[i].z, 1.0f), toClip));
+	}
+
+	for (int i = 0; i + 2 < indexCount; i += 3)
+	{
+		const XMFLOAT4* clip[3] = { &clipVertices[indices[i]], &clipVertices[indices[i + 1]], &clipVertices[indices[i + 2]] };
+		stats.occluderTriangles++;
+
+		//Left out when it reaches in front of the near plane, or is wholly beyond one side of the frustum
+		bool nearClipped = false;
+		int outside[5] = {};
+
+		for (int v = 0; v < 3; v++)
+		{
+			nearClipped = nearClipped || clip[v]->z < 0.0f || clip[v]->w <= 0.0f;
+			outside[0] += clip[v]->x < -clip[v]->w ? 1 : 0;
+			outside[1] += clip[v]->x > clip[v]->w ? 1 : 0;
+			outside[2] += clip[v]->y < -clip[v]->w ? 1 : 0;
+			outside[3] += clip[v]->y > clip[v]->w ? 1 : 0;
+			outside[4] += clip[v]->z > clip[v]->w ? 1 : 0;
+		}
+
+		if (nearClipped || outside[0] == 3 || outside[1] == 3 || outside[2] == 3 || outside[3] == 3 || outside[4] == 3)
+		{
+			continue;
+		}
+
+		Triangle triangle;
+		float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+
+		for (int v = 0; v < 3; v++)
+		{
+			float inverseW = 1.0f / clip[v]->w;
+			XMFLOAT3& screen = triangle.vertices[v];
+			screen = XMFLOAT3(((clip[v]->x * inverseW * 0.5f) + 0.5f) * (float)width, (0.5f - (clip[v]->y * inverseW * 0.5f)) * (float)height, clip[v]->z * inverseW);
+
+			minX = fminf(minX, screen.x);
+			minY = fminf(minY, screen.y);
+			maxX = fmaxf(maxX, screen.x);
+			maxY = fmaxf(maxY, screen.y);
+		}
+
+		int firstTileX = (int)fmaxf(0.0f, minX) / TILE_WIDTH;
+		int firstTileY = (int)fmaxf(0.0f, minY) / TILE_HEIGHT;
+		int lastTileX = (int)fminf((float)(width - 1), maxX) / TILE_WIDTH;
+		int lastTileY = (int)fminf((float)(height - 1), maxY) / TILE_HEIGHT;
+		int index = (int)triangles.size();
+		triangles.push_back(triangle);
+
+		for (int tileY = firstTileY; tileY <= lastTileY; tileY++)
+		{
+			for (int tileX = firstTileX; tileX <= lastTileX; tileX++)
+			{
+				tileTriangles[(tileY * tilesX) + tileX].push_back(index);
+				stats.rasterisedTriangles++;
+			}
+		}
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	stats.binMilliseconds += std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+void OcclusionCuller::rasterise(bool multithreaded)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	if (multithreaded)
+	{
+		parallelFor(tilesX * tilesY, [&](int begin, int end)
+		{
+			for (int tile = begin; tile < end; tile++)
+			{
+				rasteriseTile(tile);
+			}
+		}, 1);
+	}
+
+	else
+	{
+		for (int tile = 0; tile < tilesX * tilesY; tile++)
+		{
+			rasteriseTile(tile);
+		}
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	stats.rasteriseMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	buildHiZ();
+	end = std::chrono::high_resolution_clock::now();
+	stats.hiZMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+//Clears the tile then draws its triangles, testing pixel centres against the three edge functions four pixels at a time
+void OcclusionCuller::rasteriseTile(int tile)
+{
+	int tileX0 = (tile % tilesX) * TILE_WIDTH;
+	int tileY0 = (tile / tilesX) * TILE_HEIGHT;
+	int tileX1 = tileX0 + TILE_WIDTH < width ? tileX0 + TILE_WIDTH : width;
+	int tileY1 = tileY0 + TILE_HEIGHT < height ? tileY0 + TILE_HEIGHT : height;
+	float* depth = levels[0].data();
+
+	for (int y = tileY0; y < tileY1; y++)
+	{
+		for (int x = tileX0; x < tileX1; x++)
+		{
+			depth[(y * width) + x] = 1.0f;
+		}
+	}
+
+	XMVECTOR offsets = XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f);
+	XMVECTOR zero = XMVectorZero();
+
+	for (int index : tileTriangles[tile])
+	{
+		XMFLOAT3 v0 = triangles[index].vertices[0];
+		XMFLOAT3 v1 = triangles[index].vertices[1];
+		XMFLOAT3 v2 = triangles[index].vertices[2];
+
+		//Either winding is drawn, swapped so the inside of every edge is positive
+		float area = ((v1.x - v0.x) * (v2.y - v0.y)) - ((v2.x - v0.x) * (v1.y - v0.y));
+
+		if (fabsf(area) < 1e-6f)
+		{
+			continue;
+		}
+
+		if (area < 0.0f)
+		{
+			XMFLOAT3 swap = v1;
+			v1 = v2;
+			v2 = swap;
+			area = -area;
+		}
+
+		float edgeA[3] = { v0.y - v1.y, v1.y - v2.y, v2.y - v0.y };
+		float edgeB[3] = { v1.x - v0.x, v2.x - v1.x, v0.x - v2.x };
+		float edgeC[3] = { (v0.x * v1.y) - (v0.y * v1.x), (v1.x * v2.y) - (v1.y * v2.x), (v2.x * v0.y) - (v2.y * v0.x) };
+
+		//Depth divided by w is linear in screen space
+		float depthX = (((v1.z - v0.z) * (v2.y - v0.y)) - ((v2.z - v0.z) * (v1.y - v0.y))) / area;
+		float depthY = (((v2.z - v0.z) * (v1.x - v0.x)) - ((v1.z - v0.z) * (v2.x - v0.x))) / area;
+
+		int minX = (int)fmaxf((float)tileX0, floorf(fminf(v0.x, fminf(v1.x, v2.x))));
+		int minY = (int)fmaxf((float)tileY0, floorf(fminf(v0.y, fminf(v1.y, v2.y))));
+		int maxX = (int)fminf((float)(tileX1 - 1), floorf(fmaxf(v0.x, fmaxf(v1.x, v2.x))));
+		int maxY = (int)fminf((float)(tileY1 - 1), floorf(fmaxf(v0.y, fmaxf(v1.y, v2.y))));
+
+		//Tiles start on a multiple of four, so every group of four pixels stays within its row
+		minX &= ~3;
+
+		XMVECTOR a0 = XMVectorReplicate(edgeA[0]);
+		XMVECTOR a1 = XMVectorReplicate(edgeA[1]);
+		XMVECTOR a2 = XMVectorReplicate(edgeA[2]);
+		XMVECTOR stepDepth = XMVectorReplicate(depthX);
+
+		for (int y = minY; y <= maxY; y++)
+		{
+			float centreY = (float)y + 0.5f;
+			XMVECTOR row0 = XMVectorReplicate((edgeB[0] * centreY) + edgeC[0]);
+			XMVECTOR row1 = XMVectorReplicate((edgeB[1] * centreY) + edgeC[1]);
+			XMVECTOR row2 = XMVectorReplicate((edgeB[2] * centreY) + edgeC[2]);
+			XMVECTOR rowDepth = XMVectorReplicate(v0.z + (depthY * (centreY - v0.y)) - (depthX * v0.x));
+
+			for (int x = minX; x <= maxX; x += 4)
+			{
+				XMVECTOR centreX = XMVectorAdd(XMVectorReplicate((float)x), offsets);
+				XMVECTOR inside = XMVectorAndInt(XMVectorAndInt(
+					XMVectorGreaterOrEqual(XMVectorMultiplyAdd(centreX, a0, row0), zero),
+					XMVectorGreaterOrEqual(XMVectorMultiplyAdd(centreX, a1, row1), zero)),
+					XMVectorGreaterOrEqual(XMVectorMultiplyAdd(centreX, a2, row2), zero));
+
+				XMFLOAT4* target = reinterpret_cast<XMFLOAT4*>(&depth[(y * width) + x]);
+				XMVECTOR nearest = XMVectorMin(XMLoadFloat4(target), XMVectorMultiplyAdd(centreX, stepDepth, rowDepth));
+				XMStoreFloat4(target, XMVectorSelect(XMLoadFloat4(target), nearest, inside));
+			}
+		}
+	}
+}
+
+void OcclusionCuller::buildHiZ()
+{
+	for (int level = 1; level < (int)levels.size(); level++)
+	{
+		const std::vector<float>& below = levels[level - 1];
+		std::vector<float>& above = levels[level];
+		int belowWidth = levelWidths[level - 1];
+		int belowHeight = levelHeights[level - 1];
+
+		for (int y = 0; y < levelHeights[level]; y++)
+		{
+			//An odd edge repeats its last texel
+			int y0 = y * 2;
+			int y1 = y0 + 1 < belowHeight ? y0 + 1 : y0;
+
+			for (int x = 0; x < levelWidths[level]; x++)
+			{
+				int x0 = x * 2;
+				int x1 = x0 + 1 < belowWidth ? x0 + 1 : x0;
+
+				above[(y * levelWidths[level]) + x] = fmaxf(fmaxf(below[(y0 * belowWidth) + x0], below[(y0 * belowWidth) + x1]),
+					fmaxf(below[(y1 * belowWidth) + x0], below[(y1 * belowWidth) + x1]));
+			}
+		}
+	}
+}
+
+//The box's screen rectangle is tested at the level where it spans at most two texels each way
+bool OcclusionCuller::boxVisible(const XMFLOAT3& minimum, const XMFLOAT3& maximum) const
+{
+	float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+	float nearestDepth = FLT_MAX;
+
+	for (int corner = 0; corner < 8; corner++)
+	{
+		XMFLOAT4 clip;
+		XMStoreFloat4(&clip, XMVector4Transform(XMVectorSet(corner & 1 ? maximum.x : minimum.x, corner & 2 ? maximum.y : minimum.y, corner & 4 ? maximum.z : minimum.z, 1.0f),
+			XMLoadFloat4x4(&viewProjection)));
+
+		//Reaching in front of the near plane, so it may cover the whole view
+		if (clip.z < 0.0f || clip.w <= 0.0f)
+		{
+			return true;
+		}
+
+		float inverseW = 1.0f / clip.w;
+		float x = ((clip.x * inverseW * 0.5f) + 0.5f) * (float)width;
+		float y = (0.5f - (clip.y * inverseW * 0.5f)) * (float)height;
+
+		minX = fminf(minX, x);
+		minY = fminf(minY, y);
+		maxX = fmaxf(maxX, x);
+		maxY = fmaxf(maxY, y);
+		nearestDepth = fminf(nearestDepth, clip.z * inverseW);
+	}
+
+	//Off screen boxes are left to the frustum
+	if (maxX < 0.0f || maxY < 0.0f || minX >= (float)width || minY >= (float)height)
+	{
+		return true;
+	}
+
+	int x0 = (int)fmaxf(0.0f, minX);
+	int y0 = (int)fmaxf(0.0f, minY);
+	int x1 = (int)fminf((float)(width - 1), maxX);
+	int y1 = (int)fminf((float)(height - 1), maxY);
+	int level = 0;
+
+	while (level < (int)levels.size() - 1 && (((x1 >> level) - (x0 >> level)) > 1 || ((y1 >> level) - (y0 >> level)) > 1))
+	{
+		level++;
+	}
+
+	const std::vector<float>& depths = levels[level];
+
+	for (int y = y0 >> level; y <= (y1 >> level); y++)
+	{
+		for (int x = x0 >> level; x <= (x1 >> level); x++)
+		{
+			if (depths[(y * levelWidths[level]) + x] >= nearestDepth)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+OcclusionCuller::BenchmarkResult OcclusionCuller::benchmark(int blocksPerSide, int objects, int iterations)
+{
+	BenchmarkResult result = { blocksPerSide * blocksPerSide, objects, 0, 0, 0, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+	if (blocksPerSide <= 0 || iterations <= 0)
+	{
+		return result;
+	}
+
+	//Blocks twelve units apart, each an eight unit square building between six and forty units tall, with four unit streets
+	const float blockSize = 12.0f;
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> buildingHeight(6.0f, 40.0f);
+	std::vector<XMMATRIX> buildings;
+
+	for (int z = 0; z < blocksPerSide; z++)
+	{
+		for (int x = 0; x < blocksPerSide; x++)
+		{
+			buildings.push_back(XMMatrixScaling(8.0f, buildingHeight(random), 8.0f) * XMMatrixTranslation(((float)x * blockSize) + 2.0f, 0.0f, ((float)z * blockSize) + 2.0f));
+		}
+	}
+
+	const XMFLOAT3 cube[8] =
+	{
+		XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 1.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 0.0f),
+		XMFLOAT3(0.0f, 0.0f, 1.0f), XMFLOAT3(1.0f, 0.0f, 1.0f), XMFLOAT3(0.0f, 1.0f, 1.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)
+	};
+	const unsigned int cubeIndices[36] =
+	{
+		0, 2, 1, 1, 2, 3,	4, 5, 6, 5, 7, 6,	0, 4, 2, 2, 4, 6,
+		1, 3, 5, 5, 3, 7,	0, 1, 4, 1, 5, 4,	2, 6, 3, 3, 6, 7
+	};
+
+	//Props up to two units across, along the streets between the buildings
+	float citySize = (float)blocksPerSide * blockSize;
+	std::uniform_real_distribution<float> along(0.0f, citySize);
+	std::uniform_real_distribution<float> across(-1.5f, 1.5f);
+	std::uniform_real_distribution<float> propHeight(0.0f, 3.0f);
+	std::uniform_real_distribution<float> propSize(0.5f, 2.0f);
+	std::uniform_int_distribution<int> street(0, blocksPerSide);
+	std::vector<XMFLOAT3> propMinimums(objects), propMaximums(objects);
+
+	for (int i = 0; i < objects; i++)
+	{
+		float position = along(random);
+		float streetCentre = (float)street(random) * blockSize;
+		float x = (i & 1) ? position : streetCentre + across(random);
+		float z = (i & 1) ? streetCentre + across(random) : position;
+		float y = propHeight(random);
+		float size = propSize(random);
+
+		propMinimums[i] = XMFLOAT3(x - (size * 0.5f), y, z - (size * 0.5f));
+		propMaximums[i] = XMFLOAT3(x + (size * 0.5f), y + size, z + (size * 0.5f));
+	}
+
+	//From just outside one corner at head height, looking diagonally across the city
+	XMMATRIX view = XMMatrixLookToLH(XMVectorSet(-2.0f, 1.8f, -2.0f, 1.0f), XMVectorSet(1.0f, 0.0f, 1.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+	XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PI / 3.0f, 2.0f, 0.1f, citySize * 1.5f);
+	Frustum frustum(view * projection);
+	OcclusionCuller culler;
+
+	//Only what the frustum keeps is tested for occlusion
+	std::vector<int> inFrustum;
+
+	for (int i = 0; i < objects; i++)
+	{
+		if (frustum.boxVisible(propMinimums[i], propMaximums[i]))
+		{
+			inFrustum.push_back(i);
+		}
+	}
+
+	result.inFrustum = (int)inFrustum.size();
+
+	for (int iteration = 0; iteration < iterations; iteration++)
+	{
+		culler.beginFrame(view * projection);
+
+		for (const XMMATRIX& building : buildings)
+		{
+			culler.addOccluder(cube, 8, cubeIndices, 36, building);
+		}
+
+		result.binMilliseconds += culler.getStats().binMilliseconds;
+		result.triangles = culler.getStats().occluderTriangles;
+
+		culler.rasterise(false);
+		result.singleMilliseconds += culler.getStats().rasteriseMilliseconds;
+		culler.rasterise(true);
+		result.multiMilliseconds += culler.getStats().rasteriseMilliseconds;
+		result.hiZMilliseconds += culler.getStats().hiZMilliseconds;
+
+		result.occluded = 0;
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		for (int i : inFrustum)
+		{
+			result.occluded += culler.boxVisible(propMinimums[i], propMaximums[i]) ? 0 : 1;
+		}
+
+		auto end = std::chrono::high_resolution_clock::now();
+		float testMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+		result.testNanoseconds += inFrustum.empty() ? 0.0f : (testMilliseconds * 1000000.0f) / (float)inFrustum.size();
+	}
+
+	result.binMilliseconds /= (float)iterations;
+	result.singleMilliseconds /= (float)iterations;
+	result.multiMilliseconds /= (float)iterations;
+	result.hiZMilliseconds /= (float)iterations;
+	result.testNanoseconds /= (float)iterations;
+
+	return result;
+}
\ No newline at end of file
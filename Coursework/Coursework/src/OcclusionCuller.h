@@ -0,0 +1,87 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+
+using namespace DirectX;
+
+//Occlusion culling against a small depth buffer drawn on the CPU. Occluders' triangles are transformed and binned into screen tiles,
+//then each tile is rasterised on its own thread four pixels at a time, keeping the nearest depth. A hierarchical-Z pyramid of the
+//farthest depth under each texel is built over it, and a box is occluded when its nearest point is behind every texel its screen
+//rectangle covers. Triangles crossing the near plane are left out, so they can only hide less.
+class OcclusionCuller
+{
+public:
+	struct Stats
+	{
+		int occluderTriangles;			//Added this frame
+		int rasterisedTriangles;		//In front of the near plane and on screen, counted once for every tile they touch
+		float binMilliseconds;			//Transforming and binning the occluders
+		float rasteriseMilliseconds;
+		float hiZMilliseconds;
+	};
+
+	struct BenchmarkResult
+	{
+		int buildings;
+		int objects;
+		int inFrustum;					//Objects the frustum keeps
+		int occluded;					//Of those, the objects hidden by the buildings
+		int triangles;
+		float binMilliseconds;
+		float singleMilliseconds;		//Rasterising every tile on one thread
+		float multiMilliseconds;		//A tile per thread
+		float hiZMilliseconds;
+		float testNanoseconds;			//Per object tested
+	};
+
+	OcclusionCuller(int width = 256, int height = 128);
+	~OcclusionCuller();
+
+	//Clears the depth buffer and the binned triangles for a new view
+	void beginFrame(const XMMATRIX& viewProjection);
+
+	//Transforms an indexed triangle list by the world matrix and bins its triangles into the tiles they cover
+	void addOccluder(const XMFLOAT3* vertices, int vertexCount, const unsigned int* indices, int indexCount, const XMMATRIX& world);
+
+	//Draws the binned triangles and builds the hierarchical-Z pyramid
+	void rasterise(bool multithreaded = true);
+
+	//False when a world space box is wholly hidden behind the occluders
+	bool boxVisible(const XMFLOAT3& minimum, const XMFLOAT3& maximum) const;
+
+	//Culls random props among a grid of buildings, seen from a street corner looking across the city
+	static BenchmarkResult benchmark(int blocksPerSide, int objects, int iterations);
+
+	inline int getWidth() const { return width; }
+	inline int getHeight() const { return height; }
+	inline const std::vector<float>& getDepth() const { return levels[0]; }
+	inline const Stats& getStats() const { return stats; }
+
+	static const int TILE_WIDTH = 64;	//A multiple of four, the pixels rasterised together
+	static const int TILE_HEIGHT = 32;
+
+private:
+	//Screen space, x and y in pixels and z the depth
+	struct Triangle
+	{
+		XMFLOAT3 vertices[3];
+	};
+
+	void rasteriseTile(int tile);
+	void buildHiZ();
+
+	int width;
+	int height;
+	int tilesX;
+	int tilesY;
+	XMFLOAT4X4 viewProjection;
+
+	std::vector<Triangle> triangles;
+	std::vector<std::vector<int>> tileTriangles;
+	std::vector<XMFLOAT4> clipVertices;		//Reused by addOccluder()
+	std::vector<std::vector<float>> levels;	//The depth buffer, then each level of the pyramid holding the farthest depth of four texels below
+	std::vector<int> levelWidths;
+	std::vector<int> levelHeights;
+	Stats stats;
+};
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <functional>
+
+#include "JobSystem.h"
+
+//Splits the range [0, count) into contiguous blocks and runs them as jobs on the framework's job system, returning once every block has finished
+//The body receives the first and one past the last index of its block. The calling thread runs blocks too, and everything runs on it before the system exists.
+inline void parallelFor(int count, const std::function<void(int, int)>& body, int minimumPerThread = 1)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	JobSystem* jobs = JobSystem::getShared();
+	if (!jobs)
+	{
+		body(0, count);
+		return;
+	}
+
+	jobs->parallelFor(count, body, minimumPerThread);
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "RecordingContexts.h"
+
+#include <cstring>
+
+void RecordingContexts::Context::setShader(unsigned int shader)
+{
+	Command command = { Command::SET_SHADER, shader, 0, {}, 0 };
+	commands.push_back(command);
+}
+
+void RecordingContexts::Context::setVertexBuffers(unsigned int mesh, unsigned int stride)
+{
+	Command command = { Command::SET_VERTEX_BUFFERS, mesh, stride, {}, 0 };
+	commands.push_back(command);
+}
+
+void RecordingContexts::Context::setConstants(const float* matrix)
+{
+	Command command = { Command::SET_CONSTANTS, 0, 0, {}, 0 };
+	memcpy(command.constants, matrix, sizeof(command.constants));
+	commands.push_back(command);
+}
+
+void RecordingContexts::Context::drawIndexed(unsigned int indexCount)
+{
+	Command command = { Command::DRAW_INDEXED, indexCount, 0, {}, 0 };
+	commands.push_back(command);
+}
+
+void RecordingContexts::Context::drawIndexedInstanced(unsigned int indexCount, unsigned int instanceCount)
+{
+	Command command = { Command::DRAW_INDEXED_INSTANCED, indexCount, 0, {}, instanceCount };
+	commands.push_back(command);
+}
+
+void* RecordingContexts::Context::mapInstances(unsigned int bytes)
+{
+	Command command = { Command::MAP_INSTANCES, bytes, 0, {}, 0 };
+	commands.push_back(command);
+
+	size_t offset = instanceBytes.size();
+	instanceBytes.resize(offset + bytes);
+	return instanceBytes.data() + offset;
+}
+
+RecordingContexts::RecordingContexts() : executedDraws(0), executedInstances(0), executedInstanceBytes(0)
+{
+}
+
+RecordingContexts::~RecordingContexts()
+{
+}
+
+void RecordingContexts::reserveContexts(int count)
+{
+	if ((int)contexts.size() < count)
+	{
+		contexts.resize(count);
+		lists.resize(count);
+		listInstanceBytes.resize(count);
+	}
+}
+
+//The context's buffer becomes the list, and the list's old storage is cleared for the context's next pass
+void RecordingContexts::finish(int context)
+{
+	lists[context].swap(contexts[context].commands);
+	contexts[context].commands.clear();
+	listInstanceBytes[context].swap(contexts[context].instanceBytes);
+	contexts[context].instanceBytes.clear();
+}
+
+void RecordingContexts::execute(int context)
+{
+	for (const Command& command : lists[context])
+	{
+		executedDraws += command.type == Command::DRAW_INDEXED || command.type == Command::DRAW_INDEXED_INSTANCED ? 1 : 0;
+		executedInstances += command.type == Command::DRAW_INDEXED ? 1 : command.type == Command::DRAW_INDEXED_INSTANCED ? command.instances : 0;
+	}
+
+	executedInstanceBytes += listInstanceBytes[context].size();
+	listInstanceBytes[context].clear();
+
+	executed.insert(executed.end(), lists[context].begin(), lists[context].end());
+	lists[context].clear();
+}
+
+void RecordingContexts::clearExecuted()
+{
+	executed.clear();
+	executedDraws = 0;
+	executedInstances = 0;
+	executedInstanceBytes = 0;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+
+#include "CommandRecorder.h"
+
+//Headless side of command recording - each pass records the calls a depth or post processing pass makes into a plain command buffer,
+//and executing a list appends its commands to one stream in the order a device would have received them. Stands in for
+//DeferredContexts where there is no device, so CommandRecorder can be tested and timed on its own.
+class RecordingContexts : public CommandBackend
+{
+public:
+	struct Command
+	{
+		enum Type
+		{
+			SET_SHADER,
+			SET_VERTEX_BUFFERS,
+			SET_CONSTANTS,
+			MAP_INSTANCES,
+			DRAW_INDEXED,
+			DRAW_INDEXED_INSTANCED
+		};
+
+		Type type;
+		unsigned int value;		//The shader or mesh, the index count of a draw, the bytes of a map
+		unsigned int stride;	//Bytes per vertex of the bound buffers
+		float constants[16];	//A transposed matrix, as a shader's parameters map it
+		unsigned int instances;	//Instances of an instanced draw
+	};
+
+	//What one pass records into, from one thread at a time
+	class Context
+	{
+	public:
+		void setShader(unsigned int shader);
+		void setVertexBuffers(unsigned int mesh, unsigned int stride);
+		void setConstants(const float* matrix);
+		void drawIndexed(unsigned int indexCount);
+		void drawIndexedInstanced(unsigned int indexCount, unsigned int instanceCount);
+
+		//Memory for an instance buffer's contents, valid until the next map, which the list carries to execution as a deferred
+		//context's discarding map does
+		void* mapInstances(unsigned int bytes);
+
+		inline int getCommandCount() const { return (int)commands.size(); }
+
+	private:
+		friend class RecordingContexts;
+
+		std::vector<Command> commands;
+		std::vector<unsigned char> instanceBytes;
+	};
+
+	RecordingContexts();
+	~RecordingContexts();
+
+	void reserveContexts(int count) override;
+	void finish(int context) override;
+	void execute(int context) override;
+
+	//Forgets the commands executed so far
+	void clearExecuted();
+
+	inline Context* getContext(int context) { return &contexts[context]; }
+	inline int getContextCount() const { return (int)contexts.size(); }
+	inline const std::vector<Command>& getExecuted() const { return executed; }
+	inline int getExecutedDraws() const { return executedDraws; }
+	inline long long getExecutedInstances() const { return executedInstances; }
+	inline size_t getExecutedInstanceBytes() const { return executedInstanceBytes; }
+
+private:
+	std::vector<Context> contexts;
+	std::vector<std::vector<Command>> lists;	//Each context's finished list, waiting to be executed
+	std::vector<std::vector<unsigned char>> listInstanceBytes;
+	std::vector<Command> executed;
+	int executedDraws;
+	long long executedInstances;
+	size_t executedInstanceBytes;
+};
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "RenderStats.h"
+
+void RenderStats::beginFrame()
+{
+	passes.clear();
+	currentPass = -1;
+}
+
+void RenderStats::beginPass(const std::string& name)
+{
+	for (size_t i = 0; i < passes.size(); i++)
+	{
+		if (passes[i].name == name)
+		{
+			currentPass = (int)i;
+			return;
+		}
+	}
+
+	passes.push_back({ name, 0, 0, 0, 0, 0, 0 });
+	currentPass = (int)passes.size() - 1;
+}
+
+void RenderStats::recordDraw(int indexCount, int vertexCount, unsigned int bytesPerVertex)
+{
+	if (currentPass < 0)
+	{
+		beginPass("Unnamed");
+	}
+
+	PassStats& pass = passes[currentPass];
+	pass.draws++;
+	pass.triangles += indexCount / 3;
+	pass.vertexBytes += (long long)vertexCount * bytesPerVertex;
+}
+
+void RenderStats::recordCulling(int visible, int culled, int occluded)
+{
+	if (currentPass < 0)
+	{
+		beginPass("Unnamed");
+	}
+
+	passes[currentPass].visibleObjects += visible;
+	passes[currentPass].culledObjects += culled;
+	passes[currentPass].occludedObjects += occluded;
+}
+
+void RenderStats::merge(const RenderStats& other)
+{
+	for (const PassStats& otherPass : other.passes)
+	{
+		beginPass(otherPass.name);
+
+		PassStats& pass = passes[currentPass];
+		pass.draws += otherPass.draws;
+		pass.triangles += otherPass.triangles;
+		pass.vertexBytes += otherPass.vertexBytes;
+		pass.visibleObjects += otherPass.visibleObjects;
+		pass.culledObjects += otherPass.culledObjects;
+		pass.occludedObjects += otherPass.occludedObjects;
+	}
+}
\ No newline at end of file
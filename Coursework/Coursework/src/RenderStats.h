@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+//Counts what each pass of a frame submits: draws, triangles and the bytes of every vertex stream the draws had bound. Each vertex
+//a draw's buffers hold counts once, which is what the input assembler fetches when the post-transform cache catches every repeat.
+class RenderStats
+{
+public:
+	struct PassStats
+	{
+		std::string name;
+		int draws;
+		int triangles;
+		long long vertexBytes;
+		int visibleObjects;		//Left by the pass's culling
+		int culledObjects;		//Outside the frustum
+		int occludedObjects;	//In the frustum, hidden behind occluders
+	};
+
+	//Forgets the last frame's passes
+	void beginFrame();
+	//Draws recorded from here on count towards the named pass, which carries on if the frame already has it
+	void beginPass(const std::string& name);
+	//Records a draw of a mesh's indices from the streams sendData() or sendPositionData() bound, given the bytes per vertex it returned
+	void recordDraw(int indexCount, int vertexCount, unsigned int bytesPerVertex);
+	void recordCulling(int visible, int culled, int occluded = 0);
+	//Adds another frame's passes to those of the same name, for passes recorded on other threads with their own stats
+	void merge(const RenderStats& other);
+
+	inline const std::vector<PassStats>& getPasses() const { return passes; }
+
+private:
+	std::vector<PassStats> passes;
+	int currentPass = -1;
+};
\ No newline at end of file
@@ -0,0 +1,272 @@
+#include "SceneGraph.h"
+#include "ParallelFor.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+//Depths with fewer nodes than this for each thread are updated on the calling thread
+static const int MIN_NODES_PER_THREAD = 2048;
+
+SceneGraph::SceneGraph() : levelsBuilt(true), firstDirtyDepth(-1), updateStamp(0), lastUpdated(0), lastMilliseconds(0.0f)
+{
+
+}
+
+SceneGraph::~SceneGraph()
+{
+
+}
+
+int SceneGraph::createNode(int parent, const XMFLOAT3& position, const XMFLOAT4& rotation, const XMFLOAT3& scale)
+{
+	int node = (int)parents.size();
+
+	parents.push_back(parent < node ? parent : -1);
+	positions.push_back(position);
+	rotations.push_back(rotation);
+	scales.push_back(scale);
+	depths.push_back(parents.back() >= 0 ? depths[parents.back()] + 1 : 0);
+	dirty.push_back(0);
+	updateStamps.push_back(0);
+
+	XMFLOAT4X4 identity;
+	XMStoreFloat4x4(&identity, XMMatrixIdentity());
+	worlds.push_back(identity);
+
+	levelsBuilt = false;
+	markDirty(node);
+
+	return node;
+}
+
+void SceneGraph::setPosition(int node, const XMFLOAT3& position)
+{
+	positions[node] = position;
+	markDirty(node);
+}
+
+void SceneGraph::setRotation(int node, const XMFLOAT4& rotation)
+{
+	rotations[node] = rotation;
+	markDirty(node);
+}
+
+void SceneGraph::setScale(int node, const XMFLOAT3& scale)
+{
+	scales[node] = scale;
+	markDirty(node);
+}
+
+void SceneGraph::markDirty(int node)
+{
+	if (!dirty[node] && (firstDirtyDepth < 0 || depths[node] < firstDirtyDepth))
+	{
+		firstDirtyDepth = depths[node];
+	}
+
+	dirty[node] = 1;
+}
+
+//Counting sort of the nodes by depth
+void SceneGraph::buildLevels()
+{
+	int maxDepth = -1;
+
+	for (int depth : depths)
+	{
+		maxDepth = depth > maxDepth ? depth : maxDepth;
+	}
+
+	levelStarts.assign(maxDepth + 2, 0);
+
+	for (int depth : depths)
+	{
+		levelStarts[depth + 1]++;
+	}
+
+	for (int i = 1; i < (int)levelStarts.size(); i++)
+	{
+		levelStarts[i] += levelStarts[i - 1];
+	}
+
+	std::vector<int> next(levelStarts.begin(), levelStarts.end() - 1);
+	levelNodes.resize(parents.size());
+
+	for (int node = 0; node < (int)parents.size(); node++)
+	{
+		levelNodes[next[depths[node]]++] = node;
+	}
+
+	levelsBuilt = true;
+}
+
+//A node is recomputed when it was changed or its parent was recomputed by this update, which its parent's depth finished before this one
+int SceneGraph::updateNodes(const int* nodes, int count)
+{
+	int updated = 0;
+
+	for (int i = 0; i < count; i++)
+	{
+		int node = nodes[i];
+		int parent = parents[node];
+		bool parentMoved = parent >= 0 && updateStamps[parent] == updateStamp;
+
+		if (!dirty[node] && !parentMoved)
+		{
+			continue;
+		}
+
+		XMMATRIX local = XMMatrixScaling(scales[node].x, scales[node].y, scales[node].z) * XMMatrixRotationQuaternion(XMLoadFloat4(&rotations[node])) *
+			XMMatrixTranslation(positions[node].x, positions[node].y, positions[node].z);
+
+		if (parent >= 0)
+		{
+			local = XMMatrixMultiply(local, XMLoadFloat4x4(&worlds[parent]));
+		}
+
+		XMStoreFloat4x4(&worlds[node], local);
+		updateStamps[node] = updateStamp;
+		dirty[node] = 0;
+		updated++;
+	}
+
+	return updated;
+}
+
+void SceneGraph::update(bool multithreaded)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	//A new stamp, so nodes recomputed by earlier updates don't count as moved
+	updateStamp++;
+	lastUpdated = 0;
+
+	if (firstDirtyDepth < 0)
+	{
+		lastMilliseconds = 0.0f;
+		return;
+	}
+
+	if (!levelsBuilt)
+	{
+		buildLevels();
+	}
+
+	for (int depth = firstDirtyDepth; depth < (int)levelStarts.size() - 1; depth++)
+	{
+		const int* nodes = levelNodes.data() + levelStarts[depth];
+		int count = levelStarts[depth + 1] - levelStarts[depth];
+
+		if (multithreaded)
+		{
+			std::atomic<int> updated(0);
+
+			parallelFor(count, [&](int begin, int end)
+			{
+				updated += updateNodes(nodes + begin, end - begin);
+			}, MIN_NODES_PER_THREAD);
+
+			lastUpdated += updated;
+		}
+
+		else
+		{
+			lastUpdated += updateNodes(nodes, count);
+		}
+	}
+
+	firstDirtyDepth = -1;
+
+	auto end = std::chrono::high_resolution_clock::now();
+	lastMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+SceneGraph::BenchmarkResult SceneGraph::benchmark(int nodes, int branching, int iterations)
+{
+	BenchmarkResult result = { nodes, 0, 0, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+	if (nodes <= 0 || branching <= 0 || iterations <= 0)
+	{
+		return result;
+	}
+
+	//A single root with every node below it, small random offsets, turns and scales so the matrices aren't trivial
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> angle(-XM_PI, XM_PI);
+	std::uniform_real_distribution<float> scale(0.9f, 1.1f);
+	SceneGraph single, multi;
+
+	for (int i = 0; i < nodes; i++)
+	{
+		int parent = i > 0 ? (i - 1) / branching : -1;
+		XMFLOAT3 position(offset(random), offset(random), offset(random));
+		XMFLOAT4 rotation;
+		XMStoreFloat4(&rotation, XMQuaternionRotationRollPitchYaw(angle(random), angle(random), angle(random)));
+		XMFLOAT3 size(scale(random), scale(random), scale(random));
+
+		single.createNode(parent, position, rotation, size);
+		multi.createNode(parent, position, rotation, size);
+		result.depth = single.depths.back() > result.depth ? single.depths.back() : result.depth;
+	}
+
+	single.update(false);
+	multi.update(true);
+
+	std::uniform_int_distribution<int> pick(0, nodes - 1);
+	int sparseCount = nodes / 100 > 1 ? nodes / 100 : 1;
+	std::vector<int> sparse(sparseCount);
+
+	for (int iteration = 0; iteration < iterations; iteration++)
+	{
+		//Moving the root dirties everything
+		XMFLOAT3 root((float)iteration, 0.0f, 0.0f);
+		single.setPosition(0, root);
+		multi.setPosition(0, root);
+
+		single.update(false);
+		result.rootSingleMilliseconds += single.getLastMilliseconds();
+		multi.update(true);
+		result.rootMultiMilliseconds += multi.getLastMilliseconds();
+
+		for (int& node : sparse)
+		{
+			node = pick(random);
+		}
+
+		XMFLOAT4 turn;
+		XMStoreFloat4(&turn, XMQuaternionRotationRollPitchYaw(0.0f, (float)iteration * 0.1f, 0.0f));
+
+		for (int node : sparse)
+		{
+			single.setRotation(node, turn);
+			multi.setRotation(node, turn);
+		}
+
+		single.update(false);
+		result.sparseSingleMilliseconds += single.getLastMilliseconds();
+		multi.update(true);
+		result.sparseMultiMilliseconds += multi.getLastMilliseconds();
+		result.sparseNodes = single.getLastUpdated();
+	}
+
+	result.rootSingleMilliseconds /= (float)iterations;
+	result.rootMultiMilliseconds /= (float)iterations;
+	result.sparseSingleMilliseconds /= (float)iterations;
+	result.sparseMultiMilliseconds /= (float)iterations;
+
+	for (int i = 0; i < nodes; i++)
+	{
+		const float* a = &single.worlds[i]._11;
+		const float* b = &multi.worlds[i]._11;
+
+		for (int element = 0; element < 16; element++)
+		{
+			result.maxDifference = fmaxf(result.maxDifference, fabsf(a[element] - b[element]));
+		}
+	}
+
+	return result;
+}
\ No newline at end of file
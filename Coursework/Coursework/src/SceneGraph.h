@@ -0,0 +1,74 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+
+using namespace DirectX;
+
+//The scene's objects as nodes with a local transform and a parent, kept as structure of arrays. Each node caches its world matrix,
+//which every pass reads. Changing a node marks it dirty, and update() recomputes the dirty nodes and everything below them one depth
+//at a time, so a node's parent is always done first. The nodes of a depth are split across threads.
+class SceneGraph
+{
+public:
+	struct BenchmarkResult
+	{
+		int nodes;
+		int depth;						//Deepest node, the roots are at 0
+		int sparseNodes;				//Recomputed by the sparse update, the dirtied nodes and their subtrees
+		float rootSingleMilliseconds;	//Every node recomputed after moving the roots, one thread
+		float rootMultiMilliseconds;	//Every thread
+		float sparseSingleMilliseconds;	//One node in a hundred dirtied at random, one thread
+		float sparseMultiMilliseconds;
+		float maxDifference;			//Largest world matrix element difference between the single and multithreaded graphs
+	};
+
+	SceneGraph();
+	~SceneGraph();
+
+	//Adds a node below the parent, or a root for -1. Parents must be created before their children.
+	int createNode(int parent, const XMFLOAT3& position, const XMFLOAT4& rotation = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f), const XMFLOAT3& scale = XMFLOAT3(1.0f, 1.0f, 1.0f));
+
+	void setPosition(int node, const XMFLOAT3& position);
+	void setRotation(int node, const XMFLOAT4& rotation);	//Quaternion
+	void setScale(int node, const XMFLOAT3& scale);
+
+	//Recomputes the world matrices of the dirty nodes and their subtrees
+	void update(bool multithreaded = true);
+
+	//Times hierarchy updates of a graph of the given number of nodes, each with up to branching children
+	static BenchmarkResult benchmark(int nodes, int branching, int iterations);
+
+	inline XMMATRIX getWorldMatrix(int node) const { return XMLoadFloat4x4(&worlds[node]); }
+	inline const XMFLOAT3& getPosition(int node) const { return positions[node]; }
+	inline const XMFLOAT4& getRotation(int node) const { return rotations[node]; }
+	inline const XMFLOAT3& getScale(int node) const { return scales[node]; }
+	inline int getParent(int node) const { return parents[node]; }
+	inline bool wasUpdated(int node) const { return updateStamps[node] == updateStamp; }	//By the last update()
+	inline int getNodeCount() const { return (int)parents.size(); }
+	inline int getLastUpdated() const { return lastUpdated; }
+	inline float getLastMilliseconds() const { return lastMilliseconds; }
+
+private:
+	void markDirty(int node);
+	void buildLevels();
+	int updateNodes(const int* nodes, int count);
+
+	std::vector<int> parents;
+	std::vector<XMFLOAT3> positions;
+	std::vector<XMFLOAT4> rotations;
+	std::vector<XMFLOAT3> scales;
+	std::vector<XMFLOAT4X4> worlds;
+	std::vector<int> depths;
+	std::vector<unsigned char> dirty;
+	std::vector<unsigned int> updateStamps;	//The update that last recomputed each node, so children know their parent moved
+
+	std::vector<int> levelNodes;		//Every node, sorted by depth
+	std::vector<int> levelStarts;		//Where each depth begins in levelNodes, with one past the last
+	bool levelsBuilt;
+
+	int firstDirtyDepth;				//Shallowest dirty node, the depths above it are skipped
+	unsigned int updateStamp;
+	int lastUpdated;
+	float lastMilliseconds;
+};
\ No newline at end of file
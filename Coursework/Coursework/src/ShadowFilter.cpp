@@ -0,0 +1,277 @@
+#include "ShadowFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+ShadowFilter::ShadowFilter(int sampleCount, int blockerSamples)
+{
+	lightSize = 12.0f;
+	minVariance = 0.00002f;
+	bleedReduction = 0.2f;
+	blockerSampleCount = 0;
+
+	generatePoissonDisk(sampleCount);
+	setBlockerSampleCount(blockerSamples);
+}
+
+ShadowFilter::~ShadowFilter()
+{
+
+}
+
+//Dart throwing inside the unit disk, the minimum spacing is relaxed whenever a sample can't be placed
+void ShadowFilter::generatePoissonDisk(int count, unsigned int seed)
+{
+	sampleCount = std::max(1, std::min(count, MAX_SAMPLES));
+	poissonDisk.clear();
+
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+	//Spacing for roughly half of the disk area to be covered by the exclusion radii
+	float minDistance = sqrtf(2.0f / (float)sampleCount);
+	int attempts = 0;
+
+	while ((int)poissonDisk.size() < sampleCount)
+	{
+		XMFLOAT2 candidate(distribution(generator), distribution(generator));
+
+		if ((candidate.x * candidate.x) + (candidate.y * candidate.y) > 1.0f)
+		{
+			continue;
+		}
+
+		bool accepted = true;
+
+		for (const XMFLOAT2& sample : poissonDisk)
+		{
+			float dx = sample.x - candidate.x;
+			float dy = sample.y - candidate.y;
+
+			if ((dx * dx) + (dy * dy) < minDistance * minDistance)
+			{
+				accepted = false;
+				break;
+			}
+		}
+
+		if (accepted)
+		{
+			poissonDisk.push_back(candidate);
+			attempts = 0;
+		}
+
+		else if (++attempts > 1000)
+		{
+			minDistance *= 0.9f;
+			attempts = 0;
+		}
+	}
+
+	if (blockerSampleCount > sampleCount)
+	{
+		blockerSampleCount = sampleCount;
+	}
+}
+
+float ShadowFilter::DepthMap::load(int x, int y) const
+{
+	if (x < 0 || y < 0 || x >= width || y >= height)
+	{
+		return 1.0f;
+	}
+
+	return depths[(y * width) + x];
+}
+
+float ShadowFilter::DepthMap::samplePoint(XMFLOAT2 uv) const
+{
+	return load((int)floorf(uv.x * (float)width), (int)floorf(uv.y * (float)height));
+}
+
+float ShadowFilter::DepthMap::sampleCompare(XMFLOAT2 uv, float compareDepth) const
+{
+	//Same texel footprint as a D3D11_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT sampler
+	float x = (uv.x * (float)width) - 0.5f;
+	float y = (uv.y * (float)height) - 0.5f;
+	int x0 = (int)floorf(x);
+	int y0 = (int)floorf(y);
+	float fx = x - (float)x0;
+	float fy = y - (float)y0;
+
+	float s00 = compareDepth <= load(x0, y0) ? 1.0f : 0.0f;
+	float s10 = compareDepth <= load(x0 + 1, y0) ? 1.0f : 0.0f;
+	float s01 = compareDepth <= load(x0, y0 + 1) ? 1.0f : 0.0f;
+	float s11 = compareDepth <= load(x0 + 1, y0 + 1) ? 1.0f : 0.0f;
+
+	float top = s00 + ((s10 - s00) * fx);
+	float bottom = s01 + ((s11 - s01) * fx);
+
+	return top + ((bottom - top) * fy);
+}
+
+float ShadowFilter::filterGrid(const DepthMap& map, XMFLOAT2 uv, float depth, float bias, int radius, int& samples) const
+{
+	float shadow = 0.0f;
+	float pixelCount = 0.0f;
+
+	for (int x = -radius; x <= radius; ++x)
+	{
+		for (int y = -radius; y <= radius; ++y)
+		{
+			XMFLOAT2 offset(uv.x + ((float)x / (float)map.width), uv.y + ((float)y / (float)map.height));
+			shadow += (depth - bias) > map.samplePoint(offset) ? 1.0f : 0.0f;
+			pixelCount += 1.0f;
+		}
+	}
+
+	samples = (int)pixelCount;
+
+	return 1.0f - (shadow / pixelCount);
+}
+
+float ShadowFilter::filterPoisson(const DepthMap& map, XMFLOAT2 uv, float depth, float bias, float radius, float rotation, int& samples) const
+{
+	float s = sinf(rotation);
+	float c = cosf(rotation);
+	float lit = 0.0f;
+
+	for (int i = 0; i < sampleCount; i++)
+	{
+		//mul(row vector, float2x2(c, -s, s, c)) in the shader
+		float rx = (poissonDisk[i].x * c) + (poissonDisk[i].y * s);
+		float ry = (poissonDisk[i].x * -s) + (poissonDisk[i].y * c);
+
+		XMFLOAT2 offset(uv.x + ((rx * radius) / (float)map.width), uv.y + ((ry * radius) / (float)map.height));
+		lit += map.sampleCompare(offset, depth - bias);
+	}
+
+	samples = sampleCount;
+
+	return lit / (float)sampleCount;
+}
+
+float ShadowFilter::filterPCSS(const DepthMap& map, XMFLOAT2 uv, float depth, float bias, float maxRadius, float rotation, int& samples) const
+{
+	float s = sinf(rotation);
+	float c = cosf(rotation);
+	float blockerSum = 0.0f;
+	float blockerCount = 0.0f;
+
+	//Blocker search over the light size footprint
+	for (int i = 0; i < blockerSampleCount; i++)
+	{
+		float rx = (poissonDisk[i].x * c) + (poissonDisk[i].y * s);
+		float ry = (poissonDisk[i].x * -s) + (poissonDisk[i].y * c);
+
+		XMFLOAT2 offset(uv.x + ((rx * lightSize) / (float)map.width), uv.y + ((ry * lightSize) / (float)map.height));
+		float blockerDepth = map.samplePoint(offset);
+
+		if (blockerDepth < depth - bias)
+		{
+			blockerSum += blockerDepth;
+			blockerCount += 1.0f;
+		}
+	}
+
+	if (blockerCount == 0.0f)
+	{
+		samples = blockerSampleCount;
+		return 1.0f;
+	}
+
+	//Penumbra estimate from similar triangles between the receiver, the blockers and the light
+	float averageBlocker = blockerSum / blockerCount;
+	float penumbra = ((depth - averageBlocker) / averageBlocker) * lightSize;
+	float radius = std::max(1.0f, std::min(penumbra, maxRadius));
+
+	float lit = filterPoisson(map, uv, depth, bias, radius, rotation, samples);
+	samples += blockerSampleCount;
+
+	return lit;
+}
+
+ShadowFilter::ComparisonResult ShadowFilter::compareWithGrid(const DepthMap& map, float receiverDepth, float bias, int radius, FilterMode mode) const
+{
+	ComparisonResult result = { 0.0f, 0.0f, 0.0f, 0.0f };
+	double differenceSum = 0.0;
+	double gridSamples = 0.0;
+	double filterSamples = 0.0;
+
+	for (int y = 0; y < map.height; y++)
+	{
+		for (int x = 0; x < map.width; x++)
+		{
+			XMFLOAT2 uv(((float)x + 0.5f) / (float)map.width, ((float)y + 0.5f) / (float)map.height);
+			int samples = 0;
+
+			float reference = filterGrid(map, uv, receiverDepth, bias, radius, samples);
+			gridSamples += samples;
+
+			float filtered = reference;
+			float rotation = XM_2PI * interleavedGradientNoise((float)x + 0.5f, (float)y + 0.5f);
+
+			if (mode == FILTER_POISSON)
+			{
+				filtered = filterPoisson(map, uv, receiverDepth, bias, (float)radius, rotation, samples);
+			}
+
+			else if (mode == FILTER_PCSS)
+			{
+				filtered = filterPCSS(map, uv, receiverDepth, bias, (float)radius, rotation, samples);
+			}
+
+			filterSamples += samples;
+
+			float difference = fabsf(filtered - reference);
+			differenceSum += difference;
+			result.maxDifference = std::max(result.maxDifference, difference);
+		}
+	}
+
+	double pixelCount = (double)map.width * (double)map.height;
+	result.meanDifference = (float)(differenceSum / pixelCount);
+	result.gridSamplesPerPixel = (float)(gridSamples / pixelCount);
+	result.filterSamplesPerPixel = (float)(filterSamples / pixelCount);
+
+	return result;
+}
+
+//A receiver plane partly covered by a box and a disk occluder, gives straight and curved shadow edges to filter
+ShadowFilter::DepthMap ShadowFilter::buildTestDepthMap(int size, float receiverDepth, float occluderDepth)
+{
+	DepthMap map;
+	map.width = size;
+	map.height = size;
+	map.depths.assign(size * size, receiverDepth);
+
+	float centre = (float)size * 0.7f;
+	float diskRadius = (float)size * 0.15f;
+
+	for (int y = 0; y < size; y++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			bool inBox = x > size / 8 && x < size / 2 && y > size / 4 && y < (size * 3) / 4;
+			float dx = (float)x - centre;
+			float dy = (float)y - centre;
+			bool inDisk = ((dx * dx) + (dy * dy)) < (diskRadius * diskRadius);
+
+			if (inBox || inDisk)
+			{
+				map.depths[(y * size) + x] = occluderDepth;
+			}
+		}
+	}
+
+	return map;
+}
+
+//Matches getSampleRotation in light_ps.hlsl
+float ShadowFilter::interleavedGradientNoise(float x, float y)
+{
+	float value = 52.9829189f * ((0.06711056f * x) + (0.00583715f * y) - floorf((0.06711056f * x) + (0.00583715f * y)));
+
+	return value - floorf(value);
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+
+using namespace DirectX;
+
+//Generates the rotated Poisson disk patterns used by light_ps.hlsl for filtered shadows
+//Also provides a CPU reference of each shadow filter so the patterns can be compared against the original NxN loop
+class ShadowFilter
+{
+public:
+	static const int MAX_SAMPLES = 64;
+
+	//Matches the shadowFilterMode value sent to the pixel shader for each light
+	enum FilterMode
+	{
+		FILTER_GRID = 0,	//Original (2r+1)^2 point sample loop
+		FILTER_POISSON = 1,	//Hardware comparison PCF over a rotated Poisson disk
+		FILTER_PCSS = 2,	//Blocker search followed by Poisson PCF with a variable radius
+		FILTER_VSM = 3,		//Single filtered fetch of prefiltered depth moments, see MomentShadow
+		FILTER_EVSM = 4		//As VSM with exponentially warped moments
+	};
+
+	//A CPU copy of a shadow map, sampled the same way as the shadow samplers in LightShader
+	struct DepthMap
+	{
+		int width;
+		int height;
+		std::vector<float> depths;
+
+		float load(int x, int y) const;		//Out of range texels return the border depth of 1.0f
+		float samplePoint(XMFLOAT2 uv) const;
+		float sampleCompare(XMFLOAT2 uv, float compareDepth) const;	//Bilinear weighted (compareDepth <= depth) test
+	};
+
+	struct ComparisonResult
+	{
+		float meanDifference;
+		float maxDifference;
+		float gridSamplesPerPixel;
+		float filterSamplesPerPixel;
+	};
+
+	ShadowFilter(int sampleCount = 16, int blockerSamples = 8);
+	~ShadowFilter();
+
+	void generatePoissonDisk(int count, unsigned int seed = 1802644);
+
+	inline void setBlockerSampleCount(int count) { blockerSampleCount = count < sampleCount ? count : sampleCount; }
+	inline void setLightSize(float size) { lightSize = size; }
+	inline void setMinVariance(float variance) { minVariance = variance; }
+	inline void setBleedReduction(float reduction) { bleedReduction = reduction; }
+
+	inline const std::vector<XMFLOAT2>& getPoissonDisk() const { return poissonDisk; }
+	inline int getSampleCount() const { return sampleCount; }
+	inline int getBlockerSampleCount() const { return blockerSampleCount; }
+	inline float getLightSize() const { return lightSize; }
+	inline float getMinVariance() const { return minVariance; }
+	inline float getBleedReduction() const { return bleedReduction; }
+
+	//CPU references of the shader filters, each returns the lit fraction (1.0f fully lit) and the number of depth fetches made
+	float filterGrid(const DepthMap& map, XMFLOAT2 uv, float depth, float bias, int radius, int& samples) const;
+	float filterPoisson(const DepthMap& map, XMFLOAT2 uv, float depth, float bias, float radius, float rotation, int& samples) const;
+	float filterPCSS(const DepthMap& map, XMFLOAT2 uv, float depth, float bias, float maxRadius, float rotation, int& samples) const;
+
+	//Filters every texel of a receiver plane with the given mode and measures it against the grid loop
+	ComparisonResult compareWithGrid(const DepthMap& map, float receiverDepth, float bias, int radius, FilterMode mode) const;
+
+	static DepthMap buildTestDepthMap(int size, float receiverDepth, float occluderDepth);
+	static float interleavedGradientNoise(float x, float y);
+
+private:
+	std::vector<XMFLOAT2> poissonDisk;
+	int sampleCount;
+	int blockerSampleCount;
+	float lightSize;
+	float minVariance;
+	float bleedReduction;
+};
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "StateCache.h"
+
+StateCache::StateCache()
+{
+	invalidate();
+	resetCounters();
+}
+
+StateCache::~StateCache()
+{
+}
+
+void StateCache::invalidate()
+{
+	shader = UNBOUND;
+	material = UNBOUND;
+	mesh = UNBOUND;
+}
+
+void StateCache::resetCounters()
+{
+	counters = { 0, 0, 0, 0, 0 };
+}
+
+bool StateCache::setShader(unsigned int newShader)
+{
+	if (newShader == shader)
+	{
+		counters.skippedBinds++;
+		return false;
+	}
+
+	shader = newShader;
+	material = UNBOUND;
+	counters.shaderBinds++;
+	return true;
+}
+
+bool StateCache::setMaterial(unsigned int newMaterial)
+{
+	if (newMaterial == material)
+	{
+		counters.skippedBinds++;
+		return false;
+	}
+
+	material = newMaterial;
+	counters.materialBinds++;
+	return true;
+}
+
+bool StateCache::setMesh(unsigned int newMesh)
+{
+	if (newMesh == mesh)
+	{
+		counters.skippedBinds++;
+		return false;
+	}
+
+	mesh = newMesh;
+	counters.meshBinds++;
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+//Shadows the shader, material and mesh last bound, so binding what is already bound can be skipped. Counts the binds made and
+//skipped since the counters were reset, which the application does once a frame.
+class StateCache
+{
+public:
+	struct Counters
+	{
+		int shaderBinds;
+		int materialBinds;
+		int meshBinds;
+		int skippedBinds;
+		int draws;
+	};
+
+	StateCache();
+	~StateCache();
+
+	//Forgets what is bound, for after other draws have bound their own state
+	void invalidate();
+	void resetCounters();
+
+	//True when the state isn't the one bound, and must then be bound by the caller. A new shader also needs its material bound again,
+	//as it may read its textures from other slots.
+	bool setShader(unsigned int shader);
+	bool setMaterial(unsigned int material);
+	bool setMesh(unsigned int mesh);
+	inline void countDraw() { counters.draws++; }
+
+	inline const Counters& getCounters() const { return counters; }
+	inline int getBinds() const { return counters.shaderBinds + counters.materialBinds + counters.meshBinds; }
+
+private:
+	static const unsigned int UNBOUND = 0xffffffff;
+
+	unsigned int shader;
+	unsigned int material;
+	unsigned int mesh;
+	Counters counters;
+};
\ No newline at end of file
@@ -0,0 +1,258 @@
+#include "TerrainBaker.h"
+#include "ParallelFor.h"
+#include "TerrainQuadtree.h"
+#include "DirtyTileTracker.h"
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+void TerrainBaker::computeNormals(const float* left, const float* right, const float* top, const float* bottom, int count, float amplitude, float cellSize, XMFLOAT3* normals)
+{
+	XMVECTOR scale = XMVectorReplicate(amplitude);
+	XMVECTOR up = XMVectorReplicate(2.0f * cellSize);
+	XMVECTOR upSquared = XMVectorMultiply(up, up);
+	int i = 0;
+
+	//Structure of arrays, each vector holds one component of four normals
+	for (; i + 4 <= count; i += 4)
+	{
+		XMVECTOR leftHeights = XMLoadFloat4((const XMFLOAT4*)(left + i));
+		XMVECTOR rightHeights = XMLoadFloat4((const XMFLOAT4*)(right + i));
+		XMVECTOR topHeights = XMLoadFloat4((const XMFLOAT4*)(top + i));
+		XMVECTOR bottomHeights = XMLoadFloat4((const XMFLOAT4*)(bottom + i));
+
+		XMVECTOR x = XMVectorMultiply(XMVectorSubtract(leftHeights, rightHeights), scale);
+		XMVECTOR z = XMVectorMultiply(XMVectorSubtract(bottomHeights, topHeights), scale);
+		XMVECTOR inverseLength = XMVectorReciprocalSqrt(XMVectorMultiplyAdd(x, x, XMVectorMultiplyAdd(z, z, upSquared)));
+
+		XMFLOAT4 normalX, normalY, normalZ;
+		XMStoreFloat4(&normalX, XMVectorMultiply(x, inverseLength));
+		XMStoreFloat4(&normalY, XMVectorMultiply(up, inverseLength));
+		XMStoreFloat4(&normalZ, XMVectorMultiply(z, inverseLength));
+
+		normals[i] = XMFLOAT3(normalX.x, normalY.x, normalZ.x);
+		normals[i + 1] = XMFLOAT3(normalX.y, normalY.y, normalZ.y);
+		normals[i + 2] = XMFLOAT3(normalX.z, normalY.z, normalZ.z);
+		normals[i + 3] = XMFLOAT3(normalX.w, normalY.w, normalZ.w);
+	}
+
+	computeNormalsScalar(left + i, right + i, top + i, bottom + i, count - i, amplitude, cellSize, normals + i);
+}
+
+void TerrainBaker::computeNormalsScalar(const float* left, const float* right, const float* top, const float* bottom, int count, float amplitude, float cellSize, XMFLOAT3* normals)
+{
+	float up = 2.0f * cellSize;
+
+	for (int i = 0; i < count; i++)
+	{
+		//The direction of cross(tangent, bitangent) in estimateNormalsByHeightMap()
+		float x = (left[i] - right[i]) * amplitude;
+		float z = (bottom[i] - top[i]) * amplitude;
+		float inverseLength = 1.0f / sqrtf((x * x) + (up * up) + (z * z));
+
+		normals[i] = XMFLOAT3(x * inverseLength, up * inverseLength, z * inverseLength);
+	}
+}
+
+uint32_t TerrainBaker::packNormal(const XMFLOAT3& normal)
+{
+	uint32_t r = (uint32_t)(((normal.x * 0.5f) + 0.5f) * 255.0f + 0.5f);
+	uint32_t g = (uint32_t)(((normal.y * 0.5f) + 0.5f) * 255.0f + 0.5f);
+	uint32_t b = (uint32_t)(((normal.z * 0.5f) + 0.5f) * 255.0f + 0.5f);
+
+	return r | (g << 8) | (b << 16) | (255u << 24);
+}
+
+XMFLOAT3 TerrainBaker::unpackNormal(uint32_t packed)
+{
+	return XMFLOAT3((((float)(packed & 0xFF) / 255.0f) * 2.0f) - 1.0f, (((float)((packed >> 8) & 0xFF) / 255.0f) * 2.0f) - 1.0f, (((float)((packed >> 16) & 0xFF) / 255.0f) * 2.0f) - 1.0f);
+}
+
+void TerrainBaker::bakeNormalMap(const HeightField& heights, float amplitude, float cellSize, uint32_t* normalMap, bool simd, bool multithreaded)
+{
+	bakeNormalMapRegion(heights, amplitude, cellSize, normalMap, 0, 0, heights.getWidth(), heights.getHeight(), simd, multithreaded);
+}
+
+void TerrainBaker::bakeNormalMapRegion(const HeightField& heights, float amplitude, float cellSize, uint32_t* normalMap, int x0, int y0, int x1, int y1, bool simd, bool multithreaded)
+{
+	int width = heights.getWidth();
+	int columns = x1 - x0;
+
+	if (columns <= 0 || y1 <= y0)
+	{
+		return;
+	}
+
+	auto bakeRows = [&](int begin, int end)
+	{
+		//Rows padded with a clamped texel at either end, so every texel has a neighbour on both sides
+		std::vector<float> rows[3];
+		std::vector<XMFLOAT3> normals(columns);
+
+		for (std::vector<float>& row : rows)
+		{
+			row.resize(columns + 2);
+		}
+
+		auto loadRow = [&](int y, std::vector<float>& row)
+		{
+			for (int x = -1; x <= columns; x++)
+			{
+				row[x + 1] = heights.load(x0 + x, y);
+			}
+		};
+
+		loadRow(begin - 1, rows[0]);
+		loadRow(begin, rows[1]);
+
+		for (int y = begin; y < end; y++)
+		{
+			loadRow(y + 1, rows[2]);
+
+			if (simd)
+			{
+				computeNormals(rows[1].data(), rows[1].data() + 2, rows[0].data() + 1, rows[2].data() + 1, columns, amplitude, cellSize, normals.data());
+			}
+
+			else
+			{
+				computeNormalsScalar(rows[1].data(), rows[1].data() + 2, rows[0].data() + 1, rows[2].data() + 1, columns, amplitude, cellSize, normals.data());
+			}
+
+			uint32_t* output = normalMap + ((size_t)y * width) + x0;
+
+			for (int x = 0; x < columns; x++)
+			{
+				output[x] = packNormal(normals[x]);
+			}
+
+			//Slide the window down a row
+			rows[0].swap(rows[1]);
+			rows[1].swap(rows[2]);
+		}
+	};
+
+	if (multithreaded)
+	{
+		parallelFor(y1 - y0, [&](int begin, int end) { bakeRows(y0 + begin, y0 + end); }, 16);
+	}
+
+	else
+	{
+		bakeRows(y0, y1);
+	}
+}
+
+TerrainBaker::BenchmarkResult TerrainBaker::benchmark(int size)
+{
+	BenchmarkResult result = { size, 0.0f, 0.0f, 0.0f, 0.0f };
+
+	HeightField heights;
+	heights.generateFractal(size);
+
+	std::vector<uint32_t> scalarNormals((size_t)size * size);
+	std::vector<uint32_t> simdNormals((size_t)size * size);
+	float amplitude = (float)size * 0.1f;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	bakeNormalMap(heights, amplitude, 1.0f, scalarNormals.data(), false, false);
+	auto end = std::chrono::high_resolution_clock::now();
+	result.scalarMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	bakeNormalMap(heights, amplitude, 1.0f, simdNormals.data(), true, false);
+	end = std::chrono::high_resolution_clock::now();
+	result.simdMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	bakeNormalMap(heights, amplitude, 1.0f, simdNormals.data(), true, true);
+	end = std::chrono::high_resolution_clock::now();
+	result.multithreadedMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+
+	for (size_t i = 0; i < scalarNormals.size(); i++)
+	{
+		XMFLOAT3 a = unpackNormal(scalarNormals[i]);
+		XMFLOAT3 b = unpackNormal(simdNormals[i]);
+
+		result.maxDifference = fmaxf(result.maxDifference, fmaxf(fabsf(a.x - b.x), fmaxf(fabsf(a.y - b.y), fabsf(a.z - b.z))));
+	}
+
+	return result;
+}
+
+TerrainBaker::EditBenchmarkResult TerrainBaker::benchmarkEdits(int size, int brushRadius, int edits, int tileSize)
+{
+	EditBenchmarkResult result = { size, brushRadius, edits, 0.0f, 0.0f, 0.0f };
+
+	HeightField heights;
+	heights.generateFractal(size);
+
+	std::vector<uint32_t> normals((size_t)size * size);
+	float amplitude = (float)size * 0.1f;
+
+	TerrainQuadtree tree;
+	tree.build(heights, size, 64, (float)size);
+	bakeNormalMap(heights, amplitude, 1.0f, normals.data());
+
+	DirtyTileTracker tracker;
+	tracker.resize(size, size, tileSize);
+
+	std::vector<int> tiles;
+	float fullMilliseconds = 0.0f;
+	float incrementalMilliseconds = 0.0f;
+	float dirtyTiles = 0.0f;
+	unsigned int seed = 1802644;
+
+	for (int edit = 0; edit < edits; edit++)
+	{
+		seed = (seed * 1664525u) + 1013904223u;
+		int centreX = (int)((seed >> 8) % (unsigned int)size);
+		seed = (seed * 1664525u) + 1013904223u;
+		int centreY = (int)((seed >> 8) % (unsigned int)size);
+
+		heights.applyBrush(centreX, centreY, brushRadius, (edit & 1) ? -0.02f : 0.02f);
+
+		//Normals read the texels either side of them, so the edit reaches one texel past the brush
+		tracker.markDirty(centreX - brushRadius - 1, centreY - brushRadius - 1, centreX + brushRadius + 1, centreY + brushRadius + 1);
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		tracker.getDirtyTiles(tiles);
+
+		for (int tile : tiles)
+		{
+			int x0, y0, x1, y1;
+			tracker.getTileRect(tile, x0, y0, x1, y1);
+			bakeNormalMapRegion(heights, amplitude, 1.0f, normals.data(), x0, y0, x1, y1, true, false);
+		}
+
+		int x0, y0, x1, y1;
+		tracker.getDirtyBounds(x0, y0, x1, y1);
+		tree.refit(heights, x0, y0, x1, y1);
+
+		auto end = std::chrono::high_resolution_clock::now();
+		incrementalMilliseconds += std::chrono::duration<float, std::milli>(end - start).count();
+		dirtyTiles += (float)tiles.size();
+
+		tracker.clear();
+
+		//Everything rebuilt, as without the tracker
+		start = std::chrono::high_resolution_clock::now();
+
+		bakeNormalMap(heights, amplitude, 1.0f, normals.data());
+		tree.build(heights, size, 64, (float)size);
+
+		end = std::chrono::high_resolution_clock::now();
+		fullMilliseconds += std::chrono::duration<float, std::milli>(end - start).count();
+	}
+
+	if (edits > 0)
+	{
+		result.fullMilliseconds = fullMilliseconds / (float)edits;
+		result.incrementalMilliseconds = incrementalMilliseconds / (float)edits;
+		result.dirtyTiles = dirtyTiles / (float)edits;
+	}
+
+	return result;
+}
\ No newline at end of file
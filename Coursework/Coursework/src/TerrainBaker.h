@@ -0,0 +1,54 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+
+#include "HeightField.h"
+
+using namespace DirectX;
+
+//Precomputes the terrain's normals on the CPU, so the shaders don't estimate them from four heightmap taps per vertex or pixel.
+//Normals match estimateNormalsByHeightMap() in the shaders, central differences of the heights either side of each point.
+class TerrainBaker
+{
+public:
+	struct BenchmarkResult
+	{
+		int size;
+		float scalarMilliseconds;			//One thread, one texel at a time
+		float simdMilliseconds;				//One thread, four texels at a time
+		float multithreadedMilliseconds;	//Every thread, four texels at a time
+		float maxDifference;				//Largest component difference between the scalar and SIMD normals
+	};
+
+	struct EditBenchmarkResult
+	{
+		int size;
+		int brushRadius;
+		int edits;
+		float fullMilliseconds;			//Average for one edit, re-baking the whole normal map and rebuilding the quadtree
+		float incrementalMilliseconds;	//Average for one edit, re-baking the dirty tiles and refitting the nodes they touch
+		float dirtyTiles;				//Average for one edit
+	};
+
+	//Normals of count points from the heights to their left, right, top and bottom, four at a time with a scalar tail
+	static void computeNormals(const float* left, const float* right, const float* top, const float* bottom, int count, float amplitude, float cellSize, XMFLOAT3* normals);
+
+	//Reference for computeNormals(), one point at a time
+	static void computeNormalsScalar(const float* left, const float* right, const float* top, const float* bottom, int count, float amplitude, float cellSize, XMFLOAT3* normals);
+
+	//R8G8B8A8_UNORM normal map with one texel per heightmap texel, cellSize is the world space width of a texel
+	static void bakeNormalMap(const HeightField& heights, float amplitude, float cellSize, uint32_t* normalMap, bool simd = true, bool multithreaded = true);
+
+	//Bakes only the texels from (x0, y0) up to but not including (x1, y1), reading the heights around them
+	static void bakeNormalMapRegion(const HeightField& heights, float amplitude, float cellSize, uint32_t* normalMap, int x0, int y0, int x1, int y1, bool simd = true, bool multithreaded = true);
+
+	static uint32_t packNormal(const XMFLOAT3& normal);
+	static XMFLOAT3 unpackNormal(uint32_t packed);
+
+	//Times the normal map bake of a generated heightmap of the given size with each of the paths
+	static BenchmarkResult benchmark(int size);
+
+	//Applies random brush edits to a generated heightmap, timing the tracked re-bake of each against rebuilding everything
+	static EditBenchmarkResult benchmarkEdits(int size, int brushRadius, int edits, int tileSize = 64);
+};
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include "TerrainChunkMesh.h"
+#include "TerrainBaker.h"
+
+#include <string>
+
+TerrainChunkMesh::TerrainChunkMesh(ID3D11Device* device, const TerrainQuadtree& ltree, const HeightField& lheights, int lnode, float lskirtDepth, float amplitude)
+	: tree(ltree), heights(lheights), node(lnode), skirtDepth(lskirtDepth)
+{
+	bake(amplitude);
+	initBuffers(device);
+}
+
+TerrainChunkMesh::~TerrainChunkMesh()
+{
+	// Run parent deconstructor
+	BaseMesh::~BaseMesh();
+}
+
+//Grid vertex index along each edge - bottom, top, left and right
+static int getEdgeVertex(int side, int edge, int k)
+{
+	switch (edge)
+	{
+	case 0: return k;
+	case 1: return ((side - 1) * side) + k;
+	case 2: return k * side;
+	default: return (k * side) + (side - 1);
+	}
+}
+
+void TerrainChunkMesh::bake(float amplitude)
+{
+	const TerrainQuadtree::Node& patch = tree.getNode(node);
+	int chunk = tree.getChunkSize();
+	int side = chunk + 1;
+	int step = patch.size / chunk;
+	float cellSize = tree.getWorldSize() / (float)tree.getGridSize();
+	float uvSize = 1.0f / (float)tree.getGridSize();
+
+	//The grid, then a row of skirt vertices under each of the four edges
+	vertices.resize((side * side) + (4 * side));
+
+	//Heights around each vertex of a row one full resolution cell away, so every level of detail is lit alike
+	std::vector<float> centre(side), left(side), right(side), top(side), bottom(side);
+	std::vector<XMFLOAT3> normals(side);
+
+	for (int j = 0; j < side; j++)
+	{
+		int z = patch.z + (j * step);
+
+		for (int i = 0; i < side; i++)
+		{
+			int x = patch.x + (i * step);
+
+			centre[i] = tree.getGridHeight(heights, x, z);
+			left[i] = tree.getGridHeight(heights, x - 1, z);
+			right[i] = tree.getGridHeight(heights, x + 1, z);
+			top[i] = tree.getGridHeight(heights, x, z - 1);
+			bottom[i] = tree.getGridHeight(heights, x, z + 1);
+		}
+
+		TerrainBaker::computeNormals(left.data(), right.data(), top.data(), bottom.data(), side, amplitude, cellSize, normals.data());
+
+		for (int i = 0; i < side; i++)
+		{
+			int x = patch.x + (i * step);
+
+			VertexType& vertex = vertices[(j * side) + i];
+			vertex.position = XMFLOAT3((float)x * cellSize, centre[i] * amplitude, (float)z * cellSize);
+			vertex.texture = XMFLOAT2((float)x * uvSize, (float)z * uvSize);
+			vertex.normal = normals[i];
+		}
+	}
+
+	int skirtStart = side * side;
+
+	for (int edge = 0; edge < 4; edge++)
+	{
+		for (int k = 0; k < side; k++)
+		{
+			VertexType& vertex = vertices[skirtStart + (edge * side) + k];
+			vertex = vertices[getEdgeVertex(side, edge, k)];
+			vertex.position.y -= skirtDepth * amplitude;
+		}
+	}
+}
+
+void TerrainChunkMesh::rescale(float scale)
+{
+	//Baked normals are proportional to (dx * amplitude, 2 * cellSize, dz * amplitude), so scaling x and z and renormalising
+	//gives the normal for the new amplitude without reading the heights again
+	XMVECTOR normalScale = XMVectorSet(scale, 1.0f, scale, 0.0f);
+
+	for (VertexType& vertex : vertices)
+	{
+		vertex.position.y *= scale;
+		XMStoreFloat3(&vertex.normal, XMVector3Normalize(XMVectorMultiply(XMLoadFloat3(&vertex.normal), normalScale)));
+	}
+}
+
+bool TerrainChunkMesh::overlaps(int x0, int z0, int x1, int z1) const
+{
+	//Normals reach one grid corner past the patch
+	return tree.overlaps(tree.getNode(node), x0 - 1, z0 - 1, x1 + 1, z1 + 1);
+}
+
+void TerrainChunkMesh::upload(ID3D11DeviceContext* deviceContext)
+{
+	deviceContext->UpdateSubresource(vertexBuffer, 0, NULL, vertices.data(), 0, 0);
+	updatePositionStreams(deviceContext, vertices.data());
+}
+
+void TerrainChunkMesh::initBuffers(ID3D11Device* device)
+{
+	unsigned long* indices;
+	D3D11_BUFFER_DESC vertexBufferDesc, indexBufferDesc;
+	D3D11_SUBRESOURCE_DATA vertexData, indexData;
+
+	int chunk = tree.getChunkSize();
+	int side = chunk + 1;
+	int skirtStart = side * side;
+
+	vertexCount = (int)vertices.size();
+	indexCount = (chunk * chunk * 6) + (4 * chunk * 12);
+	indices = new unsigned long[indexCount];
+
+	int index = 0;
+
+	//Same triangulation as PlaneMesh, every cell is split along the diagonal from (0,0) to (1,1)
+	for (int j = 0; j < chunk; j++)
+	{
+		for (int i = 0; i < chunk; i++)
+		{
+			unsigned long upperLeft = (j * side) + i;
+			unsigned long upperRight = ((j + 1) * side) + i + 1;
+			unsigned long lowerLeft = ((j + 1) * side) + i;
+			unsigned long bottomRight = (j * side) + i + 1;
+
+			indices[index++] = upperLeft;
+			indices[index++] = upperRight;
+			indices[index++] = lowerLeft;
+			indices[index++] = upperLeft;
+			indices[index++] = bottomRight;
+			indices[index++] = upperRight;
+		}
+	}
+
+	//Skirts are wound both ways, so they cover a crack whichever side it is seen from
+	for (int edge = 0; edge < 4; edge++)
+	{
+		for (int k = 0; k < chunk; k++)
+		{
+			unsigned long top0 = getEdgeVertex(side, edge, k);
+			unsigned long top1 = getEdgeVertex(side, edge, k + 1);
+			unsigned long bottom0 = skirtStart + (edge * side) + k;
+			unsigned long bottom1 = bottom0 + 1;
+
+			indices[index++] = top0;
+			indices[index++] = top1;
+			indices[index++] = bottom0;
+			indices[index++] = top1;
+			indices[index++] = bottom1;
+			indices[index++] = bottom0;
+
+			indices[index++] = top0;
+			indices[index++] = bottom0;
+			indices[index++] = top1;
+			indices[index++] = top1;
+			indices[index++] = bottom0;
+			indices[index++] = bottom1;
+		}
+	}
+
+	//Only the triangles are reordered, bake() writes the vertices by their place in the grid. Reported by node, as every chunk has its own.
+	MeshOptimiser::optimise("TerrainChunkMesh node " + std::to_string(node), vertices.data(), vertexCount, indices, indexCount, false);
+
+	// Set up the description of the vertex buffer, rewritten when the amplitude changes.
+	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	vertexBufferDesc.ByteWidth = sizeof(VertexType) * vertexCount;
+	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	vertexBufferDesc.CPUAccessFlags = 0;
+	vertexBufferDesc.MiscFlags = 0;
+	vertexBufferDesc.StructureByteStride = 0;
+	// Give the subresource structure a pointer to the vertex data.
+	vertexData.pSysMem = vertices.data();
+	vertexData.SysMemPitch = 0;
+	vertexData.SysMemSlicePitch = 0;
+	// Now create the vertex buffer.
+	device->CreateBuffer(&vertexBufferDesc, &vertexData, &vertexBuffer);
+	//The shadow passes only read positions, the baked heights are already in them
+	createPositionStreams(device, vertices.data(), vertexCount);
+
+	// Set up the description of the static index buffer.
+	indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	indexBufferDesc.ByteWidth = sizeof(unsigned long) * indexCount;
+	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+	indexBufferDesc.CPUAccessFlags = 0;
+	indexBufferDesc.MiscFlags = 0;
+	indexBufferDesc.StructureByteStride = 0;
+	// Give the subresource structure a pointer to the index data.
+	indexData.pSysMem = indices;
+	indexData.SysMemPitch = 0;
+	indexData.SysMemSlicePitch = 0;
+	// Create the index buffer.
+	device->CreateBuffer(&indexBufferDesc, &indexData, &indexBuffer);
+
+	// Release the index array now that the buffers have been created and loaded, the vertices are kept for re-baking.
+	delete[] indices;
+	indices = 0;
+}
\ No newline at end of file
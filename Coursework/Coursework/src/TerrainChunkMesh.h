@@ -0,0 +1,38 @@
+#pragma once
+
+#include "DXF.h"
+#include "TerrainQuadtree.h"
+
+#include <vector>
+
+using namespace DirectX;
+
+//One quadtree node's patch of chunkSize x chunkSize quads, with the displaced positions and normals baked into the vertices so
+//the shaders don't read the heightmap. A skirt hangs down from every edge to hide cracks against coarser neighbours.
+class TerrainChunkMesh : public BaseMesh
+{
+public:
+	TerrainChunkMesh(ID3D11Device* device, const TerrainQuadtree& tree, const HeightField& heights, int node, float skirtDepth, float amplitude);
+	~TerrainChunkMesh();
+
+	//Recomputes the vertices on the CPU for a new amplitude, safe to run for several chunks at once
+	void bake(float amplitude);
+	//Scales the baked heights and normals in place, for when only the amplitude has changed
+	void rescale(float scale);
+	//Whether any of the vertices read heights from the grid corners between (x0, z0) and (x1, z1)
+	bool overlaps(int x0, int z0, int x1, int z1) const;
+	//Copies the baked vertices to the vertex buffer and position streams
+	void upload(ID3D11DeviceContext* deviceContext);
+
+	inline int getTriangleCount() const { return indexCount / 3; }
+	inline const std::vector<VertexType>& getVertices() const { return vertices; }
+
+protected:
+	void initBuffers(ID3D11Device* device);
+
+	const TerrainQuadtree& tree;
+	const HeightField& heights;
+	int node;
+	float skirtDepth;	//Normalised, scaled by the amplitude with the heights
+	std::vector<VertexType> vertices;
+};
\ No newline at end of file
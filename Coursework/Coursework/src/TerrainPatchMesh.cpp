@@ -0,0 +1,105 @@
+#include "TerrainPatchMesh.h"
+
+TerrainPatchMesh::TerrainPatchMesh(ID3D11Device* device, int lpatchesPerSide, float lworldSize)
+	: patchesPerSide(lpatchesPerSide), worldSize(lworldSize)
+{
+	initBuffers(device);
+}
+
+TerrainPatchMesh::~TerrainPatchMesh()
+{
+	// Run parent deconstructor
+	BaseMesh::~BaseMesh();
+}
+
+void TerrainPatchMesh::initBuffers(ID3D11Device* device)
+{
+	VertexType* vertices;
+	unsigned long* indices;
+	D3D11_BUFFER_DESC vertexBufferDesc, indexBufferDesc;
+	D3D11_SUBRESOURCE_DATA vertexData, indexData;
+
+	int side = patchesPerSide + 1;
+	float patchSize = worldSize / (float)patchesPerSide;
+
+	vertexCount = side * side;
+	indexCount = patchesPerSide * patchesPerSide * 4;
+	vertices = new VertexType[vertexCount];
+	indices = new unsigned long[indexCount];
+
+	//Shared corners, with the same uv mapping as PlaneMesh
+	for (int j = 0; j < side; j++)
+	{
+		for (int i = 0; i < side; i++)
+		{
+			VertexType& vertex = vertices[(j * side) + i];
+			vertex.position = XMFLOAT3((float)i * patchSize, 0.0f, (float)j * patchSize);
+			vertex.texture = XMFLOAT2(((float)i * patchSize) / worldSize, ((float)j * patchSize) / worldSize);
+			vertex.normal = XMFLOAT3(0.0f, 1.0f, 0.0f);
+		}
+	}
+
+	int index = 0;
+
+	//Control points ordered (0,0), (1,0), (0,1), (1,1), which terrain_tess_hs.hlsl and terrain_tess_ds.hlsl rely on
+	for (int j = 0; j < patchesPerSide; j++)
+	{
+		for (int i = 0; i < patchesPerSide; i++)
+		{
+			indices[index++] = (j * side) + i;
+			indices[index++] = (j * side) + i + 1;
+			indices[index++] = ((j + 1) * side) + i;
+			indices[index++] = ((j + 1) * side) + i + 1;
+		}
+	}
+
+	// Set up the description of the static vertex buffer.
+	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	vertexBufferDesc.ByteWidth = sizeof(VertexType) * vertexCount;
+	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	vertexBufferDesc.CPUAccessFlags = 0;
+	vertexBufferDesc.MiscFlags = 0;
+	vertexBufferDesc.StructureByteStride = 0;
+	// Give the subresource structure a pointer to the vertex data.
+	vertexData.pSysMem = vertices;
+	vertexData.SysMemPitch = 0;
+	vertexData.SysMemSlicePitch = 0;
+	// Now create the vertex buffer.
+	device->CreateBuffer(&vertexBufferDesc, &vertexData, &vertexBuffer);
+
+	// Set up the description of the static index buffer.
+	indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	indexBufferDesc.ByteWidth = sizeof(unsigned long) * indexCount;
+	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+	indexBufferDesc.CPUAccessFlags = 0;
+	indexBufferDesc.MiscFlags = 0;
+	indexBufferDesc.StructureByteStride = 0;
+	// Give the subresource structure a pointer to the index data.
+	indexData.pSysMem = indices;
+	indexData.SysMemPitch = 0;
+	indexData.SysMemSlicePitch = 0;
+	// Create the index buffer.
+	device->CreateBuffer(&indexBufferDesc, &indexData, &indexBuffer);
+
+	// Release the arrays now that the vertex and index buffers have been created and loaded.
+	delete[] vertices;
+	vertices = 0;
+	delete[] indices;
+	indices = 0;
+}
+
+// Override sendData() to change topology type. Control point patch list is required for tessellation.
+unsigned int TerrainPatchMesh::sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top)
+{
+	unsigned int stride;
+	unsigned int offset;
+
+	stride = sizeof(VertexType);
+	offset = 0;
+
+	deviceContext->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+	deviceContext->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	deviceContext->IASetPrimitiveTopology(top);
+
+	return stride;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "DXF.h"
+
+using namespace DirectX;
+
+//Grid of flat quad patches over the terrain, drawn as a four control point patch list for the tessellated terrain.
+//Like TessellationMesh, sendData() is overridden for the patch topology.
+class TerrainPatchMesh : public BaseMesh
+{
+public:
+	TerrainPatchMesh(ID3D11Device* device, int patchesPerSide = 32, float worldSize = 100.0f);
+	~TerrainPatchMesh();
+
+	unsigned int sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top = D3D11_PRIMITIVE_TOPOLOGY_4_CONTROL_POINT_PATCHLIST) override;
+
+	inline int getPatchesPerSide() const { return patchesPerSide; }
+	inline float getWorldSize() const { return worldSize; }
+
+protected:
+	void initBuffers(ID3D11Device* device);
+
+	int patchesPerSide;
+	float worldSize;
+};
\ No newline at end of file
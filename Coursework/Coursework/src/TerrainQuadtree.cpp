@@ -0,0 +1,368 @@
+#include "TerrainQuadtree.h"
+#include "ParallelFor.h"
+
+#include <chrono>
+#include <cmath>
+
+TerrainQuadtree::TerrainQuadtree() : gridSize(0), chunkSize(0), worldSize(0.0f), levelCount(0), buildMilliseconds(0.0f)
+{
+
+}
+
+TerrainQuadtree::~TerrainQuadtree()
+{
+
+}
+
+float TerrainQuadtree::getGridHeight(const HeightField& heights, int x, int z) const
+{
+	//With one texel per cell the corners read the texels directly, which keeps very large trees quick to build
+	if (heights.getWidth() == gridSize && heights.getHeight() == gridSize)
+	{
+		return heights.load(x, z);
+	}
+
+	return heights.sample((float)x / (float)gridSize, (float)z / (float)gridSize);
+}
+
+int TerrainQuadtree::addNode(int x, int z, int size, int level)
+{
+	Node node;
+	node.x = x;
+	node.z = z;
+	node.size = size;
+	node.level = level;
+	node.minHeight = 0.0f;
+	node.maxHeight = 0.0f;
+	node.error = 0.0f;
+
+	for (int i = 0; i < 4; i++)
+	{
+		node.children[i] = -1;
+	}
+
+	int index = (int)nodes.size();
+	nodes.push_back(node);
+
+	if (level + 1 > levelCount)
+	{
+		levelCount = level + 1;
+	}
+
+	if (size > chunkSize)
+	{
+		int half = size / 2;
+
+		//Children are added after the parent, so walking the list backwards visits every child before its parent
+		int children[4] =
+		{
+			addNode(x, z, half, level + 1),
+			addNode(x + half, z, half, level + 1),
+			addNode(x, z + half, half, level + 1),
+			addNode(x + half, z + half, half, level + 1)
+		};
+
+		for (int i = 0; i < 4; i++)
+		{
+			nodes[index].children[i] = children[i];
+		}
+	}
+
+	return index;
+}
+
+//Largest difference between a patch drawn with cells of the given step and one drawn with cells half that size.
+//Both surfaces are piecewise linear, so the difference peaks at the extra vertices of the finer patch.
+float TerrainQuadtree::measureLevelError(const HeightField& heights, int x, int z, int size, int step) const
+{
+	int half = step / 2;
+	float error = 0.0f;
+
+	for (int cz = z; cz < z + size; cz += step)
+	{
+		for (int cx = x; cx < x + size; cx += step)
+		{
+			float h00 = getGridHeight(heights, cx, cz);
+			float h10 = getGridHeight(heights, cx + step, cz);
+			float h01 = getGridHeight(heights, cx, cz + step);
+			float h11 = getGridHeight(heights, cx + step, cz + step);
+
+			//Edge midpoints, and the centre which lies on the diagonal from (0,0) to (1,1) shared by every patch
+			float differences[5] =
+			{
+				getGridHeight(heights, cx + half, cz) - ((h00 + h10) * 0.5f),
+				getGridHeight(heights, cx, cz + half) - ((h00 + h01) * 0.5f),
+				getGridHeight(heights, cx + half, cz + step) - ((h01 + h11) * 0.5f),
+				getGridHeight(heights, cx + step, cz + half) - ((h10 + h11) * 0.5f),
+				getGridHeight(heights, cx + half, cz + half) - ((h00 + h11) * 0.5f)
+			};
+
+			for (int i = 0; i < 5; i++)
+			{
+				error = fmaxf(error, fabsf(differences[i]));
+			}
+		}
+	}
+
+	return error;
+}
+
+void TerrainQuadtree::measureLeaf(const HeightField& heights, Node& node) const
+{
+	float minimum = 1.0f;
+	float maximum = 0.0f;
+
+	for (int z = node.z; z <= node.z + node.size; z++)
+	{
+		for (int x = node.x; x <= node.x + node.size; x++)
+		{
+			float height = getGridHeight(heights, x, z);
+			minimum = fminf(minimum, height);
+			maximum = fmaxf(maximum, height);
+		}
+	}
+
+	node.minHeight = minimum;
+	node.maxHeight = maximum;
+}
+
+void TerrainQuadtree::measureParent(const HeightField& heights, Node& node) const
+{
+	float childError = 0.0f;
+
+	node.minHeight = 1.0f;
+	node.maxHeight = 0.0f;
+
+	for (int child : node.children)
+	{
+		node.minHeight = fminf(node.minHeight, nodes[child].minHeight);
+		node.maxHeight = fmaxf(node.maxHeight, nodes[child].maxHeight);
+		childError = fmaxf(childError, nodes[child].error);
+	}
+
+	node.error = childError + measureLevelError(heights, node.x, node.z, node.size, node.size / chunkSize);
+}
+
+void TerrainQuadtree::build(const HeightField& heights, int grid, int chunk, float size, bool multithreaded)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	gridSize = grid;
+	chunkSize = chunk;
+	worldSize = size;
+	levelCount = 0;
+
+	nodes.clear();
+	addNode(0, 0, gridSize, 0);
+
+	//Leaves are the full resolution surface, so only their height bounds are needed
+	std::vector<int> leaves;
+	std::vector<std::vector<int>> levels(levelCount);
+
+	for (int i = 0; i < (int)nodes.size(); i++)
+	{
+		if (nodes[i].children[0] < 0)
+		{
+			leaves.push_back(i);
+		}
+
+		else
+		{
+			levels[nodes[i].level].push_back(i);
+		}
+	}
+
+	auto measureLeaves = [&](int begin, int end)
+	{
+		for (int i = begin; i < end; i++)
+		{
+			measureLeaf(heights, nodes[leaves[i]]);
+		}
+	};
+
+	if (multithreaded)
+	{
+		parallelFor((int)leaves.size(), measureLeaves, 4);
+	}
+
+	else
+	{
+		measureLeaves(0, (int)leaves.size());
+	}
+
+	//Parents from the deepest level up, each one's error adds the step to its own detail onto the worst of its children
+	for (int level = levelCount - 1; level >= 0; level--)
+	{
+		std::vector<int>& levelNodes = levels[level];
+
+		auto measureParents = [&](int begin, int end)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				measureParent(heights, nodes[levelNodes[i]]);
+			}
+		};
+
+		if (multithreaded)
+		{
+			parallelFor((int)levelNodes.size(), measureParents, 1);
+		}
+
+		else
+		{
+			measureParents(0, (int)levelNodes.size());
+		}
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	buildMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+void TerrainQuadtree::refit(const HeightField& heights, int x0, int z0, int x1, int z1)
+{
+	//Children always come after their parents, so walking backwards remeasures every child before the parent that reads it
+	for (int i = (int)nodes.size() - 1; i >= 0; i--)
+	{
+		if (!overlaps(nodes[i], x0, z0, x1, z1))
+		{
+			continue;
+		}
+
+		if (nodes[i].children[0] < 0)
+		{
+			measureLeaf(heights, nodes[i]);
+		}
+
+		else
+		{
+			measureParent(heights, nodes[i]);
+		}
+	}
+}
+
+void TerrainQuadtree::getBounds(const Node& node, float amplitude, XMFLOAT3& minimum, XMFLOAT3& maximum) const
+{
+	float cellSize = worldSize / (float)gridSize;
+
+	minimum = XMFLOAT3((float)node.x * cellSize, node.minHeight * amplitude, (float)node.z * cellSize);
+	maximum = XMFLOAT3((float)(node.x + node.size) * cellSize, node.maxHeight * amplitude, (float)(node.z + node.size) * cellSize);
+}
+
+void TerrainQuadtree::select(const SelectionParams& params, const Frustum* frustum, std::vector<int>& selected) const
+{
+	selected.clear();
+
+	if (nodes.empty())
+	{
+		return;
+	}
+
+	std::vector<int> stack;
+	stack.push_back(0);
+
+	while (!stack.empty())
+	{
+		int index = stack.back();
+		stack.pop_back();
+
+		const Node& node = nodes[index];
+		XMFLOAT3 minimum, maximum;
+		getBounds(node, params.amplitude, minimum, maximum);
+
+		if (frustum && !frustum->boxVisible(minimum, maximum))
+		{
+			continue;
+		}
+
+		if (node.children[0] < 0)
+		{
+			selected.push_back(index);
+			continue;
+		}
+
+		//Distance from the camera to the closest point of the node's bounds
+		float dx = fmaxf(fmaxf(minimum.x - params.cameraPosition.x, params.cameraPosition.x - maximum.x), 0.0f);
+		float dy = fmaxf(fmaxf(minimum.y - params.cameraPosition.y, params.cameraPosition.y - maximum.y), 0.0f);
+		float dz = fmaxf(fmaxf(minimum.z - params.cameraPosition.z, params.cameraPosition.z - maximum.z), 0.0f);
+		float distance = sqrtf((dx * dx) + (dy * dy) + (dz * dz));
+
+		float screenError = (node.error * params.amplitude * params.projectionScale) / fmaxf(distance, 0.0001f);
+
+		if (screenError <= params.pixelThreshold)
+		{
+			selected.push_back(index);
+		}
+
+		else
+		{
+			for (int child : node.children)
+			{
+				stack.push_back(child);
+			}
+		}
+	}
+}
+
+TerrainQuadtree::BenchmarkResult TerrainQuadtree::benchmark(int heightFieldSize, int chunk, int views)
+{
+	BenchmarkResult result = { heightFieldSize, 0, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	HeightField heights;
+	heights.generateFractal(heightFieldSize);
+
+	auto end = std::chrono::high_resolution_clock::now();
+	result.generateMilliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+
+	//One unit per cell, with relief a tenth of the terrain's width
+	TerrainQuadtree tree;
+	tree.build(heights, heightFieldSize, chunk, (float)heightFieldSize);
+
+	result.nodeCount = (int)tree.getNodes().size();
+	result.buildMilliseconds = tree.getBuildMilliseconds();
+
+	float world = (float)heightFieldSize;
+	float amplitude = world * 0.1f;
+
+	//A 1080p view with a 45 degree field of view, as the scene's projection
+	XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, world * 1.5f);
+	XMFLOAT4X4 projectionValues;
+	XMStoreFloat4x4(&projectionValues, projection);
+
+	SelectionParams params;
+	params.amplitude = amplitude;
+	params.projectionScale = projectionValues._22 * 540.0f;
+	params.pixelThreshold = 2.0f;
+
+	std::vector<int> selected;
+	float totalMilliseconds = 0.0f;
+	float totalSelected = 0.0f;
+
+	for (int view = 0; view < views; view++)
+	{
+		//Looking across the terrain towards its centre from a ring inside it
+		float angle = XM_2PI * (float)view / (float)views;
+		XMFLOAT3 eye((world * 0.5f) + (cosf(angle) * world * 0.3f), amplitude * 0.8f, (world * 0.5f) + (sinf(angle) * world * 0.3f));
+		XMMATRIX viewMatrix = XMMatrixLookAtLH(XMVectorSet(eye.x, eye.y, eye.z, 1.0f), XMVectorSet(world * 0.5f, 0.0f, world * 0.5f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		Frustum frustum(viewMatrix * projection);
+
+		params.cameraPosition = eye;
+
+		start = std::chrono::high_resolution_clock::now();
+		tree.select(params, &frustum, selected);
+		end = std::chrono::high_resolution_clock::now();
+
+		totalMilliseconds += std::chrono::duration<float, std::milli>(end - start).count();
+		totalSelected += (float)selected.size();
+	}
+
+	if (views > 0)
+	{
+		result.selectMilliseconds = totalMilliseconds / (float)views;
+		result.selectedNodes = totalSelected / (float)views;
+		result.triangleRatio = (result.selectedNodes * (float)chunk * (float)chunk) / ((float)heightFieldSize * (float)heightFieldSize);
+	}
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+
+#include "HeightField.h"
+#include "Frustum.h"
+
+using namespace DirectX;
+
+//Chunked LOD quadtree over a square grid of terrain cells. Every node is drawn as a patch of chunkSize x chunkSize
+//quads, so each level up halves the detail, and nodes are picked by the screen space size of their geometric error.
+//Positions are in terrain space - x and z in (0, worldSize) and y the normalised height multiplied by the amplitude.
+class TerrainQuadtree
+{
+public:
+	struct Node
+	{
+		int x;				//First grid cell covered
+		int z;
+		int size;			//Grid cells along each side
+		int level;			//Zero for the root
+		float minHeight;	//Normalised height bounds of the node's full resolution surface
+		float maxHeight;
+		float error;		//Largest normalised height difference between this patch and the full resolution surface
+		int children[4];	//-1 for leaves
+	};
+
+	struct SelectionParams
+	{
+		XMFLOAT3 cameraPosition;	//In terrain space
+		float amplitude;
+		float projectionScale;		//Pixels covered by one unit at a distance of one unit, projection._22 * screenHeight / 2
+		float pixelThreshold;		//Largest allowed screen space error
+	};
+
+	struct BenchmarkResult
+	{
+		int heightFieldSize;
+		int nodeCount;
+		float generateMilliseconds;
+		float buildMilliseconds;
+		float selectMilliseconds;	//Average for one view
+		float selectedNodes;		//Average for one view
+		float triangleRatio;		//Selected triangles against drawing every cell at full resolution
+	};
+
+	TerrainQuadtree();
+	~TerrainQuadtree();
+
+	//Grid size must be the chunk size multiplied by a power of two. Heights are taken at the cell corners.
+	void build(const HeightField& heights, int gridSize, int chunkSize, float worldSize, bool multithreaded = true);
+
+	//Remeasures only the nodes touching the grid corners from (x0, z0) to (x1, z1), after the heights there have been edited
+	void refit(const HeightField& heights, int x0, int z0, int x1, int z1);
+
+	//Whether a node's patch includes any grid corner from (x0, z0) to (x1, z1)
+	inline bool overlaps(const Node& node, int x0, int z0, int x1, int z1) const { return node.x <= x1 && node.x + node.size >= x0 && node.z <= z1 && node.z + node.size >= z0; }
+
+	//Writes the indices of the nodes to draw, a null frustum selects for the whole terrain, such as for shadow maps
+	void select(const SelectionParams& params, const Frustum* frustum, std::vector<int>& selected) const;
+
+	//Builds a tree over a generated heightmap of the given size and times the selection from several views
+	static BenchmarkResult benchmark(int heightFieldSize, int chunkSize, int views);
+
+	//Height of a grid corner, bilinearly sampled from the heightmap
+	float getGridHeight(const HeightField& heights, int x, int z) const;
+
+	void getBounds(const Node& node, float amplitude, XMFLOAT3& minimum, XMFLOAT3& maximum) const;
+
+	inline const std::vector<Node>& getNodes() const { return nodes; }
+	inline const Node& getNode(int index) const { return nodes[index]; }
+	inline int getGridSize() const { return gridSize; }
+	inline int getChunkSize() const { return chunkSize; }
+	inline float getWorldSize() const { return worldSize; }
+	inline int getLevelCount() const { return levelCount; }
+	inline float getBuildMilliseconds() const { return buildMilliseconds; }
+
+private:
+	int addNode(int x, int z, int size, int level);
+	void measureLeaf(const HeightField& heights, Node& node) const;
+	void measureParent(const HeightField& heights, Node& node) const;
+	float measureLevelError(const HeightField& heights, int x, int z, int size, int step) const;
+
+	std::vector<Node> nodes;
+	int gridSize;
+	int chunkSize;
+	float worldSize;
+	int levelCount;
+	float buildMilliseconds;
+};
\ No newline at end of file
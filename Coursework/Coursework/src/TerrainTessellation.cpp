@@ -0,0 +1,158 @@
+#include "TerrainTessellation.h"
+
+#include <chrono>
+#include <cmath>
+
+float TerrainTessellation::edgeFactor(const XMFLOAT3& a, const XMFLOAT3& b, const Settings& settings)
+{
+	//The displaced height isn't known before the domain shader, so the midpoint is taken at the height closest to the camera
+	float midpointY = settings.cameraPosition.y < 0.0f ? 0.0f : (settings.cameraPosition.y > settings.amplitude ? settings.amplitude : settings.cameraPosition.y);
+	float dx = ((a.x + b.x) * 0.5f) - settings.cameraPosition.x;
+	float dy = midpointY - settings.cameraPosition.y;
+	float dz = ((a.z + b.z) * 0.5f) - settings.cameraPosition.z;
+	float distance = fmaxf(sqrtf((dx * dx) + (dy * dy) + (dz * dz)), 0.0001f);
+
+	float ex = b.x - a.x;
+	float ez = b.z - a.z;
+	float factor = (sqrtf((ex * ex) + (ez * ez)) * settings.projectionScale) / (distance * settings.pixelsPerEdge);
+
+	return factor < settings.minFactor ? settings.minFactor : (factor > settings.maxFactor ? settings.maxFactor : factor);
+}
+
+int TerrainTessellation::countTriangles(const float edges[4], float inside)
+{
+	int edgeSegments[4];
+	int insideSegments = (int)ceilf(inside);
+	bool subdivided = insideSegments > 1;
+
+	for (int i = 0; i < 4; i++)
+	{
+		edgeSegments[i] = (int)ceilf(edges[i]);
+		subdivided = subdivided || edgeSegments[i] > 1;
+	}
+
+	if (!subdivided)
+	{
+		return 2;
+	}
+
+	//An inner grid of quads, then a ring stitching each edge's segments to the side of the grid next to it
+	insideSegments = insideSegments < 2 ? 2 : insideSegments;
+	int triangles = 2 * (insideSegments - 2) * (insideSegments - 2);
+
+	for (int i = 0; i < 4; i++)
+	{
+		triangles += edgeSegments[i] + insideSegments - 2;
+	}
+
+	return triangles;
+}
+
+TerrainTessellation::ViewStats TerrainTessellation::measureView(const Settings& settings, const Frustum& frustum, int patchesPerSide, float worldSize)
+{
+	ViewStats stats = { 0, 0, 0.0f };
+	float patchSize = worldSize / (float)patchesPerSide;
+	float totalFactor = 0.0f;
+
+	for (int j = 0; j < patchesPerSide; j++)
+	{
+		for (int i = 0; i < patchesPerSide; i++)
+		{
+			XMFLOAT3 minimum((float)i * patchSize, 0.0f, (float)j * patchSize);
+			XMFLOAT3 maximum((float)(i + 1) * patchSize, settings.amplitude, (float)(j + 1) * patchSize);
+
+			if (!frustum.boxVisible(minimum, maximum))
+			{
+				continue;
+			}
+
+			//Control points in the order of TerrainPatchMesh
+			XMFLOAT3 corners[4] =
+			{
+				XMFLOAT3(minimum.x, 0.0f, minimum.z),
+				XMFLOAT3(maximum.x, 0.0f, minimum.z),
+				XMFLOAT3(minimum.x, 0.0f, maximum.z),
+				XMFLOAT3(maximum.x, 0.0f, maximum.z)
+			};
+
+			//u = 0, v = 0, u = 1 and v = 1, as SV_TessFactor for the quad domain
+			float edges[4] =
+			{
+				edgeFactor(corners[0], corners[2], settings),
+				edgeFactor(corners[0], corners[1], settings),
+				edgeFactor(corners[1], corners[3], settings),
+				edgeFactor(corners[2], corners[3], settings)
+			};
+
+			float inside = fmaxf(fmaxf(edges[0], edges[1]), fmaxf(edges[2], edges[3]));
+
+			stats.visiblePatches++;
+			stats.triangles += countTriangles(edges, inside);
+			totalFactor += inside;
+		}
+	}
+
+	if (stats.visiblePatches > 0)
+	{
+		stats.averageFactor = totalFactor / (float)stats.visiblePatches;
+	}
+
+	return stats;
+}
+
+TerrainTessellation::BenchmarkResult TerrainTessellation::benchmark(int patchesPerSide, float pixelsPerEdge, float maxFactor, int views)
+{
+	BenchmarkResult result = { views, patchesPerSide, 0.0f, 0.0f, 0.0f, 0.0f, 99 * 99 * 2, 0.0f };
+
+	float world = 100.0f;
+	XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 200.0f);
+	XMFLOAT4X4 projectionValues;
+	XMStoreFloat4x4(&projectionValues, projection);
+
+	Settings settings;
+	settings.amplitude = 10.0f;
+	settings.projectionScale = projectionValues._22 * 540.0f;
+	settings.pixelsPerEdge = pixelsPerEdge;
+	settings.minFactor = 1.0f;
+	settings.maxFactor = maxFactor;
+
+	float totalTriangles = 0.0f;
+	float totalPatches = 0.0f;
+	float totalMilliseconds = 0.0f;
+	result.minTriangles = 3.402823466e+38f;
+
+	for (int view = 0; view < views; view++)
+	{
+		//Looking across the terrain towards its centre from a ring inside it, just above the highest point
+		float angle = XM_2PI * (float)view / (float)views;
+		XMFLOAT3 eye((world * 0.5f) + (cosf(angle) * world * 0.3f), settings.amplitude * 1.2f, (world * 0.5f) + (sinf(angle) * world * 0.3f));
+		XMMATRIX viewMatrix = XMMatrixLookAtLH(XMVectorSet(eye.x, eye.y, eye.z, 1.0f), XMVectorSet(world * 0.5f, 0.0f, world * 0.5f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		Frustum frustum(viewMatrix * projection);
+
+		settings.cameraPosition = eye;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		ViewStats stats = measureView(settings, frustum, patchesPerSide, world);
+		auto end = std::chrono::high_resolution_clock::now();
+
+		totalMilliseconds += std::chrono::duration<float, std::milli>(end - start).count();
+		totalTriangles += (float)stats.triangles;
+		totalPatches += (float)stats.visiblePatches;
+		result.minTriangles = fminf(result.minTriangles, (float)stats.triangles);
+		result.maxTriangles = fmaxf(result.maxTriangles, (float)stats.triangles);
+	}
+
+	if (views > 0)
+	{
+		result.averageTriangles = totalTriangles / (float)views;
+		result.averagePatches = totalPatches / (float)views;
+		result.milliseconds = totalMilliseconds / (float)views;
+	}
+
+	else
+	{
+		result.minTriangles = 0.0f;
+	}
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include "Frustum.h"
+
+using namespace DirectX;
+
+//CPU reference of the tessellated terrain's hull shader, terrain_tess_hs.hlsl. Edge factors follow the projected length of
+//each patch edge, so edges are split until their pieces cover about pixelsPerEdge pixels, and patches outside the view are culled.
+class TerrainTessellation
+{
+public:
+	struct Settings
+	{
+		XMFLOAT3 cameraPosition;	//In terrain space
+		float amplitude;
+		float projectionScale;		//projection._22 * screenHeight / 2
+		float pixelsPerEdge;
+		float minFactor;
+		float maxFactor;
+	};
+
+	struct ViewStats
+	{
+		int visiblePatches;
+		int triangles;
+		float averageFactor;		//Inside factor averaged over the visible patches
+	};
+
+	struct BenchmarkResult
+	{
+		int views;
+		int patchesPerSide;
+		float minTriangles;
+		float maxTriangles;
+		float averageTriangles;
+		float averagePatches;
+		int planeTriangles;			//The fixed density PlaneMesh, for comparison
+		float milliseconds;			//Average for one view
+	};
+
+	//Tessellation factor of the edge from a to b, taken from the edge alone so neighbouring patches always agree
+	static float edgeFactor(const XMFLOAT3& a, const XMFLOAT3& b, const Settings& settings);
+
+	//Triangles made by the quad domain with integer partitioning, edges in the order of SV_TessFactor
+	static int countTriangles(const float edges[4], float inside);
+
+	//Tessellates a grid of patchesPerSide x patchesPerSide patches over the terrain as the hull shader would
+	static ViewStats measureView(const Settings& settings, const Frustum& frustum, int patchesPerSide, float worldSize);
+
+	//Views from a ring around a 100 unit terrain, the size of the scene's, with a 1080p 45 degree projection
+	static BenchmarkResult benchmark(int patchesPerSide, float pixelsPerEdge, float maxFactor, int views);
+};
\ No newline at end of file
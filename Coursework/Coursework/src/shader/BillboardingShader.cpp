@@ -1,121 +0,0 @@
-#include "BillboardingShader.h"
-
-BillboardingShader::BillboardingShader(ID3D11Device* device, HWND hwnd) : BaseShader(device, hwnd)
-{
-	initShader(L"billboarding_vs.cso", L"light_ps.cso");
-}
-
-BillboardingShader::~BillboardingShader()
-{
-	// Release the sampler state.
-	if (sampleState)
-	{
-		sampleState->Release();
-		sampleState = 0;
-	}
-
-	// Release the matrix constant buffer.
-	if (matrixBuffer)
-	{
-		matrixBuffer->Release();
-		matrixBuffer = 0;
-	}
-
-	if (cameraBuffer)
-	{
-		cameraBuffer->Release();
-		cameraBuffer = 0;
-	}
-
-	// Release the layout.
-	if (layout)
-	{
-		layout->Release();
-		layout = 0;
-	}
-
-	//Release base shader components
-	BaseShader::~BaseShader();
-}
-
-void BillboardingShader::initShader(const wchar_t* vsFilename, const wchar_t* psFilename)
-{
-	D3D11_BUFFER_DESC matrixBufferDesc;
-	D3D11_BUFFER_DESC cameraBufferDesc;
-	D3D11_SAMPLER_DESC samplerDesc;
-	D3D11_BLEND_DESC blendDesc;
-
-	// Load (+ compile) shader files
-	loadVertexShader(vsFilename);
-	loadGeometryShader(L"billboarding_gs.cso");
-	//loadGeometryShader(L"GeometryShader.cso");
-	loadPixelShader(psFilename);
-
-	// Setup the description of the dynamic matrix constant buffer that is in the vertex shader.
-	matrixBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
-	matrixBufferDesc.ByteWidth = sizeof(MatrixBufferType);
-	matrixBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-	matrixBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-	matrixBufferDesc.MiscFlags = 0;
-	matrixBufferDesc.StructureByteStride = 0;
-
-	// Create the constant buffer pointer so we can access the vertex shader constant buffer from within this class.
-	renderer->CreateBuffer(&matrixBufferDesc, NULL, &matrixBuffer);
-
-	cameraBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
-	cameraBufferDesc.ByteWidth = sizeof(CameraBufferType);
-	cameraBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-	cameraBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-	cameraBufferDesc.MiscFlags = 0;
-	cameraBufferDesc.StructureByteStride = 0;
-
-	renderer->CreateBuffer(&cameraBufferDesc, NULL, &cameraBuffer);
-
-	// Create a texture sampler state description.
-	samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-	samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
-	samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
-	samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
-	samplerDesc.MipLODBias = 0.0f;
-	samplerDesc.MaxAnisotropy = 1;
-	samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
-	samplerDesc.MinLOD = 0;
-	samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
-
-	// Create the texture sampler state.
-	renderer->CreateSamplerState(&samplerDesc, &sampleState);
-}
-
-void BillboardingShader::setShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX& worldMatrix, const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, ID3D11ShaderResourceView* texture, XMFLOAT3 camPos)
-{
-	HRESULT result;
-	D3D11_MAPPED_SUBRESOURCE mappedResource;
-	MatrixBufferType* dataPtr;
-	CameraBufferType* cameraPtr;
-	XMMATRIX tworld, tview, tproj;
-
-	// Transpose the matrices to prepare them for the shader.
-	tworld = XMMatrixTranspose(worldMatrix);
-	tview = XMMatrixTranspose(viewMatrix);
-	tproj = XMMatrixTranspose(projectionMatrix);
-
-	// Sned matrix data
-	result = deviceContext->Map(matrixBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-	dataPtr = (MatrixBufferType*)mappedResource.pData;
-	dataPtr->world = tworld;// worldMatrix;
-	dataPtr->view = tview;
-	dataPtr->projection = tproj;
-	deviceContext->Unmap(matrixBuffer, 0);
-	deviceContext->GSSetConstantBuffers(0, 1, &matrixBuffer);
-
-	deviceContext->Map(cameraBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-	cameraPtr = (CameraBufferType*)mappedResource.pData;
-	cameraPtr->cameraPosition = camPos;
-	cameraPtr->padding = 0.0f;
-	deviceContext->Unmap(cameraBuffer, 0);
-	deviceContext->GSSetConstantBuffers(1, 1, &cameraBuffer);
-
-	// Set shader texture and sampler resource in the pixel shader.
-	deviceContext->PSSetShaderResources(0, 1, &texture);
-	deviceContext->PSSetSamplers(0, 1, &sampleState);
-}
\ No newline at end of file
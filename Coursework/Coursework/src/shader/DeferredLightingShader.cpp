@@ -0,0 +1,52 @@
+#include "DeferredLightingShader.h"
+
+DeferredLightingShader::DeferredLightingShader(ID3D11Device* device, HWND hwnd) : LightShader(device, hwnd, L"texture_vs.cso", L"deferred_ps.cso")
+{
+	D3D11_BUFFER_DESC deferredBufferDesc;
+
+	deferredBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	deferredBufferDesc.ByteWidth = sizeof(DeferredBufferType);
+	deferredBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	deferredBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	deferredBufferDesc.MiscFlags = 0;
+	deferredBufferDesc.StructureByteStride = 0;
+	renderer->CreateBuffer(&deferredBufferDesc, NULL, &deferredBuffer);
+}
+
+DeferredLightingShader::~DeferredLightingShader()
+{
+	if (deferredBuffer)
+	{
+		deferredBuffer->Release();
+		deferredBuffer = 0;
+	}
+}
+
+void DeferredLightingShader::setShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX& worldMatrix, const XMMATRIX& orthoViewMatrix, const XMMATRIX& orthoMatrix,
+	const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, const GBuffer* gBuffer, AppLight* light[4], XMFLOAT3& cameraPos, float time, float renderType, bool renderShadows,
+	const ShadowFilter* shadowFilter, const LightClusterBuffers* clusters)
+{
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	DeferredBufferType* deferredPtr;
+
+	//The quad is drawn with the ortho matrices, the albedo target takes the place of the surface texture
+	LightShader::setShaderParameters(deviceContext, worldMatrix, orthoViewMatrix, orthoMatrix, gBuffer->getShaderResourceView(GBuffer::TARGET_ALBEDO), nullptr,
+		0.0f, light, cameraPos, time, renderType, 0.0f, 1.0f, renderShadows, shadowFilter, clusters);
+
+	//The light matrices are needed per pixel, as the vertex shader only sees the corners of the screen
+	deviceContext->PSSetConstantBuffers(4, 1, &matrixBuffer);
+
+	deviceContext->Map(deferredBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	deferredPtr = (DeferredBufferType*)mappedResource.pData;
+	deferredPtr->inverseView = XMMatrixTranspose(XMMatrixInverse(nullptr, viewMatrix));
+	deferredPtr->inverseProjection = XMMatrixTranspose(XMMatrixInverse(nullptr, projectionMatrix));
+	deferredPtr->cameraPosition = cameraPos;
+	deferredPtr->padding = 0.0f;
+	deferredPtr->gBufferSize = XMFLOAT2((float)gBuffer->getWidth(), (float)gBuffer->getHeight());
+	deferredPtr->sizePadding = XMFLOAT2(0.0f, 0.0f);
+	deviceContext->Unmap(deferredBuffer, 0);
+	deviceContext->PSSetConstantBuffers(5, 1, &deferredBuffer);
+
+	ID3D11ShaderResourceView* gBufferResources[2] = { gBuffer->getShaderResourceView(GBuffer::TARGET_NORMAL), gBuffer->getShaderResourceView(GBuffer::TARGET_DEPTH) };
+	deviceContext->PSSetShaderResources(13, 2, gBufferResources);
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "LightShader.h"
+#include "GBuffer.h"
+
+using namespace std;
+using namespace DirectX;
+
+//Lighting pass of the deferred path, drawn over a full screen ortho mesh. Shares the light, shadow and cluster
+//buffers with LightShader and rebuilds each pixel's world position from the G-buffer's view depth.
+class DeferredLightingShader : public LightShader
+{
+private:
+	struct DeferredBufferType
+	{
+		XMMATRIX inverseView;
+		XMMATRIX inverseProjection;
+		XMFLOAT3 cameraPosition;
+		float padding;
+		XMFLOAT2 gBufferSize;
+		XMFLOAT2 sizePadding;
+	};
+
+public:
+	DeferredLightingShader(ID3D11Device* device, HWND hwnd);
+	~DeferredLightingShader();
+
+	void setShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX& world, const XMMATRIX& orthoView, const XMMATRIX& ortho, const XMMATRIX& view, const XMMATRIX& projection,
+		const GBuffer* gBuffer, AppLight* light[4], XMFLOAT3& cameraPos, float time, float renderType, bool renderShadows, const ShadowFilter* shadowFilter, const LightClusterBuffers* clusters);
+
+private:
+	ID3D11Buffer* deferredBuffer;
+};
\ No newline at end of file
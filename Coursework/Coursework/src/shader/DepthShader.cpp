@@ -1,8 +1,22 @@
 #include "DepthShader.h"
 
-DepthShader::DepthShader(ID3D11Device* device, HWND hwnd) : BaseShader(device, hwnd)
+DepthShader::DepthShader(ID3D11Device* device, HWND hwnd, VertexInput input) : BaseShader(device, hwnd)
 {
-	initShader(L"depth_vs.cso", L"depth_ps.cso");
+	vertexInput = input;
+
+	switch (input)
+	{
+	case PACKED_VERTICES:
+	case PACKED_COMPACT_VERTICES:
+		initShader(L"depth_packed_vs.cso", L"depth_ps.cso");
+		break;
+	case POSITION_STREAMS:
+		initShader(L"depth_position_vs.cso", L"depth_ps.cso");
+		break;
+	default:
+		initShader(L"depth_vs.cso", L"depth_ps.cso");
+		break;
+	}
 }
 
 DepthShader::~DepthShader()
@@ -32,7 +46,7 @@ void DepthShader::initShader(const wchar_t* vsFilename, const wchar_t* psFilenam
 	D3D11_BUFFER_DESC geometryBufferDesc;
 
 	// Load (+ compile) shader files
-	loadVertexShader(vsFilename);
+	loadVertexShader(vsFilename, vertexInput);
 	loadPixelShader(psFilename);
 
 	// Setup the description of the dynamic matrix constant buffer that is in the vertex shader.
@@ -61,7 +75,8 @@ void DepthShader::initShader(const wchar_t* vsFilename, const wchar_t* psFilenam
 	renderer->CreateBuffer(&geometryBufferDesc, NULL, &geometryBuffer);
 }
 
-void DepthShader::setShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX& worldMatrix, const XMMATRIX& view, const XMMATRIX& projection, ID3D11ShaderResourceView* heightMap, float nearP, float farP, float ampl, float geoType)
+void DepthShader::setShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX& worldMatrix, const XMMATRIX& view, const XMMATRIX& projection, ID3D11ShaderResourceView* heightMap, float nearP, float farP, float ampl, float geoType,
+	float projType, float momentMode)
 {
 	D3D11_MAPPED_SUBRESOURCE mappedResource;
 	MatrixBufferType* dataPtr;
@@ -97,7 +112,8 @@ void DepthShader::setShaderParameters(ID3D11DeviceContext* deviceContext, const
 	depthPtr = (DepthBufferType*)mappedResource.pData;
 	depthPtr->nearPlane = nearP;
 	depthPtr->farPlane = farP;
-	depthPtr->padding = XMFLOAT2(0.0f, 0.0f);
+	depthPtr->projectionType = projType;
+	depthPtr->momentMode = momentMode;
 	deviceContext->Unmap(depthBuffer, 0);
 	deviceContext->PSSetConstantBuffers(0, 1, &depthBuffer);
 }
\ No newline at end of file
@@ -15,7 +15,8 @@ private:
 	{
 		float nearPlane;
 		float farPlane;
-		XMFLOAT2 padding;
+		float projectionType;
+		float momentMode;	//0 for variance moments, 1 for exponential variance moments
 	};
 
 	struct GeometryBufferType
@@ -26,14 +27,18 @@ private:
 	};
 
 public:
-	DepthShader(ID3D11Device* device, HWND hwnd);
+	//Each kind of vertex input has its own vertex shader, instanced worlds aren't supported
+	DepthShader(ID3D11Device* device, HWND hwnd, VertexInput input = VERTICES);
 	~DepthShader();
 
-	void setShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX& world, const XMMATRIX& view, const XMMATRIX& projection, ID3D11ShaderResourceView* heightMap, float nearP, float farP, float ampl, float geoType);
+	void setShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX& world, const XMMATRIX& view, const XMMATRIX& projection, ID3D11ShaderResourceView* heightMap, float nearP, float farP, float ampl, float geoType,
+		float projType, float momentMode);
 
 private:
 	void initShader(const wchar_t* vs, const wchar_t* ps);
 
+	VertexInput vertexInput;
+
 private:
 	ID3D11Buffer* matrixBuffer;
 	ID3D11Buffer* depthBuffer;
@@ -0,0 +1,11 @@
+#include "GBufferShader.h"
+
+GBufferShader::GBufferShader(ID3D11Device* device, HWND hwnd) : LightShader(device, hwnd, L"light_vs.cso", L"gbuffer_ps.cso")
+{
+
+}
+
+GBufferShader::~GBufferShader()
+{
+
+}
\ No newline at end of file
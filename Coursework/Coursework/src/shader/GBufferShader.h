@@ -0,0 +1,15 @@
+#pragma once
+
+#include "LightShader.h"
+
+using namespace std;
+using namespace DirectX;
+
+//Geometry pass of the deferred path. Shares light_vs.hlsl and its buffers with LightShader, the pixel shader
+//writes albedo, normals and view depth to a GBuffer instead of lighting the surface.
+class GBufferShader : public LightShader
+{
+public:
+	GBufferShader(ID3D11Device* device, HWND hwnd);
+	~GBufferShader();
+};
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include "GrassShader.h"
+
+GrassShader::GrassShader(ID3D11Device* device, HWND hwnd) : BaseShader(device, hwnd)
+{
+	initShader(L"grass_vs.cso", L"grass_ps.cso");
+}
+
+GrassShader::GrassShader(ID3D11Device* device, HWND hwnd, const wchar_t* ps) : BaseShader(device, hwnd)
+{
+	initShader(L"grass_vs.cso", ps);
+}
+
+GrassShader::~GrassShader()
+{
+	// Release the sampler state.
+	if (sampleState)
+	{
+		sampleState->Release();
+		sampleState = 0;
+	}
+
+	// Release the matrix constant buffer.
+	if (matrixBuffer)
+	{
+		matrixBuffer->Release();
+		matrixBuffer = 0;
+	}
+
+	if (grassBuffer)
+	{
+		grassBuffer->Release();
+		grassBuffer = 0;
+	}
+
+	if (transparencyBuffer)
+	{
+		transparencyBuffer->Release();
+		transparencyBuffer = 0;
+	}
+
+	// Release the layout.
+	if (layout)
+	{
+		layout->Release();
+		layout = 0;
+	}
+
+	//Release base shader components
+	BaseShader::~BaseShader();
+}
+
+void GrassShader::initShader(const wchar_t* vsFilename, const wchar_t* psFilename)
+{
+	D3D11_BUFFER_DESC matrixBufferDesc;
+	D3D11_BUFFER_DESC grassBufferDesc;
+	D3D11_BUFFER_DESC transparencyBufferDesc;
+	D3D11_SAMPLER_DESC samplerDesc;
+
+	// Load (+ compile) shader files
+	loadInstancedVertexShader(vsFilename);
+	loadPixelShader(psFilename);
+
+	// Setup the description of the dynamic matrix constant buffer that is in the vertex shader.
+	matrixBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	matrixBufferDesc.ByteWidth = sizeof(MatrixBufferType);
+	matrixBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	matrixBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	matrixBufferDesc.MiscFlags = 0;
+	matrixBufferDesc.StructureByteStride = 0;
+
+	// Create the constant buffer pointer so we can access the vertex shader constant buffer from within this class.
+	renderer->CreateBuffer(&matrixBufferDesc, NULL, &matrixBuffer);
+
+	grassBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	grassBufferDesc.ByteWidth = sizeof(GrassBufferType);
+	grassBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	grassBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	grassBufferDesc.MiscFlags = 0;
+	grassBufferDesc.StructureByteStride = 0;
+
+	renderer->CreateBuffer(&grassBufferDesc, NULL, &grassBuffer);
+
+	transparencyBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	transparencyBufferDesc.ByteWidth = sizeof(TransparencyBufferType);
+	transparencyBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	transparencyBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	transparencyBufferDesc.MiscFlags = 0;
+	transparencyBufferDesc.StructureByteStride = 0;
+
+	renderer->CreateBuffer(&transparencyBufferDesc, NULL, &transparencyBuffer);
+
+	// Create a texture sampler state description.
+	samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+	samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.MipLODBias = 0.0f;
+	samplerDesc.MaxAnisotropy = 1;
+	samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+	samplerDesc.MinLOD = 0;
+	samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+
+	// Create the texture sampler state.
+	renderer->CreateSamplerState(&samplerDesc, &sampleState);
+}
+
+// As BaseShader::loadVertexShader(), with a second, per instance, vertex buffer in the input layout.
+void GrassShader::loadInstancedVertexShader(const wchar_t* filename)
+{
+	ID3DBlob* vertexShaderBuffer = 0;
+
+	// Reads compiled shader into buffer (bytecode).
+	HRESULT result = D3DReadFileToBlob(filename, &vertexShaderBuffer);
+	if (result != S_OK)
+	{
+		MessageBox(NULL, filename, L"File ERROR", MB_OK);
+		exit(0);
+	}
+
+	// Create the vertex shader from the buffer.
+	renderer->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), NULL, &vertexShader);
+
+	// The blade's vertices in slot 0 and GrassScatter::Instance in slot 1, advancing once per instance.
+	D3D11_INPUT_ELEMENT_DESC polygonLayout[] = {
+		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "INSTANCEPOSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		{ "INSTANCESCALEROTATION", 0, DXGI_FORMAT_R32G32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		{ "INSTANCEBEND", 0, DXGI_FORMAT_R16G16_SNORM, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 }
+	};
+
+	unsigned int numElements = sizeof(polygonLayout) / sizeof(polygonLayout[0]);
+
+	// Create the vertex input layout.
+	renderer->CreateInputLayout(polygonLayout, numElements, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), &layout);
+
+	// Release the vertex shader buffer since it is no longer needed.
+	vertexShaderBuffer->Release();
+	vertexShaderBuffer = 0;
+}
+
+void GrassShader::setShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX& worldMatrix, const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, ID3D11ShaderResourceView* texture,
+	XMFLOAT3 camPos, float amplitude, Transparency transparency)
+{
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	MatrixBufferType* dataPtr;
+	GrassBufferType* grassPtr;
+	TransparencyBufferType* transparencyPtr;
+	XMMATRIX tworld, tview, tproj;
+
+	// Transpose the matrices to prepare them for the shader.
+	tworld = XMMatrixTranspose(worldMatrix);
+	tview = XMMatrixTranspose(viewMatrix);
+	tproj = XMMatrixTranspose(projectionMatrix);
+
+	deviceContext->Map(matrixBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	dataPtr = (MatrixBufferType*)mappedResource.pData;
+	dataPtr->world = tworld;
+	dataPtr->view = tview;
+	dataPtr->projection = tproj;
+	deviceContext->Unmap(matrixBuffer, 0);
+	deviceContext->VSSetConstantBuffers(0, 1, &matrixBuffer);
+
+	deviceContext->Map(grassBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	grassPtr = (GrassBufferType*)mappedResource.pData;
+	grassPtr->cameraPosition = camPos;
+	grassPtr->amplitude = amplitude;
+	deviceContext->Unmap(grassBuffer, 0);
+	deviceContext->VSSetConstantBuffers(1, 1, &grassBuffer);
+
+	//After the lighting buffers in b0 to b3, which are left bound from the scene's last LightShader draw
+	deviceContext->Map(transparencyBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	transparencyPtr = (TransparencyBufferType*)mappedResource.pData;
+	transparencyPtr->transparency = (float)transparency;
+	transparencyPtr->padding = XMFLOAT3(0.0f, 0.0f, 0.0f);
+	deviceContext->Unmap(transparencyBuffer, 0);
+	deviceContext->PSSetConstantBuffers(4, 1, &transparencyBuffer);
+
+	// Set shader texture and sampler resource in the pixel shader.
+	deviceContext->PSSetShaderResources(0, 1, &texture);
+	deviceContext->PSSetSamplers(0, 1, &sampleState);
+}
+
+void GrassShader::renderInstanced(ID3D11DeviceContext* deviceContext, int indexCount, int instanceCount)
+{
+	deviceContext->IASetInputLayout(layout);
+
+	// No hull, domain or geometry stages, every blade is already a mesh.
+	deviceContext->VSSetShader(vertexShader, NULL, 0);
+	deviceContext->PSSetShader(pixelShader, NULL, 0);
+	deviceContext->CSSetShader(NULL, NULL, 0);
+	deviceContext->HSSetShader(NULL, NULL, 0);
+	deviceContext->DSSetShader(NULL, NULL, 0);
+	deviceContext->GSSetShader(NULL, NULL, 0);
+
+	deviceContext->DrawIndexedInstanced(indexCount, instanceCount, 0, 0, 0);
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "BaseShader.h"
+
+using namespace std;
+using namespace DirectX;
+
+//Draws GrassMesh's blade once for every scattered instance with hardware instancing, in place of the billboarding geometry shader.
+//The input layout adds the per instance position, scale, rotation and wind bend from the mesh's second vertex buffer.
+//grass_ps keeps the texture's alpha, so the blades can be cut out, drawn with alpha to coverage, or blended.
+class GrassShader : public BaseShader
+{
+private:
+	struct GrassBufferType
+	{
+		XMFLOAT3 cameraPosition;
+		float amplitude;
+	};
+
+	struct TransparencyBufferType
+	{
+		float transparency;
+		XMFLOAT3 padding;
+	};
+
+public:
+	enum Transparency
+	{
+		CUTOUT,				//Texels under 0.9 alpha are discarded, as light_ps
+		ALPHA_TO_COVERAGE,	//Alpha is sharpened for the coverage mask, needs the alpha to coverage blend state
+		BLENDED				//Premultiplied, needs the alpha blend state and the instances drawn back to front
+	};
+
+	GrassShader(ID3D11Device* device, HWND hwnd);
+	GrassShader(ID3D11Device* device, HWND hwnd, const wchar_t* ps);	//For drawing the grass with another pixel shader, such as the G-buffer's
+	~GrassShader();
+
+	void setShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX& world, const XMMATRIX& view, const XMMATRIX& projection, ID3D11ShaderResourceView* texture, XMFLOAT3 camPos,
+		float amplitude, Transparency transparency = CUTOUT);
+
+	//Sets the shader stages like render(), then draws instanceCount copies of the mesh
+	void renderInstanced(ID3D11DeviceContext* deviceContext, int indexCount, int instanceCount);
+
+private:
+	void initShader(const wchar_t* vs, const wchar_t* ps);
+	void loadInstancedVertexShader(const wchar_t* filename);
+
+private:
+	ID3D11Buffer* matrixBuffer;
+	ID3D11Buffer* grassBuffer;
+	ID3D11Buffer* transparencyBuffer;
+	ID3D11SamplerState* sampleState;
+};
\ No newline at end of file
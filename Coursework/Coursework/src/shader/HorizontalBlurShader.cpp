@@ -2,8 +2,9 @@
 #include "horizontalblurshader.h"
 
 
-HorizontalBlurShader::HorizontalBlurShader(ID3D11Device* device, HWND hwnd) : BaseShader(device, hwnd)
+HorizontalBlurShader::HorizontalBlurShader(ID3D11Device* device, HWND hwnd, D3D11_TEXTURE_ADDRESS_MODE address) : BaseShader(device, hwnd)
 {
+	addressMode = address;
 	initShader(L"horizontalBlur_vs.cso", L"horizontalBlur_ps.cso");
 }
 
@@ -57,9 +58,9 @@ void HorizontalBlurShader::initShader(const wchar_t* vsFilename, const wchar_t*
 
 	// Create a texture sampler state description.
 	samplerDesc.Filter = D3D11_FILTER_ANISOTROPIC;
-	samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
-	samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
-	samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.AddressU = addressMode;
+	samplerDesc.AddressV = addressMode;
+	samplerDesc.AddressW = addressMode;
 	samplerDesc.MipLODBias = 0.0f;
 	samplerDesc.MaxAnisotropy = 1;
 	samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
@@ -21,7 +21,7 @@ private:
 
 public:
 
-	HorizontalBlurShader(ID3D11Device* device, HWND hwnd);
+	HorizontalBlurShader(ID3D11Device* device, HWND hwnd, D3D11_TEXTURE_ADDRESS_MODE address = D3D11_TEXTURE_ADDRESS_WRAP);	//Clamp for maps whose edges must not bleed into each other, such as moment maps
 	~HorizontalBlurShader();
 
 	void setShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX &world, const XMMATRIX &view, const XMMATRIX &projection, ID3D11ShaderResourceView* texture, float width, float lower, float upper, float sd);
@@ -33,4 +33,5 @@ private:
 	ID3D11Buffer* matrixBuffer;
 	ID3D11SamplerState* sampleState;
 	ID3D11Buffer* screenSizeBuffer;
+	D3D11_TEXTURE_ADDRESS_MODE addressMode;
 };
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "ImpostorShader.h"
+
+ImpostorShader::ImpostorShader(ID3D11Device* device, HWND hwnd) : BaseShader(device, hwnd)
+{
+	initShader(L"impostor_vs.cso", L"impostor_ps.cso");
+}
+
+ImpostorShader::ImpostorShader(ID3D11Device* device, HWND hwnd, const wchar_t* ps) : BaseShader(device, hwnd)
+{
+	initShader(L"impostor_vs.cso", ps);
+}
+
+ImpostorShader::~ImpostorShader()
+{
+	// Release the sampler state.
+	if (sampleState)
+	{
+		sampleState->Release();
+		sampleState = 0;
+	}
+
+	// Release the matrix constant buffer.
+	if (matrixBuffer)
+	{
+		matrixBuffer->Release();
+		matrixBuffer = 0;
+	}
+
+	if (impostorBuffer)
+	{
+		impostorBuffer->Release();
+		impostorBuffer = 0;
+	}
+
+	// Release the layout.
+	if (layout)
+	{
+		layout->Release();
+		layout = 0;
+	}
+
+	//Release base shader components
+	BaseShader::~BaseShader();
+}
+
+void ImpostorShader::initShader(const wchar_t* vsFilename, const wchar_t* psFilename)
+{
+	D3D11_BUFFER_DESC matrixBufferDesc;
+	D3D11_BUFFER_DESC impostorBufferDesc;
+	D3D11_SAMPLER_DESC samplerDesc;
+
+	// Load (+ compile) shader files
+	loadVertexShader(vsFilename);
+	loadPixelShader(psFilename);
+
+	// Setup the description of the dynamic matrix constant buffer that is in the vertex shader.
+	matrixBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	matrixBufferDesc.ByteWidth = sizeof(MatrixBufferType);
+	matrixBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	matrixBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	matrixBufferDesc.MiscFlags = 0;
+	matrixBufferDesc.StructureByteStride = 0;
+
+	// Create the constant buffer pointer so we can access the vertex shader constant buffer from within this class.
+	renderer->CreateBuffer(&matrixBufferDesc, NULL, &matrixBuffer);
+
+	impostorBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	impostorBufferDesc.ByteWidth = sizeof(ImpostorBufferType);
+	impostorBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	impostorBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	impostorBufferDesc.MiscFlags = 0;
+	impostorBufferDesc.StructureByteStride = 0;
+
+	renderer->CreateBuffer(&impostorBufferDesc, NULL, &impostorBuffer);
+
+	// Clamped, so the frames at the edge of the atlas don't filter in the far side.
+	samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+	samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
+	samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
+	samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+	samplerDesc.MipLODBias = 0.0f;
+	samplerDesc.MaxAnisotropy = 1;
+	samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+	samplerDesc.MinLOD = 0;
+	samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+
+	// Create the texture sampler state.
+	renderer->CreateSamplerState(&samplerDesc, &sampleState);
+}
+
+void ImpostorShader::setShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX& worldMatrix, const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix,
+	const Impostor* impostor, XMFLOAT3 camPos)
+{
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	MatrixBufferType* dataPtr;
+	ImpostorBufferType* impostorPtr;
+	XMMATRIX tworld, tview, tproj;
+
+	// Transpose the matrices to prepare them for the shader.
+	tworld = XMMatrixTranspose(worldMatrix);
+	tview = XMMatrixTranspose(viewMatrix);
+	tproj = XMMatrixTranspose(projectionMatrix);
+
+	deviceContext->Map(matrixBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	dataPtr = (MatrixBufferType*)mappedResource.pData;
+	dataPtr->world = tworld;
+	dataPtr->view = tview;
+	dataPtr->projection = tproj;
+	deviceContext->Unmap(matrixBuffer, 0);
+	deviceContext->VSSetConstantBuffers(0, 1, &matrixBuffer);
+
+	const ImpostorBaker::Atlas& atlas = impostor->getAtlas();
+
+	deviceContext->Map(impostorBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	impostorPtr = (ImpostorBufferType*)mappedResource.pData;
+	impostorPtr->world = tworld;
+	impostorPtr->cameraPosition = camPos;
+	impostorPtr->radius = atlas.radius;
+	impostorPtr->centre = atlas.centre;
+	impostorPtr->framesPerSide = (float)atlas.framesPerSide;
+	deviceContext->Unmap(impostorBuffer, 0);
+
+	//b4 and up in the pixel shader, clear of the lighting buffers that are left bound from the scene's last LightShader draw
+	deviceContext->VSSetConstantBuffers(4, 1, &impostorBuffer);
+	deviceContext->PSSetConstantBuffers(4, 1, &impostorBuffer);
+
+	ID3D11ShaderResourceView* textures[Impostor::ATLAS_COUNT] = { impostor->getTexture(Impostor::ATLAS_ALBEDO), impostor->getTexture(Impostor::ATLAS_NORMALS),
+		impostor->getTexture(Impostor::ATLAS_DEPTH) };
+	deviceContext->PSSetShaderResources(13, Impostor::ATLAS_COUNT, textures);
+	deviceContext->PSSetSamplers(4, 1, &sampleState);
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "BaseShader.h"
+#include "Impostor.h"
+
+using namespace std;
+using namespace DirectX;
+
+//Draws an Impostor's atlas on a QuadMesh, turned to face the camera over the model's bounding sphere. The pixel shader
+//blends the four baked views nearest the view direction and lights them with the baked normals.
+class ImpostorShader : public BaseShader
+{
+private:
+	struct ImpostorBufferType
+	{
+		XMMATRIX world;
+		XMFLOAT3 cameraPosition;
+		float radius;
+		XMFLOAT3 centre;
+		float framesPerSide;
+	};
+
+public:
+	ImpostorShader(ID3D11Device* device, HWND hwnd);
+	ImpostorShader(ID3D11Device* device, HWND hwnd, const wchar_t* ps);	//For drawing to the G-buffer with impostor_gbuffer_ps
+	~ImpostorShader();
+
+	//The world matrix is the model's, it may rotate and scale uniformly
+	void setShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX& world, const XMMATRIX& view, const XMMATRIX& projection, const Impostor* impostor, XMFLOAT3 camPos);
+
+private:
+	void initShader(const wchar_t* vs, const wchar_t* ps);
+
+private:
+	ID3D11Buffer* matrixBuffer;
+	ID3D11Buffer* impostorBuffer;
+	ID3D11SamplerState* sampleState;
+};
\ No newline at end of file
@@ -1,8 +1,28 @@
 #include "LightShader.h"
 
-LightShader::LightShader(ID3D11Device* device, HWND hwnd) : BaseShader(device, hwnd)
+LightShader::LightShader(ID3D11Device* device, HWND hwnd, VertexInput input) : BaseShader(device, hwnd)
 {
-	initShader(L"light_vs.cso", L"light_ps.cso");
+	vertexInput = input;
+
+	switch (input)
+	{
+	case PACKED_VERTICES:
+	case PACKED_COMPACT_VERTICES:
+		initShader(L"light_packed_vs.cso", L"light_ps.cso");
+		break;
+	case INSTANCED_WORLDS:
+		initShader(L"light_instanced_vs.cso", L"light_ps.cso");
+		break;
+	default:
+		initShader(L"light_vs.cso", L"light_ps.cso");
+		break;
+	}
+}
+
+LightShader::LightShader(ID3D11Device* device, HWND hwnd, const wchar_t* vs, const wchar_t* ps) : BaseShader(device, hwnd)
+{
+	vertexInput = VERTICES;
+	initShader(vs, ps);
 }
 
 LightShader::~LightShader()
@@ -35,6 +55,30 @@ LightShader::~LightShader()
 		lightBuffer = 0;
 	}
 
+	if (shadowFilterBuffer)
+	{
+		shadowFilterBuffer->Release();
+		shadowFilterBuffer = 0;
+	}
+
+	if (sampleStateShadowCompare)
+	{
+		sampleStateShadowCompare->Release();
+		sampleStateShadowCompare = 0;
+	}
+
+	if (clusterBuffer)
+	{
+		clusterBuffer->Release();
+		clusterBuffer = 0;
+	}
+
+	if (sampleStateMoments)
+	{
+		sampleStateMoments->Release();
+		sampleStateMoments = 0;
+	}
+
 	//Release base shader components
 	BaseShader::~BaseShader();
 }
@@ -46,9 +90,11 @@ void LightShader::initShader(const wchar_t* vsFilename, const wchar_t* psFilenam
 	D3D11_BUFFER_DESC vertexManipulationBufferDesc;
 	D3D11_SAMPLER_DESC samplerDesc;
 	D3D11_BUFFER_DESC lightBufferDesc;
+	D3D11_BUFFER_DESC shadowFilterBufferDesc;
+	D3D11_BUFFER_DESC clusterBufferDesc;
 
 	// Load (+ compile) shader files
-	loadVertexShader(vsFilename);
+	loadVertexShader(vsFilename, vertexInput);
 	loadPixelShader(psFilename);
 
 	// Setup the description of the dynamic matrix constant buffer that is in the vertex shader.
@@ -103,6 +149,19 @@ void LightShader::initShader(const wchar_t* vsFilename, const wchar_t* psFilenam
 	samplerDesc.BorderColor[3] = 1.0f;
 	renderer->CreateSamplerState(&samplerDesc, &sampleStateShadow);
 
+	// Comparison sampler for hardware PCF, each fetch returns the bilinear weighted result of four depth tests.
+	samplerDesc.Filter = D3D11_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT;
+	samplerDesc.ComparisonFunc = D3D11_COMPARISON_LESS_EQUAL;
+	renderer->CreateSamplerState(&samplerDesc, &sampleStateShadowCompare);
+
+	// Bilinear sampler for the prefiltered moment maps, clamped so the blurred edges aren't wrapped onto the far side.
+	samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+	samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
+	samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
+	samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+	samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+	renderer->CreateSamplerState(&samplerDesc, &sampleStateMoments);
+
 	// Setup light buffer
 	// Setup the description of the light dynamic constant buffer that is in the pixel shader.
 	// Note that ByteWidth always needs to be a multiple of 16 if using D3D11_BIND_CONSTANT_BUFFER or CreateBuffer will fail.
@@ -113,74 +172,70 @@ void LightShader::initShader(const wchar_t* vsFilename, const wchar_t* psFilenam
 	lightBufferDesc.MiscFlags = 0;
 	lightBufferDesc.StructureByteStride = 0;
 	renderer->CreateBuffer(&lightBufferDesc, NULL, &lightBuffer);
+
+	shadowFilterBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	shadowFilterBufferDesc.ByteWidth = sizeof(ShadowFilterBufferType);
+	shadowFilterBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	shadowFilterBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	shadowFilterBufferDesc.MiscFlags = 0;
+	shadowFilterBufferDesc.StructureByteStride = 0;
+	renderer->CreateBuffer(&shadowFilterBufferDesc, NULL, &shadowFilterBuffer);
+
+	clusterBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	clusterBufferDesc.ByteWidth = sizeof(ClusterBufferType);
+	clusterBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	clusterBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	clusterBufferDesc.MiscFlags = 0;
+	clusterBufferDesc.StructureByteStride = 0;
+	renderer->CreateBuffer(&clusterBufferDesc, NULL, &clusterBuffer);
 }
 
 void LightShader::setShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX &worldMatrix, const XMMATRIX &viewMatrix, const XMMATRIX &projectionMatrix, ID3D11ShaderResourceView* texture,
-	ID3D11ShaderResourceView* heightMap, float amplitude, AppLight* light[4], XMFLOAT3& cameraPos, float time, float renderType, float resolution, float geometryType, bool renderShadows)
+	ID3D11ShaderResourceView* heightMap, float amplitude, AppLight* light[4], XMFLOAT3& cameraPos, float time, float renderType, float resolution, float geometryType, bool renderShadows,
+	const ShadowFilter* shadowFilter, const LightClusterBuffers* clusters)
+{
+	setFrameParameters(deviceContext, viewMatrix, projectionMatrix, light, cameraPos, time, renderShadows, shadowFilter, clusters);
+	setMaterial(deviceContext, texture, heightMap);
+	setObjectParameters(deviceContext, worldMatrix, amplitude, renderType, resolution, geometryType);
+}
+
+void LightShader::setFrameParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX &viewMatrix, const XMMATRIX &projectionMatrix, AppLight* light[4], XMFLOAT3& cameraPos, float time,
+	bool renderShadows, const ShadowFilter* shadowFilter, const LightClusterBuffers* clusters)
 {
-	HRESULT result;
 	D3D11_MAPPED_SUBRESOURCE mappedResource;
-	MatrixBufferType* dataPtr;
 	CameraBufferType* cameraPtr;
 	LightBufferType* lightPtr;
-	VertexManipulationBufferType* vertexPtr;
-	
-	XMMATRIX tworld, tview, tproj, tLightViewMatrix[4], tLightProjectionMatrix[4];
+	ShadowFilterBufferType* filterPtr;
+	ClusterBufferType* clusterPtr;
 
 	ID3D11ShaderResourceView* depthMaps[4];
+	ID3D11ShaderResourceView* momentMaps[4];
 
-	// Transpose the matrices to prepare them for the shader.
-	tworld = XMMatrixTranspose(worldMatrix);
-	tview = XMMatrixTranspose(viewMatrix);
-	tproj = XMMatrixTranspose(projectionMatrix);
+	// Transpose the matrices to prepare them for the shader, the matrix buffer is sent with each object's world matrix
+	frameMatrices.view = XMMatrixTranspose(viewMatrix);
+	frameMatrices.projection = XMMatrixTranspose(projectionMatrix);
 	
 	for (int i = 0; i < 4; i++)
 	{
-		tLightViewMatrix[i] = XMMatrixTranspose(light[i]->getViewMatrix());
+		frameMatrices.lightView[i] = XMMatrixTranspose(light[i]->getViewMatrix());
 
 		if (light[i]->getProjectionMatrixType() == 0.0f)
 		{
-			tLightProjectionMatrix[i] = XMMatrixTranspose(light[i]->getOrthoMatrix());
+			frameMatrices.lightProjection[i] = XMMatrixTranspose(light[i]->getOrthoMatrix());
 		}
 
 		else
 		{
-			tLightProjectionMatrix[i] = XMMatrixTranspose(light[i]->getProjectionMatrix());
+			frameMatrices.lightProjection[i] = XMMatrixTranspose(light[i]->getProjectionMatrix());
 		}
 	}
 
-	result = deviceContext->Map(matrixBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-	dataPtr = (MatrixBufferType*)mappedResource.pData;
-	dataPtr->world = tworld;// worldMatrix;
-	dataPtr->view = tview;
-	dataPtr->projection = tproj;
-
-	for (int i = 0; i < 4; i++)
-	{
-		dataPtr->lightView[i] = tLightViewMatrix[i];
-		dataPtr->lightProjection[i] = tLightProjectionMatrix[i];
-	}
-
-	deviceContext->Unmap(matrixBuffer, 0);
-	deviceContext->VSSetConstantBuffers(0, 1, &matrixBuffer);
-
 	deviceContext->Map(cameraBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
 	cameraPtr = (CameraBufferType*)mappedResource.pData;
 	cameraPtr->cameraPosition = cameraPos;
 	cameraPtr->time = time;
 	deviceContext->Unmap(cameraBuffer, 0);
 	deviceContext->VSSetConstantBuffers(1, 1, &cameraBuffer);
-
-	deviceContext->Map(vertexManipulationBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-	vertexPtr = (VertexManipulationBufferType*)mappedResource.pData;
-	vertexPtr->amplitude = amplitude;
-	vertexPtr->renderType = renderType;
-	vertexPtr->terrainResolution = resolution;
-	vertexPtr->geometryType = geometryType;
-	deviceContext->Unmap(vertexManipulationBuffer, 0);
-	deviceContext->VSSetConstantBuffers(2, 1, &vertexManipulationBuffer);
-
-	deviceContext->VSSetShaderResources(0, 1, &heightMap);
 	deviceContext->VSSetSamplers(0, 1, &sampleState);
 
 	//Additional
@@ -201,22 +256,95 @@ void LightShader::setShaderParameters(ID3D11DeviceContext* deviceContext, const
 		lightPtr->lights[i].specularPower = light[i]->getSpecularPower();
 		lightPtr->lights[i].lightType = light[i]->getLightType();
 		lightPtr->lights[i].shadowBias = light[i]->getShadowBias();
+		lightPtr->lights[i].nearPlane = light[i]->getNearPlane();
+		lightPtr->lights[i].farPlane = light[i]->getFarPlane();
+		lightPtr->lights[i].projectionType = light[i]->getProjectionMatrixType();
 		lightPtr->lights[i].softShadowsEnabled = (float)light[i]->getSoftenShadows();
 		lightPtr->lights[i].softenRadius = (float)light[i]->getSoftenRadius();
 		lightPtr->lights[i].shadowsEnabled = (float)renderShadows;
-		lightPtr->lights[i].padding = 0.0f;
+		lightPtr->lights[i].shadowFilterMode = light[i]->getShadowFilterMode();
 
 		depthMaps[i] = light[i]->getShadowMap()->getDepthMapSRV();
+		momentMaps[i] = light[i]->getMomentMap() ? light[i]->getMomentMap()->getShaderResourceView() : nullptr;
 	}
 
 	deviceContext->Unmap(lightBuffer, 0);
 	deviceContext->PSSetConstantBuffers(0, 1, &lightBuffer);
-	deviceContext->PSSetConstantBuffers(1, 1, &vertexManipulationBuffer);
 
-	// Set shader texture resource in the pixel shader.
-	deviceContext->PSSetShaderResources(0, 1, &texture);
+	// Send the Poisson disk used by the filtered shadow modes
+	deviceContext->Map(shadowFilterBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	filterPtr = (ShadowFilterBufferType*)mappedResource.pData;
+
+	const std::vector<XMFLOAT2>& disk = shadowFilter->getPoissonDisk();
+
+	for (int i = 0; i < shadowFilter->getSampleCount(); i++)
+	{
+		filterPtr->poissonDisk[i] = XMFLOAT4(disk[i].x, disk[i].y, 0.0f, 0.0f);
+	}
+
+	filterPtr->sampleCount = (float)shadowFilter->getSampleCount();
+	filterPtr->blockerSampleCount = (float)shadowFilter->getBlockerSampleCount();
+	filterPtr->lightSize = shadowFilter->getLightSize();
+	filterPtr->minVariance = shadowFilter->getMinVariance();
+	filterPtr->bleedReduction = shadowFilter->getBleedReduction();
+	filterPtr->padding = XMFLOAT3(0.0f, 0.0f, 0.0f);
+	deviceContext->Unmap(shadowFilterBuffer, 0);
+	deviceContext->PSSetConstantBuffers(2, 1, &shadowFilterBuffer);
+
+	// Send the clustered light lists, a null cluster object switches the extra lights off
+	deviceContext->Map(clusterBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	clusterPtr = (ClusterBufferType*)mappedResource.pData;
+	clusterPtr->screenSize = clusters ? XMFLOAT2(clusters->getScreenWidth(), clusters->getScreenHeight()) : XMFLOAT2(1.0f, 1.0f);
+	clusterPtr->sliceScale = clusters ? clusters->getSliceScale() : 0.0f;
+	clusterPtr->sliceBias = clusters ? clusters->getSliceBias() : 0.0f;
+	clusterPtr->clustersEnabled = clusters ? 1.0f : 0.0f;
+	clusterPtr->padding = XMFLOAT3(0.0f, 0.0f, 0.0f);
+	deviceContext->Unmap(clusterBuffer, 0);
+	deviceContext->PSSetConstantBuffers(3, 1, &clusterBuffer);
+
+	if (clusters)
+	{
+		ID3D11ShaderResourceView* clusterResources[3] = { clusters->getLightSRV(), clusters->getClusterSRV(), clusters->getIndexSRV() };
+		deviceContext->PSSetShaderResources(10, 3, clusterResources);
+	}
+
+	// Set the shadow maps and samplers in the pixel shader.
 	deviceContext->PSSetShaderResources(1, 4, depthMaps);
-	deviceContext->PSSetShaderResources(5, 1, &heightMap);
+	deviceContext->PSSetShaderResources(6, 4, momentMaps);
 	deviceContext->PSSetSamplers(0, 1, &sampleState);
 	deviceContext->PSSetSamplers(1, 1, &sampleStateShadow);
+	deviceContext->PSSetSamplers(2, 1, &sampleStateShadowCompare);
+	deviceContext->PSSetSamplers(3, 1, &sampleStateMoments);
+}
+
+void LightShader::setMaterial(ID3D11DeviceContext* deviceContext, ID3D11ShaderResourceView* texture, ID3D11ShaderResourceView* heightMap)
+{
+	// Set shader texture resources, the height map displaces the vertices and is sampled again for the normals
+	deviceContext->VSSetShaderResources(0, 1, &heightMap);
+	deviceContext->PSSetShaderResources(0, 1, &texture);
+	deviceContext->PSSetShaderResources(5, 1, &heightMap);
+}
+
+void LightShader::setObjectParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX &worldMatrix, float amplitude, float renderType, float resolution, float geometryType)
+{
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	MatrixBufferType* dataPtr;
+	VertexManipulationBufferType* vertexPtr;
+
+	deviceContext->Map(matrixBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	dataPtr = (MatrixBufferType*)mappedResource.pData;
+	*dataPtr = frameMatrices;
+	dataPtr->world = XMMatrixTranspose(worldMatrix);
+	deviceContext->Unmap(matrixBuffer, 0);
+	deviceContext->VSSetConstantBuffers(0, 1, &matrixBuffer);
+
+	deviceContext->Map(vertexManipulationBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	vertexPtr = (VertexManipulationBufferType*)mappedResource.pData;
+	vertexPtr->amplitude = amplitude;
+	vertexPtr->renderType = renderType;
+	vertexPtr->terrainResolution = resolution;
+	vertexPtr->geometryType = geometryType;
+	deviceContext->Unmap(vertexManipulationBuffer, 0);
+	deviceContext->VSSetConstantBuffers(2, 1, &vertexManipulationBuffer);
+	deviceContext->PSSetConstantBuffers(1, 1, &vertexManipulationBuffer);
 }
\ No newline at end of file
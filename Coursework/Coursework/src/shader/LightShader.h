@@ -2,6 +2,8 @@
 
 #include "DXF.h"
 #include "AppLight.h"
+#include "ShadowFilter.h"
+#include "LightClusterBuffers.h"
 
 using namespace std;
 using namespace DirectX;
@@ -51,7 +53,7 @@ private:
 		float softenRadius;
 		float projectionType;
 		float shadowsEnabled;
-		float padding;
+		float shadowFilterMode;
 	};
 
 	struct LightBufferType
@@ -59,21 +61,61 @@ private:
 		LightType lights[4];
 	};
 
+	struct ShadowFilterBufferType
+	{
+		XMFLOAT4 poissonDisk[ShadowFilter::MAX_SAMPLES];	//Only xy are used, each sample is padded to a register
+		float sampleCount;
+		float blockerSampleCount;
+		float lightSize;
+		float minVariance;
+		float bleedReduction;
+		XMFLOAT3 padding;
+	};
+
+	struct ClusterBufferType
+	{
+		XMFLOAT2 screenSize;
+		float sliceScale;
+		float sliceBias;
+		float clustersEnabled;
+		XMFLOAT3 padding;
+	};
+
 public:
-	LightShader(ID3D11Device* device, HWND hwnd);
+	//Packed vertices and instanced worlds have their own vertex shaders, position streams aren't supported
+	LightShader(ID3D11Device* device, HWND hwnd, VertexInput input = VERTICES);
 	~LightShader();
 
 	void setShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX& world, const XMMATRIX& view, const XMMATRIX& projection, ID3D11ShaderResourceView* texture, ID3D11ShaderResourceView* heightMap,
-		float amplitude, AppLight* light[4], XMFLOAT3& cameraPos, float time, float renderType, float resolution, float geometryType, bool renderShadows);
+		float amplitude, AppLight* light[4], XMFLOAT3& cameraPos, float time, float renderType, float resolution, float geometryType, bool renderShadows, const ShadowFilter* shadowFilter,
+		const LightClusterBuffers* clusters);
+
+	//setShaderParameters() in three parts, so objects drawn together only send what changes between them. The frame's values are
+	//sent once after binding the shader, the textures when the material changes and the world matrix for every object.
+	void setFrameParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX& view, const XMMATRIX& projection, AppLight* light[4], XMFLOAT3& cameraPos, float time, bool renderShadows,
+		const ShadowFilter* shadowFilter, const LightClusterBuffers* clusters);
+	void setMaterial(ID3D11DeviceContext* deviceContext, ID3D11ShaderResourceView* texture, ID3D11ShaderResourceView* heightMap);
+	void setObjectParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX& world, float amplitude, float renderType, float resolution, float geometryType);
+
+protected:
+	//For shaders that reuse the light buffers with other shader files
+	LightShader(ID3D11Device* device, HWND hwnd, const wchar_t* vs, const wchar_t* ps);
 
 private:
 	void initShader(const wchar_t* vs, const wchar_t* ps);
 
-private:
+	VertexInput vertexInput;
+	MatrixBufferType frameMatrices;		//Transposed by setFrameParameters(), sent with each world matrix
+
+protected:
 	ID3D11Buffer* matrixBuffer;
 	ID3D11Buffer* cameraBuffer;
 	ID3D11Buffer* vertexManipulationBuffer;
 	ID3D11SamplerState* sampleState;
 	ID3D11SamplerState* sampleStateShadow;
+	ID3D11SamplerState* sampleStateShadowCompare;
+	ID3D11SamplerState* sampleStateMoments;
 	ID3D11Buffer* lightBuffer;
+	ID3D11Buffer* shadowFilterBuffer;
+	ID3D11Buffer* clusterBuffer;
 };
\ No newline at end of file
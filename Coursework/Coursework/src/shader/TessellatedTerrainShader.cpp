@@ -0,0 +1,63 @@
+#include "TessellatedTerrainShader.h"
+
+TessellatedTerrainShader::TessellatedTerrainShader(ID3D11Device* device, HWND hwnd, const wchar_t* ps) : LightShader(device, hwnd, L"terrain_tess_vs.cso", ps)
+{
+	D3D11_BUFFER_DESC tessellationBufferDesc;
+
+	loadHullShader(L"terrain_tess_hs.cso");
+	loadDomainShader(L"terrain_tess_ds.cso");
+
+	tessellationBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	tessellationBufferDesc.ByteWidth = sizeof(TessellationBufferType);
+	tessellationBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	tessellationBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	tessellationBufferDesc.MiscFlags = 0;
+	tessellationBufferDesc.StructureByteStride = 0;
+	renderer->CreateBuffer(&tessellationBufferDesc, NULL, &tessellationBuffer);
+}
+
+TessellatedTerrainShader::~TessellatedTerrainShader()
+{
+	if (tessellationBuffer)
+	{
+		tessellationBuffer->Release();
+		tessellationBuffer = 0;
+	}
+}
+
+void TessellatedTerrainShader::setTessellationParameters(ID3D11DeviceContext* deviceContext, const TerrainTessellation::Settings& settings, const Frustum& frustum)
+{
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	TessellationBufferType* tessellationPtr;
+
+	deviceContext->Map(tessellationBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	tessellationPtr = (TessellationBufferType*)mappedResource.pData;
+	tessellationPtr->cameraPosition = settings.cameraPosition;
+	tessellationPtr->amplitude = settings.amplitude;
+	tessellationPtr->projectionScale = settings.projectionScale;
+	tessellationPtr->pixelsPerEdge = settings.pixelsPerEdge;
+	tessellationPtr->minFactor = settings.minFactor;
+	tessellationPtr->maxFactor = settings.maxFactor;
+
+	for (int i = 0; i < Frustum::PLANE_COUNT; i++)
+	{
+		tessellationPtr->frustumPlanes[i] = frustum.getPlane(i);
+	}
+
+	deviceContext->Unmap(tessellationBuffer, 0);
+	deviceContext->HSSetConstantBuffers(0, 1, &tessellationBuffer);
+}
+
+void TessellatedTerrainShader::setShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX& world, const XMMATRIX& view, const XMMATRIX& projection, ID3D11ShaderResourceView* texture,
+	ID3D11ShaderResourceView* heightMap, float amplitude, AppLight* light[4], XMFLOAT3& cameraPos, float time, float renderType, float resolution, float geometryType, bool renderShadows,
+	const ShadowFilter* shadowFilter, const LightClusterBuffers* clusters)
+{
+	LightShader::setShaderParameters(deviceContext, world, view, projection, texture, heightMap, amplitude, light, cameraPos, time, renderType, resolution, geometryType, renderShadows,
+		shadowFilter, clusters);
+
+	//The displacement moves from the vertex shader to the domain shader, which reads the same buffers
+	ID3D11Buffer* domainBuffers[3] = { matrixBuffer, cameraBuffer, vertexManipulationBuffer };
+	deviceContext->DSSetConstantBuffers(0, 3, domainBuffers);
+	deviceContext->DSSetShaderResources(0, 1, &heightMap);
+	deviceContext->DSSetSamplers(0, 1, &sampleState);
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "LightShader.h"
+#include "TerrainTessellation.h"
+
+using namespace std;
+using namespace DirectX;
+
+//Terrain drawn from TerrainPatchMesh's patches, tessellated by projected edge length and displaced in the domain shader.
+//Shares the light buffers with LightShader, and the pixel shader can be either the forward or the G-buffer one.
+class TessellatedTerrainShader : public LightShader
+{
+private:
+	struct TessellationBufferType
+	{
+		XMFLOAT3 cameraPosition;
+		float amplitude;
+		float projectionScale;
+		float pixelsPerEdge;
+		float minFactor;
+		float maxFactor;
+		XMFLOAT4 frustumPlanes[Frustum::PLANE_COUNT];
+	};
+
+public:
+	TessellatedTerrainShader(ID3D11Device* device, HWND hwnd, const wchar_t* ps = L"light_ps.cso");
+	~TessellatedTerrainShader();
+
+	//The tessellation settings and frustum are in terrain space, before the world matrix
+	void setTessellationParameters(ID3D11DeviceContext* deviceContext, const TerrainTessellation::Settings& settings, const Frustum& frustum);
+
+	void setShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX& world, const XMMATRIX& view, const XMMATRIX& projection, ID3D11ShaderResourceView* texture, ID3D11ShaderResourceView* heightMap,
+		float amplitude, AppLight* light[4], XMFLOAT3& cameraPos, float time, float renderType, float resolution, float geometryType, bool renderShadows, const ShadowFilter* shadowFilter,
+		const LightClusterBuffers* clusters);
+
+private:
+	ID3D11Buffer* tessellationBuffer;
+};
\ No newline at end of file
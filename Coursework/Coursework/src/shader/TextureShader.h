@@ -13,6 +13,10 @@ public:
 
 	void setShaderParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX &world, const XMMATRIX &view, const XMMATRIX &projection, ID3D11ShaderResourceView* texture);
 
+	//setShaderParameters() in two parts, so objects sharing a texture only send their matrices
+	void setObjectParameters(ID3D11DeviceContext* deviceContext, const XMMATRIX &world, const XMMATRIX &view, const XMMATRIX &projection);
+	void setMaterial(ID3D11DeviceContext* deviceContext, ID3D11ShaderResourceView* texture);
+
 private:
 	void initShader(const wchar_t* vs, const wchar_t* ps);
 
@@ -1,4 +1,5 @@
 #include "AModel.h"
+#include "MeshOptimiser.h"
 
 AModel::AModel(ID3D11Device* ldevice, const std::string& file)
 {
@@ -44,6 +45,11 @@ void AModel::importModel(const std::string& pFile)
 		processNode(scene->mRootNode, scene);
 	}
 
+	// Reorder for the post-transform cache, overdraw and vertex fetch, before the buffers and the CPU copies are kept.
+	int optimisedCount = (int)vertices.size();
+	MeshOptimiser::optimise(pFile, vertices.data(), optimisedCount, indices.data(), (int)indices.size());
+	vertices.resize(optimisedCount);
+
 	// Set up the description of the static vertex buffer.
 	D3D11_BUFFER_DESC vertexBufferDesc, indexBufferDesc;
 	D3D11_SUBRESOURCE_DATA vertexData, indexData;
@@ -30,6 +30,9 @@ public:
 	AModel(ID3D11Device* device, const std::string& file);
 	~AModel();
 
+	const std::vector<VertexType>& getVertices() const { return vertices; }		///< CPU copy of the imported vertices, kept after the buffers are made
+	const std::vector<unsigned long>& getIndices() const { return indices; }	///< CPU copy of the imported indices
+
 protected:
 	void initBuffers(ID3D11Device* device);
 	void importModel(const std::string& pFile);
@@ -5,6 +5,8 @@
 
 BaseApplication::BaseApplication()
 {
+	jobs = 0;
+	msaaSamples = MSAA_SAMPLES;
 }
 
 // Release resources.
@@ -34,9 +36,16 @@ BaseApplication::~BaseApplication()
 		delete textureMgr;
 		textureMgr = 0;
 	}
+
+	if (jobs)
+	{
+		JobSystem::setShared(nullptr);
+		delete jobs;
+		jobs = 0;
+	}
 }
 
-// Default application initialisation. Create renderer, camera, timer and imGUI objects.
+// Default application initialisation. Create renderer, camera, timer, job system and imGUI objects.
 void BaseApplication::init(HINSTANCE hinstance, HWND hwnd, int screenWidth, int screenHeight, Input *in, bool VSYNC, bool FULL_SCREEN)
 {
 	input = in;
@@ -45,7 +54,7 @@ void BaseApplication::init(HINSTANCE hinstance, HWND hwnd, int screenWidth, int
 	sHeight = screenHeight;
 
 	// Create the Direct3D renderer.
-	renderer = new D3D(screenWidth, screenHeight, VSYNC, hwnd, FULL_SCREEN, SCREEN_DEPTH, SCREEN_NEAR);
+	renderer = new D3D(screenWidth, screenHeight, VSYNC, hwnd, FULL_SCREEN, SCREEN_DEPTH, SCREEN_NEAR, msaaSamples);
 	if (!renderer)
 	{
 		MessageBox(hwnd, L"Could not initialize DirectX 11.", L"Error", MB_OK);
@@ -64,6 +73,10 @@ void BaseApplication::init(HINSTANCE hinstance, HWND hwnd, int screenWidth, int
 	textureMgr = new TextureManager(renderer->getDevice(), renderer->getDeviceContext());
 	//textureMgr->loadTexture(L"default", L"res/DefaultDiffuse.png");
 
+	// Create the job system, one worker for every other hardware thread.
+	jobs = new JobSystem();
+	JobSystem::setShared(jobs);
+
 	//Initialise ImGUI
 	ImGui::CreateContext();
 	ImGuiIO& io = ImGui::GetIO(); (void)io;
@@ -2,6 +2,8 @@
 // Base mesh class, for inheriting base mesh functionality.
 
 #include "basemesh.h"
+#include "VertexPacker.h"
+#include <vector>
 
 BaseMesh::BaseMesh()
 {
@@ -9,7 +11,13 @@ BaseMesh::BaseMesh()
 	indexBuffer = nullptr;
 	vertexCount = 0;
 	indexCount = 0;
-
+	packedVertexBuffer = nullptr;
+	packedMinimum = XMFLOAT3(0.0f, 0.0f, 0.0f);
+	packedSize = 1.0f;
+	compactNormals = false;
+	drawPacked = false;
+	positionBuffer = nullptr;
+	texCoordBuffer = nullptr;
 }
 
 // Release base objects (index, vertex buffers and texture object.
@@ -26,6 +34,24 @@ BaseMesh::~BaseMesh()
 		vertexBuffer->Release();
 		vertexBuffer = 0;
 	}
+
+	if (packedVertexBuffer)
+	{
+		packedVertexBuffer->Release();
+		packedVertexBuffer = 0;
+	}
+
+	if (positionBuffer)
+	{
+		positionBuffer->Release();
+		positionBuffer = 0;
+	}
+
+	if (texCoordBuffer)
+	{
+		texCoordBuffer->Release();
+		texCoordBuffer = 0;
+	}
 }
 
 int BaseMesh::getIndexCount()
@@ -35,20 +61,195 @@ int BaseMesh::getIndexCount()
 
 // Sends geometry data to the GPU. Default primitive topology is TriangleList.
 // To render alternative topologies this function needs to be overwritten.
-void BaseMesh::sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top)
+unsigned int BaseMesh::sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top)
 {
 	unsigned int stride;
 	unsigned int offset;
 	
 	// Set vertex buffer stride and offset.
-	stride = sizeof(VertexType);
+	stride = getVertexStride();
 	offset = 0;
 
-	deviceContext->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+	deviceContext->IASetVertexBuffers(0, 1, isDrawingPacked() ? &packedVertexBuffer : &vertexBuffer, &stride, &offset);
+	deviceContext->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	deviceContext->IASetPrimitiveTopology(top);
+
+	return stride;
+}
+
+// Sends the float vertices and the instances together, each instance draws every index once more.
+unsigned int BaseMesh::sendInstancedData(ID3D11DeviceContext* deviceContext, ID3D11Buffer* instanceBuffer, unsigned int instanceStride, D3D_PRIMITIVE_TOPOLOGY top)
+{
+	ID3D11Buffer* buffers[2] = { vertexBuffer, instanceBuffer };
+	unsigned int strides[2] = { sizeof(VertexType), instanceStride };
+	unsigned int offsets[2] = { 0, 0 };
+
+	deviceContext->IASetVertexBuffers(0, 2, buffers, strides, offsets);
+	deviceContext->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	deviceContext->IASetPrimitiveTopology(top);
+
+	return strides[0];
+}
+
+// Sends only the position and texture coordinate streams, falling back to sendData() for meshes that haven't made them.
+unsigned int BaseMesh::sendPositionData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top)
+{
+	if (!hasPositionStreams())
+	{
+		return sendData(deviceContext, top);
+	}
+
+	ID3D11Buffer* buffers[2] = { positionBuffer, texCoordBuffer };
+	unsigned int strides[2] = { sizeof(XMFLOAT3), sizeof(XMFLOAT2) };
+	unsigned int offsets[2] = { 0, 0 };
+
+	deviceContext->IASetVertexBuffers(0, 2, buffers, strides, offsets);
 	deviceContext->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
 	deviceContext->IASetPrimitiveTopology(top);
+
+	return strides[0] + strides[1];
+}
+
+// Encodes the vertices with VertexPacker and uploads them as a second, immutable vertex buffer.
+void BaseMesh::createPackedVertices(ID3D11Device* device, const VertexType* vertices, int count, bool compact)
+{
+	D3D11_BUFFER_DESC vertexBufferDesc;
+	D3D11_SUBRESOURCE_DATA vertexData;
+
+	if (packedVertexBuffer)
+	{
+		packedVertexBuffer->Release();
+		packedVertexBuffer = 0;
+	}
+
+	VertexPacker::Bounds bounds = VertexPacker::getBounds(vertices, count);
+	std::vector<unsigned char> packed(count * VertexPacker::getStride(compact));
+
+	if (compact)
+	{
+		VertexPacker::encode(vertices, count, bounds, (VertexType_PackedCompact*)packed.data());
+	}
+	else
+	{
+		VertexPacker::encode(vertices, count, bounds, (VertexType_Packed*)packed.data());
+	}
+
+	packedMinimum = bounds.minimum;
+	packedSize = bounds.size;
+	compactNormals = compact;
+
+	vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+	vertexBufferDesc.ByteWidth = (UINT)packed.size();
+	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	vertexBufferDesc.CPUAccessFlags = 0;
+	vertexBufferDesc.MiscFlags = 0;
+	vertexBufferDesc.StructureByteStride = 0;
+	vertexData.pSysMem = packed.data();
+	vertexData.SysMemPitch = 0;
+	vertexData.SysMemSlicePitch = 0;
+	device->CreateBuffer(&vertexBufferDesc, &vertexData, &packedVertexBuffer);
+}
+
+void BaseMesh::setDrawPacked(bool packed)
+{
+	drawPacked = packed;
+}
+
+bool BaseMesh::isDrawingPacked()
+{
+	return drawPacked && packedVertexBuffer;
+}
+
+bool BaseMesh::hasCompactNormals()
+{
+	return compactNormals;
+}
+
+XMMATRIX BaseMesh::getDecodeMatrix()
+{
+	if (!isDrawingPacked())
+	{
+		return XMMatrixIdentity();
+	}
+
+	return XMMatrixMultiply(XMMatrixScaling(packedSize, packedSize, packedSize), XMMatrixTranslation(packedMinimum.x, packedMinimum.y, packedMinimum.z));
+}
+
+unsigned int BaseMesh::getVertexStride()
+{
+	return isDrawingPacked() ? VertexPacker::getStride(compactNormals) : sizeof(VertexType);
+}
+
+// Splits the vertices into a position stream and a texture coordinate stream. Default usage, so updatePositionStreams() can rewrite them.
+void BaseMesh::createPositionStreams(ID3D11Device* device, const VertexType* vertices, int count)
+{
+	D3D11_BUFFER_DESC bufferDesc;
+	D3D11_SUBRESOURCE_DATA bufferData;
+
+	if (positionBuffer)
+	{
+		positionBuffer->Release();
+		positionBuffer = 0;
+	}
+
+	if (texCoordBuffer)
+	{
+		texCoordBuffer->Release();
+		texCoordBuffer = 0;
+	}
+
+	std::vector<XMFLOAT3> positions(count);
+	std::vector<XMFLOAT2> texCoords(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		positions[i] = vertices[i].position;
+		texCoords[i] = vertices[i].texture;
+	}
+
+	bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	bufferDesc.ByteWidth = sizeof(XMFLOAT3) * count;
+	bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	bufferDesc.CPUAccessFlags = 0;
+	bufferDesc.MiscFlags = 0;
+	bufferDesc.StructureByteStride = 0;
+	bufferData.pSysMem = positions.data();
+	bufferData.SysMemPitch = 0;
+	bufferData.SysMemSlicePitch = 0;
+	device->CreateBuffer(&bufferDesc, &bufferData, &positionBuffer);
+
+	bufferDesc.ByteWidth = sizeof(XMFLOAT2) * count;
+	bufferData.pSysMem = texCoords.data();
+	device->CreateBuffer(&bufferDesc, &bufferData, &texCoordBuffer);
 }
 
+void BaseMesh::updatePositionStreams(ID3D11DeviceContext* deviceContext, const VertexType* vertices)
+{
+	if (!hasPositionStreams())
+	{
+		return;
+	}
+
+	std::vector<XMFLOAT3> positions(vertexCount);
+	std::vector<XMFLOAT2> texCoords(vertexCount);
+
+	for (int i = 0; i < vertexCount; i++)
+	{
+		positions[i] = vertices[i].position;
+		texCoords[i] = vertices[i].texture;
+	}
 
+	deviceContext->UpdateSubresource(positionBuffer, 0, NULL, positions.data(), 0, 0);
+	deviceContext->UpdateSubresource(texCoordBuffer, 0, NULL, texCoords.data(), 0, 0);
+}
 
+bool BaseMesh::hasPositionStreams()
+{
+	return positionBuffer && texCoordBuffer;
+}
+
+int BaseMesh::getVertexCount()
+{
+	return vertexCount;
+}
 
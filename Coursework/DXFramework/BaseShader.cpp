@@ -240,7 +240,228 @@ void BaseShader::loadColourVertexShader(const wchar_t* filename)
 	vertexShaderBuffer = 0;
 }
 
+// Given pre-compiled file, load and create vertex shader for packed vertices, see VertexPacker.
+// The formats widen them back to floats as they are fetched, the shader only decodes the octahedral normal.
+void BaseShader::loadPackedVertexShader(const wchar_t* filename, bool compactNormals)
+{
+	ID3DBlob* vertexShaderBuffer;
+
+	unsigned int numElements;
+
+	vertexShaderBuffer = 0;
+
+	// check file extension for correct loading function.
+	std::wstring fn(filename);
+	std::string::size_type idx;
+	std::wstring extension;
+
+	idx = fn.rfind('.');
+
+	if (idx != std::string::npos)
+	{
+		extension = fn.substr(idx + 1);
+	}
+	else
+	{
+		// No extension found
+		MessageBox(hwnd, L"Error finding vertex shader file", L"ERROR", MB_OK);
+		exit(0);
+	}
+
+	// Load the texture in.
+	if (extension != L"cso")
+	{
+		MessageBox(hwnd, L"Incorrect vertex shader file type", L"ERROR", MB_OK);
+		exit(0);
+	}
+
+	// Reads compiled shader into buffer (bytecode).
+	HRESULT result = D3DReadFileToBlob(filename, &vertexShaderBuffer);
+	if (result != S_OK)
+	{
+		MessageBox(NULL, filename, L"File ERROR", MB_OK);
+		exit(0);
+	}
+
+	// Create the vertex shader from the buffer.
+	renderer->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), NULL, &vertexShader);
+
+	// Create the vertex input layout description.
+	// This setup needs to match VertexType_Packed or VertexType_PackedCompact in BaseMesh, the compact normal sits in the position's w.
+	D3D11_INPUT_ELEMENT_DESC polygonLayout[] = {
+		{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 8, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "NORMAL", 0, compactNormals ? DXGI_FORMAT_R8G8_SNORM : DXGI_FORMAT_R16G16_SNORM, 0, compactNormals ? 6u : 12u, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+	};
+
+	// Get a count of the elements in the layout.
+	numElements = sizeof(polygonLayout) / sizeof(polygonLayout[0]);
+
+	// Create the vertex input layout.
+	renderer->CreateInputLayout(polygonLayout, numElements, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), &layout);
+
+	// Release the vertex shader buffer and pixel shader buffer since they are no longer needed.
+	vertexShaderBuffer->Release();
+	vertexShaderBuffer = 0;
+}
+
+// Given pre-compiled file, load and create vertex shader reading positions and texture coordinates from two streams.
+// Depth only passes bind just these, see BaseMesh::sendPositionData().
+void BaseShader::loadPositionVertexShader(const wchar_t* filename)
+{
+	ID3DBlob* vertexShaderBuffer;
+
+	unsigned int numElements;
+
+	vertexShaderBuffer = 0;
+
+	// check file extension for correct loading function.
+	std::wstring fn(filename);
+	std::string::size_type idx;
+	std::wstring extension;
+
+	idx = fn.rfind('.');
+
+	if (idx != std::string::npos)
+	{
+		extension = fn.substr(idx + 1);
+	}
+	else
+	{
+		// No extension found
+		MessageBox(hwnd, L"Error finding vertex shader file", L"ERROR", MB_OK);
+		exit(0);
+	}
+
+	// Load the texture in.
+	if (extension != L"cso")
+	{
+		MessageBox(hwnd, L"Incorrect vertex shader file type", L"ERROR", MB_OK);
+		exit(0);
+	}
+
+	// Reads compiled shader into buffer (bytecode).
+	HRESULT result = D3DReadFileToBlob(filename, &vertexShaderBuffer);
+	if (result != S_OK)
+	{
+		MessageBox(NULL, filename, L"File ERROR", MB_OK);
+		exit(0);
+	}
 
+	// Create the vertex shader from the buffer.
+	renderer->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), NULL, &vertexShader);
+
+	// Create the vertex input layout description.
+	// This setup needs to match the streams BaseMesh::createPositionStreams() makes, one per input slot.
+	D3D11_INPUT_ELEMENT_DESC polygonLayout[] = {
+		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 1, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+	};
+
+	// Get a count of the elements in the layout.
+	numElements = sizeof(polygonLayout) / sizeof(polygonLayout[0]);
+
+	// Create the vertex input layout.
+	renderer->CreateInputLayout(polygonLayout, numElements, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), &layout);
+
+	// Release the vertex shader buffer and pixel shader buffer since they are no longer needed.
+	vertexShaderBuffer->Release();
+	vertexShaderBuffer = 0;
+}
+
+// Given pre-compiled file, load and create vertex shader for standard geometry drawn once per instance.
+// Each instance's world matrix comes from the second input slot, see InstanceBuffer.
+void BaseShader::loadInstancedWorldVertexShader(const wchar_t* filename)
+{
+	ID3DBlob* vertexShaderBuffer;
+
+	unsigned int numElements;
+
+	vertexShaderBuffer = 0;
+
+	// check file extension for correct loading function.
+	std::wstring fn(filename);
+	std::string::size_type idx;
+	std::wstring extension;
+
+	idx = fn.rfind('.');
+
+	if (idx != std::string::npos)
+	{
+		extension = fn.substr(idx + 1);
+	}
+	else
+	{
+		// No extension found
+		MessageBox(hwnd, L"Error finding vertex shader file", L"ERROR", MB_OK);
+		exit(0);
+	}
+
+	// Load the texture in.
+	if (extension != L"cso")
+	{
+		MessageBox(hwnd, L"Incorrect vertex shader file type", L"ERROR", MB_OK);
+		exit(0);
+	}
+
+	// Reads compiled shader into buffer (bytecode).
+	HRESULT result = D3DReadFileToBlob(filename, &vertexShaderBuffer);
+	if (result != S_OK)
+	{
+		MessageBox(NULL, filename, L"File ERROR", MB_OK);
+		exit(0);
+	}
+
+	// Create the vertex shader from the buffer.
+	renderer->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), NULL, &vertexShader);
+
+	// Create the vertex input layout description.
+	// The mesh's VertexType in slot 0 and InstanceBuffer::Instance in slot 1, advancing once per instance.
+	D3D11_INPUT_ELEMENT_DESC polygonLayout[] = {
+		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		{ "WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		{ "WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		{ "WORLD", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 48, D3D11_INPUT_PER_INSTANCE_DATA, 1 }
+	};
+
+	// Get a count of the elements in the layout.
+	numElements = sizeof(polygonLayout) / sizeof(polygonLayout[0]);
+
+	// Create the vertex input layout.
+	renderer->CreateInputLayout(polygonLayout, numElements, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), &layout);
+
+	// Release the vertex shader buffer and pixel shader buffer since they are no longer needed.
+	vertexShaderBuffer->Release();
+	vertexShaderBuffer = 0;
+}
+
+
+
+// Picks the loader whose input layout matches the vertices.
+void BaseShader::loadVertexShader(const wchar_t* filename, VertexInput input)
+{
+	switch (input)
+	{
+	case PACKED_VERTICES:
+		loadPackedVertexShader(filename, false);
+		break;
+	case PACKED_COMPACT_VERTICES:
+		loadPackedVertexShader(filename, true);
+		break;
+	case POSITION_STREAMS:
+		loadPositionVertexShader(filename);
+		break;
+	case INSTANCED_WORLDS:
+		loadInstancedWorldVertexShader(filename);
+		break;
+	default:
+		loadVertexShader(filename);
+		break;
+	}
+}
 
 // Given pre-compiled file, load and create pixel shader.
 void BaseShader::loadPixelShader(const wchar_t* filename)
@@ -463,6 +684,24 @@ void BaseShader::loadComputeShader(const wchar_t* filename)
 
 // De/Activate shader stages and send shaders to GPU.
 void BaseShader::render(ID3D11DeviceContext* deviceContext, int indexCount)
+{
+	bind(deviceContext);
+
+	// Render the triangle.
+	deviceContext->DrawIndexed(indexCount, 0, 0);
+}
+
+// De/Activate shader stages and send shaders to GPU.
+void BaseShader::renderInstanced(ID3D11DeviceContext* deviceContext, int indexCount, int instanceCount)
+{
+	bind(deviceContext);
+
+	// Render every instance of the triangles.
+	deviceContext->DrawIndexedInstanced(indexCount, instanceCount, 0, 0, 0);
+}
+
+// De/Activate shader stages without drawing.
+void BaseShader::bind(ID3D11DeviceContext* deviceContext)
 {
 	// Set the vertex input layout.
 	deviceContext->IASetInputLayout(layout);
@@ -493,8 +732,11 @@ void BaseShader::render(ID3D11DeviceContext* deviceContext, int indexCount)
 	{
 		deviceContext->GSSetShader(NULL, NULL, 0);
 	}
+}
 
-	// Render the triangle.
+// Draw with the shader stages already set.
+void BaseShader::draw(ID3D11DeviceContext* deviceContext, int indexCount)
+{
 	deviceContext->DrawIndexed(indexCount, 0, 0);
 }
 
@@ -37,6 +37,16 @@ protected:
 	};
 
 public:
+	/// Vertices a vertex shader can read, each loaded with its own input layout
+	enum VertexInput
+	{
+		VERTICES,					///< Interleaved BaseMesh::VertexType
+		PACKED_VERTICES,			///< BaseMesh::VertexType_Packed, see BaseMesh::setDrawPacked()
+		PACKED_COMPACT_VERTICES,	///< BaseMesh::VertexType_PackedCompact
+		POSITION_STREAMS,			///< Positions and texture coordinates only, see BaseMesh::sendPositionData()
+		INSTANCED_WORLDS			///< VertexType with per instance world matrices, see InstanceBuffer
+	};
+
 	void* operator new(size_t i)
 	{
 		return _mm_malloc(i, 16);
@@ -54,6 +64,18 @@ public:
 	* Sets shader stages and draws the indexed data
 	*/
 	virtual void render(ID3D11DeviceContext* deviceContext, int vertexCount);
+	/** \Brief renderInstanced function
+	* Sets shader stages and draws the indexed data once per instance
+	*/
+	virtual void renderInstanced(ID3D11DeviceContext* deviceContext, int indexCount, int instanceCount);
+	/** \Brief bind function
+	* Sets the input layout and shader stages without drawing, for several draws with the same shader
+	*/
+	void bind(ID3D11DeviceContext* deviceContext);
+	/** \Brief draw function
+	* Draws the indexed data with the stages set by the last bind() or render()
+	*/
+	void draw(ID3D11DeviceContext* deviceContext, int indexCount);
 	void compute(ID3D11DeviceContext* dc, int x, int y, int z);
 
 protected:
@@ -61,6 +83,10 @@ protected:
 	void loadVertexShader(const wchar_t* filename);		///< Load Vertex shader, for stand position, tex, normal geomtry
 	void loadColourVertexShader(const wchar_t* filename);		///< Load Vertex shader, pre-made for position and colour only
 	void loadTextureVertexShader(const wchar_t* filename);		///< Load Vertex shader, pre-made for position and tex only
+	void loadPackedVertexShader(const wchar_t* filename, bool compactNormals = false);	///< Load Vertex shader, for VertexType_Packed or, with compactNormals, VertexType_PackedCompact geometry
+	void loadPositionVertexShader(const wchar_t* filename);	///< Load Vertex shader, for position and tex in separate streams
+	void loadInstancedWorldVertexShader(const wchar_t* filename);	///< Load Vertex shader, for standard geometry with per instance world matrices
+	void loadVertexShader(const wchar_t* filename, VertexInput input);	///< Load Vertex shader with the input layout for the vertices it reads
 	void loadHullShader(const wchar_t* filename);		///< Load Hull shader
 	void loadDomainShader(const wchar_t* filename);		///< Load Domain shader
 	void loadGeometryShader(const wchar_t* filename);	///< Load Geometry shader
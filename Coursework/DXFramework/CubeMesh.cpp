@@ -2,6 +2,7 @@
 // Generates cube mesh at set resolution. Default res is 20.
 // Mesh has texture coordinates and normals.
 #include "cubemesh.h"
+#include "MeshOptimiser.h"
 
 // Initialise vertex data, buffers and load texture.
 CubeMesh::CubeMesh(ID3D11Device* device, ID3D11DeviceContext* deviceContext, int lresolution)
@@ -513,6 +514,9 @@ void CubeMesh::initBuffers(ID3D11Device* device)
 	}
 
 	
+	// Reorder for the post-transform cache, overdraw and vertex fetch, merging duplicate vertices.
+	MeshOptimiser::optimise("CubeMesh", vertices, vertexCount, indices, indexCount);
+
 	// Set up the description of the static vertex buffer.
 	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
 	vertexBufferDesc.ByteWidth = sizeof(VertexType)* vertexCount;
@@ -526,6 +530,8 @@ void CubeMesh::initBuffers(ID3D11Device* device)
 	vertexData.SysMemSlicePitch = 0;
 	// Now create the vertex buffer.
 	device->CreateBuffer(&vertexBufferDesc, &vertexData, &vertexBuffer);
+	// The positions and texture coordinates again on their own, for the shadow passes.
+	createPositionStreams(device, vertices, vertexCount);
 
 	// Set up the description of the static index buffer.
 	indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
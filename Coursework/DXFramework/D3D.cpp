@@ -5,13 +5,14 @@
 
 // Configures and initilises a DirectX renderer.
 // Including render states for wireframe, alpha blending and orthographics rendering.
-D3D::D3D(int screenWidth, int screenHeight, bool vsync, HWND hwnd, bool fullscreen, float screenDepth, float screenNear)
+D3D::D3D(int screenWidth, int screenHeight, bool vsync, HWND hwnd, bool fullscreen, float screenDepth, float screenNear, int samples)
 {
 	// Store rendering control variables.
 	vsync_enabled = vsync;
 	wireframeState = false;
 	zbufferState = true;
 	alphaBlendState = false;
+	sampleCount = samples < 1 ? 1 : samples;
 
 	wnd = &hwnd;
 	isFullscreen = fullscreen;
@@ -99,7 +100,18 @@ void D3D::createSwapchain()
 	swapChainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
 	swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
 	swapChainDesc.OutputWindow = *wnd;
-	swapChainDesc.SampleDesc.Count = 1;
+
+	// Multisample the back buffer if the adapter supports the sample count for its format.
+	UINT qualityLevels = 0;
+	if (sampleCount > 1)
+	{
+		device->CheckMultisampleQualityLevels(DXGI_FORMAT_R8G8B8A8_UNORM, sampleCount, &qualityLevels);
+		if (qualityLevels == 0)
+		{
+			sampleCount = 1;
+		}
+	}
+	swapChainDesc.SampleDesc.Count = sampleCount;
 	swapChainDesc.SampleDesc.Quality = 0;
 
 	// Set to full screen or windowed mode.
@@ -145,7 +157,7 @@ void D3D::createDepthBuffer()
 	depthBufferDesc.MipLevels = 1;
 	depthBufferDesc.ArraySize = 1;
 	depthBufferDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
-	depthBufferDesc.SampleDesc.Count = 1;
+	depthBufferDesc.SampleDesc.Count = sampleCount;	// Must match the back buffer.
 	depthBufferDesc.SampleDesc.Quality = 0;
 	depthBufferDesc.Usage = D3D11_USAGE_DEFAULT;
 	depthBufferDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
@@ -186,7 +198,7 @@ void D3D::createStencilBuffer()
 	D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc;
 	ZeroMemory(&depthStencilViewDesc, sizeof(depthStencilViewDesc));
 	depthStencilViewDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
-	depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+	depthStencilViewDesc.ViewDimension = sampleCount > 1 ? D3D11_DSV_DIMENSION_TEXTURE2DMS : D3D11_DSV_DIMENSION_TEXTURE2D;
 	depthStencilViewDesc.Texture2D.MipSlice = 0;
 
 	// Create the depth stencil view.
@@ -207,7 +219,7 @@ void D3D::createDefaultRasterState()
 	rasterDesc.DepthClipEnable = true;
 	rasterDesc.FillMode = D3D11_FILL_SOLID;
 	rasterDesc.FrontCounterClockwise = true;
-	rasterDesc.MultisampleEnable = false;
+	rasterDesc.MultisampleEnable = sampleCount > 1;
 	rasterDesc.ScissorEnable = false;
 	rasterDesc.SlopeScaledDepthBias = 0.0f;
 
@@ -294,6 +306,14 @@ void D3D::createBlendState()
 	// Modify the description to create an alpha disabled blend state description.
 	blendStateDescription.RenderTarget[0].BlendEnable = FALSE;
 	device->CreateBlendState(&blendStateDescription, &alphaDisableBlendingState);
+
+	// Alpha to coverage state, the pixel's alpha picks how many samples it covers instead of being blended.
+	device->CreateBlendState(&blendStateDescription, &alphaToCoverageState);
+
+	// Blending without alpha to coverage, which on a single sample target would cut out the texels the blend should fade.
+	blendStateDescription.AlphaToCoverageEnable = FALSE;
+	blendStateDescription.RenderTarget[0].BlendEnable = TRUE;
+	device->CreateBlendState(&blendStateDescription, &sortedBlendingState);
 }
 
 // Releases swap chain. Failure to do so will throw an exception.
@@ -316,6 +336,18 @@ D3D::~D3D()
 		alphaDisableBlendingState = 0;
 	}
 
+	if (alphaToCoverageState)
+	{
+		alphaToCoverageState->Release();
+		alphaToCoverageState = 0;
+	}
+
+	if (sortedBlendingState)
+	{
+		sortedBlendingState->Release();
+		sortedBlendingState = 0;
+	}
+
 	if (depthDisabledStencilState)
 	{
 		depthDisabledStencilState->Release();
@@ -446,6 +478,11 @@ void D3D::setZBuffer(bool b)
 	}
 }
 
+void D3D::setZBuffer(bool b, ID3D11DeviceContext* context)
+{
+	context->OMSetDepthStencilState(b ? depthStencilState : depthDisabledStencilState, 1);
+}
+
 bool D3D::getZBufferState()
 {
 	return zbufferState;
@@ -479,6 +516,45 @@ bool D3D::getAlphaBlendingState()
 	return alphaBlendState;
 }
 
+// Sets the blending state to alpha to coverage, or back to no blending
+void D3D::setAlphaToCoverage(bool b)
+{
+	alphaBlendState = false;
+
+	float blendFactor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+	if (b)
+	{
+		deviceContext->OMSetBlendState(alphaToCoverageState, blendFactor, 0xffffffff);
+	}
+	else
+	{
+		deviceContext->OMSetBlendState(alphaDisableBlendingState, blendFactor, 0xffffffff);
+	}
+}
+
+// Sets blending without alpha to coverage, for transparency drawn in depth order, or back to no blending
+void D3D::setSortedBlending(bool b)
+{
+	alphaBlendState = false;
+
+	float blendFactor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+	if (b)
+	{
+		deviceContext->OMSetBlendState(sortedBlendingState, blendFactor, 0xffffffff);
+	}
+	else
+	{
+		deviceContext->OMSetBlendState(alphaDisableBlendingState, blendFactor, 0xffffffff);
+	}
+}
+
+int D3D::getSampleCount()
+{
+	return sampleCount;
+}
+
 // Set the back buffer as the render target
 void D3D::setBackBufferRenderTarget()
 {
@@ -510,4 +586,14 @@ void D3D::setWireframeMode(bool b)
 bool D3D::getWireframeState() 
 {
 	return wireframeState;
+}
+
+// Copy the tracked states to another context, the blend state is alpha blending or none
+void D3D::applyStates(ID3D11DeviceContext* context)
+{
+	float blendFactor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+	context->OMSetDepthStencilState(zbufferState ? depthStencilState : depthDisabledStencilState, 1);
+	context->OMSetBlendState(alphaBlendState ? alphaEnableBlendingState : alphaDisableBlendingState, blendFactor, 0xffffffff);
+	context->RSSetState(wireframeState ? rasterStateWF : rasterState);
 }
\ No newline at end of file
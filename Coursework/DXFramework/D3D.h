@@ -46,8 +46,9 @@ public:
 	* @param fullscreen is a boolean if fullscreen is dis/enabled
 	* @param screenDepth is the distance of the far plane for projection matrix generation
 	* @param screenNear is the near plane for projection matrix generation
+	* @param samples is the number of samples per pixel of the back buffer, falls back to 1 if the adapter can't multisample
 	*/
-	D3D(int screenWidth, int screenHeight, bool vsync, HWND hwnd, bool fullscreen, float screenDepth, float screenNear);
+	D3D(int screenWidth, int screenHeight, bool vsync, HWND hwnd, bool fullscreen, float screenDepth, float screenNear, int samples = 1);
 	~D3D();
 
 	/// Begin rendering frame, set background colour
@@ -64,11 +65,16 @@ public:
 
 	// Control render states
 	void setZBuffer(bool b);	///< Sets z-buffer on/off for orthographic rendering
+	void setZBuffer(bool b, ID3D11DeviceContext* context);	///< Sets z-buffer on/off on another context, such as a deferred one, leaving the tracked state alone
 	bool getZBufferState();		///< Returns if the z-buffer is on/off
 
 
 	void setAlphaBlending(bool b);	///< Sets the alpha blending state on/off for transparent rendering
 	bool getAlphaBlendingState();	///< Returns alphab blending state, if on/off
+
+	void setAlphaToCoverage(bool b);	///< Sets alpha to coverage on/off, turning alpha blending off. Only smooth with a multisampled target
+	void setSortedBlending(bool b);		///< Sets alpha blending without alpha to coverage on/off, for transparency drawn back to front on any target
+	int getSampleCount();				///< Returns the number of samples per pixel of the back buffer
 	
 	void setWireframeMode(bool b);	///< Set wireframe render mode on/off
 	bool getWireframeState();		///< Returns currect wireframe state on/off
@@ -76,6 +82,10 @@ public:
 	void setBackBufferRenderTarget();	///< Sets the back buffer as the render target
 	void resetViewport();				///< Restores viewport if dimensions of render target were different
 
+	/// Sets the tracked z-buffer, alpha blending and wireframe states on another context. Deferred contexts start from the pipeline's
+	/// defaults rather than the immediate context's states, so command lists recorded on them call this first.
+	void applyStates(ID3D11DeviceContext* context);
+
 private:
 	void createDevice();
 	void createSwapchain();
@@ -94,6 +104,7 @@ protected:
 	bool zbufferState;		///< Variable tracks z-buffer state
 	bool wireframeState;	///< Variable tracks wireframe state
 	bool alphaBlendState;	///< Variable tracks alpha blending state
+	int sampleCount;		///< Samples per pixel of the back buffer and depth buffer
 
 	bool isFullscreen;
 	HWND* wnd;
@@ -120,6 +131,8 @@ protected:
 	ID3D11DepthStencilState* depthDisabledStencilState;
 	ID3D11BlendState* alphaEnableBlendingState;	///< Alpha blend enabled state
 	ID3D11BlendState* alphaDisableBlendingState;///< Alpha blend disabled state
+	ID3D11BlendState* alphaToCoverageState;		///< Alpha to coverage without blending
+	ID3D11BlendState* sortedBlendingState;		///< Alpha blending without alpha to coverage
 	D3D11_VIEWPORT viewport;					///< Default viewport object
 };
 
@@ -0,0 +1,64 @@
+// Instance buffer
+// Dynamic per instance world matrices, rewritten whole each time they change.
+#include "InstanceBuffer.h"
+
+InstanceBuffer::InstanceBuffer(ID3D11Device* device, int lcapacity)
+{
+	D3D11_BUFFER_DESC bufferDesc;
+
+	buffer = nullptr;
+	count = 0;
+	capacity = lcapacity > 0 ? lcapacity : 1;
+
+	bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	bufferDesc.ByteWidth = sizeof(Instance) * capacity;
+	bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	bufferDesc.MiscFlags = 0;
+	bufferDesc.StructureByteStride = 0;
+	device->CreateBuffer(&bufferDesc, NULL, &buffer);
+}
+
+InstanceBuffer::~InstanceBuffer()
+{
+	if (buffer)
+	{
+		buffer->Release();
+		buffer = 0;
+	}
+}
+
+void InstanceBuffer::update(ID3D11DeviceContext* deviceContext, const Instance* instances, int lcount)
+{
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+
+	count = 0;
+
+	if (!buffer || FAILED(deviceContext->Map(buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource)))
+	{
+		return;
+	}
+
+	count = InstanceData::write(mappedResource.pData, capacity, instances, lcount);
+	deviceContext->Unmap(buffer, 0);
+}
+
+ID3D11Buffer* InstanceBuffer::getBuffer()
+{
+	return buffer;
+}
+
+int InstanceBuffer::getCount()
+{
+	return count;
+}
+
+int InstanceBuffer::getCapacity()
+{
+	return capacity;
+}
+
+unsigned int InstanceBuffer::getStride()
+{
+	return sizeof(Instance);
+}
\ No newline at end of file
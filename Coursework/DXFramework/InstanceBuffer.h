@@ -0,0 +1,38 @@
+/**
+* \class Instance Buffer
+*
+* \brief A dynamic vertex buffer of per instance world matrices, for drawing many copies of a mesh in one call.
+*
+* Bind it with BaseMesh::sendInstancedData() and draw with a shader loaded by BaseShader::loadInstancedWorldVertexShader(), whose
+* input layout reads the four rows of each instance's world matrix from the second input slot.
+*/
+
+#pragma once
+
+#include <d3d11.h>
+#include <directxmath.h>
+#include "InstanceData.h"
+
+using namespace DirectX;
+
+class InstanceBuffer
+{
+public:
+	typedef InstanceData::Instance Instance;
+
+	InstanceBuffer(ID3D11Device* device, int capacity);
+	~InstanceBuffer();
+
+	/// Refills the buffer with up to its capacity of instances, discarding what it held before
+	void update(ID3D11DeviceContext* deviceContext, const Instance* instances, int count);
+
+	ID3D11Buffer* getBuffer();
+	int getCount();			///< Instances written by the last update()
+	int getCapacity();
+	static unsigned int getStride();
+
+protected:
+	ID3D11Buffer* buffer;
+	int count;
+	int capacity;
+};
\ No newline at end of file
@@ -0,0 +1,424 @@
+// Job system
+// Work-stealing worker threads, each with a lock-free deque of the jobs it spawned.
+#include "JobSystem.h"
+#include <chrono>
+#include <future>
+
+namespace
+{
+	// The system the current thread belongs to and its deque there
+	struct ThreadSlot
+	{
+		const JobSystem* system;
+		int index;
+	};
+
+	thread_local ThreadSlot threadSlot = { nullptr, -1 };
+
+	JobSystem* sharedJobs = nullptr;
+
+	// Failed searches before a worker with nothing to do sleeps, rather than yielding again
+	const int SPINS_BEFORE_SLEEP = 64;
+}
+
+JobSystem::Deque::Deque() : top(0), bottom(0)
+{
+	for (long long i = 0; i < CAPACITY; i++)
+	{
+		jobs[i].store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+bool JobSystem::Deque::push(Job* job)
+{
+	long long b = bottom.load(std::memory_order_relaxed);
+	long long t = top.load(std::memory_order_acquire);
+
+	if (b - t >= CAPACITY)
+	{
+		return false;
+	}
+
+	// Thieves read the bottom with acquire, so they see the job once they see the new bottom
+	jobs[b & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+	bottom.store(b + 1, std::memory_order_release);
+	return true;
+}
+
+JobSystem::Job* JobSystem::Deque::pop()
+{
+	long long b = bottom.load(std::memory_order_relaxed) - 1;
+	bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	long long t = top.load(std::memory_order_relaxed);
+
+	if (t > b)
+	{
+		// Empty, put the bottom back
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Job* job = jobs[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+
+	if (t == b)
+	{
+		// The last job, which a thief may be taking at the same time. Whoever moves the top first has it.
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			job = nullptr;
+		}
+
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+
+	return job;
+}
+
+JobSystem::Job* JobSystem::Deque::steal()
+{
+	long long t = top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	long long b = bottom.load(std::memory_order_acquire);
+
+	if (t >= b)
+	{
+		return nullptr;
+	}
+
+	Job* job = jobs[t & (CAPACITY - 1)].load(std::memory_order_relaxed);
+
+	// Lost to the owner or another thief
+	if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+		return nullptr;
+	}
+
+	return job;
+}
+
+JobSystem::JobSystem(int workerCount) : stopping(false), queuedJobs(0), sleepingWorkers(0), stolenJobs(0)
+{
+	if (workerCount <= 0)
+	{
+		workerCount = (int)std::thread::hardware_concurrency() - 1;
+	}
+
+	if (workerCount < 0)
+	{
+		workerCount = 0;
+	}
+
+	for (int i = 0; i <= workerCount; i++)
+	{
+		deques.push_back(new Deque());
+	}
+
+	// The thread making the system works on the first deque while it waits
+	threadSlot = { this, 0 };
+
+	for (int i = 1; i <= workerCount; i++)
+	{
+		workers.push_back(std::thread(&JobSystem::workerLoop, this, i));
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	stopping = true;
+
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+	}
+
+	sleepCondition.notify_all();
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+
+	// Jobs left unwaited for are dropped
+	for (Deque* deque : deques)
+	{
+		while (Job* job = deque->pop())
+		{
+			delete job;
+		}
+
+		delete deque;
+	}
+
+	if (threadSlot.system == this)
+	{
+		threadSlot = { nullptr, -1 };
+	}
+}
+
+void JobSystem::run(const std::function<void()>& function, Counter* counter)
+{
+	if (counter)
+	{
+		counter->value.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	Job* job = new Job{ function, counter };
+	int index = getThreadIndex();
+
+	// A thread outside the system, or a full deque, runs the job itself
+	if (index < 0 || !deques[index]->push(job))
+	{
+		execute(job);
+		return;
+	}
+
+	queuedJobs.fetch_add(1);
+
+	// Taking the lock means a worker between checking for jobs and sleeping is already asleep to be woken
+	if (sleepingWorkers.load() > 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+		}
+
+		sleepCondition.notify_one();
+	}
+}
+
+void JobSystem::wait(Counter& counter)
+{
+	int index = getThreadIndex();
+
+	while (counter.value.load(std::memory_order_acquire) > 0)
+	{
+		Job* job = index >= 0 ? findJob(index) : nullptr;
+
+		if (job)
+		{
+			execute(job);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::parallelFor(int count, const std::function<void(int, int)>& body, int minimumPerJob)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	// A few blocks for every thread, so threads that finish early can steal the rest
+	int blockCount = getThreadCount() * 4;
+	int maxBlocks = count / (minimumPerJob > 0 ? minimumPerJob : 1);
+
+	if (blockCount > maxBlocks)
+	{
+		blockCount = maxBlocks;
+	}
+
+	if (blockCount <= 1 || getThreadCount() == 1 || getThreadIndex() < 0)
+	{
+		body(0, count);
+		return;
+	}
+
+	Counter counter;
+	int blockSize = (count + blockCount - 1) / blockCount;
+
+	for (int begin = blockSize; begin < count; begin += blockSize)
+	{
+		int end = begin + blockSize < count ? begin + blockSize : count;
+		run([&body, begin, end]() { body(begin, end); }, &counter);
+	}
+
+	body(0, blockSize < count ? blockSize : count);
+	wait(counter);
+}
+
+int JobSystem::getThreadCount()
+{
+	return (int)deques.size();
+}
+
+long long JobSystem::getStolenCount()
+{
+	return stolenJobs.load(std::memory_order_relaxed);
+}
+
+JobSystem* JobSystem::getShared()
+{
+	return sharedJobs;
+}
+
+void JobSystem::setShared(JobSystem* jobs)
+{
+	sharedJobs = jobs;
+}
+
+void JobSystem::workerLoop(int index)
+{
+	threadSlot = { this, index };
+	int spins = 0;
+
+	while (!stopping)
+	{
+		Job* job = findJob(index);
+
+		if (job)
+		{
+			execute(job);
+			spins = 0;
+			continue;
+		}
+
+		if (++spins < SPINS_BEFORE_SLEEP || queuedJobs.load() > 0)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		// Nothing queued anywhere, sleep until run() queues a job
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		sleepingWorkers++;
+		sleepCondition.wait(lock, [this]() { return stopping || queuedJobs.load() > 0; });
+		sleepingWorkers--;
+		spins = 0;
+	}
+}
+
+JobSystem::Job* JobSystem::findJob(int index)
+{
+	// The thread's own newest job first, then the oldest of each other thread's
+	Job* job = deques[index]->pop();
+
+	for (int i = 1; !job && i < (int)deques.size(); i++)
+	{
+		job = deques[(index + i) % deques.size()]->steal();
+
+		if (job)
+		{
+			stolenJobs.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	if (job)
+	{
+		queuedJobs.fetch_sub(1);
+	}
+
+	return job;
+}
+
+void JobSystem::execute(Job* job)
+{
+	job->function();
+
+	if (job->counter)
+	{
+		job->counter->value.fetch_sub(1, std::memory_order_release);
+	}
+
+	delete job;
+}
+
+int JobSystem::getThreadIndex()
+{
+	return threadSlot.system == this ? threadSlot.index : -1;
+}
+
+// Each part starts with every deque empty and is timed on its own.
+JobSystem::BenchmarkResult JobSystem::benchmark(JobSystem& jobs, int jobCount)
+{
+	BenchmarkResult result = { jobCount, jobs.getThreadCount(), 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+	if (jobCount <= 0)
+	{
+		return result;
+	}
+
+	const int ROUND_TRIPS = 1000;
+	auto empty = []() {};
+
+	// Spawning, then finishing every job
+	Counter counter;
+	long long stolenBefore = jobs.getStolenCount();
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for (int i = 0; i < jobCount; i++)
+	{
+		jobs.run(empty, &counter);
+	}
+
+	auto spawned = std::chrono::high_resolution_clock::now();
+	jobs.wait(counter);
+	auto end = std::chrono::high_resolution_clock::now();
+
+	result.spawnNanoseconds = std::chrono::duration<float, std::nano>(spawned - start).count() / jobCount;
+	result.jobsPerMillisecond = jobCount / std::chrono::duration<float, std::milli>(end - start).count();
+	result.stolenPercent = 100.0f * (float)(jobs.getStolenCount() - stolenBefore) / jobCount;
+
+	// One job at a time
+	start = std::chrono::high_resolution_clock::now();
+
+	for (int i = 0; i < ROUND_TRIPS; i++)
+	{
+		jobs.run(empty, &counter);
+		jobs.wait(counter);
+	}
+
+	end = std::chrono::high_resolution_clock::now();
+	result.roundTripMicroseconds = std::chrono::duration<float, std::micro>(end - start).count() / ROUND_TRIPS;
+
+	// One job at a time again, without the spawning thread helping, so a worker has to wake and steal each
+	if (jobs.getThreadCount() > 1)
+	{
+		start = std::chrono::high_resolution_clock::now();
+
+		for (int i = 0; i < ROUND_TRIPS; i++)
+		{
+			jobs.run(empty, &counter);
+
+			while (counter.value.load(std::memory_order_acquire) > 0)
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		end = std::chrono::high_resolution_clock::now();
+		result.stealMicroseconds = std::chrono::duration<float, std::micro>(end - start).count() / ROUND_TRIPS;
+	}
+
+	// The same with std::async, each task on a thread of its own or the library's pool
+	std::vector<std::future<void>> futures;
+	futures.reserve(jobCount);
+	start = std::chrono::high_resolution_clock::now();
+
+	for (int i = 0; i < jobCount; i++)
+	{
+		futures.push_back(std::async(std::launch::async, empty));
+	}
+
+	for (std::future<void>& future : futures)
+	{
+		future.get();
+	}
+
+	end = std::chrono::high_resolution_clock::now();
+	result.asyncJobsPerMillisecond = jobCount / std::chrono::duration<float, std::milli>(end - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+
+	for (int i = 0; i < ROUND_TRIPS; i++)
+	{
+		std::async(std::launch::async, empty).get();
+	}
+
+	end = std::chrono::high_resolution_clock::now();
+	result.asyncRoundTripMicroseconds = std::chrono::duration<float, std::micro>(end - start).count() / ROUND_TRIPS;
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+/**
+* \class Job System
+*
+* \brief Worker threads running small jobs, each thread with its own work-stealing deque.
+*
+* A thread pushes the jobs it spawns onto the bottom of its own Chase-Lev deque and pops them back from there, so it carries on with
+* the work it spawned last. Threads with nothing left steal from the top of the others' deques. The deques are lock-free, workers
+* only take a lock to sleep once every deque is empty. A job can count down a Counter when it finishes, and wait() runs other jobs
+* until the counter reaches zero, so jobs can wait on the jobs they spawn.
+* BaseApplication owns one, which the rest of the program reaches through getShared().
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem
+{
+public:
+	/// Jobs of a group yet to finish, see run() and wait()
+	struct Counter
+	{
+		std::atomic<int> value{ 0 };
+	};
+
+	/// Empty jobs, so the times are only the scheduling's
+	struct BenchmarkResult
+	{
+		int jobs;
+		int threads;
+		float spawnNanoseconds;				///< Queueing a job on the calling thread's deque
+		float jobsPerMillisecond;			///< Spawning every job and waiting for them all
+		float stolenPercent;				///< Of those, the jobs run by a thread that stole them
+		float roundTripMicroseconds;		///< Spawning one job and waiting for it
+		float stealMicroseconds;			///< Spawning one job and waiting for another thread to steal and run it
+		float asyncJobsPerMillisecond;		///< The same jobs as std::async tasks
+		float asyncRoundTripMicroseconds;
+	};
+
+	/// Starts the worker threads, one fewer than the hardware's threads for 0, as the calling thread works too
+	JobSystem(int workerCount = 0);
+	~JobSystem();
+
+	/// Queues the job on the calling thread's deque, counting the counter up until the job has run. Threads the system didn't start,
+	/// other than the one that made it, run the job at once.
+	void run(const std::function<void()>& job, Counter* counter = nullptr);
+	/// Runs queued jobs until the counter reaches zero
+	void wait(Counter& counter);
+	/// Splits [0, count) into blocks of at least minimumPerJob and runs them as jobs, returning once every block has finished.
+	/// The body receives the first and one past the last index of its block.
+	void parallelFor(int count, const std::function<void(int, int)>& body, int minimumPerJob = 1);
+
+	int getThreadCount();			///< Workers and the thread that made the system
+	long long getStolenCount();		///< Jobs run by a thread other than the one that queued them, since the system started
+
+	static JobSystem* getShared();	///< The application's job system, nullptr outside of one
+	static void setShared(JobSystem* jobs);
+
+	/// Times spawning, stealing and waiting on the given number of empty jobs, against std::async
+	static BenchmarkResult benchmark(JobSystem& jobs, int jobCount);
+
+private:
+	struct Job
+	{
+		std::function<void()> function;
+		Counter* counter;
+	};
+
+	/// Chase-Lev deque of a fixed capacity. Only its thread pushes and pops at the bottom, any thread steals from the top.
+	class Deque
+	{
+	public:
+		Deque();
+
+		bool push(Job* job);	///< False when full
+		Job* pop();
+		Job* steal();
+
+		static const long long CAPACITY = 4096;	///< A power of two
+
+	private:
+		std::atomic<long long> top;
+		std::atomic<long long> bottom;
+		std::atomic<Job*> jobs[CAPACITY];
+	};
+
+	void workerLoop(int index);
+	Job* findJob(int index);
+	void execute(Job* job);
+	int getThreadIndex();
+
+	std::vector<Deque*> deques;			///< One for every thread, the thread that made the system first
+	std::vector<std::thread> workers;
+	std::atomic<bool> stopping;
+	std::atomic<int> queuedJobs;		///< Queued and not yet taken, workers sleep while there are none
+	std::atomic<int> sleepingWorkers;
+	std::atomic<long long> stolenJobs;
+	std::mutex sleepMutex;
+	std::condition_variable sleepCondition;
+};
\ No newline at end of file
@@ -0,0 +1,498 @@
+// Mesh optimiser
+// Reorders triangle lists for the post-transform cache, overdraw and vertex fetch before they are uploaded.
+#include "MeshOptimiser.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+using namespace DirectX;
+
+// Entries of the LRU cache Forsyth's scores are modelled on, larger than the hardware's so vertices about to fall out still count.
+static const int scoringCacheSize = 32;
+
+static float getVertexScore(int cachePosition, int remainingTriangles)
+{
+	if (remainingTriangles == 0)
+	{
+		return -1.0f;
+	}
+
+	float score = 0.0f;
+
+	if (cachePosition >= 0)
+	{
+		// The last triangle's vertices get a fixed score, otherwise the next triangle would always be its neighbour on the same strip.
+		if (cachePosition < 3)
+		{
+			score = 0.75f;
+		}
+		else
+		{
+			score = powf(1.0f - ((float)(cachePosition - 3) / (float)(scoringCacheSize - 3)), 1.5f);
+		}
+	}
+
+	// Vertices with few triangles left are finished off first, so they don't linger as lone triangles for the end.
+	return score + (2.0f * powf((float)remainingTriangles, -0.5f));
+}
+
+std::vector<MeshOptimiser::Report>& MeshOptimiser::reports()
+{
+	static std::vector<Report> recorded;
+	return recorded;
+}
+
+const std::vector<MeshOptimiser::Report>& MeshOptimiser::getReports()
+{
+	return reports();
+}
+
+MeshOptimiser::Report MeshOptimiser::optimise(const std::string& name, VertexFormats::VertexType* vertices, int& vertexCount, unsigned long* indices, int indexCount, bool reorderVertices)
+{
+	Report report = {};
+	report.name = name;
+	report.triangles = indexCount / 3;
+	report.verticesBefore = vertexCount;
+	report.before = analyse(indices, indexCount, vertexCount);
+
+	if (indexCount >= 3 && indexCount % 3 == 0)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		if (reorderVertices)
+		{
+			weldVertices(vertices, vertexCount, indices, indexCount);
+		}
+
+		auto welded = std::chrono::high_resolution_clock::now();
+		optimiseVertexCache(indices, indexCount, vertexCount);
+		auto cached = std::chrono::high_resolution_clock::now();
+		optimiseOverdraw(vertices, indices, indexCount, vertexCount);
+		auto sorted = std::chrono::high_resolution_clock::now();
+
+		if (reorderVertices)
+		{
+			vertexCount = optimiseVertexFetch(vertices, vertexCount, indices, indexCount);
+		}
+
+		auto end = std::chrono::high_resolution_clock::now();
+
+		report.weldMilliseconds = std::chrono::duration<float, std::milli>(welded - start).count();
+		report.cacheMilliseconds = std::chrono::duration<float, std::milli>(cached - welded).count();
+		report.overdrawMilliseconds = std::chrono::duration<float, std::milli>(sorted - cached).count();
+		report.fetchMilliseconds = std::chrono::duration<float, std::milli>(end - sorted).count();
+	}
+
+	report.verticesAfter = vertexCount;
+	report.after = analyse(indices, indexCount, vertexCount);
+
+	// One report per name, so meshes built over and over don't grow the list.
+	std::vector<Report>& recorded = reports();
+	auto existing = std::find_if(recorded.begin(), recorded.end(), [&](const Report& other) { return other.name == name; });
+
+	if (existing != recorded.end())
+	{
+		*existing = report;
+	}
+	else
+	{
+		recorded.push_back(report);
+	}
+
+	return report;
+}
+
+int MeshOptimiser::weldVertices(const VertexFormats::VertexType* vertices, int vertexCount, unsigned long* indices, int indexCount)
+{
+	std::vector<int> sorted(vertexCount);
+
+	for (int i = 0; i < vertexCount; i++)
+	{
+		sorted[i] = i;
+	}
+
+	// Byte for byte, so only vertices that would draw identically are merged.
+	std::sort(sorted.begin(), sorted.end(), [&](int a, int b)
+	{
+		int order = memcmp(&vertices[a], &vertices[b], sizeof(VertexFormats::VertexType));
+		return order != 0 ? order < 0 : a < b;
+	});
+
+	std::vector<unsigned long> remap(vertexCount);
+	int distinct = 0;
+
+	for (int i = 0; i < vertexCount; i++)
+	{
+		bool duplicate = i > 0 && memcmp(&vertices[sorted[i - 1]], &vertices[sorted[i]], sizeof(VertexFormats::VertexType)) == 0;
+		remap[sorted[i]] = duplicate ? remap[sorted[i - 1]] : (unsigned long)sorted[i];
+		distinct += duplicate ? 0 : 1;
+	}
+
+	for (int i = 0; i < indexCount; i++)
+	{
+		indices[i] = remap[indices[i]];
+	}
+
+	return distinct;
+}
+
+void MeshOptimiser::optimiseVertexCache(unsigned long* indices, int indexCount, int vertexCount)
+{
+	int triangleCount = indexCount / 3;
+
+	// Triangles around each vertex. The first remaining[v] of each vertex's list are those not yet drawn.
+	std::vector<int> offsets(vertexCount + 1, 0);
+	std::vector<int> remaining(vertexCount, 0);
+
+	for (int i = 0; i < indexCount; i++)
+	{
+		remaining[indices[i]]++;
+	}
+
+	for (int v = 0; v < vertexCount; v++)
+	{
+		offsets[v + 1] = offsets[v] + remaining[v];
+	}
+
+	std::vector<int> adjacency(indexCount);
+	std::vector<int> filled(offsets.begin(), offsets.end() - 1);
+
+	for (int i = 0; i < indexCount; i++)
+	{
+		adjacency[filled[indices[i]]++] = i / 3;
+	}
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	std::vector<float> triangleScore(triangleCount, 0.0f);
+	std::vector<char> emitted(triangleCount, 0);
+
+	for (int v = 0; v < vertexCount; v++)
+	{
+		vertexScore[v] = getVertexScore(-1, remaining[v]);
+	}
+
+	for (int t = 0; t < triangleCount; t++)
+	{
+		triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[(t * 3) + 1]] + vertexScore[indices[(t * 3) + 2]];
+	}
+
+	int best = (int)(std::max_element(triangleScore.begin(), triangleScore.end()) - triangleScore.begin());
+	int scan = 0;
+	std::vector<unsigned long> output(indexCount);
+	std::vector<int> cache;
+	std::vector<int> nextCache;
+	cache.reserve(scoringCacheSize + 3);
+	nextCache.reserve(scoringCacheSize + 3);
+
+	for (int drawn = 0; drawn < triangleCount; drawn++)
+	{
+		// With nothing in the cache worth drawing, start again from the next triangle in the original order.
+		if (best < 0)
+		{
+			while (emitted[scan])
+			{
+				scan++;
+			}
+
+			best = scan;
+		}
+
+		const unsigned long* triangle = &indices[best * 3];
+		output[drawn * 3] = triangle[0];
+		output[(drawn * 3) + 1] = triangle[1];
+		output[(drawn * 3) + 2] = triangle[2];
+		emitted[best] = 1;
+
+		// The triangle leaves its vertices' lists of triangles left to draw.
+		for (int k = 0; k < 3; k++)
+		{
+			int v = (int)triangle[k];
+			int* list = &adjacency[offsets[v]];
+
+			for (int i = 0; i < remaining[v]; i++)
+			{
+				if (list[i] == best)
+				{
+					list[i] = list[remaining[v] - 1];
+					remaining[v]--;
+					break;
+				}
+			}
+		}
+
+		// The triangle's vertices move to the front of the cache, in front of everything else still in it.
+		nextCache.assign(triangle, triangle + 3);
+
+		for (int v : cache)
+		{
+			if (v != (int)triangle[0] && v != (int)triangle[1] && v != (int)triangle[2])
+			{
+				nextCache.push_back(v);
+			}
+		}
+
+		cache.swap(nextCache);
+
+		// Anything pushed out has no cache position left, and every vertex still in the cache has a new one.
+		for (int i = 0; i < (int)cache.size(); i++)
+		{
+			int v = cache[i];
+			cachePosition[v] = i < scoringCacheSize ? i : -1;
+			vertexScore[v] = getVertexScore(cachePosition[v], remaining[v]);
+		}
+
+		// Only triangles around the cache changed score, so the next triangle is the best of those.
+		float bestScore = -1.0f;
+		best = -1;
+
+		for (int v : cache)
+		{
+			for (int i = 0; i < remaining[v]; i++)
+			{
+				int t = adjacency[offsets[v] + i];
+				triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[(t * 3) + 1]] + vertexScore[indices[(t * 3) + 2]];
+
+				if (triangleScore[t] > bestScore)
+				{
+					bestScore = triangleScore[t];
+					best = t;
+				}
+			}
+		}
+
+		if ((int)cache.size() > scoringCacheSize)
+		{
+			cache.resize(scoringCacheSize);
+		}
+	}
+
+	std::copy(output.begin(), output.end(), indices);
+}
+
+void MeshOptimiser::optimiseOverdraw(const VertexFormats::VertexType* vertices, unsigned long* indices, int indexCount, int vertexCount, float threshold)
+{
+	int triangleCount = indexCount / 3;
+
+	// A FIFO cache as timestamps: a vertex is cached while fewer than cacheSize misses have happened since its own.
+	std::vector<unsigned int> cacheTime(vertexCount, 0);
+	unsigned int time = cacheSize + 1;
+
+	auto countMisses = [&](int t)
+	{
+		int misses = 0;
+
+		for (int k = 0; k < 3; k++)
+		{
+			unsigned long v = indices[(t * 3) + k];
+
+			if (time - cacheTime[v] > (unsigned int)cacheSize)
+			{
+				cacheTime[v] = time++;
+				misses++;
+			}
+		}
+
+		return misses;
+	};
+
+	// Hard boundaries where all three vertices miss, which is where the cache optimisation had to start afresh.
+	std::vector<int> hardClusters(1, 0);
+	countMisses(0);
+
+	for (int t = 1; t < triangleCount; t++)
+	{
+		if (countMisses(t) == 3)
+		{
+			hardClusters.push_back(t);
+		}
+	}
+
+	hardClusters.push_back(triangleCount);
+
+	// Soft boundaries inside each, wherever a cluster so far is already nearly as cache efficient as the whole hard cluster.
+	std::vector<int> clusters;
+
+	for (size_t c = 0; c + 1 < hardClusters.size(); c++)
+	{
+		int start = hardClusters[c];
+		int end = hardClusters[c + 1];
+		int misses = 0;
+		time += cacheSize + 1;
+
+		for (int t = start; t < end; t++)
+		{
+			misses += countMisses(t);
+		}
+
+		float clusterThreshold = threshold * ((float)misses / (float)(end - start));
+
+		misses = 0;
+		time += cacheSize + 1;
+		clusters.push_back(start);
+
+		for (int t = start; t < end; t++)
+		{
+			misses += countMisses(t);
+
+			if (t + 1 < end && (float)misses <= clusterThreshold * (float)(t + 1 - clusters.back()))
+			{
+				clusters.push_back(t + 1);
+				misses = 0;
+				time += cacheSize + 1;
+			}
+		}
+	}
+
+	int clusterCount = (int)clusters.size();
+	clusters.push_back(triangleCount);
+
+	// The mesh's centre and each cluster's centre and facing, weighted by area.
+	auto getCentroid = [&](int start, int end, XMFLOAT3& centroid, XMFLOAT3& normal)
+	{
+		float totalArea = 0.0f;
+		centroid = XMFLOAT3(0.0f, 0.0f, 0.0f);
+		normal = XMFLOAT3(0.0f, 0.0f, 0.0f);
+
+		for (int t = start; t < end; t++)
+		{
+			const XMFLOAT3& p0 = vertices[indices[t * 3]].position;
+			const XMFLOAT3& p1 = vertices[indices[(t * 3) + 1]].position;
+			const XMFLOAT3& p2 = vertices[indices[(t * 3) + 2]].position;
+			XMFLOAT3 e0(p1.x - p0.x, p1.y - p0.y, p1.z - p0.z);
+			XMFLOAT3 e1(p2.x - p0.x, p2.y - p0.y, p2.z - p0.z);
+			XMFLOAT3 n((e0.y * e1.z) - (e0.z * e1.y), (e0.z * e1.x) - (e0.x * e1.z), (e0.x * e1.y) - (e0.y * e1.x));
+			float area = sqrtf((n.x * n.x) + (n.y * n.y) + (n.z * n.z));
+
+			centroid.x += (p0.x + p1.x + p2.x) * (area / 3.0f);
+			centroid.y += (p0.y + p1.y + p2.y) * (area / 3.0f);
+			centroid.z += (p0.z + p1.z + p2.z) * (area / 3.0f);
+			normal.x += n.x;
+			normal.y += n.y;
+			normal.z += n.z;
+			totalArea += area;
+		}
+
+		if (totalArea > 0.0f)
+		{
+			centroid = XMFLOAT3(centroid.x / totalArea, centroid.y / totalArea, centroid.z / totalArea);
+		}
+
+		float length = sqrtf((normal.x * normal.x) + (normal.y * normal.y) + (normal.z * normal.z));
+
+		if (length > 0.0f)
+		{
+			normal = XMFLOAT3(normal.x / length, normal.y / length, normal.z / length);
+		}
+	};
+
+	XMFLOAT3 meshCentroid, meshNormal;
+	getCentroid(0, triangleCount, meshCentroid, meshNormal);
+
+	// Clusters facing out from the centre are drawn first, they are the ones most likely to hide what is behind them.
+	std::vector<float> sortKeys(clusterCount);
+	std::vector<int> order(clusterCount);
+
+	for (int c = 0; c < clusterCount; c++)
+	{
+		XMFLOAT3 centroid, normal;
+		getCentroid(clusters[c], clusters[c + 1], centroid, normal);
+		sortKeys[c] = ((centroid.x - meshCentroid.x) * normal.x) + ((centroid.y - meshCentroid.y) * normal.y) + ((centroid.z - meshCentroid.z) * normal.z);
+		order[c] = c;
+	}
+
+	std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return sortKeys[a] > sortKeys[b]; });
+
+	std::vector<unsigned long> output;
+	output.reserve(indexCount);
+
+	for (int c : order)
+	{
+		output.insert(output.end(), indices + (clusters[c] * 3), indices + (clusters[c + 1] * 3));
+	}
+
+	std::copy(output.begin(), output.end(), indices);
+}
+
+int MeshOptimiser::optimiseVertexFetch(VertexFormats::VertexType* vertices, int vertexCount, unsigned long* indices, int indexCount)
+{
+	std::vector<int> remap(vertexCount, -1);
+	std::vector<VertexFormats::VertexType> reordered;
+	reordered.reserve(vertexCount);
+
+	for (int i = 0; i < indexCount; i++)
+	{
+		unsigned long v = indices[i];
+
+		if (remap[v] < 0)
+		{
+			remap[v] = (int)reordered.size();
+			reordered.push_back(vertices[v]);
+		}
+
+		indices[i] = (unsigned long)remap[v];
+	}
+
+	std::copy(reordered.begin(), reordered.end(), vertices);
+
+	return (int)reordered.size();
+}
+
+MeshOptimiser::Statistics MeshOptimiser::analyse(const unsigned long* indices, int indexCount, int vertexCount)
+{
+	Statistics statistics = { 0.0f, 0.0f, 0.0f };
+
+	if (indexCount < 3 || vertexCount == 0)
+	{
+		return statistics;
+	}
+
+	std::vector<unsigned int> cacheTime(vertexCount, 0);
+	std::vector<char> used(vertexCount, 0);
+	std::vector<long long> lineTags(cacheLines, -1);
+	unsigned int time = cacheSize + 1;
+	int misses = 0;
+	int usedCount = 0;
+	long long bytesFetched = 0;
+
+	for (int i = 0; i < indexCount; i++)
+	{
+		unsigned long v = indices[i];
+
+		if (!used[v])
+		{
+			used[v] = 1;
+			usedCount++;
+		}
+
+		if (time - cacheTime[v] <= (unsigned int)cacheSize)
+		{
+			continue;
+		}
+
+		// A miss runs the vertex shader, which reads each cache line the vertex spans.
+		cacheTime[v] = time++;
+		misses++;
+
+		long long firstByte = (long long)v * sizeof(VertexFormats::VertexType);
+		long long lastByte = firstByte + sizeof(VertexFormats::VertexType) - 1;
+
+		for (long long line = firstByte / cacheLineSize; line <= lastByte / cacheLineSize; line++)
+		{
+			long long& tag = lineTags[line % cacheLines];
+
+			if (tag != line)
+			{
+				tag = line;
+				bytesFetched += cacheLineSize;
+			}
+		}
+	}
+
+	statistics.acmr = (float)misses / (float)(indexCount / 3);
+	statistics.atvr = (float)misses / (float)usedCount;
+	statistics.fetchEfficiency = (float)((double)usedCount * sizeof(VertexFormats::VertexType) / (double)bytesFetched);
+
+	return statistics;
+}
\ No newline at end of file
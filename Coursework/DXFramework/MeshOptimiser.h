@@ -0,0 +1,65 @@
+/**
+* \class Mesh Optimiser
+*
+* \brief Reorders a mesh's triangles and vertices before it is uploaded, for the GPU's post-transform cache, early depth rejection and vertex fetch.
+*
+* Exact duplicate vertices are merged first, then triangles are ordered by Forsyth's linear-speed vertex cache optimisation, clusters of
+* them are sorted outward facing first to cut overdraw (Sander, Nehab and Barczak), and vertices are stored in the order the triangles
+* first use them. Every mesh optimised is reported with its cache and fetch statistics before and after, the latest for each name.
+*/
+
+#pragma once
+
+#include "VertexFormats.h"
+#include <string>
+#include <vector>
+
+class MeshOptimiser
+{
+public:
+	/// Statistics of a triangle list, as a GPU with a 16 entry FIFO post-transform cache and 64 byte vertex cache lines would run it
+	struct Statistics
+	{
+		float acmr;				///< Vertex shader runs per triangle, 0.5 is ideal for a large regular mesh and 3 the worst
+		float atvr;				///< Vertex shader runs per vertex used, 1 is ideal
+		float fetchEfficiency;	///< Vertex bytes used over bytes fetched through the cache lines, 1 is ideal
+	};
+
+	struct Report
+	{
+		std::string name;
+		int triangles;
+		int verticesBefore;
+		int verticesAfter;
+		Statistics before;
+		Statistics after;
+		float weldMilliseconds;
+		float cacheMilliseconds;
+		float overdrawMilliseconds;
+		float fetchMilliseconds;
+	};
+
+	/** \brief Runs every stage on a triangle list in place and records the report
+	*
+	* @param name the report is recorded under, replacing any earlier report of that name
+	* @param vertices are merged and reordered when reorderVertices is set, vertexCount becomes the number still used
+	* @param indices are rewritten in place
+	* @param reorderVertices false keeps the vertices as they are, for meshes that rewrite them by index or share them between index buffers
+	*/
+	static Report optimise(const std::string& name, VertexFormats::VertexType* vertices, int& vertexCount, unsigned long* indices, int indexCount, bool reorderVertices = true);
+
+	static int weldVertices(const VertexFormats::VertexType* vertices, int vertexCount, unsigned long* indices, int indexCount);	///< Points indices at the first of any identical vertices, returns the number of distinct vertices
+	static void optimiseVertexCache(unsigned long* indices, int indexCount, int vertexCount);	///< Forsyth's greedy ordering by cache position and remaining valence
+	static void optimiseOverdraw(const VertexFormats::VertexType* vertices, unsigned long* indices, int indexCount, int vertexCount, float threshold = 1.05f);	///< Sorts clusters of a cache optimised order outward first, keeping each cluster's ACMR within threshold of the order's
+	static int optimiseVertexFetch(VertexFormats::VertexType* vertices, int vertexCount, unsigned long* indices, int indexCount);	///< Stores vertices in first use order and drops unused ones, returns the new count
+
+	static Statistics analyse(const unsigned long* indices, int indexCount, int vertexCount);	///< Simulates the caches over the triangle list
+	static const std::vector<Report>& getReports();	///< Every mesh optimised so far, in the order first seen
+
+	static const int cacheSize = 16;		///< FIFO entries of the simulated post-transform cache
+	static const int cacheLineSize = 64;	///< Bytes per simulated vertex cache line
+	static const int cacheLines = 256;		///< Lines of the simulated direct mapped vertex cache, 16KB
+
+private:
+	static std::vector<Report>& reports();
+};
\ No newline at end of file
@@ -1,6 +1,7 @@
 // Model mesh and load
 // Loads a .obj and creates a mesh object from the data
 #include "model.h"
+#include "MeshOptimiser.h"
 
 // load model datat, initialise buffers (with model data) and load texture.
 Model::Model(ID3D11Device* device, ID3D11DeviceContext* deviceContext, const char* filename)
@@ -44,6 +45,9 @@ void Model::initBuffers(ID3D11Device* device)
 		indices[i] = i;
 	}
 
+	// Reorder for the post-transform cache, overdraw and vertex fetch, merging duplicate vertices.
+	MeshOptimiser::optimise("Model", vertices, vertexCount, indices, indexCount);
+
 	// Set up the description of the static vertex buffer.
 	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
 	vertexBufferDesc.ByteWidth = sizeof(VertexType)* vertexCount;
@@ -2,6 +2,7 @@
 // 2D quad mesh for post processing, should render a quad to match window size
 
 #include "orthomesh.h"
+#include "MeshOptimiser.h"
 
 // Store geometry dimensions, initialise buffers and loadTexture (null as texture is provided from a rendertarget).
 OrthoMesh::OrthoMesh(ID3D11Device* device, ID3D11DeviceContext* deviceContext, int lwidth, int lheight, int lxPosition, int lyPosition)
@@ -73,6 +74,9 @@ void OrthoMesh::initBuffers(ID3D11Device* device)
 	indices[4] = 3;	// bottom right
 	indices[5] = 2;	// top right
 
+	// Reorder for the post-transform cache, overdraw and vertex fetch, merging duplicate vertices.
+	MeshOptimiser::optimise("OrthoMesh", vertices, vertexCount, indices, indexCount);
+
 	// Set up the description of the vertex buffer.
 	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
 	vertexBufferDesc.ByteWidth = sizeof(VertexType)* vertexCount;
@@ -1,6 +1,7 @@
 // plane mesh
 // Quad mesh made of many quads. Default is 100x100
 #include "planemesh.h"
+#include "MeshOptimiser.h"
 
 // Initialise buffer and load texture.
 PlaneMesh::PlaneMesh(ID3D11Device* device, ID3D11DeviceContext* deviceContext, int lresolution)
@@ -115,6 +116,9 @@ void PlaneMesh::initBuffers(ID3D11Device* device)
 		v += increment;
 	}
 
+	// Reorder for the post-transform cache, overdraw and vertex fetch, merging duplicate vertices.
+	MeshOptimiser::optimise("PlaneMesh", vertices, vertexCount, indices, indexCount);
+
 	// Set up the description of the static vertex buffer.
 	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
 	vertexBufferDesc.ByteWidth = sizeof(VertexType)* vertexCount;
@@ -128,6 +132,8 @@ void PlaneMesh::initBuffers(ID3D11Device* device)
 	vertexData.SysMemSlicePitch = 0;
 	// Now create the vertex buffer.
 	device->CreateBuffer(&vertexBufferDesc, &vertexData, &vertexBuffer);
+	// The positions and texture coordinates again on their own, for the shadow passes.
+	createPositionStreams(device, vertices, vertexCount);
 	
 	// Set up the description of the static index buffer.
 	indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
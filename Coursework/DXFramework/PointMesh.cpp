@@ -87,7 +87,7 @@ void PointMesh::initBuffers(ID3D11Device* device)
 
 // Override sendData()
 // Change in primitive topology (pointlist instead of trianglelist) for geometry shader use.
-void PointMesh::sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top)
+unsigned int PointMesh::sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top)
 {
 	unsigned int stride;
 	unsigned int offset;
@@ -99,5 +99,7 @@ void PointMesh::sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOL
 	deviceContext->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
 	deviceContext->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
 	deviceContext->IASetPrimitiveTopology(top);
+
+	return stride;
 }
 
@@ -19,7 +19,7 @@ public:
 	~PointMesh();
 
 	//void sendData(ID3D11DeviceContext*);
-	void sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top = D3D11_PRIMITIVE_TOPOLOGY_POINTLIST) override;
+	unsigned int sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top = D3D11_PRIMITIVE_TOPOLOGY_POINTLIST) override;
 
 protected:
 	void initBuffers(ID3D11Device* device);
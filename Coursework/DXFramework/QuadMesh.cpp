@@ -1,6 +1,7 @@
 // Quad Mesh
 // Simple unit quad mesh with texture coordinates and normals.
 #include "quadmesh.h"
+#include "MeshOptimiser.h"
 
 // Initialise buffers and lad texture.
 QuadMesh::QuadMesh(ID3D11Device* device, ID3D11DeviceContext* deviceContext)
@@ -57,6 +58,9 @@ void QuadMesh::initBuffers(ID3D11Device* device)
 	indices[4] = 3;	// bottom right
 	indices[5] = 2;	// top right
 
+	// Reorder for the post-transform cache, overdraw and vertex fetch, merging duplicate vertices.
+	MeshOptimiser::optimise("QuadMesh", vertices, vertexCount, indices, indexCount);
+
 	// Set up the description of the static vertex buffer.
 	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
 	vertexBufferDesc.ByteWidth = sizeof(VertexType)* vertexCount;
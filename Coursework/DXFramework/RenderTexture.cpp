@@ -3,7 +3,7 @@
 #include "rendertexture.h"
 
 // Initialise texture object based on provided dimensions. Usually to match window.
-RenderTexture::RenderTexture(ID3D11Device* device, int ltextureWidth, int ltextureHeight, float screenNear, float screenFar)
+RenderTexture::RenderTexture(ID3D11Device* device, int ltextureWidth, int ltextureHeight, float screenNear, float screenFar, DXGI_FORMAT format)
 {
 	D3D11_TEXTURE2D_DESC textureDesc;
 	HRESULT result;
@@ -22,7 +22,7 @@ RenderTexture::RenderTexture(ID3D11Device* device, int ltextureWidth, int ltextu
 	textureDesc.Height = textureHeight;
 	textureDesc.MipLevels = 1;
 	textureDesc.ArraySize = 1;
-	textureDesc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+	textureDesc.Format = format;
 	textureDesc.SampleDesc.Count = 1;
 	textureDesc.Usage = D3D11_USAGE_DEFAULT;
 	textureDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
@@ -149,6 +149,16 @@ ID3D11ShaderResourceView* RenderTexture::getShaderResourceView()
 	return shaderResourceView;
 }
 
+ID3D11RenderTargetView* RenderTexture::getRenderTargetView()
+{
+	return renderTargetView;
+}
+
+ID3D11DepthStencilView* RenderTexture::getDepthStencilView()
+{
+	return depthStencilView;
+}
+
 XMMATRIX RenderTexture::getProjectionMatrix()
 {
 	return projectionMatrix;
@@ -1,6 +1,7 @@
 // Sphere Mesh
 // Generates a cube sphere.
 #include "spheremesh.h"
+#include "MeshOptimiser.h"
 
 // Store shape resolution (default is 20), initialise buffers and load texture.
 SphereMesh::SphereMesh(ID3D11Device* device, ID3D11DeviceContext* deviceContext, int lresolution)
@@ -535,6 +536,9 @@ void SphereMesh::initBuffers(ID3D11Device* device)
 		vertices[counter].normal.z = dz;
 	}
 
+	// Reorder for the post-transform cache, overdraw and vertex fetch, merging duplicate vertices.
+	MeshOptimiser::optimise("SphereMesh", vertices, vertexCount, indices, indexCount);
+
 	// Set up the description of the static vertex buffer.
 	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
 	vertexBufferDesc.ByteWidth = sizeof(VertexType)* vertexCount;
@@ -548,6 +552,8 @@ void SphereMesh::initBuffers(ID3D11Device* device)
 	vertexData.SysMemSlicePitch = 0;
 	// Now create the vertex buffer.
 	device->CreateBuffer(&vertexBufferDesc, &vertexData, &vertexBuffer);
+	// The positions and texture coordinates again on their own, for the shadow passes.
+	createPositionStreams(device, vertices, vertexCount);
 
 	// Set up the description of the static index buffer.
 	indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
@@ -84,7 +84,7 @@ void TessellationMesh::initBuffers(ID3D11Device* device)
 }
 
 // Override sendData() to change topology type. Control point patch list is required for tessellation.
-void TessellationMesh::sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top)
+unsigned int TessellationMesh::sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top)
 {
 	unsigned int stride;
 	unsigned int offset;
@@ -96,5 +96,7 @@ void TessellationMesh::sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIV
 	deviceContext->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
 	// Set the type of primitive that should be rendered from this vertex buffer, in this case control patch for tessellation.
 	deviceContext->IASetPrimitiveTopology(top);
+
+	return stride;
 }
 
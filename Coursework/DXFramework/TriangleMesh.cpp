@@ -1,6 +1,7 @@
 // TriangleMesh.cpp
 // Simple triangle mesh for example purposes. With texture cooridnates and normals.
 #include "TriangleMesh.h"
+#include "MeshOptimiser.h"
 
 // Initialise buffers and load texture.
 TriangleMesh::TriangleMesh(ID3D11Device* device, ID3D11DeviceContext* deviceContext)
@@ -56,6 +57,9 @@ void TriangleMesh::initBuffers(ID3D11Device* device)
 	vertexBufferDesc = { sizeof(VertexType) * vertexCount, D3D11_USAGE_DEFAULT, D3D11_BIND_VERTEX_BUFFER, 0, 0, 0 };
 	vertexData = {vertices, 0 , 0};
 
+	// Reorder for the post-transform cache, overdraw and vertex fetch, merging duplicate vertices.
+	MeshOptimiser::optimise("TriangleMesh", vertices, vertexCount, indices, indexCount);
+
 	// Set up the description of the static vertex buffer.
 	//vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
 	//vertexBufferDesc.ByteWidth = sizeof(VertexType)* vertexCount;
@@ -0,0 +1,52 @@
+/**
+* \class Vertex Formats
+*
+* \brief The vertex layouts of the meshes, outside BaseMesh so the code that builds and rewrites vertices on the CPU needs only DirectXMath.
+*
+* BaseMesh names each of them as its own nested type, BaseMesh::VertexType and the rest, which is how the meshes and shaders use them.
+*/
+
+#pragma once
+
+#include <DirectXMath.h>
+
+namespace VertexFormats
+{
+	/// Default struct for general vertex data include position, texture coordinates and normals
+	struct VertexType
+	{
+		DirectX::XMFLOAT3 position;
+		DirectX::XMFLOAT2 texture;
+		DirectX::XMFLOAT3 normal;
+	};
+
+	/// Default vertex struct for geometry with only position and colour
+	struct VertexType_Colour
+	{
+		DirectX::XMFLOAT3 position;
+		DirectX::XMFLOAT4 colour;
+	};
+
+	/// Default vertex struct for geometry with only position and texture coordinates.
+	struct VertexType_Texture
+	{
+		DirectX::XMFLOAT3 position;
+		DirectX::XMFLOAT2 texture;
+	};
+
+	/// Packed vertex of 16 bytes, positions as 16 bit unorms over the mesh's bounds, half float texture coordinates and 16:16 octahedral normals. See VertexPacker.
+	struct VertexType_Packed
+	{
+		unsigned short position[4];	///< w is unused, always 0
+		unsigned short texture[2];
+		short normal[2];
+	};
+
+	/// Packed vertex of 12 bytes, as VertexType_Packed with an 8:8 octahedral normal where the position's w would be
+	struct VertexType_PackedCompact
+	{
+		unsigned short position[3];
+		signed char normal[2];
+		unsigned short texture[2];
+	};
+}
\ No newline at end of file
@@ -0,0 +1,336 @@
+// Vertex packer
+// Quantises positions, normals and texture coordinates into the packed vertex formats, and measures the error and bytes saved.
+#include "VertexPacker.h"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+static unsigned short quantiseUnorm16(float value)
+{
+	value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+	return (unsigned short)(value * 65535.0f + 0.5f);
+}
+
+static int quantiseSnorm(float value, int maximum)
+{
+	value = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+	return (int)floorf(value * (float)maximum + 0.5f);
+}
+
+// As the GPU reads SNORM formats, the most negative value is clamped to -1.
+static float dequantiseSnorm(int value, int maximum)
+{
+	float result = (float)value / (float)maximum;
+	return result < -1.0f ? -1.0f : result;
+}
+
+// Rounding each component separately can land a cell away from the closest direction, so every corner of the cell is tried.
+static void quantiseNormal(const XMFLOAT3& normal, int maximum, int& x, int& y)
+{
+	XMFLOAT2 encoded = VertexPacker::encodeOctahedral(normal);
+	XMVECTOR target = XMVector3Normalize(XMLoadFloat3(&normal));
+
+	int baseX = (int)floorf(encoded.x * (float)maximum);
+	int baseY = (int)floorf(encoded.y * (float)maximum);
+	float bestDot = -2.0f;
+	x = quantiseSnorm(encoded.x, maximum);
+	y = quantiseSnorm(encoded.y, maximum);
+
+	for (int corner = 0; corner < 4; corner++)
+	{
+		int cornerX = baseX + (corner & 1);
+		int cornerY = baseY + (corner >> 1);
+
+		if (cornerX < -maximum || cornerX > maximum || cornerY < -maximum || cornerY > maximum)
+		{
+			continue;
+		}
+
+		XMFLOAT3 decoded = VertexPacker::decodeOctahedral(XMFLOAT2(dequantiseSnorm(cornerX, maximum), dequantiseSnorm(cornerY, maximum)));
+		float dot = XMVectorGetX(XMVector3Dot(target, XMLoadFloat3(&decoded)));
+
+		if (dot > bestDot)
+		{
+			bestDot = dot;
+			x = cornerX;
+			y = cornerY;
+		}
+	}
+}
+
+static void encodePosition(const XMFLOAT3& position, const VertexPacker::Bounds& bounds, unsigned short* output)
+{
+	float scale = 1.0f / bounds.size;
+	output[0] = quantiseUnorm16((position.x - bounds.minimum.x) * scale);
+	output[1] = quantiseUnorm16((position.y - bounds.minimum.y) * scale);
+	output[2] = quantiseUnorm16((position.z - bounds.minimum.z) * scale);
+}
+
+static XMFLOAT3 decodePosition(const unsigned short* position, const VertexPacker::Bounds& bounds)
+{
+	float scale = bounds.size / 65535.0f;
+	return XMFLOAT3(bounds.minimum.x + (float)position[0] * scale, bounds.minimum.y + (float)position[1] * scale, bounds.minimum.z + (float)position[2] * scale);
+}
+
+VertexPacker::Bounds VertexPacker::getBounds(const VertexFormats::VertexType* vertices, int count)
+{
+	Bounds bounds = { XMFLOAT3(0.0f, 0.0f, 0.0f), 1.0f };
+
+	if (count <= 0)
+	{
+		return bounds;
+	}
+
+	XMVECTOR minimum = XMLoadFloat3(&vertices[0].position);
+	XMVECTOR maximum = minimum;
+
+	for (int i = 1; i < count; i++)
+	{
+		XMVECTOR position = XMLoadFloat3(&vertices[i].position);
+		minimum = XMVectorMin(minimum, position);
+		maximum = XMVectorMax(maximum, position);
+	}
+
+	// One size for every axis, so decoding is a uniform scale that leaves normals alone
+	XMFLOAT3 extent;
+	XMStoreFloat3(&bounds.minimum, minimum);
+	XMStoreFloat3(&extent, XMVectorSubtract(maximum, minimum));
+	bounds.size = extent.x > extent.y ? extent.x : extent.y;
+	bounds.size = bounds.size > extent.z ? bounds.size : extent.z;
+
+	if (bounds.size <= 0.0f)
+	{
+		bounds.size = 1.0f;
+	}
+
+	return bounds;
+}
+
+void VertexPacker::encode(const VertexFormats::VertexType* vertices, int count, const Bounds& bounds, VertexFormats::VertexType_Packed* output)
+{
+	for (int i = 0; i < count; i++)
+	{
+		int x, y;
+		encodePosition(vertices[i].position, bounds, output[i].position);
+		output[i].position[3] = 0;
+		output[i].texture[0] = floatToHalf(vertices[i].texture.x);
+		output[i].texture[1] = floatToHalf(vertices[i].texture.y);
+		quantiseNormal(vertices[i].normal, 32767, x, y);
+		output[i].normal[0] = (short)x;
+		output[i].normal[1] = (short)y;
+	}
+}
+
+void VertexPacker::encode(const VertexFormats::VertexType* vertices, int count, const Bounds& bounds, VertexFormats::VertexType_PackedCompact* output)
+{
+	for (int i = 0; i < count; i++)
+	{
+		int x, y;
+		encodePosition(vertices[i].position, bounds, output[i].position);
+		quantiseNormal(vertices[i].normal, 127, x, y);
+		output[i].normal[0] = (signed char)x;
+		output[i].normal[1] = (signed char)y;
+		output[i].texture[0] = floatToHalf(vertices[i].texture.x);
+		output[i].texture[1] = floatToHalf(vertices[i].texture.y);
+	}
+}
+
+void VertexPacker::decode(const VertexFormats::VertexType_Packed* vertices, int count, const Bounds& bounds, VertexFormats::VertexType* output)
+{
+	for (int i = 0; i < count; i++)
+	{
+		output[i].position = decodePosition(vertices[i].position, bounds);
+		output[i].texture = XMFLOAT2(halfToFloat(vertices[i].texture[0]), halfToFloat(vertices[i].texture[1]));
+		output[i].normal = decodeOctahedral(XMFLOAT2(dequantiseSnorm(vertices[i].normal[0], 32767), dequantiseSnorm(vertices[i].normal[1], 32767)));
+	}
+}
+
+void VertexPacker::decode(const VertexFormats::VertexType_PackedCompact* vertices, int count, const Bounds& bounds, VertexFormats::VertexType* output)
+{
+	for (int i = 0; i < count; i++)
+	{
+		output[i].position = decodePosition(vertices[i].position, bounds);
+		output[i].texture = XMFLOAT2(halfToFloat(vertices[i].texture[0]), halfToFloat(vertices[i].texture[1]));
+		output[i].normal = decodeOctahedral(XMFLOAT2(dequantiseSnorm(vertices[i].normal[0], 127), dequantiseSnorm(vertices[i].normal[1], 127)));
+	}
+}
+
+VertexPacker::Error VertexPacker::measureError(const VertexFormats::VertexType* vertices, const VertexFormats::VertexType* decoded, int count, const Bounds& bounds)
+{
+	Error error = { 0.0f, 0.5f * sqrtf(3.0f) * bounds.size / 65535.0f, 0.0f, 0.0f };
+	float smallestDot = 1.0f;
+
+	for (int i = 0; i < count; i++)
+	{
+		float position = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&vertices[i].position), XMLoadFloat3(&decoded[i].position))));
+		error.position = position > error.position ? position : error.position;
+
+		float texture = fabsf(vertices[i].texture.x - decoded[i].texture.x);
+		texture = texture > fabsf(vertices[i].texture.y - decoded[i].texture.y) ? texture : fabsf(vertices[i].texture.y - decoded[i].texture.y);
+		error.texture = texture > error.texture ? texture : error.texture;
+
+		// Normals of zero length have no direction to keep
+		XMVECTOR normal = XMLoadFloat3(&vertices[i].normal);
+
+		if (XMVectorGetX(XMVector3LengthSq(normal)) > 0.0f)
+		{
+			float dot = XMVectorGetX(XMVector3Dot(XMVector3Normalize(normal), XMVector3Normalize(XMLoadFloat3(&decoded[i].normal))));
+			smallestDot = dot < smallestDot ? dot : smallestDot;
+		}
+	}
+
+	smallestDot = smallestDot < -1.0f ? -1.0f : smallestDot;
+	error.normalDegrees = XMConvertToDegrees(acosf(smallestDot));
+	return error;
+}
+
+VertexPacker::Report VertexPacker::measure(const std::string& name, const VertexFormats::VertexType* vertices, int count)
+{
+	Report report;
+	report.name = name;
+	report.vertices = count;
+	report.floatBytes = count * (int)sizeof(VertexFormats::VertexType);
+	report.packedBytes = count * (int)sizeof(VertexFormats::VertexType_Packed);
+	report.compactBytes = count * (int)sizeof(VertexFormats::VertexType_PackedCompact);
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	Bounds bounds = getBounds(vertices, count);
+	std::vector<VertexFormats::VertexType_Packed> packed(count);
+	std::vector<VertexFormats::VertexType_PackedCompact> compact(count);
+	std::vector<VertexFormats::VertexType> packedDecoded(count);
+	std::vector<VertexFormats::VertexType> compactDecoded(count);
+	encode(vertices, count, bounds, packed.data());
+	encode(vertices, count, bounds, compact.data());
+	decode(packed.data(), count, bounds, packedDecoded.data());
+	decode(compact.data(), count, bounds, compactDecoded.data());
+
+	report.milliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	report.packedError = measureError(vertices, packedDecoded.data(), count, bounds);
+	report.compactError = measureError(vertices, compactDecoded.data(), count, bounds);
+	return report;
+}
+
+unsigned int VertexPacker::getStride(bool compactNormals)
+{
+	return compactNormals ? sizeof(VertexFormats::VertexType_PackedCompact) : sizeof(VertexFormats::VertexType_Packed);
+}
+
+unsigned short VertexPacker::floatToHalf(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	uint32_t sign = (bits >> 16) & 0x8000;
+	uint32_t magnitude = bits & 0x7FFFFFFF;
+
+	// NaN stays NaN, anything at or past the largest half rounds to infinity
+	if (magnitude > 0x7F800000)
+	{
+		return (unsigned short)(sign | 0x7E00);
+	}
+
+	if (magnitude >= 0x477FF000)
+	{
+		return (unsigned short)(sign | 0x7C00);
+	}
+
+	int exponent = (int)(magnitude >> 23) - 127 + 15;
+	uint32_t mantissa = magnitude & 0x7FFFFF;
+
+	if (exponent <= 0)
+	{
+		// Subnormal halves keep the implicit one among the mantissa bits, anything smaller than half the least of them is zero
+		if (exponent < -10)
+		{
+			return (unsigned short)sign;
+		}
+
+		mantissa |= 0x800000;
+		int shift = 14 - exponent;
+		uint32_t half = mantissa >> shift;
+		uint32_t remainder = mantissa & ((1u << shift) - 1);
+		uint32_t halfway = 1u << (shift - 1);
+
+		if (remainder > halfway || (remainder == halfway && (half & 1)))
+		{
+			half++;
+		}
+
+		return (unsigned short)(sign | half);
+	}
+
+	// Rounding up can carry into the exponent, which is still the right half
+	uint32_t half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+	uint32_t remainder = mantissa & 0x1FFF;
+
+	if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+	{
+		half++;
+	}
+
+	return (unsigned short)(sign | half);
+}
+
+float VertexPacker::halfToFloat(unsigned short value)
+{
+	uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+	uint32_t exponent = (value >> 10) & 0x1F;
+	uint32_t mantissa = value & 0x3FF;
+	uint32_t bits;
+
+	if (exponent == 0)
+	{
+		float result = ldexpf((float)mantissa, -24);
+		return sign ? -result : result;
+	}
+	else if (exponent == 31)
+	{
+		bits = sign | 0x7F800000 | (mantissa << 13);
+	}
+	else
+	{
+		bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+	}
+
+	float result;
+	memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+XMFLOAT2 VertexPacker::encodeOctahedral(const XMFLOAT3& normal)
+{
+	float length = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+
+	if (length <= 0.0f)
+	{
+		return XMFLOAT2(0.0f, 0.0f);
+	}
+
+	float x = normal.x / length;
+	float y = normal.y / length;
+
+	// The lower hemisphere folds over the diagonals onto the square's corners
+	if (normal.z < 0.0f)
+	{
+		float foldedX = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		float foldedY = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+		x = foldedX;
+		y = foldedY;
+	}
+
+	return XMFLOAT2(x, y);
+}
+
+XMFLOAT3 VertexPacker::decodeOctahedral(const XMFLOAT2& encoded)
+{
+	XMFLOAT3 normal(encoded.x, encoded.y, 1.0f - fabsf(encoded.x) - fabsf(encoded.y));
+	float fold = normal.z < 0.0f ? -normal.z : 0.0f;
+	normal.x += normal.x >= 0.0f ? -fold : fold;
+	normal.y += normal.y >= 0.0f ? -fold : fold;
+
+	XMStoreFloat3(&normal, XMVector3Normalize(XMLoadFloat3(&normal)));
+	return normal;
+}
\ No newline at end of file
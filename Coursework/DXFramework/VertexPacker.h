@@ -0,0 +1,63 @@
+/**
+* \class Vertex Packer
+*
+* \brief Encodes VertexType into the packed vertex formats and back, and measures what packing costs and saves.
+*
+* Positions become 16 bit unorms over the cube around the mesh's bounds, so one uniform scale decodes them and the normals keep their
+* directions through it. Normals are octahedral, folded onto two components of 16 or 8 bits, and texture coordinates are half floats.
+* The GPU widens every component back to floats as it fetches them, which BaseShader::loadPackedVertexShader() sets up.
+*/
+
+#pragma once
+
+#include "VertexFormats.h"
+#include <string>
+
+using namespace DirectX;
+
+class VertexPacker
+{
+public:
+	/// Cube the positions are quantised over
+	struct Bounds
+	{
+		XMFLOAT3 minimum;
+		float size;
+	};
+
+	/// Largest differences between vertices and their packed round trip
+	struct Error
+	{
+		float position;				///< In model units
+		float positionBound;		///< Half a quantisation step along every axis, which position stays within
+		float normalDegrees;		///< Angle between normals
+		float texture;				///< In texture coordinates, half floats lose precision as coordinates grow
+	};
+
+	struct Report
+	{
+		std::string name;
+		int vertices;
+		int floatBytes;				///< As VertexType
+		int packedBytes;			///< As VertexType_Packed
+		int compactBytes;			///< As VertexType_PackedCompact
+		Error packedError;
+		Error compactError;
+		float milliseconds;			///< Encoding and decoding both formats
+	};
+
+	static Bounds getBounds(const VertexFormats::VertexType* vertices, int count);
+	static void encode(const VertexFormats::VertexType* vertices, int count, const Bounds& bounds, VertexFormats::VertexType_Packed* output);
+	static void encode(const VertexFormats::VertexType* vertices, int count, const Bounds& bounds, VertexFormats::VertexType_PackedCompact* output);
+	static void decode(const VertexFormats::VertexType_Packed* vertices, int count, const Bounds& bounds, VertexFormats::VertexType* output);
+	static void decode(const VertexFormats::VertexType_PackedCompact* vertices, int count, const Bounds& bounds, VertexFormats::VertexType* output);
+
+	static Error measureError(const VertexFormats::VertexType* vertices, const VertexFormats::VertexType* decoded, int count, const Bounds& bounds);	///< Compares vertices with their decoded round trip
+	static Report measure(const std::string& name, const VertexFormats::VertexType* vertices, int count);	///< Round trips both formats and reports their sizes and errors
+	static unsigned int getStride(bool compactNormals);	///< Bytes per packed vertex
+
+	static unsigned short floatToHalf(float value);		///< Rounds to nearest even, values past a half's range become infinity
+	static float halfToFloat(unsigned short value);
+	static XMFLOAT2 encodeOctahedral(const XMFLOAT3& normal);	///< Folds a unit normal onto the [-1, 1] square
+	static XMFLOAT3 decodeOctahedral(const XMFLOAT2& encoded);	///< Unfolds and normalises, as packed_vertex.hlsli does
+};
\ No newline at end of file
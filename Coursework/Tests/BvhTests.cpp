@@ -0,0 +1,152 @@
+#include "Bvh.h"
+#include "Check.h"
+
+#include <algorithm>
+#include <random>
+
+static Frustum makeFrustum(const XMFLOAT3& eye, const XMFLOAT3& direction, float farPlane)
+{
+	XMMATRIX view = XMMatrixLookToLH(XMLoadFloat3(&eye), XMLoadFloat3(&direction), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+	XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PI / 3.0f, 16.0f / 9.0f, 0.1f, farPlane);
+
+	return Frustum(view * projection);
+}
+
+static std::vector<int> bruteForce(const std::vector<Bvh::Box>& boxes, const Frustum& frustum)
+{
+	std::vector<int> expected;
+
+	for (int i = 0; i < (int)boxes.size(); i++)
+	{
+		if (frustum.boxVisible(boxes[i].minimum, boxes[i].maximum))
+		{
+			expected.push_back(i);
+		}
+	}
+
+	return expected;
+}
+
+static std::vector<Bvh::Box> randomBoxes(int count, std::mt19937& random)
+{
+	std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+	std::uniform_real_distribution<float> size(0.25f, 4.0f);
+	std::vector<Bvh::Box> boxes(count);
+
+	for (Bvh::Box& box : boxes)
+	{
+		XMFLOAT3 centre(position(random), position(random), position(random));
+		XMFLOAT3 half(size(random), size(random), size(random));
+		box = { XMFLOAT3(centre.x - half.x, centre.y - half.y, centre.z - half.z), XMFLOAT3(centre.x + half.x, centre.y + half.y, centre.z + half.z) };
+	}
+
+	return boxes;
+}
+
+//Queries find exactly the objects testing every box finds, from several views and after the boxes move and the tree is refit
+static void testQueryMatchesBruteForce()
+{
+	std::mt19937 random(5);
+	std::vector<Bvh::Box> boxes = randomBoxes(20000, random);
+	Bvh bvh;
+	bvh.build(boxes);
+	CHECK(bvh.getObjectCount() == 20000);
+
+	const XMFLOAT3 views[4][2] = { { XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 1.0f) }, { XMFLOAT3(-250.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 0.0f, 0.0f) },
+		{ XMFLOAT3(0.0f, 300.0f, 0.0f), XMFLOAT3(0.1f, -1.0f, 0.2f) }, { XMFLOAT3(50.0f, 10.0f, -50.0f), XMFLOAT3(-1.0f, 0.3f, 1.0f) } };
+	std::uniform_real_distribution<float> jitter(-3.0f, 3.0f);
+	std::vector<int> visible;
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (const XMFLOAT3* view : views)
+		{
+			Frustum frustum = makeFrustum(view[0], view[1], 250.0f);
+			Bvh::QueryStats stats = bvh.query(frustum, visible);
+			std::sort(visible.begin(), visible.end());
+
+			std::vector<int> expected = bruteForce(boxes, frustum);
+			CHECK(!expected.empty());
+			CHECK(visible == expected);
+			CHECK(stats.visible == (int)expected.size());
+			CHECK(stats.visible + stats.culled == 20000);
+			CHECK(stats.nodesVisited > 0 && stats.nodesVisited <= bvh.getNodeCount());
+		}
+
+		for (int i = 0; i < (int)boxes.size(); i++)
+		{
+			XMFLOAT3 offset(jitter(random), jitter(random), jitter(random));
+			boxes[i].minimum = XMFLOAT3(boxes[i].minimum.x + offset.x, boxes[i].minimum.y + offset.y, boxes[i].minimum.z + offset.z);
+			boxes[i].maximum = XMFLOAT3(boxes[i].maximum.x + offset.x, boxes[i].maximum.y + offset.y, boxes[i].maximum.z + offset.z);
+			bvh.setBox(i, boxes[i]);
+		}
+
+		bvh.refit();
+		CHECK(bvh.getBox(123).minimum.x == boxes[123].minimum.x && bvh.getBox(123).maximum.z == boxes[123].maximum.z);
+	}
+}
+
+//A view that sees everything returns every object once, and one looking away from them all returns none
+static void testEverythingAndNothing()
+{
+	std::mt19937 random(6);
+	std::vector<Bvh::Box> boxes = randomBoxes(1000, random);
+
+	//Squeezed into a small cube well in front of the camera
+	for (Bvh::Box& box : boxes)
+	{
+		box.minimum = XMFLOAT3(box.minimum.x * 0.01f, box.minimum.y * 0.01f, box.minimum.z * 0.01f + 100.0f);
+		box.maximum = XMFLOAT3(box.maximum.x * 0.01f, box.maximum.y * 0.01f, box.maximum.z * 0.01f + 100.0f);
+	}
+
+	Bvh bvh;
+	bvh.build(boxes);
+
+	std::vector<int> visible;
+	bvh.query(makeFrustum(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 1.0f), 500.0f), visible);
+	std::sort(visible.begin(), visible.end());
+	CHECK(visible.size() == 1000);
+	CHECK(std::adjacent_find(visible.begin(), visible.end()) == visible.end());
+
+	Bvh::QueryStats stats = bvh.query(makeFrustum(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, -1.0f), 500.0f), visible);
+	CHECK(visible.empty());
+	CHECK(stats.culled == 1000);
+
+	//An empty tree and one of a single object
+	Bvh empty;
+	empty.build({});
+	CHECK(empty.query(makeFrustum(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 1.0f), 500.0f), visible).visible == 0);
+
+	Bvh single;
+	single.build({ boxes[0] });
+	single.query(makeFrustum(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 1.0f), 500.0f), visible);
+	CHECK(visible == std::vector<int>({ 0 }));
+}
+
+//A transformed box bounds the eight transformed corners, and a quarter turn swaps its extents
+static void testTransformBox()
+{
+	Bvh::Box box = { XMFLOAT3(-1.0f, -2.0f, -3.0f), XMFLOAT3(1.0f, 2.0f, 3.0f) };
+	Bvh::Box turned = Bvh::transformBox(box, XMMatrixRotationY(XM_PIDIV2) * XMMatrixTranslation(10.0f, 0.0f, 0.0f));
+	CHECK_NEAR(turned.minimum.x, 7.0f, 1e-5f);
+	CHECK_NEAR(turned.maximum.x, 13.0f, 1e-5f);
+	CHECK_NEAR(turned.minimum.y, -2.0f, 1e-5f);
+	CHECK_NEAR(turned.minimum.z, -1.0f, 1e-5f);
+	CHECK_NEAR(turned.maximum.z, 1.0f, 1e-5f);
+
+	//An eighth of a turn widens x and z to the corners' reach
+	Bvh::Box cube = { XMFLOAT3(-1.0f, -1.0f, -1.0f), XMFLOAT3(1.0f, 1.0f, 1.0f) };
+	Bvh::Box diagonal = Bvh::transformBox(cube, XMMatrixRotationY(XM_PIDIV4) * XMMatrixScaling(2.0f, 2.0f, 2.0f));
+	CHECK_NEAR(diagonal.maximum.x, 2.0f * sqrtf(2.0f), 1e-5f);
+	CHECK_NEAR(diagonal.minimum.z, -2.0f * sqrtf(2.0f), 1e-5f);
+	CHECK_NEAR(diagonal.maximum.y, 2.0f, 1e-5f);
+}
+
+int main()
+{
+	testQueryMatchesBruteForce();
+	testEverythingAndNothing();
+	testTransformBox();
+
+	return checkResult();
+}
\ No newline at end of file
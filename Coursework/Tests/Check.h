@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+//The checks the headless tests make. A failed check prints where it was and the test carries on, so one run reports every failure.
+//Each test's main() returns checkResult(), which ctest reads as passed when it is zero.
+static int checkFailures = 0;
+
+#define CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			checkFailures++; \
+		} \
+	} while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+	do \
+	{ \
+		double checkActual = (double)(actual); \
+		double checkExpected = (double)(expected); \
+		if (!(std::fabs(checkActual - checkExpected) <= (double)(tolerance))) \
+		{ \
+			std::printf("%s:%d: CHECK_NEAR(%s, %s, %s) failed, %g against %g\n", __FILE__, __LINE__, #actual, #expected, #tolerance, checkActual, checkExpected); \
+			checkFailures++; \
+		} \
+	} while (0)
+
+inline int checkResult()
+{
+	if (checkFailures > 0)
+	{
+		std::printf("%d checks failed\n", checkFailures);
+		return 1;
+	}
+
+	std::printf("All checks passed\n");
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "CommandRecorder.h"
+#include "RecordingContexts.h"
+#include "JobSystem.h"
+#include "Check.h"
+
+#include <thread>
+
+//A pass binding its own shader, then draws of its own index counts, so the stream shows which pass each command came from
+static void recordPass(RecordingContexts::Context* context, unsigned int pass, int draws)
+{
+	float matrix[16] = {};
+	context->setShader(pass);
+
+	for (int draw = 0; draw < draws; draw++)
+	{
+		matrix[0] = (float)draw;
+		context->setVertexBuffers(pass * 1000 + draw, 20);
+		context->setConstants(matrix);
+		context->drawIndexed(3 * (draw + 1));
+	}
+}
+
+//Records five passes of different lengths and returns the stream they executed as
+static std::vector<RecordingContexts::Command> recordFrame(bool multithreaded)
+{
+	RecordingContexts contexts;
+	CommandRecorder recorder(&contexts);
+
+	for (unsigned int pass = 0; pass < 5; pass++)
+	{
+		recorder.addPass([&contexts, pass](int context)
+		{
+			recordPass(contexts.getContext(context), pass, 200 * (5 - pass));
+		});
+	}
+
+	recorder.record(multithreaded);
+	recorder.execute();
+
+	return contexts.getExecuted();
+}
+
+static bool sameCommands(const std::vector<RecordingContexts::Command>& a, const std::vector<RecordingContexts::Command>& b)
+{
+	if (a.size() != b.size())
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		if (a[i].type != b[i].type || a[i].value != b[i].value || a[i].stride != b[i].stride || a[i].constants[0] != b[i].constants[0])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//Passes recorded on worker threads run in the order they were added, the same stream as recording them one after another
+static void testOrder()
+{
+	JobSystem jobs(3);
+	JobSystem::setShared(&jobs);
+
+	std::vector<RecordingContexts::Command> single = recordFrame(false);
+	CHECK(single.size() == 5 + (3 * 200 * 15));
+
+	//Each pass's commands together, the passes in order
+	unsigned int lastShader = 0;
+	bool ordered = true;
+
+	for (const RecordingContexts::Command& command : single)
+	{
+		if (command.type == RecordingContexts::Command::SET_SHADER)
+		{
+			ordered = ordered && (command.value == 0 || command.value == lastShader + 1);
+			lastShader = command.value;
+		}
+
+		else if (command.type == RecordingContexts::Command::SET_VERTEX_BUFFERS)
+		{
+			ordered = ordered && command.value / 1000 == lastShader;
+		}
+	}
+
+	CHECK(ordered);
+	CHECK(lastShader == 4);
+
+	for (int frame = 0; frame < 20; frame++)
+	{
+		CHECK(sameCommands(recordFrame(true), single));
+	}
+
+	JobSystem::setShared(nullptr);
+}
+
+//Contexts are kept for the busiest frame, each pass starts from an empty context, and execute() forgets the passes and their lists
+static void testFrames()
+{
+	RecordingContexts contexts;
+	CommandRecorder recorder(&contexts);
+
+	for (int frame = 0; frame < 3; frame++)
+	{
+		int passes = frame == 1 ? 2 : 4;
+
+		for (int pass = 0; pass < passes; pass++)
+		{
+			recorder.addPass([&contexts, pass](int context)
+			{
+				CHECK(contexts.getContext(context)->getCommandCount() == 0);
+				recordPass(contexts.getContext(context), pass, 10);
+			});
+		}
+
+		CHECK(recorder.getPassCount() == passes);
+		CHECK(contexts.getContextCount() == 4);
+
+		contexts.clearExecuted();
+		recorder.record(false);
+		recorder.execute();
+		CHECK(recorder.getPassCount() == 0);
+		CHECK(contexts.getExecutedDraws() == passes * 10);
+
+		//Nothing left to run twice
+		recorder.execute();
+		CHECK(contexts.getExecutedDraws() == passes * 10);
+	}
+}
+
+//Without a job system every pass is recorded on the calling thread, whether multithreaded or not
+static void testSerialFallback()
+{
+	CHECK(JobSystem::getShared() == nullptr);
+
+	RecordingContexts contexts;
+	CommandRecorder recorder(&contexts);
+	std::thread::id threads[8];
+
+	for (int pass = 0; pass < 8; pass++)
+	{
+		recorder.addPass([&threads, &contexts, pass](int context)
+		{
+			threads[pass] = std::this_thread::get_id();
+			recordPass(contexts.getContext(context), pass, 1);
+		});
+	}
+
+	recorder.record(true);
+	recorder.execute();
+
+	for (std::thread::id thread : threads)
+	{
+		CHECK(thread == std::this_thread::get_id());
+	}
+
+	CHECK(contexts.getExecutedDraws() == 8);
+}
+
+int main()
+{
+	testOrder();
+	testFrames();
+	testSerialFallback();
+
+	return checkResult();
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "DepthSort.h"
+#include "Check.h"
+
+#include <algorithm>
+#include <random>
+
+static bool isPermutation(const std::vector<uint32_t>& order, int count)
+{
+	std::vector<uint32_t> sorted = order;
+	std::sort(sorted.begin(), sorted.end());
+
+	bool valid = (int)sorted.size() == count;
+
+	for (int i = 0; i < (int)sorted.size() && valid; i++)
+	{
+		valid = sorted[i] == (uint32_t)i;
+	}
+
+	return valid;
+}
+
+//Random depths come out farthest first, or nearest first, to within one quantisation step
+static void testDepthOrder()
+{
+	std::mt19937 random(3);
+	std::uniform_real_distribution<float> distribution(-20.0f, 180.0f);
+
+	const int count = 50000;
+	std::vector<float> depths(count);
+
+	for (float& depth : depths)
+	{
+		depth = distribution(random);
+	}
+
+	float nearest = *std::min_element(depths.begin(), depths.end());
+	float farthest = *std::max_element(depths.begin(), depths.end());
+	float step = (farthest - nearest) / 65535.0f;
+
+	DepthSort depthSort;
+	depthSort.sort(depths.data(), count, true);
+	CHECK(isPermutation(depthSort.getOrder(), count));
+
+	bool backToFront = true;
+
+	for (int i = 1; i < count; i++)
+	{
+		backToFront = backToFront && depths[depthSort.getOrder()[i]] <= depths[depthSort.getOrder()[i - 1]] + step;
+	}
+
+	CHECK(backToFront);
+	CHECK(depths[depthSort.getOrder()[0]] >= farthest - step);
+
+	depthSort.sort(depths.data(), count, false);
+	CHECK(isPermutation(depthSort.getOrder(), count));
+
+	bool frontToBack = true;
+
+	for (int i = 1; i < count; i++)
+	{
+		frontToBack = frontToBack && depths[depthSort.getOrder()[i]] >= depths[depthSort.getOrder()[i - 1]] - step;
+	}
+
+	CHECK(frontToBack);
+	CHECK(depths[depthSort.getOrder()[0]] <= nearest + step);
+}
+
+//The radix sort gives exactly std::stable_sort's order, so equal keys keep the order they were given in
+static void testMatchesStableSort()
+{
+	std::mt19937 random(5);
+
+	for (int count : { 1, 2, 255, 256, 257, 100000 })
+	{
+		//Few distinct keys, so most items share a key with others
+		std::uniform_int_distribution<int> distribution(0, count < 64 ? 3 : count / 16);
+		std::vector<uint16_t> keys(count);
+
+		for (uint16_t& key : keys)
+		{
+			key = (uint16_t)(distribution(random) * 37);
+		}
+
+		std::vector<uint32_t> expected(count);
+
+		for (int i = 0; i < count; i++)
+		{
+			expected[i] = i;
+		}
+
+		std::stable_sort(expected.begin(), expected.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+		DepthSort depthSort;
+		depthSort.sortKeys(keys.data(), count);
+		CHECK(depthSort.getOrder() == expected);
+	}
+}
+
+//Nothing to sort, and items all at one depth, which stay in the order given
+static void testDegenerate()
+{
+	DepthSort depthSort;
+	depthSort.sort(nullptr, 0);
+	CHECK(depthSort.getOrder().empty());
+
+	std::vector<float> depths(1000, 12.5f);
+	depthSort.sort(depths.data(), (int)depths.size());
+
+	bool identity = (int)depthSort.getOrder().size() == 1000;
+
+	for (int i = 0; i < (int)depthSort.getOrder().size(); i++)
+	{
+		identity = identity && depthSort.getOrder()[i] == (uint32_t)i;
+	}
+
+	CHECK(identity);
+}
+
+int main()
+{
+	testDepthOrder();
+	testMatchesStableSort();
+	testDegenerate();
+
+	return checkResult();
+}
\ No newline at end of file
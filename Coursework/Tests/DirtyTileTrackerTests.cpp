@@ -0,0 +1,144 @@
+#include "DirtyTileTracker.h"
+#include "Check.h"
+
+#include <algorithm>
+
+//Exactly the tiles a rectangle touches are marked, once each however often they are marked
+static void testMarking()
+{
+	DirtyTileTracker tracker;
+	tracker.resize(256, 256, 64);
+	CHECK(tracker.getTileCount() == 16);
+	CHECK(!tracker.hasDirtyTiles());
+
+	//Texels 63 and 64 sit either side of a tile edge
+	tracker.markDirty(63, 10, 64, 10);
+
+	std::vector<int> tiles;
+	tracker.getDirtyTiles(tiles);
+	CHECK(tiles == std::vector<int>({ 0, 1 }));
+
+	tracker.markDirty(0, 0, 10, 10);
+	tracker.markDirty(130, 130, 200, 140);
+	tracker.getDirtyTiles(tiles);
+	CHECK(tiles == std::vector<int>({ 0, 1, 10, 11 }));
+	CHECK(tracker.getDirtyCount() == 4);
+
+	int x0, y0, x1, y1;
+	CHECK(tracker.getDirtyBounds(x0, y0, x1, y1));
+	CHECK(x0 == 0 && y0 == 0 && x1 == 200 && y1 == 140);
+
+	tracker.clear();
+	CHECK(!tracker.hasDirtyTiles());
+	CHECK(!tracker.getDirtyBounds(x0, y0, x1, y1));
+	tracker.getDirtyTiles(tiles);
+	CHECK(tiles.empty());
+}
+
+//Rectangles are clamped to the heightmap, and ones wholly outside it or inside out mark nothing
+static void testClamping()
+{
+	DirtyTileTracker tracker;
+	tracker.resize(100, 100, 32);
+
+	tracker.markDirty(-50, -50, -1, 20);
+	tracker.markDirty(100, 0, 150, 50);
+	tracker.markDirty(40, 40, 30, 50);
+	CHECK(!tracker.hasDirtyTiles());
+
+	tracker.markDirty(90, 90, 500, 500);
+
+	std::vector<int> tiles;
+	tracker.getDirtyTiles(tiles);
+	CHECK(tiles == std::vector<int>({ 10, 11, 14, 15 }));
+
+	int x0, y0, x1, y1;
+	tracker.getDirtyBounds(x0, y0, x1, y1);
+	CHECK(x0 == 90 && y0 == 90 && x1 == 99 && y1 == 99);
+}
+
+//Tiles cover the heightmap without gaps or overlaps, the last row and column cut short where the size doesn't divide it
+static void testTileRects()
+{
+	DirtyTileTracker tracker;
+	tracker.resize(100, 70, 32);
+	CHECK(tracker.getTileCount() == 4 * 3);
+
+	std::vector<int> coverage(100 * 70, 0);
+
+	for (int tile = 0; tile < tracker.getTileCount(); tile++)
+	{
+		int x0, y0, x1, y1;
+		tracker.getTileRect(tile, x0, y0, x1, y1);
+
+		for (int y = y0; y < y1; y++)
+		{
+			for (int x = x0; x < x1; x++)
+			{
+				coverage[(y * 100) + x]++;
+			}
+		}
+	}
+
+	CHECK(std::all_of(coverage.begin(), coverage.end(), [](int count) { return count == 1; }));
+
+	int x0, y0, x1, y1;
+	tracker.getTileRect(11, x0, y0, x1, y1);
+	CHECK(x0 == 96 && y0 == 64 && x1 == 100 && y1 == 70);
+}
+
+//Every texel of a marked rectangle lies in a dirty tile, for random brush sized rectangles
+static void testRandomRects()
+{
+	DirtyTileTracker tracker;
+	tracker.resize(512, 512, 64);
+
+	unsigned int seed = 99;
+	auto random = [&seed](int range) { seed = (seed * 1664525u) + 1013904223u; return (int)((seed >> 8) % (unsigned int)range); };
+
+	bool covered = true;
+	bool tight = true;
+
+	for (int i = 0; i < 200; i++)
+	{
+		int x0 = random(560) - 24;
+		int y0 = random(560) - 24;
+		int x1 = x0 + random(80);
+		int y1 = y0 + random(80);
+
+		tracker.clear();
+		tracker.markDirty(x0, y0, x1, y1);
+
+		std::vector<int> tiles;
+		tracker.getDirtyTiles(tiles);
+
+		for (int y = std::max(y0, 0); y <= std::min(y1, 511); y++)
+		{
+			for (int x = std::max(x0, 0); x <= std::min(x1, 511); x++)
+			{
+				covered = covered && tracker.isDirty(((y / 64) * 8) + (x / 64));
+			}
+		}
+
+		//No tile is marked that the rectangle doesn't reach
+		for (int tile : tiles)
+		{
+			int tx0, ty0, tx1, ty1;
+			tracker.getTileRect(tile, tx0, ty0, tx1, ty1);
+			tight = tight && tx0 <= x1 && tx1 > x0 && ty0 <= y1 && ty1 > y0;
+		}
+	}
+
+	CHECK(covered);
+	CHECK(tight);
+}
+
+int main()
+{
+	testMarking();
+	testClamping();
+	testTileRects();
+	testRandomRects();
+
+	return checkResult();
+}
\ No newline at end of file
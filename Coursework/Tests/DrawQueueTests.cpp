@@ -0,0 +1,181 @@
+#include "DrawQueue.h"
+#include "Check.h"
+
+#include <algorithm>
+#include <random>
+
+//Every field comes back out of the key, cut to its bits, and the fields order the keys from the pass down to the depth
+static void testKeys()
+{
+	uint64_t key = DrawQueue::makeKey(3, 700, 513, 200, 12.5f);
+	CHECK(DrawQueue::getPass(key) == 3);
+	CHECK(DrawQueue::getShader(key) == 700);
+	CHECK(DrawQueue::getMaterial(key) == 513);
+	CHECK(DrawQueue::getMesh(key) == 200);
+
+	uint64_t cut = DrawQueue::makeKey(17, 1025, 1024 + 9, 257, 1.0f);
+	CHECK(DrawQueue::getPass(cut) == 1);
+	CHECK(DrawQueue::getShader(cut) == 1);
+	CHECK(DrawQueue::getMaterial(cut) == 9);
+	CHECK(DrawQueue::getMesh(cut) == 1);
+
+	//Higher fields outweigh everything below them
+	CHECK(DrawQueue::makeKey(0, 1023, 1023, 255, 1000.0f) < DrawQueue::makeKey(1, 0, 0, 0, 0.0f));
+	CHECK(DrawQueue::makeKey(0, 1, 1023, 255, 1000.0f) < DrawQueue::makeKey(0, 2, 0, 0, 0.0f));
+	CHECK(DrawQueue::makeKey(0, 1, 1, 255, 1000.0f) < DrawQueue::makeKey(0, 1, 2, 0, 0.0f));
+	CHECK(DrawQueue::makeKey(0, 1, 1, 1, 1000.0f) < DrawQueue::makeKey(0, 1, 1, 2, 0.0f));
+
+	//Near first, or far first for blended draws, and behind the camera sorts with zero
+	CHECK(DrawQueue::makeKey(0, 0, 0, 0, 1.0f) < DrawQueue::makeKey(0, 0, 0, 0, 1.5f));
+	CHECK(DrawQueue::makeKey(0, 0, 0, 0, 0.001f) < DrawQueue::makeKey(0, 0, 0, 0, 900.0f));
+	CHECK(DrawQueue::makeKey(0, 0, 0, 0, 1.0f, true) > DrawQueue::makeKey(0, 0, 0, 0, 1.5f, true));
+	CHECK(DrawQueue::makeKey(0, 0, 0, 0, -5.0f) == DrawQueue::makeKey(0, 0, 0, 0, 0.0f));
+}
+
+//The radix sort gives the order of a stable sort by key, whether the keys share bytes or not and whatever the number of passes
+static void testRadixSort()
+{
+	std::mt19937 random(7);
+	std::vector<DrawQueue::Packet> packets, scratch;
+
+	for (int variant = 0; variant < 4; variant++)
+	{
+		packets.clear();
+
+		for (unsigned int i = 0; i < 20000; i++)
+		{
+			uint64_t key = ((uint64_t)random() << 32) | random();
+
+			//Few distinct keys, so equal keys test stability, or only the mesh varying, or only the depth's low byte
+			key = variant == 1 ? key & 0x0000000F00000000ull : key;
+			key = variant == 2 ? DrawQueue::makeKey(1, 2, 3, (unsigned int)(key & 0xff), 7.0f) : key;
+			key = variant == 3 ? 0x1234567800000000ull | (key & 0xff) : key;
+			packets.push_back({ key, i });
+		}
+
+		std::vector<DrawQueue::Packet> expected = packets;
+		std::stable_sort(expected.begin(), expected.end(), [](const DrawQueue::Packet& a, const DrawQueue::Packet& b) { return a.key < b.key; });
+		DrawQueue::radixSort(packets, scratch);
+
+		bool same = packets.size() == expected.size();
+
+		for (size_t i = 0; same && i < packets.size(); i++)
+		{
+			same = packets[i].key == expected[i].key && packets[i].payload == expected[i].payload;
+		}
+
+		CHECK(same);
+	}
+
+	//Nothing to sort
+	packets.clear();
+	DrawQueue::radixSort(packets, scratch);
+	CHECK(packets.empty());
+	packets.push_back({ 5, 9 });
+	DrawQueue::radixSort(packets, scratch);
+	CHECK(packets.size() == 1 && packets[0].payload == 9);
+}
+
+//A new shader forgets the bound material, rebinding what is bound is skipped, and invalidating forgets everything
+static void testStateCache()
+{
+	StateCache state;
+	CHECK(state.setShader(1));
+	CHECK(state.setMaterial(4));
+	CHECK(state.setMesh(2));
+	CHECK(!state.setShader(1));
+	CHECK(!state.setMaterial(4));
+	CHECK(!state.setMesh(2));
+	CHECK(state.setShader(3));
+	CHECK(state.setMaterial(4));
+	CHECK(!state.setMesh(2));
+	state.countDraw();
+
+	const StateCache::Counters& counters = state.getCounters();
+	CHECK(counters.shaderBinds == 2 && counters.materialBinds == 2 && counters.meshBinds == 1);
+	CHECK(counters.skippedBinds == 4);
+	CHECK(counters.draws == 1);
+	CHECK(state.getBinds() == 5);
+
+	state.invalidate();
+	CHECK(state.setShader(3) && state.setMaterial(4) && state.setMesh(2));
+
+	state.resetCounters();
+	CHECK(state.getBinds() == 0 && state.getCounters().skippedBinds == 0 && state.getCounters().draws == 0);
+}
+
+//Two shaders, three materials each and four meshes, five draws of every combination submitted shuffled. Sorted, each shader, material
+//and mesh is bound once for each run of it, and execute() tells the draw exactly the binds the cache counted.
+static void testExecuteCounters()
+{
+	std::vector<uint64_t> keys;
+
+	for (unsigned int shader = 0; shader < 2; shader++)
+	{
+		for (unsigned int material = 0; material < 3; material++)
+		{
+			for (unsigned int mesh = 0; mesh < 4; mesh++)
+			{
+				for (int draw = 0; draw < 5; draw++)
+				{
+					keys.push_back(DrawQueue::makeKey(0, shader, material, mesh, (float)(draw + 1)));
+				}
+			}
+		}
+	}
+
+	std::mt19937 random(8);
+	std::shuffle(keys.begin(), keys.end(), random);
+
+	DrawQueue queue;
+
+	for (unsigned int i = 0; i < (unsigned int)keys.size(); i++)
+	{
+		queue.submit(keys[i], i);
+	}
+
+	StateCache state;
+	int reported[3] = {};
+	auto countBinds = [&](const DrawQueue::Packet&, unsigned int binds)
+	{
+		reported[0] += (binds & DrawQueue::BIND_SHADER) ? 1 : 0;
+		reported[1] += (binds & DrawQueue::BIND_MATERIAL) ? 1 : 0;
+		reported[2] += (binds & DrawQueue::BIND_MESH) ? 1 : 0;
+	};
+
+	queue.execute(state, countBinds);
+	int unsortedBinds = state.getBinds();
+	CHECK(reported[0] == state.getCounters().shaderBinds && reported[1] == state.getCounters().materialBinds && reported[2] == state.getCounters().meshBinds);
+
+	queue.sort();
+	state.resetCounters();
+	reported[0] = reported[1] = reported[2] = 0;
+	queue.execute(state, countBinds);
+
+	const StateCache::Counters& counters = state.getCounters();
+	CHECK(counters.shaderBinds == 2);
+	CHECK(counters.materialBinds == 6);
+	CHECK(counters.meshBinds == 24);
+	CHECK(counters.draws == 120);
+	CHECK(counters.skippedBinds == (3 * 120) - 32);
+	CHECK(reported[0] == 2 && reported[1] == 6 && reported[2] == 24);
+	CHECK(state.getBinds() < unsortedBinds);
+
+	//In key order, so within each mesh's run the nearest draw comes first
+	const std::vector<DrawQueue::Packet>& packets = queue.getPackets();
+
+	for (int i = 1; i < queue.getPacketCount(); i++)
+	{
+		CHECK(packets[i - 1].key <= packets[i].key);
+	}
+}
+
+int main()
+{
+	testKeys();
+	testRadixSort();
+	testStateCache();
+	testExecuteCounters();
+
+	return checkResult();
+}
\ No newline at end of file
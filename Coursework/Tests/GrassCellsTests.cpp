@@ -0,0 +1,232 @@
+#include "GrassCells.h"
+#include "JobSystem.h"
+#include "Check.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+static const float worldSize = 100.0f;
+
+//Looking straight down from high above the field, so every cell is in view and only the distance thinning removes blades
+static Frustum overheadFrustum()
+{
+	return Frustum(XMMatrixLookAtLH(XMVectorSet(50.0f, 400.0f, 50.0f, 1.0f), XMVectorSet(50.0f, 0.0f, 50.0f, 1.0f), XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f))
+		* XMMatrixPerspectiveFovLH(XM_PIDIV2, 1.0f, 1.0f, 1000.0f));
+}
+
+static GrassCells::CullSettings testSettings(float cameraX, float cameraZ)
+{
+	GrassCells::CullSettings settings;
+	settings.cameraPosition = XMFLOAT3(cameraX, 2.0f, cameraZ);
+	settings.amplitude = 10.0f;
+	settings.fadeStart = 15.0f;
+	settings.fadeEnd = 35.0f;
+	settings.viewDirection = XMFLOAT3(0.0f, 0.0f, 1.0f);
+	settings.backToFront = false;
+
+	return settings;
+}
+
+static std::set<std::pair<float, float>> keptPositions(const std::vector<GrassScatter::Instance>& output, int count)
+{
+	std::set<std::pair<float, float>> kept;
+
+	for (int i = 0; i < count; i++)
+	{
+		kept.insert(std::make_pair(output[i].position.x, output[i].position.z));
+	}
+
+	return kept;
+}
+
+//Every blade lands in the cell under it, with the cells' blades contiguous
+static void testBuild(const GrassCells& cells, const std::vector<GrassScatter::Instance>& field)
+{
+	CHECK(cells.getBladeCount() == (int)field.size());
+	CHECK(cells.getCellCount() == 20 * 20);
+
+	std::multiset<std::pair<float, float>> original, sorted;
+
+	for (int i = 0; i < (int)field.size(); i++)
+	{
+		original.insert(std::make_pair(field[i].position.x, field[i].position.z));
+		sorted.insert(std::make_pair(cells.getInstance(i).position.x, cells.getInstance(i).position.z));
+	}
+
+	CHECK(original == sorted);
+
+	//Sorted by cell, so the cell index never goes down along the list
+	int previousCell = 0;
+	bool ordered = true;
+
+	for (int i = 0; i < cells.getBladeCount(); i++)
+	{
+		int cell = ((int)(cells.getPositionZ()[i] / 5.0f) * 20) + (int)(cells.getPositionX()[i] / 5.0f);
+		ordered = ordered && cell >= previousCell;
+		previousCell = cell;
+	}
+
+	CHECK(ordered);
+}
+
+//Everything closer than the fade start survives, nothing past the fade end does, and in between about the linear fraction is kept
+static void testThinning(GrassCells& cells, const std::vector<GrassScatter::Instance>& field)
+{
+	GrassCells::CullSettings settings = testSettings(50.0f, 50.0f);
+	std::vector<GrassScatter::Instance> output(field.size());
+	int count = cells.cull(settings, overheadFrustum(), output.data(), true, false);
+	std::set<std::pair<float, float>> kept = keptPositions(output, count);
+
+	int inside = 0, insideKept = 0, band = 0, bandKept = 0, outsideKept = 0;
+	float expectedBand = 0.0f;
+
+	for (const GrassScatter::Instance& blade : field)
+	{
+		float distance = sqrtf(((blade.position.x - 50.0f) * (blade.position.x - 50.0f)) + ((blade.position.z - 50.0f) * (blade.position.z - 50.0f)));
+		bool isKept = kept.count(std::make_pair(blade.position.x, blade.position.z)) > 0;
+
+		if (distance < settings.fadeStart)
+		{
+			inside++;
+			insideKept += isKept ? 1 : 0;
+		}
+
+		else if (distance < settings.fadeEnd)
+		{
+			band++;
+			bandKept += isKept ? 1 : 0;
+			expectedBand += (settings.fadeEnd - distance) / (settings.fadeEnd - settings.fadeStart);
+		}
+
+		else
+		{
+			outsideKept += isKept ? 1 : 0;
+		}
+	}
+
+	CHECK(insideKept == inside);
+	CHECK(outsideKept == 0);
+	CHECK_NEAR((float)bandKept / expectedBand, 1.0f, 0.05f);
+	CHECK(cells.getLastStats().visibleBlades == count);
+}
+
+//Scalar, four wide and job system culls keep the same blades in the same order
+static void testPathsMatch(GrassCells& cells, const std::vector<GrassScatter::Instance>& field)
+{
+	Frustum frustum(XMMatrixLookAtLH(XMVectorSet(30.0f, 2.0f, 20.0f, 1.0f), XMVectorSet(60.0f, 0.0f, 70.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f))
+		* XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 200.0f));
+	GrassCells::CullSettings settings = testSettings(30.0f, 20.0f);
+
+	std::vector<GrassScatter::Instance> scalar(field.size()), simd(field.size()), threaded(field.size());
+	int scalarCount = cells.cull(settings, frustum, scalar.data(), false, false);
+	int simdCount = cells.cull(settings, frustum, simd.data(), true, false);
+
+	JobSystem jobs(3);
+	JobSystem::setShared(&jobs);
+	int threadedCount = cells.cull(settings, frustum, threaded.data(), true, true);
+	JobSystem::setShared(nullptr);
+
+	CHECK(scalarCount > 0 && scalarCount < (int)field.size());
+	CHECK(scalarCount == simdCount && scalarCount == threadedCount);
+
+	bool same = true;
+
+	for (int i = 0; i < scalarCount && same; i++)
+	{
+		same = scalar[i].position.x == simd[i].position.x && scalar[i].position.z == simd[i].position.z
+			&& scalar[i].position.x == threaded[i].position.x && scalar[i].position.z == threaded[i].position.z;
+	}
+
+	CHECK(same);
+
+	//The view culls the cells behind the camera, which the overhead view keeps
+	std::vector<GrassScatter::Instance> overhead(field.size());
+	CHECK(cells.cull(settings, overheadFrustum(), overhead.data(), true, false) > scalarCount);
+}
+
+//Backing away only ever removes blades - a blade that faded out at one distance stays out further away, so nothing pops in
+static void testNoPopping(GrassCells& cells, const std::vector<GrassScatter::Instance>& field)
+{
+	std::vector<GrassScatter::Instance> output(field.size());
+	std::set<std::pair<float, float>> previous;
+	bool subset = true;
+
+	for (int step = 0; step < 10; step++)
+	{
+		GrassCells::CullSettings settings = testSettings(50.0f, 50.0f - (2.0f * (float)step));
+		int count = cells.cull(settings, overheadFrustum(), output.data(), true, false);
+		std::set<std::pair<float, float>> kept = keptPositions(output, count);
+
+		//Only blades in front of the camera, which it is moving away from
+		for (const std::pair<float, float>& blade : kept)
+		{
+			if (step > 0 && blade.second > 60.0f && !previous.count(blade))
+			{
+				subset = false;
+			}
+		}
+
+		previous = kept;
+	}
+
+	CHECK(subset);
+}
+
+//Back to front writes farther cells first, and the packed bends given replace the instances' own
+static void testOrderAndBends(GrassCells& cells, const std::vector<GrassScatter::Instance>& field)
+{
+	std::vector<uint32_t> bends(cells.getBladeCount());
+	std::map<std::pair<float, float>, uint32_t> bendOf;
+
+	for (int i = 0; i < cells.getBladeCount(); i++)
+	{
+		bends[i] = 0x10000u + (uint32_t)i;
+		bendOf[std::make_pair(cells.getInstance(i).position.x, cells.getInstance(i).position.z)] = bends[i];
+	}
+
+	GrassCells::CullSettings settings = testSettings(50.0f, 50.0f);
+	settings.backToFront = true;
+
+	std::vector<GrassScatter::Instance> output(field.size());
+	int count = cells.cull(settings, overheadFrustum(), output.data(), true, false, bends.data());
+	CHECK(count > 0);
+
+	bool bendsMatch = true;
+	bool farthestFirst = true;
+	float previousDepth = 1e30f;
+
+	for (int i = 0; i < count; i++)
+	{
+		bendsMatch = bendsMatch && output[i].bend == bendOf[std::make_pair(output[i].position.x, output[i].position.z)];
+
+		//Depth of the blade's cell centre along the view direction, quantised sorting allows a little disorder between equal cells
+		float cellCentreZ = (floorf(output[i].position.z / 5.0f) + 0.5f) * 5.0f;
+		float depth = cellCentreZ - 50.0f;
+		farthestFirst = farthestFirst && depth <= previousDepth + 0.01f;
+		previousDepth = depth;
+	}
+
+	CHECK(bendsMatch);
+	CHECK(farthestFirst);
+}
+
+int main()
+{
+	HeightField heights;
+	heights.generateFractal(256);
+
+	std::vector<GrassScatter::Instance> field;
+	GrassScatter::scatterJittered(heights, worldSize, 0.5f, 1, field, false);
+
+	GrassCells cells;
+	cells.build(field, worldSize, 20);
+
+	testBuild(cells, field);
+	testThinning(cells, field);
+	testPathsMatch(cells, field);
+	testNoPopping(cells, field);
+	testOrderAndBends(cells, field);
+
+	return checkResult();
+}
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "GrassScatter.h"
+#include "JobSystem.h"
+#include "Check.h"
+
+#include <algorithm>
+
+static bool sameInstances(const std::vector<GrassScatter::Instance>& a, const std::vector<GrassScatter::Instance>& b)
+{
+	if (a.size() != b.size())
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		if (a[i].position.x != b[i].position.x || a[i].position.y != b[i].position.y || a[i].position.z != b[i].position.z
+			|| a[i].scale != b[i].scale || a[i].rotation != b[i].rotation)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//One blade inside each cell, standing on the heightmap, with the scale and rotation in range. The job system gives the same field.
+static void testJittered(const HeightField& heights)
+{
+	const float worldSize = 100.0f;
+	const float spacing = 0.5f;
+
+	std::vector<GrassScatter::Instance> single;
+	GrassScatter::scatterJittered(heights, worldSize, spacing, 4, single, false);
+	CHECK(single.size() == 200 * 200);
+
+	bool inCell = true;
+	bool onGround = true;
+	bool inRange = true;
+
+	for (int j = 0; j < 200; j++)
+	{
+		for (int i = 0; i < 200; i++)
+		{
+			const GrassScatter::Instance& blade = single[(j * 200) + i];
+			//The far edge is inclusive, a hash just under one can round up onto it
+			inCell = inCell && blade.position.x >= (float)i * spacing && blade.position.x <= (float)(i + 1) * spacing
+				&& blade.position.z >= (float)j * spacing && blade.position.z <= (float)(j + 1) * spacing;
+			onGround = onGround && blade.position.y == heights.sample(blade.position.x / worldSize, blade.position.z / worldSize);
+			inRange = inRange && blade.scale >= 0.75f && blade.scale < 1.25f && blade.rotation >= 0.0f && blade.rotation < XM_2PI && blade.bend == 0;
+		}
+	}
+
+	CHECK(inCell);
+	CHECK(onGround);
+	CHECK(inRange);
+
+	JobSystem jobs(3);
+	JobSystem::setShared(&jobs);
+
+	std::vector<GrassScatter::Instance> threaded;
+	GrassScatter::scatterJittered(heights, worldSize, spacing, 4, threaded, true);
+
+	JobSystem::setShared(nullptr);
+
+	CHECK(sameInstances(single, threaded));
+
+	std::vector<GrassScatter::Instance> reseeded;
+	GrassScatter::scatterJittered(heights, worldSize, spacing, 5, reseeded, false);
+	CHECK(!sameInstances(single, reseeded));
+}
+
+//No two Poisson blades closer than the spacing, and the field is full - every point is within two spacings of a blade
+static void testPoisson(const HeightField& heights)
+{
+	const float worldSize = 40.0f;
+	const float spacing = 0.5f;
+
+	std::vector<GrassScatter::Instance> blades;
+	GrassScatter::scatterPoisson(heights, worldSize, spacing, 7, blades);
+
+	//Dense disc packings sit near 0.7 discs of radius spacing / 2 per area, Bridson's algorithm noticeably under that
+	float density = ((float)blades.size() * spacing * spacing) / (worldSize * worldSize);
+	CHECK(density > 0.5f && density < 1.2f);
+
+	int side = (int)(worldSize / spacing);
+	std::vector<std::vector<int>> buckets(side * side);
+
+	for (int i = 0; i < (int)blades.size(); i++)
+	{
+		CHECK(blades[i].position.x >= 0.0f && blades[i].position.x < worldSize && blades[i].position.z >= 0.0f && blades[i].position.z < worldSize);
+		buckets[((int)(blades[i].position.z / spacing) * side) + (int)(blades[i].position.x / spacing)].push_back(i);
+	}
+
+	auto nearest = [&](float x, float z, int skip)
+	{
+		float best = worldSize * worldSize;
+		int bucketX = (int)(x / spacing);
+		int bucketZ = (int)(z / spacing);
+
+		for (int bz = std::max(bucketZ - 3, 0); bz <= std::min(bucketZ + 3, side - 1); bz++)
+		{
+			for (int bx = std::max(bucketX - 3, 0); bx <= std::min(bucketX + 3, side - 1); bx++)
+			{
+				for (int other : buckets[(bz * side) + bx])
+				{
+					if (other != skip)
+					{
+						float dx = blades[other].position.x - x;
+						float dz = blades[other].position.z - z;
+						best = std::min(best, (dx * dx) + (dz * dz));
+					}
+				}
+			}
+		}
+
+		return sqrtf(best);
+	};
+
+	float closestPair = worldSize;
+
+	for (int i = 0; i < (int)blades.size(); i++)
+	{
+		closestPair = std::min(closestPair, nearest(blades[i].position.x, blades[i].position.z, i));
+	}
+
+	CHECK(closestPair >= spacing * 0.9999f);
+
+	float largestGap = 0.0f;
+
+	for (float z = 0.1f; z < worldSize; z += 0.37f)
+	{
+		for (float x = 0.1f; x < worldSize; x += 0.37f)
+		{
+			largestGap = std::max(largestGap, nearest(x, z, -1));
+		}
+	}
+
+	CHECK(largestGap <= spacing * 2.0f);
+}
+
+//Without a heightmap the blades stand on the flat plane
+static void testFlat()
+{
+	HeightField empty;
+	std::vector<GrassScatter::Instance> blades;
+	GrassScatter::scatterJittered(empty, 10.0f, 1.0f, 1, blades, false);
+
+	CHECK(blades.size() == 100);
+	CHECK(std::all_of(blades.begin(), blades.end(), [](const GrassScatter::Instance& blade) { return blade.position.y == 0.0f; }));
+}
+
+int main()
+{
+	HeightField heights;
+	heights.generateFractal(256);
+
+	testJittered(heights);
+	testPoisson(heights);
+	testFlat();
+
+	return checkResult();
+}
\ No newline at end of file
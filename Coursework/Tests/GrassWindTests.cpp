@@ -0,0 +1,193 @@
+#include "GrassWind.h"
+#include "JobSystem.h"
+#include "Check.h"
+
+#include <cmath>
+
+static float unpackX(uint32_t packed)
+{
+	return (float)(int16_t)(packed & 0xFFFF) / 32767.0f;
+}
+
+static float unpackZ(uint32_t packed)
+{
+	return (float)(int16_t)(packed >> 16) / 32767.0f;
+}
+
+static GrassWind::Settings testSettings()
+{
+	GrassWind::Settings settings = { XMFLOAT2(0.8f, 0.6f), 10.0f, 8.0f, 4.0f, 3.0f, 1000000.0f };
+	return settings;
+}
+
+//The four wide path follows the scalar one step for step
+static void testSimdMatchesScalar(const GrassCells& cells)
+{
+	GrassWind scalar, simd;
+	scalar.build(cells);
+	simd.build(cells);
+
+	int count = scalar.getBladeCount();
+	GrassWind::Settings settings = testSettings();
+	float maxDifference = 0.0f;
+
+	for (int step = 1; step <= 120; step++)
+	{
+		scalar.simulate(0, count, (float)step / 60.0f, 1.0f / 60.0f, settings, false);
+		simd.simulate(0, count, (float)step / 60.0f, 1.0f / 60.0f, settings, true);
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		maxDifference = fmaxf(maxDifference, fabsf(unpackX(scalar.getPackedBends()[i]) - unpackX(simd.getPackedBends()[i])));
+		maxDifference = fmaxf(maxDifference, fabsf(unpackZ(scalar.getPackedBends()[i]) - unpackZ(simd.getPackedBends()[i])));
+	}
+
+	CHECK(maxDifference < 1e-3f);
+}
+
+//With no wind the blades stay at rest, and a steady wind settles every blade where the spring balances the gust at it
+static void testRestAndSteadyState(const GrassCells& cells)
+{
+	GrassWind wind;
+	wind.build(cells);
+
+	int count = wind.getBladeCount();
+	GrassWind::Settings settings = testSettings();
+	settings.strength = 0.0f;
+
+	for (int step = 1; step <= 60; step++)
+	{
+		wind.simulate(0, count, (float)step / 60.0f, 1.0f / 60.0f, settings, true);
+	}
+
+	bool atRest = true;
+
+	for (int i = 0; i < count; i++)
+	{
+		atRest = atRest && wind.getPackedBends()[i] == 0;
+	}
+
+	CHECK(atRest);
+
+	//Gusts that don't scroll, so the force on every blade is constant and the damped spring settles
+	settings = testSettings();
+	settings.gustSpeed = 0.0f;
+
+	for (int step = 1; step <= 900; step++)
+	{
+		wind.simulate(0, count, (float)step / 60.0f, 1.0f / 60.0f, settings, true);
+	}
+
+	float maxError = 0.0f;
+
+	for (int i = 0; i < count; i++)
+	{
+		float x = cells.getPositionX()[i];
+		float z = cells.getPositionZ()[i];
+		float phase = ((x * settings.direction.x) + (z * settings.direction.y)) / settings.gustScale;
+		float crossPhase = (((z * settings.direction.x) - (x * settings.direction.y)) / settings.gustScale) * 1.7f;
+		float gust = 0.55f + (0.3f * sinf(phase)) + (0.15f * sinf((phase * 2.3f) + crossPhase));
+		float stiffness = 24.0f / cells.getInstance(i).scale;
+		float bend = (settings.strength * gust) / stiffness;
+
+		maxError = fmaxf(maxError, fabsf(unpackX(wind.getPackedBends()[i]) - (bend * settings.direction.x)));
+		maxError = fmaxf(maxError, fabsf(unpackZ(wind.getPackedBends()[i]) - (bend * settings.direction.y)));
+	}
+
+	CHECK(maxError < 2e-3f);
+}
+
+//The first update moves every blade, then a budget of nothing still moves one batch a frame, round robin
+static void testBudget(const GrassCells& cells)
+{
+	GrassWind wind;
+	wind.build(cells);
+
+	int count = wind.getBladeCount();
+	int batchCount = (count + GrassWind::BATCH_SIZE - 1) / GrassWind::BATCH_SIZE;
+	GrassWind::Settings settings = testSettings();
+	settings.budgetMilliseconds = 0.0f;
+
+	wind.update(1.0f / 60.0f, settings, true, false);
+	CHECK(wind.getLastBlades() == count);
+	CHECK(wind.getNanosecondsPerBlade() > 0.0f);
+
+	std::vector<uint32_t> previous(wind.getPackedBends(), wind.getPackedBends() + count);
+	bool roundRobin = true;
+
+	for (int frame = 0; frame < batchCount; frame++)
+	{
+		wind.update((float)(frame + 2) / 60.0f, settings, true, false);
+		roundRobin = roundRobin && wind.getLastBlades() == (frame < batchCount - 1 ? GrassWind::BATCH_SIZE : count - ((batchCount - 1) * GrassWind::BATCH_SIZE));
+
+		//Only the blades of this frame's batch have moved
+		for (int i = 0; i < count; i++)
+		{
+			bool inBatch = i / GrassWind::BATCH_SIZE == frame;
+			bool moved = wind.getPackedBends()[i] != previous[i];
+
+			if (moved && !inBatch)
+			{
+				roundRobin = false;
+			}
+
+			previous[i] = wind.getPackedBends()[i];
+		}
+	}
+
+	CHECK(roundRobin);
+
+	//A budget of a few batches' measured cost does more than one batch and less than the field
+	settings.budgetMilliseconds = (wind.getNanosecondsPerBlade() * (float)GrassWind::BATCH_SIZE * 4.0f) / 1000000.0f;
+	wind.update((float)(batchCount + 2) / 60.0f, settings, true, false);
+	CHECK(wind.getLastBlades() >= GrassWind::BATCH_SIZE && wind.getLastBlades() < count);
+}
+
+//Simulating the batches on the job system gives exactly the single thread result
+static void testMultithreaded(const GrassCells& cells)
+{
+	GrassWind single, threaded;
+	single.build(cells);
+	threaded.build(cells);
+
+	GrassWind::Settings settings = testSettings();
+
+	JobSystem jobs(3);
+	JobSystem::setShared(&jobs);
+
+	for (int frame = 1; frame <= 30; frame++)
+	{
+		single.update((float)frame / 60.0f, settings, true, false);
+		threaded.update((float)frame / 60.0f, settings, true, true);
+	}
+
+	JobSystem::setShared(nullptr);
+
+	bool same = single.getLastBlades() == threaded.getLastBlades();
+
+	for (int i = 0; i < single.getBladeCount(); i++)
+	{
+		same = same && single.getPackedBends()[i] == threaded.getPackedBends()[i];
+	}
+
+	CHECK(same);
+}
+
+int main()
+{
+	//A field that doesn't divide into whole batches, so the last batch is short
+	std::vector<GrassScatter::Instance> field;
+	GrassScatter::scatterJittered(HeightField(), 150.0f, 1.0f, 1, field, false);
+
+	GrassCells cells;
+	cells.build(field, 150.0f, 15);
+	CHECK(cells.getBladeCount() % GrassWind::BATCH_SIZE != 0);
+
+	testSimdMatchesScalar(cells);
+	testRestAndSteadyState(cells);
+	testBudget(cells);
+	testMultithreaded(cells);
+
+	return checkResult();
+}
\ No newline at end of file
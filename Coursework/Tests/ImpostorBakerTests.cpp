@@ -0,0 +1,174 @@
+#include "ImpostorBaker.h"
+#include "JobSystem.h"
+#include "Check.h"
+
+#include <cmath>
+
+static const int framesPerSide = 8;
+static const int frameSize = 64;
+
+//Unit sphere around the origin, with the normals pointing out and the texture coordinates wrapping around it
+static void buildSphere(int slices, int stacks, std::vector<ImpostorBaker::Vertex>& vertices, std::vector<unsigned long>& indices)
+{
+	for (int stack = 0; stack <= stacks; stack++)
+	{
+		float theta = XM_PI * (float)stack / (float)stacks;
+
+		for (int slice = 0; slice <= slices; slice++)
+		{
+			float phi = XM_2PI * (float)slice / (float)slices;
+			XMFLOAT3 position(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi));
+			vertices.push_back({ position, position, XMFLOAT2((float)slice / (float)slices, (float)stack / (float)stacks) });
+		}
+	}
+
+	for (int stack = 0; stack < stacks; stack++)
+	{
+		for (int slice = 0; slice < slices; slice++)
+		{
+			unsigned long first = (unsigned long)((stack * (slices + 1)) + slice);
+			unsigned long below = first + slices + 1;
+			indices.insert(indices.end(), { first, below, first + 1, first + 1, below, below + 1 });
+		}
+	}
+}
+
+static XMFLOAT3 unpackNormal(uint32_t texel)
+{
+	return XMFLOAT3(((float)(texel & 0xFF) / 255.0f * 2.0f) - 1.0f, ((float)((texel >> 8) & 0xFF) / 255.0f * 2.0f) - 1.0f,
+		((float)((texel >> 16) & 0xFF) / 255.0f * 2.0f) - 1.0f);
+}
+
+//Every frame's view direction is a unit vector, with the image axes at right angles to it and each other
+static void testFrameAxes()
+{
+	bool orthonormal = true;
+
+	for (int frameY = 0; frameY < framesPerSide; frameY++)
+	{
+		for (int frameX = 0; frameX < framesPerSide; frameX++)
+		{
+			XMFLOAT3 direction = ImpostorBaker::getFrameDirection(frameX, frameY, framesPerSide);
+			XMFLOAT3 right, up;
+			ImpostorBaker::getFrameAxes(direction, right, up);
+
+			XMVECTOR d = XMLoadFloat3(&direction);
+			XMVECTOR r = XMLoadFloat3(&right);
+			XMVECTOR u = XMLoadFloat3(&up);
+
+			orthonormal = orthonormal && fabsf(XMVectorGetX(XMVector3Length(d)) - 1.0f) < 1e-4f && fabsf(XMVectorGetX(XMVector3Length(r)) - 1.0f) < 1e-4f
+				&& fabsf(XMVectorGetX(XMVector3Length(u)) - 1.0f) < 1e-4f && fabsf(XMVectorGetX(XMVector3Dot(d, r))) < 1e-4f
+				&& fabsf(XMVectorGetX(XMVector3Dot(d, u))) < 1e-4f && fabsf(XMVectorGetX(XMVector3Dot(r, u))) < 1e-4f;
+		}
+	}
+
+	CHECK(orthonormal);
+}
+
+//A sphere fills a disc in the middle of every frame, with the depth and normal of the sphere's surface behind each texel
+static void testSphereAtlas(const std::vector<ImpostorBaker::Vertex>& vertices, const std::vector<unsigned long>& indices)
+{
+	uint32_t colour = 0xFFC04020;
+	ImpostorBaker::Texture albedo = { 1, 1, &colour };
+	ImpostorBaker::Atlas atlas;
+	ImpostorBaker::BakeStats stats = ImpostorBaker::bake(vertices.data(), (int)vertices.size(), indices.data(), (int)indices.size(), albedo, framesPerSide,
+		frameSize, atlas, false);
+
+	CHECK(stats.frames == framesPerSide * framesPerSide);
+	CHECK(stats.triangles == (int)indices.size() / 3);
+	CHECK(atlas.getSize() == framesPerSide * frameSize);
+	CHECK_NEAR(atlas.radius, 1.0f, 1e-4f);
+	CHECK_NEAR(atlas.centre.x, 0.0f, 1e-4f);
+	CHECK_NEAR(atlas.centre.y, 0.0f, 1e-4f);
+	CHECK_NEAR(atlas.centre.z, 0.0f, 1e-4f);
+
+	//The disc covers pi/4 of its square, a little less for the sphere's flat faces
+	CHECK_NEAR(stats.coverage, XM_PIDIV4, 0.02f);
+
+	//Neighbouring frames agree on the depth to within half a texel, the next frame is looked up at the nearest texel
+	CHECK(stats.reprojectionError < atlas.radius / (float)frameSize);
+
+	int atlasSize = atlas.getSize();
+	float maxDepthError = 0.0f;
+	float minNormalDot = 1.0f;
+	bool coloured = true;
+	bool dilated = true;
+
+	for (int frameY = 0; frameY < framesPerSide; frameY++)
+	{
+		for (int frameX = 0; frameX < framesPerSide; frameX++)
+		{
+			XMFLOAT3 direction = ImpostorBaker::getFrameDirection(frameX, frameY, framesPerSide);
+			XMFLOAT3 right, up;
+			ImpostorBaker::getFrameAxes(direction, right, up);
+
+			for (int py = 0; py < frameSize; py++)
+			{
+				for (int px = 0; px < frameSize; px++)
+				{
+					size_t texel = ((size_t)((frameY * frameSize) + py) * atlasSize) + (frameX * frameSize) + px;
+					float x = ((((float)px + 0.5f) / (float)frameSize) * 2.0f) - 1.0f;
+					float y = 1.0f - ((((float)py + 0.5f) / (float)frameSize) * 2.0f);
+					float squared = (x * x) + (y * y);
+					bool covered = (atlas.albedo[texel] >> 24) != 0;
+
+					//Clear of the silhouette, where the faceted edge may go either way
+					if (squared < 0.8f)
+					{
+						coloured = coloured && covered && atlas.albedo[texel] == colour;
+
+						float expected = sqrtf(1.0f - squared);
+						float z = (((float)atlas.depth[texel] / 65535.0f) * 2.0f) - 1.0f;
+						maxDepthError = fmaxf(maxDepthError, fabsf(z - expected));
+
+						XMFLOAT3 surface((x * right.x) + (y * up.x) + (expected * direction.x), (x * right.y) + (y * up.y) + (expected * direction.y),
+							(x * right.z) + (y * up.z) + (expected * direction.z));
+						XMFLOAT3 normal = unpackNormal(atlas.normals[texel]);
+						minNormalDot = fminf(minNormalDot, (normal.x * surface.x) + (normal.y * surface.y) + (normal.z * surface.z));
+					}
+
+					//Just outside the disc the colour is spread out with no coverage, so filtering doesn't darken the edge
+					else if (squared > 1.035f && squared < 1.06f && fabsf(x) < 0.95f && fabsf(y) < 0.95f)
+					{
+						dilated = dilated && !covered && (atlas.albedo[texel] & 0x00FFFFFF) == (colour & 0x00FFFFFF);
+					}
+				}
+			}
+		}
+	}
+
+	CHECK(coloured);
+	CHECK(dilated);
+	CHECK(maxDepthError < 0.01f);
+	CHECK(minNormalDot > 0.98f);
+}
+
+//Baking a frame per task on the job system gives exactly the single thread atlas
+static void testMultithreaded(const std::vector<ImpostorBaker::Vertex>& vertices, const std::vector<unsigned long>& indices)
+{
+	ImpostorBaker::Texture albedo = { 0, 0, nullptr };
+	ImpostorBaker::Atlas single, threaded;
+	ImpostorBaker::bake(vertices.data(), (int)vertices.size(), indices.data(), (int)indices.size(), albedo, framesPerSide, frameSize, single, false);
+
+	JobSystem jobs(3);
+	JobSystem::setShared(&jobs);
+	ImpostorBaker::bake(vertices.data(), (int)vertices.size(), indices.data(), (int)indices.size(), albedo, framesPerSide, frameSize, threaded, true);
+	JobSystem::setShared(nullptr);
+
+	CHECK(single.albedo == threaded.albedo);
+	CHECK(single.normals == threaded.normals);
+	CHECK(single.depth == threaded.depth);
+}
+
+int main()
+{
+	std::vector<ImpostorBaker::Vertex> vertices;
+	std::vector<unsigned long> indices;
+	buildSphere(96, 48, vertices, indices);
+
+	testFrameAxes();
+	testSphereAtlas(vertices, indices);
+	testMultithreaded(vertices, indices);
+
+	return checkResult();
+}
\ No newline at end of file
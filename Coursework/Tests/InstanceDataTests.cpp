@@ -0,0 +1,87 @@
+#include "InstanceData.h"
+#include "CommandRecorder.h"
+#include "RecordingContexts.h"
+#include "Check.h"
+
+#include <vector>
+
+using namespace DirectX;
+
+//The instanced vertex shaders read four float4 rows from the second slot, so an instance is exactly one untransposed matrix
+static void testLayout()
+{
+	CHECK(sizeof(InstanceData::Instance) == 64);
+	CHECK(sizeof(InstanceData::Instance) == sizeof(XMFLOAT4X4));
+
+	InstanceData::Instance instance;
+	XMStoreFloat4x4(&instance.world, XMMatrixMultiply(XMMatrixScaling(2.0f, 3.0f, 4.0f), XMMatrixTranslation(5.0f, 6.0f, 7.0f)));
+	const float* rows = &instance.world._11;
+
+	//Row vectors times the matrix, so the translation is the fourth row rather than the fourth column
+	CHECK(rows[0] == 2.0f && rows[5] == 3.0f && rows[10] == 4.0f);
+	CHECK(rows[12] == 5.0f && rows[13] == 6.0f && rows[14] == 7.0f && rows[15] == 1.0f);
+	CHECK(rows[3] == 0.0f && rows[7] == 0.0f && rows[11] == 0.0f);
+}
+
+//More instances than the buffer holds are cut at its capacity, leaving the memory after it alone, and nothing is written for none
+static void testWriteClamps()
+{
+	std::vector<InstanceData::Instance> instances(10);
+
+	for (int i = 0; i < 10; i++)
+	{
+		XMStoreFloat4x4(&instances[i].world, XMMatrixTranslation((float)i, 0.0f, 0.0f));
+	}
+
+	std::vector<InstanceData::Instance> mapped(5);
+	XMStoreFloat4x4(&mapped[4].world, XMMatrixScaling(-1.0f, -1.0f, -1.0f));
+
+	CHECK(InstanceData::write(mapped.data(), 4, instances.data(), 10) == 4);
+	CHECK(mapped[3].world._41 == 3.0f);
+	CHECK(mapped[4].world._11 == -1.0f && mapped[4].world._41 == 0.0f);
+
+	CHECK(InstanceData::write(mapped.data(), 4, instances.data(), 2) == 2);
+	CHECK(InstanceData::write(mapped.data(), 4, instances.data(), 0) == 0);
+	CHECK(InstanceData::write(mapped.data(), 4, instances.data(), -3) == 0);
+	CHECK(mapped[4].world._11 == -1.0f);
+}
+
+//An instanced pass records its map and one draw, and executing it counts every instance but one draw call
+static void testRecordedInstances()
+{
+	std::vector<InstanceData::Instance> instances(100);
+	RecordingContexts contexts;
+	CommandRecorder recorder(&contexts);
+
+	recorder.addPass([&contexts, &instances](int context)
+	{
+		RecordingContexts::Context* recording = contexts.getContext(context);
+		void* mapped = recording->mapInstances((unsigned int)(sizeof(InstanceData::Instance) * instances.size()));
+		int count = InstanceData::write(mapped, (int)instances.size(), instances.data(), (int)instances.size());
+		recording->drawIndexedInstanced(36, (unsigned int)count);
+		recording->drawIndexed(6);
+	});
+
+	recorder.record(false);
+	recorder.execute();
+
+	const std::vector<RecordingContexts::Command>& executed = contexts.getExecuted();
+	CHECK(executed.size() == 3);
+	CHECK(executed[0].type == RecordingContexts::Command::MAP_INSTANCES && executed[0].value == 6400);
+	CHECK(executed[1].type == RecordingContexts::Command::DRAW_INDEXED_INSTANCED && executed[1].value == 36 && executed[1].instances == 100);
+	CHECK(contexts.getExecutedDraws() == 2);
+	CHECK(contexts.getExecutedInstances() == 101);
+	CHECK(contexts.getExecutedInstanceBytes() == 6400);
+
+	contexts.clearExecuted();
+	CHECK(contexts.getExecutedInstances() == 0 && contexts.getExecutedInstanceBytes() == 0);
+}
+
+int main()
+{
+	testLayout();
+	testWriteClamps();
+	testRecordedInstances();
+
+	return checkResult();
+}
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include "JobSystem.h"
+#include "ParallelFor.h"
+#include "Check.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+//Sums [first, last) by splitting it in two jobs until the halves are small, each job waiting on the two it spawned
+static void sumRange(JobSystem& jobs, long long first, long long last, std::atomic<long long>& total)
+{
+	if (last - first <= 64)
+	{
+		long long sum = 0;
+
+		for (long long i = first; i < last; i++)
+		{
+			sum += i;
+		}
+
+		total += sum;
+		return;
+	}
+
+	long long middle = first + ((last - first) / 2);
+	JobSystem::Counter counter;
+	jobs.run([&jobs, first, middle, &total]() { sumRange(jobs, first, middle, total); }, &counter);
+	jobs.run([&jobs, middle, last, &total]() { sumRange(jobs, middle, last, total); }, &counter);
+	jobs.wait(counter);
+}
+
+//Jobs waiting on the jobs they spawned, many levels deep, finish every job once and return only when their children have
+static void testNestedWait()
+{
+	JobSystem jobs(3);
+	CHECK(jobs.getThreadCount() == 4);
+
+	for (int run = 0; run < 10; run++)
+	{
+		std::atomic<long long> total(0);
+		sumRange(jobs, 0, 100000, total);
+		CHECK(total == (100000LL * 99999LL) / 2);
+	}
+
+	//Parents that each wait on eight children, checking every child had finished when their wait returned
+	std::atomic<int> leaves(0);
+	std::atomic<int> early(0);
+	JobSystem::Counter parents;
+
+	for (int parent = 0; parent < 64; parent++)
+	{
+		jobs.run([&jobs, &leaves, &early]()
+		{
+			std::atomic<int> finished(0);
+			JobSystem::Counter children;
+
+			for (int child = 0; child < 8; child++)
+			{
+				jobs.run([&finished, &leaves]() { finished++; leaves++; }, &children);
+			}
+
+			jobs.wait(children);
+			early += finished == 8 ? 0 : 1;
+		}, &parents);
+	}
+
+	jobs.wait(parents);
+	CHECK(leaves == 64 * 8);
+	CHECK(early == 0);
+}
+
+//More jobs than a deque holds are queued while the workers are busy, and the ones past its capacity run at once on the calling thread
+static void testPastCapacity()
+{
+	const int workers = 3;
+	const int count = 10000;
+	JobSystem jobs(workers);
+
+	//Keep every worker inside a job, so none can steal from the calling thread's deque
+	std::atomic<int> started(0);
+	std::atomic<bool> release(false);
+	JobSystem::Counter blockers;
+
+	for (int i = 0; i < workers; i++)
+	{
+		jobs.run([&started, &release]()
+		{
+			started++;
+
+			while (!release)
+			{
+				std::this_thread::yield();
+			}
+		}, &blockers);
+	}
+
+	while (started < workers)
+	{
+		std::this_thread::yield();
+	}
+
+	std::vector<std::atomic<int>> runs(count);
+	std::atomic<int> ranAtOnce(0);
+	std::thread::id caller = std::this_thread::get_id();
+	JobSystem::Counter counter;
+
+	for (int i = 0; i < count; i++)
+	{
+		runs[i] = 0;
+		jobs.run([&runs, &ranAtOnce, caller, i]()
+		{
+			runs[i]++;
+			ranAtOnce += std::this_thread::get_id() == caller ? 1 : 0;
+		}, &counter);
+	}
+
+	//Before anything waited, only the jobs the full deque turned away have run
+	CHECK(ranAtOnce == count - 4096);
+	CHECK(counter.value == 4096);
+
+	release = true;
+	jobs.wait(counter);
+	jobs.wait(blockers);
+
+	int wrong = 0;
+
+	for (std::atomic<int>& run : runs)
+	{
+		wrong += run == 1 ? 0 : 1;
+	}
+
+	CHECK(wrong == 0);
+	CHECK(counter.value == 0);
+}
+
+//Every index of the range is visited exactly once, in contiguous blocks no smaller than asked for except the last
+static void testParallelForCoverage()
+{
+	JobSystem jobs(3);
+	JobSystem::setShared(&jobs);
+
+	for (int count : { 0, 1, 7, 100, 4096, 100003 })
+	{
+		for (int minimum : { 1, 16, 1000 })
+		{
+			std::vector<std::atomic<int>> visits(count);
+			std::atomic<int> badBlocks(0);
+
+			for (std::atomic<int>& visit : visits)
+			{
+				visit = 0;
+			}
+
+			jobs.parallelFor(count, [&](int begin, int end)
+			{
+				badBlocks += (begin < 0 || end > count || begin >= end || (end - begin < minimum && end != count)) ? 1 : 0;
+
+				for (int i = begin; i < end; i++)
+				{
+					visits[i]++;
+				}
+			}, minimum);
+
+			int wrong = 0;
+
+			for (std::atomic<int>& visit : visits)
+			{
+				wrong += visit == 1 ? 0 : 1;
+			}
+
+			CHECK(wrong == 0);
+			CHECK(badBlocks == 0);
+
+			//The same through the shared system
+			std::atomic<long long> sum(0);
+			parallelFor(count, [&sum](int begin, int end)
+			{
+				for (int i = begin; i < end; i++)
+				{
+					sum += i;
+				}
+			}, minimum);
+
+			CHECK(sum == ((long long)count * (count - 1)) / 2);
+		}
+	}
+
+	JobSystem::setShared(nullptr);
+}
+
+//Without a shared system parallelFor() runs the whole range on the calling thread, and a thread the system doesn't know runs its own
+//jobs and ranges at once rather than queueing them where nothing would wait for them
+static void testSerialFallback()
+{
+	CHECK(JobSystem::getShared() == nullptr);
+
+	int calls = 0;
+	int first = -1, last = -1;
+	std::thread::id thread;
+	parallelFor(1000, [&](int begin, int end)
+	{
+		calls++;
+		first = begin;
+		last = end;
+		thread = std::this_thread::get_id();
+	});
+
+	CHECK(calls == 1);
+	CHECK(first == 0 && last == 1000);
+	CHECK(thread == std::this_thread::get_id());
+
+	calls = 0;
+	parallelFor(0, [&](int, int) { calls++; });
+	CHECK(calls == 0);
+
+	JobSystem jobs(3);
+	std::atomic<int> outsideCalls(0);
+	std::atomic<int> ranInline(0);
+
+	std::thread outsider([&]()
+	{
+		jobs.parallelFor(1000, [&](int begin, int end) { outsideCalls += (begin == 0 && end == 1000) ? 1 : 0; });
+
+		JobSystem::Counter counter;
+		std::thread::id self = std::this_thread::get_id();
+		jobs.run([&ranInline, self]() { ranInline += std::this_thread::get_id() == self ? 1 : 0; }, &counter);
+		ranInline += counter.value == 0 ? 1 : 0;
+		jobs.wait(counter);
+	});
+
+	outsider.join();
+	CHECK(outsideCalls == 1);
+	CHECK(ranInline == 2);
+}
+
+int main()
+{
+	testNestedWait();
+	testPastCapacity();
+	testParallelForCoverage();
+	testSerialFallback();
+
+	return checkResult();
+}
\ No newline at end of file
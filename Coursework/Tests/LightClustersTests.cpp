@@ -0,0 +1,178 @@
+#include "LightClusters.h"
+#include "JobSystem.h"
+#include "Check.h"
+
+#include <algorithm>
+
+static const float nearZ = 0.1f;
+static const float farZ = 200.0f;
+static const float aspect = 16.0f / 9.0f;
+
+static XMMATRIX testView()
+{
+	return XMMatrixLookAtLH(XMVectorSet(0.0f, 10.0f, -20.0f, 1.0f), XMVectorSet(0.0f, 0.0f, 40.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+}
+
+static XMMATRIX testProjection()
+{
+	return XMMatrixPerspectiveFovLH(XM_PIDIV4, aspect, nearZ, farZ);
+}
+
+static std::vector<unsigned int> allLights(const LightSystem& lights)
+{
+	std::vector<unsigned int> visible(lights.getCount());
+
+	for (int i = 0; i < lights.getCount(); i++)
+	{
+		visible[i] = i;
+	}
+
+	return visible;
+}
+
+//The single threaded and job system builds produce the same ranges and index lists
+static void testThreadedMatches()
+{
+	LightSystem lights;
+	lights.addRandomLights(1024, XMFLOAT3(-50.0f, 1.0f, -10.0f), XMFLOAT3(50.0f, 8.0f, 90.0f));
+	std::vector<unsigned int> visible = allLights(lights);
+
+	LightClusters single;
+	single.build(lights, visible, testView(), testProjection(), nearZ, farZ, false);
+
+	JobSystem jobs(4);
+	JobSystem::setShared(&jobs);
+
+	LightClusters threaded;
+	threaded.build(lights, visible, testView(), testProjection(), nearZ, farZ, true);
+
+	JobSystem::setShared(nullptr);
+
+	CHECK(single.getStats().indexCount > 0);
+	CHECK(single.getLightIndices() == threaded.getLightIndices());
+
+	bool rangesMatch = true;
+
+	for (int i = 0; i < LightClusters::CLUSTER_COUNT; i++)
+	{
+		rangesMatch = rangesMatch && single.getClusterRanges()[i].offset == threaded.getClusterRanges()[i].offset
+			&& single.getClusterRanges()[i].count == threaded.getClusterRanges()[i].count;
+	}
+
+	CHECK(rangesMatch);
+}
+
+//Every point inside the view that a light reaches must find that light in its cluster, using the same lookup as lighting.hlsli.
+//Points too close to a cluster boundary to say which side they fall on are skipped.
+static void testConservative()
+{
+	LightSystem lights;
+	lights.addRandomLights(512, XMFLOAT3(-50.0f, 1.0f, -10.0f), XMFLOAT3(50.0f, 8.0f, 90.0f));
+	std::vector<unsigned int> visible = allLights(lights);
+
+	XMMATRIX view = testView();
+	XMMATRIX projection = testProjection();
+
+	LightClusters clusters;
+	clusters.build(lights, visible, view, projection, nearZ, farZ, false);
+
+	std::vector<XMFLOAT3> viewPositions(lights.getCount());
+	std::vector<XMFLOAT3> viewDirections(lights.getCount());
+
+	for (int i = 0; i < lights.getCount(); i++)
+	{
+		XMVECTOR position = XMVectorSet(lights.getPositionX()[i], lights.getPositionY()[i], lights.getPositionZ()[i], 1.0f);
+		XMStoreFloat3(&viewPositions[i], XMVector3TransformCoord(position, view));
+		XMStoreFloat3(&viewDirections[i], XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&lights.getDirections()[i]), view)));
+	}
+
+	unsigned int seed = 12345;
+	auto random = [&seed]() { seed = (seed * 1664525u) + 1013904223u; return (float)(seed >> 8) / 16777216.0f; };
+
+	int tested = 0;
+	int missing = 0;
+
+	for (int sample = 0; sample < 20000; sample++)
+	{
+		//A random point in normalised device space at a view depth spread over the first 120 units
+		float ndcX = (random() * 2.0f) - 1.0f;
+		float ndcY = (random() * 2.0f) - 1.0f;
+		float depth = 1.0f + (random() * 119.0f);
+
+		float tanHalf = tanf(XM_PIDIV4 * 0.5f);
+		XMFLOAT3 point(ndcX * depth * tanHalf * aspect, ndcY * depth * tanHalf, depth);
+
+		float clusterX = ((ndcX + 1.0f) * 0.5f) * (float)LightClusters::CLUSTERS_X;
+		float clusterY = ((1.0f - ndcY) * 0.5f) * (float)LightClusters::CLUSTERS_Y;
+		float clusterZ = (logf(depth) * clusters.getSliceScale()) + clusters.getSliceBias();
+
+		if (fabsf(clusterX - roundf(clusterX)) < 1e-3f || fabsf(clusterY - roundf(clusterY)) < 1e-3f || fabsf(clusterZ - roundf(clusterZ)) < 1e-3f)
+		{
+			continue;
+		}
+
+		int cluster = (int)clusterX + (LightClusters::CLUSTERS_X * ((int)clusterY + (LightClusters::CLUSTERS_Y * (int)clusterZ)));
+		const LightClusters::ClusterRange& range = clusters.getClusterRanges()[cluster];
+		const unsigned int* first = clusters.getLightIndices().data() + range.offset;
+
+		for (int light = 0; light < lights.getCount(); light++)
+		{
+			XMVECTOR toPoint = XMVectorSubtract(XMLoadFloat3(&point), XMLoadFloat3(&viewPositions[light]));
+			float distance = XMVectorGetX(XMVector3Length(toPoint));
+
+			if (distance > lights.getRanges()[light] * 0.999f)
+			{
+				continue;
+			}
+
+			if (lights.getKinds()[light] == LightSystem::KIND_SPOT && distance > 0.0f)
+			{
+				float cosine = XMVectorGetX(XMVector3Dot(XMVectorScale(toPoint, 1.0f / distance), XMLoadFloat3(&viewDirections[light])));
+
+				if (cosine < lights.getSpotCosines()[light] + 1e-3f)
+				{
+					continue;
+				}
+			}
+
+			tested++;
+
+			if (std::find(first, first + range.count, (unsigned int)light) == first + range.count)
+			{
+				missing++;
+			}
+		}
+	}
+
+	CHECK(tested > 1000);
+	CHECK(missing == 0);
+	CHECK(!clusters.getStats().truncated);
+}
+
+//Without lights every cluster is empty, and a single light far behind the camera reaches no cluster
+static void testEmpty()
+{
+	LightSystem lights;
+	LightClusters clusters;
+	std::vector<unsigned int> visible;
+
+	clusters.build(lights, visible, testView(), testProjection(), nearZ, farZ, false);
+	CHECK(clusters.getStats().indexCount == 0);
+	CHECK(clusters.getStats().maxLightsPerCluster == 0);
+
+	lights.addPointLight(XMFLOAT3(0.0f, 10.0f, -60.0f), 5.0f, XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f));
+	visible = allLights(lights);
+
+	clusters.build(lights, visible, testView(), testProjection(), nearZ, farZ, false);
+	CHECK(clusters.getStats().lightCount == 1);
+	CHECK(clusters.getStats().indexCount == 0);
+}
+
+int main()
+{
+	testThreadedMatches();
+	testConservative();
+	testEmpty();
+
+	return checkResult();
+}
\ No newline at end of file
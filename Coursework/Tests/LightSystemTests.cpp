@@ -0,0 +1,67 @@
+#include "LightSystem.h"
+#include "Check.h"
+
+static Frustum testFrustum()
+{
+	return Frustum(XMMatrixLookAtLH(XMVectorSet(0.0f, 10.0f, -20.0f, 1.0f), XMVectorSet(0.0f, 0.0f, 40.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f))
+		* XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 200.0f));
+}
+
+//The four wide cull keeps exactly the enabled lights the one at a time sphere test keeps, in index order, including the ones
+//left over past the last group of four
+static void testCull()
+{
+	LightSystem system;
+	system.addRandomLights(1003, XMFLOAT3(-50.0f, 1.0f, -10.0f), XMFLOAT3(50.0f, 8.0f, 90.0f));
+
+	for (int i = 0; i < system.getCount(); i += 5)
+	{
+		system.setEnabled(i, false);
+	}
+
+	Frustum frustum = testFrustum();
+	std::vector<unsigned int> visible;
+	system.cull(frustum, visible);
+
+	std::vector<unsigned int> expected;
+
+	for (int i = 0; i < system.getCount(); i++)
+	{
+		XMFLOAT3 centre(system.getPositionX()[i], system.getPositionY()[i], system.getPositionZ()[i]);
+
+		if (system.isEnabled(i) && frustum.sphereVisible(centre, system.getRanges()[i]))
+		{
+			expected.push_back(i);
+		}
+	}
+
+	CHECK(!expected.empty() && (int)expected.size() < system.getCount());
+	CHECK(visible == expected);
+}
+
+//Packing copies each listed light's fields in list order, point lights keep a -1 spot cosine
+static void testPack()
+{
+	LightSystem system;
+	int point = system.addPointLight(XMFLOAT3(1.0f, 2.0f, 3.0f), 4.0f, XMFLOAT4(0.1f, 0.2f, 0.3f, 1.0f));
+	int spot = system.addSpotLight(XMFLOAT3(5.0f, 6.0f, 7.0f), XMFLOAT3(0.0f, -1.0f, 0.0f), 8.0f, 0.9f, XMFLOAT4(0.4f, 0.5f, 0.6f, 1.0f));
+
+	std::vector<unsigned int> indices = { (unsigned int)spot, (unsigned int)point };
+	LightSystem::PackedLight packed[2];
+	system.pack(packed, indices, 2);
+
+	CHECK(packed[0].position.x == 5.0f && packed[0].position.y == 6.0f && packed[0].position.z == 7.0f);
+	CHECK(packed[0].range == 8.0f && packed[0].spotCosine == 0.9f && packed[0].direction.y == -1.0f);
+	CHECK(packed[0].colour.x == 0.4f);
+	CHECK(packed[1].position.x == 1.0f && packed[1].range == 4.0f && packed[1].spotCosine == -1.0f);
+	CHECK(packed[1].colour.z == 0.3f);
+	CHECK(system.getKinds()[point] == LightSystem::KIND_POINT && system.getKinds()[spot] == LightSystem::KIND_SPOT);
+}
+
+int main()
+{
+	testCull();
+	testPack();
+
+	return checkResult();
+}
\ No newline at end of file
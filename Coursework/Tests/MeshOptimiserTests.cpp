@@ -0,0 +1,254 @@
+#include "MeshOptimiser.h"
+#include "Check.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <random>
+
+using namespace DirectX;
+
+typedef VertexFormats::VertexType Vertex;
+typedef std::array<float, 8> VertexKey;
+typedef std::array<VertexKey, 3> TriangleKey;
+
+static VertexKey getKey(const Vertex& vertex)
+{
+	return { vertex.position.x, vertex.position.y, vertex.position.z, vertex.texture.x, vertex.texture.y, vertex.normal.x, vertex.normal.y, vertex.normal.z };
+}
+
+//Every triangle by the vertices it draws, turned to start at its smallest corner so the winding is kept but not where it starts
+static std::vector<TriangleKey> getTriangles(const std::vector<Vertex>& vertices, const std::vector<unsigned long>& indices)
+{
+	std::vector<TriangleKey> triangles;
+
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		TriangleKey triangle = { getKey(vertices[indices[i]]), getKey(vertices[indices[i + 1]]), getKey(vertices[indices[i + 2]]) };
+		std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		triangles.push_back(triangle);
+	}
+
+	std::sort(triangles.begin(), triangles.end());
+
+	return triangles;
+}
+
+//A grid of quads with the vertices along one row doubled up, as a UV seam is, then every vertex and triangle shuffled
+//so the order starts out as bad for the caches as it can be
+static void buildShuffledGrid(int size, std::vector<Vertex>& vertices, std::vector<unsigned long>& indices)
+{
+	for (int z = 0; z <= size; z++)
+	{
+		for (int x = 0; x <= size; x++)
+		{
+			float v = z == size / 2 ? 0.0f : (float)z / (float)size;
+			vertices.push_back({ XMFLOAT3((float)x, 0.0f, (float)z), XMFLOAT2((float)x / (float)size, v), XMFLOAT3(0.0f, 1.0f, 0.0f) });
+		}
+	}
+
+	for (int x = 0; x <= size; x++)
+	{
+		vertices.push_back({ XMFLOAT3((float)x, 0.0f, (float)(size / 2)), XMFLOAT2((float)x / (float)size, 1.0f), XMFLOAT3(0.0f, 1.0f, 0.0f) });
+	}
+
+	int seam = (size + 1) * (size + 1);
+	std::vector<std::array<unsigned long, 3>> triangles;
+
+	for (int z = 0; z < size; z++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			//The row below the seam uses the second copy of its vertices
+			unsigned long bottomLeft = (unsigned long)((z * (size + 1)) + x);
+			unsigned long topLeft = z + 1 == size / 2 ? (unsigned long)(seam + x) : bottomLeft + size + 1;
+			triangles.push_back({ bottomLeft, topLeft, topLeft + 1 });
+			triangles.push_back({ bottomLeft, topLeft + 1, bottomLeft + 1 });
+		}
+	}
+
+	//Exact duplicates for the weld to merge
+	vertices.push_back(vertices[0]);
+	vertices.push_back(vertices[size]);
+	triangles.push_back({ (unsigned long)vertices.size() - 2, (unsigned long)size + 1, 1 });
+
+	std::mt19937 random(11);
+	std::vector<unsigned long> shuffle(vertices.size());
+
+	for (size_t i = 0; i < shuffle.size(); i++)
+	{
+		shuffle[i] = (unsigned long)i;
+	}
+
+	std::shuffle(shuffle.begin(), shuffle.end(), random);
+	std::shuffle(triangles.begin(), triangles.end(), random);
+
+	std::vector<Vertex> shuffled(vertices.size());
+
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		shuffled[shuffle[i]] = vertices[i];
+	}
+
+	vertices.swap(shuffled);
+	indices.clear();
+
+	for (const std::array<unsigned long, 3>& triangle : triangles)
+	{
+		indices.insert(indices.end(), { shuffle[triangle[0]], shuffle[triangle[1]], shuffle[triangle[2]] });
+	}
+}
+
+//The whole pass draws the same triangles with the same winding, only reordered, and runs fewer vertex shaders
+static void testOptimise()
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned long> indices;
+	buildShuffledGrid(48, vertices, indices);
+
+	std::vector<TriangleKey> before = getTriangles(vertices, indices);
+	int vertexCount = (int)vertices.size();
+
+	MeshOptimiser::Report report = MeshOptimiser::optimise("grid", vertices.data(), vertexCount, indices.data(), (int)indices.size());
+	vertices.resize(vertexCount);
+
+	CHECK(report.triangles == (int)indices.size() / 3);
+	CHECK(report.verticesBefore == (int)vertices.size() + 2);
+	CHECK(report.verticesAfter == vertexCount);
+	CHECK(getTriangles(vertices, indices) == before);
+
+	bool inRange = true;
+
+	for (unsigned long index : indices)
+	{
+		inRange = inRange && index < (unsigned long)vertexCount;
+	}
+
+	CHECK(inRange);
+	CHECK(report.after.acmr <= report.before.acmr);
+	CHECK(report.after.acmr < 0.8f);
+	CHECK(report.after.fetchEfficiency >= report.before.fetchEfficiency);
+
+	//Recorded once under its name, replaced when optimised again
+	MeshOptimiser::optimise("grid", vertices.data(), vertexCount, indices.data(), (int)indices.size());
+	CHECK(std::count_if(MeshOptimiser::getReports().begin(), MeshOptimiser::getReports().end(), [](const MeshOptimiser::Report& other) { return other.name == "grid"; }) == 1);
+}
+
+//The weld points every copy of a vertex at one of them, and the fetch order then keeps each used vertex exactly once
+static void testVertexRemap()
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned long> indices;
+	buildShuffledGrid(16, vertices, indices);
+
+	std::vector<Vertex> original = vertices;
+	std::vector<unsigned long> originalIndices = indices;
+	std::map<VertexKey, int> distinct;
+
+	for (const Vertex& vertex : vertices)
+	{
+		distinct[getKey(vertex)]++;
+	}
+
+	int welded = MeshOptimiser::weldVertices(vertices.data(), (int)vertices.size(), indices.data(), (int)indices.size());
+	CHECK(welded == (int)distinct.size());
+
+	//Each index still draws the same vertex, and a vertex is only reached through one index value
+	bool sameVertices = true;
+	std::map<VertexKey, unsigned long> indexOf;
+
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		VertexKey key = getKey(vertices[indices[i]]);
+		sameVertices = sameVertices && key == getKey(original[originalIndices[i]]);
+
+		auto found = indexOf.emplace(key, indices[i]).first;
+		sameVertices = sameVertices && found->second == indices[i];
+	}
+
+	CHECK(sameVertices);
+
+	int fetched = MeshOptimiser::optimiseVertexFetch(vertices.data(), (int)vertices.size(), indices.data(), (int)indices.size());
+	CHECK(fetched == (int)indexOf.size());
+
+	//The new vertices are the used ones, each once, numbered in the order the indices first reach them
+	std::map<VertexKey, int> seen;
+	bool bijection = true;
+	unsigned long next = 0;
+
+	for (int i = 0; i < fetched; i++)
+	{
+		bijection = bijection && ++seen[getKey(vertices[i])] == 1 && indexOf.count(getKey(vertices[i])) == 1;
+	}
+
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		bijection = bijection && indices[i] <= next && getKey(vertices[indices[i]]) == getKey(original[originalIndices[i]]);
+		next = indices[i] == next ? next + 1 : next;
+	}
+
+	CHECK(bijection);
+	CHECK((int)seen.size() == fetched);
+}
+
+//The overdraw sort only moves whole clusters of the cache order, so the ACMR stays within its threshold
+static void testOverdrawThreshold()
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned long> indices;
+	buildShuffledGrid(32, vertices, indices);
+
+	std::vector<TriangleKey> before = getTriangles(vertices, indices);
+	int vertexCount = (int)vertices.size();
+
+	MeshOptimiser::optimiseVertexCache(indices.data(), (int)indices.size(), vertexCount);
+	float cacheAcmr = MeshOptimiser::analyse(indices.data(), (int)indices.size(), vertexCount).acmr;
+
+	MeshOptimiser::optimiseOverdraw(vertices.data(), indices.data(), (int)indices.size(), vertexCount, 1.05f);
+	float overdrawAcmr = MeshOptimiser::analyse(indices.data(), (int)indices.size(), vertexCount).acmr;
+
+	CHECK(getTriangles(vertices, indices) == before);
+	CHECK(overdrawAcmr <= cacheAcmr * 1.05f + 0.01f);
+}
+
+//A list already in a good order isn't made worse
+static void testNoRegression()
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned long> indices;
+	const int size = 32;
+
+	for (int z = 0; z <= size; z++)
+	{
+		for (int x = 0; x <= size; x++)
+		{
+			vertices.push_back({ XMFLOAT3((float)x, 0.0f, (float)z), XMFLOAT2(0.0f, 0.0f), XMFLOAT3(0.0f, 1.0f, 0.0f) });
+		}
+	}
+
+	for (int z = 0; z < size; z++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			unsigned long bottomLeft = (unsigned long)((z * (size + 1)) + x);
+			indices.insert(indices.end(), { bottomLeft, bottomLeft + size + 1, bottomLeft + size + 2, bottomLeft, bottomLeft + size + 2, bottomLeft + 1 });
+		}
+	}
+
+	int vertexCount = (int)vertices.size();
+	MeshOptimiser::Report report = MeshOptimiser::optimise("rows", vertices.data(), vertexCount, indices.data(), (int)indices.size());
+
+	CHECK(report.after.acmr <= report.before.acmr);
+	CHECK(report.after.atvr >= 1.0f);
+	CHECK(report.after.fetchEfficiency <= 1.0f);
+}
+
+int main()
+{
+	testOptimise();
+	testVertexRemap();
+	testOverdrawThreshold();
+	testNoRegression();
+
+	return checkResult();
+}
\ No newline at end of file
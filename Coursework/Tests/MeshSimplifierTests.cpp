@@ -0,0 +1,360 @@
+#include "MeshSimplifier.h"
+#include "LodSelector.h"
+#include "JobSystem.h"
+#include "Check.h"
+
+#include <array>
+#include <cmath>
+#include <set>
+
+static XMFLOAT3 getNormal(const std::vector<XMFLOAT3>& positions, const std::vector<unsigned long>& indices, size_t first)
+{
+	XMVECTOR p0 = XMLoadFloat3(&positions[indices[first]]);
+	XMVECTOR p1 = XMLoadFloat3(&positions[indices[first + 1]]);
+	XMVECTOR p2 = XMLoadFloat3(&positions[indices[first + 2]]);
+	XMFLOAT3 normal;
+	XMStoreFloat3(&normal, XMVector3Cross(XMVectorSubtract(p1, p0), XMVectorSubtract(p2, p0)));
+
+	return normal;
+}
+
+//A welded UV sphere, one vertex at each pole and the first column reused to close it, facing outwards
+static void buildSphere(int rings, int segments, std::vector<XMFLOAT3>& positions, std::vector<unsigned long>& indices)
+{
+	positions.push_back(XMFLOAT3(0.0f, 1.0f, 0.0f));
+
+	for (int ring = 1; ring < rings; ring++)
+	{
+		float theta = XM_PI * (float)ring / (float)rings;
+
+		for (int segment = 0; segment < segments; segment++)
+		{
+			float phi = XM_2PI * (float)segment / (float)segments;
+			positions.push_back(XMFLOAT3(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi)));
+		}
+	}
+
+	positions.push_back(XMFLOAT3(0.0f, -1.0f, 0.0f));
+	unsigned long south = (unsigned long)positions.size() - 1;
+
+	auto ringVertex = [&](int ring, int segment)
+	{
+		return (unsigned long)(1 + ((ring - 1) * segments) + (segment % segments));
+	};
+
+	for (int segment = 0; segment < segments; segment++)
+	{
+		indices.insert(indices.end(), { 0, ringVertex(1, segment + 1), ringVertex(1, segment) });
+		indices.insert(indices.end(), { south, ringVertex(rings - 1, segment), ringVertex(rings - 1, segment + 1) });
+	}
+
+	for (int ring = 1; ring + 1 < rings; ring++)
+	{
+		for (int segment = 0; segment < segments; segment++)
+		{
+			unsigned long a = ringVertex(ring, segment);
+			unsigned long b = ringVertex(ring, segment + 1);
+			unsigned long c = ringVertex(ring + 1, segment);
+			unsigned long d = ringVertex(ring + 1, segment + 1);
+			indices.insert(indices.end(), { a, b, d });
+			indices.insert(indices.end(), { a, d, c });
+		}
+	}
+}
+
+//A bumpy height field of size x size quads facing up. The row of vertices at z = size / 2 is doubled up, as a UV seam is, and
+//the quads below it use the second copy, which starts at the returned index.
+static unsigned long buildSeamGrid(int size, std::vector<XMFLOAT3>& positions, std::vector<unsigned long>& indices)
+{
+	auto height = [](int x, int z)
+	{
+		return 0.6f * sinf((float)x * 0.7f) * cosf((float)z * 0.45f);
+	};
+
+	for (int z = 0; z <= size; z++)
+	{
+		for (int x = 0; x <= size; x++)
+		{
+			positions.push_back(XMFLOAT3((float)x, height(x, z), (float)z));
+		}
+	}
+
+	unsigned long seam = (unsigned long)positions.size();
+
+	for (int x = 0; x <= size; x++)
+	{
+		positions.push_back(XMFLOAT3((float)x, height(x, size / 2), (float)(size / 2)));
+	}
+
+	for (int z = 0; z < size; z++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			unsigned long bottomLeft = (unsigned long)((z * (size + 1)) + x);
+			unsigned long topLeft = z + 1 == size / 2 ? seam + x : bottomLeft + size + 1;
+			indices.insert(indices.end(), { bottomLeft, topLeft, topLeft + 1 });
+			indices.insert(indices.end(), { bottomLeft, topLeft + 1, bottomLeft + 1 });
+		}
+	}
+
+	return seam;
+}
+
+//Every level of the chain of a closed sphere reaches its target, and the sphere still faces outwards all over
+static void testTargetsAndFlips()
+{
+	std::vector<XMFLOAT3> positions;
+	std::vector<unsigned long> indices;
+	buildSphere(24, 48, positions, indices);
+
+	int triangleCount = (int)indices.size() / 3;
+	const std::vector<float> ratios = { 0.5f, 0.25f, 0.1f, 0.05f };
+	std::vector<MeshSimplifier::Level> levels = MeshSimplifier::buildChain(positions, indices, ratios, false);
+
+	CHECK(levels.size() == ratios.size());
+
+	for (size_t i = 0; i < levels.size(); i++)
+	{
+		int target = (int)((float)triangleCount * ratios[i]);
+		const MeshSimplifier::Level& level = levels[i];
+
+		CHECK(level.triangles == (int)level.indices.size() / 3);
+		CHECK(level.triangles <= target);
+		CHECK(level.triangles >= target - 2);
+		CHECK(level.error >= 0.0f && level.error < 0.5f);
+
+		for (size_t j = 0; j < level.indices.size(); j += 3)
+		{
+			XMFLOAT3 normal = getNormal(positions, level.indices, j);
+			const XMFLOAT3& corner = positions[level.indices[j]];
+			CHECK((normal.x * corner.x) + (normal.y * corner.y) + (normal.z * corner.z) > 0.0f);
+		}
+	}
+}
+
+//Collapses along a seam move both of its sides to the same position, so no crack opens between them, and a bumpy
+//height field keeps every triangle facing up
+static void testSeam()
+{
+	const int size = 16;
+	std::vector<XMFLOAT3> positions;
+	std::vector<unsigned long> indices;
+	unsigned long seam = buildSeamGrid(size, positions, indices);
+	unsigned long firstRow = (unsigned long)((size / 2) * (size + 1));
+
+	auto isFirstCopy = [&](unsigned long vertex) { return vertex >= firstRow && vertex <= firstRow + size; };
+	auto isSecondCopy = [&](unsigned long vertex) { return vertex >= seam; };
+
+	for (float ratio : { 0.5f, 0.25f, 0.1f })
+	{
+		MeshSimplifier::Level level = MeshSimplifier::simplify(positions, indices, (int)((float)(indices.size() / 3) * ratio), false);
+		std::set<int> firstSide;
+		std::set<int> secondSide;
+
+		for (size_t i = 0; i < level.indices.size(); i += 3)
+		{
+			bool first = false;
+			bool second = false;
+
+			for (int k = 0; k < 3; k++)
+			{
+				unsigned long vertex = level.indices[i + k];
+
+				if (isFirstCopy(vertex))
+				{
+					first = true;
+					firstSide.insert((int)positions[vertex].x);
+				}
+
+				if (isSecondCopy(vertex))
+				{
+					second = true;
+					secondSide.insert((int)positions[vertex].x);
+				}
+			}
+
+			//A triangle keeps the side of the seam it started on
+			CHECK(!(first && second));
+			CHECK(getNormal(positions, level.indices, i).y > 0.0f);
+		}
+
+		CHECK(firstSide == secondSide);
+		CHECK((int)firstSide.size() < size + 1);
+		CHECK(firstSide.count(0) == 1 && firstSide.count(size) == 1);
+	}
+}
+
+//The southern half of a sphere is a triangle soup, every triangle with vertices of its own as a flat shaded mesh's are. Its
+//positions have too many vertices to collapse, so the simplifier stops short of the target with the soup untouched.
+static void testLockedVertices()
+{
+	std::vector<XMFLOAT3> positions;
+	std::vector<unsigned long> indices;
+	std::set<std::array<unsigned long, 3>> soup;
+	buildSphere(16, 32, positions, indices);
+
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		if (positions[indices[i]].y + positions[indices[i + 1]].y + positions[indices[i + 2]].y >= 0.0f)
+		{
+			continue;
+		}
+
+		for (int k = 0; k < 3; k++)
+		{
+			positions.push_back(positions[indices[i + k]]);
+			indices[i + k] = (unsigned long)positions.size() - 1;
+		}
+
+		soup.insert({ indices[i], indices[i + 1], indices[i + 2] });
+	}
+
+	int triangleCount = (int)indices.size() / 3;
+	int northCount = triangleCount - (int)soup.size();
+	MeshSimplifier::Level level = MeshSimplifier::simplify(positions, indices, triangleCount / 10, false);
+
+	CHECK(level.triangles > triangleCount / 10);
+	CHECK(level.triangles < (int)soup.size() + (northCount / 2));
+
+	int soupLeft = 0;
+
+	for (size_t i = 0; i < level.indices.size(); i += 3)
+	{
+		soupLeft += soup.count({ level.indices[i], level.indices[i + 1], level.indices[i + 2] }) ? 1 : 0;
+	}
+
+	CHECK(soupLeft == (int)soup.size());
+}
+
+//The levels are the same built one after another on this thread and in parallel on the job system
+static void testChainThreading()
+{
+	std::vector<XMFLOAT3> positions;
+	std::vector<unsigned long> indices;
+	buildSphere(32, 64, positions, indices);
+
+	std::vector<XMFLOAT3> gridPositions;
+	std::vector<unsigned long> gridIndices;
+	buildSeamGrid(32, gridPositions, gridIndices);
+
+	const std::vector<float> ratios = { 0.5f, 0.25f, 0.1f };
+
+	JobSystem jobs(3);
+	JobSystem::setShared(&jobs);
+
+	std::vector<MeshSimplifier::Level> single = MeshSimplifier::buildChain(positions, indices, ratios, false);
+	std::vector<MeshSimplifier::Level> multi = MeshSimplifier::buildChain(positions, indices, ratios, true);
+	std::vector<MeshSimplifier::Level> gridSingle = MeshSimplifier::buildChain(gridPositions, gridIndices, ratios, false);
+	std::vector<MeshSimplifier::Level> gridMulti = MeshSimplifier::buildChain(gridPositions, gridIndices, ratios, true);
+
+	//The collapses of one level costed in parallel too
+	MeshSimplifier::Level costedSingle = MeshSimplifier::simplify(positions, indices, (int)indices.size() / 12, false);
+	MeshSimplifier::Level costedMulti = MeshSimplifier::simplify(positions, indices, (int)indices.size() / 12, true);
+
+	JobSystem::setShared(nullptr);
+
+	for (size_t i = 0; i < ratios.size(); i++)
+	{
+		CHECK(single[i].indices == multi[i].indices);
+		CHECK(single[i].error == multi[i].error);
+		CHECK(gridSingle[i].indices == gridMulti[i].indices);
+	}
+
+	CHECK(costedSingle.indices == costedMulti.indices);
+}
+
+//A model hovering at a switch stays on one level until it is past the switch by the hysteresis, and the levels follow the
+//size down and back up again without skipping
+static void testSelectionHysteresis()
+{
+	const float fullDetailPixels = 600.0f;
+	const float hysteresis = 0.1f;
+
+	LodSelector selector;
+	selector.setLevelTriangles({ 4000, 2000, 1000, 400 });
+
+	CHECK(selector.getLevelCount() == 4);
+	CHECK(selector.getLevel() == 0);
+	CHECK_NEAR(selector.getSwitchPixels(0, fullDetailPixels), fullDetailPixels, 0.001f);
+	CHECK_NEAR(selector.getSwitchPixels(1, fullDetailPixels), fullDetailPixels * sqrtf(0.5f), 0.001f);
+	CHECK_NEAR(selector.getSwitchPixels(3, fullDetailPixels), fullDetailPixels * sqrtf(0.1f), 0.001f);
+
+	//Jitter within the band either side of each switch never changes level, whichever side it was reached from
+	for (int switchLevel = 1; switchLevel < selector.getLevelCount(); switchLevel++)
+	{
+		float switchPixels = selector.getSwitchPixels(switchLevel, fullDetailPixels);
+
+		for (int fromLevel : { switchLevel - 1, switchLevel })
+		{
+			selector.setLevel(fromLevel);
+			int changes = 0;
+
+			for (int frame = 0; frame < 200; frame++)
+			{
+				float jitter = (hysteresis * 0.95f) * ((frame % 2) == 0 ? 1.0f : -1.0f) * ((float)(frame % 7) / 6.0f);
+				int before = selector.getLevel();
+				changes += selector.selectLevel(switchPixels * (1.0f + jitter), fullDetailPixels, hysteresis) != before ? 1 : 0;
+			}
+
+			CHECK(changes == 0);
+			CHECK(selector.getLevel() == fromLevel);
+		}
+	}
+
+	//Shrinking steadily steps coarser one level at a time, each once it is past its switch's band
+	selector.setLevel(0);
+	int previous = 0;
+
+	for (float pixels = 700.0f; pixels > 50.0f; pixels -= 1.0f)
+	{
+		int selected = selector.selectLevel(pixels, fullDetailPixels, hysteresis);
+		CHECK(selected == previous || selected == previous + 1);
+
+		if (selected != previous)
+		{
+			CHECK(pixels < selector.getSwitchPixels(selected, fullDetailPixels) * (1.0f - hysteresis));
+			CHECK(pixels >= selector.getSwitchPixels(selected, fullDetailPixels) * (1.0f - hysteresis) - 1.0f);
+		}
+
+		previous = selected;
+	}
+
+	CHECK(previous == 3);
+
+	//Growing back steps finer the same way, at the top of each band rather than the bottom
+	for (float pixels = 50.0f; pixels < 700.0f; pixels += 1.0f)
+	{
+		int selected = selector.selectLevel(pixels, fullDetailPixels, hysteresis);
+		CHECK(selected == previous || selected == previous - 1);
+
+		if (selected != previous)
+		{
+			CHECK(pixels > selector.getSwitchPixels(previous, fullDetailPixels) * (1.0f + hysteresis));
+		}
+
+		previous = selected;
+	}
+
+	CHECK(previous == 0);
+
+	//A sudden jump goes straight to the level for the new size
+	selector.setLevel(0);
+	CHECK(selector.selectLevel(10.0f, fullDetailPixels, hysteresis) == 3);
+	CHECK(selector.selectLevel(1000.0f, fullDetailPixels, hysteresis) == 0);
+
+	selector.setLevel(-1);
+	CHECK(selector.getLevel() == 0);
+	selector.setLevel(10);
+	CHECK(selector.getLevel() == 3);
+}
+
+int main()
+{
+	testTargetsAndFlips();
+	testSeam();
+	testLockedVertices();
+	testChainThreading();
+	testSelectionHysteresis();
+
+	return checkResult();
+}
\ No newline at end of file
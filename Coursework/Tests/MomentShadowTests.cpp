@@ -0,0 +1,173 @@
+#include "MomentShadow.h"
+#include "Check.h"
+
+#include <cmath>
+
+//VSM stores depth and its square, EVSM the positive and negative exponential warps of depth moved to [-1, 1] and their squares
+static void testEncode()
+{
+	XMFLOAT4 vsm = MomentShadow::encode(0.3f, MomentShadow::MODE_VSM);
+	CHECK_NEAR(vsm.x, 0.3f, 1e-7f);
+	CHECK_NEAR(vsm.y, 0.09f, 1e-7f);
+	CHECK(vsm.z == 0.0f && vsm.w == 0.0f);
+
+	//The middle of the range warps to e^0 for both
+	XMFLOAT4 middle = MomentShadow::encode(0.5f, MomentShadow::MODE_EVSM);
+	CHECK_NEAR(middle.x, 1.0f, 1e-6f);
+	CHECK_NEAR(middle.y, 1.0f, 1e-6f);
+	CHECK_NEAR(middle.z, -1.0f, 1e-6f);
+	CHECK_NEAR(middle.w, 1.0f, 1e-6f);
+
+	//The far end must still square inside 32 bit float range
+	XMFLOAT4 far = MomentShadow::encode(1.0f, MomentShadow::MODE_EVSM);
+	CHECK_NEAR(far.x / expf(MomentShadow::POSITIVE_EXPONENT), 1.0f, 1e-5f);
+	CHECK(std::isfinite(far.y));
+	CHECK_NEAR(far.z, -expf(-MomentShadow::NEGATIVE_EXPONENT), 1e-7f);
+
+	XMFLOAT4 near = MomentShadow::encode(0.0f, MomentShadow::MODE_EVSM);
+	CHECK_NEAR(near.x, expf(-MomentShadow::POSITIVE_EXPONENT), 1e-20f);
+	CHECK_NEAR(near.z / -expf(MomentShadow::NEGATIVE_EXPONENT), 1.0f, 1e-5f);
+}
+
+//The blur is two normalised gaussian passes, so it leaves a flat map alone and spreads a single texel into the outer product of the kernel
+static void testBlur()
+{
+	const int size = 16;
+	const int radius = 3;
+	const float deviation = 1.5f;
+
+	ShadowFilter::DepthMap map;
+	map.width = size;
+	map.height = size;
+	map.depths.assign(size * size, 0.25f);
+
+	MomentShadow flat(MomentShadow::MODE_VSM);
+	flat.encodeDepthMap(map);
+	flat.blur(radius, deviation);
+
+	for (const XMFLOAT4& moments : flat.getMoments())
+	{
+		CHECK_NEAR(moments.x, 0.25f, 1e-6f);
+		CHECK_NEAR(moments.y, 0.0625f, 1e-6f);
+	}
+
+	map.depths.assign(size * size, 0.0f);
+	map.depths[(8 * size) + 8] = 1.0f;
+
+	MomentShadow spike(MomentShadow::MODE_VSM);
+	spike.encodeDepthMap(map);
+	spike.blur(radius, deviation);
+
+	float weights[2 * radius + 1];
+	float kernelSum = 0.0f;
+
+	for (int i = -radius; i <= radius; i++)
+	{
+		weights[i + radius] = expf(-(float)(i * i) / (2.0f * deviation * deviation));
+		kernelSum += weights[i + radius];
+	}
+
+	float total = 0.0f;
+
+	for (int y = 0; y < size; y++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			int dx = x - 8;
+			int dy = y - 8;
+			float expected = 0.0f;
+
+			if (abs(dx) <= radius && abs(dy) <= radius)
+			{
+				expected = (weights[dx + radius] / kernelSum) * (weights[dy + radius] / kernelSum);
+			}
+
+			CHECK_NEAR(spike.getMoments()[(y * size) + x].x, expected, 1e-6f);
+			total += spike.getMoments()[(y * size) + x].x;
+		}
+	}
+
+	CHECK_NEAR(total, 1.0f, 1e-5f);
+
+	//No blur leaves the moments as encoded
+	MomentShadow unblurred(MomentShadow::MODE_VSM);
+	unblurred.encodeDepthMap(map);
+	unblurred.blur(0, deviation);
+	CHECK(unblurred.getMoments()[(8 * size) + 8].x == 1.0f);
+}
+
+//The one tailed Chebyshev bound, with its variance floor and the bleeding reduction's linear step
+static void testChebyshev()
+{
+	//Mean 0.5 and variance 0.01, a receiver 0.1 behind the mean is lit by at most 0.01 / (0.01 + 0.1^2)
+	XMFLOAT2 moments(0.5f, 0.26f);
+	CHECK(MomentShadow::chebyshevUpperBound(moments, 0.4f, 0.0f, 0.0f) == 1.0f);
+	CHECK(MomentShadow::chebyshevUpperBound(moments, 0.5f, 0.0f, 0.0f) == 1.0f);
+	CHECK_NEAR(MomentShadow::chebyshevUpperBound(moments, 0.6f, 0.0f, 0.0f), 0.5f, 1e-5f);
+	CHECK_NEAR(MomentShadow::chebyshevUpperBound(moments, 0.7f, 0.0f, 0.0f), 0.01f / 0.05f, 1e-5f);
+
+	//(pMax - reduction) / (1 - reduction), clamped at zero
+	CHECK_NEAR(MomentShadow::chebyshevUpperBound(moments, 0.6f, 0.0f, 0.2f), 0.375f, 1e-5f);
+	CHECK(MomentShadow::chebyshevUpperBound(moments, 0.7f, 0.0f, 0.3f) == 0.0f);
+
+	//A single depth has no variance, the floor keeps the bound from dropping straight to zero
+	XMFLOAT2 single(0.5f, 0.25f);
+	CHECK_NEAR(MomentShadow::chebyshevUpperBound(single, 0.51f, 0.0001f, 0.0f), 0.0001f / (0.0001f + 0.0001f), 1e-4f);
+	CHECK(MomentShadow::chebyshevUpperBound(single, 0.6f, 0.0f, 0.0f) == 0.0f);
+}
+
+//Unblurred moments give a hard depth test, for both modes
+static void testVisibility()
+{
+	ShadowFilter::DepthMap map = ShadowFilter::buildTestDepthMap(64, 0.6f, 0.3f);
+
+	for (MomentShadow::Mode mode : { MomentShadow::MODE_VSM, MomentShadow::MODE_EVSM })
+	{
+		MomentShadow moments(mode);
+		moments.setBleedReduction(0.0f);
+		moments.encodeDepthMap(map);
+
+		CHECK_NEAR(moments.visibility(XMFLOAT2(0.9f, 0.1f), 0.598f), 1.0f, 1e-6f);
+		CHECK(moments.visibility(XMFLOAT2(0.3f, 0.5f), 0.598f) < 0.01f);
+		CHECK_NEAR(moments.visibility(XMFLOAT2(0.3f, 0.5f), 0.29f), 1.0f, 1e-6f);
+	}
+}
+
+//Two overlapping occluders, where VSM leaks light through the umbra of the lower one. EVSM's warp and the bleeding reduction cut it back.
+static void testLightBleeding()
+{
+	ShadowFilter::DepthMap map = MomentShadow::buildBleedingTestMap(256, 0.8f);
+	MomentShadow::BleedingResult results[2][2];
+
+	for (int mode = 0; mode < 2; mode++)
+	{
+		for (int reduction = 0; reduction < 2; reduction++)
+		{
+			MomentShadow moments((MomentShadow::Mode)mode);
+			moments.setBleedReduction(reduction == 0 ? 0.0f : 0.2f);
+			moments.encodeDepthMap(map);
+			moments.blur(3, 1.5f);
+
+			results[mode][reduction] = moments.measureLightBleeding(map, 0.8f, 0.002f);
+			std::printf("%s, reduction %.1f: mean %.4f, max %.4f over %.0f texels\n", mode == 0 ? "VSM" : "EVSM", reduction == 0 ? 0.0f : 0.2f,
+				results[mode][reduction].meanBleeding, results[mode][reduction].maxBleeding, results[mode][reduction].shadowedTexels);
+		}
+	}
+
+	CHECK(results[0][0].shadowedTexels > 0.0f);
+	CHECK(results[0][0].maxBleeding > 0.1f);
+	CHECK(results[1][0].maxBleeding < results[0][0].maxBleeding);
+	CHECK(results[0][1].meanBleeding < results[0][0].meanBleeding);
+	CHECK(results[1][1].meanBleeding <= results[1][0].meanBleeding);
+}
+
+int main()
+{
+	testEncode();
+	testBlur();
+	testChebyshev();
+	testVisibility();
+	testLightBleeding();
+
+	return checkResult();
+}
\ No newline at end of file
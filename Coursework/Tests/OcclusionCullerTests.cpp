@@ -0,0 +1,193 @@
+#include "OcclusionCuller.h"
+#include "JobSystem.h"
+#include "Check.h"
+
+#include <random>
+
+static const XMFLOAT3 QUAD[4] = { XMFLOAT3(-1.0f, -1.0f, 0.0f), XMFLOAT3(1.0f, -1.0f, 0.0f), XMFLOAT3(-1.0f, 1.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 0.0f) };
+static const unsigned int QUAD_INDICES[6] = { 0, 2, 1, 1, 2, 3 };
+
+static const XMFLOAT3 CUBE[8] =
+{
+	XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 1.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 0.0f),
+	XMFLOAT3(0.0f, 0.0f, 1.0f), XMFLOAT3(1.0f, 0.0f, 1.0f), XMFLOAT3(0.0f, 1.0f, 1.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)
+};
+static const unsigned int CUBE_INDICES[36] =
+{
+	0, 2, 1, 1, 2, 3,	4, 5, 6, 5, 7, 6,	0, 4, 2, 2, 4, 6,
+	1, 3, 5, 5, 3, 7,	0, 1, 4, 1, 5, 4,	2, 6, 3, 3, 6, 7
+};
+
+//From the origin along z, with the benchmark's field of view and aspect
+static XMMATRIX forwardView()
+{
+	XMMATRIX view = XMMatrixLookToLH(XMVectorZero(), XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+	return view * XMMatrixPerspectiveFovLH(XM_PI / 3.0f, 2.0f, 0.1f, 200.0f);
+}
+
+//A twenty unit wall twenty units away hides what is squarely behind it, and nothing in front of it, beside it or peeking over it
+static void testWall()
+{
+	XMMATRIX viewProjection = forwardView();
+	OcclusionCuller culler;
+	CHECK(culler.getWidth() == 256 && culler.getHeight() == 128);
+
+	culler.beginFrame(viewProjection);
+	culler.addOccluder(QUAD, 4, QUAD_INDICES, 6, XMMatrixScaling(10.0f, 10.0f, 1.0f) * XMMatrixTranslation(0.0f, 0.0f, 20.0f));
+	culler.rasterise(false);
+	CHECK(culler.getStats().occluderTriangles == 2);
+	CHECK(culler.getStats().rasterisedTriangles > 0);
+
+	CHECK(!culler.boxVisible(XMFLOAT3(-2.0f, -2.0f, 30.0f), XMFLOAT3(2.0f, 2.0f, 34.0f)));
+	//Wide enough to be tested further up the hierarchical-Z pyramid
+	CHECK(!culler.boxVisible(XMFLOAT3(-8.0f, -8.0f, 100.0f), XMFLOAT3(8.0f, 8.0f, 110.0f)));
+	CHECK(culler.boxVisible(XMFLOAT3(-2.0f, -2.0f, 10.0f), XMFLOAT3(2.0f, 2.0f, 14.0f)));
+	CHECK(culler.boxVisible(XMFLOAT3(-2.0f, -2.0f, 18.0f), XMFLOAT3(2.0f, 2.0f, 22.0f)));
+	CHECK(culler.boxVisible(XMFLOAT3(28.0f, -2.0f, 40.0f), XMFLOAT3(32.0f, 2.0f, 44.0f)));
+	CHECK(culler.boxVisible(XMFLOAT3(-2.0f, 12.0f, 30.0f), XMFLOAT3(2.0f, 18.0f, 34.0f)));
+
+	//The centre pixel holds the wall's projected depth
+	XMFLOAT4 clip;
+	XMStoreFloat4(&clip, XMVector4Transform(XMVectorSet(0.0f, 0.0f, 20.0f, 1.0f), viewProjection));
+	float centre = culler.getDepth()[(64 * culler.getWidth()) + 128];
+	CHECK_NEAR(centre, clip.z / clip.w, 1e-5f);
+
+	//Nothing drawn leaves the buffer at the far plane, so everything is visible
+	culler.beginFrame(viewProjection);
+	culler.rasterise(false);
+	CHECK(culler.getStats().occluderTriangles == 0);
+	CHECK(culler.getDepth()[(64 * culler.getWidth()) + 128] == 1.0f);
+	CHECK(culler.boxVisible(XMFLOAT3(-2.0f, -2.0f, 30.0f), XMFLOAT3(2.0f, 2.0f, 34.0f)));
+}
+
+//A triangle reaching behind the camera is left out rather than clipped, so it hides nothing
+static void testNearPlane()
+{
+	OcclusionCuller culler;
+	culler.beginFrame(forwardView());
+	culler.addOccluder(QUAD, 4, QUAD_INDICES, 6, XMMatrixScaling(10.0f, 10.0f, 1.0f) * XMMatrixRotationX(XM_PIDIV4) * XMMatrixTranslation(0.0f, 0.0f, 2.0f));
+	culler.rasterise(false);
+	CHECK(culler.getStats().occluderTriangles == 2);
+	CHECK(culler.getStats().rasterisedTriangles == 0);
+	CHECK(culler.boxVisible(XMFLOAT3(-1.0f, -1.0f, 30.0f), XMFLOAT3(1.0f, 1.0f, 31.0f)));
+
+	//A box reaching in front of the near plane is always visible
+	culler.beginFrame(forwardView());
+	culler.addOccluder(QUAD, 4, QUAD_INDICES, 6, XMMatrixScaling(100.0f, 100.0f, 1.0f) * XMMatrixTranslation(0.0f, 0.0f, 5.0f));
+	culler.rasterise(false);
+	CHECK(culler.boxVisible(XMFLOAT3(-1.0f, -1.0f, -1.0f), XMFLOAT3(1.0f, 1.0f, 30.0f)));
+}
+
+//Buildings on a grid, seen from the benchmark's street corner
+static void drawCity(OcclusionCuller& culler, XMMATRIX& viewProjection, bool multithreaded)
+{
+	std::mt19937 random(2);
+	std::uniform_real_distribution<float> height(6.0f, 40.0f);
+	XMMATRIX view = XMMatrixLookToLH(XMVectorSet(-2.0f, 1.8f, -2.0f, 1.0f), XMVectorSet(1.0f, 0.0f, 1.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+	viewProjection = view * XMMatrixPerspectiveFovLH(XM_PI / 3.0f, 2.0f, 0.1f, 300.0f);
+
+	culler.beginFrame(viewProjection);
+
+	for (int z = 0; z < 16; z++)
+	{
+		for (int x = 0; x < 16; x++)
+		{
+			culler.addOccluder(CUBE, 8, CUBE_INDICES, 36, XMMatrixScaling(8.0f, height(random), 8.0f) * XMMatrixTranslation((x * 12.0f) + 2.0f, 0.0f, (z * 12.0f) + 2.0f));
+		}
+	}
+
+	culler.rasterise(multithreaded);
+}
+
+//A tile per thread draws the same buffer as one thread, so the boxes tested against it are culled alike
+static void testThreadedMatchesSingle()
+{
+	JobSystem jobs(3);
+	JobSystem::setShared(&jobs);
+
+	OcclusionCuller single, multi;
+	XMMATRIX viewProjection;
+	drawCity(single, viewProjection, false);
+	drawCity(multi, viewProjection, true);
+	CHECK(single.getDepth() == multi.getDepth());
+	CHECK(single.getStats().rasterisedTriangles == multi.getStats().rasterisedTriangles);
+
+	std::mt19937 random(3);
+	std::uniform_real_distribution<float> position(0.0f, 190.0f);
+	int differences = 0;
+
+	for (int i = 0; i < 1000; i++)
+	{
+		XMFLOAT3 minimum(position(random), 0.0f, position(random));
+		XMFLOAT3 maximum(minimum.x + 1.0f, 1.0f, minimum.z + 1.0f);
+		differences += single.boxVisible(minimum, maximum) != multi.boxVisible(minimum, maximum) ? 1 : 0;
+	}
+
+	CHECK(differences == 0);
+
+	JobSystem::setShared(nullptr);
+}
+
+//Every box the culler hides really is hidden: each point sampled through it projects behind the depth the buffer holds there
+static void testConservative()
+{
+	OcclusionCuller culler;
+	XMMATRIX viewProjection;
+	drawCity(culler, viewProjection, false);
+
+	std::mt19937 random(4);
+	std::uniform_real_distribution<float> position(0.0f, 190.0f);
+	std::uniform_real_distribution<float> size(0.5f, 3.0f);
+	const std::vector<float>& depth = culler.getDepth();
+	int occluded = 0;
+	int wrong = 0;
+
+	for (int i = 0; i < 5000; i++)
+	{
+		float half = size(random);
+		XMFLOAT3 centre(position(random), half, position(random));
+		XMFLOAT3 minimum(centre.x - half, 0.0f, centre.z - half);
+		XMFLOAT3 maximum(centre.x + half, half * 2.0f, centre.z + half);
+
+		if (culler.boxVisible(minimum, maximum))
+		{
+			continue;
+		}
+
+		occluded++;
+
+		for (int sample = 0; sample < 125; sample++)
+		{
+			float u = (float)(sample % 5) / 4.0f;
+			float v = (float)((sample / 5) % 5) / 4.0f;
+			float w = (float)(sample / 25) / 4.0f;
+			XMFLOAT4 clip;
+			XMStoreFloat4(&clip, XMVector4Transform(XMVectorSet(minimum.x + ((maximum.x - minimum.x) * u), minimum.y + ((maximum.y - minimum.y) * v),
+				minimum.z + ((maximum.z - minimum.z) * w), 1.0f), viewProjection));
+
+			int x = (int)((((clip.x / clip.w) * 0.5f) + 0.5f) * (float)culler.getWidth());
+			int y = (int)((0.5f - ((clip.y / clip.w) * 0.5f)) * (float)culler.getHeight());
+
+			if (x < 0 || y < 0 || x >= culler.getWidth() || y >= culler.getHeight())
+			{
+				continue;
+			}
+
+			wrong += depth[(y * culler.getWidth()) + x] > clip.z / clip.w ? 1 : 0;
+		}
+	}
+
+	//Props along the near streets are hidden by the first row of buildings
+	CHECK(occluded > 100);
+	CHECK(wrong == 0);
+}
+
+int main()
+{
+	testWall();
+	testNearPlane();
+	testThreadedMatchesSingle();
+	testConservative();
+
+	return checkResult();
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "RenderStats.h"
+#include "VertexFormats.h"
+#include "VertexPacker.h"
+#include "Check.h"
+
+//The strides sendData() and sendPositionData() return for each layout
+static const unsigned int INTERLEAVED_BYTES = sizeof(VertexFormats::VertexType);
+static const unsigned int STREAM_BYTES = sizeof(XMFLOAT3) + sizeof(XMFLOAT2);
+
+//Draws add up within their pass, and naming a pass the frame already has carries it on rather than starting another
+static void testPasses()
+{
+	RenderStats stats;
+	stats.beginFrame();
+	stats.beginPass("Camera");
+	stats.recordDraw(36, 24, INTERLEAVED_BYTES);
+	stats.beginPass("Shadow map 0");
+	stats.recordDraw(300, 120, STREAM_BYTES);
+	stats.beginPass("Camera");
+	stats.recordDraw(6, 4, INTERLEAVED_BYTES);
+
+	const std::vector<RenderStats::PassStats>& passes = stats.getPasses();
+	CHECK(passes.size() == 2);
+	CHECK(passes[0].name == "Camera");
+	CHECK(passes[0].draws == 2);
+	CHECK(passes[0].triangles == 14);
+	CHECK(passes[0].vertexBytes == 28 * INTERLEAVED_BYTES);
+	CHECK(passes[1].draws == 1);
+	CHECK(passes[1].triangles == 100);
+	CHECK(passes[1].vertexBytes == 120 * STREAM_BYTES);
+
+	//Draws before any pass still count, and a new frame forgets the last
+	stats.beginFrame();
+	CHECK(stats.getPasses().empty());
+	stats.recordDraw(3, 3, INTERLEAVED_BYTES);
+	stats.recordCulling(5, 2, 1);
+	CHECK(stats.getPasses().size() == 1);
+	CHECK(stats.getPasses()[0].name == "Unnamed");
+	CHECK(stats.getPasses()[0].visibleObjects == 5 && stats.getPasses()[0].culledObjects == 2 && stats.getPasses()[0].occludedObjects == 1);
+}
+
+//The four shadow maps of the scene's casters, drawn from the interleaved vertices and then from the position and texture
+//coordinate streams. Streams fetch 20 bytes a vertex rather than 32, with the packed vertices at 16.
+static void testPositionStreamBytes()
+{
+	CHECK(INTERLEAVED_BYTES == 32);
+	CHECK(STREAM_BYTES == 20);
+	CHECK(VertexPacker::getStride(false) == 16);
+
+	//Indices and vertices of the plane, teapot, cube and sphere
+	const int casters[4][2] = { { 60000, 10201 }, { 4704, 792 }, { 36, 24 }, { 2400, 441 } };
+	RenderStats interleaved;
+	RenderStats streams;
+	long long vertices = 0;
+
+	for (int i = 0; i < 4; i++)
+	{
+		interleaved.beginPass("Shadow map " + std::to_string(i));
+		streams.beginPass("Shadow map " + std::to_string(i));
+
+		for (const int* caster : casters)
+		{
+			interleaved.recordDraw(caster[0], caster[1], INTERLEAVED_BYTES);
+			streams.recordDraw(caster[0], caster[1], STREAM_BYTES);
+			vertices += i == 0 ? caster[1] : 0;
+		}
+	}
+
+	CHECK(interleaved.getPasses().size() == 4 && streams.getPasses().size() == 4);
+
+	for (int i = 0; i < 4; i++)
+	{
+		const RenderStats::PassStats& before = interleaved.getPasses()[i];
+		const RenderStats::PassStats& after = streams.getPasses()[i];
+		CHECK(before.draws == 4 && after.draws == 4);
+		CHECK(before.triangles == after.triangles);
+		CHECK(before.vertexBytes == vertices * 32);
+		CHECK(after.vertexBytes == vertices * 20);
+	}
+}
+
+//Shadow maps recorded on their own threads into stats of their own add up to the same frame as recording them all in one
+static void testMerge()
+{
+	RenderStats single;
+	RenderStats perThread[4];
+	single.beginFrame();
+	single.beginPass("Camera");
+	single.recordDraw(36, 24, INTERLEAVED_BYTES);
+	single.recordCulling(3, 1);
+
+	RenderStats merged = single;
+
+	for (int i = 0; i < 4; i++)
+	{
+		std::string name = "Shadow map " + std::to_string(i);
+		single.beginPass(name);
+		perThread[i].beginFrame();
+		perThread[i].beginPass(name);
+
+		for (int draw = 0; draw <= i; draw++)
+		{
+			single.recordDraw(300, 100 + i, STREAM_BYTES);
+			perThread[i].recordDraw(300, 100 + i, STREAM_BYTES);
+		}
+
+		single.recordCulling(i, 4 - i, 1);
+		perThread[i].recordCulling(i, 4 - i, 1);
+	}
+
+	for (int i = 3; i >= 0; i--)
+	{
+		merged.merge(perThread[i]);
+	}
+
+	CHECK(merged.getPasses().size() == single.getPasses().size());
+
+	for (const RenderStats::PassStats& pass : single.getPasses())
+	{
+		bool found = false;
+
+		for (const RenderStats::PassStats& other : merged.getPasses())
+		{
+			if (other.name == pass.name)
+			{
+				found = true;
+				CHECK(other.draws == pass.draws);
+				CHECK(other.triangles == pass.triangles);
+				CHECK(other.vertexBytes == pass.vertexBytes);
+				CHECK(other.visibleObjects == pass.visibleObjects);
+				CHECK(other.culledObjects == pass.culledObjects);
+				CHECK(other.occludedObjects == pass.occludedObjects);
+			}
+		}
+
+		CHECK(found);
+	}
+}
+
+int main()
+{
+	testPasses();
+	testPositionStreamBytes();
+	testMerge();
+
+	return checkResult();
+}
\ No newline at end of file
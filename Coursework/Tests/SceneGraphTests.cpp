@@ -0,0 +1,168 @@
+#include "SceneGraph.h"
+#include "JobSystem.h"
+#include "Check.h"
+
+#include <random>
+
+static float maxDifference(const XMMATRIX& a, const XMMATRIX& b)
+{
+	XMFLOAT4X4 first, second;
+	XMStoreFloat4x4(&first, a);
+	XMStoreFloat4x4(&second, b);
+	float difference = 0.0f;
+
+	for (int row = 0; row < 4; row++)
+	{
+		for (int column = 0; column < 4; column++)
+		{
+			difference = fmaxf(difference, fabsf(first.m[row][column] - second.m[row][column]));
+		}
+	}
+
+	return difference;
+}
+
+//A node's world matrix is its scale, rotation and translation followed by its parent's world matrix
+static void testWorldMatrices()
+{
+	SceneGraph scene;
+	XMFLOAT4 turn;
+	XMStoreFloat4(&turn, XMQuaternionRotationRollPitchYaw(0.0f, XM_PIDIV2, 0.0f));
+
+	int root = scene.createNode(-1, XMFLOAT3(10.0f, 0.0f, 0.0f), turn, XMFLOAT3(2.0f, 2.0f, 2.0f));
+	int child = scene.createNode(root, XMFLOAT3(1.0f, 0.0f, 0.0f));
+	int grandchild = scene.createNode(child, XMFLOAT3(0.0f, 1.0f, 0.0f), XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f), XMFLOAT3(0.5f, 0.5f, 0.5f));
+	scene.update(false);
+
+	XMMATRIX rootWorld = XMMatrixScaling(2.0f, 2.0f, 2.0f) * XMMatrixRotationQuaternion(XMLoadFloat4(&turn)) * XMMatrixTranslation(10.0f, 0.0f, 0.0f);
+	XMMATRIX childWorld = XMMatrixTranslation(1.0f, 0.0f, 0.0f) * rootWorld;
+	XMMATRIX grandchildWorld = XMMatrixScaling(0.5f, 0.5f, 0.5f) * XMMatrixTranslation(0.0f, 1.0f, 0.0f) * childWorld;
+	CHECK(maxDifference(scene.getWorldMatrix(root), rootWorld) < 1e-5f);
+	CHECK(maxDifference(scene.getWorldMatrix(child), childWorld) < 1e-5f);
+	CHECK(maxDifference(scene.getWorldMatrix(grandchild), grandchildWorld) < 1e-5f);
+
+	//The child's origin is one unit along x turned a quarter about y and doubled, so two units along -z from the root
+	XMFLOAT3 origin;
+	XMStoreFloat3(&origin, XMVector3TransformCoord(XMVectorZero(), scene.getWorldMatrix(child)));
+	CHECK_NEAR(origin.x, 10.0f, 1e-5f);
+	CHECK_NEAR(origin.z, -2.0f, 1e-5f);
+
+	//A parent created after its child can't be, so the node becomes a root
+	int orphan = scene.createNode(7, XMFLOAT3(0.0f, 0.0f, 0.0f));
+	CHECK(scene.getParent(orphan) == -1);
+	CHECK(scene.getNodeCount() == 4);
+}
+
+//The teapot's node in the application, kept at the baseline's on screen position by scaling before translating
+static void testApplicationScene()
+{
+	SceneGraph scene;
+	int teapot = scene.createNode(-1, XMFLOAT3(0.0f, 5.0f, 2.5f), XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f), XMFLOAT3(0.5f, 0.5f, 0.5f));
+	scene.update(true);
+
+	XMMATRIX baseline = XMMatrixMultiply(XMMatrixTranslation(0.0f, 10.0f, 5.0f), XMMatrixScaling(0.5f, 0.5f, 0.5f));
+	CHECK(maxDifference(scene.getWorldMatrix(teapot), baseline) < 1e-5f);
+}
+
+//Only the changed nodes and their subtrees are recomputed, and an update with nothing changed recomputes nothing
+static void testDirtySubtrees()
+{
+	SceneGraph scene;
+	int root = scene.createNode(-1, XMFLOAT3(0.0f, 0.0f, 0.0f));
+	int left = scene.createNode(root, XMFLOAT3(-1.0f, 0.0f, 0.0f));
+	int right = scene.createNode(root, XMFLOAT3(1.0f, 0.0f, 0.0f));
+	int leftChild = scene.createNode(left, XMFLOAT3(0.0f, -1.0f, 0.0f));
+	int rightChild = scene.createNode(right, XMFLOAT3(0.0f, -1.0f, 0.0f));
+	int other = scene.createNode(-1, XMFLOAT3(5.0f, 0.0f, 0.0f));
+	scene.update(false);
+	CHECK(scene.getLastUpdated() == 6);
+
+	scene.update(false);
+	CHECK(scene.getLastUpdated() == 0);
+	CHECK(!scene.wasUpdated(root));
+
+	scene.setPosition(left, XMFLOAT3(-2.0f, 0.0f, 0.0f));
+	scene.update(false);
+	CHECK(scene.getLastUpdated() == 2);
+	CHECK(scene.wasUpdated(left) && scene.wasUpdated(leftChild));
+	CHECK(!scene.wasUpdated(root) && !scene.wasUpdated(right) && !scene.wasUpdated(rightChild) && !scene.wasUpdated(other));
+
+	XMFLOAT3 origin;
+	XMStoreFloat3(&origin, XMVector3TransformCoord(XMVectorZero(), scene.getWorldMatrix(leftChild)));
+	CHECK_NEAR(origin.x, -2.0f, 1e-6f);
+	CHECK_NEAR(origin.y, -1.0f, 1e-6f);
+
+	//Moving the root carries every node below it, leaving the other root
+	scene.setPosition(root, XMFLOAT3(0.0f, 3.0f, 0.0f));
+	scene.setScale(rightChild, XMFLOAT3(2.0f, 2.0f, 2.0f));
+	scene.update(false);
+	CHECK(scene.getLastUpdated() == 5);
+	CHECK(!scene.wasUpdated(other));
+
+	XMStoreFloat3(&origin, XMVector3TransformCoord(XMVectorZero(), scene.getWorldMatrix(rightChild)));
+	CHECK_NEAR(origin.x, 1.0f, 1e-6f);
+	CHECK_NEAR(origin.y, 2.0f, 1e-6f);
+}
+
+//A graph with depths wide enough to split across threads gives the same matrices as one thread, after full and sparse updates
+static void testThreadedMatchesSingle()
+{
+	JobSystem jobs(3);
+	JobSystem::setShared(&jobs);
+
+	const int nodes = 100000;
+	std::mt19937 random(3);
+	std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+	SceneGraph single, multi;
+
+	for (int i = 0; i < nodes; i++)
+	{
+		int parent = i > 0 ? (i - 1) / 8 : -1;
+		XMFLOAT3 position(offset(random), offset(random), offset(random));
+		XMFLOAT4 rotation;
+		XMStoreFloat4(&rotation, XMQuaternionRotationRollPitchYaw(offset(random), offset(random), offset(random)));
+		single.createNode(parent, position, rotation);
+		multi.createNode(parent, position, rotation);
+	}
+
+	single.update(false);
+	multi.update(true);
+	CHECK(multi.getLastUpdated() == nodes);
+
+	std::uniform_int_distribution<int> pick(0, nodes - 1);
+
+	for (int i = 0; i < 1000; i++)
+	{
+		int node = pick(random);
+		XMFLOAT3 position(offset(random), offset(random), offset(random));
+		single.setPosition(node, position);
+		multi.setPosition(node, position);
+	}
+
+	single.update(false);
+	multi.update(true);
+	CHECK(single.getLastUpdated() == multi.getLastUpdated());
+	CHECK(multi.getLastUpdated() < nodes);
+
+	float difference = 0.0f;
+
+	for (int i = 0; i < nodes; i++)
+	{
+		difference = fmaxf(difference, maxDifference(single.getWorldMatrix(i), multi.getWorldMatrix(i)));
+		CHECK(single.wasUpdated(i) == multi.wasUpdated(i));
+	}
+
+	CHECK(difference == 0.0f);
+
+	JobSystem::setShared(nullptr);
+}
+
+int main()
+{
+	testWorldMatrices();
+	testApplicationScene();
+	testDirtySubtrees();
+	testThreadedMatchesSingle();
+
+	return checkResult();
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "ShadowFilter.h"
+#include "Check.h"
+
+#include <cmath>
+
+//The disks stay inside the unit circle and keep their samples apart, and the same seed always gives the same disk
+static void testPoissonDisk()
+{
+	ShadowFilter filter;
+
+	for (int count : { 8, 16, 32, 64 })
+	{
+		filter.generatePoissonDisk(count);
+		const std::vector<XMFLOAT2>& disk = filter.getPoissonDisk();
+
+		CHECK((int)disk.size() == count);
+		CHECK(filter.getSampleCount() == count);
+
+		float closest = 2.0f;
+
+		for (size_t i = 0; i < disk.size(); i++)
+		{
+			CHECK((disk[i].x * disk[i].x) + (disk[i].y * disk[i].y) <= 1.0f);
+
+			for (size_t j = i + 1; j < disk.size(); j++)
+			{
+				float dx = disk[i].x - disk[j].x;
+				float dy = disk[i].y - disk[j].y;
+				closest = fminf(closest, sqrtf((dx * dx) + (dy * dy)));
+			}
+		}
+
+		//The generator starts at sqrt(2 / count) and only relaxes it when a sample can't be placed
+		std::printf("%d samples, closest pair %.3f of %.3f\n", count, closest, sqrtf(2.0f / (float)count));
+		CHECK(closest >= 0.5f * sqrtf(2.0f / (float)count));
+	}
+
+	ShadowFilter other;
+	other.generatePoissonDisk(16);
+	filter.generatePoissonDisk(16);
+
+	for (int i = 0; i < 16; i++)
+	{
+		CHECK(other.getPoissonDisk()[i].x == filter.getPoissonDisk()[i].x);
+		CHECK(other.getPoissonDisk()[i].y == filter.getPoissonDisk()[i].y);
+	}
+
+	filter.generatePoissonDisk(1000);
+	CHECK(filter.getSampleCount() == ShadowFilter::MAX_SAMPLES);
+}
+
+//Comparison sampling is bilinear over the four nearest texels, with the border past the edges
+static void testSampleCompare()
+{
+	ShadowFilter::DepthMap map;
+	map.width = 4;
+	map.height = 4;
+	map.depths.assign(16, 0.5f);
+
+	CHECK(map.sampleCompare(XMFLOAT2(0.5f, 0.5f), 0.4f) == 1.0f);
+	CHECK(map.sampleCompare(XMFLOAT2(0.5f, 0.5f), 0.6f) == 0.0f);
+	CHECK(map.load(-1, 0) == 1.0f);
+	CHECK(map.load(4, 3) == 1.0f);
+
+	//Half way between a lit column and a shadowed one
+	for (int y = 0; y < 4; y++)
+	{
+		map.depths[(y * 4) + 2] = 0.2f;
+		map.depths[(y * 4) + 3] = 0.2f;
+	}
+
+	CHECK_NEAR(map.sampleCompare(XMFLOAT2(0.5f, 0.5f), 0.4f), 0.5f, 1e-6f);
+	CHECK_NEAR(map.sampleCompare(XMFLOAT2(0.375f, 0.5f), 0.4f), 1.0f, 1e-6f);
+	CHECK_NEAR(map.sampleCompare(XMFLOAT2(0.625f, 0.5f), 0.4f), 0.0f, 1e-6f);
+}
+
+//Every filter agrees with the grid loop far from an edge, and each makes the number of fetches it should
+static void testFilters()
+{
+	ShadowFilter filter(16, 8);
+	ShadowFilter::DepthMap map = ShadowFilter::buildTestDepthMap(256, 0.6f, 0.3f);
+	XMFLOAT2 lit(0.9f, 0.1f);
+	XMFLOAT2 umbra(0.3f, 0.5f);
+	int samples = 0;
+
+	CHECK(filter.filterGrid(map, lit, 0.6f, 0.002f, 3, samples) == 1.0f);
+	CHECK(samples == 49);
+	CHECK(filter.filterGrid(map, umbra, 0.6f, 0.002f, 3, samples) == 0.0f);
+
+	CHECK(filter.filterPoisson(map, lit, 0.6f, 0.002f, 3.0f, 0.7f, samples) == 1.0f);
+	CHECK(samples == 16);
+	CHECK(filter.filterPoisson(map, umbra, 0.6f, 0.002f, 3.0f, 0.7f, samples) == 0.0f);
+
+	//No blockers ends PCSS after its search
+	CHECK(filter.filterPCSS(map, lit, 0.6f, 0.002f, 3.0f, 0.7f, samples) == 1.0f);
+	CHECK(samples == 8);
+	CHECK(filter.filterPCSS(map, umbra, 0.6f, 0.002f, 3.0f, 0.7f, samples) == 0.0f);
+	CHECK(samples == 8 + 16);
+}
+
+//The Poisson and PCSS filters stay close to the grid loop over the whole test map with far fewer fetches
+static void testCompareWithGrid()
+{
+	ShadowFilter filter(16, 8);
+	ShadowFilter::DepthMap map = ShadowFilter::buildTestDepthMap(256, 0.6f, 0.3f);
+
+	ShadowFilter::ComparisonResult poisson = filter.compareWithGrid(map, 0.6f, 0.002f, 3, ShadowFilter::FILTER_POISSON);
+	std::printf("Poisson: mean %.4f, max %.4f, %.1f samples against %.1f\n", poisson.meanDifference, poisson.maxDifference, poisson.filterSamplesPerPixel, poisson.gridSamplesPerPixel);
+	CHECK(poisson.gridSamplesPerPixel == 49.0f);
+	CHECK(poisson.filterSamplesPerPixel == 16.0f);
+	CHECK(poisson.meanDifference < 0.01f);
+	CHECK(poisson.maxDifference < 0.3f);
+
+	ShadowFilter::ComparisonResult pcss = filter.compareWithGrid(map, 0.6f, 0.002f, 3, ShadowFilter::FILTER_PCSS);
+	std::printf("PCSS: mean %.4f, max %.4f, %.1f samples against %.1f\n", pcss.meanDifference, pcss.maxDifference, pcss.filterSamplesPerPixel, pcss.gridSamplesPerPixel);
+	CHECK(pcss.filterSamplesPerPixel >= 8.0f);
+	CHECK(pcss.filterSamplesPerPixel <= 24.0f);
+	CHECK(pcss.meanDifference < 0.01f);
+}
+
+int main()
+{
+	testPoissonDisk();
+	testSampleCompare();
+	testFilters();
+	testCompareWithGrid();
+
+	return checkResult();
+}
\ No newline at end of file
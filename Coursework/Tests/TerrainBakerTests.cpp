@@ -0,0 +1,256 @@
+#include "TerrainBaker.h"
+#include "JobSystem.h"
+#include "TerrainQuadtree.h"
+#include "DirtyTileTracker.h"
+#include "Check.h"
+
+#include <random>
+
+static float maxComponentDifference(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	return fmaxf(fabsf(a.x - b.x), fmaxf(fabsf(a.y - b.y), fabsf(a.z - b.z)));
+}
+
+//The four wide path matches the scalar reference for every count, including the scalar tail after the last group of four
+static void testSimdMatchesScalar()
+{
+	std::mt19937 generator(3);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	std::vector<float> left(64), right(64), top(64), bottom(64);
+
+	for (int i = 0; i < 64; i++)
+	{
+		left[i] = unit(generator);
+		right[i] = unit(generator);
+		top[i] = unit(generator);
+		bottom[i] = unit(generator);
+	}
+
+	float maxDifference = 0.0f;
+
+	for (int count = 0; count <= 64; count++)
+	{
+		std::vector<XMFLOAT3> simd(count), scalar(count);
+		TerrainBaker::computeNormals(left.data(), right.data(), top.data(), bottom.data(), count, 25.0f, 0.4f, simd.data());
+		TerrainBaker::computeNormalsScalar(left.data(), right.data(), top.data(), bottom.data(), count, 25.0f, 0.4f, scalar.data());
+
+		for (int i = 0; i < count; i++)
+		{
+			maxDifference = fmaxf(maxDifference, maxComponentDifference(simd[i], scalar[i]));
+		}
+	}
+
+	CHECK(maxDifference < 1e-5f);
+}
+
+//Central differences of a flat field point straight up, and of a ramp in x lean back against the slope
+static void testAnalyticNormals()
+{
+	const int size = 32;
+	const float amplitude = 10.0f;
+	const float cellSize = 0.5f;
+	const float slope = 0.01f;
+
+	HeightField flat(size, size);
+	HeightField ramp(size, size);
+
+	for (int y = 0; y < size; y++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			flat.setSample(x, y, 0.25f);
+			ramp.setSample(x, y, 0.1f + (slope * (float)x));
+		}
+	}
+
+	std::vector<uint32_t> normals(size * size);
+	TerrainBaker::bakeNormalMap(flat, amplitude, cellSize, normals.data(), true, false);
+
+	bool allUp = true;
+
+	for (uint32_t packed : normals)
+	{
+		allUp = allUp && maxComponentDifference(TerrainBaker::unpackNormal(packed), XMFLOAT3(0.0f, 1.0f, 0.0f)) < 1.0f / 127.0f;
+	}
+
+	CHECK(allUp);
+
+	TerrainBaker::bakeNormalMap(ramp, amplitude, cellSize, normals.data(), true, false);
+
+	//Rise of amplitude * slope per cell of cellSize
+	XMFLOAT3 expected;
+	XMStoreFloat3(&expected, XMVector3Normalize(XMVectorSet(-2.0f * slope * amplitude, 2.0f * cellSize, 0.0f, 0.0f)));
+	CHECK(maxComponentDifference(TerrainBaker::unpackNormal(normals[(16 * size) + 16]), expected) < 1.0f / 127.0f);
+
+	//The edges read their own height in place of the missing neighbour, halving the difference
+	XMStoreFloat3(&expected, XMVector3Normalize(XMVectorSet(-slope * amplitude, 2.0f * cellSize, 0.0f, 0.0f)));
+	CHECK(maxComponentDifference(TerrainBaker::unpackNormal(normals[16 * size]), expected) < 1.0f / 127.0f);
+}
+
+//Eight bits per channel of the R8G8B8A8_UNORM map, so half a step of error at most, with alpha full
+static void testPacking()
+{
+	std::mt19937 generator(5);
+	std::normal_distribution<float> gaussian(0.0f, 1.0f);
+
+	float maxDifference = 0.0f;
+
+	for (int i = 0; i < 1000; i++)
+	{
+		XMFLOAT3 normal;
+		XMStoreFloat3(&normal, XMVector3Normalize(XMVectorSet(gaussian(generator), gaussian(generator), gaussian(generator), 0.0f)));
+
+		uint32_t packed = TerrainBaker::packNormal(normal);
+		CHECK((packed >> 24) == 255u);
+		maxDifference = fmaxf(maxDifference, maxComponentDifference(normal, TerrainBaker::unpackNormal(packed)));
+	}
+
+	CHECK(maxDifference <= (1.0f / 255.0f) + 1e-6f);
+}
+
+//Every combination of scalar, SIMD and job system bakes the same map, and a region bake rewrites only its own texels
+static void testBakePaths()
+{
+	const int size = 256;
+
+	HeightField heights;
+	heights.generateFractal(size);
+
+	std::vector<uint32_t> reference(size * size);
+	TerrainBaker::bakeNormalMap(heights, 25.0f, 1.0f, reference.data(), false, false);
+
+	JobSystem jobs(3);
+	JobSystem::setShared(&jobs);
+
+	std::vector<uint32_t> threaded(size * size);
+	TerrainBaker::bakeNormalMap(heights, 25.0f, 1.0f, threaded.data(), true, true);
+
+	int differentTexels = 0;
+	float maxDifference = 0.0f;
+
+	for (int i = 0; i < size * size; i++)
+	{
+		if (threaded[i] != reference[i])
+		{
+			differentTexels++;
+			maxDifference = fmaxf(maxDifference, maxComponentDifference(TerrainBaker::unpackNormal(threaded[i]), TerrainBaker::unpackNormal(reference[i])));
+		}
+	}
+
+	//Rounding can land the odd texel on the neighbouring 8 bit value
+	CHECK(maxDifference <= (2.0f / 255.0f) + 1e-6f);
+	CHECK(differentTexels < (size * size) / 1000);
+
+	std::vector<uint32_t> region(size * size, 0u);
+	TerrainBaker::bakeNormalMapRegion(heights, 25.0f, 1.0f, region.data(), 40, 100, 73, 131, true, true);
+
+	JobSystem::setShared(nullptr);
+
+	bool insideMatches = true;
+	bool outsideUntouched = true;
+
+	for (int y = 0; y < size; y++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			bool inside = x >= 40 && x < 73 && y >= 100 && y < 131;
+			uint32_t value = region[(y * size) + x];
+
+			if (inside)
+			{
+				insideMatches = insideMatches && value == threaded[(y * size) + x];
+			}
+
+			else
+			{
+				outsideUntouched = outsideUntouched && value == 0u;
+			}
+		}
+	}
+
+	CHECK(insideMatches);
+	CHECK(outsideUntouched);
+}
+
+//Brush edits re-baked through the dirty tiles, with the quadtree refit over the dirty bounds, leave the same normal map and
+//tree as baking and building everything again, as ChunkedTerrain::update() relies on
+static void testIncrementalEdits()
+{
+	const int size = 512;
+	const int radius = 20;
+	const float amplitude = 40.0f;
+
+	HeightField heights;
+	heights.generateFractal(size);
+
+	std::vector<uint32_t> normals(size * size);
+	TerrainBaker::bakeNormalMap(heights, amplitude, 1.0f, normals.data(), true, false);
+
+	TerrainQuadtree tree;
+	tree.build(heights, size, 32, (float)size, false);
+
+	DirtyTileTracker tracker;
+	tracker.resize(size, size, 64);
+
+	std::vector<int> tiles;
+	const int centres[4][2] = { { 100, 100 }, { 63, 300 }, { 500, 10 }, { 256, 256 } };
+
+	for (int edit = 0; edit < 4; edit++)
+	{
+		int centreX = centres[edit][0];
+		int centreY = centres[edit][1];
+
+		heights.applyBrush(centreX, centreY, radius, (edit & 1) ? -0.05f : 0.05f);
+		tracker.markDirty(centreX - radius - 1, centreY - radius - 1, centreX + radius + 1, centreY + radius + 1);
+
+		//Two edits share a re-bake
+		if (!(edit & 1))
+		{
+			continue;
+		}
+
+		tracker.getDirtyTiles(tiles);
+		CHECK(!tiles.empty() && (int)tiles.size() < tracker.getTileCount());
+
+		for (int tile : tiles)
+		{
+			int x0, y0, x1, y1;
+			tracker.getTileRect(tile, x0, y0, x1, y1);
+			TerrainBaker::bakeNormalMapRegion(heights, amplitude, 1.0f, normals.data(), x0, y0, x1, y1, true, false);
+		}
+
+		int x0, y0, x1, y1;
+		tracker.getDirtyBounds(x0, y0, x1, y1);
+		tree.refit(heights, x0, y0, x1, y1);
+		tracker.clear();
+	}
+
+	std::vector<uint32_t> fullNormals(size * size);
+	TerrainBaker::bakeNormalMap(heights, amplitude, 1.0f, fullNormals.data(), true, false);
+	CHECK(normals == fullNormals);
+
+	TerrainQuadtree fullTree;
+	fullTree.build(heights, size, 32, (float)size, false);
+
+	bool treesMatch = fullTree.getNodes().size() == tree.getNodes().size();
+
+	for (size_t i = 0; treesMatch && i < tree.getNodes().size(); i++)
+	{
+		treesMatch = tree.getNodes()[i].minHeight == fullTree.getNodes()[i].minHeight && tree.getNodes()[i].maxHeight == fullTree.getNodes()[i].maxHeight
+			&& tree.getNodes()[i].error == fullTree.getNodes()[i].error;
+	}
+
+	CHECK(treesMatch);
+}
+
+int main()
+{
+	testSimdMatchesScalar();
+	testAnalyticNormals();
+	testPacking();
+	testBakePaths();
+	testIncrementalEdits();
+
+	return checkResult();
+}
\ No newline at end of file
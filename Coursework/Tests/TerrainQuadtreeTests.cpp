@@ -0,0 +1,281 @@
+#include "TerrainQuadtree.h"
+#include "JobSystem.h"
+#include "Check.h"
+
+static const int gridSize = 256;
+static const int chunkSize = 16;
+
+//Height of the coarse patch a node draws with cells of the given step, at a full resolution grid corner. Each cell is split
+//along the diagonal from its (0,0) corner to its (1,1) corner, as TerrainChunkMesh builds it.
+static float coarseHeight(const TerrainQuadtree& tree, const HeightField& heights, int x, int z, const TerrainQuadtree::Node& node, int step)
+{
+	//Corners on the far edges belong to the last cell
+	int cx = node.x + (((x - node.x) / step) * step);
+	int cz = node.z + (((z - node.z) / step) * step);
+	cx = cx == node.x + node.size ? cx - step : cx;
+	cz = cz == node.z + node.size ? cz - step : cz;
+
+	float fx = (float)(x - cx) / (float)step;
+	float fz = (float)(z - cz) / (float)step;
+	float h00 = tree.getGridHeight(heights, cx, cz);
+	float h10 = tree.getGridHeight(heights, cx + step, cz);
+	float h01 = tree.getGridHeight(heights, cx, cz + step);
+	float h11 = tree.getGridHeight(heights, cx + step, cz + step);
+
+	if (fx >= fz)
+	{
+		return h00 + (fx * (h10 - h00)) + (fz * (h11 - h10));
+	}
+
+	return h00 + (fz * (h01 - h00)) + (fx * (h11 - h01));
+}
+
+//A full quadtree down to chunk sized leaves, each child one quarter of its parent
+static void testStructure(const TerrainQuadtree& tree)
+{
+	CHECK(tree.getNodes().size() == 1 + 4 + 16 + 64 + 256);
+	CHECK(tree.getLevelCount() == 5);
+
+	const TerrainQuadtree::Node& root = tree.getNode(0);
+	CHECK(root.x == 0 && root.z == 0 && root.size == gridSize);
+
+	bool childrenFit = true;
+	bool leavesAreChunks = true;
+
+	for (const TerrainQuadtree::Node& node : tree.getNodes())
+	{
+		if (node.children[0] < 0)
+		{
+			leavesAreChunks = leavesAreChunks && node.size == chunkSize && node.error == 0.0f;
+			continue;
+		}
+
+		for (int child : node.children)
+		{
+			const TerrainQuadtree::Node& c = tree.getNode(child);
+			childrenFit = childrenFit && c.size * 2 == node.size && c.level == node.level + 1 && c.x >= node.x && c.z >= node.z
+				&& c.x + c.size <= node.x + node.size && c.z + c.size <= node.z + node.size;
+		}
+	}
+
+	CHECK(childrenFit);
+	CHECK(leavesAreChunks);
+}
+
+//Height bounds hold every corner of a node's full resolution surface, and a node's error is at least the real distance
+//between its coarse patch and that surface, so the screen space error never understates a pop
+static void testBoundsAndError(const TerrainQuadtree& tree, const HeightField& heights)
+{
+	bool boundsHold = true;
+	bool errorHolds = true;
+	bool errorGrows = true;
+
+	for (const TerrainQuadtree::Node& node : tree.getNodes())
+	{
+		int step = node.size / chunkSize;
+		float deviation = 0.0f;
+
+		for (int z = node.z; z <= node.z + node.size; z++)
+		{
+			for (int x = node.x; x <= node.x + node.size; x++)
+			{
+				float height = tree.getGridHeight(heights, x, z);
+				boundsHold = boundsHold && height >= node.minHeight && height <= node.maxHeight;
+				deviation = fmaxf(deviation, fabsf(height - coarseHeight(tree, heights, x, z, node, step)));
+			}
+		}
+
+		errorHolds = errorHolds && deviation <= node.error + 1e-5f;
+
+		if (node.children[0] >= 0)
+		{
+			for (int child : node.children)
+			{
+				errorGrows = errorGrows && tree.getNode(child).error <= node.error;
+			}
+		}
+	}
+
+	CHECK(boundsHold);
+	CHECK(errorHolds);
+	CHECK(errorGrows);
+	CHECK(tree.getNode(0).error > 0.0f);
+}
+
+static bool sameNodes(const TerrainQuadtree& a, const TerrainQuadtree& b)
+{
+	if (a.getNodes().size() != b.getNodes().size())
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < a.getNodes().size(); i++)
+	{
+		const TerrainQuadtree::Node& na = a.getNodes()[i];
+		const TerrainQuadtree::Node& nb = b.getNodes()[i];
+
+		if (na.minHeight != nb.minHeight || na.maxHeight != nb.maxHeight || na.error != nb.error)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//The job system build and a refit after a brush edit both match a fresh single threaded build
+static void testThreadedAndRefit(const TerrainQuadtree& tree, HeightField heights)
+{
+	JobSystem jobs(3);
+	JobSystem::setShared(&jobs);
+
+	TerrainQuadtree threaded;
+	threaded.build(heights, gridSize, chunkSize, 100.0f, true);
+	CHECK(sameNodes(tree, threaded));
+
+	heights.applyBrush(70, 180, 12, 0.2f);
+	threaded.refit(heights, 70 - 13, 180 - 13, 70 + 13, 180 + 13);
+
+	JobSystem::setShared(nullptr);
+
+	TerrainQuadtree rebuilt;
+	rebuilt.build(heights, gridSize, chunkSize, 100.0f, false);
+	CHECK(sameNodes(rebuilt, threaded));
+	CHECK(!sameNodes(tree, threaded));
+}
+
+//Whole terrain selections tile the grid exactly once at any threshold, from the root alone to every leaf
+static void testSelectionCoverage(const TerrainQuadtree& tree)
+{
+	TerrainQuadtree::SelectionParams params;
+	params.cameraPosition = XMFLOAT3(20.0f, 5.0f, 30.0f);
+	params.amplitude = 10.0f;
+	params.projectionScale = 1300.0f;
+
+	std::vector<int> selected;
+
+	for (float threshold : { 1e9f, 8.0f, 2.0f, 0.5f, 0.0f })
+	{
+		params.pixelThreshold = threshold;
+		tree.select(params, nullptr, selected);
+
+		std::vector<int> coverage(gridSize * gridSize, 0);
+
+		for (int index : selected)
+		{
+			const TerrainQuadtree::Node& node = tree.getNode(index);
+
+			for (int z = node.z; z < node.z + node.size; z++)
+			{
+				for (int x = node.x; x < node.x + node.size; x++)
+				{
+					coverage[(z * gridSize) + x]++;
+				}
+			}
+		}
+
+		bool exactlyOnce = true;
+
+		for (int count : coverage)
+		{
+			exactlyOnce = exactlyOnce && count == 1;
+		}
+
+		CHECK(exactlyOnce);
+
+		if (threshold == 1e9f)
+		{
+			CHECK(selected.size() == 1 && selected[0] == 0);
+		}
+
+		if (threshold == 0.0f)
+		{
+			CHECK(selected.size() == 256);
+		}
+	}
+}
+
+//With a frustum only nodes whose bounds it touches are kept, and finer nodes are picked near the camera than far from it
+static void testSelectionView(const TerrainQuadtree& tree)
+{
+	XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(10.0f, 12.0f, 10.0f, 1.0f), XMVectorSet(60.0f, 0.0f, 60.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+	XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 200.0f);
+	Frustum frustum(view * projection);
+
+	TerrainQuadtree::SelectionParams params;
+	params.cameraPosition = XMFLOAT3(10.0f, 12.0f, 10.0f);
+	params.amplitude = 10.0f;
+	params.projectionScale = XMVectorGetY(projection.r[1]) * 540.0f;
+	params.pixelThreshold = 2.0f;
+
+	std::vector<int> selected;
+	tree.select(params, &frustum, selected);
+	CHECK(!selected.empty());
+
+	bool allVisible = true;
+	int nearLevel = -1;
+	int farLevel = 100;
+
+	for (int index : selected)
+	{
+		const TerrainQuadtree::Node& node = tree.getNode(index);
+		XMFLOAT3 minimum, maximum;
+		tree.getBounds(node, params.amplitude, minimum, maximum);
+		allVisible = allVisible && frustum.boxVisible(minimum, maximum);
+
+		float centreX = (minimum.x + maximum.x) * 0.5f;
+		float centreZ = (minimum.z + maximum.z) * 0.5f;
+		float distance = sqrtf(((centreX - 10.0f) * (centreX - 10.0f)) + ((centreZ - 10.0f) * (centreZ - 10.0f)));
+
+		if (distance < 20.0f && node.level > nearLevel)
+		{
+			nearLevel = node.level;
+		}
+
+		if (distance > 80.0f && node.level < farLevel)
+		{
+			farLevel = node.level;
+		}
+	}
+
+	CHECK(allVisible);
+	CHECK(nearLevel > farLevel);
+}
+
+//Bilinear sampling hits the stored texels at their centres, stores 16 bits, and a brush only changes the texels it covers
+static void testHeightField()
+{
+	HeightField heights(8, 8);
+	heights.setSample(3, 4, 0.5f);
+	CHECK_NEAR(heights.getSample(3, 4), 0.5f, 0.5f / 65535.0f);
+	CHECK_NEAR(heights.sample(3.5f / 8.0f, 4.5f / 8.0f), heights.getSample(3, 4), 1e-6f);
+	CHECK_NEAR(heights.sample(4.0f / 8.0f, 4.5f / 8.0f), heights.getSample(3, 4) * 0.5f, 1e-6f);
+
+	heights.setSample(0, 0, 2.0f);
+	CHECK(heights.getSample(0, 0) == 1.0f);
+	CHECK(heights.load(-5, -5) == 1.0f);
+
+	HeightField brushed(64, 64);
+	brushed.applyBrush(32, 32, 5, 0.3f);
+	CHECK_NEAR(brushed.getSample(32, 32), 0.3f, 1e-4f);
+	CHECK(brushed.getSample(32, 38) == 0.0f);
+	CHECK(brushed.getSample(32, 34) > 0.0f);
+}
+
+int main()
+{
+	HeightField heights;
+	heights.generateFractal(gridSize);
+
+	TerrainQuadtree tree;
+	tree.build(heights, gridSize, chunkSize, 100.0f, false);
+
+	testStructure(tree);
+	testBoundsAndError(tree, heights);
+	testThreadedAndRefit(tree, heights);
+	testSelectionCoverage(tree);
+	testSelectionView(tree);
+	testHeightField();
+
+	return checkResult();
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "TerrainTessellation.h"
+#include "Check.h"
+
+static TerrainTessellation::Settings testSettings()
+{
+	TerrainTessellation::Settings settings;
+	settings.cameraPosition = XMFLOAT3(50.0f, 12.0f, 20.0f);
+	settings.amplitude = 10.0f;
+	settings.projectionScale = 1300.0f;
+	settings.pixelsPerEdge = 16.0f;
+	settings.minFactor = 1.0f;
+	settings.maxFactor = 64.0f;
+
+	return settings;
+}
+
+//Factors come from the edge alone, so both patches sharing an edge pick the same one whichever way round they list it.
+//They follow the projected length - inversely with distance and with the pixels asked for - clamped to the range.
+static void testEdgeFactor()
+{
+	TerrainTessellation::Settings settings = testSettings();
+
+	XMFLOAT3 a(40.0f, 0.0f, 60.0f);
+	XMFLOAT3 b(43.0f, 0.0f, 60.0f);
+	float factor = TerrainTessellation::edgeFactor(a, b, settings);
+	CHECK(factor == TerrainTessellation::edgeFactor(b, a, settings));
+	CHECK(factor > settings.minFactor && factor < settings.maxFactor);
+
+	//The midpoint is taken at the top of the height range, two units below the camera
+	float distance = sqrtf((8.5f * 8.5f) + (2.0f * 2.0f) + (40.0f * 40.0f));
+	CHECK_NEAR(factor, (3.0f * settings.projectionScale) / (distance * settings.pixelsPerEdge), 1e-4f);
+
+	settings.pixelsPerEdge = 32.0f;
+	CHECK_NEAR(TerrainTessellation::edgeFactor(a, b, settings), factor * 0.5f, 1e-4f);
+
+	settings = testSettings();
+	CHECK(TerrainTessellation::edgeFactor(XMFLOAT3(50.0f, 0.0f, 20.0f), XMFLOAT3(52.0f, 0.0f, 20.0f), settings) == settings.maxFactor);
+	CHECK(TerrainTessellation::edgeFactor(XMFLOAT3(0.0f, 0.0f, 1000.0f), XMFLOAT3(0.1f, 0.0f, 1000.0f), settings) == settings.minFactor);
+}
+
+//An untessellated quad is two triangles, and a uniform integer factor n splits it into n x n quads
+static void testCountTriangles()
+{
+	const float ones[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	CHECK(TerrainTessellation::countTriangles(ones, 1.0f) == 2);
+
+	for (int n = 2; n <= 64; n++)
+	{
+		const float edges[4] = { (float)n, (float)n, (float)n, (float)n };
+		CHECK(TerrainTessellation::countTriangles(edges, (float)n) == 2 * n * n);
+	}
+
+	//Fractional factors round up with integer partitioning
+	const float fractional[4] = { 2.2f, 2.2f, 2.2f, 2.2f };
+	CHECK(TerrainTessellation::countTriangles(fractional, 2.2f) == 2 * 3 * 3);
+
+	//Each edge adds its own segments to the ring around the inner grid
+	const float mixed[4] = { 1.0f, 4.0f, 4.0f, 4.0f };
+	CHECK(TerrainTessellation::countTriangles(mixed, 4.0f) == (2 * 4 * 4) - 3);
+}
+
+//Patches are culled against their full height range. From high above every patch is in view, facing away none are.
+static void testMeasureView()
+{
+	TerrainTessellation::Settings settings = testSettings();
+	XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 500.0f);
+
+	settings.cameraPosition = XMFLOAT3(50.0f, 300.0f, 50.0f);
+	Frustum above(XMMatrixLookAtLH(XMVectorSet(50.0f, 300.0f, 50.0f, 1.0f), XMVectorSet(50.0f, 0.0f, 50.0f, 1.0f), XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f)) * projection);
+	TerrainTessellation::ViewStats stats = TerrainTessellation::measureView(settings, above, 32, 100.0f);
+	CHECK(stats.visiblePatches == 32 * 32);
+	CHECK(stats.triangles >= 2 * 32 * 32);
+	CHECK(stats.averageFactor >= settings.minFactor);
+
+	settings.cameraPosition = XMFLOAT3(50.0f, 12.0f, -10.0f);
+	Frustum away(XMMatrixLookAtLH(XMVectorSet(50.0f, 12.0f, -10.0f, 1.0f), XMVectorSet(50.0f, 12.0f, -50.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)) * projection);
+	stats = TerrainTessellation::measureView(settings, away, 32, 100.0f);
+	CHECK(stats.visiblePatches == 0 && stats.triangles == 0);
+
+	//Close to the ground the nearby patches are refined far more than the fixed 99 x 99 plane, and fewer pixels per edge means more triangles
+	settings.cameraPosition = XMFLOAT3(50.0f, 12.0f, 20.0f);
+	Frustum across(XMMatrixLookAtLH(XMVectorSet(50.0f, 12.0f, 20.0f, 1.0f), XMVectorSet(50.0f, 0.0f, 50.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)) * projection);
+	TerrainTessellation::ViewStats coarse = TerrainTessellation::measureView(settings, across, 32, 100.0f);
+	settings.pixelsPerEdge = 4.0f;
+	TerrainTessellation::ViewStats fine = TerrainTessellation::measureView(settings, across, 32, 100.0f);
+	CHECK(coarse.visiblePatches == fine.visiblePatches);
+	CHECK(fine.triangles > coarse.triangles);
+	CHECK(fine.averageFactor > coarse.averageFactor);
+}
+
+int main()
+{
+	testEdgeFactor();
+	testCountTriangles();
+	testMeasureView();
+
+	return checkResult();
+}
\ No newline at end of file
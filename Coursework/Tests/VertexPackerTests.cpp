@@ -0,0 +1,161 @@
+#include "VertexPacker.h"
+#include "Check.h"
+
+#include <cstring>
+#include <random>
+
+typedef VertexFormats::VertexType Vertex;
+
+static std::vector<Vertex> randomVertices(int count, float extent, float textureRange, unsigned int seed)
+{
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> position(-extent, extent * 0.5f);
+	std::uniform_real_distribution<float> texture(-textureRange, textureRange);
+	std::normal_distribution<float> direction(0.0f, 1.0f);
+	std::vector<Vertex> vertices(count);
+
+	for (Vertex& vertex : vertices)
+	{
+		XMVECTOR normal = XMVector3Normalize(XMVectorSet(direction(random), direction(random), direction(random), 0.0f));
+		vertex.position = XMFLOAT3(position(random), position(random) * 0.25f, position(random));
+		vertex.texture = XMFLOAT2(texture(random), texture(random));
+		XMStoreFloat3(&vertex.normal, normal);
+	}
+
+	return vertices;
+}
+
+//Halves round to nearest even, keep subnormals and saturate to infinity
+static void testHalfFloats()
+{
+	for (float value : { 0.0f, 1.0f, -2.0f, 0.5f, 0.333251953125f, 65504.0f, -65504.0f, 6.103515625e-05f, 5.9604644775390625e-08f })
+	{
+		CHECK(VertexPacker::halfToFloat(VertexPacker::floatToHalf(value)) == value);
+	}
+
+	CHECK(VertexPacker::floatToHalf(1.0f) == 0x3C00);
+	CHECK(VertexPacker::floatToHalf(-0.0f) == 0x8000);
+	CHECK(VertexPacker::floatToHalf(100000.0f) == 0x7C00);
+	CHECK(VertexPacker::floatToHalf(2.0e-8f) == 0x0000);
+
+	//Exactly halfway between two halves goes to the even one
+	CHECK(VertexPacker::floatToHalf(1.0f + (1.0f / 2048.0f)) == 0x3C00);
+	CHECK(VertexPacker::floatToHalf(1.0f + (3.0f / 2048.0f)) == 0x3C02);
+
+	//Every finite half survives the round trip through a float
+	bool exact = true;
+
+	for (unsigned int bits = 0; bits < 0x10000; bits++)
+	{
+		if (((bits >> 10) & 0x1F) != 31)
+		{
+			exact = exact && VertexPacker::floatToHalf(VertexPacker::halfToFloat((unsigned short)bits)) == (unsigned short)bits;
+		}
+	}
+
+	CHECK(exact);
+}
+
+//The octahedral fold is undone exactly before quantisation, over both hemispheres and the axes
+static void testOctahedral()
+{
+	std::vector<Vertex> vertices = randomVertices(20000, 1.0f, 1.0f, 1);
+	vertices[0].normal = XMFLOAT3(0.0f, 0.0f, -1.0f);
+	vertices[1].normal = XMFLOAT3(1.0f, 0.0f, 0.0f);
+	vertices[2].normal = XMFLOAT3(0.0f, -1.0f, 0.0f);
+
+	float smallestDot = 1.0f;
+
+	for (const Vertex& vertex : vertices)
+	{
+		XMFLOAT2 encoded = VertexPacker::encodeOctahedral(vertex.normal);
+		XMFLOAT3 decoded = VertexPacker::decodeOctahedral(encoded);
+		smallestDot = fminf(smallestDot, (vertex.normal.x * decoded.x) + (vertex.normal.y * decoded.y) + (vertex.normal.z * decoded.z));
+
+		CHECK(fabsf(encoded.x) + fabsf(encoded.y) <= 1.0001f || vertex.normal.z < 0.0f);
+	}
+
+	CHECK(smallestDot > 0.99999f);
+}
+
+//The report measures the largest of each error, and both formats stay within what their precision allows
+static void testErrorReport()
+{
+	std::vector<Vertex> vertices = randomVertices(50000, 40.0f, 4.0f, 2);
+	VertexPacker::Report report = VertexPacker::measure("random", vertices.data(), (int)vertices.size());
+
+	CHECK(report.vertices == 50000);
+	CHECK(report.floatBytes == 50000 * 32);
+	CHECK(report.packedBytes == 50000 * 16);
+	CHECK(report.compactBytes == 50000 * 12);
+	CHECK(VertexPacker::getStride(false) == 16 && VertexPacker::getStride(true) == 12);
+
+	VertexPacker::Bounds bounds = VertexPacker::getBounds(vertices.data(), (int)vertices.size());
+	CHECK_NEAR(report.packedError.positionBound, 0.5f * sqrtf(3.0f) * bounds.size / 65535.0f, 1e-7f);
+	CHECK(report.packedError.position <= report.packedError.positionBound);
+	CHECK(report.compactError.position <= report.compactError.positionBound);
+
+	//Half floats have 11 significant bits, so coordinates up to 4 are within half of 2^-9
+	CHECK(report.packedError.texture <= 1.0f / 1024.0f);
+	//16 bit normals are finer than the report can resolve, acos of a float dot product near one steps in hundredths of a degree
+	CHECK(report.packedError.normalDegrees < 0.05f);
+	CHECK(report.compactError.normalDegrees < 1.5f);
+	CHECK(report.compactError.normalDegrees > report.packedError.normalDegrees);
+
+	//Moving one vertex and turning one normal by known amounts is reported as exactly those
+	std::vector<Vertex> moved = vertices;
+	moved[7].position.x += 0.25f;
+	moved[9].normal = XMFLOAT3(-vertices[9].normal.x, -vertices[9].normal.y, -vertices[9].normal.z);
+	moved[11].texture.y += 0.5f;
+
+	VertexPacker::Error error = VertexPacker::measureError(vertices.data(), moved.data(), (int)vertices.size(), bounds);
+	CHECK_NEAR(error.position, 0.25f, 1e-4f);
+	CHECK_NEAR(error.normalDegrees, 180.0f, 0.1f);
+	CHECK_NEAR(error.texture, 0.5f, 1e-4f);
+}
+
+//Decoding a packed vertex gives exactly the quantised position the shader would, and both formats agree on it
+static void testRoundTrip()
+{
+	std::vector<Vertex> vertices = randomVertices(1000, 5.0f, 1.0f, 3);
+	VertexPacker::Bounds bounds = VertexPacker::getBounds(vertices.data(), (int)vertices.size());
+
+	std::vector<VertexFormats::VertexType_Packed> packed(vertices.size());
+	std::vector<VertexFormats::VertexType_PackedCompact> compact(vertices.size());
+	std::vector<Vertex> packedDecoded(vertices.size()), compactDecoded(vertices.size());
+
+	VertexPacker::encode(vertices.data(), (int)vertices.size(), bounds, packed.data());
+	VertexPacker::encode(vertices.data(), (int)vertices.size(), bounds, compact.data());
+	VertexPacker::decode(packed.data(), (int)vertices.size(), bounds, packedDecoded.data());
+	VertexPacker::decode(compact.data(), (int)vertices.size(), bounds, compactDecoded.data());
+
+	bool samePositions = true;
+	bool sameTextures = true;
+	bool unusedW = true;
+
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		samePositions = samePositions && memcmp(&packedDecoded[i].position, &compactDecoded[i].position, sizeof(XMFLOAT3)) == 0;
+		sameTextures = sameTextures && memcmp(&packedDecoded[i].texture, &compactDecoded[i].texture, sizeof(XMFLOAT2)) == 0;
+		unusedW = unusedW && packed[i].position[3] == 0;
+	}
+
+	CHECK(samePositions);
+	CHECK(sameTextures);
+	CHECK(unusedW);
+
+	//The bounds are a cube from the minimum corner, the largest extent maps to the full range
+	CHECK(bounds.size > 0.0f);
+	Vertex single = vertices[0];
+	CHECK(VertexPacker::getBounds(&single, 1).size == 1.0f);
+}
+
+int main()
+{
+	testHalfFloats();
+	testOctahedral();
+	testErrorReport();
+	testRoundTrip();
+
+	return checkResult();
+}
\ No newline at end of file
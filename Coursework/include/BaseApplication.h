@@ -4,7 +4,7 @@
 * \brief Default application setup, inherit from this
 *
 * This class is the parent application to inherit from when creating a new application.
-* Handles the default configuration of the renderer, camera, input, timer and texture manager.
+* Handles the default configuration of the renderer, camera, input, timer, texture manager and job system.
 *
 * \author Paul Robertson
 */
@@ -17,6 +17,7 @@
 //const bool VSYNC_ENABLED = true;
 const float SCREEN_DEPTH = 200.0f;	// 1000.0f
 const float SCREEN_NEAR = 0.1f;		//0.1f
+const int MSAA_SAMPLES = 1;			// Default back buffer samples per pixel, applications opt in to multisampling through msaaSamples
 
 // Includes
 #include "input.h"
@@ -27,6 +28,7 @@ const float SCREEN_NEAR = 0.1f;		//0.1f
 #include "imGUI/imgui_impl_dx11.h"
 #include "imGUI/imgui_impl_win32.h"
 #include "TextureManager.h"
+#include "JobSystem.h"
 
 
 class BaseApplication
@@ -74,6 +76,8 @@ protected:
 	FPCamera* camera;			///< Pointer to camera object
 	Timer* timer;			///< Pointer to timer object (for delta time and FPS)
 	TextureManager* textureMgr;	///< Pointer to texture manager (handles loading and storing of textures)
+	JobSystem* jobs;		///< Pointer to the job system (worker threads, shared through JobSystem::getShared())
+	int msaaSamples;		///< Back buffer samples per pixel, MSAA_SAMPLES unless set before init(). Falls back to 1 if unsupported
 	bool wireframeToggle;	///< Boolean tracking if wireframe is de/activated
 };
 
@@ -14,49 +14,59 @@
 
 #include <d3d11.h>
 #include <directxmath.h>
+#include "VertexFormats.h"
 
 using namespace DirectX;
 
 class BaseMesh
 {
-protected:
-
-	/// Default struct for general vertex data include position, texture coordinates and normals
-	struct VertexType
-	{
-		XMFLOAT3 position;
-		XMFLOAT2 texture;
-		XMFLOAT3 normal;
-	};
-
-	/// Default vertex struct for geometry with only position and colour
-	struct VertexType_Colour
-	{
-		XMFLOAT3 position;
-		XMFLOAT4 colour;
-	};
+public:
 
-	/// Default vertex struct for geometry with only position and texture coordinates.
-	struct VertexType_Texture
-	{
-		XMFLOAT3 position;
-		XMFLOAT2 texture;
-	};
+	/// Vertex layouts, defined in VertexFormats.h
+	typedef VertexFormats::VertexType VertexType;
+	typedef VertexFormats::VertexType_Colour VertexType_Colour;
+	typedef VertexFormats::VertexType_Texture VertexType_Texture;
+	typedef VertexFormats::VertexType_Packed VertexType_Packed;
+	typedef VertexFormats::VertexType_PackedCompact VertexType_PackedCompact;
 
 public:
 	/// Empty constructor
 	BaseMesh();
 	~BaseMesh();
 
-	/// Transfers mesh data to the GPU.
-	virtual void sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	/// Transfers mesh data to the GPU. Returns the bytes per vertex of the streams it bound.
+	virtual unsigned int sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	/// Transfers mesh data with a per instance buffer in the second input slot, for BaseShader::renderInstanced().
+	unsigned int sendInstancedData(ID3D11DeviceContext* deviceContext, ID3D11Buffer* instanceBuffer, unsigned int instanceStride, D3D_PRIMITIVE_TOPOLOGY top = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 	int getIndexCount();			///< Returns total index value of the mesh
+
+	/// Uploads a packed copy of the vertices beside the float ones, for meshes that opt in. Shaders drawing it load their vertex shader with loadPackedVertexShader().
+	void createPackedVertices(ID3D11Device* device, const VertexType* vertices, int count, bool compactNormals = false);
+	void setDrawPacked(bool packed);	///< Binds the packed vertices in sendData() instead of the float ones, when there are any
+	bool isDrawingPacked();				///< Whether sendData() binds the packed vertices
+	bool hasCompactNormals();			///< Whether the packed vertices are VertexType_PackedCompact
+	XMMATRIX getDecodeMatrix();			///< Scales packed positions back out of the unit cube, put in front of the world matrix. Identity when drawing float vertices.
+	unsigned int getVertexStride();		///< Bytes per vertex of the buffer sendData() binds
+
+	/// Uploads the positions and texture coordinates again as streams of their own, for passes that read nothing else.
+	void createPositionStreams(ID3D11Device* device, const VertexType* vertices, int count);
+	void updatePositionStreams(ID3D11DeviceContext* deviceContext, const VertexType* vertices);	///< Rewrites the streams, for meshes whose vertices change
+	/// Binds the position stream to slot 0 and the texture coordinate stream to slot 1, for shaders loaded with loadPositionVertexShader(). Meshes without them bind their whole vertices.
+	virtual unsigned int sendPositionData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	bool hasPositionStreams();
+	int getVertexCount();
 	//D3D11_INPUT_ELEMENT_DESC getInputLayout();
 
 protected:
 	virtual void initBuffers(ID3D11Device*) = 0;
 
 	ID3D11Buffer *vertexBuffer, *indexBuffer;
+	ID3D11Buffer* packedVertexBuffer;
+	XMFLOAT3 packedMinimum;		///< Corner of the cube the packed positions are quantised over
+	float packedSize;			///< Edge of that cube
+	bool compactNormals;
+	bool drawPacked;
+	ID3D11Buffer *positionBuffer, *texCoordBuffer;
 	//D3D11_INPUT_ELEMENT_DESC *inputLayout;
 	int vertexCount, indexCount;
 };
@@ -28,6 +28,9 @@
 #include "TessellationMesh.h"
 #include "TriangleMesh.h"
 #include "AModel.h"
+#include "MeshOptimiser.h"
+#include "VertexPacker.h"
+#include "InstanceBuffer.h"
 
 // Include additional rendering headers
 #include "Light.h"
@@ -0,0 +1,30 @@
+/**
+* \class Instance Data
+*
+* \brief The per instance layout InstanceBuffer streams, outside it so the code that fills instances on the CPU needs only DirectXMath.
+*
+* InstanceBuffer names it as InstanceBuffer::Instance and writes through write(), which is how the application uses them.
+*/
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstring>
+
+namespace InstanceData
+{
+	/// One instance, the rows of its world matrix untransposed, as XMStoreFloat4x4 writes them
+	struct Instance
+	{
+		DirectX::XMFLOAT4X4 world;
+	};
+
+	/// Copies up to capacity instances to mapped memory, returning how many were copied
+	inline int write(void* destination, int capacity, const Instance* instances, int count)
+	{
+		count = count < capacity ? count : capacity;
+		count = count > 0 ? count : 0;
+		memcpy(destination, instances, sizeof(Instance) * count);
+		return count;
+	}
+}
\ No newline at end of file
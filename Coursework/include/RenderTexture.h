@@ -33,13 +33,16 @@ public:
 
 	/** \brief Initialises render textures
 	*	Required renderer device, specified width and height of texture/target, and near + far planes
+	*	Format can be specified for smaller targets, such as the channels of a G-buffer
 	*/
-	RenderTexture(ID3D11Device* device, int textureWidth, int textureHeight, float screenNear, float screenDepth);
+	RenderTexture(ID3D11Device* device, int textureWidth, int textureHeight, float screenNear, float screenDepth, DXGI_FORMAT format = DXGI_FORMAT_R32G32B32A32_FLOAT);
 	~RenderTexture();
 
 	void setRenderTarget(ID3D11DeviceContext* deviceContext);		///< Set this render texture as the render target
 	void clearRenderTarget(ID3D11DeviceContext* deviceContext, float red, float green, float blue, float alpha);	///< Empties the render texture, provide device context and RGBA (background colour)
 	ID3D11ShaderResourceView* getShaderResourceView();			///< Get the data from this render target as a texture resource.
+	ID3D11RenderTargetView* getRenderTargetView();				///< Get the render target view, for binding several render textures at once (MRT).
+	ID3D11DepthStencilView* getDepthStencilView();				///< Get the depth stencil view created with this render target.
 
 	XMMATRIX getProjectionMatrix();		///< Get the projection matrix related to this render target (Could be different based on dimensions or near/far plane)
 	XMMATRIX getOrthoMatrix();			///< Get the orthographics matrix stored within this render target (could be different based on dimension)
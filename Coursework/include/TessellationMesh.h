@@ -18,7 +18,7 @@ public:
 	TessellationMesh(ID3D11Device* device, ID3D11DeviceContext* deviceContext);
 	~TessellationMesh();
 
-	void sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top = D3D11_PRIMITIVE_TOPOLOGY_3_CONTROL_POINT_PATCHLIST) override;
+	unsigned int sendData(ID3D11DeviceContext* deviceContext, D3D_PRIMITIVE_TOPOLOGY top = D3D11_PRIMITIVE_TOPOLOGY_3_CONTROL_POINT_PATCHLIST) override;
 
 protected:
 	void initBuffers(ID3D11Device* device);